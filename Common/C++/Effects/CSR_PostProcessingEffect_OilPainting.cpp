@@ -19,6 +19,10 @@
 // compactStar engine
 #include "CSR_Renderer.h"
 
+//---------------------------------------------------------------------------
+// Global defines
+//---------------------------------------------------------------------------
+#define M_CSR_OilPainting_Max_Radius 147 // (radius + 1)^2 * 3 * 255^2 should fit in 32 bits
 //---------------------------------------------------------------------------
 // CSR_PostProcessingEffect_OilPainting
 //---------------------------------------------------------------------------
@@ -28,9 +32,14 @@ CSR_PostProcessingEffect_OilPainting::CSR_PostProcessingEffect_OilPainting(std::
     CSR_PostProcessingEffect(),
     m_Radius(radius),
     m_ViewportSlot(-1),
-    m_RadiusSlot(-1)
+    m_RadiusSlot(-1),
+    m_pTableShader(0),
+    m_TableSourceSlot(-1),
+    m_TableOffsetSlot(-1),
+    m_TableInitSlot(-1)
 {
     const std::string vertexShader =
+        "#version 130\n"
         "precision mediump float;"
         "attribute vec4 csr_vVertex;"
         "void main(void)"
@@ -38,61 +47,109 @@ CSR_PostProcessingEffect_OilPainting::CSR_PostProcessingEffect_OilPainting(std::
         "    gl_Position = vec4(csr_vVertex.x, csr_vVertex.y, 0.0f, 1.0f);"
         "}";
 
-    const std::string fragmentShader =
-        "precision mediump float;"
-        "uniform sampler2D csr_sTexture;"
-        "uniform int       csr_iRadius;"
-        "uniform vec2      csr_vViewport;"
-        "void main(void)"
+    // the summed-area table is built by several passes, each of them adding to each pixel the pixel
+    // found at an offset on its left or below it, the offset being doubled on each pass. The first
+    // pass converts the scene colors to the summed values, i.e. the 8 bit color channels and the sum
+    // of their squares. The sums are unsigned integers, thus they are exact, and a quadrant sum read
+    // from the table remains exact even if the table values wrapped around
+    const std::string tableShader =
+        "#version 130\n"
+        "uniform sampler2D  csr_sTexture;"
+        "uniform usampler2D csr_sTable;"
+        "uniform ivec2      csr_vOffset;"
+        "uniform int        csr_iInit;"
+        "out     uvec4      csr_uSum;"
+        "uvec4 Fetch(ivec2 pos)"
         "{"
-        "    vec2  src_size = csr_vViewport;"
-        "    vec2  uv       = gl_FragCoord.xy / src_size;"
-        "    float n        = float((csr_iRadius + 1) * (csr_iRadius + 1));"
-        "    vec3  m[4];"
-        "    vec3  s[4];"
-        "    for (int k = 0; k < 4; ++k)"
+        "    if (csr_iInit != 0)"
         "    {"
-        "        m[k] = vec3(0.0);"
-        "        s[k] = vec3(0.0);"
+        "        uvec3 c = uvec3(texelFetch(csr_sTexture, pos, 0).rgb * 255.0 + 0.5);"
+        "        return uvec4(c, c.r * c.r + c.g * c.g + c.b * c.b);"
         "    }"
-        "    struct Window{int x1 , y1 , x2 , y2;};"
-        "    Window W[4];"
-        "    W[0] = Window(-csr_iRadius, -csr_iRadius, 0,           0);"
-        "    W[1] = Window( 0,           -csr_iRadius, csr_iRadius, 0);"
-        "    W[2] = Window( 0,            0,           csr_iRadius, csr_iRadius);"
-        "    W[3] = Window(-csr_iRadius , 0,           0,           csr_iRadius);"
+        "    return texelFetch(csr_sTable, pos, 0);"
+        "}"
+        "void main(void)"
+        "{"
+        "    ivec2 pos  = ivec2(gl_FragCoord.xy);"
+        "    ivec2 prev = pos - csr_vOffset;"
+        "    uvec4 sum  = Fetch(pos);"
+        "    if (prev.x >= 0 && prev.y >= 0)"
+        "        sum += Fetch(prev);"
+        "    csr_uSum = sum;"
+        "}";
+
+    // the quadrants sums are read in the 4 corners of the quadrants in the summed-area table. The
+    // quadrants are cut on the viewport borders. Up to 296 pixels, the quadrant variance multiplied
+    // by the square of its pixel count is exact in unsigned integers, and the quadrants are compared
+    // on it, as csrFrameBufferOilPainting() does. The mean colors are rounded in the same way too
+    const std::string fragmentShader =
+        "#version 130\n"
+        "precision highp float;"
+        "uniform usampler2D csr_sTexture;"
+        "uniform int        csr_iRadius;"
+        "uniform vec2       csr_vViewport;"
+        "uvec4 Table(ivec2 pos)"
+        "{"
+        "    if (pos.x < 0 || pos.y < 0)"
+        "        return uvec4(0u);"
+        "    return texelFetch(csr_sTexture, pos, 0);"
+        "}"
+        "void main(void)"
+        "{"
+        "    ivec2 pos  = ivec2(gl_FragCoord.xy);"
+        "    ivec2 last = ivec2(csr_vViewport) - 1;"
+        "    int   r    = csr_iRadius;"
+        "    ivec2 lo[4];"
+        "    ivec2 hi[4];"
+        "    lo[0] = pos - r;                     hi[0] = pos;"
+        "    lo[1] = ivec2(pos.x,     pos.y - r); hi[1] = ivec2(pos.x + r, pos.y);"
+        "    lo[2] = pos;                         hi[2] = pos + r;"
+        "    lo[3] = ivec2(pos.x - r, pos.y);     hi[3] = ivec2(pos.x,     pos.y + r);"
+        "    float min_sigma2 = 0.0;"
         "    for (int k = 0; k < 4; ++k)"
         "    {"
-        "       for (int j = W[k].y1; j <= W[k].y2; ++j)"
-        "       {"
-        "            for (int i = W[k].x1; i <= W[k].x2; ++i)"
-        "            {"
-        "                vec3 c  = texture(csr_sTexture, uv + vec2(i ,j) / src_size).rgb;"
-        "                m[k]   += c;"
-        "                s[k]   += c * c;"
-        "            }"
+        "        ivec2 a      = max(lo[k], ivec2(0));"
+        "        ivec2 b      = min(hi[k], last);"
+        "        uvec4 s      = Table(b)"
+        "                     - Table(ivec2(a.x - 1, b.y))"
+        "                     - Table(ivec2(b.x,     a.y - 1))"
+        "                     + Table(a - 1);"
+        "        uint  count  = uint((b.x - a.x + 1) * (b.y - a.y + 1));"
+        "        float n      = float(count);"
+        "        float sigma2;"
+        "        if (count <= 296u)"
+        "            sigma2 = float(count * s.a - (s.r * s.r + s.g * s.g + s.b * s.b)) / (n * n);"
+        "        else"
+        "        {"
+        "            vec3 m = vec3(s.rgb) / n;"
+        "            sigma2 = float(s.a) / n - dot(m, m);"
         "        }"
-        "    }"
-        "    float min_sigma2 = 1e+2;"
-        "    for (int k = 0; k < 4; ++k)"
-        "    {"
-        "        m[k]         /= n;"
-        "        s[k]          = abs(s[k] / n - m[k] * m[k]);"
-        "        float sigma2  = s[k].r + s[k].g + s[k].b;"
-        "        if (sigma2 < min_sigma2)"
+        "        if (k == 0 || sigma2 < min_sigma2)"
         "        {"
         "            min_sigma2   = sigma2;"
-        "            gl_FragColor = vec4(m[k], 1.0);"
+        "            gl_FragColor = vec4(vec3((2u * s.rgb + count) / (2u * count)) / 255.0, 1.0);"
         "        }"
         "    }"
         "}";
 
-    if (!Initialize(width, height, vertexShader, fragmentShader))
+    m_TableTextureID[0] = 0;
+    m_TableTextureID[1] = 0;
+    m_TableBufferID[0]  = 0;
+    m_TableBufferID[1]  = 0;
+
+    if (!Initialize(width, height, vertexShader, fragmentShader, tableShader))
         throw std::runtime_error("Could not initialize the oil painting post-processing effect");
 }
 //---------------------------------------------------------------------------
 CSR_PostProcessingEffect_OilPainting::~CSR_PostProcessingEffect_OilPainting()
-{}
+{
+    // delete the summed-area table
+    DeleteTable();
+
+    // delete the summed-area table shader
+    if (m_pTableShader)
+        csrOpenGLShaderRelease(m_pTableShader);
+}
 //---------------------------------------------------------------------------
 bool CSR_PostProcessingEffect_OilPainting::ChangeSize(std::size_t width, std::size_t height)
 {
@@ -124,6 +181,9 @@ bool CSR_PostProcessingEffect_OilPainting::ChangeSize(std::size_t width, std::si
         m_FrameBufferID = M_CSR_Error_Code;
     }
 
+    // delete the summed-area table
+    DeleteTable();
+
     // recreate the effect
     return Configure(width, height);
 }
@@ -166,9 +226,6 @@ void CSR_PostProcessingEffect_OilPainting::DrawEnd() const
         // set polygon mode to fill
         glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
 
-        // enable the MSAA shader
-        csrShaderEnable(m_pShader);
-
         // blit the multisampled buffer containing the drawing to the output texture buffer
         glBindFramebuffer(GL_READ_FRAMEBUFFER, m_FrameBufferID);
         glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_TextureBufferID);
@@ -187,22 +244,31 @@ void CSR_PostProcessingEffect_OilPainting::DrawEnd() const
         glBindFramebuffer(GL_FRAMEBUFFER, 0);
 
         // configure the depth testing
+        glDisable(GL_DEPTH_TEST);
+
+        // build the summed-area table of the drawing
+        const std::size_t table = BuildTable();
+
+        // clear the final frame buffer
         glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT);
-        glDisable(GL_DEPTH_TEST);
+
+        // enable the effect shader
+        csrShaderEnable(m_pShader);
 
         // set the viewport values
         glUniform2f(m_ViewportSlot, float(m_Width), float(m_Height));
 
-        // set the radius value
-        glUniform1i(m_RadiusSlot, m_Radius);
+        // set the radius value. Above the max radius, the quadrant sums would no longer fit in the
+        // summed-area table unsigned integers
+        glUniform1i(m_RadiusSlot, m_Radius < M_CSR_OilPainting_Max_Radius ? m_Radius : M_CSR_OilPainting_Max_Radius);
 
-        // select the texture sampler to use (GL_TEXTURE0 for normal textures)
+        // select the texture sampler to use
         glActiveTexture(GL_TEXTURE0);
-        glUniform1i(m_pShader->m_TextureSlot, GL_TEXTURE0);
+        glUniform1i(m_pShader->m_TextureSlot, 0);
 
-        // bind the texure to use
-        glBindTexture(GL_TEXTURE_2D, m_TextureID);
+        // bind the summed-area table texure to use
+        glBindTexture(GL_TEXTURE_2D, m_TableTextureID[table]);
 
         // bind the VBO containing the shape to draw
         glBindBuffer(GL_ARRAY_BUFFER, m_pStaticBuffer->m_BufferID);
@@ -240,7 +306,8 @@ void CSR_PostProcessingEffect_OilPainting::DrawEnd() const
 bool CSR_PostProcessingEffect_OilPainting::Initialize(std::size_t  width,
                                                       std::size_t  height,
                                                 const std::string& vertexShader,
-                                                const std::string& fragmentShader)
+                                                const std::string& fragmentShader,
+                                                const std::string& tableShader)
 {
     // load the shader to use for post processing effect
     m_pShader = csrOpenGLShaderLoadFromStr(vertexShader.c_str(),
@@ -289,6 +356,56 @@ bool CSR_PostProcessingEffect_OilPainting::Initialize(std::size_t  width,
     if (m_RadiusSlot == -1)
         return false;
 
+    // load the shader building the summed-area table, which draws on the same surface
+    m_pTableShader = csrOpenGLShaderLoadFromStr(vertexShader.c_str(),
+                                                vertexShader.length(),
+                                                tableShader.c_str(),
+                                                tableShader.length(),
+                                                0,
+                                                0);
+
+    // succeeded?
+    if (!m_pTableShader)
+        return false;
+
+    // enable the summed-area table shader
+    csrShaderEnable(m_pTableShader);
+
+    // get the vertex slot
+    m_pTableShader->m_VertexSlot = glGetAttribLocation(m_pTableShader->m_ProgramID, "csr_vVertex");
+
+    // found it?
+    if (m_pTableShader->m_VertexSlot == -1)
+        return false;
+
+    // get the texture sampler slot
+    m_pTableShader->m_TextureSlot = glGetUniformLocation(m_pTableShader->m_ProgramID, "csr_sTexture");
+
+    // found it?
+    if (m_pTableShader->m_TextureSlot == -1)
+        return false;
+
+    // get the summed-area table sampler slot
+    m_TableSourceSlot = glGetUniformLocation(m_pTableShader->m_ProgramID, "csr_sTable");
+
+    // found it?
+    if (m_TableSourceSlot == -1)
+        return false;
+
+    // get the offset slot
+    m_TableOffsetSlot = glGetUniformLocation(m_pTableShader->m_ProgramID, "csr_vOffset");
+
+    // found it?
+    if (m_TableOffsetSlot == -1)
+        return false;
+
+    // get the init slot
+    m_TableInitSlot = glGetUniformLocation(m_pTableShader->m_ProgramID, "csr_iInit");
+
+    // found it?
+    if (m_TableInitSlot == -1)
+        return false;
+
     // configure the effect
     return Configure(width, height);
 }
@@ -367,6 +484,36 @@ bool CSR_PostProcessingEffect_OilPainting::Configure(std::size_t width, std::siz
     // unbind the texture buffer
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
 
+    // create the summed-area table textures and buffers. The sums are 32 bit unsigned integers
+    for (std::size_t i = 0; i < 2; ++i)
+    {
+        glGenTextures(1, &m_TableTextureID[i]);
+        glBindTexture(GL_TEXTURE_2D, m_TableTextureID[i]);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32UI, width, height, 0, GL_RGBA_INTEGER, GL_UNSIGNED_INT, 0);
+
+        // the sums should never be interpolated
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S,     GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T,     GL_CLAMP_TO_EDGE);
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        glGenFramebuffers(1, &m_TableBufferID[i]);
+        glBindFramebuffer(GL_FRAMEBUFFER, m_TableBufferID[i]);
+        glFramebufferTexture2D(GL_FRAMEBUFFER,
+                               GL_COLOR_ATTACHMENT0,
+                               GL_TEXTURE_2D,
+                               m_TableTextureID[i],
+                               0);
+
+        // build the summed-area table buffer
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+            return false;
+    }
+
+    // unbind the summed-area table buffer
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
     // set the viewport size
     m_Width  = width;
     m_Height = height;
@@ -374,3 +521,93 @@ bool CSR_PostProcessingEffect_OilPainting::Configure(std::size_t width, std::siz
     return true;
 }
 //---------------------------------------------------------------------------
+std::size_t CSR_PostProcessingEffect_OilPainting::BuildTable() const
+{
+    std::size_t target   = 0;
+    GLuint      sourceID = 0;
+    int         init     = 1;
+
+    // enable the summed-area table shader
+    csrShaderEnable(m_pTableShader);
+
+    // select the texture samplers to use, the scene is read on the first pass, the table after it
+    glUniform1i(m_pTableShader->m_TextureSlot, 0);
+    glUniform1i(m_TableSourceSlot,             1);
+
+    // bind the scene texture
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, m_TextureID);
+
+    // bind the VBO containing the surface to draw
+    glBindBuffer(GL_ARRAY_BUFFER, m_pStaticBuffer->m_BufferID);
+
+    // enable the vertices
+    glEnableVertexAttribArray(m_pTableShader->m_VertexSlot);
+    glVertexAttribPointer(m_pTableShader->m_VertexSlot,
+                          2,
+                          GL_FLOAT,
+                          GL_FALSE,
+                          m_pStaticBuffer->m_Stride * sizeof(float),
+                          0);
+
+    // sum the rows, then the columns. Each pass reads the texture written by the previous one
+    for (std::size_t axis = 0; axis < 2; ++axis)
+    {
+        const std::size_t length = axis ? m_Height : m_Width;
+
+        for (std::size_t offset = 1; offset < length || init; offset <<= 1)
+        {
+            glBindFramebuffer(GL_FRAMEBUFFER, m_TableBufferID[target]);
+
+            // set the pass values
+            glUniform2i(m_TableOffsetSlot, axis ? 0 : GLint(offset), axis ? GLint(offset) : 0);
+            glUniform1i(m_TableInitSlot, init);
+
+            // bind the table to sum, none on the first pass
+            glActiveTexture(GL_TEXTURE1);
+            glBindTexture(GL_TEXTURE_2D, sourceID);
+
+            // draw the surface
+            glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+
+            // the next pass reads the texture just written
+            sourceID = m_TableTextureID[target];
+            target   = 1 - target;
+            init     = 0;
+        }
+    }
+
+    // disable the vertex attribute array
+    glDisableVertexAttribArray(m_pTableShader->m_VertexSlot);
+
+    // unbind the VBO, the textures and the frame buffer
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    // the last written texture contains the table
+    return 1 - target;
+}
+//---------------------------------------------------------------------------
+void CSR_PostProcessingEffect_OilPainting::DeleteTable()
+{
+    for (std::size_t i = 0; i < 2; ++i)
+    {
+        // delete the summed-area table texture
+        if (m_TableTextureID[i])
+        {
+            glDeleteTextures(1, &m_TableTextureID[i]);
+            m_TableTextureID[i] = 0;
+        }
+
+        // delete the summed-area table buffer
+        if (m_TableBufferID[i])
+        {
+            glDeleteFramebuffers(1, &m_TableBufferID[i]);
+            m_TableBufferID[i] = 0;
+        }
+    }
+}
+//---------------------------------------------------------------------------
@@ -22,6 +22,11 @@
 
 /**
 * Oil painting post-processing effect
+*@note The effect is a Kuwahara filter. The scene colors are first summed in a summed-area table,
+*      built by several passes, from which the filter reads each quadrant mean and variance in
+*      constant time, whatever the radius. The table contains unsigned integers, so the result is
+*      exact whatever the viewport size, but the radius is limited to 147. See also
+*      csrFrameBufferOilPainting()
 *@author Jean-Milost Reymond
 */
 class CSR_PostProcessingEffect_OilPainting : public CSR_PostProcessingEffect
@@ -61,24 +66,43 @@ class CSR_PostProcessingEffect_OilPainting : public CSR_PostProcessingEffect
         virtual void DrawEnd() const;
 
     private:
-        std::size_t m_Width;
-        std::size_t m_Height;
-        int         m_Radius;
-        GLint       m_ViewportSlot;
-        GLint       m_RadiusSlot;
+        std::size_t       m_Width;
+        std::size_t       m_Height;
+        int               m_Radius;
+        GLint             m_ViewportSlot;
+        GLint             m_RadiusSlot;
+        CSR_OpenGLShader* m_pTableShader;      // shader building the summed-area table
+        GLuint            m_TableTextureID[2]; // summed-area table textures, written in turn by the table passes
+        GLuint            m_TableBufferID[2];
+        GLint             m_TableSourceSlot;
+        GLint             m_TableOffsetSlot;
+        GLint             m_TableInitSlot;
 
         /**
         * Initializes the effect
         *@param width - target viewport width
         *@param height - target viewport height
         *@param vertexShader - effect vertex shader program
-        *@param vertexShader - effect fragment shader program
+        *@param fragmentShader - effect fragment shader program
+        *@param tableShader - summed-area table fragment shader program
         *@return true on success, otherwise false
         */
         bool Initialize(std::size_t  width,
                         std::size_t  height,
                   const std::string& vertexShader,
-                  const std::string& fragmentShader);
+                  const std::string& fragmentShader,
+                  const std::string& tableShader);
+
+        /**
+        * Builds the summed-area table of the scene texture
+        *@return the summed-area table texture index in m_TableTextureID
+        */
+        std::size_t BuildTable() const;
+
+        /**
+        * Deletes the summed-area table textures and buffers
+        */
+        void DeleteTable();
 
         /**
         * Configures the effect
@@ -0,0 +1,799 @@
+/****************************************************************************
+ * ==> CSR_PostProcessingGraph ---------------------------------------------*
+ ****************************************************************************
+ * Description : This module provides a post-processing graph, which chains *
+ *               several passes and shares their render targets             *
+ * Developer   : Jean-Milost Reymond                                        *
+ * Copyright   : 2017 - 2022, this file is part of the CompactStar Engine.  *
+ *               You are free to copy or redistribute this file, modify it, *
+ *               or use it for your own projects, commercial or not. This   *
+ *               file is provided "as is", WITHOUT ANY WARRANTY OF ANY      *
+ *               KIND. THE DEVELOPER IS NOT RESPONSIBLE FOR ANY DAMAGE OF   *
+ *               ANY KIND, ANY LOSS OF DATA, OR ANY LOSS OF PRODUCTIVITY    *
+ *               TIME THAT MAY RESULT FROM THE USAGE OF THIS SOURCE CODE,   *
+ *               DIRECTLY OR NOT.                                           *
+ ****************************************************************************/
+
+#include "CSR_PostProcessingGraph.h"
+
+// std
+#include <memory>
+#include <algorithm>
+#include <sstream>
+
+// compactStar engine
+#include "CSR_Renderer.h"
+
+//---------------------------------------------------------------------------
+// CSR_PostProcessingGraph::IPass
+//---------------------------------------------------------------------------
+CSR_PostProcessingGraph::IPass::IPass() :
+    m_Format(IE_F_RGBA8),
+    m_Scale(1.0f),
+    m_fOnSetUniforms(0),
+    m_pData(0)
+{}
+//---------------------------------------------------------------------------
+CSR_PostProcessingGraph::IPass::~IPass()
+{}
+//---------------------------------------------------------------------------
+// CSR_PostProcessingGraph::ITarget
+//---------------------------------------------------------------------------
+CSR_PostProcessingGraph::ITarget::ITarget() :
+    m_Width(0),
+    m_Height(0),
+    m_Format(IE_F_RGBA8),
+    m_TextureID(0),
+    m_FrameBufferID(0)
+{}
+//---------------------------------------------------------------------------
+CSR_PostProcessingGraph::ITarget::~ITarget()
+{
+    // delete the target frame buffer
+    if (m_FrameBufferID)
+        glDeleteFramebuffers(1, &m_FrameBufferID);
+
+    // delete the target texture
+    if (m_TextureID)
+        glDeleteTextures(1, &m_TextureID);
+}
+//---------------------------------------------------------------------------
+// CSR_PostProcessingGraph::IStep
+//---------------------------------------------------------------------------
+CSR_PostProcessingGraph::IStep::IStep() :
+    m_pShader(0),
+    m_ViewportSlot(-1),
+    m_Target(-1),
+    m_Width(0),
+    m_Height(0)
+{}
+//---------------------------------------------------------------------------
+CSR_PostProcessingGraph::IStep::~IStep()
+{
+    // delete the step shader
+    if (m_pShader)
+        csrOpenGLShaderRelease(m_pShader);
+}
+//---------------------------------------------------------------------------
+// CSR_PostProcessingGraph
+//---------------------------------------------------------------------------
+CSR_PostProcessingGraph::CSR_PostProcessingGraph(std::size_t samples) :
+    CSR_PostProcessingEffect(),
+    m_SceneTextureID(0),
+    m_Samples(samples ? samples : 1),
+    m_Width(0),
+    m_Height(0)
+{
+    // the base effect members are only used for the scene and the surface to draw
+    m_pShader         = 0;
+    m_pStaticBuffer   = 0;
+    m_FrameBufferID   = 0;
+    m_RenderBufferID  = 0;
+    m_TextureBufferID = 0;
+    m_TextureID       = 0;
+}
+//---------------------------------------------------------------------------
+CSR_PostProcessingGraph::~CSR_PostProcessingGraph()
+{
+    DeleteSteps();
+    DeleteTargets();
+    DeleteScene();
+}
+//---------------------------------------------------------------------------
+void CSR_PostProcessingGraph::Clear()
+{
+    DeleteSteps();
+    DeleteTargets();
+
+    m_Passes.clear();
+}
+//---------------------------------------------------------------------------
+void CSR_PostProcessingGraph::AddPass(const IPass& pass)
+{
+    m_Passes.push_back(pass);
+}
+//---------------------------------------------------------------------------
+std::size_t CSR_PostProcessingGraph::GetPassCount() const
+{
+    return m_Passes.size();
+}
+//---------------------------------------------------------------------------
+bool CSR_PostProcessingGraph::Compile(std::size_t width, std::size_t height)
+{
+    // delete the previous compiled passes. The render targets are kept, to be reused if possible
+    DeleteSteps();
+
+    // nothing to compile?
+    if (m_Passes.empty())
+    {
+        DeleteTargets();
+        DeleteScene();
+        return true;
+    }
+
+    // (re)create the scene frame buffer if the viewport size changed
+    if (!m_FrameBufferID || width != m_Width || height != m_Height)
+    {
+        DeleteScene();
+
+        if (!CreateScene(width, height))
+            return false;
+    }
+
+    // build the compiled passes and assign their render targets
+    if (!BuildSteps() || !AssignTargets())
+    {
+        DeleteSteps();
+        return false;
+    }
+
+    return true;
+}
+//---------------------------------------------------------------------------
+std::size_t CSR_PostProcessingGraph::GetCompiledPassCount() const
+{
+    return m_Steps.size();
+}
+//---------------------------------------------------------------------------
+std::size_t CSR_PostProcessingGraph::GetTargetCount() const
+{
+    return m_Targets.size();
+}
+//---------------------------------------------------------------------------
+bool CSR_PostProcessingGraph::SetSamples(std::size_t samples)
+{
+    if (!samples)
+        samples = 1;
+
+    // nothing to change?
+    if (samples == m_Samples)
+        return true;
+
+    m_Samples = samples;
+
+    // no scene created yet?
+    if (!m_FrameBufferID)
+        return true;
+
+    const std::size_t width  = m_Width;
+    const std::size_t height = m_Height;
+
+    // recreate the scene frame buffer with the new sample count
+    DeleteScene();
+
+    return CreateScene(width, height);
+}
+//---------------------------------------------------------------------------
+bool CSR_PostProcessingGraph::ChangeSize(std::size_t width, std::size_t height)
+{
+    // not compiled yet?
+    if (m_Steps.empty())
+        return Compile(width, height);
+
+    // nothing to change?
+    if (width == m_Width && height == m_Height)
+        return true;
+
+    // recreate the scene frame buffer, and reassign the render targets, those of the previous
+    // size being deleted. The step shaders are kept
+    DeleteScene();
+
+    if (!CreateScene(width, height) || !AssignTargets())
+    {
+        DeleteSteps();
+        return false;
+    }
+
+    return true;
+}
+//---------------------------------------------------------------------------
+void CSR_PostProcessingGraph::DrawBegin(const CSR_Color* pColor) const
+{
+    // do apply the passes?
+    if (!m_Steps.empty())
+    {
+        // enable multisampling
+        glEnable(GL_MULTISAMPLE);
+
+        // bind the frame buffer on which the scene should be drawn
+        glBindFramebuffer(GL_FRAMEBUFFER, m_FrameBufferID);
+    }
+
+    // begin the draw
+    csrDrawBegin(pColor);
+}
+//---------------------------------------------------------------------------
+void CSR_PostProcessingGraph::DrawEnd() const
+{
+    // end the draw
+    csrDrawEnd();
+
+    // do apply the passes?
+    if (m_Steps.empty() || !m_pStaticBuffer)
+        return;
+
+    // configure the culling
+    glEnable(GL_CULL_FACE);
+    glCullFace(GL_FRONT);
+    glFrontFace(GL_CW);
+
+    // disable the alpha blending
+    glDisable(GL_BLEND);
+
+    // set polygon mode to fill
+    glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+
+    // blit the multisampled buffer containing the scene to the scene texture buffer
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, m_FrameBufferID);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_TextureBufferID);
+    glBlitFramebuffer(0,
+                      0,
+                      m_Width,
+                      m_Height,
+                      0,
+                      0,
+                      m_Width,
+                      m_Height,
+                      GL_COLOR_BUFFER_BIT,
+                      GL_NEAREST);
+
+    // configure the depth testing
+    glDisable(GL_DEPTH_TEST);
+
+    // bind the VBO containing the surface to draw, shared by all the passes
+    glBindBuffer(GL_ARRAY_BUFFER, m_pStaticBuffer->m_BufferID);
+
+    for (std::size_t i = 0; i < m_Steps.size(); ++i)
+    {
+        const IStep* pStep = m_Steps[i];
+
+        // bind the frame buffer on which the pass should draw, the last one draws on the screen
+        if (pStep->m_Target >= 0)
+            glBindFramebuffer(GL_FRAMEBUFFER, m_Targets[pStep->m_Target]->m_FrameBufferID);
+        else
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+        glViewport(0, 0, pStep->m_Width, pStep->m_Height);
+
+        // enable the pass shader
+        csrShaderEnable(pStep->m_pShader);
+
+        // set the viewport values
+        glUniform2f(pStep->m_ViewportSlot, float(pStep->m_Width), float(pStep->m_Height));
+
+        // bind the input textures, each on its own texture unit
+        for (std::size_t j = 0; j < pStep->m_Inputs.size(); ++j)
+        {
+            glActiveTexture(GLenum(GL_TEXTURE0 + j));
+
+            if (pStep->m_Inputs[j] >= 0)
+                glBindTexture(GL_TEXTURE_2D, m_Targets[pStep->m_Inputs[j]]->m_TextureID);
+            else
+                glBindTexture(GL_TEXTURE_2D, m_TextureID);
+
+            glUniform1i(pStep->m_InputSlots[j], GLint(j));
+        }
+
+        // let the passes set their own uniforms
+        for (std::size_t j = 0; j < pStep->m_Passes.size(); ++j)
+        {
+            const IPass& pass = m_Passes[pStep->m_Passes[j]];
+
+            if (pass.m_fOnSetUniforms)
+                pass.m_fOnSetUniforms(pStep->m_pShader, pass.m_pData);
+        }
+
+        // enable the vertices
+        glEnableVertexAttribArray(pStep->m_pShader->m_VertexSlot);
+        glVertexAttribPointer(pStep->m_pShader->m_VertexSlot,
+                              2,
+                              GL_FLOAT,
+                              GL_FALSE,
+                              m_pStaticBuffer->m_Stride * sizeof(float),
+                              0);
+
+        // draw the surface
+        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+
+        // disable the vertex attribute array
+        glDisableVertexAttribArray(pStep->m_pShader->m_VertexSlot);
+    }
+
+    // unbind the VBO
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    // restore the default texture unit and the viewport
+    glActiveTexture(GL_TEXTURE0);
+    glViewport(0, 0, m_Width, m_Height);
+}
+//---------------------------------------------------------------------------
+bool CSR_PostProcessingGraph::CreateScene(std::size_t width, std::size_t height)
+{
+    // enable multisampling
+    glEnable(GL_MULTISAMPLE);
+
+    // create and bind the frame buffer
+    glGenFramebuffers(1, &m_FrameBufferID);
+    glBindFramebuffer(GL_FRAMEBUFFER, m_FrameBufferID);
+
+    // create the multisampled texture on which the scene will be drawn
+    glGenTextures(1, &m_SceneTextureID);
+    glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, m_SceneTextureID);
+    glTexImage2DMultisample(GL_TEXTURE_2D_MULTISAMPLE, m_Samples, GL_RGBA8, width, height, GL_TRUE);
+    glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, 0);
+
+    // add texture to the frame buffer
+    glFramebufferTexture2D(GL_FRAMEBUFFER,
+                           GL_COLOR_ATTACHMENT0,
+                           GL_TEXTURE_2D_MULTISAMPLE,
+                           m_SceneTextureID,
+                           0);
+
+    // create and bind the render buffer for depth and stencil attachments
+    glGenRenderbuffers(1, &m_RenderBufferID);
+    glBindRenderbuffer(GL_RENDERBUFFER, m_RenderBufferID);
+    glRenderbufferStorageMultisample(GL_RENDERBUFFER,
+                                     m_Samples,
+                                     GL_DEPTH24_STENCIL8,
+                                     width,
+                                     height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER,
+                              GL_DEPTH_STENCIL_ATTACHMENT,
+                              GL_RENDERBUFFER,
+                              m_RenderBufferID);
+
+    // build the frame buffer
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+    {
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        return false;
+    }
+
+    // create the texture in which the scene is resolved, read by the passes
+    glGenTextures(1, &m_TextureID);
+    glBindTexture(GL_TEXTURE_2D, m_TextureID);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, 0);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S,     GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T,     GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    // create and bind the scene texture buffer
+    glGenFramebuffers(1, &m_TextureBufferID);
+    glBindFramebuffer(GL_FRAMEBUFFER, m_TextureBufferID);
+    glFramebufferTexture2D(GL_FRAMEBUFFER,
+                           GL_COLOR_ATTACHMENT0,
+                           GL_TEXTURE_2D,
+                           m_TextureID,
+                           0);
+
+    // build the scene texture buffer
+    const bool success = (glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE);
+
+    // unbind the texture buffer
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    if (!success)
+        return false;
+
+    // set the viewport size
+    m_Width  = width;
+    m_Height = height;
+
+    return true;
+}
+//---------------------------------------------------------------------------
+void CSR_PostProcessingGraph::DeleteScene()
+{
+    // delete the scene texture
+    if (m_TextureID)
+    {
+        glDeleteTextures(1, &m_TextureID);
+        m_TextureID = 0;
+    }
+
+    // delete the scene texture buffer
+    if (m_TextureBufferID)
+    {
+        glDeleteFramebuffers(1, &m_TextureBufferID);
+        m_TextureBufferID = 0;
+    }
+
+    // delete the multisampled scene texture
+    if (m_SceneTextureID)
+    {
+        glDeleteTextures(1, &m_SceneTextureID);
+        m_SceneTextureID = 0;
+    }
+
+    // delete the render buffer
+    if (m_RenderBufferID)
+    {
+        glDeleteRenderbuffers(1, &m_RenderBufferID);
+        m_RenderBufferID = 0;
+    }
+
+    // delete the frame buffer
+    if (m_FrameBufferID)
+    {
+        glDeleteFramebuffers(1, &m_FrameBufferID);
+        m_FrameBufferID = 0;
+    }
+
+    m_Width  = 0;
+    m_Height = 0;
+}
+//---------------------------------------------------------------------------
+bool CSR_PostProcessingGraph::BuildSteps()
+{
+    const std::string vertexShader =
+        "precision mediump float;"
+        "attribute vec4 csr_vVertex;"
+        "void main(void)"
+        "{"
+        "    gl_Position = vec4(csr_vVertex.x, csr_vVertex.y, 0.0f, 1.0f);"
+        "}";
+
+    for (std::size_t i = 0; i < m_Passes.size(); ++i)
+    {
+        const IPass& pass = m_Passes[i];
+
+        // a per-pixel pass reads a single input
+        if (pass.m_Shader.empty() && pass.m_Inputs.size() != 1)
+            return false;
+
+        // can the pass be fused with the previous one? This is possible if both are per-pixel
+        // passes of the same size and format, and if the previous pass output is only read by
+        // this pass
+        if (!m_Steps.empty() && pass.m_Shader.empty())
+        {
+                  IStep* pStep = m_Steps.back();
+            const IPass& prev  = m_Passes[pStep->m_Passes.back()];
+
+            if (prev.m_Shader.empty()                &&
+                prev.m_Output == pass.m_Inputs[0]    &&
+                prev.m_Format == pass.m_Format       &&
+                prev.m_Scale  == pass.m_Scale        &&
+                prev.m_Output != "scene")
+            {
+                std::size_t readCount = 0;
+
+                // count the passes reading the previous pass output before it's written again
+                for (std::size_t j = i; j < m_Passes.size(); ++j)
+                {
+                    for (std::size_t k = 0; k < m_Passes[j].m_Inputs.size(); ++k)
+                        if (m_Passes[j].m_Inputs[k] == prev.m_Output)
+                            ++readCount;
+
+                    if (m_Passes[j].m_Output == prev.m_Output)
+                        break;
+                }
+
+                if (readCount == 1)
+                {
+                    pStep->m_Passes.push_back(i);
+                    continue;
+                }
+            }
+        }
+
+        std::auto_ptr<IStep> pStep(new IStep());
+        pStep->m_Passes.push_back(i);
+
+        // find the steps writing the pass inputs, which are read in their render targets once
+        // the targets are assigned
+        for (std::size_t j = 0; j < pass.m_Inputs.size(); ++j)
+        {
+            const int writer = FindWriter(pass.m_Inputs[j], m_Steps.size());
+
+            // unknown resource?
+            if (writer < 0 && pass.m_Inputs[j] != "scene")
+                return false;
+
+            pStep->m_Writers.push_back(writer);
+        }
+
+        m_Steps.push_back(pStep.release());
+    }
+
+    for (std::size_t i = 0; i < m_Steps.size(); ++i)
+    {
+        IStep*      pStep = m_Steps[i];
+        std::string fragmentShader;
+
+        // build the step fragment shader
+        if (pStep->m_Passes.size() == 1 && !m_Passes[pStep->m_Passes[0]].m_Shader.empty())
+            fragmentShader = m_Passes[pStep->m_Passes[0]].m_Shader;
+        else
+        {
+            std::ostringstream sstr;
+
+            sstr << "precision highp float;"
+                 << "uniform sampler2D csr_sInput0;"
+                 << "uniform vec2      csr_vViewport;";
+
+            for (std::size_t j = 0; j < pStep->m_Passes.size(); ++j)
+                sstr << m_Passes[pStep->m_Passes[j]].m_PixelUniforms;
+
+            sstr << "void main(void)"
+                 << "{"
+                 << "    vec4 color = texture(csr_sInput0, gl_FragCoord.xy / csr_vViewport);";
+
+            // each fused pass transforms the color in turn
+            for (std::size_t j = 0; j < pStep->m_Passes.size(); ++j)
+                sstr << "{" << m_Passes[pStep->m_Passes[j]].m_PixelCode << "}";
+
+            sstr << "    gl_FragColor = color;"
+                 << "}";
+
+            fragmentShader = sstr.str();
+        }
+
+        // load the step shader. The surface to draw is created with the first shader
+        pStep->m_pShader = csrOpenGLShaderLoadFromStr(vertexShader.c_str(),
+                                                      vertexShader.length(),
+                                                      fragmentShader.c_str(),
+                                                      fragmentShader.length(),
+                                                      m_pStaticBuffer ? 0 : OnLinkStaticSurface,
+                                                      this);
+
+        // succeeded?
+        if (!pStep->m_pShader || !m_pStaticBuffer)
+            return false;
+
+        // enable the step shader
+        csrShaderEnable(pStep->m_pShader);
+
+        // get the vertex slot
+        pStep->m_pShader->m_VertexSlot = glGetAttribLocation(pStep->m_pShader->m_ProgramID,
+                                                             "csr_vVertex");
+
+        // found it?
+        if (pStep->m_pShader->m_VertexSlot == -1)
+            return false;
+
+        // get the viewport slot. It may be missing if the shader doesn't use it
+        pStep->m_ViewportSlot = glGetUniformLocation(pStep->m_pShader->m_ProgramID, "csr_vViewport");
+
+        // get the input sampler slots
+        for (std::size_t j = 0; j < pStep->m_Writers.size(); ++j)
+        {
+            std::ostringstream sstr;
+            sstr << "csr_sInput" << j;
+
+            pStep->m_InputSlots.push_back(glGetUniformLocation(pStep->m_pShader->m_ProgramID,
+                                                               sstr.str().c_str()));
+        }
+    }
+
+    return true;
+}
+//---------------------------------------------------------------------------
+bool CSR_PostProcessingGraph::AssignTargets()
+{
+    const std::size_t stepCount = m_Steps.size();
+
+    std::vector<std::size_t> lastRead(stepCount);
+    std::vector<bool>        inUse(m_Targets.size(), false);
+    std::vector<bool>        used(m_Targets.size(),  false);
+
+    // find the last step reading each step output. An output never read is released as soon as
+    // it's written
+    for (std::size_t i = 0; i < stepCount; ++i)
+    {
+        lastRead[i] = i;
+
+        for (std::size_t j = i + 1; j < stepCount; ++j)
+            for (std::size_t k = 0; k < m_Steps[j]->m_Writers.size(); ++k)
+                if (m_Steps[j]->m_Writers[k] == int(i))
+                    lastRead[i] = j;
+    }
+
+    for (std::size_t i = 0; i < stepCount; ++i)
+    {
+        IStep*       pStep = m_Steps[i];
+        const IPass& pass  = m_Passes[pStep->m_Passes.back()];
+
+        // the inputs are read in the render targets their writers were assigned to. The targets
+        // may be assigned again, e.g. after the viewport size changed
+        pStep->m_Inputs.clear();
+        pStep->m_Target = -1;
+
+        for (std::size_t j = 0; j < pStep->m_Writers.size(); ++j)
+            if (pStep->m_Writers[j] >= 0)
+                pStep->m_Inputs.push_back(m_Steps[pStep->m_Writers[j]]->m_Target);
+            else
+                pStep->m_Inputs.push_back(-1);
+
+        // the last step draws on the screen
+        if (i == stepCount - 1)
+        {
+            pStep->m_Width  = m_Width;
+            pStep->m_Height = m_Height;
+            pStep->m_Target = -1;
+            break;
+        }
+
+        pStep->m_Width  = std::max(std::size_t(float(m_Width)  * pass.m_Scale), std::size_t(1));
+        pStep->m_Height = std::max(std::size_t(float(m_Height) * pass.m_Scale), std::size_t(1));
+
+        // search for a free render target of the same size and format in the pool. The inputs
+        // aren't released yet, so the step never writes a target it reads
+        for (std::size_t j = 0; j < m_Targets.size(); ++j)
+            if (!inUse[j]                                  &&
+                m_Targets[j]->m_Width  == pStep->m_Width   &&
+                m_Targets[j]->m_Height == pStep->m_Height  &&
+                m_Targets[j]->m_Format == pass.m_Format)
+            {
+                pStep->m_Target = int(j);
+                break;
+            }
+
+        // none found, create a new one
+        if (pStep->m_Target < 0)
+        {
+            std::auto_ptr<ITarget> pTarget(new ITarget());
+            pTarget->m_Width  = pStep->m_Width;
+            pTarget->m_Height = pStep->m_Height;
+            pTarget->m_Format = pass.m_Format;
+
+            GLint  internalFormat;
+            GLenum type;
+            GLint  filter;
+
+            switch (pass.m_Format)
+            {
+                case IE_F_RGBA16F:
+                    internalFormat = GL_RGBA16F;
+                    type           = GL_HALF_FLOAT;
+                    filter         = GL_LINEAR;
+                    break;
+
+                // the 32 bit float textures aren't always filterable
+                case IE_F_RGBA32F:
+                    internalFormat = GL_RGBA32F;
+                    type           = GL_FLOAT;
+                    filter         = GL_NEAREST;
+                    break;
+
+                default:
+                    internalFormat = GL_RGBA8;
+                    type           = GL_UNSIGNED_BYTE;
+                    filter         = GL_LINEAR;
+                    break;
+            }
+
+            // create the target texture
+            glGenTextures(1, &pTarget->m_TextureID);
+            glBindTexture(GL_TEXTURE_2D, pTarget->m_TextureID);
+            glTexImage2D(GL_TEXTURE_2D,
+                         0,
+                         internalFormat,
+                         pTarget->m_Width,
+                         pTarget->m_Height,
+                         0,
+                         GL_RGBA,
+                         type,
+                         0);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S,     GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T,     GL_CLAMP_TO_EDGE);
+            glBindTexture(GL_TEXTURE_2D, 0);
+
+            // create the target frame buffer
+            glGenFramebuffers(1, &pTarget->m_FrameBufferID);
+            glBindFramebuffer(GL_FRAMEBUFFER, pTarget->m_FrameBufferID);
+            glFramebufferTexture2D(GL_FRAMEBUFFER,
+                                   GL_COLOR_ATTACHMENT0,
+                                   GL_TEXTURE_2D,
+                                   pTarget->m_TextureID,
+                                   0);
+
+            // build the target frame buffer
+            const bool success = (glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE);
+
+            // unbind the target frame buffer
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+            if (!success)
+                return false;
+
+            pStep->m_Target = int(m_Targets.size());
+            m_Targets.push_back(pTarget.release());
+            inUse.push_back(false);
+            used.push_back(false);
+        }
+
+        inUse[pStep->m_Target] = true;
+        used[pStep->m_Target]  = true;
+
+        // release the targets read for the last time by this step, and its own output if it's
+        // never read
+        for (std::size_t j = 0; j <= i; ++j)
+            if (lastRead[j] == i && m_Steps[j]->m_Target >= 0)
+                inUse[m_Steps[j]->m_Target] = false;
+    }
+
+    // delete the pooled targets no longer used, e.g. after the viewport size changed
+    std::vector<int> remap(m_Targets.size(), -1);
+    std::size_t      count = 0;
+
+    for (std::size_t i = 0; i < m_Targets.size(); ++i)
+        if (used[i])
+        {
+            remap[i]           = int(count);
+            m_Targets[count++] = m_Targets[i];
+        }
+        else
+            delete m_Targets[i];
+
+    m_Targets.resize(count);
+
+    for (std::size_t i = 0; i < stepCount; ++i)
+    {
+        IStep* pStep = m_Steps[i];
+
+        if (pStep->m_Target >= 0)
+            pStep->m_Target = remap[pStep->m_Target];
+
+        for (std::size_t j = 0; j < pStep->m_Inputs.size(); ++j)
+            if (pStep->m_Inputs[j] >= 0)
+                pStep->m_Inputs[j] = remap[pStep->m_Inputs[j]];
+    }
+
+    return true;
+}
+//---------------------------------------------------------------------------
+int CSR_PostProcessingGraph::FindWriter(const std::string& name, std::size_t last) const
+{
+    // the scene isn't written by a step
+    if (name == "scene")
+        return -1;
+
+    // search for the last step writing the resource, which is always its last fused pass
+    for (std::size_t i = last; i > 0; --i)
+        if (m_Passes[m_Steps[i - 1]->m_Passes.back()].m_Output == name)
+            return int(i - 1);
+
+    return -1;
+}
+//---------------------------------------------------------------------------
+void CSR_PostProcessingGraph::DeleteSteps()
+{
+    for (std::size_t i = 0; i < m_Steps.size(); ++i)
+        delete m_Steps[i];
+
+    m_Steps.clear();
+}
+//---------------------------------------------------------------------------
+void CSR_PostProcessingGraph::DeleteTargets()
+{
+    for (std::size_t i = 0; i < m_Targets.size(); ++i)
+        delete m_Targets[i];
+
+    m_Targets.clear();
+}
+//---------------------------------------------------------------------------
@@ -0,0 +1,253 @@
+/****************************************************************************
+ * ==> CSR_PostProcessingGraph ---------------------------------------------*
+ ****************************************************************************
+ * Description : This module provides a post-processing graph, which chains *
+ *               several passes and shares their render targets             *
+ * Developer   : Jean-Milost Reymond                                        *
+ * Copyright   : 2017 - 2022, this file is part of the CompactStar Engine.  *
+ *               You are free to copy or redistribute this file, modify it, *
+ *               or use it for your own projects, commercial or not. This   *
+ *               file is provided "as is", WITHOUT ANY WARRANTY OF ANY      *
+ *               KIND. THE DEVELOPER IS NOT RESPONSIBLE FOR ANY DAMAGE OF   *
+ *               ANY KIND, ANY LOSS OF DATA, OR ANY LOSS OF PRODUCTIVITY    *
+ *               TIME THAT MAY RESULT FROM THE USAGE OF THIS SOURCE CODE,   *
+ *               DIRECTLY OR NOT.                                           *
+ ****************************************************************************/
+
+#ifndef CSR_PostProcessingGraphH
+#define CSR_PostProcessingGraphH
+
+// std
+#include <string>
+#include <vector>
+
+// classes
+#include "CSR_PostProcessingEffect.h"
+
+/**
+* Post-processing graph
+*@note The scene is drawn in the "scene" resource, then the passes are executed in the order they
+*      were added. Each pass reads its input resources and writes its output resource, and the
+*      last pass writes on the screen
+*@note The render targets are taken from a pool, by size and format. A target is reused by
+*      another pass as soon as its resource was read for the last time
+*@note The consecutive per-pixel passes, i.e. the ones which only read their single input at the
+*      drawn pixel, are fused in a single pass when the intermediate resource isn't read elsewhere
+*@author Jean-Milost Reymond
+*/
+class CSR_PostProcessingGraph : public CSR_PostProcessingEffect
+{
+    public:
+        /**
+        * Render target formats
+        */
+        enum IEFormat
+        {
+            IE_F_RGBA8 = 0,
+            IE_F_RGBA16F,
+            IE_F_RGBA32F
+        };
+
+        /**
+        * Called when the pass uniforms should be set, the pass shader being enabled
+        *@param pShader - pass shader, which may contain several fused passes
+        *@param pData - pass custom data
+        */
+        typedef void (*ITfOnSetUniforms)(const CSR_OpenGLShader* pShader, void* pData);
+
+        typedef std::vector<std::string> IResources;
+
+        /**
+        * Post-processing pass
+        *@note A full pass provides its whole fragment shader, in which its inputs are read with
+        *      the csr_sInput0, csr_sInput1, ... samplers, and the output size is csr_vViewport
+        *@note A per-pixel pass only provides the code transforming the vec4 color variable, which
+        *      contains the input color at the drawn pixel. Its uniforms are declared separately,
+        *      and should have unique names, as the pass may be fused with others
+        */
+        struct IPass
+        {
+            std::string      m_Name;
+            IResources       m_Inputs;         // read resources
+            std::string      m_Output;         // written resource, ignored by the last pass
+            IEFormat         m_Format;         // output format
+            float            m_Scale;          // output size, relative to the viewport size
+            std::string      m_Shader;         // full pass fragment shader
+            std::string      m_PixelCode;      // per-pixel pass code, used if the shader is empty
+            std::string      m_PixelUniforms;  // per-pixel pass uniform declarations
+            ITfOnSetUniforms m_fOnSetUniforms; // ignored if 0
+            void*            m_pData;          // custom data passed to m_fOnSetUniforms
+
+            IPass();
+            virtual ~IPass();
+        };
+
+        /**
+        * Constructor
+        *@param samples - scene multisampling sample count, 1 to disable the multisampling
+        */
+        CSR_PostProcessingGraph(std::size_t samples);
+
+        /**
+        * Destructor
+        */
+        virtual ~CSR_PostProcessingGraph();
+
+        /**
+        * Clears the passes
+        *@note The graph should be compiled again, see Compile()
+        */
+        virtual void Clear();
+
+        /**
+        * Adds a pass
+        *@param pass - pass to add
+        *@note The graph should be compiled again, see Compile()
+        */
+        virtual void AddPass(const IPass& pass);
+
+        /**
+        * Gets the pass count
+        *@return the pass count
+        */
+        virtual std::size_t GetPassCount() const;
+
+        /**
+        * Compiles the graph, i.e. fuses the passes, builds their shaders and assigns their targets
+        *@param width - viewport width
+        *@param height - viewport height
+        *@return true on success, otherwise false
+        */
+        virtual bool Compile(std::size_t width, std::size_t height);
+
+        /**
+        * Gets the compiled pass count, after the passes were fused
+        *@return the compiled pass count
+        */
+        virtual std::size_t GetCompiledPassCount() const;
+
+        /**
+        * Gets the render target count in the pool
+        *@return the render target count
+        */
+        virtual std::size_t GetTargetCount() const;
+
+        /**
+        * Sets the scene multisampling sample count
+        *@param samples - sample count, 1 to disable the multisampling
+        *@return true on success, otherwise false
+        */
+        virtual bool SetSamples(std::size_t samples);
+
+        /**
+        * Changes the effect viewport size
+        *@param width - new width to apply
+        *@param height - new height to apply
+        *@return true on success, otherwise false
+        *@note Only the scene and the render targets are created again, once the graph is compiled
+        */
+        virtual bool ChangeSize(std::size_t width, std::size_t height);
+
+        /**
+        * Begins a draw process at the end of which the passes will be applied
+        *@param pColor - scene background color
+        */
+        virtual void DrawBegin(const CSR_Color* pColor) const;
+
+        /**
+        * Ends the draw process and applies the passes
+        */
+        virtual void DrawEnd() const;
+
+    private:
+        /**
+        * Render target
+        */
+        struct ITarget
+        {
+            std::size_t m_Width;
+            std::size_t m_Height;
+            IEFormat    m_Format;
+            GLuint      m_TextureID;
+            GLuint      m_FrameBufferID;
+
+            ITarget();
+            virtual ~ITarget();
+        };
+
+        /**
+        * Compiled pass, i.e. one or several fused passes
+        */
+        struct IStep
+        {
+            CSR_OpenGLShader*        m_pShader;
+            std::vector<std::size_t> m_Passes;   // fused passes, in order
+            std::vector<int>         m_Writers;  // steps writing the inputs, -1 for the scene
+            std::vector<int>         m_Inputs;   // input target indices, -1 for the scene
+            std::vector<GLint>       m_InputSlots;
+            GLint                    m_ViewportSlot;
+            int                      m_Target;   // output target index, -1 for the screen
+            std::size_t              m_Width;
+            std::size_t              m_Height;
+
+            IStep();
+            virtual ~IStep();
+        };
+
+        typedef std::vector<IPass>    IPasses;
+        typedef std::vector<ITarget*> ITargets;
+        typedef std::vector<IStep*>   ISteps;
+
+        IPasses     m_Passes;
+        ITargets    m_Targets;        // render target pool
+        ISteps      m_Steps;          // compiled passes
+        GLuint      m_SceneTextureID; // multisampled texture on which the scene is drawn
+        std::size_t m_Samples;
+        std::size_t m_Width;
+        std::size_t m_Height;
+
+        /**
+        * Creates the scene frame buffer and its resolved texture
+        *@param width - viewport width
+        *@param height - viewport height
+        *@return true on success, otherwise false
+        */
+        bool CreateScene(std::size_t width, std::size_t height);
+
+        /**
+        * Deletes the scene frame buffer and its resolved texture
+        */
+        void DeleteScene();
+
+        /**
+        * Builds the compiled passes, fusing the per-pixel passes
+        *@return true on success, otherwise false
+        */
+        bool BuildSteps();
+
+        /**
+        * Assigns a render target of the pool to each compiled pass output
+        *@return true on success, otherwise false
+        */
+        bool AssignTargets();
+
+        /**
+        * Gets the compiled pass writing a resource
+        *@param name - resource name
+        *@param last - compiled pass index before which the resource should be written
+        *@return compiled pass index, -1 if the resource is the scene or isn't found
+        */
+        int FindWriter(const std::string& name, std::size_t last) const;
+
+        /**
+        * Deletes the compiled passes
+        */
+        void DeleteSteps();
+
+        /**
+        * Deletes the render targets
+        */
+        void DeleteTargets();
+};
+
+#endif
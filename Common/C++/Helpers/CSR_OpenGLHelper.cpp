@@ -379,7 +379,7 @@ void CSR_OpenGLHelper::AddTexture(const std::string& key, GLuint id, IResources&
     pID.release();
 }
 //---------------------------------------------------------------------------
-void CSR_OpenGLHelper::DeleteTexture(const void* pKey, IResources& resources)
+void CSR_OpenGLHelper::DeleteTexture(const void* pKey, IResources& resources, CSR_OpenGLTextureCache* pCache)
 {
     // search the matching texture in the OpenGL resources
     CSR_OpenGLHelper::IResources::iterator it = resources.find((void*)pKey);
@@ -396,8 +396,8 @@ void CSR_OpenGLHelper::DeleteTexture(const void* pKey, IResources& resources)
     if (it->second->m_UseCount)
         return;
 
-    // texture was used?
-    if (it->second->m_ID != GLint(M_CSR_Error_Code))
+    // texture was used? (a cached texture is released by its cache)
+    if (it->second->m_ID != GLint(M_CSR_Error_Code) && !csrOpenGLTextureCacheDrop(GLuint(it->second->m_ID), pCache))
         // release it
         glDeleteTextures(1, (GLuint*)(&it->second->m_ID));
 
@@ -406,7 +406,7 @@ void CSR_OpenGLHelper::DeleteTexture(const void* pKey, IResources& resources)
     resources.erase(it);
 }
 //---------------------------------------------------------------------------
-void CSR_OpenGLHelper::DeleteTexture(const std::string& key, IResources& resources)
+void CSR_OpenGLHelper::DeleteTexture(const std::string& key, IResources& resources, CSR_OpenGLTextureCache* pCache)
 {
     // search a matching texture in the OpenGL resources
     for (CSR_OpenGLHelper::IResources::iterator it = resources.begin(); it != resources.end(); ++it)
@@ -427,8 +427,8 @@ void CSR_OpenGLHelper::DeleteTexture(const std::string& key, IResources& resourc
         if (it->second->m_UseCount)
             return;
 
-        // texture was used?
-        if (it->second->m_ID != GLint(M_CSR_Error_Code))
+        // texture was used? (a cached texture is released by its cache)
+        if (it->second->m_ID != GLint(M_CSR_Error_Code) && !csrOpenGLTextureCacheDrop(GLuint(it->second->m_ID), pCache))
             // release it
             glDeleteTextures(1, (GLuint*)(&it->second->m_ID));
 
@@ -113,19 +113,23 @@ class CSR_OpenGLHelper
         * Deletes a texture from the GPU side
         *@param pKey - texture key to delete
         *@param resources - OpenGL resources owning the texture to delete
+        *@param pCache - texture cache, if the texture belongs to it, the texture is dropped from the
+        *                cache instead of being deleted
         *@note The texture will only be deleted on the GPU side, the pTexture object itself will not
         *      be modified
         */
-        static void DeleteTexture(const void* pKey, IResources& resources);
+        static void DeleteTexture(const void* pKey, IResources& resources, CSR_OpenGLTextureCache* pCache = NULL);
 
         /**
         * Deletes a texture from the GPU side
         *@param key - texture key to delete
         *@param resources - OpenGL resources owning the texture to delete
+        *@param pCache - texture cache, if the texture belongs to it, the texture is dropped from the
+        *                cache instead of being deleted
         *@note The texture will only be deleted on the GPU side, the pTexture object itself will not
         *      be modified
         */
-        static void DeleteTexture(const std::string& key, IResources& resources);
+        static void DeleteTexture(const std::string& key, IResources& resources, CSR_OpenGLTextureCache* pCache = NULL);
 
         /**
         * Gets the identifier matching with a texture
@@ -74,6 +74,51 @@ std::string CSR_ShaderHelper::GetVertexShader(IEShaderType type)
                        "    gl_Position   = csr_uProjection * csr_uView * csr_uModel * vec4(csr_aVertices, 1.0);"
                        "}";
 
+        #ifdef _MSC_VER
+            case CSR_ShaderHelper::IEShaderType::IE_ST_Skinned:
+        #else
+            case IE_ST_Skinned:
+        #endif
+            // the vertices are blended in the same way as csrSkinBindingApply() does, and the
+            // palette size should match with M_CSR_OpenGL_Max_Palette_Size. The precision
+            // qualifiers are omitted on desktop, where the strict GLSL 1.20 compilers reject them
+            #ifndef __APPLE__
+                return "#version 120\n"
+            #else
+                return "precision mediump float;"
+            #endif
+                       "attribute vec3 csr_aVertices;"
+                       "attribute vec4 csr_aColor;"
+                       "attribute vec2 csr_aTexCoord;"
+                       "attribute vec4 csr_aBoneIndices;"
+                       "attribute vec4 csr_aBoneWeights;"
+                       "uniform   mat4 csr_uProjection;"
+                       "uniform   mat4 csr_uView;"
+                       "uniform   mat4 csr_uModel;"
+                       "uniform   mat4 csr_uPalette[28];"
+                       "varying   vec4 csr_vColor;"
+                       "varying   vec2 csr_vTexCoord;"
+                       "void main(void)"
+                       "{"
+                       "    vec3 skinned   = vec3(0.0);"
+                       "    bool isSkinned = false;"
+                       "    for (int i = 0; i < 4; ++i)"
+                       "    {"
+                       "        float weight = csr_aBoneWeights[i];"
+                       "        if (weight > 0.0)"
+                       "        {"
+                       "            vec4 pos   = csr_uPalette[int(csr_aBoneIndices[i])] * vec4(csr_aVertices, 1.0);"
+                       "            skinned   += (pos.xyz / pos.w) * weight;"
+                       "            isSkinned  = true;"
+                       "        }"
+                       "    }"
+                       "    if (!isSkinned)"
+                       "        skinned = csr_aVertices;"
+                       "    csr_vColor    = csr_aColor;"
+                       "    csr_vTexCoord = csr_aTexCoord;"
+                       "    gl_Position   = csr_uProjection * csr_uView * csr_uModel * vec4(skinned, 1.0);"
+                       "}";
+
         #ifdef _MSC_VER
             case CSR_ShaderHelper::IEShaderType::IE_ST_Skybox:
         #else
@@ -262,6 +307,24 @@ std::string CSR_ShaderHelper::GetFragmentShader(IEShaderType type)
                        "    gl_FragColor = csr_vColor * texture2D(csr_sTexture, csr_vTexCoord);"
                        "}";
 
+        #ifdef _MSC_VER
+            case CSR_ShaderHelper::IEShaderType::IE_ST_Skinned:
+        #else
+            case IE_ST_Skinned:
+        #endif
+            #ifndef __APPLE__
+                return "#version 120\n"
+            #else
+                return "precision mediump float;"
+            #endif
+                       "uniform sampler2D csr_sTexture;"
+                       "varying vec4      csr_vColor;"
+                       "varying vec2      csr_vTexCoord;"
+                       "void main(void)"
+                       "{"
+                       "    gl_FragColor = csr_vColor * texture2D(csr_sTexture, csr_vTexCoord);"
+                       "}";
+
         #ifdef _MSC_VER
             case CSR_ShaderHelper::IEShaderType::IE_ST_Skybox:
         #else
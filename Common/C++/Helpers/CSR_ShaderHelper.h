@@ -44,7 +44,8 @@ class CSR_ShaderHelper
             IE_ST_Texture,
             IE_ST_Skybox,
             IE_ST_Line,
-            IE_ST_Water
+            IE_ST_Water,
+            IE_ST_Skinned  // textured, skinned on the GPU by a bone matrix palette
         };
 
         /**
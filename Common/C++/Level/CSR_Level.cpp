@@ -16,6 +16,9 @@
 
 #include "CSR_Level.h"
 
+// std
+#include <cctype>
+
 // classes
 #include "CSR_ShaderHelper.h"
 
@@ -113,24 +116,36 @@ void CSR_Level::ISound::Clear()
 //---------------------------------------------------------------------------
 // CSR_Level
 //---------------------------------------------------------------------------
-CSR_Level::CSR_Level() :
+CSR_Level::CSR_Level(CSR_OpenGLTextureCache* pTextureCache) :
     m_pOpenALDevice(NULL),
     m_pOpenALContext(NULL),
     m_pScene(NULL),
     m_pShader(NULL),
     m_pSkyboxShader(NULL),
+    m_pTextureCache(pTextureCache),
+    m_pMeshCache(NULL),
     m_pEffect(NULL),
+    m_pPostProcessing(NULL),
     m_pMSAA(NULL),
     m_pSound(NULL),
     m_pLandscapeKey(NULL),
     m_UseMSAA(false),
-    m_UseOilPainting(true)
+    m_UseOilPainting(true),
+    m_OwnTextureCache(!pTextureCache)
 {
     // initialize OpenAL
     csrSoundInitializeOpenAL(&m_pOpenALDevice, &m_pOpenALContext);
 
     // initialize the scene context
     csrSceneContextInit(&m_SceneContext);
+
+    // no texture cache shared by the caller? Create one for the level models
+    if (m_OwnTextureCache)
+        m_pTextureCache = csrOpenGLTextureCacheCreate(M_CSR_Default_Texture_Budget);
+
+    // create the post-processing graph, empty until passes are added to it. The scene is
+    // multisampled as set by the level
+    m_pPostProcessing = new CSR_PostProcessingGraph(m_UseMSAA ? 4 : 1);
 }
 //---------------------------------------------------------------------------
 CSR_Level::~CSR_Level()
@@ -144,6 +159,13 @@ CSR_Level::~CSR_Level()
     // delete the scene textures
     CSR_OpenGLHelper::ClearResources(m_OpenGLResources);
 
+    // release the texture cache, if owned by the level
+    if (m_OwnTextureCache)
+        csrOpenGLTextureCacheRelease(m_pTextureCache);
+
+    // release the mesh cache
+    csrMeshCacheRelease(m_pMeshCache);
+
     // release the shaders
     csrOpenGLShaderRelease(m_pSkyboxShader);
     csrOpenGLShaderRelease(m_pShader);
@@ -152,6 +174,10 @@ CSR_Level::~CSR_Level()
     if (m_pEffect)
         delete m_pEffect;
 
+    // release the post-processing graph
+    if (m_pPostProcessing)
+        delete m_pPostProcessing;
+
     // release the multisampling antialiasing
     csrOpenGLMSAARelease(m_pMSAA);
 
@@ -240,16 +266,22 @@ void CSR_Level::CreateViewport(float w, float h)
     else
         // change the effect viewport size
         m_pEffect->ChangeSize(w, h);
+
+    // resize the post-processing graph targets for the new viewport size
+    if (m_pPostProcessing->GetPassCount())
+        m_pPostProcessing->ChangeSize(w, h);
 }
 //---------------------------------------------------------------------------
-bool CSR_Level::AddSkybox(const IFileNames& fileNames, ITfLoadCubemap fLoadCubemap)
+bool CSR_Level::AddSkybox(const IFileNames&             fileNames,
+                                ITfLoadCubemap          fLoadCubemap,
+                          const CSR_PixelBuffer* const* pFaces)
 {
     // not enough or too many file names to load
     if (fileNames.size() != 6)
         return false;
 
-    // no load cubemap texture callback?
-    if (!fLoadCubemap)
+    // no decoded faces and no load cubemap texture callback?
+    if (!pFaces && !fLoadCubemap)
         return false;
 
     // is skybox shader still not loaded?
@@ -288,9 +320,9 @@ bool CSR_Level::AddSkybox(const IFileNames& fileNames, ITfLoadCubemap fLoadCubem
     // create the skybox
     m_pScene->m_pSkybox = csrSkyboxCreate(1.0f, 1.0f, 1.0f);
 
-    // load the cubemap texture
+    // load the cubemap texture, from the decoded faces if available
     CSR_OpenGLHelper::AddTexture(&m_pScene->m_pSkybox->m_Skin.m_CubeMap,
-                                  fLoadCubemap(fileNames),
+                                  pFaces ? csrOpenGLCubemapFromPixelBuffers(pFaces) : fLoadCubemap(fileNames),
                                   m_OpenGLResources);
 
     const std::size_t fileNameCount = fileNames.size();
@@ -979,18 +1011,10 @@ void* CSR_Level::AddSurface(const CSR_Matrix4&       matrix,
     return pSurface;
 }
 //---------------------------------------------------------------------------
-void* CSR_Level::AddWaveFront(const CSR_Matrix4&       matrix,
-                              const std::string&       fileName,
-                              const std::string&       textureName,
-                              const CSR_Buffer*        pBuffer,
-                                    CSR_ECollisionType collisionType,
-                                    ITfLoadTexture     fLoadTexture,
-                                    ITfSelectModel     fSelectModel)
+CSR_Model* CSR_Level::CreateWaveFront(const std::string&   fileName,
+                                      const CSR_Buffer*    pBuffer,
+                                      const CSR_MeshCache* pCache)
 {
-    // no load texture callback?
-    if (!fLoadTexture)
-        return NULL;
-
     CSR_Material material;
     material.m_Color       = 0xFFFFFFFF;
     material.m_Transparent = 0;
@@ -1007,18 +1031,124 @@ void* CSR_Level::AddWaveFront(const CSR_Matrix4&       matrix,
     vf.m_HasTexCoords      = 1;
     vf.m_HasPerVertexColor = 1;
 
-    CSR_Model* pModel;
+    // no mesh cache?
+    if (!pCache)
+    {
+        // load the Wavefront model (no texture was loaded yet, thus no delete texture callback is required)
+        if (pBuffer)
+            return csrWaveFrontCreate(pBuffer, &vf, &vc, &material, 0, 0, 0);
+
+        return csrWaveFrontOpen(fileName.c_str(), &vf, &vc, &material, 0, 0, 0);
+    }
+
+    // the file content is required to identify the cooked model
+    CSR_Buffer* pFile = NULL;
+
+    if (!pBuffer)
+    {
+        pFile = csrFileMap(fileName.c_str());
+
+        // succeeded?
+        if (!pFile)
+            return NULL;
+    }
+
+    // get the cooked model, or load and cook the Wavefront model
+    CSR_Model* pModel = csrMeshCacheGetWaveFront(pCache, pBuffer ? pBuffer : pFile, &vf, &vc, &material, 0, 0, 0);
+
+    csrBufferRelease(pFile);
+
+    return pModel;
+}
+//---------------------------------------------------------------------------
+CSR_MDL* CSR_Level::CreateMDL(const std::string&   fileName,
+                              const CSR_Buffer*    pBuffer,
+                              const CSR_MeshCache* pCache)
+{
+    CSR_Material material;
+    material.m_Color       = 0xFFFFFFFF;
+    material.m_Transparent = 0;
+    material.m_Wireframe   = 0;
+    material.m_uScale      = 1.0f;
+    material.m_vScale      = 1.0f;
+
+    CSR_VertexFormat vf;
+    vf.m_HasNormal         = 0;
+    vf.m_HasTexCoords      = 1;
+    vf.m_HasPerVertexColor = 1;
+
+    // no mesh cache?
+    if (!pCache)
+    {
+        // load the MDL model, the skins will be applied later, see AddMDLModel()
+        if (pBuffer)
+            return csrMDLCreate(pBuffer, 0, &vf, 0, &material, 0, 0, 0);
+
+        return csrMDLOpen(fileName.c_str(), 0, &vf, 0, &material, 0, 0, 0);
+    }
+
+    // the file content is required to identify the cooked model
+    CSR_Buffer* pFile = NULL;
+
+    if (!pBuffer)
+    {
+        pFile = csrFileMap(fileName.c_str());
+
+        // succeeded?
+        if (!pFile)
+            return NULL;
+    }
+
+    // get the cooked model, or load and cook the MDL model. The skins will be applied later
+    CSR_MDL* pMDL = csrMeshCacheGetMDL(pCache, pBuffer ? pBuffer : pFile, 0, &vf, 0, &material, 0, 0, 0);
+
+    csrBufferRelease(pFile);
+
+    return pMDL;
+}
+//---------------------------------------------------------------------------
+void* CSR_Level::AddWaveFront(const CSR_Matrix4&       matrix,
+                              const std::string&       fileName,
+                              const std::string&       textureName,
+                              const CSR_Buffer*        pBuffer,
+                                    CSR_ECollisionType collisionType,
+                                    ITfLoadTexture     fLoadTexture,
+                                    ITfSelectModel     fSelectModel)
+{
+    // no load texture callback?
+    if (!fLoadTexture)
+        return NULL;
 
     // load the Wavefront model
-    if (pBuffer)
-        pModel = csrWaveFrontCreate(pBuffer, &vf, &vc, &material, 0, 0, m_SceneContext.m_fOnDeleteTexture);
-    else
-        pModel = csrWaveFrontOpen(fileName.c_str(), &vf, &vc, &material, 0, 0, m_SceneContext.m_fOnDeleteTexture);
+    CSR_Model* pModel = CreateWaveFront(fileName, pBuffer, m_pMeshCache);
 
     // succeeded?
     if (!pModel)
         return NULL;
 
+    return AddWaveFrontModel(matrix, fileName, textureName, pModel, NULL, collisionType, fLoadTexture, fSelectModel);
+}
+//---------------------------------------------------------------------------
+void* CSR_Level::AddWaveFrontModel(const CSR_Matrix4&       matrix,
+                                   const std::string&       fileName,
+                                   const std::string&       textureName,
+                                         CSR_Model*         pModel,
+                                   const CSR_PixelBuffer*   pTexture,
+                                         CSR_ECollisionType collisionType,
+                                         ITfLoadTexture     fLoadTexture,
+                                         ITfSelectModel     fSelectModel)
+{
+    // no model?
+    if (!pModel)
+        return NULL;
+
+    // no decoded texture and no load texture callback?
+    if (!pTexture && !fLoadTexture)
+    {
+        csrModelRelease(pModel, m_SceneContext.m_fOnDeleteTexture);
+        return NULL;
+    }
+
     // empty model?
     if (!pModel->m_MeshCount)
     {
@@ -1028,8 +1158,8 @@ void* CSR_Level::AddWaveFront(const CSR_Matrix4&       matrix,
 
     try
     {
-        // load the texture
-        const GLuint textureID = fLoadTexture(textureName);
+        // load the texture, from the decoded texture if available
+        const GLuint textureID = pTexture ? LoadTexture(pTexture) : fLoadTexture(textureName);
 
         // failed?
         if (textureID == M_CSR_Error_Code)
@@ -1093,30 +1223,30 @@ void* CSR_Level::AddMDL(const CSR_Matrix4&       matrix,
                               CSR_fOnApplySkin   fOnApplySkin,
                               ITfSelectModel     fSelectModel)
 {
-    CSR_Material material;
-    material.m_Color       = 0xFFFFFFFF;
-    material.m_Transparent = 0;
-    material.m_Wireframe   = 0;
-    material.m_uScale      = 1.0f;
-    material.m_vScale      = 1.0f;
-
-    CSR_VertexFormat vf;
-    vf.m_HasNormal         = 0;
-    vf.m_HasTexCoords      = 1;
-    vf.m_HasPerVertexColor = 1;
-
-    CSR_MDL* pMDL;
-
     // load the MDL model
-    if (pBuffer)
-        pMDL = csrMDLCreate(pBuffer, 0, &vf, 0, &material, 0, fOnApplySkin, m_SceneContext.m_fOnDeleteTexture);
-    else
-        pMDL = csrMDLOpen(fileName.c_str(), 0, &vf, 0, &material, 0, fOnApplySkin, m_SceneContext.m_fOnDeleteTexture);
+    CSR_MDL* pMDL = CreateMDL(fileName, pBuffer, m_pMeshCache);
 
     // succeeded?
     if (!pMDL)
         return NULL;
 
+    return AddMDLModel(matrix, fileName, pMDL, collisionType, fOnApplySkin, fSelectModel);
+}
+//---------------------------------------------------------------------------
+void* CSR_Level::AddMDLModel(const CSR_Matrix4&       matrix,
+                             const std::string&       fileName,
+                                   CSR_MDL*           pMDL,
+                                   CSR_ECollisionType collisionType,
+                                   CSR_fOnApplySkin   fOnApplySkin,
+                                   ITfSelectModel     fSelectModel)
+{
+    // no model?
+    if (!pMDL)
+        return NULL;
+
+    // apply the skins, if still required
+    csrMDLApplySkins(pMDL, fOnApplySkin);
+
     try
     {
         // add a new item to the manager
@@ -1248,6 +1378,7 @@ void* CSR_Level::AddLandscapeFromBitmap(const std::string&        fileName,
 {
     CSR_Model*       pModel  = NULL;
     CSR_PixelBuffer* pBitmap = NULL;
+    CSR_HeightField* pHF     = NULL;
 
     try
     {
@@ -1287,9 +1418,13 @@ void* CSR_Level::AddLandscapeFromBitmap(const std::string&        fileName,
         // load the landscape mesh from the grayscale bitmap
         pModel->m_pMesh     = csrLandscapeCreate(pBitmap, 3.0f, 0.2f, &vf, &vc, &material, 0);
         pModel->m_MeshCount = 1;
+
+        // keep the landscape height field, to find the ground without searching in the tree
+        pHF = csrHeightFieldCreate(pBitmap, 3.0f, 0.2f);
     }
     catch (...)
     {
+        csrHeightFieldRelease(pHF);
         csrPixelBufferRelease(pBitmap);
         return NULL;
     }
@@ -1302,6 +1437,7 @@ void* CSR_Level::AddLandscapeFromBitmap(const std::string&        fileName,
     // succeeded?
     if (!pItem || !pItem->m_Matrices.size())
     {
+        csrHeightFieldRelease(pHF);
         csrModelRelease(pModel, m_SceneContext.m_fOnDeleteTexture);
         return NULL;
     }
@@ -1318,6 +1454,7 @@ void* CSR_Level::AddLandscapeFromBitmap(const std::string&        fileName,
     // succeeded?
     if (!pSceneItem)
     {
+        csrHeightFieldRelease(pHF);
         csrModelRelease(pModel, m_SceneContext.m_fOnDeleteTexture);
         return NULL;
     }
@@ -1325,6 +1462,9 @@ void* CSR_Level::AddLandscapeFromBitmap(const std::string&        fileName,
     // set the collision type
     pSceneItem->m_CollisionType = CSR_ECollisionType(CSR_CO_Ground | CSR_CO_Custom);
 
+    // the scene item owns the height field from now
+    csrSceneItemSetHeightField(pSceneItem, pHF);
+
     // keep the key
     m_pLandscapeKey = pModel;
 
@@ -1435,6 +1575,31 @@ CSR_Scene* CSR_Level::GetScene() const
     return m_pScene;
 }
 //---------------------------------------------------------------------------
+CSR_OpenGLTextureCache* CSR_Level::GetTextureCache() const
+{
+    return m_pTextureCache;
+}
+//---------------------------------------------------------------------------
+bool CSR_Level::SetMeshCacheDir(const std::string& dir)
+{
+    // release the previous mesh cache
+    csrMeshCacheRelease(m_pMeshCache);
+    m_pMeshCache = NULL;
+
+    // models should no longer be cached?
+    if (dir.empty())
+        return true;
+
+    m_pMeshCache = csrMeshCacheCreate(dir.c_str());
+
+    return (m_pMeshCache != NULL);
+}
+//---------------------------------------------------------------------------
+CSR_MeshCache* CSR_Level::GetMeshCache() const
+{
+    return m_pMeshCache;
+}
+//---------------------------------------------------------------------------
 void CSR_Level::EnableShader() const
 {
     // enable the shader program
@@ -1444,6 +1609,9 @@ void CSR_Level::EnableShader() const
 void CSR_Level::EnableMSAA(bool value)
 {
     m_UseMSAA = value;
+
+    // the post-processing graph scene is multisampled in the same way
+    m_pPostProcessing->SetSamples(m_UseMSAA ? 4 : 1);
 }
 //---------------------------------------------------------------------------
 void CSR_Level::EnableOilPainting(bool value)
@@ -1451,6 +1619,44 @@ void CSR_Level::EnableOilPainting(bool value)
     m_UseOilPainting = value;
 }
 //---------------------------------------------------------------------------
+CSR_PostProcessingGraph* CSR_Level::GetPostProcessing() const
+{
+    return m_pPostProcessing;
+}
+//---------------------------------------------------------------------------
+CSR_PixelBuffer* CSR_Level::DecodeTexture(const std::string& fileName, const CSR_Buffer* pBuffer)
+{
+    // get the file extension
+    const std::size_t dotPos = fileName.rfind('.');
+
+    // found it?
+    if (dotPos == std::string::npos)
+        return NULL;
+
+    std::string extension = fileName.substr(dotPos + 1);
+
+    // convert it to lower case
+    for (std::size_t i = 0; i < extension.length(); ++i)
+        extension[i] = char(std::tolower((unsigned char)extension[i]));
+
+    // decode the texture, if its format is supported
+    if (extension == "bmp")
+        return pBuffer ? csrPixelBufferFromBitmapBuffer(pBuffer) : csrPixelBufferFromBitmapFile(fileName.c_str());
+    else
+    if (extension == "tga")
+        return pBuffer ? csrPixelBufferFromTgaBuffer(pBuffer) : csrPixelBufferFromTgaFile(fileName.c_str());
+
+    return NULL;
+}
+//---------------------------------------------------------------------------
+GLuint CSR_Level::LoadTexture(const CSR_PixelBuffer* pPixelBuffer)
+{
+    // get the texture from the cache, the identical textures are only loaded once
+    return m_pTextureCache ?
+            csrOpenGLTextureCacheGet(pPixelBuffer, m_pTextureCache) :
+            csrOpenGLTextureFromPixelBuffer(pPixelBuffer);
+}
+//---------------------------------------------------------------------------
 void CSR_Level::AddTexture(const void* pKey, GLuint textureID)
 {
     // add the texture to the OpenGL resources
@@ -1459,8 +1665,8 @@ void CSR_Level::AddTexture(const void* pKey, GLuint textureID)
 //---------------------------------------------------------------------------
 void CSR_Level::DeleteTexture(const void* pKey)
 {
-    // add the texture to the OpenGL resources
-    CSR_OpenGLHelper::DeleteTexture(pKey, m_OpenGLResources);
+    // delete the texture from the OpenGL resources (a cached texture is released by its cache)
+    CSR_OpenGLHelper::DeleteTexture(pKey, m_OpenGLResources, m_pTextureCache);
 }
 //---------------------------------------------------------------------------
 CSR_Level::IItem* CSR_Level::Add(void* pKey)
@@ -1591,8 +1797,8 @@ void CSR_Level::Draw() const
 //---------------------------------------------------------------------------
 void CSR_Level::OnApplySkin(size_t index, const CSR_Skin* pSkin, int* pCanRelease)
 {
-    // load the texture from the received pixel buffer
-    const GLuint textureID = csrOpenGLTextureFromPixelBuffer(pSkin->m_Texture.m_pBuffer);
+    // load the texture, the identical textures are only loaded once
+    const GLuint textureID = LoadTexture(pSkin->m_Texture.m_pBuffer);
 
     // suceeded?
     if (textureID == M_CSR_Error_Code)
@@ -1621,6 +1827,9 @@ void* CSR_Level::OnGetID(const void* pKey)
 //---------------------------------------------------------------------------
 void CSR_Level::OnSceneBegin(const CSR_Scene* pScene, const CSR_SceneContext* pContext)
 {
+    if (m_pPostProcessing->GetCompiledPassCount())
+        m_pPostProcessing->DrawBegin(&pScene->m_Color);
+    else
     if (m_UseOilPainting)
         m_pEffect->DrawBegin(&pScene->m_Color);
     else
@@ -1632,6 +1841,9 @@ void CSR_Level::OnSceneBegin(const CSR_Scene* pScene, const CSR_SceneContext* pC
 //---------------------------------------------------------------------------
 void CSR_Level::OnSceneEnd(const CSR_Scene* pScene, const CSR_SceneContext* pContext)
 {
+    if (m_pPostProcessing->GetCompiledPassCount())
+        m_pPostProcessing->DrawEnd();
+    else
     if (m_UseOilPainting)
         m_pEffect->DrawEnd();
     else
@@ -1643,7 +1855,7 @@ void CSR_Level::OnSceneEnd(const CSR_Scene* pScene, const CSR_SceneContext* pCon
 //------------------------------------------------------------------------------
 void CSR_Level::OnDeleteTexture(const CSR_Texture* pTexture)
 {
-    CSR_OpenGLHelper::DeleteTexture(pTexture, m_OpenGLResources);
+    CSR_OpenGLHelper::DeleteTexture(pTexture, m_OpenGLResources, m_pTextureCache);
 }
 //------------------------------------------------------------------------------
 void CSR_Level::BuildScene()
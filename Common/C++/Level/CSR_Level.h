@@ -38,6 +38,7 @@
 #ifdef USE_WAVEFRONT
     #include "CSR_WaveFront.h"
 #endif
+#include "CSR_MeshCache.h"
 #include "CSR_Renderer_OpenGL.h"
 #include "CSR_Scene.h"
 #include "CSR_Sound.h"
@@ -45,6 +46,7 @@
 // classes
 #include "CSR_OpenGLHelper.h"
 #include "CSR_PostProcessingEffect_OilPainting.h"
+#include "CSR_PostProcessingGraph.h"
 
 /**
 * Level manager
@@ -202,7 +204,15 @@ class CSR_Level
         */
         typedef void (*ITfSelectModel)(void* pKey, int index);
 
-        CSR_Level();
+        /**
+        * Constructor
+        *@param pTextureCache - texture cache to use, may be shared between several levels. If NULL,
+        *                       the level creates and owns its own cache
+        *@note A texture cache passed in argument isn't released by the level, its owner should
+        *      release it once all the levels using it are deleted
+        */
+        CSR_Level(CSR_OpenGLTextureCache* pTextureCache = NULL);
+
         virtual ~CSR_Level();
 
         /**
@@ -235,8 +245,12 @@ class CSR_Level
         *      4. The skybox bottom image
         *      5. The skybox front image
         *      6. The skybox back image
+        *@note If pFaces is defined, the cubemap is created from the decoded faces, which should be
+        *      sorted in the same order, and fLoadCubemap is ignored
         */
-        virtual bool AddSkybox(const IFileNames& fileNames, ITfLoadCubemap fLoadCubemap);
+        virtual bool AddSkybox(const IFileNames&             fileNames,
+                                     ITfLoadCubemap          fLoadCubemap,
+                               const CSR_PixelBuffer* const* pFaces = NULL);
 
         /**
         * Adds a box in the level
@@ -405,6 +419,72 @@ class CSR_Level
                                    CSR_fOnApplySkin   fOnApplySkin,
                                    ITfSelectModel     fSelectModel);
 
+        /**
+        * Creates a WaveFront model configured as the level expects it
+        *@param fileName - model file name to load, ignored if pBuffer is defined
+        *@param pBuffer - optional buffer containing the model file content, ignored if NULL
+        *@param pCache - optional mesh cache to read the cooked model from, ignored if NULL
+        *@return newly created model, NULL on error
+        *@note This function doesn't access neither the level nor the GPU, thus it may be called
+        *      from a worker thread. The model should be added with AddWaveFrontModel() afterwards
+        */
+        static CSR_Model* CreateWaveFront(const std::string&   fileName,
+                                          const CSR_Buffer*    pBuffer,
+                                          const CSR_MeshCache* pCache = NULL);
+
+        /**
+        * Creates a Quake I model configured as the level expects it, without applying its skins
+        *@param fileName - model file name to load, ignored if pBuffer is defined
+        *@param pBuffer - optional buffer containing the model file content, ignored if NULL
+        *@param pCache - optional mesh cache to read the cooked model from, ignored if NULL
+        *@return newly created model, NULL on error
+        *@note This function doesn't access neither the level nor the GPU, thus it may be called
+        *      from a worker thread. The model should be added with AddMDLModel() afterwards
+        */
+        static CSR_MDL* CreateMDL(const std::string&   fileName,
+                                  const CSR_Buffer*    pBuffer,
+                                  const CSR_MeshCache* pCache = NULL);
+
+        /**
+        * Adds an already loaded WaveFront model in the level
+        *@param matrix - model matrix
+        *@param fileName - model file name, kept as model resource
+        *@param textureName - model texture file name to use
+        *@param pModel - model to add, see CreateWaveFront()
+        *@param pTexture - model texture decoded by the caller, see DecodeTexture(), NULL if none
+        *@param collisionType - collision type to apply to the model
+        *@param fLoadTexture - callback function to use to load a texture, ignored if pTexture is defined
+        *@param fSelectModel - callback function to select the newly added model on designer
+        *@return newly added item key, NULL on error
+        *@note The level takes the ownership of the model, which is released on error
+        */
+        virtual void* AddWaveFrontModel(const CSR_Matrix4&       matrix,
+                                        const std::string&       fileName,
+                                        const std::string&       textureName,
+                                              CSR_Model*         pModel,
+                                        const CSR_PixelBuffer*   pTexture,
+                                              CSR_ECollisionType collisionType,
+                                              ITfLoadTexture     fLoadTexture,
+                                              ITfSelectModel     fSelectModel);
+
+        /**
+        * Adds an already loaded Quake I model in the level
+        *@param matrix - model matrix
+        *@param fileName - model file name, kept as model resource
+        *@param pMDL - model to add, see CreateMDL()
+        *@param collisionType - collision type to apply to the model
+        *@param fOnApplySkin - callback function to use to apply the skins, NULL if already applied
+        *@param fSelectModel - callback function to select the newly added model on designer
+        *@return newly added item key, NULL on error
+        *@note The level takes the ownership of the model, which is released on error
+        */
+        virtual void* AddMDLModel(const CSR_Matrix4&       matrix,
+                                  const std::string&       fileName,
+                                        CSR_MDL*           pMDL,
+                                        CSR_ECollisionType collisionType,
+                                        CSR_fOnApplySkin   fOnApplySkin,
+                                        ITfSelectModel     fSelectModel);
+
         /**
         * Adds a landscape from a file
         *@param fileName - model file name to load from
@@ -486,6 +566,25 @@ class CSR_Level
         */
         virtual CSR_Scene* GetScene() const;
 
+        /**
+        * Gets the texture cache
+        *@return the texture cache, NULL if no texture cache
+        */
+        virtual CSR_OpenGLTextureCache* GetTextureCache() const;
+
+        /**
+        * Sets the dir in which the cooked models are cached
+        *@param dir - cache dir, should already exist. If empty, the models are no longer cached
+        *@return true on success, otherwise false
+        */
+        virtual bool SetMeshCacheDir(const std::string& dir);
+
+        /**
+        * Gets the mesh cache
+        *@return the mesh cache, NULL if the models aren't cached
+        */
+        virtual CSR_MeshCache* GetMeshCache() const;
+
         /**
         * Enables the main level shader
         */
@@ -503,6 +602,35 @@ class CSR_Level
         */
         virtual void EnableOilPainting(bool value);
 
+        /**
+        * Gets the scene post-processing graph
+        *@return the post-processing graph
+        *@note If the graph contains passes, it's applied instead of the oil painting effect and
+        *      the multisample antialiasing. It should be compiled after its passes are changed,
+        *      otherwise it will only be compiled on the next viewport change if never compiled before
+        */
+        virtual CSR_PostProcessingGraph* GetPostProcessing() const;
+
+        /**
+        * Decodes a texture file
+        *@param fileName - texture file name to decode, ignored if pBuffer is defined
+        *@param pBuffer - optional buffer containing the texture file content, ignored if NULL
+        *@return decoded texture, NULL on error or if the file format isn't supported
+        *@note Only the bitmap and targa files are supported. The other formats should be loaded
+        *      with a ITfLoadTexture or ITfLoadCubemap callback
+        *@note This function doesn't access neither the level nor the GPU, thus it may be called
+        *      from a worker thread. The texture should be loaded with LoadTexture() afterwards
+        */
+        static CSR_PixelBuffer* DecodeTexture(const std::string& fileName, const CSR_Buffer* pBuffer);
+
+        /**
+        * Loads a decoded texture on the GPU
+        *@param pPixelBuffer - decoded texture to load, see DecodeTexture()
+        *@return texture identifier on the GPU, M_CSR_Error_Code on error
+        *@note The texture is shared with the identical textures already loaded in the texture cache
+        */
+        virtual GLuint LoadTexture(const CSR_PixelBuffer* pPixelBuffer);
+
         /**
         * Adds a texture to the OpenGL resources
         *@param pKey - key for which the texture should be added
@@ -631,12 +759,16 @@ class CSR_Level
         CSR_OpenGLShader*                     m_pShader;
         CSR_OpenGLShader*                     m_pSkyboxShader;
         CSR_OpenGLHelper::IResources          m_OpenGLResources;
+        CSR_OpenGLTextureCache*               m_pTextureCache;
+        CSR_MeshCache*                        m_pMeshCache;
         CSR_PostProcessingEffect_OilPainting* m_pEffect;
+        CSR_PostProcessingGraph*              m_pPostProcessing;
         CSR_OpenGLMSAA*                       m_pMSAA;
         CSR_Sound*                            m_pSound;
         void*                                 m_pLandscapeKey;
         bool                                  m_UseMSAA;
         bool                                  m_UseOilPainting;
+        bool                                  m_OwnTextureCache;
 
         /**
         * Builds a default scene
@@ -0,0 +1,937 @@
+/****************************************************************************
+ * ==> CSR_LevelFile_Pack --------------------------------------------------*
+ ****************************************************************************
+ * Description : This module provides the functions required to read and    *
+ *               write the level from/to a binary packed file               *
+ * Developer   : Jean-Milost Reymond                                        *
+ * Copyright   : 2017 - 2022, this file is part of the CompactStar Engine.  *
+ *               You are free to copy or redistribute this file, modify it, *
+ *               or use it for your own projects, commercial or not. This   *
+ *               file is provided "as is", WITHOUT ANY WARRANTY OF ANY      *
+ *               KIND. THE DEVELOPER IS NOT RESPONSIBLE FOR ANY DAMAGE OF   *
+ *               ANY KIND, ANY LOSS OF DATA, OR ANY LOSS OF PRODUCTIVITY    *
+ *               TIME THAT MAY RESULT FROM THE USAGE OF THIS SOURCE CODE,   *
+ *               DIRECTLY OR NOT.                                           *
+ ****************************************************************************/
+
+#include "CSR_LevelFile_Pack.h"
+
+// std
+#include <cstring>
+
+//---------------------------------------------------------------------------
+// Global defines
+//---------------------------------------------------------------------------
+#define M_CSR_OS_Separator      '\\'
+#define M_CSR_Pack_Magic        0x4C525343 // CSRL
+#define M_CSR_Pack_Version      1
+#define M_CSR_Pack_Alignment    16
+#define M_CSR_Pack_Header_Size  (4 * sizeof(unsigned))
+#define M_CSR_Pack_Entry_Size   (3 * sizeof(unsigned))
+#define M_CSR_Pack_Item_Size    (11 * sizeof(unsigned))
+//---------------------------------------------------------------------------
+// Chunk types
+//---------------------------------------------------------------------------
+#define M_CSR_Pack_Chunk_File   0x454C4946 // FILE
+#define M_CSR_Pack_Chunk_Scene  0x454E4353 // SCNE
+#define M_CSR_Pack_Chunk_Item   0x4D455449 // ITEM
+#define M_CSR_Pack_Chunk_Skybox 0x42594B53 // SKYB
+#define M_CSR_Pack_Chunk_Sound  0x444E4F53 // SOND
+//---------------------------------------------------------------------------
+// CSR_LevelFile_Pack
+//---------------------------------------------------------------------------
+CSR_LevelFile_Pack::CSR_LevelFile_Pack(const std::string& levelDir) :
+    CSR_LevelFile(),
+    m_LevelDir(levelDir),
+    m_pPack(NULL),
+    m_fOnLoadCubemap(NULL),
+    m_fOnLoadTexture(NULL),
+    m_fOnSelectModel(NULL),
+    m_fOnUpdateDesigner(NULL),
+    m_fOnApplySkin(NULL)
+{}
+//---------------------------------------------------------------------------
+CSR_LevelFile_Pack::~CSR_LevelFile_Pack()
+{
+    Clear();
+}
+//---------------------------------------------------------------------------
+bool CSR_LevelFile_Pack::Load(const std::string& fileName, CSR_Level& level)
+{
+    Clear();
+
+    // map the packed file in memory
+    m_pPack = csrFileMap(fileName.c_str());
+
+    // succeeded?
+    if (!m_pPack || !m_pPack->m_pData)
+    {
+        Clear();
+        return false;
+    }
+
+    const std::size_t packLength = m_pPack->m_Length;
+    std::size_t       offset     = 0;
+    unsigned          header[4];
+
+    // read the header
+    if (packLength < M_CSR_Pack_Header_Size || !csrBufferRead(m_pPack, &offset, sizeof(unsigned), 4, header))
+    {
+        Clear();
+        return false;
+    }
+
+    // is a packed level file, and is the version supported?
+    if (header[0] != M_CSR_Pack_Magic || header[1] != M_CSR_Pack_Version)
+    {
+        Clear();
+        return false;
+    }
+
+    const std::size_t chunkCount = header[2];
+
+    // is the table of contents complete?
+    if (chunkCount > (packLength - M_CSR_Pack_Header_Size) / M_CSR_Pack_Entry_Size)
+    {
+        Clear();
+        return false;
+    }
+
+    const unsigned char* pPack    = (const unsigned char*)m_pPack->m_pData;
+    const unsigned*      pEntries = (const unsigned*)(pPack + M_CSR_Pack_Header_Size);
+
+    try
+    {
+        // read the files first, as the other chunks refer to them
+        for (std::size_t pass = 0; pass < 2; ++pass)
+            for (std::size_t i = 0; i < chunkCount; ++i)
+            {
+                const unsigned type   = pEntries[i * 3];
+                const unsigned start  = pEntries[i * 3 + 1];
+                const unsigned length = pEntries[i * 3 + 2];
+
+                // is chunk inside the file?
+                if (start > packLength || length > packLength - start)
+                {
+                    Clear();
+                    return false;
+                }
+
+                // get the chunk content, without copying it
+                CSR_Buffer chunk;
+                chunk.m_pData     = (void*)(pPack + start);
+                chunk.m_Length    = length;
+                chunk.m_Ownership = CSR_BO_Borrowed;
+
+                bool success = true;
+
+                // search for the chunk type to read
+                if (!pass)
+                {
+                    if (type == M_CSR_Pack_Chunk_File)
+                        success = ReadFile(&chunk);
+                }
+                else
+                    switch (type)
+                    {
+                        case M_CSR_Pack_Chunk_Scene:  success = ReadScene    (&chunk, level); break;
+                        case M_CSR_Pack_Chunk_Item:   success = ReadSceneItem(&chunk, level); break;
+                        case M_CSR_Pack_Chunk_Skybox: success = ReadSkybox   (&chunk, level); break;
+                        case M_CSR_Pack_Chunk_Sound:  success = ReadSound    (&chunk, level); break;
+
+                        // unknown chunks are skipped, thus newer files remain readable
+                        default: break;
+                    }
+
+                if (!success)
+                {
+                    Clear();
+                    return false;
+                }
+            }
+    }
+    catch (...)
+    {
+        Clear();
+        return false;
+    }
+
+    // re-enable the default level shader, as the skybox shader could be enabled, and this may cause
+    // the level to not be rendered in this case
+    level.EnableShader();
+
+    return true;
+}
+//---------------------------------------------------------------------------
+bool CSR_LevelFile_Pack::Save(const std::string& fileName, const CSR_Level& level) const
+{
+    try
+    {
+        return Write(fileName, level, NULL);
+    }
+    catch (...)
+    {
+        return false;
+    }
+}
+//---------------------------------------------------------------------------
+bool CSR_LevelFile_Pack::Convert(      CSR_LevelFile_XML& source,
+                                 const std::string&       sourceFileName,
+                                 const std::string&       fileName,
+                                       CSR_Level&         level) const
+{
+    // load the xml level
+    if (!source.Load(sourceFileName, level))
+        return false;
+
+    try
+    {
+        // write the packed level, the file contents are read from the xml level
+        return Write(fileName, level, &source);
+    }
+    catch (...)
+    {
+        return false;
+    }
+}
+//---------------------------------------------------------------------------
+const CSR_Buffer* CSR_LevelFile_Pack::GetFile(const std::string& fileName) const
+{
+    // the level uses absolute file names, the packed file relative ones
+    std::string relativeFileName = AbsoluteToRelative(fileName);
+
+    if (relativeFileName.empty())
+        relativeFileName = fileName;
+
+    // get the buffer matching with file name
+    IFiles::const_iterator it = m_Files.find(relativeFileName);
+
+    // found it?
+    if (it == m_Files.end())
+        return NULL;
+
+    return it->second;
+}
+//---------------------------------------------------------------------------
+void CSR_LevelFile_Pack::Set_OnLoadCubemap(CSR_Level::ITfLoadCubemap fHandler)
+{
+    m_fOnLoadCubemap = fHandler;
+}
+//---------------------------------------------------------------------------
+void CSR_LevelFile_Pack::Set_OnLoadTexture(CSR_Level::ITfLoadTexture fHandler)
+{
+    m_fOnLoadTexture = fHandler;
+}
+//---------------------------------------------------------------------------
+void CSR_LevelFile_Pack::Set_OnSelectModel(CSR_Level::ITfSelectModel fHandler)
+{
+    m_fOnSelectModel = fHandler;
+}
+//---------------------------------------------------------------------------
+void CSR_LevelFile_Pack::Set_OnUpdateDesigner(CSR_Level::ITfOnUpdateDesigner fHandler)
+{
+    m_fOnUpdateDesigner = fHandler;
+}
+//---------------------------------------------------------------------------
+void CSR_LevelFile_Pack::Set_OnApplySkin(CSR_fOnApplySkin fHandler)
+{
+    m_fOnApplySkin = fHandler;
+}
+//---------------------------------------------------------------------------
+void CSR_LevelFile_Pack::Clear()
+{
+    // delete the file buffers (their content is borrowed from the mapped file)
+    for (IFiles::iterator it = m_Files.begin(); it != m_Files.end(); ++it)
+        csrBufferRelease(it->second);
+
+    m_Files.clear();
+
+    // unmap the packed file
+    csrBufferRelease(m_pPack);
+    m_pPack = NULL;
+}
+//---------------------------------------------------------------------------
+std::string CSR_LevelFile_Pack::RelativeToAbsolute(const std::string& fileName) const
+{
+    std::string absolute = fileName;
+
+    // remove the first separator, if any
+    if (!absolute.empty() && absolute[0] == M_CSR_OS_Separator)
+        absolute = absolute.substr(1, absolute.length() - 1);
+
+    // no path to the level dir?
+    if (m_LevelDir.empty())
+        return absolute;
+
+    // level dir begins with a separator?
+    if (m_LevelDir[m_LevelDir.length() - 1] == M_CSR_OS_Separator)
+        return m_LevelDir + absolute;
+
+    return m_LevelDir + M_CSR_OS_Separator + absolute;
+}
+//---------------------------------------------------------------------------
+std::string CSR_LevelFile_Pack::AbsoluteToRelative(const std::string& fileName) const
+{
+    std::string relative;
+
+    // remove the level dir
+    if (m_LevelDir.empty())
+        relative = fileName;
+    else
+    if (fileName.find(m_LevelDir) == 0)
+        relative = fileName.substr(m_LevelDir.length(), fileName.length() - m_LevelDir.length());
+
+    // no remaining file name?
+    if (relative.empty())
+        return "";
+
+    // remove the first separator, if any
+    if (relative[0] == M_CSR_OS_Separator)
+        relative = relative.substr(1, relative.length() - 1);
+
+    return relative;
+}
+//---------------------------------------------------------------------------
+bool CSR_LevelFile_Pack::ReadScene(const CSR_Buffer* pChunk, CSR_Level& level)
+{
+    // is chunk complete?
+    if (pChunk->m_Length < sizeof(CSR_Color) + 2 * sizeof(CSR_Matrix4) + sizeof(CSR_Vector3))
+        return false;
+
+    // create the scene
+    CSR_Scene* pScene = level.CreateScene();
+
+    // found it?
+    if (!pScene)
+        return false;
+
+    std::size_t offset = 0;
+
+    // read the scene values
+    csrBufferRead(pChunk, &offset, sizeof(CSR_Color),   1, &pScene->m_Color);
+    csrBufferRead(pChunk, &offset, sizeof(CSR_Matrix4), 1, &pScene->m_ProjectionMatrix);
+    csrBufferRead(pChunk, &offset, sizeof(CSR_Matrix4), 1, &pScene->m_ViewMatrix);
+    csrBufferRead(pChunk, &offset, sizeof(CSR_Vector3), 1, &pScene->m_GroundDir);
+
+    return true;
+}
+//---------------------------------------------------------------------------
+bool CSR_LevelFile_Pack::ReadSceneItem(const CSR_Buffer* pChunk, CSR_Level& level)
+{
+    CSR_Level::IItem item;
+    std::size_t      offset = 0;
+    int              values[11];
+
+    // read the item values
+    if (pChunk->m_Length < M_CSR_Pack_Item_Size || !csrBufferRead(pChunk, &offset, sizeof(int), 11, values))
+        return false;
+
+    const CSR_ECollisionType collisionType = CSR_ECollisionType(values[1]);
+    const std::size_t        matrixCount   = std::size_t(values[10]);
+
+    item.m_Type                                = CSR_Level::IEItemType(values[0]);
+    item.m_Resources.m_RepeatTextureOnEachFace = bool(values[2]);
+    item.m_Resources.m_Faces                   = values[3];
+    item.m_Resources.m_Slices                  = values[4];
+    item.m_Resources.m_Stacks                  = values[5];
+    item.m_Resources.m_Radius                  = values[6];
+    item.m_Resources.m_DeltaMin                = values[7];
+    item.m_Resources.m_DeltaMax                = values[8];
+    item.m_Resources.m_DeltaZ                  = values[9];
+
+    // are the matrices complete?
+    if (matrixCount > (pChunk->m_Length - offset) / sizeof(CSR_Matrix4))
+        return false;
+
+    // read the matrices
+    for (std::size_t i = 0; i < matrixCount; ++i)
+    {
+        std::auto_ptr<CSR_Matrix4> pMatrix(new CSR_Matrix4());
+        csrBufferRead(pChunk, &offset, sizeof(CSR_Matrix4), 1, pMatrix.get());
+
+        // add it to the item
+        item.m_Matrices.push_back(pMatrix.get());
+        pMatrix.release();
+    }
+
+    // read the file names
+    if (!ReadString(pChunk, &offset, item.m_Resources.m_Files.m_LandscapeMap) ||
+        !ReadString(pChunk, &offset, item.m_Resources.m_Files.m_Model)        ||
+        !ReadString(pChunk, &offset, item.m_Resources.m_Files.m_Texture)      ||
+        !ReadString(pChunk, &offset, item.m_Resources.m_Files.m_BumpMap))
+        return false;
+
+    // item should at least contain one matrix (except for the landscapes)
+    if (item.m_Type != CSR_Level::IE_IT_Landscape && !item.m_Matrices.size())
+        return false;
+
+    const std::string texture = RelativeToAbsolute(item.m_Resources.m_Files.m_Texture);
+
+    void* pKey = NULL;
+
+    // search for model type to build
+    switch (item.m_Type)
+    {
+        case CSR_Level::IE_IT_Surface:
+            // add the surface
+            pKey = level.AddSurface(*item.m_Matrices[0], texture, collisionType, m_fOnLoadTexture, m_fOnSelectModel);
+            break;
+
+        case CSR_Level::IE_IT_Box:
+            // add the box
+            pKey = level.AddBox(*item.m_Matrices[0],
+                                 texture,
+                                 item.m_Resources.m_RepeatTextureOnEachFace,
+                                 collisionType,
+                                 m_fOnLoadTexture,
+                                 m_fOnSelectModel);
+            break;
+
+        case CSR_Level::IE_IT_Sphere:
+            // add the sphere
+            pKey = level.AddSphere(*item.m_Matrices[0],
+                                    texture,
+                                    item.m_Resources.m_Slices,
+                                    item.m_Resources.m_Stacks,
+                                    collisionType,
+                                    m_fOnLoadTexture,
+                                    m_fOnSelectModel);
+            break;
+
+        case CSR_Level::IE_IT_Cylinder:
+            // add the cylinder
+            pKey = level.AddCylinder(*item.m_Matrices[0],
+                                      texture,
+                                      item.m_Resources.m_Faces,
+                                      collisionType,
+                                      m_fOnLoadTexture,
+                                      m_fOnSelectModel);
+            break;
+
+        case CSR_Level::IE_IT_Disk:
+            // add the disk
+            pKey = level.AddDisk(*item.m_Matrices[0],
+                                  texture,
+                                  item.m_Resources.m_Slices,
+                                  collisionType,
+                                  m_fOnLoadTexture,
+                                  m_fOnSelectModel);
+            break;
+
+        case CSR_Level::IE_IT_Ring:
+            // add the ring
+            pKey = level.AddRing(*item.m_Matrices[0],
+                                  texture,
+                                  item.m_Resources.m_Slices,
+                                  item.m_Resources.m_Radius,
+                                  collisionType,
+                                  m_fOnLoadTexture,
+                                  m_fOnSelectModel);
+            break;
+
+        case CSR_Level::IE_IT_Spiral:
+            // add the spiral
+            pKey = level.AddSpiral(*item.m_Matrices[0],
+                                    texture,
+                                    item.m_Resources.m_Radius,
+                                    item.m_Resources.m_DeltaMin,
+                                    item.m_Resources.m_DeltaMax,
+                                    item.m_Resources.m_DeltaZ,
+                                    item.m_Resources.m_Slices,
+                                    item.m_Resources.m_Stacks,
+                                    collisionType,
+                                    m_fOnLoadTexture,
+                                    m_fOnSelectModel);
+            break;
+
+        case CSR_Level::IE_IT_Landscape:
+        {
+            // add the landscape
+            if (!item.m_Resources.m_Files.m_LandscapeMap.empty())
+                pKey = level.AddLandscapeFromBitmap(RelativeToAbsolute(item.m_Resources.m_Files.m_LandscapeMap),
+                                                    texture,
+                                                    GetFile(item.m_Resources.m_Files.m_LandscapeMap),
+                                                    m_fOnUpdateDesigner);
+            else
+            if (!item.m_Resources.m_Files.m_Model.empty())
+                pKey = level.AddLandscape(RelativeToAbsolute(item.m_Resources.m_Files.m_Model),
+                                          texture,
+                                          GetFile(item.m_Resources.m_Files.m_Model),
+                                          m_fOnUpdateDesigner);
+
+            // no texture to load?
+            if (!pKey || item.m_Resources.m_Files.m_Texture.empty() || !m_fOnLoadTexture)
+                break;
+
+            // get back the landscape model from the key
+            const CSR_Model* pModel = static_cast<CSR_Model*>(pKey);
+
+            // found it?
+            if (!pModel->m_MeshCount)
+                return false;
+
+            // load the texture
+            const GLuint textureID = m_fOnLoadTexture(texture);
+
+            // failed?
+            if (textureID == M_CSR_Error_Code)
+                return false;
+
+            // add it to the OpenGL resources
+            level.AddTexture(&pModel->m_pMesh[0].m_Skin.m_Texture, textureID);
+            break;
+        }
+
+        case CSR_Level::IE_IT_WaveFront:
+            // add the WaveFront model, parsed directly from the mapped file
+            pKey = level.AddWaveFront(*item.m_Matrices[0],
+                                       RelativeToAbsolute(item.m_Resources.m_Files.m_Model),
+                                       texture,
+                                       GetFile(item.m_Resources.m_Files.m_Model),
+                                       collisionType,
+                                       m_fOnLoadTexture,
+                                       m_fOnSelectModel);
+            break;
+
+        case CSR_Level::IE_IT_MDL:
+            // add the Quake I model, parsed directly from the mapped file
+            pKey = level.AddMDL(*item.m_Matrices[0],
+                                 RelativeToAbsolute(item.m_Resources.m_Files.m_Model),
+                                 GetFile(item.m_Resources.m_Files.m_Model),
+                                 collisionType,
+                                 m_fOnApplySkin,
+                                 m_fOnSelectModel);
+            break;
+
+        default:
+            // unknown model
+            return false;
+    }
+
+    if (!pKey)
+        return false;
+
+    // read the matrices
+    for (std::size_t i = 1; i < item.m_Matrices.size(); ++i)
+        if (level.AddDuplicate(pKey, *item.m_Matrices[i], m_fOnSelectModel) == -1)
+            return false;
+
+    return true;
+}
+//---------------------------------------------------------------------------
+bool CSR_LevelFile_Pack::ReadSkybox(const CSR_Buffer* pChunk, CSR_Level& level)
+{
+    std::size_t offset = 0;
+
+    // read the skybox files
+    if (!ReadString(pChunk, &offset, level.m_Skybox.m_Right)  ||
+        !ReadString(pChunk, &offset, level.m_Skybox.m_Left)   ||
+        !ReadString(pChunk, &offset, level.m_Skybox.m_Top)    ||
+        !ReadString(pChunk, &offset, level.m_Skybox.m_Bottom) ||
+        !ReadString(pChunk, &offset, level.m_Skybox.m_Front)  ||
+        !ReadString(pChunk, &offset, level.m_Skybox.m_Back))
+        return false;
+
+    // build the cubemap textures to load
+    CSR_Level::IFileNames fileNames;
+    fileNames.push_back(RelativeToAbsolute(level.m_Skybox.m_Right));
+    fileNames.push_back(RelativeToAbsolute(level.m_Skybox.m_Left));
+    fileNames.push_back(RelativeToAbsolute(level.m_Skybox.m_Top));
+    fileNames.push_back(RelativeToAbsolute(level.m_Skybox.m_Bottom));
+    fileNames.push_back(RelativeToAbsolute(level.m_Skybox.m_Front));
+    fileNames.push_back(RelativeToAbsolute(level.m_Skybox.m_Back));
+
+    // add the skybox
+    return level.AddSkybox(fileNames, m_fOnLoadCubemap);
+}
+//---------------------------------------------------------------------------
+bool CSR_LevelFile_Pack::ReadSound(const CSR_Buffer* pChunk, CSR_Level& level)
+{
+    std::size_t offset = 0;
+
+    // read the sound file name
+    if (!ReadString(pChunk, &offset, level.m_Sound.m_FileName))
+        return false;
+
+    // open the ambient sound
+    return level.OpenSound(RelativeToAbsolute(level.m_Sound.m_FileName), GetFile(level.m_Sound.m_FileName));
+}
+//---------------------------------------------------------------------------
+bool CSR_LevelFile_Pack::ReadFile(const CSR_Buffer* pChunk)
+{
+    std::size_t offset = 0;
+    unsigned    values[3];
+
+    // read the file header
+    if (pChunk->m_Length < sizeof(values) || !csrBufferRead(pChunk, &offset, sizeof(unsigned), 3, values))
+        return false;
+
+    const std::size_t nameLength = values[0];
+    const std::size_t dataOffset = values[1];
+    const std::size_t dataLength = values[2];
+
+    // is file inside its chunk?
+    if (nameLength > pChunk->m_Length - offset ||
+        dataOffset > pChunk->m_Length          ||
+        dataLength > pChunk->m_Length - dataOffset)
+        return false;
+
+    // read the file name
+    const std::string fileName((const char*)pChunk->m_pData + offset, nameLength);
+
+    // empty file name should never happen, so found one may be a corruption
+    if (fileName.empty())
+        return false;
+
+    // empty files aren't kept, thus they will be read from the level dir
+    if (!dataLength)
+        return true;
+
+    // create a buffer pointing to the file content in the mapped file
+    CSR_Buffer* pBuffer = csrBufferCreate();
+
+    // succeeded?
+    if (!pBuffer)
+        return false;
+
+    pBuffer->m_pData     = (unsigned char*)pChunk->m_pData + dataOffset;
+    pBuffer->m_Length    = dataLength;
+    pBuffer->m_Ownership = CSR_BO_Borrowed;
+
+    // release the previous file with the same name, if any
+    IFiles::iterator it = m_Files.find(fileName);
+
+    if (it != m_Files.end())
+        csrBufferRelease(it->second);
+
+    // add the file to the list
+    m_Files[fileName] = pBuffer;
+
+    return true;
+}
+//---------------------------------------------------------------------------
+bool CSR_LevelFile_Pack::ReadString(const CSR_Buffer* pChunk, std::size_t* pOffset, std::string& value) const
+{
+    unsigned length = 0;
+
+    // is string length inside the chunk?
+    if (*pOffset + sizeof(unsigned) > pChunk->m_Length)
+        return false;
+
+    // read the string length
+    csrBufferRead(pChunk, pOffset, sizeof(unsigned), 1, &length);
+
+    // is string inside the chunk?
+    if (length > pChunk->m_Length - *pOffset)
+        return false;
+
+    // read the string
+    value.assign((const char*)pChunk->m_pData + *pOffset, length);
+    *pOffset += length;
+
+    return true;
+}
+//---------------------------------------------------------------------------
+bool CSR_LevelFile_Pack::Write(const std::string&       fileName,
+                               const CSR_Level&         level,
+                                     CSR_LevelFile_XML* pSource) const
+{
+    // get the scene to write
+    const CSR_Scene* pScene = level.GetScene();
+
+    // found it?
+    if (!pScene)
+        return false;
+
+    IChunks chunks;
+
+    // write the scene values
+    IChunk scene;
+    scene.m_Type = M_CSR_Pack_Chunk_Scene;
+    WriteValue(scene.m_Data, &pScene->m_Color,            sizeof(CSR_Color));
+    WriteValue(scene.m_Data, &pScene->m_ProjectionMatrix, sizeof(CSR_Matrix4));
+    WriteValue(scene.m_Data, &pScene->m_ViewMatrix,       sizeof(CSR_Matrix4));
+    WriteValue(scene.m_Data, &pScene->m_GroundDir,        sizeof(CSR_Vector3));
+    chunks.push_back(scene);
+
+    // write the scene items
+    for (std::size_t i = 0; i < pScene->m_ItemCount; ++i)
+        if (!WriteSceneItem(&pScene->m_pItem[i], level.Get(pScene->m_pItem[i].m_pModel), chunks))
+            return false;
+
+    // write the scene transparent items
+    for (std::size_t i = 0; i < pScene->m_TransparentItemCount; ++i)
+        if (!WriteSceneItem(&pScene->m_pTransparentItem[i],
+                             level.Get(pScene->m_pTransparentItem[i].m_pModel),
+                             chunks))
+            return false;
+
+    // write the skybox files to use, if any
+    if (!level.m_Skybox.m_Left.empty()   &&
+        !level.m_Skybox.m_Top.empty()    &&
+        !level.m_Skybox.m_Right.empty()  &&
+        !level.m_Skybox.m_Bottom.empty() &&
+        !level.m_Skybox.m_Front.empty()  &&
+        !level.m_Skybox.m_Back.empty())
+    {
+        IChunk skybox;
+        skybox.m_Type = M_CSR_Pack_Chunk_Skybox;
+
+        if (!WriteFileName(level.m_Skybox.m_Right,  skybox.m_Data, chunks) ||
+            !WriteFileName(level.m_Skybox.m_Left,   skybox.m_Data, chunks) ||
+            !WriteFileName(level.m_Skybox.m_Top,    skybox.m_Data, chunks) ||
+            !WriteFileName(level.m_Skybox.m_Bottom, skybox.m_Data, chunks) ||
+            !WriteFileName(level.m_Skybox.m_Front,  skybox.m_Data, chunks) ||
+            !WriteFileName(level.m_Skybox.m_Back,   skybox.m_Data, chunks))
+            return false;
+
+        chunks.push_back(skybox);
+    }
+
+    // write the ambient sound file to use, if any
+    if (!level.m_Sound.m_FileName.empty())
+    {
+        IChunk sound;
+        sound.m_Type = M_CSR_Pack_Chunk_Sound;
+
+        if (!WriteFileName(level.m_Sound.m_FileName, sound.m_Data, chunks))
+            return false;
+
+        chunks.push_back(sound);
+    }
+
+    // write in a temporary file, because the file contents to copy may be mapped from the file to
+    // overwrite (e.g. while a loaded packed level is saved over itself)
+    const std::string tempFileName = fileName + ".tmp";
+
+    // open file for write
+    std::FILE* pFile = std::fopen(tempFileName.c_str(), "wb");
+
+    // succeeded?
+    if (!pFile)
+        return false;
+
+    const unsigned        chunkCount = unsigned(chunks.size());
+    const unsigned        header[4]  = {M_CSR_Pack_Magic, M_CSR_Pack_Version, chunkCount, 0};
+    std::vector<unsigned> entries(chunks.size() * 3, 0);
+    bool                  success    = true;
+
+    try
+    {
+        // write the header, and reserve the table of contents
+        success = (std::fwrite(header, sizeof(header), 1, pFile) == 1);
+
+        if (success && chunkCount)
+            success = (std::fwrite(&entries[0], M_CSR_Pack_Entry_Size, chunkCount, pFile) == chunkCount);
+
+        // write the chunks
+        for (std::size_t i = 0; success && i < chunks.size(); ++i)
+        {
+            const std::size_t start = WritePadding(pFile);
+
+            // write the chunk content
+            if (chunks[i].m_Type == M_CSR_Pack_Chunk_File)
+                success = WriteFile(pFile, chunks[i].m_Data, pSource);
+            else
+            if (!chunks[i].m_Data.empty())
+                success = (std::fwrite(chunks[i].m_Data.c_str(), chunks[i].m_Data.length(), 1, pFile) == 1);
+
+            // keep the chunk location in the table of contents
+            entries[i * 3]     = chunks[i].m_Type;
+            entries[i * 3 + 1] = unsigned(start);
+            entries[i * 3 + 2] = unsigned(std::size_t(std::ftell(pFile)) - start);
+        }
+
+        // write the table of contents
+        if (success && chunkCount)
+            success = !std::fseek(pFile, M_CSR_Pack_Header_Size, SEEK_SET) &&
+                       std::fwrite(&entries[0], M_CSR_Pack_Entry_Size, chunkCount, pFile) == chunkCount;
+    }
+    catch (...)
+    {
+        std::fclose(pFile);
+        std::remove(tempFileName.c_str());
+        throw;
+    }
+
+    std::fclose(pFile);
+
+    // failed?
+    if (!success)
+    {
+        std::remove(tempFileName.c_str());
+        return false;
+    }
+
+    // replace the previous file. NOTE on some systems the rename fails if the file already exists, in
+    // this case it should be removed first
+    if (std::rename(tempFileName.c_str(), fileName.c_str()) &&
+       (std::remove(fileName.c_str()) || std::rename(tempFileName.c_str(), fileName.c_str())))
+    {
+        std::remove(tempFileName.c_str());
+        return false;
+    }
+
+    return true;
+}
+//---------------------------------------------------------------------------
+bool CSR_LevelFile_Pack::WriteSceneItem(const CSR_SceneItem*    pSceneItem,
+                                        const CSR_Level::IItem* pLevelItem,
+                                              IChunks&          chunks) const
+{
+    // validate the inputs
+    if (!pSceneItem || !pLevelItem)
+        return false;
+
+    const std::size_t matrixCount = pSceneItem->m_pMatrixArray ? pSceneItem->m_pMatrixArray->m_Count : 0;
+
+    // build the item values
+    const int values[11] =
+    {
+        pLevelItem->m_Type,
+        pSceneItem->m_CollisionType,
+        pLevelItem->m_Resources.m_RepeatTextureOnEachFace,
+        pLevelItem->m_Resources.m_Faces,
+        pLevelItem->m_Resources.m_Slices,
+        pLevelItem->m_Resources.m_Stacks,
+        pLevelItem->m_Resources.m_Radius,
+        pLevelItem->m_Resources.m_DeltaMin,
+        pLevelItem->m_Resources.m_DeltaMax,
+        pLevelItem->m_Resources.m_DeltaZ,
+        int(matrixCount)
+    };
+
+    IChunk item;
+    item.m_Type = M_CSR_Pack_Chunk_Item;
+
+    // write the item values
+    WriteValue(item.m_Data, values, sizeof(values));
+
+    // write the model matrices
+    for (std::size_t i = 0; i < matrixCount; ++i)
+        WriteValue(item.m_Data, pSceneItem->m_pMatrixArray->m_pItem[i].m_pData, sizeof(CSR_Matrix4));
+
+    // write the file names (the landscape model is ignored if a landscape map exists)
+    const bool hasMap   =  pLevelItem->m_Type == CSR_Level::IE_IT_Landscape &&
+                          !pLevelItem->m_Resources.m_Files.m_LandscapeMap.empty();
+    const bool hasModel = (pLevelItem->m_Type == CSR_Level::IE_IT_Landscape ||
+                           pLevelItem->m_Type == CSR_Level::IE_IT_WaveFront ||
+                           pLevelItem->m_Type == CSR_Level::IE_IT_MDL) && !hasMap;
+
+    if (!WriteFileName(hasMap   ? pLevelItem->m_Resources.m_Files.m_LandscapeMap : "", item.m_Data, chunks) ||
+        !WriteFileName(hasModel ? pLevelItem->m_Resources.m_Files.m_Model        : "", item.m_Data, chunks) ||
+        !WriteFileName(pLevelItem->m_Resources.m_Files.m_Texture,                      item.m_Data, chunks) ||
+        !WriteFileName(pLevelItem->m_Resources.m_Files.m_BumpMap,                      item.m_Data, chunks))
+        return false;
+
+    chunks.push_back(item);
+
+    return true;
+}
+//---------------------------------------------------------------------------
+bool CSR_LevelFile_Pack::WriteFileName(const std::string& fileName, std::string& data, IChunks& chunks) const
+{
+    // no file? Write an empty name
+    if (fileName.empty())
+    {
+        const unsigned length = 0;
+        WriteValue(data, &length, sizeof(unsigned));
+        return true;
+    }
+
+    // convert the absolute file name to relative
+    const std::string relativeFileName = AbsoluteToRelative(fileName);
+
+    // no remaining file name?
+    if (relativeFileName.empty())
+        return false;
+
+    // write the file name
+    const unsigned length = unsigned(relativeFileName.length());
+    WriteValue(data, &length, sizeof(unsigned));
+    WriteValue(data, relativeFileName.c_str(), length);
+
+    // search for an already added file chunk
+    for (IChunks::const_iterator it = chunks.begin(); it != chunks.end(); ++it)
+        if (it->m_Type == M_CSR_Pack_Chunk_File && it->m_Data == relativeFileName)
+            return true;
+
+    // add the file chunk, its content will be read while the chunk is written
+    IChunk file;
+    file.m_Type = M_CSR_Pack_Chunk_File;
+    file.m_Data = relativeFileName;
+    chunks.push_back(file);
+
+    return true;
+}
+//---------------------------------------------------------------------------
+bool CSR_LevelFile_Pack::WriteFile(std::FILE* pFile, const std::string& fileName, CSR_LevelFile_XML* pSource) const
+{
+    CSR_Buffer*       pRead   = NULL;
+    const CSR_Buffer* pBuffer = GetFile(fileName);
+
+    // search for the file content, in the previously loaded packed file, in the source level or in
+    // the level dir
+    if (!pBuffer && pSource)
+        pBuffer = pSource->GetFile(fileName);
+
+    if (!pBuffer)
+    {
+        pRead   = csrFileOpen(RelativeToAbsolute(fileName).c_str());
+        pBuffer = pRead;
+    }
+
+    const std::size_t start      = std::size_t(std::ftell(pFile));
+    const std::size_t nameLength = fileName.length();
+    const std::size_t dataLength = pBuffer ? pBuffer->m_Length : 0;
+
+    // the file content is aligned in the chunk (which is itself aligned)
+    const std::size_t headerLength = 3 * sizeof(unsigned) + nameLength;
+    const std::size_t dataOffset   =
+            ((headerLength + M_CSR_Pack_Alignment - 1) / M_CSR_Pack_Alignment) * M_CSR_Pack_Alignment;
+
+    const unsigned values[3] = {unsigned(nameLength), unsigned(dataOffset), unsigned(dataLength)};
+    const char     zero      = 0;
+
+    // write the file header
+    bool success = std::fwrite(values, sizeof(values), 1, pFile) == 1 &&
+                   std::fwrite(fileName.c_str(), nameLength, 1, pFile) == 1;
+
+    // write the file content
+    if (success)
+    {
+        WritePadding(pFile);
+        success = (std::size_t(std::ftell(pFile)) == start + dataOffset);
+    }
+
+    if (success && dataLength)
+        success = (std::fwrite(pBuffer->m_pData, dataLength, 1, pFile) == 1);
+
+    // terminate the content, thus it may also be read as a text
+    if (success)
+        success = (std::fwrite(&zero, 1, 1, pFile) == 1);
+
+    csrBufferRelease(pRead);
+
+    return success;
+}
+//---------------------------------------------------------------------------
+void CSR_LevelFile_Pack::WriteValue(std::string& data, const void* pValue, std::size_t length)
+{
+    data.append((const char*)pValue, length);
+}
+//---------------------------------------------------------------------------
+std::size_t CSR_LevelFile_Pack::WritePadding(std::FILE* pFile)
+{
+    std::size_t position = std::size_t(std::ftell(pFile));
+
+    // write zeros until the next aligned position
+    while (position % M_CSR_Pack_Alignment)
+    {
+        std::fputc(0, pFile);
+        ++position;
+    }
+
+    return position;
+}
+//---------------------------------------------------------------------------
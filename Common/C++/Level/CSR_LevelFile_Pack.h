@@ -0,0 +1,267 @@
+/****************************************************************************
+ * ==> CSR_LevelFile_Pack --------------------------------------------------*
+ ****************************************************************************
+ * Description : This module provides the functions required to read and    *
+ *               write the level from/to a binary packed file               *
+ * Developer   : Jean-Milost Reymond                                        *
+ * Copyright   : 2017 - 2022, this file is part of the CompactStar Engine.  *
+ *               You are free to copy or redistribute this file, modify it, *
+ *               or use it for your own projects, commercial or not. This   *
+ *               file is provided "as is", WITHOUT ANY WARRANTY OF ANY      *
+ *               KIND. THE DEVELOPER IS NOT RESPONSIBLE FOR ANY DAMAGE OF   *
+ *               ANY KIND, ANY LOSS OF DATA, OR ANY LOSS OF PRODUCTIVITY    *
+ *               TIME THAT MAY RESULT FROM THE USAGE OF THIS SOURCE CODE,   *
+ *               DIRECTLY OR NOT.                                           *
+ ****************************************************************************/
+
+#ifndef CSR_LevelFile_PackH
+#define CSR_LevelFile_PackH
+
+// std
+#include <cstdio>
+#include <map>
+#include <vector>
+
+// compactStar engine
+#include "CSR_Common.h"
+#include "CSR_Scene.h"
+
+// classes
+#include "CSR_LevelFile.h"
+#include "CSR_LevelFile_XML.h"
+
+/**
+* Binary packed level serializer
+*@note The packed file is a header, followed by a table of contents and by chunks. The file contents
+*      are stored raw and aligned in their chunks, and the file is mapped in memory on load, thus
+*      the buffers returned by GetFile() point directly to the mapped file without any copy
+*@author Jean-Milost Reymond
+*/
+class CSR_LevelFile_Pack : public CSR_LevelFile
+{
+    public:
+        /**
+        * Constructor
+        *@param levelDir - path to the level dir, used to read the files to pack and to resolve the
+        *                  file names used by the level
+        */
+        CSR_LevelFile_Pack(const std::string& levelDir);
+
+        virtual ~CSR_LevelFile_Pack();
+
+        /**
+        * Loads the level
+        *@param fileName - level file name
+        *@param[in, out] level - level to load
+        *@return true on success, otherwise false
+        */
+        virtual bool Load(const std::string& fileName, CSR_Level& level);
+
+        /**
+        * Saves the level
+        *@param fileName - level file name
+        *@param level - level to save
+        *@return true on success, otherwise false
+        *@note The content of all the files used by the level is saved in the packed file
+        */
+        virtual bool Save(const std::string& fileName, const CSR_Level& level) const;
+
+        /**
+        * Converts a xml level file to a packed level file
+        *@param[in, out] source - xml serializer to read with
+        *@param sourceFileName - xml level file name to convert
+        *@param fileName - packed level file name to write
+        *@param[in, out] level - level in which the xml level will be loaded
+        *@return true on success, otherwise false
+        *@note The file contents are read from the xml level file if they were saved in it, otherwise
+        *      from the source level dir. The level is loaded, thus an OpenGL context is required
+        */
+        virtual bool Convert(      CSR_LevelFile_XML& source,
+                             const std::string&       sourceFileName,
+                             const std::string&       fileName,
+                                   CSR_Level&         level) const;
+
+        /**
+        * Gets a file buffer from the packed file
+        *@param fileName - file name for which the buffer should be get
+        *@return file buffer, NULL if not found or on error
+        *@note The buffer points to the mapped file, and remains valid until the next load or until
+        *      the serializer is deleted
+        */
+        virtual const CSR_Buffer* GetFile(const std::string& fileName) const;
+
+        /**
+        * Sets the OnLoadCubemap callback
+        *@param fHandler - function handler
+        */
+        void Set_OnLoadCubemap(CSR_Level::ITfLoadCubemap fHandler);
+
+        /**
+        * Sets the OnLoadTexture callback
+        *@param fHandler - function handler
+        */
+        void Set_OnLoadTexture(CSR_Level::ITfLoadTexture fHandler);
+
+        /**
+        * Sets the OnSelectModel callback
+        *@param fHandler - function handler
+        */
+        void Set_OnSelectModel(CSR_Level::ITfSelectModel fHandler);
+
+        /**
+        * Sets the OnUpdateDesigner callback
+        *@param fHandler - function handler
+        */
+        void Set_OnUpdateDesigner(CSR_Level::ITfOnUpdateDesigner fHandler);
+
+        /**
+        * Sets the OnApplySkin callback
+        *@param fHandler - function handler
+        */
+        void Set_OnApplySkin(CSR_fOnApplySkin fHandler);
+
+    private:
+        typedef std::map<std::string, CSR_Buffer*> IFiles;
+
+        /**
+        * Chunk to write
+        */
+        struct IChunk
+        {
+            unsigned    m_Type;
+            std::string m_Data;     // chunk data, or file name if the chunk contains a file
+        };
+
+        typedef std::vector<IChunk> IChunks;
+
+        std::string                    m_LevelDir;
+        IFiles                         m_Files;
+        CSR_Buffer*                    m_pPack;
+        CSR_Level::ITfLoadCubemap      m_fOnLoadCubemap;
+        CSR_Level::ITfLoadTexture      m_fOnLoadTexture;
+        CSR_Level::ITfSelectModel      m_fOnSelectModel;
+        CSR_Level::ITfOnUpdateDesigner m_fOnUpdateDesigner;
+        CSR_fOnApplySkin               m_fOnApplySkin;
+
+        /**
+        * Clears the serializer, unmaps the previously loaded file
+        */
+        void Clear();
+
+        /**
+        * Converts a relative file name to absolute
+        *@param fileName - relative file name to convert
+        *@return absolute file name
+        */
+        std::string RelativeToAbsolute(const std::string& fileName) const;
+
+        /**
+        * Converts an absolute file name to relative
+        *@param fileName - absolute file name to convert
+        *@return relative file name
+        */
+        std::string AbsoluteToRelative(const std::string& fileName) const;
+
+        /**
+        * Reads a scene chunk
+        *@param pChunk - chunk content
+        *@param[in, out] level - level in which the scene should be created
+        *@return true on success, otherwise false
+        */
+        bool ReadScene(const CSR_Buffer* pChunk, CSR_Level& level);
+
+        /**
+        * Reads a scene item chunk
+        *@param pChunk - chunk content
+        *@param[in, out] level - level in which the scene item should be added
+        *@return true on success, otherwise false
+        */
+        bool ReadSceneItem(const CSR_Buffer* pChunk, CSR_Level& level);
+
+        /**
+        * Reads a skybox chunk
+        *@param pChunk - chunk content
+        *@param[in, out] level - level for which the skybox should be load
+        *@return true on success, otherwise false
+        */
+        bool ReadSkybox(const CSR_Buffer* pChunk, CSR_Level& level);
+
+        /**
+        * Reads a sound chunk
+        *@param pChunk - chunk content
+        *@param[in, out] level - level for which the sound should be load
+        *@return true on success, otherwise false
+        */
+        bool ReadSound(const CSR_Buffer* pChunk, CSR_Level& level);
+
+        /**
+        * Reads a file chunk
+        *@param pChunk - chunk content
+        *@return true on success, otherwise false
+        */
+        bool ReadFile(const CSR_Buffer* pChunk);
+
+        /**
+        * Reads a string
+        *@param pChunk - chunk to read from
+        *@param[in, out] pOffset - offset to read from, new offset position after function ends
+        *@param[out] value - read string
+        *@return true on success, otherwise false
+        */
+        bool ReadString(const CSR_Buffer* pChunk, std::size_t* pOffset, std::string& value) const;
+
+        /**
+        * Writes the level
+        *@param fileName - level file name
+        *@param level - level to save
+        *@param pSource - xml serializer from which the file contents should be read, may be NULL
+        *@return true on success, otherwise false
+        */
+        bool Write(const std::string& fileName, const CSR_Level& level, CSR_LevelFile_XML* pSource) const;
+
+        /**
+        * Writes a scene item chunk
+        *@param pSceneItem - scene item to write
+        *@param pLevelItem - level item to write
+        *@param[in, out] chunks - chunks in which the scene item and its files should be added
+        *@return true on success, otherwise false
+        */
+        bool WriteSceneItem(const CSR_SceneItem*    pSceneItem,
+                            const CSR_Level::IItem* pLevelItem,
+                                  IChunks&          chunks) const;
+
+        /**
+        * Writes a file name, and adds its chunk if still not done
+        *@param fileName - absolute file name to write, may be empty
+        *@param[in, out] data - chunk data in which the file name should be written
+        *@param[in, out] chunks - chunks in which the file chunk should be added
+        *@return true on success, otherwise false
+        */
+        bool WriteFileName(const std::string& fileName, std::string& data, IChunks& chunks) const;
+
+        /**
+        * Writes a file chunk content
+        *@param pFile - file to write to
+        *@param fileName - relative file name to write
+        *@param pSource - xml serializer from which the file content should be read, may be NULL
+        *@return true on success, otherwise false
+        */
+        bool WriteFile(std::FILE* pFile, const std::string& fileName, CSR_LevelFile_XML* pSource) const;
+
+        /**
+        * Writes a value in a chunk data
+        *@param[in, out] data - chunk data to write to
+        *@param pValue - value to write
+        *@param length - value length in bytes
+        */
+        static void WriteValue(std::string& data, const void* pValue, std::size_t length);
+
+        /**
+        * Writes padding bytes until the file position is aligned
+        *@param pFile - file to write to
+        *@return the aligned file position
+        */
+        static std::size_t WritePadding(std::FILE* pFile);
+};
+
+#endif
@@ -87,10 +87,53 @@
 #define M_CSR_Xml_Attribute_43                    "_43"
 #define M_CSR_Xml_Attribute_44                    "_44"
 //---------------------------------------------------------------------------
+// CSR_LevelFile_XML::ITexture
+//---------------------------------------------------------------------------
+CSR_LevelFile_XML::ITexture::ITexture() :
+    m_pContent(NULL),
+    m_pPixelBuffer(NULL)
+{}
+//---------------------------------------------------------------------------
+CSR_LevelFile_XML::ITexture::~ITexture()
+{
+    csrPixelBufferRelease(m_pPixelBuffer);
+}
+//---------------------------------------------------------------------------
+// CSR_LevelFile_XML::IStep
+//---------------------------------------------------------------------------
+CSR_LevelFile_XML::IStep::IStep() :
+    m_Type(IE_ST_SceneItem),
+    m_pItem(NULL),
+    m_CollisionType(CSR_CO_None),
+    m_pContent(NULL),
+    m_pBuffer(NULL),
+    m_pModel(NULL),
+    m_pMDL(NULL),
+    m_pMeshCache(NULL)
+{
+    csrJobInit(&m_Job, OnLoadStep, this);
+}
+//---------------------------------------------------------------------------
+CSR_LevelFile_XML::IStep::~IStep()
+{
+    // no texture was loaded yet for the models which were not committed
+    csrModelRelease(m_pModel, 0);
+    csrMDLRelease(m_pMDL, 0);
+    csrBufferRelease(m_pBuffer);
+
+    for (ITextures::iterator it = m_Textures.begin(); it != m_Textures.end(); ++it)
+        delete (*it);
+
+    if (m_pItem)
+        delete m_pItem;
+}
+//---------------------------------------------------------------------------
 // CSR_LevelFile_XML
 //---------------------------------------------------------------------------
 CSR_LevelFile_XML::CSR_LevelFile_XML(const std::string& levelDir, bool saveContent) :
     m_LevelDir(levelDir),
+    m_StepIndex(0),
+    m_pJobPool(NULL),
     m_SaveContent(saveContent),
     m_fOnLoadCubemap(NULL),
     m_fOnLoadTexture(NULL),
@@ -101,11 +144,29 @@ CSR_LevelFile_XML::CSR_LevelFile_XML(const std::string& levelDir, bool saveConte
 //---------------------------------------------------------------------------
 CSR_LevelFile_XML::~CSR_LevelFile_XML()
 {
+    ClearSteps();
+    csrJobPoolRelease(m_pJobPool);
     Clear();
 }
 //---------------------------------------------------------------------------
 bool CSR_LevelFile_XML::Load(const std::string& fileName, CSR_Level& level)
 {
+    // begin to load the level
+    if (!BeginLoad(fileName, level))
+        return false;
+
+    // add the level items as soon as they are ready
+    while (IsLoading())
+        if (!Update(level, true))
+            return false;
+
+    return true;
+}
+//---------------------------------------------------------------------------
+bool CSR_LevelFile_XML::BeginLoad(const std::string& fileName, CSR_Level& level)
+{
+    // abort any previous loading
+    ClearSteps();
     Clear();
 
     XMLDoc doc;
@@ -140,17 +201,98 @@ bool CSR_LevelFile_XML::Load(const std::string& fileName, CSR_Level& level)
         if (!Read(pNode, level))
         {
             XMLDoc_free(&doc);
+            ClearSteps();
             return false;
         }
     }
     catch (...)
     {
         XMLDoc_free(&doc);
+        ClearSteps();
         return false;
     }
 
     XMLDoc_free(&doc);
 
+    // nothing to load?
+    if (m_Steps.empty())
+    {
+        level.EnableShader();
+        return true;
+    }
+
+    // create the job pool, if still not done. On error the steps will be executed on this thread
+    if (!m_pJobPool)
+        m_pJobPool = csrJobPoolCreate(0);
+
+    // start the loading jobs
+    for (ISteps::iterator it = m_Steps.begin(); it != m_Steps.end(); ++it)
+    {
+        IStep* pStep = *it;
+
+        // the models are parsed by the jobs, thus they should know where the cooked models are
+        pStep->m_pMeshCache = level.GetMeshCache();
+
+        // step reads a file?
+        if (!pStep->m_FileName.empty())
+        {
+            pStep->m_Absolute = RelativeToAbsolute(pStep->m_FileName);
+
+            // the file content is contained in the level file, or was already read?
+            IFiles::const_iterator itFile = m_Files.find(pStep->m_Absolute);
+
+            if (itFile != m_Files.end())
+                pStep->m_pContent = itFile->second;
+        }
+
+        // iterate through the textures the step decodes
+        for (ITextures::iterator itTex = pStep->m_Textures.begin(); itTex != pStep->m_Textures.end(); ++itTex)
+        {
+            ITexture* pTexture   = *itTex;
+            pTexture->m_Absolute = RelativeToAbsolute(pTexture->m_FileName);
+
+            // the texture content is contained in the level file, or was already read?
+            IFiles::const_iterator itFile = m_Files.find(pTexture->m_Absolute);
+
+            if (itFile != m_Files.end())
+                pTexture->m_pContent = itFile->second;
+        }
+
+        csrJobPoolAdd(m_pJobPool, &pStep->m_Job);
+    }
+
+    return true;
+}
+//---------------------------------------------------------------------------
+bool CSR_LevelFile_XML::Update(CSR_Level& level, bool wait)
+{
+    // add the ready steps to the level, in the level file order
+    while (m_StepIndex < m_Steps.size())
+    {
+        IStep* pStep = m_Steps[m_StepIndex];
+
+        // step still not ready?
+        if (csrJobPoolGetState(m_pJobPool, &pStep->m_Job) != CSR_JS_Done)
+        {
+            if (!wait)
+                return true;
+
+            csrJobPoolWait(m_pJobPool, &pStep->m_Job);
+        }
+
+        // add the step content to the level
+        if (!CommitStep(pStep, level))
+        {
+            ClearSteps();
+            return false;
+        }
+
+        ++m_StepIndex;
+    }
+
+    // loading is done
+    ClearSteps();
+
     // re-enable the default level shader, as the skybox shader could be enabled, and this may cause
     // the level to not be rendered in this case
     level.EnableShader();
@@ -158,6 +300,19 @@ bool CSR_LevelFile_XML::Load(const std::string& fileName, CSR_Level& level)
     return true;
 }
 //---------------------------------------------------------------------------
+bool CSR_LevelFile_XML::IsLoading() const
+{
+    return !m_Steps.empty();
+}
+//---------------------------------------------------------------------------
+float CSR_LevelFile_XML::GetProgress() const
+{
+    if (m_Steps.empty())
+        return 1.0f;
+
+    return float(m_StepIndex) / float(m_Steps.size());
+}
+//---------------------------------------------------------------------------
 bool CSR_LevelFile_XML::Save(const std::string& fileName, const CSR_Level& level) const
 {
     XMLDoc doc;
@@ -216,7 +371,7 @@ const CSR_Buffer* CSR_LevelFile_XML::GetFile(const std::string& fileName)
         if (!it->second)
         {
             // open the file
-            std::auto_ptr<CSR_Buffer> pBuffer(csrFileOpen(absoluteFileName.c_str()));
+            std::auto_ptr<CSR_Buffer> pBuffer(csrFileMap(absoluteFileName.c_str()));
 
             // succeeded?
             if (!pBuffer.get())
@@ -231,7 +386,7 @@ const CSR_Buffer* CSR_LevelFile_XML::GetFile(const std::string& fileName)
     }
 
     // open the file
-    std::auto_ptr<CSR_Buffer> pBuffer(csrFileOpen(absoluteFileName.c_str()));
+    std::auto_ptr<CSR_Buffer> pBuffer(csrFileMap(absoluteFileName.c_str()));
 
     // succeeded?
     if (!pBuffer.get())
@@ -277,6 +432,148 @@ void CSR_LevelFile_XML::Clear()
     m_Files.clear();
 }
 //---------------------------------------------------------------------------
+void CSR_LevelFile_XML::ClearSteps()
+{
+    // wait until the running jobs are done, as they reference the steps
+    csrJobPoolWaitAll(m_pJobPool);
+
+    // delete all the steps
+    for (ISteps::iterator it = m_Steps.begin(); it != m_Steps.end(); ++it)
+        delete (*it);
+
+    m_Steps.clear();
+    m_StepIndex = 0;
+}
+//---------------------------------------------------------------------------
+void CSR_LevelFile_XML::AddStep(IStep* pStep)
+{
+    std::auto_ptr<IStep> pNewStep(pStep);
+    m_Steps.push_back(pNewStep.get());
+    pNewStep.release();
+}
+//---------------------------------------------------------------------------
+void CSR_LevelFile_XML::AddStepTexture(IStep* pStep, const std::string& fileName)
+{
+    std::auto_ptr<ITexture> pTexture(new ITexture());
+    pTexture->m_FileName = fileName;
+    pStep->m_Textures.push_back(pTexture.get());
+    pTexture.release();
+}
+//---------------------------------------------------------------------------
+bool CSR_LevelFile_XML::IsDecoded(const IStep* pStep)
+{
+    if (pStep->m_Textures.empty())
+        return false;
+
+    for (ITextures::const_iterator it = pStep->m_Textures.begin(); it != pStep->m_Textures.end(); ++it)
+        if (!(*it)->m_pPixelBuffer)
+            return false;
+
+    return true;
+}
+//---------------------------------------------------------------------------
+void CSR_LevelFile_XML::OnLoadStep(void* pArg)
+{
+    IStep* pStep = static_cast<IStep*>(pArg);
+
+    // decode the textures. NOTE the formats the level cannot decode are loaded later by the
+    // OnLoadTexture or OnLoadCubemap callbacks, on the thread which commits the step
+    for (ITextures::iterator it = pStep->m_Textures.begin(); it != pStep->m_Textures.end(); ++it)
+        (*it)->m_pPixelBuffer = CSR_Level::DecodeTexture((*it)->m_Absolute, (*it)->m_pContent);
+
+    // nothing to read?
+    if (pStep->m_FileName.empty())
+        return;
+
+    // read the file, if its content is still unknown
+    if (!pStep->m_pContent)
+        pStep->m_pBuffer = csrFileMap(pStep->m_Absolute.c_str());
+
+    const CSR_Buffer* pBuffer = pStep->m_pContent ? pStep->m_pContent : pStep->m_pBuffer;
+
+    // file not found?
+    if (!pBuffer)
+        return;
+
+    // not a scene item?
+    if (pStep->m_Type != IE_ST_SceneItem || !pStep->m_pItem)
+        return;
+
+    // parse the model, if any
+    switch (pStep->m_pItem->m_Type)
+    {
+        case CSR_Level::IE_IT_WaveFront:
+            pStep->m_pModel = CSR_Level::CreateWaveFront(pStep->m_Absolute, pBuffer, pStep->m_pMeshCache);
+            break;
+
+        case CSR_Level::IE_IT_MDL:
+            pStep->m_pMDL = CSR_Level::CreateMDL(pStep->m_Absolute, pBuffer, pStep->m_pMeshCache);
+            break;
+
+        default:
+            break;
+    }
+}
+//---------------------------------------------------------------------------
+bool CSR_LevelFile_XML::CommitStep(IStep* pStep, CSR_Level& level)
+{
+    // keep the read file, thus GetFile() will no longer open it
+    if (pStep->m_pBuffer)
+    {
+        IFiles::iterator it = m_Files.find(pStep->m_Absolute);
+
+        if (it == m_Files.end())
+        {
+            m_Files[pStep->m_Absolute] = pStep->m_pBuffer;
+            pStep->m_pBuffer           = NULL;
+        }
+        else
+        if (!it->second)
+        {
+            it->second       = pStep->m_pBuffer;
+            pStep->m_pBuffer = NULL;
+        }
+    }
+
+    switch (pStep->m_Type)
+    {
+        case IE_ST_SceneItem:
+            return CommitSceneItem(pStep, level);
+
+        case IE_ST_Skybox:
+        {
+            const CSR_PixelBuffer* pFaces[6]  = {NULL};
+            const bool             allDecoded = IsDecoded(pStep);
+
+            // get the faces decoded by the loading job, the cubemap is loaded by the OnLoadCubemap
+            // callback if any of them could not be decoded
+            if (allDecoded)
+                for (std::size_t i = 0; i < 6; ++i)
+                    pFaces[i] = pStep->m_Textures[i]->m_pPixelBuffer;
+
+            // build the cubemap textures to load
+            CSR_Level::IFileNames fileNames;
+            fileNames.push_back(RelativeToAbsolute(level.m_Skybox.m_Right));
+            fileNames.push_back(RelativeToAbsolute(level.m_Skybox.m_Left));
+            fileNames.push_back(RelativeToAbsolute(level.m_Skybox.m_Top));
+            fileNames.push_back(RelativeToAbsolute(level.m_Skybox.m_Bottom));
+            fileNames.push_back(RelativeToAbsolute(level.m_Skybox.m_Front));
+            fileNames.push_back(RelativeToAbsolute(level.m_Skybox.m_Back));
+
+            // add the skybox
+            return level.AddSkybox(fileNames, m_fOnLoadCubemap, allDecoded ? pFaces : NULL);
+        }
+
+        case IE_ST_Sound:
+            // open the ambient sound
+            return level.OpenSound(RelativeToAbsolute(level.m_Sound.m_FileName),
+                                   GetFile(level.m_Sound.m_FileName));
+
+        default:
+            return false;
+    }
+}
+//---------------------------------------------------------------------------
 std::string CSR_LevelFile_XML::RelativeToAbsolute(const std::string& fileName) const
 {
     std::string absolute = fileName;
@@ -400,18 +697,22 @@ bool CSR_LevelFile_XML::ReadScene(const XMLNode* pNode, CSR_Level& level)
         }
         else
         if (std::strcmp(pChild->tag, M_CSR_Xml_Tag_Scene_Item) == 0)
-            // found the view matrix
-            if (!ReadSceneItem(pChild, level))
+            // found a scene item
+            if (!ReadSceneItem(pChild))
                 return false;
     }
 
     return true;
 }
 //---------------------------------------------------------------------------
-bool CSR_LevelFile_XML::ReadSceneItem(const XMLNode* pNode, CSR_Level& level)
+bool CSR_LevelFile_XML::ReadSceneItem(const XMLNode* pNode)
 {
-    CSR_Level::IItem   item;
-    CSR_ECollisionType collisionType = CSR_CO_None;
+    // create the loading step
+    std::auto_ptr<IStep> pStep(new IStep());
+    pStep->m_Type  = IE_ST_SceneItem;
+    pStep->m_pItem = new CSR_Level::IItem();
+
+    CSR_Level::IItem& item = *pStep->m_pItem;
 
     // iterate through node children
     for (int i = 0; i < pNode->n_children; ++i)
@@ -430,7 +731,7 @@ bool CSR_LevelFile_XML::ReadSceneItem(const XMLNode* pNode, CSR_Level& level)
         else
         if (std::strcmp(pChild->tag, M_CSR_Xml_Tag_Collision_Type) == 0)
             // found the collision type to apply
-            collisionType = CSR_ECollisionType(std::atoi(pChild->text));
+            pStep->m_CollisionType = CSR_ECollisionType(std::atoi(pChild->text));
         else
         if (std::strcmp(pChild->tag, M_CSR_Xml_Tag_Repeat_Texture_On_Each_Face) == 0)
             // found if texture should be repeated on each face
@@ -511,6 +812,52 @@ bool CSR_LevelFile_XML::ReadSceneItem(const XMLNode* pNode, CSR_Level& level)
     if (item.m_Type != CSR_Level::IE_IT_Landscape && !item.m_Matrices.size())
         return false;
 
+    // search for the file to read while loading
+    switch (item.m_Type)
+    {
+        case CSR_Level::IE_IT_Landscape:
+            if (!item.m_Resources.m_Files.m_LandscapeMap.empty())
+                pStep->m_FileName = item.m_Resources.m_Files.m_LandscapeMap;
+            else
+                pStep->m_FileName = item.m_Resources.m_Files.m_Model;
+
+            // the texture is decoded while loading
+            if (!item.m_Resources.m_Files.m_Texture.empty())
+                AddStepTexture(pStep.get(), item.m_Resources.m_Files.m_Texture);
+
+            break;
+
+        case CSR_Level::IE_IT_WaveFront:
+            pStep->m_FileName = item.m_Resources.m_Files.m_Model;
+
+            // the texture is decoded while loading
+            if (!item.m_Resources.m_Files.m_Texture.empty())
+                AddStepTexture(pStep.get(), item.m_Resources.m_Files.m_Texture);
+
+            break;
+
+        case CSR_Level::IE_IT_MDL:
+            pStep->m_FileName = item.m_Resources.m_Files.m_Model;
+            break;
+
+        default:
+            break;
+    }
+
+    // add the step, the item will be added to the level once loaded
+    AddStep(pStep.release());
+
+    return true;
+}
+//---------------------------------------------------------------------------
+bool CSR_LevelFile_XML::CommitSceneItem(IStep* pStep, CSR_Level& level)
+{
+    const CSR_Level::IItem&  item          = *pStep->m_pItem;
+    const CSR_ECollisionType collisionType =  pStep->m_CollisionType;
+
+    // get the texture decoded by the loading job, if any
+    const CSR_PixelBuffer* pTexture = IsDecoded(pStep) ? pStep->m_Textures[0]->m_pPixelBuffer : NULL;
+
     void* pKey = NULL;
 
     // search for model type to build
@@ -631,14 +978,14 @@ bool CSR_LevelFile_XML::ReadSceneItem(const XMLNode* pNode, CSR_Level& level)
             if (!item.m_Resources.m_Files.m_Model.empty())
                 pKey = level.AddLandscape(RelativeToAbsolute(item.m_Resources.m_Files.m_Model),
                                           RelativeToAbsolute(item.m_Resources.m_Files.m_Texture),
-                                          GetFile(item.m_Resources.m_Files.m_LandscapeMap),
+                                          GetFile(item.m_Resources.m_Files.m_Model),
                                           m_fOnUpdateDesigner);
 
             if (!pKey)
                 return false;
 
             // can load the texture?
-            if (!item.m_Resources.m_Files.m_Texture.empty() && m_fOnLoadTexture)
+            if (!item.m_Resources.m_Files.m_Texture.empty() && (pTexture || m_fOnLoadTexture))
             {
                 // get back the landscape model from the key
                 const CSR_Model* pModel = static_cast<CSR_Model*>(pKey);
@@ -647,8 +994,9 @@ bool CSR_LevelFile_XML::ReadSceneItem(const XMLNode* pNode, CSR_Level& level)
                 if (!pModel || !pModel->m_MeshCount)
                     return false;
 
-                // load the texture
-                const GLuint textureID =
+                // load the texture, from the decoded texture if available
+                const GLuint textureID = pTexture ?
+                        level.LoadTexture(pTexture) :
                         m_fOnLoadTexture(RelativeToAbsolute(item.m_Resources.m_Files.m_Texture));
 
                 // failed?
@@ -662,14 +1010,17 @@ bool CSR_LevelFile_XML::ReadSceneItem(const XMLNode* pNode, CSR_Level& level)
             break;
 
         case CSR_Level::IE_IT_WaveFront:
-            // add the WaveFront model
-            pKey = level.AddWaveFront(*item.m_Matrices[0],
-                                       RelativeToAbsolute(item.m_Resources.m_Files.m_Model),
-                                       RelativeToAbsolute(item.m_Resources.m_Files.m_Texture),
-                                       GetFile(item.m_Resources.m_Files.m_Model),
-                                       collisionType,
-                                       m_fOnLoadTexture,
-                                       m_fOnSelectModel);
+            // add the WaveFront model parsed by the loading job (the level takes its ownership)
+            pKey = level.AddWaveFrontModel(*item.m_Matrices[0],
+                                            RelativeToAbsolute(item.m_Resources.m_Files.m_Model),
+                                            RelativeToAbsolute(item.m_Resources.m_Files.m_Texture),
+                                            pStep->m_pModel,
+                                            pTexture,
+                                            collisionType,
+                                            m_fOnLoadTexture,
+                                            m_fOnSelectModel);
+
+            pStep->m_pModel = NULL;
 
             if (!pKey)
                 return false;
@@ -677,13 +1028,16 @@ bool CSR_LevelFile_XML::ReadSceneItem(const XMLNode* pNode, CSR_Level& level)
             break;
 
         case CSR_Level::IE_IT_MDL:
-            // add the Quake I model
-            pKey = level.AddMDL(*item.m_Matrices[0],
-                                 RelativeToAbsolute(item.m_Resources.m_Files.m_Model),
-                                 GetFile(item.m_Resources.m_Files.m_Model),
-                                 collisionType,
-                                 m_fOnApplySkin,
-                                 m_fOnSelectModel);
+            // add the Quake I model parsed by the loading job (the level takes its ownership), the
+            // skins are applied here, as they may upload textures
+            pKey = level.AddMDLModel(*item.m_Matrices[0],
+                                      RelativeToAbsolute(item.m_Resources.m_Files.m_Model),
+                                      pStep->m_pMDL,
+                                      collisionType,
+                                      m_fOnApplySkin,
+                                      m_fOnSelectModel);
+
+            pStep->m_pMDL = NULL;
 
             if (!pKey)
                 return false;
@@ -757,18 +1111,17 @@ bool CSR_LevelFile_XML::ReadSkybox(const XMLNode* pNode, CSR_Level& level)
         level.m_Skybox.m_Front.empty() || level.m_Skybox.m_Back.empty())
         return true;
 
-    // build the cubemap textures to load
-    CSR_Level::IFileNames fileNames;
-    fileNames.push_back(RelativeToAbsolute(level.m_Skybox.m_Right));
-    fileNames.push_back(RelativeToAbsolute(level.m_Skybox.m_Left));
-    fileNames.push_back(RelativeToAbsolute(level.m_Skybox.m_Top));
-    fileNames.push_back(RelativeToAbsolute(level.m_Skybox.m_Bottom));
-    fileNames.push_back(RelativeToAbsolute(level.m_Skybox.m_Front));
-    fileNames.push_back(RelativeToAbsolute(level.m_Skybox.m_Back));
-
-    // add the skybox
-    if (!level.AddSkybox(fileNames, m_fOnLoadCubemap))
-        return false;
+    // add the skybox loading step. NOTE the step job decodes the faces, the cubemap is loaded on the
+    // GPU when the step is committed
+    std::auto_ptr<IStep> pStep(new IStep());
+    pStep->m_Type = IE_ST_Skybox;
+    AddStepTexture(pStep.get(), level.m_Skybox.m_Right);
+    AddStepTexture(pStep.get(), level.m_Skybox.m_Left);
+    AddStepTexture(pStep.get(), level.m_Skybox.m_Top);
+    AddStepTexture(pStep.get(), level.m_Skybox.m_Bottom);
+    AddStepTexture(pStep.get(), level.m_Skybox.m_Front);
+    AddStepTexture(pStep.get(), level.m_Skybox.m_Back);
+    AddStep(pStep.release());
 
     return true;
 }
@@ -791,9 +1144,11 @@ bool CSR_LevelFile_XML::ReadSound(const XMLNode* pNode, CSR_Level& level)
                 return false;
     }
 
-    // open the ambient sound
-    if (!level.OpenSound(RelativeToAbsolute(level.m_Sound.m_FileName), GetFile(level.m_Sound.m_FileName)))
-        return false;
+    // add the ambient sound loading step
+    std::auto_ptr<IStep> pStep(new IStep());
+    pStep->m_Type     = IE_ST_Sound;
+    pStep->m_FileName = level.m_Sound.m_FileName;
+    AddStep(pStep.release());
 
     return true;
 }
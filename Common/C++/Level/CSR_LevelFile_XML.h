@@ -19,10 +19,12 @@
 
 // std
 #include <map>
+#include <vector>
 
 // compactStar engine
 #include "CSR_Common.h"
 #include "CSR_Scene.h"
+#include "CSR_Job.h"
 
 // classes
 #include "CSR_LevelFile.h"
@@ -55,6 +57,38 @@ class CSR_LevelFile_XML
         */
         virtual bool Load(const std::string& fileName, CSR_Level& level);
 
+        /**
+        * Begins to load the level asynchronously
+        *@param fileName - level file name
+        *@param[in, out] level - level to load
+        *@return true on success, otherwise false
+        *@note The level files are read and the models are parsed on worker threads, then the level
+        *      items are added by Update(), which should be called from the rendering thread until
+        *      IsLoading() returns false. The level may be drawn between two updates
+        */
+        virtual bool BeginLoad(const std::string& fileName, CSR_Level& level);
+
+        /**
+        * Updates the asynchronous loading, adds the items which are ready to the level
+        *@param[in, out] level - level to load, should be the same as the one passed to BeginLoad()
+        *@param wait - if true, waits until the next item is ready if none is
+        *@return true on success, otherwise false
+        *@note The items are added in the same order as they are declared in the level file
+        */
+        virtual bool Update(CSR_Level& level, bool wait);
+
+        /**
+        * Checks if a level is currently loading
+        *@return true if a level is currently loading, otherwise false
+        */
+        virtual bool IsLoading() const;
+
+        /**
+        * Gets the loading progress
+        *@return the loading progress, between 0.0f and 1.0f
+        */
+        virtual float GetProgress() const;
+
         /**
         * Saves the level
         *@param fileName - level file name
@@ -73,12 +107,16 @@ class CSR_LevelFile_XML
         /**
         * Sets the OnLoadCubemap callback
         *@param fHandler - function handler
+        *@note The callback is only used if a skybox face cannot be decoded by the loading job, see
+        *      CSR_Level::DecodeTexture()
         */
         void Set_OnLoadCubemap(CSR_Level::ITfLoadCubemap fHandler);
 
         /**
         * Sets the OnLoadTexture callback
         *@param fHandler - function handler
+        *@note The landscape and WaveFront textures decoded by the loading job don't use the
+        *      callback, see CSR_Level::DecodeTexture()
         */
         void Set_OnLoadTexture(CSR_Level::ITfLoadTexture fHandler);
 
@@ -103,8 +141,62 @@ class CSR_LevelFile_XML
     private:
         typedef std::map<std::string, CSR_Buffer*> IFiles;
 
+        /**
+        * Loading step type
+        */
+        enum IEStepType
+        {
+            IE_ST_SceneItem,
+            IE_ST_Skybox,
+            IE_ST_Sound
+        };
+
+        /**
+        * Loading step texture, decoded on a worker thread if its format is supported
+        */
+        struct ITexture
+        {
+            std::string       m_FileName;     // relative file name to decode
+            std::string       m_Absolute;     // absolute file name to decode
+            const CSR_Buffer* m_pContent;     // file content already contained in the level file
+            CSR_PixelBuffer*  m_pPixelBuffer; // texture decoded by the worker, NULL if not decoded
+
+            ITexture();
+            ~ITexture();
+        };
+
+        typedef std::vector<ITexture*> ITextures;
+
+        /**
+        * Loading step, the file it requires is read, its model is parsed and its textures are
+        * decoded on a worker thread
+        */
+        struct IStep
+        {
+            IEStepType           m_Type;
+            CSR_Level::IItem*    m_pItem;
+            CSR_ECollisionType   m_CollisionType;
+            std::string          m_FileName;   // relative file name to read, empty if none
+            std::string          m_Absolute;   // absolute file name to read
+            const CSR_Buffer*    m_pContent;   // file content already contained in the level file
+            CSR_Buffer*          m_pBuffer;    // file content read by the worker
+            CSR_Model*           m_pModel;     // parsed WaveFront model
+            CSR_MDL*             m_pMDL;       // parsed Quake I model, without skins
+            const CSR_MeshCache* m_pMeshCache; // cooked models cache, NULL if none
+            ITextures            m_Textures;   // textures to decode, the 6 cubemap faces for a skybox
+            CSR_Job              m_Job;
+
+            IStep();
+            ~IStep();
+        };
+
+        typedef std::vector<IStep*> ISteps;
+
         std::string                    m_LevelDir;
         IFiles                         m_Files;
+        ISteps                         m_Steps;
+        std::size_t                    m_StepIndex;
+        CSR_JobPool*                   m_pJobPool;
         bool                           m_SaveContent;
         CSR_Level::ITfLoadCubemap      m_fOnLoadCubemap;
         CSR_Level::ITfLoadTexture      m_fOnLoadTexture;
@@ -117,6 +209,53 @@ class CSR_LevelFile_XML
         */
         void Clear();
 
+        /**
+        * Clears the loading steps, waits until their jobs are done
+        */
+        void ClearSteps();
+
+        /**
+        * Adds a loading step
+        *@param pStep - step to add, the serializer takes the ownership
+        */
+        void AddStep(IStep* pStep);
+
+        /**
+        * Adds a texture to decode while a step is loaded
+        *@param pStep - step which should decode the texture
+        *@param fileName - relative texture file name
+        */
+        static void AddStepTexture(IStep* pStep, const std::string& fileName);
+
+        /**
+        * Gets if all the textures of a step were decoded
+        *@param pStep - step to check
+        *@return true if all the step textures were decoded, otherwise false
+        */
+        static bool IsDecoded(const IStep* pStep);
+
+        /**
+        * Executes a loading step on a worker thread
+        *@param pArg - step to execute
+        */
+        static void OnLoadStep(void* pArg);
+
+        /**
+        * Adds a loaded step content to the level
+        *@param pStep - step to commit
+        *@param[in, out] level - level in which the step content should be added
+        *@return true on success, otherwise false
+        */
+        bool CommitStep(IStep* pStep, CSR_Level& level);
+
+        /**
+        * Adds a loaded scene item to the level
+        *@param pStep - step containing the scene item to add
+        *@param[in, out] level - level in which the scene item should be added
+        *@return true on success, otherwise false
+        */
+        bool CommitSceneItem(IStep* pStep, CSR_Level& level);
+
         /**
         * Converts a relative file name to absolute
         *@param fileName - relative file name to convert
@@ -150,10 +289,10 @@ class CSR_LevelFile_XML
         /**
         * Reads a scene item
         *@param pNode - xml node containing the scene item to read
-        *@param[in, out] level - level in which the scene item should be added
         *@return true on success, otherwise false
+        *@note The scene item is added to the loading steps, see CommitSceneItem()
         */
-        bool ReadSceneItem(const XMLNode* pNode, CSR_Level& level);
+        bool ReadSceneItem(const XMLNode* pNode);
 
         /**
         * Reads a skybox from an xml node
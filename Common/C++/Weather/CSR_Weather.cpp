@@ -15,36 +15,174 @@
 
 #include "CSR_Weather.h"
 
+// std
+#include <stdlib.h>
+#include <string.h>
+#include <cstring>
+#include <stdexcept>
+#include <algorithm>
+
 //---------------------------------------------------------------------------
 // CSR_Weather
 //---------------------------------------------------------------------------
 CSR_Weather::CSR_Weather(CSR_Scene* pScene) :
     m_pScene(pScene),
-    m_pParticles(NULL)
+    m_pEngine(NULL),
+    m_pShape(NULL),
+    m_pMesh(NULL),
+    m_pPool(NULL)
 {
-    m_pParticles = csrParticlesCreate();
+    csrMat4Identity(&m_Matrix);
+
+    m_pEngine = csrParticleEngineCreate();
 }
 //---------------------------------------------------------------------------
 CSR_Weather::~CSR_Weather()
 {
-    csrParticlesRelease(m_pParticles);
+    // NOTE the mesh belongs to the scene, and will be released with it
+    csrParticleEngineRelease(m_pEngine);
+    csrVertexBufferRelease(m_pShape);
 }
 //---------------------------------------------------------------------------
 void* CSR_Weather::GetKey()
 {
-    return m_pParticles;
+    return m_pEngine;
+}
+//---------------------------------------------------------------------------
+void CSR_Weather::SetJobPool(CSR_JobPool* pPool)
+{
+    m_pPool = pPool;
 }
 //---------------------------------------------------------------------------
 void CSR_Weather::Animate(float elapsedTime)
 {
-    csrParticlesAnimate(m_pParticles, elapsedTime);
+    csrParticleEngineAnimateParallel(m_pEngine, elapsedTime, m_pPool);
+
+    UpdateMesh();
+}
+//---------------------------------------------------------------------------
+void CSR_Weather::AddToScene(CSR_VertexBuffer* pShape)
+{
+    // keep the shape
+    csrVertexBufferRelease(m_pShape);
+    m_pShape = pShape;
+
+    if (!m_pScene || !m_pEngine || !m_pShape)
+        return;
+
+    // create the mesh which will contain all the particles
+    CSR_Mesh* pMesh = csrMeshCreate();
+
+    // succeeded?
+    if (!pMesh)
+        throw std::runtime_error("Could not create the weather mesh");
+
+    pMesh->m_pVB = csrVertexBufferCreate();
+
+    // succeeded?
+    if (!pMesh->m_pVB)
+    {
+        csrMeshRelease(pMesh, 0);
+        throw std::runtime_error("Could not create the weather mesh");
+    }
+
+    pMesh->m_Count           = 1;
+    pMesh->m_pVB->m_Material = m_pShape->m_Material;
+    pMesh->m_pVB->m_Culling  = m_pShape->m_Culling;
+
+    // add it to the scene
+    if (!csrSceneAddMesh(m_pScene, pMesh, pMesh->m_pVB->m_Material.m_Transparent, 0))
+    {
+        csrMeshRelease(pMesh, 0);
+        throw std::runtime_error("Could not add the weather mesh to the scene");
+    }
+
+    // the mesh vertices are already in world coordinates, thus it's drawn once with an identity matrix
+    csrSceneAddModelMatrix(m_pScene, pMesh, &m_Matrix);
+
+    m_pMesh = pMesh;
+
+    UpdateMesh();
 }
 //---------------------------------------------------------------------------
-void CSR_Weather::Set_OnCalculateMotion_Callback(CSR_fOnCalculateMotion fHandle)
+void CSR_Weather::UpdateMesh()
 {
-    if (!m_pParticles)
+    if (!m_pMesh)
         return;
 
-    m_pParticles->m_fOnCalculateMotion = fHandle;
+    csrParticleEngineToVBParallel(m_pEngine, m_pShape, m_pMesh->m_pVB, m_pPool);
+}
+//---------------------------------------------------------------------------
+CSR_VertexBuffer* CSR_Weather::CreateShape(const CSR_Mesh* pMesh)
+{
+    if (!pMesh || !pMesh->m_Count)
+        return NULL;
+
+    // get the mesh polygons
+    CSR_IndexedPolygonBuffer* pIPB = csrIndexedPolygonBufferFromMesh(pMesh);
+
+    // succeeded?
+    if (!pIPB)
+        return NULL;
+
+    CSR_VertexBuffer* pShape = csrVertexBufferCreate();
+
+    // succeeded?
+    if (!pShape)
+    {
+        csrIndexedPolygonBufferRelease(pIPB);
+        return NULL;
+    }
+
+    // the shape is a triangle list with the mesh format
+    pShape->m_Format        = pMesh->m_pVB[0].m_Format;
+    pShape->m_Format.m_Type = CSR_VT_Triangles;
+    pShape->m_Culling       = pMesh->m_pVB[0].m_Culling;
+    pShape->m_Material      = pMesh->m_pVB[0].m_Material;
+
+    const std::size_t stride = pShape->m_Format.m_Stride;
+
+    pShape->m_pData = (float*)malloc(pIPB->m_Count * 3 * stride * sizeof(float));
+
+    // succeeded?
+    if (!pShape->m_pData)
+    {
+        csrIndexedPolygonBufferRelease(pIPB);
+        csrVertexBufferRelease(pShape);
+        return NULL;
+    }
+
+    // copy the polygon vertices
+    for (std::size_t i = 0; i < pIPB->m_Count; ++i)
+    {
+        const CSR_IndexedPolygon& polygon = pIPB->m_pIndexedPolygon[i];
+
+        // all the vertices should have the same format
+        if (polygon.m_pVB->m_Format.m_Stride != stride)
+            continue;
+
+        for (std::size_t j = 0; j < 3; ++j)
+        {
+            std::memcpy(&pShape->m_pData[pShape->m_Count],
+                        &polygon.m_pVB->m_pData[polygon.m_pIndex[j]],
+                        stride * sizeof(float));
+
+            pShape->m_Count += stride;
+        }
+    }
+
+    csrIndexedPolygonBufferRelease(pIPB);
+
+    return pShape;
+}
+//---------------------------------------------------------------------------
+void CSR_Weather::GetBounds(const CSR_Box& box, CSR_Box& bounds)
+{
+    bounds.m_Min.m_X = std::min(box.m_Min.m_X, box.m_Max.m_X);
+    bounds.m_Min.m_Y = std::min(box.m_Min.m_Y, box.m_Max.m_Y);
+    bounds.m_Min.m_Z = std::min(box.m_Min.m_Z, box.m_Max.m_Z);
+    bounds.m_Max.m_X = std::max(box.m_Min.m_X, box.m_Max.m_X);
+    bounds.m_Max.m_Y = std::max(box.m_Min.m_Y, box.m_Max.m_Y);
+    bounds.m_Max.m_Z = std::max(box.m_Min.m_Z, box.m_Max.m_Z);
 }
 //---------------------------------------------------------------------------
@@ -22,6 +22,7 @@
 
 /**
 * Base class for weather effects
+*@note All the weather particles are drawn at once, from a single mesh updated on each animation
 *@author Jean-Milost Reymond
 */
 class CSR_Weather
@@ -36,36 +37,58 @@ class CSR_Weather
         virtual ~CSR_Weather();
 
         /**
-        * Gets the weather particle system key
-        *@return the weather particle system key
+        * Gets the weather particle engine key
+        *@return the weather particle engine key
         */
         virtual void* GetKey();
 
+        /**
+        * Sets the job pool used to animate the weather
+        *@param pPool - job pool, if NULL the weather is animated in the calling thread
+        *@note The job pool is not owned by the weather effect, and should remain valid while used
+        *@note The result is the same whatever the thread count
+        */
+        virtual void SetJobPool(CSR_JobPool* pPool);
+
         /**
         * Animates the weather
         *@param elapedTime - elapsed time since the last animation
         */
         virtual void Animate(float elapsedTime);
 
+    protected:
+        CSR_Scene*          m_pScene;
+        CSR_ParticleEngine* m_pEngine;
+        CSR_VertexBuffer*   m_pShape;
+        CSR_Mesh*           m_pMesh;
+        CSR_Matrix4         m_Matrix;
+        CSR_JobPool*        m_pPool;
+
         /**
-        * Called when a motion should be calculated for a particle
-        *@param pParticles - particle system at which the particle belongs
-        *@param pParticle - particle for which the motion should be calculated
-        *@param elapedTime - elapsed time since last animation, in milliseconds
+        * Adds the particles to the scene, as a single mesh
+        *@param pShape - shape to draw at each particle position, should be a triangle or line list
+        *@note The shape is owned by the weather effect after this call
         */
-        virtual void OnCalculateMotion(const CSR_Particles* pParticles,
-                                             CSR_Particle*  pParticle,
-                                             float          elapsedTime) = 0;
+        virtual void AddToScene(CSR_VertexBuffer* pShape);
 
         /**
-        * Sets OnCalculateMotion callback
-        *@param fHandler - function handler
+        * Updates the mesh from the particles
         */
-        virtual void Set_OnCalculateMotion_Callback(CSR_fOnCalculateMotion fHandle);
+        virtual void UpdateMesh();
 
-    protected:
-        CSR_Scene*     m_pScene;
-        CSR_Particles* m_pParticles;
+        /**
+        * Creates a shape from a mesh
+        *@param pMesh - mesh
+        *@return the shape, as a triangle list, NULL on error
+        */
+        static CSR_VertexBuffer* CreateShape(const CSR_Mesh* pMesh);
+
+        /**
+        * Gets the particle engine bounds matching with a weather box
+        *@param box - weather box, its min and max values may be inverted
+        *@param[out] bounds - particle engine bounds
+        */
+        static void GetBounds(const CSR_Box& box, CSR_Box& bounds);
 };
 
 #endif
@@ -16,10 +16,7 @@
 #include "CSR_Weather_Snow.h"
 
 // std
-#include <stdlib.h>
 #include <stdexcept>
-#include <memory>
-#include <math.h>
 
 // compactStar engine
 #include "CSR_Model.h"
@@ -38,116 +35,52 @@ CSR_Weather_Snow::CSR_Weather_Snow(      CSR_Scene*   pScene,
     m_WindForce(windForce),
     m_CloudHeight(cloudHeight)
 {
-    // initialize the random number generator
-    std::srand(0);
-
     // was the particle engine successfully created?
-    if (m_pParticles)
-    {
-        std::auto_ptr<CSR_Mesh> pMesh;
-
-        // create the snow particle model
-        if (!useSphere)
-            pMesh.reset(csrShapeCreateDisk(0.0f, 0.0f, 0.01f, 5, 0, 0, 0, 0));
-        else
-            pMesh.reset(csrShapeCreateSphere(0.01f, 5, 5, 0, 0, 0, 0));
-
-        // add it to the scene
-        CSR_SceneItem* pItem = csrSceneAddMesh(m_pScene, pMesh.get(), 0, 0);
+    if (!m_pEngine)
+        return;
 
-        // succeeded?
-        if (!pItem)
-            std::runtime_error("Could not create the snow particle model");
+    CSR_ParticleEmitter emitter;
+    csrParticleEmitterInit(&emitter);
 
-        // calculate the box size
-        const float width  = (m_SnowBox.m_Max.m_X - m_SnowBox.m_Min.m_X) * 1000.0f;
-        const float height = -cloudHeight                                * 1000.0f;
-        const float depth  = (m_SnowBox.m_Max.m_Z - m_SnowBox.m_Min.m_Z) * 1000.0f;
+    // the snowflakes are created in the cloud height, at the top of the snow box
+    emitter.m_Box           = m_SnowBox;
+    emitter.m_Box.m_Max.m_Y = m_SnowBox.m_Min.m_Y - m_CloudHeight;
 
-        // check if values should be inverted
-        const bool invX = width  < 0.0f;
-        const bool invY = height < 0.0f;
-        const bool invZ = depth  < 0.0f;
+    // the snowflakes fall at a constant speed, and are pushed by the wind
+    emitter.m_MinVelocity.m_X = -190.0f * windForce.m_X;
+    emitter.m_MinVelocity.m_Y = -100.0f * M_CSR_Gravitation;
+    emitter.m_MinVelocity.m_Z = -190.0f * windForce.m_Z;
+    emitter.m_MaxVelocity.m_X =  0.0f;
+    emitter.m_MaxVelocity.m_Y = -100.0f * M_CSR_Gravitation;
+    emitter.m_MaxVelocity.m_Z =  0.0f;
 
-        // iterate through the particles to create
-        for (std::size_t i = 0; i < count; ++i)
-        {
-            // add a new particle and set his mass (+/- 4mg for a snowflake)
-            CSR_Particle* pParticle    = csrParticlesAdd(m_pParticles);
-            pParticle->m_pBody->m_Mass = 0.004f;
+    // the snowflakes which leave the snow box are moved to the opposite side
+    GetBounds(m_SnowBox, m_pEngine->m_Bounds);
+    m_pEngine->m_BoundsMode = CSR_PB_Wrap;
 
-            // calculate the particle start position
-            const float x = m_SnowBox.m_Min.m_X + (float(std::rand() % int(std::fabs(width)))  * (invX ? -0.001 : 0.001));
-            const float y = m_SnowBox.m_Min.m_Y + (float(std::rand() % int(std::fabs(height))) * (invY ? -0.001 : 0.001));
-            const float z = m_SnowBox.m_Min.m_Z + (float(std::rand() % int(std::fabs(depth)))  * (invZ ? -0.001 : 0.001));
+    // create the snowflakes
+    if (csrParticleEngineSpawn(m_pEngine, &emitter, count) != count)
+        throw std::runtime_error("Could not create the snow particles");
 
-            // calculate the particle initial force
-            pParticle->m_pBody->m_Velocity.m_X = -10.0f *  windForce.m_X * float(std::rand() % 20);
-            pParticle->m_pBody->m_Velocity.m_Y =  12.0f + (windForce.m_Y * ((m_CloudHeight - (y - (m_SnowBox.m_Min.m_Y - m_CloudHeight))) * 2.0f));
-            pParticle->m_pBody->m_Velocity.m_Z = -10.0f *  windForce.m_Z * float(std::rand() % 20);
+    CSR_Mesh* pMesh;
 
-            // configure the particle matrix (was set to identity while the particle was created)
-            pParticle->m_pMatrix->m_Table[3][0] = x;
-            pParticle->m_pMatrix->m_Table[3][1] = y;
-            pParticle->m_pMatrix->m_Table[3][2] = z;
+    // create the snow particle model
+    if (!useSphere)
+        pMesh = csrShapeCreateDisk(0.0f, 0.0f, 0.01f, 5, 0, 0, 0, 0);
+    else
+        pMesh = csrShapeCreateSphere(0.01f, 5, 5, 0, 0, 0, 0);
 
-            // add it to the scene
-            csrSceneAddModelMatrix(m_pScene, pMesh.get(), pParticle->m_pMatrix);
+    CSR_VertexBuffer* pShape = CreateShape(pMesh);
+    csrMeshRelease(pMesh, 0);
 
-            // keep the particle model key
-            pParticle->m_pKey = pItem->m_pModel;
-        }
+    // succeeded?
+    if (!pShape)
+        throw std::runtime_error("Could not create the snow particle model");
 
-        pMesh.release();
-    }
+    // add the snowflakes to the scene
+    AddToScene(pShape);
 }
 //---------------------------------------------------------------------------
 CSR_Weather_Snow::~CSR_Weather_Snow()
 {}
 //---------------------------------------------------------------------------
-void CSR_Weather_Snow::OnCalculateMotion(const CSR_Particles* pParticles,
-                                               CSR_Particle*  pParticle,
-                                               float          elapsedTime)
-{
-    // no particle?
-    if (!pParticle)
-        return;
-
-    // calculate the new particle position
-    pParticle->m_pMatrix->m_Table[3][0] += pParticle->m_pBody->m_Velocity.m_X * (elapsedTime * 0.001f);
-    pParticle->m_pMatrix->m_Table[3][1] -= M_CSR_Gravitation                  * (elapsedTime * 0.1f);
-    pParticle->m_pMatrix->m_Table[3][2] += pParticle->m_pBody->m_Velocity.m_Z * (elapsedTime * 0.001f);
-
-    // was the particle gone out of the snow box bottom?
-    if (pParticle->m_pMatrix->m_Table[3][1] < m_SnowBox.m_Max.m_Y)
-    {
-        // calculate a new start position
-        const float height = -m_CloudHeight * 1000.0f;
-        const bool  invY   =  height < 0.0f;
-        const float y      =  m_SnowBox.m_Min.m_Y + (float(std::rand() % int(std::fabs(height))) * (invY ? -0.001 : 0.001));
-
-        // reset the particle
-        pParticle->m_pBody->m_Velocity.m_Y =
-                12.0f + (m_WindForce.m_Y * ((m_CloudHeight - (y - (m_SnowBox.m_Min.m_Y - m_CloudHeight))) * 2.0f));
-        pParticle->m_pMatrix->m_Table[3][1]        = y;
-    }
-
-    // was the particle gone out of the rain box left or right?
-    if (pParticle->m_pMatrix->m_Table[3][0] < m_SnowBox.m_Min.m_X)
-        // gone out left, put it on the right side
-        pParticle->m_pMatrix->m_Table[3][0] = m_SnowBox.m_Max.m_X;
-    else
-    if (pParticle->m_pMatrix->m_Table[3][0] > m_SnowBox.m_Max.m_X)
-        // gone out right, put it on the left side
-        pParticle->m_pMatrix->m_Table[3][0] = m_SnowBox.m_Min.m_X;
-
-    // was the particle gone out of the rain box front or back?
-    if (pParticle->m_pMatrix->m_Table[3][2] > m_SnowBox.m_Min.m_Z)
-        // gone out front, put it on the back side
-        pParticle->m_pMatrix->m_Table[3][2] = m_SnowBox.m_Max.m_Z;
-    else
-    if (pParticle->m_pMatrix->m_Table[3][2] < m_SnowBox.m_Max.m_Z)
-        // gone out back, put it on the front side
-        pParticle->m_pMatrix->m_Table[3][2] = m_SnowBox.m_Min.m_Z;
-}
-//---------------------------------------------------------------------------
@@ -43,16 +43,6 @@ class CSR_Weather_Snow : public CSR_Weather
 
         virtual ~CSR_Weather_Snow();
 
-        /**
-        * Called when a motion should be calculated for a particle
-        *@param pParticles - particle system at which the particle belongs
-        *@param pParticle - particle for which the motion should be calculated
-        *@param elapedTime - elapsed time since last animation, in milliseconds
-        */
-        virtual void OnCalculateMotion(const CSR_Particles* pParticles,
-                                             CSR_Particle*  pParticle,
-                                             float          elapsedTime);
-
     private:
         CSR_Box     m_SnowBox;
         CSR_Vector3 m_WindForce;
@@ -243,22 +243,6 @@ void TMainForm::OnSceneEndCallback(const CSR_Scene* pScene, const CSR_SceneConte
     pMainForm->OnSceneEnd(pScene, pContext);
 }
 //---------------------------------------------------------------------------
-void TMainForm::OnCalculateMotionCallback(const CSR_Particles* pParticles,
-                                                CSR_Particle*  pParticle,
-                                                float          elapsedTime)
-{
-    TMainForm* pMainForm = static_cast<TMainForm*>(Application->MainForm);
-
-    if (!pMainForm)
-        return;
-
-    if (pMainForm->m_pRain && pParticles == pMainForm->m_pRain->GetKey())
-        pMainForm->m_pRain->OnCalculateMotion(pParticles, pParticle, elapsedTime);
-
-    if (pMainForm->m_pSnow && pParticles == pMainForm->m_pSnow->GetKey())
-        pMainForm->m_pSnow->OnCalculateMotion(pParticles, pParticle, elapsedTime);
-}
-//---------------------------------------------------------------------------
 void TMainForm::CreateWeather(bool rain, bool snow)
 {
     // stop the currently polaying sounds
@@ -331,7 +315,6 @@ void TMainForm::CreateWeather(bool rain, bool snow)
     if (rain)
     {
         m_pRain = new CSR_Weather_Rain(m_pScene, weatherBox, 2.0f, rainWindForce, 2000, 0.1f);
-        m_pRain->Set_OnCalculateMotion_Callback(OnCalculateMotionCallback);
 
         // load the sound file
         m_pRainSound = csrSoundOpenWavFile(m_pOpenALDevice, m_pOpenALContext, (m_SceneDir + "\\Rain\\Rain.wav").c_str());
@@ -347,7 +330,6 @@ void TMainForm::CreateWeather(bool rain, bool snow)
     if (snow)
     {
         m_pSnow = new CSR_Weather_Snow(m_pScene, weatherBox, 2.0f, snowWindForce, 2000, true);
-        m_pSnow->Set_OnCalculateMotion_Callback(OnCalculateMotionCallback);
 
         // load the sound file
         m_pWindSound = csrSoundOpenWavFile(m_pOpenALDevice, m_pOpenALContext, (m_SceneDir + "\\Wind\\Wind.wav").c_str());
@@ -91,16 +91,6 @@ class TMainForm : public TForm
         */
         static void OnSceneEndCallback(const CSR_Scene* pScene, const CSR_SceneContext* pContext);
 
-        /**
-        * Called when a motion should be calculated for a particle
-        *@param pParticles - particle system at which the particle belongs
-        *@param pParticle - particle for which the motion should be calculated
-        *@param elapedTime - elapsed time since last animation, in milliseconds
-        */
-        static void OnCalculateMotionCallback(const CSR_Particles* pParticles,
-                                                    CSR_Particle*  pParticle,
-                                                    float          elapsedTime);
-
     private:
         HDC                                   m_hDC;
         HGLRC                                 m_hRC;
@@ -19,6 +19,19 @@
 // std
 #include <stdlib.h>
 
+//---------------------------------------------------------------------------
+// Private structures
+//---------------------------------------------------------------------------
+
+/**
+* Parallel tasks to execute
+*/
+typedef struct
+{
+    CSR_TaskManager*       m_pTaskManager;
+    const CSR_TaskContext* m_pContext;
+} CSR_TaskParallelRun;
+
 //---------------------------------------------------------------------------
 // Task functions
 //---------------------------------------------------------------------------
@@ -59,9 +72,75 @@ void csrTaskInit(CSR_Task* pTask)
         return;
 
     // initialize the task
-    pTask->m_Action   = 0;
-    pTask->m_AutoFree = 0;
-    pTask->m_pData    = 0;
+    pTask->m_Action        = 0;
+    pTask->m_AutoFree      = 0;
+    pTask->m_pData         = 0;
+    pTask->m_Priority      = 0;
+    pTask->m_Parallel      = 0;
+    pTask->m_WaitTime      = 0.0;
+    pTask->m_RunCount      = 0;
+    pTask->m_LastDuration  = 0.0;
+    pTask->m_MaxDuration   = 0.0;
+    pTask->m_TotalDuration = 0.0;
+}
+//---------------------------------------------------------------------------
+// Task manager private functions
+//---------------------------------------------------------------------------
+void csrTaskRun(CSR_Task* pTask, const CSR_TaskContext* pContext)
+{
+    int    taskCompleted = 0;
+    double startTime     = csrJobGetTime();
+    double duration;
+
+    // run the task, and change it if completed
+    if (pContext->m_fOnTaskRun)
+        taskCompleted = pContext->m_fOnTaskRun(pTask, pTask->m_WaitTime);
+
+    if (taskCompleted && pContext->m_fOnTaskChange)
+        pContext->m_fOnTaskChange(pTask, pTask->m_WaitTime);
+
+    duration = csrJobGetTime() - startTime;
+
+    // update the task statistics
+    ++pTask->m_RunCount;
+    pTask->m_LastDuration   = duration;
+    pTask->m_TotalDuration += duration;
+
+    if (duration > pTask->m_MaxDuration)
+        pTask->m_MaxDuration = duration;
+
+    pTask->m_WaitTime = 0.0;
+}
+//---------------------------------------------------------------------------
+void csrTaskRunParallel(void* pArg, size_t index)
+{
+    CSR_TaskParallelRun* pRun = (CSR_TaskParallelRun*)pArg;
+
+    // the parallel tasks are stored on the order start
+    csrTaskRun(&pRun->m_pTaskManager->m_pTask[pRun->m_pTaskManager->m_pOrder[index].m_Index],
+                pRun->m_pContext);
+}
+//---------------------------------------------------------------------------
+int csrTaskOrderCompare(const void* pA, const void* pB)
+{
+    const CSR_TaskOrder* pOrderA = (const CSR_TaskOrder*)pA;
+    const CSR_TaskOrder* pOrderB = (const CSR_TaskOrder*)pB;
+
+    // the most urgent task first
+    if (pOrderA->m_Urgency > pOrderB->m_Urgency)
+        return -1;
+
+    if (pOrderA->m_Urgency < pOrderB->m_Urgency)
+        return 1;
+
+    // on equality keep the task order, qsort isn't stable
+    if (pOrderA->m_Index < pOrderB->m_Index)
+        return -1;
+
+    if (pOrderA->m_Index > pOrderB->m_Index)
+        return 1;
+
+    return 0;
 }
 //---------------------------------------------------------------------------
 // Task manager functions
@@ -100,6 +179,10 @@ void csrTaskManagerRelease(CSR_TaskManager* pTM)
         free(pTM->m_pTask);
     }
 
+    // free the scheduling order
+    if (pTM->m_pOrder)
+        free(pTM->m_pOrder);
+
     // free the task manager
     free(pTM);
 }
@@ -111,8 +194,12 @@ void csrTaskManagerInit(CSR_TaskManager* pTM)
         return;
 
     // initialize the task manager
-    pTM->m_pTask = 0;
-    pTM->m_Count = 0;
+    pTM->m_pTask          = 0;
+    pTM->m_Count          = 0;
+    pTM->m_pOrder         = 0;
+    pTM->m_OrderCapacity  = 0;
+    pTM->m_LastDuration   = 0.0;
+    pTM->m_PostponedCount = 0;
 }
 //---------------------------------------------------------------------------
 void csrTaskManagerExecute(const CSR_TaskManager* pTaskManager,
@@ -140,3 +227,96 @@ void csrTaskManagerExecute(const CSR_TaskManager* pTaskManager,
     }
 }
 //---------------------------------------------------------------------------
+void csrTaskManagerSchedule(CSR_TaskManager*       pTaskManager,
+                            const CSR_TaskContext* pContext,
+                            CSR_JobPool*           pPool,
+                            double                 budget,
+                            double                 elapsedTime)
+{
+    CSR_TaskParallelRun run;
+    double              startTime;
+    double              serialStartTime;
+    size_t              parallelCount;
+    size_t              serialCount;
+    size_t              i;
+
+    // validate the inputs
+    if (!pTaskManager || !pContext)
+        return;
+
+    startTime                      = csrJobGetTime();
+    pTaskManager->m_PostponedCount = 0;
+
+    // reserve the scheduling order
+    if (pTaskManager->m_OrderCapacity < pTaskManager->m_Count)
+    {
+        CSR_TaskOrder* pOrder = (CSR_TaskOrder*)csrMemoryAlloc(pTaskManager->m_pOrder,
+                                                               sizeof(CSR_TaskOrder),
+                                                               pTaskManager->m_Count);
+
+        if (!pOrder)
+            return;
+
+        pTaskManager->m_pOrder        = pOrder;
+        pTaskManager->m_OrderCapacity = pTaskManager->m_Count;
+    }
+
+    parallelCount = 0;
+    serialCount   = 0;
+
+    // build the order, the parallel tasks on the start, the serial ones on the end
+    for (i = 0; i < pTaskManager->m_Count; ++i)
+    {
+        CSR_Task* pTask = &pTaskManager->m_pTask[i];
+
+        pTask->m_WaitTime += elapsedTime;
+
+        if (pTask->m_Parallel)
+        {
+            pTaskManager->m_pOrder[parallelCount].m_Urgency = 0.0;
+            pTaskManager->m_pOrder[parallelCount].m_Index   = i;
+            ++parallelCount;
+        }
+        else
+        {
+            CSR_TaskOrder* pOrder = &pTaskManager->m_pOrder[pTaskManager->m_Count - 1 - serialCount];
+
+            pOrder->m_Urgency = pTask->m_WaitTime * (double)(pTask->m_Priority + 1);
+            pOrder->m_Index   = i;
+            ++serialCount;
+        }
+    }
+
+    // execute the parallel tasks
+    if (parallelCount)
+    {
+        run.m_pTaskManager = pTaskManager;
+        run.m_pContext     = pContext;
+
+        csrJobPoolParallelFor(pPool, parallelCount, csrTaskRunParallel, &run);
+    }
+
+    // sort the serial tasks by urgency
+    if (serialCount > 1)
+        qsort(&pTaskManager->m_pOrder[parallelCount],
+              serialCount,
+              sizeof(CSR_TaskOrder),
+              csrTaskOrderCompare);
+
+    serialStartTime = csrJobGetTime();
+
+    // execute the serial tasks until the budget is spent
+    for (i = 0; i < serialCount; ++i)
+    {
+        if (i && budget > 0.0 && csrJobGetTime() - serialStartTime >= budget)
+        {
+            pTaskManager->m_PostponedCount = serialCount - i;
+            break;
+        }
+
+        csrTaskRun(&pTaskManager->m_pTask[pTaskManager->m_pOrder[parallelCount + i].m_Index], pContext);
+    }
+
+    pTaskManager->m_LastDuration = csrJobGetTime() - startTime;
+}
+//---------------------------------------------------------------------------
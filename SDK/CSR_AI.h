@@ -19,6 +19,7 @@
 
 // compactStar engine
 #include "CSR_Common.h"
+#include "CSR_Job.h"
 
 //---------------------------------------------------------------------------
 // Structures
@@ -29,18 +30,38 @@
 */
 typedef struct
 {
-    int   m_Action;
-    int   m_AutoFree;
-    void* m_pData;
+    int    m_Action;
+    int    m_AutoFree;
+    void*  m_pData;
+    int    m_Priority;      // scheduling priority, 0 is the lowest, see csrTaskManagerSchedule()
+    int    m_Parallel;      // if 1, the task only accesses its own data and may run on a worker thread
+    double m_WaitTime;      // time elapsed since the task last ran, in the caller unit
+    size_t m_RunCount;      // number of times the task ran
+    double m_LastDuration;  // duration of the last run, in milliseconds
+    double m_MaxDuration;   // longest run, in milliseconds
+    double m_TotalDuration; // duration of all the runs, in milliseconds
 } CSR_Task;
 
+/**
+* Task order, used to schedule the tasks
+*/
+typedef struct
+{
+    double m_Urgency;
+    size_t m_Index;
+} CSR_TaskOrder;
+
 /**
 * Task manager
 */
 typedef struct
 {
-    CSR_Task* m_pTask;
-    size_t    m_Count;
+    CSR_Task*      m_pTask;
+    size_t         m_Count;
+    CSR_TaskOrder* m_pOrder;         // scheduling order, rebuilt on each schedule
+    size_t         m_OrderCapacity;
+    double         m_LastDuration;   // duration of the last schedule, in milliseconds
+    size_t         m_PostponedCount; // serial tasks postponed by the last schedule because the budget was spent
 } CSR_TaskManager;
 
 //---------------------------------------------------------------------------
@@ -137,6 +158,28 @@ typedef struct
                                    const CSR_TaskContext* pContext,
                                          double           elapsedTime);
 
+        /**
+        * Schedules the tasks, i.e. executes the parallel tasks and as many serial tasks as the budget allows
+        *@param[in, out] pTaskManager - task manager
+        *@param pContext - task manager context
+        *@param[in, out] pPool - job pool on which the parallel tasks are executed, if 0 they are
+        *                        executed in the calling thread
+        *@param budget - time the serial tasks may spend, in milliseconds, unlimited if 0
+        *@param elapsedTime - elapsed time since last task was processed
+        *@note The parallel tasks (m_Parallel set to 1) all run on each call, and their callbacks
+        *      are called from the pool threads. They should thus only access their own task data
+        *@note The serial tasks run in the calling thread, the most urgent first. The urgency is the
+        *      time a task is waiting multiplied by its priority + 1, so a postponed task always ends
+        *      to run. The first serial task always runs, even if the budget is already spent
+        *@note A task receives the time elapsed since it last ran, instead of the frame elapsed time
+        *@note The task statistics are updated on each run
+        */
+        void csrTaskManagerSchedule(CSR_TaskManager*       pTaskManager,
+                                    const CSR_TaskContext* pContext,
+                                    CSR_JobPool*           pPool,
+                                    double                 budget,
+                                    double                 elapsedTime);
+
 #ifdef __cplusplus
     }
 #endif
@@ -7949,7 +7949,7 @@ CSR_Collada* csrColladaOpen(const char*                 pFileName,
     CSR_Collada* pCollada;
 
     // open the model file
-    pBuffer = csrFileOpen(pFileName);
+    pBuffer = csrFileMap(pFileName);
 
     // succeeded?
     if (!pBuffer || !pBuffer->m_Length)
@@ -17,6 +17,8 @@
 
 // std
 #include <stdlib.h>
+#include <string.h>
+#include <math.h>
 
 //---------------------------------------------------------------------------
 // Aligned-Axis Bounding Box tree functions
@@ -303,15 +305,11 @@ int csrAABBTreeResolve(const CSR_Ray3*           pRay,
         int           leftResolved   = 0;
         int           rightResolved  = 0;
         CSR_Polygon3* pPolygonBuffer = 0;
-        CSR_Figure3   ray            = {0};
-        CSR_Figure3   box            = {0};
     #else
         unsigned      i;
         int           leftResolved  = 0;
         int           rightResolved = 0;
         CSR_Polygon3* pPolygonBuffer;
-        CSR_Figure3   ray;
-        CSR_Figure3   box;
     #endif
 
     // no ray?
@@ -362,35 +360,19 @@ int csrAABBTreeResolve(const CSR_Ray3*           pRay,
         return 1;
     }
 
-    // convert ray to geometric figure
-    ray.m_Type    = CSR_F3_Ray;
-    ray.m_pFigure = pRay;
-
     // node contains a left child?
     if (pNode->m_pLeft)
-    {
-        // convert left box to geometric figure
-        box.m_Type    = CSR_F3_Box;
-        box.m_pFigure = pNode->m_pLeft->m_pBox;
-
         // check if ray intersects the left box
-        if (csrIntersect3(&ray, &box, 0, 0, 0))
+        if (csrIntersect3RayBox(pRay, pNode->m_pLeft->m_pBox, 0, 0))
             // resolve left node
             leftResolved = csrAABBTreeResolve(pRay, pNode->m_pLeft, deep + 1, pPolygons);
-    }
 
     // node contains a right child?
     if (pNode->m_pRight)
-    {
-        // convert right box to geometric figure
-        box.m_Type    = CSR_F3_Box;
-        box.m_pFigure = pNode->m_pRight->m_pBox;
-
         // check if ray intersects the right box
-        if (csrIntersect3(&ray, &box, 0, 0, 0))
+        if (csrIntersect3RayBox(pRay, pNode->m_pRight->m_pBox, 0, 0))
             // resolve right node
             rightResolved = csrAABBTreeResolve(pRay, pNode->m_pRight, deep + 1, pPolygons);
-    }
 
     return (leftResolved || rightResolved);
 }
@@ -512,6 +494,399 @@ void csrSlidingPoint(const CSR_Plane*   pSlidingPlane,
     pR->m_Z = pointOnPlane.m_Z + planeRatio.m_Z;
 }
 //---------------------------------------------------------------------------
+// Swept sphere private functions
+//---------------------------------------------------------------------------
+int csrSweptSphereLowestRoot(float a, float b, float c, float maxR, float* pRoot)
+{
+    float det;
+    float sqrtD;
+    float r1;
+    float r2;
+    float temp;
+
+    // no real solution, or no motion?
+    det = (b * b) - (4.0f * a * c);
+
+    if (det < 0.0f || a == 0.0f)
+        return 0;
+
+    sqrtD = (float)sqrt(det);
+    r1    = (-b - sqrtD) / (2.0f * a);
+    r2    = (-b + sqrtD) / (2.0f * a);
+
+    // sort the roots
+    if (r1 > r2)
+    {
+        temp = r2;
+        r2   = r1;
+        r1   = temp;
+    }
+
+    // get the lowest root in the range
+    if (r1 > 0.0f && r1 < maxR)
+    {
+        *pRoot = r1;
+        return 1;
+    }
+
+    if (r2 > 0.0f && r2 < maxR)
+    {
+        *pRoot = r2;
+        return 1;
+    }
+
+    return 0;
+}
+//---------------------------------------------------------------------------
+int csrSweptSphereInsideTriangle(const CSR_Vector3*  pP,
+                                 const CSR_Polygon3* pPolygon,
+                                 const CSR_Vector3*  pN)
+{
+    CSR_Vector3 edge;
+    CSR_Vector3 toP;
+    CSR_Vector3 cross;
+    float       dot;
+    size_t      i;
+
+    // the point is inside if it's on the inner side of each edge
+    for (i = 0; i < 3; ++i)
+    {
+        csrVec3Sub  (&pPolygon->m_Vertex[(i + 1) % 3], &pPolygon->m_Vertex[i], &edge);
+        csrVec3Sub  ( pP,                              &pPolygon->m_Vertex[i], &toP);
+        csrVec3Cross(&edge, &toP, &cross);
+        csrVec3Dot  (&cross, pN, &dot);
+
+        if (dot < 0.0f)
+            return 0;
+    }
+
+    return 1;
+}
+//---------------------------------------------------------------------------
+int csrSweptSphereIntersectBox(const CSR_Vector3* pStart,
+                               const CSR_Vector3* pMotion,
+                                     float        maxTime,
+                                     float        radius,
+                               const CSR_Box*     pBox)
+{
+    const float start[3]  = {pStart->m_X,         pStart->m_Y,         pStart->m_Z};
+    const float motion[3] = {pMotion->m_X,        pMotion->m_Y,        pMotion->m_Z};
+    const float boxMin[3] = {pBox->m_Min.m_X,     pBox->m_Min.m_Y,     pBox->m_Min.m_Z};
+    const float boxMax[3] = {pBox->m_Max.m_X,     pBox->m_Max.m_Y,     pBox->m_Max.m_Z};
+    float       tMin      = 0.0f;
+    float       tMax      = maxTime;
+    float       t1;
+    float       t2;
+    float       temp;
+    size_t      i;
+
+    // intersect the motion segment with the box inflated by the sphere radius, slab by slab
+    for (i = 0; i < 3; ++i)
+    {
+        // motion parallel to the slab?
+        if (motion[i] == 0.0f)
+        {
+            if (start[i] < boxMin[i] - radius || start[i] > boxMax[i] + radius)
+                return 0;
+
+            continue;
+        }
+
+        t1 = (boxMin[i] - radius - start[i]) / motion[i];
+        t2 = (boxMax[i] + radius - start[i]) / motion[i];
+
+        if (t1 > t2)
+        {
+            temp = t1;
+            t1   = t2;
+            t2   = temp;
+        }
+
+        if (t1 > tMin)
+            tMin = t1;
+
+        if (t2 < tMax)
+            tMax = t2;
+
+        if (tMin > tMax)
+            return 0;
+    }
+
+    return 1;
+}
+//---------------------------------------------------------------------------
+void csrSweptSphereAABBTreeNode(const CSR_Sphere*         pSphere,
+                                const CSR_Vector3*        pMotion,
+                                const CSR_AABBNode*       pNode,
+                                      int*                pFound,
+                                      CSR_SweptSphereHit* pHit)
+{
+    CSR_Polygon3 polygon;
+    size_t       i;
+    float        maxTime;
+
+    // the hits found farther than the nearest one are useless
+    maxTime = *pFound ? pHit->m_Time : 1.0f;
+
+    // does the motion reach the node?
+    if (!pNode->m_pBox || !csrSweptSphereIntersectBox(&pSphere->m_Center,
+                                                        pMotion,
+                                                        maxTime,
+                                                        pSphere->m_Radius,
+                                                        pNode->m_pBox))
+        return;
+
+    // is leaf?
+    if (!pNode->m_pLeft && !pNode->m_pRight)
+    {
+        if (!pNode->m_pPolygonBuffer)
+            return;
+
+        // iterate through polygons contained in leaf
+        for (i = 0; i < pNode->m_pPolygonBuffer->m_Count; ++i)
+        {
+            if (!csrIndexedPolygonToPolygon(&pNode->m_pPolygonBuffer->m_pIndexedPolygon[i], &polygon))
+                continue;
+
+            // keep the nearest hit
+            if (csrSweptSpherePolygon(pSphere, pMotion, &polygon, *pFound ? pHit->m_Time : 1.0f, pHit))
+                *pFound = 1;
+        }
+
+        return;
+    }
+
+    if (pNode->m_pLeft)
+        csrSweptSphereAABBTreeNode(pSphere, pMotion, pNode->m_pLeft, pFound, pHit);
+
+    if (pNode->m_pRight)
+        csrSweptSphereAABBTreeNode(pSphere, pMotion, pNode->m_pRight, pFound, pHit);
+}
+//---------------------------------------------------------------------------
+// Swept sphere functions
+//---------------------------------------------------------------------------
+int csrSweptSpherePolygon(const CSR_Sphere*         pSphere,
+                          const CSR_Vector3*        pMotion,
+                          const CSR_Polygon3*       pPolygon,
+                                float               maxTime,
+                                CSR_SweptSphereHit* pHit)
+{
+    #ifdef _MSC_VER
+        CSR_Vector3 edge1   = {0};
+        CSR_Vector3 edge2   = {0};
+        CSR_Vector3 cross   = {0};
+        CSR_Vector3 n       = {0};
+        CSR_Vector3 point   = {0};
+        CSR_Vector3 contact = {0};
+        CSR_Vector3 center  = {0};
+        CSR_Vector3 toStart = {0};
+        CSR_Vector3 edge    = {0};
+    #else
+        CSR_Vector3 edge1;
+        CSR_Vector3 edge2;
+        CSR_Vector3 cross;
+        CSR_Vector3 n;
+        CSR_Vector3 point;
+        CSR_Vector3 contact;
+        CSR_Vector3 center;
+        CSR_Vector3 toStart;
+        CSR_Vector3 edge;
+    #endif
+    float  radius;
+    float  dist;
+    float  normalVel;
+    float  time;
+    float  root;
+    float  a;
+    float  b;
+    float  c;
+    float  length;
+    float  velSq;
+    float  edgeSq;
+    float  edgeDotVel;
+    float  edgeDotToStart;
+    float  f;
+    size_t i;
+    int    found;
+
+    // validate the inputs
+    if (!pSphere || !pMotion || !pPolygon || !pHit)
+        return 0;
+
+    radius = pSphere->m_Radius;
+
+    // calculate the polygon normal
+    csrVec3Sub      (&pPolygon->m_Vertex[1], &pPolygon->m_Vertex[0], &edge1);
+    csrVec3Sub      (&pPolygon->m_Vertex[2], &pPolygon->m_Vertex[0], &edge2);
+    csrVec3Cross    (&edge1, &edge2, &cross);
+    csrVec3Length   (&cross, &length);
+
+    // degenerated polygon?
+    if (length == 0.0f)
+        return 0;
+
+    csrVec3Normalize(&cross, &n);
+
+    // the polygons are two-sided, thus the normal should point toward the sphere. NOTE the cross
+    // product keeps the polygon winding, required by the inside test
+    csrVec3Sub(&pSphere->m_Center, &pPolygon->m_Vertex[0], &toStart);
+    csrVec3Dot(&toStart, &n, &dist);
+
+    if (dist < 0.0f)
+    {
+        csrVec3Inverse(&n, &n);
+        dist = -dist;
+    }
+
+    csrVec3Dot(pMotion, &n, &normalVel);
+
+    // is the sphere already intersecting the polygon?
+    if (dist < radius)
+    {
+        csrPolygon3ClosestPoint(&pSphere->m_Center, pPolygon, &point);
+        csrVec3Sub   (&pSphere->m_Center, &point, &toStart);
+        csrVec3Length(&toStart, &length);
+
+        if (length < radius)
+        {
+            // the contact normal points from the polygon toward the sphere
+            if (length > 0.0f)
+                csrVec3DivVal(&toStart, length, &edge);
+            else
+                edge = n;
+
+            csrVec3Dot(pMotion, &edge, &a);
+
+            // moving away from the polygon, e.g. when sliding along it? Let the sphere go
+            if (a >= 0.0f)
+                return 0;
+
+            pHit->m_Time     = 0.0f;
+            pHit->m_Pos      = pSphere->m_Center;
+            pHit->m_Point    = point;
+            pHit->m_Normal   = edge;
+            pHit->m_Polygon  = *pPolygon;
+            csrPlaneFromPointNormal(&point, &edge, &pHit->m_SlidingPlane);
+            return 1;
+        }
+    }
+    else
+    {
+        // moving away from the polygon plane, or not reaching it?
+        if (normalVel >= 0.0f)
+            return 0;
+
+        time = (radius - dist) / normalVel;
+
+        if (time >= maxTime)
+            return 0;
+
+        // calculate the point where the sphere touches the plane
+        csrVec3MulVal(pMotion, time, &center);
+        csrVec3Add   (&pSphere->m_Center, &center, &center);
+        csrVec3MulVal(&n, radius, &contact);
+        csrVec3Sub   (&center, &contact, &contact);
+
+        // is the contact point inside the polygon? Then nothing can be hit before
+        if (csrSweptSphereInsideTriangle(&contact, pPolygon, &cross))
+        {
+            pHit->m_Time    = time;
+            pHit->m_Pos     = center;
+            pHit->m_Point   = contact;
+            pHit->m_Normal  = n;
+            pHit->m_Polygon = *pPolygon;
+            csrPlaneFromPointNormal(&contact, &n, &pHit->m_SlidingPlane);
+            return 1;
+        }
+    }
+
+    csrVec3Dot(pMotion, pMotion, &velSq);
+
+    // no motion?
+    if (velSq == 0.0f)
+        return 0;
+
+    found = 0;
+    time  = maxTime;
+
+    // the sphere may still hit a polygon vertex or edge
+    for (i = 0; i < 3; ++i)
+    {
+        // vertex
+        csrVec3Sub(&pSphere->m_Center, &pPolygon->m_Vertex[i], &toStart);
+        csrVec3Dot(pMotion,  &toStart, &b);
+        csrVec3Dot(&toStart, &toStart, &c);
+
+        if (csrSweptSphereLowestRoot(velSq, 2.0f * b, c - (radius * radius), time, &root))
+        {
+            time    = root;
+            contact = pPolygon->m_Vertex[i];
+            found   = 1;
+        }
+
+        // edge, the sphere center hits the cylinder built around it
+        csrVec3Sub(&pPolygon->m_Vertex[(i + 1) % 3], &pPolygon->m_Vertex[i],  &edge);
+        csrVec3Sub(&pPolygon->m_Vertex[i],            &pSphere->m_Center,     &toStart);
+        csrVec3Dot(&edge,    &edge,    &edgeSq);
+        csrVec3Dot(&edge,     pMotion, &edgeDotVel);
+        csrVec3Dot(&edge,    &toStart, &edgeDotToStart);
+        csrVec3Dot( pMotion, &toStart, &b);
+        csrVec3Dot(&toStart, &toStart, &c);
+
+        a = (edgeSq * -velSq) + (edgeDotVel * edgeDotVel);
+        b = (edgeSq * 2.0f * b) - (2.0f * edgeDotVel * edgeDotToStart);
+        c = (edgeSq * ((radius * radius) - c)) + (edgeDotToStart * edgeDotToStart);
+
+        if (csrSweptSphereLowestRoot(a, b, c, time, &root))
+        {
+            // is the hit point on the edge segment?
+            f = ((edgeDotVel * root) - edgeDotToStart) / edgeSq;
+
+            if (f >= 0.0f && f <= 1.0f)
+            {
+                time = root;
+                csrVec3MulVal(&edge, f, &contact);
+                csrVec3Add   (&pPolygon->m_Vertex[i], &contact, &contact);
+                found = 1;
+            }
+        }
+    }
+
+    if (!found)
+        return 0;
+
+    // calculate the sphere position at the impact, and the contact normal
+    csrVec3MulVal(pMotion, time, &center);
+    csrVec3Add   (&pSphere->m_Center, &center, &center);
+    csrVec3Sub   (&center, &contact, &edge);
+    csrVec3Normalize(&edge, &n);
+
+    pHit->m_Time    = time;
+    pHit->m_Pos     = center;
+    pHit->m_Point   = contact;
+    pHit->m_Normal  = n;
+    pHit->m_Polygon = *pPolygon;
+    csrPlaneFromPointNormal(&contact, &n, &pHit->m_SlidingPlane);
+
+    return 1;
+}
+//---------------------------------------------------------------------------
+int csrSweptSphereAABBTree(const CSR_Sphere*         pSphere,
+                           const CSR_Vector3*        pMotion,
+                           const CSR_AABBNode*       pTree,
+                                 CSR_SweptSphereHit* pHit)
+{
+    int found = 0;
+
+    // validate the inputs
+    if (!pSphere || !pMotion || !pTree || !pHit)
+        return 0;
+
+    csrSweptSphereAABBTreeNode(pSphere, pMotion, pTree, &found, pHit);
+
+    return found;
+}
+//---------------------------------------------------------------------------
 // Ground collision functions
 //---------------------------------------------------------------------------
 int csrGroundCollision(const CSR_Sphere*   pSphere,
@@ -519,17 +894,8 @@ int csrGroundCollision(const CSR_Sphere*   pSphere,
                        const CSR_Vector3*  pGroundDir,
                              CSR_Vector3*  pR)
 {
-    #ifdef _MSC_VER
-        CSR_Ray3    ray;
-        CSR_Vector3 groundDir;
-        CSR_Figure3 rayToCheck     = {0};
-        CSR_Figure3 polygonToCheck = {0};
-    #else
-        CSR_Ray3    ray;
-        CSR_Vector3 groundDir;
-        CSR_Figure3 rayToCheck;
-        CSR_Figure3 polygonToCheck;
-    #endif
+    CSR_Ray3    ray;
+    CSR_Vector3 groundDir;
 
     // validate the inputs
     if (!pSphere || !pPolygon)
@@ -548,16 +914,8 @@ int csrGroundCollision(const CSR_Sphere*   pSphere,
     // create the ground ray
     csrRay3FromPointDir(&pSphere->m_Center, &groundDir, &ray);
 
-    // build the ray figure to check
-    rayToCheck.m_Type    =  CSR_F3_Ray;
-    rayToCheck.m_pFigure = &ray;
-
-    // build the polygon figure to check against
-    polygonToCheck.m_Type    = CSR_F3_Polygon;
-    polygonToCheck.m_pFigure = pPolygon;
-
     // calculate the point where the ground ray hit the polygon
-    if (!csrIntersect3(&rayToCheck, &polygonToCheck, pR, 0, 0))
+    if (!csrIntersect3RayPolygon(&ray, pPolygon, pR, 0))
         return 0;
 
     // consider the sphere radius in the result
@@ -578,9 +936,13 @@ int csrGroundPosY(const CSR_Sphere*   pBoundingSphere,
                         float*        pR)
 {
     size_t             i;
+    size_t             j;
+    size_t             count;
+    int                hits;
     CSR_Ray3           groundRay;
     CSR_Vector3        groundPos;
     CSR_Polygon3Buffer polygonBuffer;
+    CSR_Polygon3Packet packet;
     int                result;
 
     // validate the inputs
@@ -598,18 +960,40 @@ int csrGroundPosY(const CSR_Sphere*   pBoundingSphere,
     // initialize the ground position from the bounding sphere center
     groundPos = pBoundingSphere->m_Center;
 
-    // iterate through polygons to check
-    for (i = 0; i < polygonBuffer.m_Count; ++i)
-        // check if a ground polygon was found, calculate the ground position if yes
-        if (csrGroundCollision(pBoundingSphere, &polygonBuffer.m_pPolygon[i], pGroundDir, &groundPos))
-        {
-            // copy the ground polygon, if required
-            if (pGroundPolygon)
-                *pGroundPolygon = polygonBuffer.m_pPolygon[i];
+    // clear the packet, its unused slots should contain no garbage values
+    memset(&packet, 0, sizeof(CSR_Polygon3Packet));
 
-            result = 1;
-            break;
-        }
+    // iterate through polygons to check, by packets
+    for (i = 0; i < polygonBuffer.m_Count && !result; i += M_CSR_Packet_Size)
+    {
+        count = polygonBuffer.m_Count - i;
+
+        if (count > M_CSR_Packet_Size)
+            count = M_CSR_Packet_Size;
+
+        for (j = 0; j < count; ++j)
+            csrPolygon3PacketSet(&polygonBuffer.m_pPolygon[i + j], j, &packet);
+
+        // find which polygons the ground ray hits
+        hits = csrIntersect3RayPolygonPacket(&groundRay, &packet, count, 0);
+
+        // no ground polygon in this packet?
+        if (!hits)
+            continue;
+
+        // calculate the ground position from the first hit polygon
+        for (j = 0; j < count; ++j)
+            if ((hits & (1 << j)) &&
+                csrGroundCollision(pBoundingSphere, &polygonBuffer.m_pPolygon[i + j], pGroundDir, &groundPos))
+            {
+                // copy the ground polygon, if required
+                if (pGroundPolygon)
+                    *pGroundPolygon = polygonBuffer.m_pPolygon[i + j];
+
+                result = 1;
+                break;
+            }
+    }
 
     // delete found polygons (no longer needed from now)
     if (polygonBuffer.m_Count)
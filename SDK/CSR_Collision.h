@@ -37,6 +37,19 @@ typedef struct CSR_tagAABBNode
            CSR_IndexedPolygonBuffer* m_pPolygonBuffer;
 } CSR_AABBNode;
 
+/**
+* Swept sphere hit, i.e. the first contact found while a sphere moves
+*/
+typedef struct
+{
+    float        m_Time;         // motion part done before the impact, between 0 and 1
+    CSR_Vector3  m_Pos;          // sphere center at the impact
+    CSR_Vector3  m_Point;        // contact point
+    CSR_Vector3  m_Normal;       // contact normal, pointing toward the sphere
+    CSR_Plane    m_SlidingPlane; // plane on which the sphere should slide, see csrSlidingPoint()
+    CSR_Polygon3 m_Polygon;      // hit polygon
+} CSR_SweptSphereHit;
+
 #ifdef __cplusplus
     extern "C"
     {
@@ -104,6 +117,44 @@ typedef struct CSR_tagAABBNode
                                    float        radius,
                                    CSR_Vector3* pR);
 
+        //-------------------------------------------------------------------
+        // Swept sphere functions
+        //-------------------------------------------------------------------
+
+        /**
+        * Finds the first contact between a moving sphere and a polygon
+        *@param pSphere - sphere at its start position
+        *@param pMotion - sphere motion, the sphere moves from its center to its center + motion
+        *@param pPolygon - polygon to check
+        *@param maxTime - motion part beyond which the hits are ignored, between 0 and 1
+        *@param[out] pHit - hit, unchanged if no hit was found
+        *@return 1 if the sphere hits the polygon before maxTime, otherwise 0
+        *@note The polygon is two-sided. A sphere already intersecting the polygon hits it at the
+        *      time 0, unless it moves away from it
+        */
+        int csrSweptSpherePolygon(const CSR_Sphere*         pSphere,
+                                  const CSR_Vector3*        pMotion,
+                                  const CSR_Polygon3*       pPolygon,
+                                        float               maxTime,
+                                        CSR_SweptSphereHit* pHit);
+
+        /**
+        * Finds the first polygon hit by a moving sphere in an AABB tree
+        *@param pSphere - sphere at its start position
+        *@param pMotion - sphere motion, the sphere moves from its center to its center + motion
+        *@param pTree - model aligned-axis bounding box tree
+        *@param[out] pHit - nearest hit, unchanged if no hit was found
+        *@return 1 if the sphere hits a polygon, otherwise 0
+        *@note The whole motion is checked in a single query, thus a fast sphere cannot tunnel
+        *      through a thin polygon
+        *@note The sphere and the motion should be in the same coordinate system as the model. This
+        *      means that any transformation should be applied to them before calling this function
+        */
+        int csrSweptSphereAABBTree(const CSR_Sphere*         pSphere,
+                                   const CSR_Vector3*        pMotion,
+                                   const CSR_AABBNode*       pTree,
+                                         CSR_SweptSphereHit* pHit);
+
         //-------------------------------------------------------------------
         // Ground collision functions
         //-------------------------------------------------------------------
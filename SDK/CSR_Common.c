@@ -21,6 +21,23 @@
 #include <memory.h>
 #include <math.h>
 
+// memory mapped files
+#ifdef _WIN32
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #include <Windows.h>
+#else
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+
+    #ifndef MAP_ANONYMOUS
+        #define MAP_ANONYMOUS MAP_ANON
+    #endif
+#endif
+
 //---------------------------------------------------------------------------
 // Memory functions
 //---------------------------------------------------------------------------
@@ -381,6 +398,55 @@ void csrArrayDeleteAt(size_t index, CSR_Array* pArray)
     --pArray->m_Count;
 }
 //---------------------------------------------------------------------------
+// Buffer private functions
+//---------------------------------------------------------------------------
+size_t csrBufferGetPageSize(void)
+{
+    #ifdef _WIN32
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        return info.dwPageSize;
+    #else
+        const long pageSize = sysconf(_SC_PAGESIZE);
+        return pageSize > 0 ? (size_t)pageSize : 4096;
+    #endif
+}
+//---------------------------------------------------------------------------
+void csrBufferReleaseData(CSR_Buffer* pBuffer)
+{
+    #ifndef _WIN32
+        size_t pageSize;
+    #endif
+
+    // no data to release?
+    if (!pBuffer->m_pData)
+        return;
+
+    switch (pBuffer->m_Ownership)
+    {
+        case CSR_BO_Owner:
+            free(pBuffer->m_pData);
+            break;
+
+        case CSR_BO_Mapped:
+            #ifdef _WIN32
+                UnmapViewOfFile(pBuffer->m_pData);
+            #else
+                // unmap the file pages and the zero page terminating them, see csrFileMap()
+                pageSize = csrBufferGetPageSize();
+                munmap(pBuffer->m_pData, ((pBuffer->m_Length + pageSize) / pageSize) * pageSize);
+            #endif
+            break;
+
+        default:
+            break;
+    }
+
+    pBuffer->m_pData     = 0;
+    pBuffer->m_Length    = 0;
+    pBuffer->m_Ownership = CSR_BO_Owner;
+}
+//---------------------------------------------------------------------------
 // Buffer functions
 //---------------------------------------------------------------------------
 CSR_Buffer* csrBufferCreate(void)
@@ -405,8 +471,7 @@ void csrBufferRelease(CSR_Buffer* pBuffer)
         return;
 
     // free the buffer content
-    if (pBuffer->m_pData)
-        free(pBuffer->m_pData);
+    csrBufferReleaseData(pBuffer);
 
     // free the buffer
     free(pBuffer);
@@ -419,8 +484,9 @@ void csrBufferInit(CSR_Buffer* pBuffer)
         return;
 
     // initialize the buffer content
-    pBuffer->m_pData  = 0;
-    pBuffer->m_Length = 0;
+    pBuffer->m_pData     = 0;
+    pBuffer->m_Length    = 0;
+    pBuffer->m_Ownership = CSR_BO_Owner;
 }
 //---------------------------------------------------------------------------
 int csrBufferRead(const CSR_Buffer* pBuffer,
@@ -483,6 +549,23 @@ int csrBufferWrite(CSR_Buffer* pBuffer,
     offset        = pBuffer->m_Length;
     lengthToWrite = (length * count);
 
+    // buffer doesn't own its data? Copy it, as it cannot be reallocated
+    if (pBuffer->m_pData && pBuffer->m_Ownership != CSR_BO_Owner)
+    {
+        pNewData = malloc(pBuffer->m_Length);
+
+        // succeeded?
+        if (!pNewData)
+            return 0;
+
+        memcpy(pNewData, pBuffer->m_pData, pBuffer->m_Length);
+
+        // release the previous data, and take the ownership of the copy
+        csrBufferReleaseData(pBuffer);
+        pBuffer->m_pData  = pNewData;
+        pBuffer->m_Length = offset;
+    }
+
     // extend the buffer memory to include the new data
     pNewData = csrMemoryAlloc(pBuffer->m_pData, pBuffer->m_Length + lengthToWrite, 1);
 
@@ -601,6 +684,129 @@ CSR_Buffer* csrFileOpen(const char* pFileName)
     return pBuffer;
 }
 //---------------------------------------------------------------------------
+CSR_Buffer* csrFileMap(const char* pFileName)
+{
+    CSR_Buffer* pBuffer;
+    size_t      length;
+    size_t      pageSize;
+    void*       pData;
+
+    #ifdef _WIN32
+        HANDLE         hFile;
+        HANDLE         hMapping;
+        LARGE_INTEGER  fileSize;
+    #else
+        int            file;
+        struct stat    fileInfo;
+        size_t         mapLength;
+        void*          pReserved;
+    #endif
+
+    if (!pFileName)
+        return 0;
+
+    pageSize = csrBufferGetPageSize();
+
+    #ifdef _WIN32
+        // open the file
+        hFile = CreateFileA(pFileName,
+                            GENERIC_READ,
+                            FILE_SHARE_READ,
+                            0,
+                            OPEN_EXISTING,
+                            FILE_ATTRIBUTE_NORMAL,
+                            0);
+
+        // succeeded?
+        if (hFile == INVALID_HANDLE_VALUE)
+            return csrFileOpen(pFileName);
+
+        // get the file size. The zero terminating the content is only guaranteed if the last page
+        // isn't full, otherwise the file is read
+        if (!GetFileSizeEx(hFile, &fileSize) || fileSize.QuadPart <= 0 ||
+            (LONGLONG)(size_t)fileSize.QuadPart != fileSize.QuadPart || !((size_t)fileSize.QuadPart % pageSize))
+        {
+            CloseHandle(hFile);
+            return csrFileOpen(pFileName);
+        }
+
+        length = (size_t)fileSize.QuadPart;
+
+        // map the file as copy on write. NOTE the handles may be closed, the view keeps them alive
+        hMapping = CreateFileMappingA(hFile, 0, PAGE_WRITECOPY, 0, 0, 0);
+        pData    = hMapping ? MapViewOfFile(hMapping, FILE_MAP_COPY, 0, 0, 0) : 0;
+
+        if (hMapping)
+            CloseHandle(hMapping);
+
+        CloseHandle(hFile);
+
+        // succeeded?
+        if (!pData)
+            return csrFileOpen(pFileName);
+    #else
+        // open the file
+        file = open(pFileName, O_RDONLY);
+
+        // succeeded?
+        if (file < 0)
+            return csrFileOpen(pFileName);
+
+        // get the file size
+        if (fstat(file, &fileInfo) || fileInfo.st_size <= 0)
+        {
+            close(file);
+            return csrFileOpen(pFileName);
+        }
+
+        length = (size_t)fileInfo.st_size;
+
+        // reserve the file pages, plus at least one zero byte to terminate the content
+        mapLength = ((length + pageSize) / pageSize) * pageSize;
+        pReserved = mmap(0, mapLength, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+        if (pReserved == MAP_FAILED)
+        {
+            close(file);
+            return csrFileOpen(pFileName);
+        }
+
+        // map the file over the reserved pages, as copy on write
+        pData = mmap(pReserved, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, file, 0);
+
+        // the mapping remains valid after the file is closed
+        close(file);
+
+        // succeeded?
+        if (pData == MAP_FAILED)
+        {
+            munmap(pReserved, mapLength);
+            return csrFileOpen(pFileName);
+        }
+    #endif
+
+    // create a new buffer
+    pBuffer = csrBufferCreate();
+
+    // succeeded?
+    if (!pBuffer)
+    {
+        #ifdef _WIN32
+            UnmapViewOfFile(pData);
+        #else
+            munmap(pReserved, mapLength);
+        #endif
+
+        return 0;
+    }
+
+    pBuffer->m_pData     = pData;
+    pBuffer->m_Length    = length;
+    pBuffer->m_Ownership = CSR_BO_Mapped;
+
+    return pBuffer;
+}
+//---------------------------------------------------------------------------
 int csrFileSave(const char* pFileName, const CSR_Buffer* pBuffer)
 {
     FILE*  pFile;
@@ -622,7 +828,7 @@ int csrFileSave(const char* pFileName, const CSR_Buffer* pBuffer)
         return 0;
 
     // write the buffer content
-    bytesWritten = fwrite(pBuffer->m_pData, pBuffer->m_Length, 1, pFile);
+    bytesWritten = fwrite(pBuffer->m_pData, 1, pBuffer->m_Length, pFile);
 
     // close the file
     fclose(pFile);
@@ -47,6 +47,16 @@ typedef enum
     CSR_E_BigEndian,
 } CSR_EEndianness;
 
+/**
+* Buffer data ownership
+*/
+typedef enum
+{
+    CSR_BO_Owner = 0, // the buffer owns its data, which is freed on release
+    CSR_BO_Mapped,    // the buffer data is a file mapped in memory, which is unmapped on release
+    CSR_BO_Borrowed   // the buffer data belongs to another object, and is never released by the buffer
+} CSR_EBufferOwnership;
+
 //---------------------------------------------------------------------------
 // Structures
 //---------------------------------------------------------------------------
@@ -86,8 +96,9 @@ typedef struct
 */
 typedef struct
 {
-    void*  m_pData;
-    size_t m_Length;
+    void*                m_pData;
+    size_t               m_Length;
+    CSR_EBufferOwnership m_Ownership;
 } CSR_Buffer;
 
 #ifdef __cplusplus
@@ -311,6 +322,7 @@ typedef struct
         /**
         * Releases a buffer and frees its memory
         *@param[in, out] pBuffer - buffer to release
+        *@note The buffer data is freed, unmapped or kept, depending on the buffer ownership
         */
         void csrBufferRelease(CSR_Buffer* pBuffer);
 
@@ -368,6 +380,17 @@ typedef struct
         */
         CSR_Buffer* csrFileOpen(const char* pFileName);
 
+        /**
+        * Maps a file in memory
+        *@param pFileName - file name
+        *@return a buffer containing the file content, 0 on error
+        *@note The buffer must be released when no longer used, see csrBufferRelease()
+        *@note The file is read as with csrFileOpen() if it cannot be mapped. In both cases the
+        *      content is followed by a zero, not included in the buffer length, and may be modified
+        *      without changing the file
+        */
+        CSR_Buffer* csrFileMap(const char* pFileName);
+
         /**
         * Saves a buffer content inside a file
         *@param pFileName - file name
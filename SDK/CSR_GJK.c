@@ -18,12 +18,36 @@
 
 // std
 #include <stdlib.h>
+#include <math.h>
 
 #define GJK_MAX_NUM_ITERATIONS  64
 #define EPA_TOLERANCE           0.0001f
-#define EPA_MAX_NUM_FACES       64
-#define EPA_MAX_NUM_LOOSE_EDGES 32
+#define EPA_MAX_NUM_FACES       256
+#define EPA_MAX_NUM_LOOSE_EDGES 128
 #define EPA_MAX_NUM_ITERATIONS  64
+#define HULL_TOLERANCE          0.00001f
+
+//---------------------------------------------------------------------------
+// Private structures
+//---------------------------------------------------------------------------
+
+/**
+* Convex hull face, used while the hull is built
+*/
+typedef struct
+{
+    size_t      m_V[3];
+    CSR_Vector3 m_Normal;
+    float       m_Dist;
+} CSR_ConvexHullFace;
+
+/**
+* Convex hull edge, used while the hull is built
+*/
+typedef struct
+{
+    size_t m_V[2];
+} CSR_ConvexHullEdge;
 
 //---------------------------------------------------------------------------
 // Support functions
@@ -141,6 +165,65 @@ void csrGJKSupportCapsule(const CSR_Collider* pCollider, const CSR_Vector3* pDir
     csrVec3Add      ( pR,                 &pCollider->m_Pos, pR);
 }
 //---------------------------------------------------------------------------
+void csrGJKSupportConvexHull(const CSR_Collider* pCollider, const CSR_Vector3* pDir, CSR_Vector3* pR)
+{
+    #ifdef _MSC_VER
+        CSR_Vector3 invDir = {0};
+    #else
+        CSR_Vector3 invDir;
+    #endif
+    CSR_ConvexHull* pHull = pCollider->m_pHull;
+    size_t          index;
+    size_t          next;
+    size_t          i;
+    float           maxDot;
+    float           dot;
+
+    // no hull?
+    if (!pHull || !pHull->m_Count)
+    {
+        *pR = pCollider->m_Pos;
+        return;
+    }
+
+    // find support in model space
+    csrMat4Transform(&pCollider->m_InvMatRS, pDir, &invDir);
+
+    // start from the previous support vertex, which is generally close to the new one
+    index = pHull->m_Hint < pHull->m_Count ? pHull->m_Hint : 0;
+    csrVec3Dot(&pHull->m_pVertex[index], &invDir, &maxDot);
+
+    // climb to the furthest neighbor, until no neighbor is further. NOTE on a convex hull the
+    // first local maximum is also the global one
+    do
+    {
+        next = index;
+
+        for (i = pHull->m_pNeighborStart[index]; i < pHull->m_pNeighborStart[index + 1]; ++i)
+        {
+            csrVec3Dot(&pHull->m_pVertex[pHull->m_pNeighbor[i]], &invDir, &dot);
+
+            if (dot > maxDot)
+            {
+                maxDot = dot;
+                next   = pHull->m_pNeighbor[i];
+            }
+        }
+
+        if (next == index)
+            break;
+
+        index = next;
+    }
+    while (1);
+
+    pHull->m_Hint = index;
+
+    // convert support to world space
+    csrMat4Transform(&pCollider->m_MatRS, &pHull->m_pVertex[index], pR);
+    csrVec3Add      ( pR,                 &pCollider->m_Pos,        pR);
+}
+//---------------------------------------------------------------------------
 // Collider functions
 //---------------------------------------------------------------------------
 CSR_Collider* csrColliderCreate(void)
@@ -188,6 +271,7 @@ void csrColliderInit(CSR_Collider* pCollider)
     pCollider->m_TopY       = 0.0f;
     pCollider->m_BottomY    = 0.0f;
     pCollider->m_Radius     = 0.0f;
+    pCollider->m_pHull      = 0;
     pCollider->m_fOnSupport = 0;
 
     // initialize the matrices
@@ -231,8 +315,492 @@ void csrColliderSetRS(const CSR_Matrix4* pMat, CSR_Collider* pCollider)
     csrMat4Inverse(&pCollider->m_MatRS, &pCollider->m_InvMatRS, &determinant);
 }
 //---------------------------------------------------------------------------
+// Convex hull private functions
+//---------------------------------------------------------------------------
+int csrConvexHullReserve(void** ppData, size_t itemSize, size_t count, size_t* pCapacity)
+{
+    void*  pData;
+    size_t capacity;
+
+    // enough place?
+    if (count <= *pCapacity)
+        return 1;
+
+    // grow the array geometrically, to keep the additions in an amortized constant time
+    capacity = *pCapacity ? *pCapacity * 2 : 32;
+
+    if (capacity < count)
+        capacity = count;
+
+    pData = csrMemoryAlloc(*ppData, itemSize, capacity);
+
+    // succeeded?
+    if (!pData)
+        return 0;
+
+    *ppData    = pData;
+    *pCapacity = capacity;
+
+    return 1;
+}
+//---------------------------------------------------------------------------
+void csrConvexHullBuildFace(const CSR_Vector3*        pPoints,
+                                  size_t              a,
+                                  size_t              b,
+                                  size_t              c,
+                                  CSR_ConvexHullFace* pFace)
+{
+    #ifdef _MSC_VER
+        CSR_Vector3 sub1  = {0};
+        CSR_Vector3 sub2  = {0};
+        CSR_Vector3 cross = {0};
+    #else
+        CSR_Vector3 sub1;
+        CSR_Vector3 sub2;
+        CSR_Vector3 cross;
+    #endif
+
+    pFace->m_V[0] = a;
+    pFace->m_V[1] = b;
+    pFace->m_V[2] = c;
+
+    // calculate the face plane, the normal points outside for a counterclockwise face
+    csrVec3Sub      (&pPoints[b], &pPoints[a], &sub1);
+    csrVec3Sub      (&pPoints[c], &pPoints[a], &sub2);
+    csrVec3Cross    (&sub1,       &sub2,       &cross);
+    csrVec3Normalize(&cross,      &pFace->m_Normal);
+    csrVec3Dot      (&pFace->m_Normal, &pPoints[a], &pFace->m_Dist);
+}
+//---------------------------------------------------------------------------
+int csrConvexHullFindTetrahedron(const CSR_Vector3* pPoints,
+                                       size_t       count,
+                                       float        tolerance,
+                                       size_t*      pIndex)
+{
+    #ifdef _MSC_VER
+        CSR_Vector3 dir   = {0};
+        CSR_Vector3 sub   = {0};
+        CSR_Vector3 cross = {0};
+        CSR_Vector3 n     = {0};
+    #else
+        CSR_Vector3 dir;
+        CSR_Vector3 sub;
+        CSR_Vector3 cross;
+        CSR_Vector3 n;
+    #endif
+    size_t extreme[6] = {0};
+    size_t i;
+    size_t j;
+    float  dist;
+    float  maxDist;
+
+    // find the extreme points on each axis
+    for (i = 1; i < count; ++i)
+    {
+        if (pPoints[i].m_X < pPoints[extreme[0]].m_X) extreme[0] = i;
+        if (pPoints[i].m_X > pPoints[extreme[1]].m_X) extreme[1] = i;
+        if (pPoints[i].m_Y < pPoints[extreme[2]].m_Y) extreme[2] = i;
+        if (pPoints[i].m_Y > pPoints[extreme[3]].m_Y) extreme[3] = i;
+        if (pPoints[i].m_Z < pPoints[extreme[4]].m_Z) extreme[4] = i;
+        if (pPoints[i].m_Z > pPoints[extreme[5]].m_Z) extreme[5] = i;
+    }
+
+    maxDist = -1.0f;
+
+    // the first edge is the longest one between the extreme points
+    for (i = 0; i < 6; ++i)
+        for (j = i + 1; j < 6; ++j)
+        {
+            csrVec3Sub   (&pPoints[extreme[j]], &pPoints[extreme[i]], &sub);
+            csrVec3Length(&sub, &dist);
+
+            if (dist > maxDist)
+            {
+                maxDist   = dist;
+                pIndex[0] = extreme[i];
+                pIndex[1] = extreme[j];
+            }
+        }
+
+    // all the points are merged?
+    if (maxDist <= tolerance)
+        return 0;
+
+    csrVec3Sub      (&pPoints[pIndex[1]], &pPoints[pIndex[0]], &sub);
+    csrVec3Normalize(&sub, &dir);
+
+    maxDist = -1.0f;
+
+    // the third point is the furthest from the first edge
+    for (i = 0; i < count; ++i)
+    {
+        csrVec3Sub   (&pPoints[i], &pPoints[pIndex[0]], &sub);
+        csrVec3Cross (&sub,        &dir,                &cross);
+        csrVec3Length(&cross, &dist);
+
+        if (dist > maxDist)
+        {
+            maxDist   = dist;
+            pIndex[2] = i;
+        }
+    }
+
+    // all the points are aligned?
+    if (maxDist <= tolerance)
+        return 0;
+
+    csrVec3Sub      (&pPoints[pIndex[2]], &pPoints[pIndex[0]], &sub);
+    csrVec3Cross    (&dir,   &sub, &cross);
+    csrVec3Normalize(&cross, &n);
+
+    maxDist = -1.0f;
+
+    // the fourth point is the furthest from the first face
+    for (i = 0; i < count; ++i)
+    {
+        csrVec3Sub(&pPoints[i], &pPoints[pIndex[0]], &sub);
+        csrVec3Dot(&sub,        &n,                  &dist);
+
+        dist = (float)fabs(dist);
+
+        if (dist > maxDist)
+        {
+            maxDist   = dist;
+            pIndex[3] = i;
+        }
+    }
+
+    // all the points are on the same plane?
+    return maxDist > tolerance;
+}
+//---------------------------------------------------------------------------
+int csrConvexHullAddEdge(CSR_ConvexHullEdge** ppEdge,
+                         size_t*              pCount,
+                         size_t*              pCapacity,
+                         size_t               a,
+                         size_t               b)
+{
+    size_t i;
+
+    // the edge is shared with another removed face, which has it in the reversed order? Then it
+    // isn't on the horizon
+    for (i = 0; i < *pCount; ++i)
+        if ((*ppEdge)[i].m_V[0] == b && (*ppEdge)[i].m_V[1] == a)
+        {
+            (*ppEdge)[i] = (*ppEdge)[*pCount - 1];
+            --(*pCount);
+            return 1;
+        }
+
+    if (!csrConvexHullReserve((void**)ppEdge, sizeof(CSR_ConvexHullEdge), *pCount + 1, pCapacity))
+        return 0;
+
+    (*ppEdge)[*pCount].m_V[0] = a;
+    (*ppEdge)[*pCount].m_V[1] = b;
+    ++(*pCount);
+
+    return 1;
+}
+//---------------------------------------------------------------------------
+CSR_ConvexHull* csrConvexHullBuild(const CSR_Vector3*        pPoints,
+                                         size_t              pointCount,
+                                   const CSR_ConvexHullFace* pFace,
+                                         size_t              faceCount)
+{
+    CSR_ConvexHull* pHull;
+    size_t*         pIndex;
+    size_t*         pFill;
+    size_t          i;
+    size_t          j;
+    size_t          index;
+
+    // create the convex hull
+    pHull = (CSR_ConvexHull*)malloc(sizeof(CSR_ConvexHull));
+
+    // succeeded?
+    if (!pHull)
+        return 0;
+
+    csrConvexHullInit(pHull);
+
+    // map each point index to its hull vertex index
+    pIndex = (size_t*)malloc(pointCount * sizeof(size_t));
+
+    // succeeded?
+    if (!pIndex)
+    {
+        csrConvexHullRelease(pHull);
+        return 0;
+    }
+
+    for (i = 0; i < pointCount; ++i)
+        pIndex[i] = pointCount;
+
+    for (i = 0; i < faceCount; ++i)
+        for (j = 0; j < 3; ++j)
+            if (pIndex[pFace[i].m_V[j]] == pointCount)
+                pIndex[pFace[i].m_V[j]] = pHull->m_Count++;
+
+    pHull->m_pVertex        = (CSR_Vector3*)malloc(pHull->m_Count * sizeof(CSR_Vector3));
+    pHull->m_pNeighborStart = (size_t*)calloc(pHull->m_Count + 1, sizeof(size_t));
+    pHull->m_pNeighbor      = (size_t*)malloc(faceCount * 3 * sizeof(size_t));
+    pFill                   = (size_t*)malloc(pHull->m_Count * sizeof(size_t));
+
+    // succeeded?
+    if (!pHull->m_pVertex || !pHull->m_pNeighborStart || !pHull->m_pNeighbor || !pFill)
+    {
+        free(pFill);
+        free(pIndex);
+        csrConvexHullRelease(pHull);
+        return 0;
+    }
+
+    for (i = 0; i < pointCount; ++i)
+        if (pIndex[i] != pointCount)
+            pHull->m_pVertex[pIndex[i]] = pPoints[i];
+
+    // each edge belongs to 2 faces, once in each direction, thus each vertex neighbor is found
+    // exactly once by iterating the face edges
+    for (i = 0; i < faceCount; ++i)
+        for (j = 0; j < 3; ++j)
+            ++pHull->m_pNeighborStart[pIndex[pFace[i].m_V[j]] + 1];
+
+    for (i = 0; i < pHull->m_Count; ++i)
+    {
+        pHull->m_pNeighborStart[i + 1] += pHull->m_pNeighborStart[i];
+        pFill[i]                        = pHull->m_pNeighborStart[i];
+    }
+
+    for (i = 0; i < faceCount; ++i)
+        for (j = 0; j < 3; ++j)
+        {
+            index                           = pIndex[pFace[i].m_V[j]];
+            pHull->m_pNeighbor[pFill[index]] = pIndex[pFace[i].m_V[(j + 1) % 3]];
+            ++pFill[index];
+        }
+
+    free(pFill);
+    free(pIndex);
+
+    return pHull;
+}
+//---------------------------------------------------------------------------
+// Convex hull functions
+//---------------------------------------------------------------------------
+CSR_ConvexHull* csrConvexHullCreate(const CSR_Vector3* pPoints, size_t count)
+{
+    #ifdef _MSC_VER
+        CSR_Vector3 center = {0};
+    #else
+        CSR_Vector3 center;
+    #endif
+    CSR_ConvexHull*     pHull;
+    CSR_ConvexHullFace* pFace        = 0;
+    CSR_ConvexHullEdge* pEdge        = 0;
+    size_t              faceCount    = 0;
+    size_t              faceCapacity = 0;
+    size_t              edgeCount    = 0;
+    size_t              edgeCapacity = 0;
+    size_t              first[4];
+    size_t              i;
+    size_t              j;
+    size_t              k;
+    size_t              swap;
+    float               tolerance;
+    float               dist;
+    float               extent;
+    int                 success;
+
+    // a volume requires at least 4 points
+    if (!pPoints || count < 4)
+        return 0;
+
+    extent = 0.0f;
+
+    // the tolerance depends on the point cloud size
+    for (i = 0; i < count; ++i)
+    {
+        if ((float)fabs(pPoints[i].m_X) > extent) extent = (float)fabs(pPoints[i].m_X);
+        if ((float)fabs(pPoints[i].m_Y) > extent) extent = (float)fabs(pPoints[i].m_Y);
+        if ((float)fabs(pPoints[i].m_Z) > extent) extent = (float)fabs(pPoints[i].m_Z);
+    }
+
+    tolerance = extent * HULL_TOLERANCE;
+
+    // find a first tetrahedron, as large as possible
+    if (!csrConvexHullFindTetrahedron(pPoints, count, tolerance, first))
+        return 0;
+
+    if (!csrConvexHullReserve((void**)&pFace, sizeof(CSR_ConvexHullFace), 4, &faceCapacity))
+        return 0;
+
+    csrConvexHullBuildFace(pPoints, first[0], first[1], first[2], &pFace[0]);
+    csrConvexHullBuildFace(pPoints, first[0], first[2], first[3], &pFace[1]);
+    csrConvexHullBuildFace(pPoints, first[0], first[3], first[1], &pFace[2]);
+    csrConvexHullBuildFace(pPoints, first[1], first[3], first[2], &pFace[3]);
+    faceCount = 4;
+
+    center.m_X = (pPoints[first[0]].m_X + pPoints[first[1]].m_X + pPoints[first[2]].m_X + pPoints[first[3]].m_X) * 0.25f;
+    center.m_Y = (pPoints[first[0]].m_Y + pPoints[first[1]].m_Y + pPoints[first[2]].m_Y + pPoints[first[3]].m_Y) * 0.25f;
+    center.m_Z = (pPoints[first[0]].m_Z + pPoints[first[1]].m_Z + pPoints[first[2]].m_Z + pPoints[first[3]].m_Z) * 0.25f;
+
+    // orient the faces outside
+    for (i = 0; i < 4; ++i)
+    {
+        csrVec3Dot(&pFace[i].m_Normal, &center, &dist);
+
+        if (dist > pFace[i].m_Dist)
+        {
+            swap = pFace[i].m_V[1];
+            csrConvexHullBuildFace(pPoints, pFace[i].m_V[0], pFace[i].m_V[2], swap, &pFace[i]);
+        }
+    }
+
+    success = 1;
+
+    // add the points one by one
+    for (i = 0; i < count && success; ++i)
+    {
+        edgeCount = 0;
+
+        // remove the faces seen by the point, and keep their horizon edges
+        for (j = 0; j < faceCount && success; ++j)
+        {
+            csrVec3Dot(&pFace[j].m_Normal, &pPoints[i], &dist);
+
+            // point below the face, or on its plane?
+            if (dist - pFace[j].m_Dist <= tolerance)
+                continue;
+
+            for (k = 0; k < 3 && success; ++k)
+                success = csrConvexHullAddEdge(&pEdge,
+                                               &edgeCount,
+                                               &edgeCapacity,
+                                                pFace[j].m_V[k],
+                                                pFace[j].m_V[(k + 1) % 3]);
+
+            pFace[j] = pFace[faceCount - 1];
+            --faceCount;
+            --j;
+        }
+
+        // close the hole with the faces joining the horizon to the point
+        for (j = 0; j < edgeCount && success; ++j)
+        {
+            success = csrConvexHullReserve((void**)&pFace, sizeof(CSR_ConvexHullFace), faceCount + 1, &faceCapacity);
+
+            if (!success)
+                break;
+
+            csrConvexHullBuildFace(pPoints, pEdge[j].m_V[0], pEdge[j].m_V[1], i, &pFace[faceCount]);
+            ++faceCount;
+        }
+    }
+
+    pHull = success ? csrConvexHullBuild(pPoints, count, pFace, faceCount) : 0;
+
+    free(pEdge);
+    free(pFace);
+
+    return pHull;
+}
+//---------------------------------------------------------------------------
+CSR_ConvexHull* csrConvexHullCreateFromMesh(const CSR_Mesh* pMesh)
+{
+    CSR_ConvexHull* pHull;
+    CSR_Vector3*    pPoints;
+    size_t          count;
+    size_t          i;
+    size_t          j;
+    size_t          stride;
+
+    // validate the input
+    if (!pMesh)
+        return 0;
+
+    count = 0;
+
+    // count the mesh vertices
+    for (i = 0; i < pMesh->m_Count; ++i)
+        if (pMesh->m_pVB[i].m_Format.m_Stride)
+            count += pMesh->m_pVB[i].m_Count / pMesh->m_pVB[i].m_Format.m_Stride;
+
+    if (count < 4)
+        return 0;
+
+    pPoints = (CSR_Vector3*)malloc(count * sizeof(CSR_Vector3));
+
+    // succeeded?
+    if (!pPoints)
+        return 0;
+
+    count = 0;
+
+    // get the vertex positions, which are always the first vertex values
+    for (i = 0; i < pMesh->m_Count; ++i)
+    {
+        stride = pMesh->m_pVB[i].m_Format.m_Stride;
+
+        if (!stride)
+            continue;
+
+        for (j = 0; j + stride <= pMesh->m_pVB[i].m_Count; j += stride)
+        {
+            pPoints[count].m_X = pMesh->m_pVB[i].m_pData[j];
+            pPoints[count].m_Y = pMesh->m_pVB[i].m_pData[j + 1];
+            pPoints[count].m_Z = pMesh->m_pVB[i].m_pData[j + 2];
+            ++count;
+        }
+    }
+
+    pHull = csrConvexHullCreate(pPoints, count);
+
+    free(pPoints);
+
+    return pHull;
+}
+//---------------------------------------------------------------------------
+void csrConvexHullRelease(CSR_ConvexHull* pHull)
+{
+    // no convex hull to release?
+    if (!pHull)
+        return;
+
+    // free the hull content
+    free(pHull->m_pVertex);
+    free(pHull->m_pNeighborStart);
+    free(pHull->m_pNeighbor);
+
+    // free the convex hull
+    free(pHull);
+}
+//---------------------------------------------------------------------------
+void csrConvexHullInit(CSR_ConvexHull* pHull)
+{
+    // no convex hull to initialize?
+    if (!pHull)
+        return;
+
+    // initialize the convex hull
+    pHull->m_pVertex        = 0;
+    pHull->m_Count          = 0;
+    pHull->m_pNeighborStart = 0;
+    pHull->m_pNeighbor      = 0;
+    pHull->m_Hint           = 0;
+}
+//---------------------------------------------------------------------------
 // GJK private functions
 //---------------------------------------------------------------------------
+void csrGJKCacheStore(CSR_GJKCache* pCache, const CSR_Vector3* pDir)
+{
+    // no cache?
+    if (!pCache)
+        return;
+
+    pCache->m_Dir   = *pDir;
+    pCache->m_Valid = 1;
+}
+//---------------------------------------------------------------------------
 void csrUpdateSimplex3(CSR_Vector3* pA,
                        CSR_Vector3* pB,
                        CSR_Vector3* pC,
@@ -674,9 +1242,11 @@ void FindMinTranslationVec(const CSR_Vector3*  pA,
     pMTV->m_Z = faces[closestFace][3].m_Z * closestFacesDot;
 }
 //---------------------------------------------------------------------------
-// GJK functions
-//---------------------------------------------------------------------------
-int csrGJKResolve(const CSR_Collider* pC1, const CSR_Collider* pC2, CSR_Vector3* pMTV)
+int csrGJKResolveFromDir(const CSR_Collider* pC1,
+                         const CSR_Collider* pC2,
+                         const CSR_Vector3*  pStartDir,
+                               CSR_GJKCache* pCache,
+                               CSR_Vector3*  pMTV)
 {
     #ifdef _MSC_VER
         CSR_Vector3 searchDir    = {0};
@@ -702,8 +1272,8 @@ int csrGJKResolve(const CSR_Collider* pC1, const CSR_Collider* pC2, CSR_Vector3*
     // simplex, it's just a set of points (a is always most recently added)
     CSR_Vector3 simplex[4] = {0};
 
-    // initial search direction between colliders
-    csrVec3Sub(&pC1->m_Pos, &pC2->m_Pos, &searchDir);
+    // initial search direction
+    searchDir = *pStartDir;
     csrVec3Inverse(&searchDir, &invSearchDir);
 
     // get initial point for simplex
@@ -711,6 +1281,19 @@ int csrGJKResolve(const CSR_Collider* pC1, const CSR_Collider* pC2, CSR_Vector3*
     pC2->m_fOnSupport(pC2, &searchDir,    &c2Support);
     csrVec3Sub(&c2Support, &c1Support, &simplex[2]);
 
+    if (pCache)
+        pCache->m_Iterations = 1;
+
+    csrVec3Dot(&simplex[2], &searchDir, &dotRes);
+
+    // the initial direction is already a separating axis? (generally the case when the direction
+    // found by the previous query is reused)
+    if (dotRes < 0.0f)
+    {
+        csrGJKCacheStore(pCache, &searchDir);
+        return 0;
+    }
+
     // search in direction of origin
     csrVec3Inverse(&simplex[2], &searchDir);
     csrVec3Inverse(&searchDir,  &invSearchDir);
@@ -720,11 +1303,17 @@ int csrGJKResolve(const CSR_Collider* pC1, const CSR_Collider* pC2, CSR_Vector3*
     pC2->m_fOnSupport(pC2, &searchDir,    &c2Support);
     csrVec3Sub(&c2Support, &c1Support, &simplex[1]);
 
+    if (pCache)
+        ++pCache->m_Iterations;
+
     csrVec3Dot(&simplex[1], &searchDir, &dotRes);
 
     // didn't reach the origin, won't enclose it
     if (dotRes < 0.0f)
+    {
+        csrGJKCacheStore(pCache, &searchDir);
         return 0;
+    }
 
     // search perpendicular to line segment towards origin
     csrVec3Inverse(&simplex[1], &invSimplex1);
@@ -775,11 +1364,17 @@ int csrGJKResolve(const CSR_Collider* pC1, const CSR_Collider* pC2, CSR_Vector3*
         pC2->m_fOnSupport(pC2, &searchDir,    &c2Support);
         csrVec3Sub(&c2Support, &c1Support, &simplex[0]);
 
+        if (pCache)
+            ++pCache->m_Iterations;
+
         csrVec3Dot(&simplex[0], &searchDir, &dotRes);
 
         // didn't reach the origin, won't enclose it
         if (dotRes < 0.0f)
+        {
+            csrGJKCacheStore(pCache, &searchDir);
             return 0;
+        }
 
         ++simpDim;
 
@@ -788,6 +1383,9 @@ int csrGJKResolve(const CSR_Collider* pC1, const CSR_Collider* pC2, CSR_Vector3*
         else
         if (csrUpdateSimplex4(&simplex[0], &simplex[1], &simplex[2], &simplex[3], &simpDim, &searchDir))
         {
+            // keep the last search direction, which points toward the origin from the simplex
+            csrGJKCacheStore(pCache, &searchDir);
+
             if (pMTV)
                 FindMinTranslationVec(&simplex[0], &simplex[1], &simplex[2], &simplex[3], pC1, pC2, pMTV);
 
@@ -795,6 +1393,63 @@ int csrGJKResolve(const CSR_Collider* pC1, const CSR_Collider* pC2, CSR_Vector3*
         }
     }
 
+    csrGJKCacheStore(pCache, &searchDir);
     return 0;
 }
 //---------------------------------------------------------------------------
+// GJK functions
+//---------------------------------------------------------------------------
+int csrGJKResolve(const CSR_Collider* pC1, const CSR_Collider* pC2, CSR_Vector3* pMTV)
+{
+    #ifdef _MSC_VER
+        CSR_Vector3 startDir = {0};
+    #else
+        CSR_Vector3 startDir;
+    #endif
+
+    // initial search direction between colliders
+    csrVec3Sub(&pC1->m_Pos, &pC2->m_Pos, &startDir);
+
+    return csrGJKResolveFromDir(pC1, pC2, &startDir, 0, pMTV);
+}
+//---------------------------------------------------------------------------
+int csrGJKResolveCached(const CSR_Collider* pC1,
+                        const CSR_Collider* pC2,
+                              CSR_GJKCache* pCache,
+                              CSR_Vector3*  pMTV)
+{
+    #ifdef _MSC_VER
+        CSR_Vector3 startDir = {0};
+    #else
+        CSR_Vector3 startDir;
+    #endif
+
+    // no cache? Resolve without warm start
+    if (!pCache)
+        return csrGJKResolve(pC1, pC2, pMTV);
+
+    // restart from the direction found by the previous query, if any. NOTE for colliders which
+    // were separated and moved a little, this direction is generally still a separating axis,
+    // and the query ends on the first support point
+    if (pCache->m_Valid && (pCache->m_Dir.m_X != 0.0f || pCache->m_Dir.m_Y != 0.0f || pCache->m_Dir.m_Z != 0.0f))
+        startDir = pCache->m_Dir;
+    else
+        csrVec3Sub(&pC1->m_Pos, &pC2->m_Pos, &startDir);
+
+    return csrGJKResolveFromDir(pC1, pC2, &startDir, pCache, pMTV);
+}
+//---------------------------------------------------------------------------
+void csrGJKCacheInit(CSR_GJKCache* pCache)
+{
+    // no cache to initialize?
+    if (!pCache)
+        return;
+
+    // initialize the cache
+    pCache->m_Dir.m_X    = 0.0f;
+    pCache->m_Dir.m_Y    = 0.0f;
+    pCache->m_Dir.m_Z    = 0.0f;
+    pCache->m_Iterations = 0;
+    pCache->m_Valid      = 0;
+}
+//---------------------------------------------------------------------------
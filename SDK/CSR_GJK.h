@@ -20,6 +20,7 @@
 // compactStar engine
 #include "CSR_Common.h"
 #include "CSR_Geometry.h"
+#include "CSR_Vertex.h"
 
 //---------------------------------------------------------------------------
 // Prototypes
@@ -59,6 +60,30 @@ typedef void (*CSR_fOnSupport)(const CSR_Collider* pCollider,
 // Implementation
 //---------------------------------------------------------------------------
 
+/**
+* Convex hull, used by the convex hull colliders
+*@note The support search climbs from vertex to vertex along the hull edges, starting from the
+*      previous support vertex. Thus a hull should not be used by several threads at once
+*/
+typedef struct
+{
+    CSR_Vector3* m_pVertex;        // hull vertices, in the collider local coordinates
+    size_t       m_Count;          // hull vertex count
+    size_t*      m_pNeighborStart; // first neighbor of each vertex in m_pNeighbor, contains m_Count + 1 items
+    size_t*      m_pNeighbor;      // neighbor vertex indices, i.e. vertices sharing an edge
+    size_t       m_Hint;           // vertex from which the next support search starts
+} CSR_ConvexHull;
+
+/**
+* GJK cache, keeps the result of a collider pair query to start the next one from it
+*/
+typedef struct
+{
+    CSR_Vector3 m_Dir;        // last search direction, e.g. the separating axis if no collision happened
+    size_t      m_Iterations; // support query count of the last resolution, for profiling
+    int         m_Valid;      // 1 if the direction may be used
+} CSR_GJKCache;
+
 /**
 * Collider
 */
@@ -73,6 +98,7 @@ struct CSR_Collider
 	float              m_TopY;       // capsule and cylinder collider, y top position
 	float              m_BottomY;    // capsule and cylinder collider, y bottom position
 	float              m_Radius;     // sphere, capsule and cylinder collider, radius
+    CSR_ConvexHull*    m_pHull;      // convex hull collider, hull to use, not owned by the collider
     CSR_fOnSupport     m_fOnSupport; // support function to use for Minkowski difference
 };
 
@@ -123,6 +149,49 @@ struct CSR_Collider
                                   const CSR_Vector3*  pDir,
                                         CSR_Vector3*  pR);
 
+        /**
+        * Convex hull support function for the Minkowski difference
+        *@param pCollider - collider for which the support function should be called
+        *@param pDir - search direction
+        *@param[out] pR - the furthest vertex belonging to the collider along the direction
+        *@note The collider m_pHull member should point to the hull to use
+        */
+        void csrGJKSupportConvexHull(const CSR_Collider* pCollider,
+                                     const CSR_Vector3*  pDir,
+                                           CSR_Vector3*  pR);
+
+        //-------------------------------------------------------------------
+        // Convex hull functions
+        //-------------------------------------------------------------------
+        /**
+        * Creates a convex hull from a point cloud
+        *@param pPoints - points to surround
+        *@param count - point count
+        *@return newly created convex hull, 0 on error or if the points have no volume
+        *@note The convex hull must be released when no longer used, see csrConvexHullRelease()
+        */
+        CSR_ConvexHull* csrConvexHullCreate(const CSR_Vector3* pPoints, size_t count);
+
+        /**
+        * Creates a convex hull surrounding a mesh
+        *@param pMesh - mesh to surround
+        *@return newly created convex hull, 0 on error or if the mesh has no volume
+        *@note The convex hull must be released when no longer used, see csrConvexHullRelease()
+        */
+        CSR_ConvexHull* csrConvexHullCreateFromMesh(const CSR_Mesh* pMesh);
+
+        /**
+        * Releases a convex hull
+        *@param[in, out] pHull - convex hull to release
+        */
+        void csrConvexHullRelease(CSR_ConvexHull* pHull);
+
+        /**
+        * Initializes a convex hull structure
+        *@param[in, out] pHull - convex hull to initialize
+        */
+        void csrConvexHullInit(CSR_ConvexHull* pHull);
+
         //-------------------------------------------------------------------
         // Collider functions
         //-------------------------------------------------------------------
@@ -172,6 +241,28 @@ struct CSR_Collider
         */
         int csrGJKResolve(const CSR_Collider* pC1, const CSR_Collider* pC2, CSR_Vector3* pMTV);
 
+        /**
+        * Resolves the GJK algorithm, starting from the previous query of the same collider pair
+        *@param pC1 - first collider to compare
+        *@param pC2 - first collider to compare with
+        *@param[in, out] pCache - cache of the collider pair, updated with the query result
+        *@param pMTV - minimum translation vector to apply to the initial movement
+        *@return 1 if a collision happened, otherwise 0
+        *@note If the pair was separated in the previous query and the colliders moved slightly,
+        *      their previous separating axis is generally still valid, and the query ends after
+        *      a single support search
+        */
+        int csrGJKResolveCached(const CSR_Collider* pC1,
+                                const CSR_Collider* pC2,
+                                      CSR_GJKCache* pCache,
+                                      CSR_Vector3*  pMTV);
+
+        /**
+        * Initializes a GJK cache structure
+        *@param[in, out] pCache - GJK cache to initialize
+        */
+        void csrGJKCacheInit(CSR_GJKCache* pCache);
+
 #ifdef __cplusplus
     }
 #endif
@@ -18,6 +18,13 @@
 // std
 #include <math.h>
 
+// SIMD instructions
+#if defined(CSR_USE_SSE)
+    #include <xmmintrin.h>
+#elif defined(CSR_USE_NEON)
+    #include <arm_neon.h>
+#endif
+
 // visual studio specific code
 #ifdef _MSC_VER
     // std
@@ -456,15 +463,79 @@ void csrMat4Scale(const CSR_Vector3* pFactor, CSR_Matrix4* pR)
 //---------------------------------------------------------------------------
 void csrMat4Multiply(const CSR_Matrix4* pM1, const CSR_Matrix4* pM2, CSR_Matrix4* pR)
 {
-    int i;
-    int j;
+    #if defined(CSR_USE_SSE) || defined(CSR_USE_NEON)
+        // each resulting row is a combination of the second matrix rows, which is calculated in
+        // the same order as below, thus the result is identical
+        csrMat4MultiplyArray(pM1, 1, pM2, pR);
+    #else
+        int i;
+        int j;
+
+        for (i = 0; i < 4; ++i)
+            for (j = 0; j < 4; ++j)
+                pR->m_Table[i][j] = pM1->m_Table[i][0] * pM2->m_Table[0][j] +
+                                    pM1->m_Table[i][1] * pM2->m_Table[1][j] +
+                                    pM1->m_Table[i][2] * pM2->m_Table[2][j] +
+                                    pM1->m_Table[i][3] * pM2->m_Table[3][j];
+    #endif
+}
+//---------------------------------------------------------------------------
+void csrMat4MultiplyArray(const CSR_Matrix4* pM,
+                                size_t       count,
+                          const CSR_Matrix4* pM2,
+                                CSR_Matrix4* pR)
+{
+    size_t i;
 
-    for (i = 0; i < 4; ++i)
-        for (j = 0; j < 4; ++j)
-            pR->m_Table[i][j] = pM1->m_Table[i][0] * pM2->m_Table[0][j] +
-                                pM1->m_Table[i][1] * pM2->m_Table[1][j] +
-                                pM1->m_Table[i][2] * pM2->m_Table[2][j] +
-                                pM1->m_Table[i][3] * pM2->m_Table[3][j];
+    #if defined(CSR_USE_SSE)
+        const __m128 row0 = _mm_loadu_ps(pM2->m_Table[0]);
+        const __m128 row1 = _mm_loadu_ps(pM2->m_Table[1]);
+        const __m128 row2 = _mm_loadu_ps(pM2->m_Table[2]);
+        const __m128 row3 = _mm_loadu_ps(pM2->m_Table[3]);
+              __m128 result;
+              size_t j;
+
+        for (i = 0; i < count; ++i)
+            for (j = 0; j < 4; ++j)
+            {
+                // NOTE the row is read before being written, so the matrices may be changed in place
+                result = _mm_mul_ps(_mm_set1_ps(pM[i].m_Table[j][0]), row0);
+                result = _mm_add_ps(result, _mm_mul_ps(_mm_set1_ps(pM[i].m_Table[j][1]), row1));
+                result = _mm_add_ps(result, _mm_mul_ps(_mm_set1_ps(pM[i].m_Table[j][2]), row2));
+                result = _mm_add_ps(result, _mm_mul_ps(_mm_set1_ps(pM[i].m_Table[j][3]), row3));
+
+                _mm_storeu_ps(pR[i].m_Table[j], result);
+            }
+    #elif defined(CSR_USE_NEON)
+        const float32x4_t row0 = vld1q_f32(pM2->m_Table[0]);
+        const float32x4_t row1 = vld1q_f32(pM2->m_Table[1]);
+        const float32x4_t row2 = vld1q_f32(pM2->m_Table[2]);
+        const float32x4_t row3 = vld1q_f32(pM2->m_Table[3]);
+              float32x4_t result;
+              size_t      j;
+
+        for (i = 0; i < count; ++i)
+            for (j = 0; j < 4; ++j)
+            {
+                // NOTE the row is read before being written, so the matrices may be changed in
+                // place. The multiply and add aren't fused, to keep the same result as the C code
+                result = vmulq_n_f32(row0, pM[i].m_Table[j][0]);
+                result = vaddq_f32(result, vmulq_n_f32(row1, pM[i].m_Table[j][1]));
+                result = vaddq_f32(result, vmulq_n_f32(row2, pM[i].m_Table[j][2]));
+                result = vaddq_f32(result, vmulq_n_f32(row3, pM[i].m_Table[j][3]));
+
+                vst1q_f32(pR[i].m_Table[j], result);
+            }
+    #else
+        CSR_Matrix4 matrix;
+
+        // copy the matrix, because the result may be written in place
+        for (i = 0; i < count; ++i)
+        {
+            matrix = pM[i];
+            csrMat4Multiply(&matrix, pM2, &pR[i]);
+        }
+    #endif
 }
 //---------------------------------------------------------------------------
 void csrMat4Transpose(const CSR_Matrix4* pM, CSR_Matrix4* pR)
@@ -579,6 +650,112 @@ void csrMat4ApplyToNormal(const CSR_Matrix4* pM, const CSR_Vector3* pN, CSR_Vect
     pR->m_Z = (pN->m_X * pM->m_Table[0][2] + pN->m_Y * pM->m_Table[1][2] + pN->m_Z * pM->m_Table[2][2]);
 }
 //---------------------------------------------------------------------------
+void csrMat4ApplyToVectorArray(const CSR_Matrix4* pM,
+                               const CSR_Vector3* pV,
+                                     size_t       count,
+                                     CSR_Vector3* pR)
+{
+    size_t i;
+
+    #if defined(CSR_USE_SSE)
+        const __m128 row0 = _mm_loadu_ps(pM->m_Table[0]);
+        const __m128 row1 = _mm_loadu_ps(pM->m_Table[1]);
+        const __m128 row2 = _mm_loadu_ps(pM->m_Table[2]);
+        const __m128 row3 = _mm_loadu_ps(pM->m_Table[3]);
+              __m128 result;
+
+        for (i = 0; i < count; ++i)
+        {
+            result = _mm_mul_ps(_mm_set1_ps(pV[i].m_X), row0);
+            result = _mm_add_ps(result, _mm_mul_ps(_mm_set1_ps(pV[i].m_Y), row1));
+            result = _mm_add_ps(result, _mm_mul_ps(_mm_set1_ps(pV[i].m_Z), row2));
+            result = _mm_add_ps(result, row3);
+
+            // write the 3 first components only, the next vector may not be transformed yet
+            _mm_storel_pi((__m64*)&pR[i].m_X, result);
+            _mm_store_ss(&pR[i].m_Z, _mm_movehl_ps(result, result));
+        }
+    #elif defined(CSR_USE_NEON)
+        const float32x4_t row0 = vld1q_f32(pM->m_Table[0]);
+        const float32x4_t row1 = vld1q_f32(pM->m_Table[1]);
+        const float32x4_t row2 = vld1q_f32(pM->m_Table[2]);
+        const float32x4_t row3 = vld1q_f32(pM->m_Table[3]);
+              float32x4_t result;
+
+        for (i = 0; i < count; ++i)
+        {
+            result = vmulq_n_f32(row0, pV[i].m_X);
+            result = vaddq_f32(result, vmulq_n_f32(row1, pV[i].m_Y));
+            result = vaddq_f32(result, vmulq_n_f32(row2, pV[i].m_Z));
+            result = vaddq_f32(result, row3);
+
+            // write the 3 first components only, the next vector may not be transformed yet
+            vst1_f32(&pR[i].m_X, vget_low_f32(result));
+            vst1q_lane_f32(&pR[i].m_Z, result, 2);
+        }
+    #else
+        CSR_Vector3 vector;
+
+        // copy the vector, because the result may be written in place
+        for (i = 0; i < count; ++i)
+        {
+            vector = pV[i];
+            csrMat4ApplyToVector(pM, &vector, &pR[i]);
+        }
+    #endif
+}
+//---------------------------------------------------------------------------
+void csrMat4ApplyToNormalArray(const CSR_Matrix4* pM,
+                               const CSR_Vector3* pN,
+                                     size_t       count,
+                                     CSR_Vector3* pR)
+{
+    size_t i;
+
+    #if defined(CSR_USE_SSE)
+        const __m128 row0 = _mm_loadu_ps(pM->m_Table[0]);
+        const __m128 row1 = _mm_loadu_ps(pM->m_Table[1]);
+        const __m128 row2 = _mm_loadu_ps(pM->m_Table[2]);
+              __m128 result;
+
+        for (i = 0; i < count; ++i)
+        {
+            result = _mm_mul_ps(_mm_set1_ps(pN[i].m_X), row0);
+            result = _mm_add_ps(result, _mm_mul_ps(_mm_set1_ps(pN[i].m_Y), row1));
+            result = _mm_add_ps(result, _mm_mul_ps(_mm_set1_ps(pN[i].m_Z), row2));
+
+            // write the 3 first components only, the next normal may not be transformed yet
+            _mm_storel_pi((__m64*)&pR[i].m_X, result);
+            _mm_store_ss(&pR[i].m_Z, _mm_movehl_ps(result, result));
+        }
+    #elif defined(CSR_USE_NEON)
+        const float32x4_t row0 = vld1q_f32(pM->m_Table[0]);
+        const float32x4_t row1 = vld1q_f32(pM->m_Table[1]);
+        const float32x4_t row2 = vld1q_f32(pM->m_Table[2]);
+              float32x4_t result;
+
+        for (i = 0; i < count; ++i)
+        {
+            result = vmulq_n_f32(row0, pN[i].m_X);
+            result = vaddq_f32(result, vmulq_n_f32(row1, pN[i].m_Y));
+            result = vaddq_f32(result, vmulq_n_f32(row2, pN[i].m_Z));
+
+            // write the 3 first components only, the next normal may not be transformed yet
+            vst1_f32(&pR[i].m_X, vget_low_f32(result));
+            vst1q_lane_f32(&pR[i].m_Z, result, 2);
+        }
+    #else
+        CSR_Vector3 normal;
+
+        // copy the normal, because the result may be written in place
+        for (i = 0; i < count; ++i)
+        {
+            normal = pN[i];
+            csrMat4ApplyToNormal(pM, &normal, &pR[i]);
+        }
+    #endif
+}
+//---------------------------------------------------------------------------
 void csrMat4Transform(const CSR_Matrix4* pM, const CSR_Vector3* pV, CSR_Vector3* pR)
 {
     float w;
@@ -828,10 +1005,47 @@ void csrQuatConjugate(const CSR_Quaternion* pQ, CSR_Quaternion* pR)
 //---------------------------------------------------------------------------
 void csrQuatMultiply(const CSR_Quaternion* pQ1, const CSR_Quaternion* pQ2, CSR_Quaternion* pR)
 {
-    pR->m_X = pQ1->m_W * pQ2->m_X + pQ1->m_X * pQ2->m_W + pQ1->m_Y * pQ2->m_Z - pQ1->m_Z * pQ2->m_Y;
-    pR->m_Y = pQ1->m_W * pQ2->m_Y - pQ1->m_X * pQ2->m_Z + pQ1->m_Y * pQ2->m_W + pQ1->m_Z * pQ2->m_X;
-    pR->m_Z = pQ1->m_W * pQ2->m_Z + pQ1->m_X * pQ2->m_Y - pQ1->m_Y * pQ2->m_X + pQ1->m_Z * pQ2->m_W;
-    pR->m_W = pQ1->m_W * pQ2->m_W - pQ1->m_X * pQ2->m_X - pQ1->m_Y * pQ2->m_Y - pQ1->m_Z * pQ2->m_Z;
+    // NOTE the SIMD versions add the same terms in the same order as the C code, and a subtraction
+    // is an addition of a negated term, thus the results are identical
+    #if defined(CSR_USE_SSE)
+        const __m128 q2     = _mm_loadu_ps(&pQ2->m_X);
+        const __m128 signX  = _mm_setr_ps( 1.0f, -1.0f,  1.0f, -1.0f);
+        const __m128 signY  = _mm_setr_ps( 1.0f,  1.0f, -1.0f, -1.0f);
+        const __m128 signZ  = _mm_setr_ps(-1.0f,  1.0f,  1.0f, -1.0f);
+              __m128 result;
+
+        result = _mm_mul_ps(_mm_set1_ps(pQ1->m_W), q2);
+        result = _mm_add_ps(result, _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(pQ1->m_X),
+                                                          _mm_shuffle_ps(q2, q2, _MM_SHUFFLE(0, 1, 2, 3))),
+                                               signX));
+        result = _mm_add_ps(result, _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(pQ1->m_Y),
+                                                          _mm_shuffle_ps(q2, q2, _MM_SHUFFLE(1, 0, 3, 2))),
+                                               signY));
+        result = _mm_add_ps(result, _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(pQ1->m_Z),
+                                                          _mm_shuffle_ps(q2, q2, _MM_SHUFFLE(2, 3, 0, 1))),
+                                               signZ));
+
+        _mm_storeu_ps(&pR->m_X, result);
+    #elif defined(CSR_USE_NEON)
+        const float32x4_t q2    = vld1q_f32(&pQ2->m_X);
+        const float32x4_t zwxy  = vextq_f32(q2, q2, 2);
+        const float       sx[4] = { 1.0f, -1.0f,  1.0f, -1.0f};
+        const float       sy[4] = { 1.0f,  1.0f, -1.0f, -1.0f};
+        const float       sz[4] = {-1.0f,  1.0f,  1.0f, -1.0f};
+              float32x4_t result;
+
+        result = vmulq_n_f32(q2, pQ1->m_W);
+        result = vaddq_f32(result, vmulq_f32(vmulq_n_f32(vrev64q_f32(zwxy), pQ1->m_X), vld1q_f32(sx)));
+        result = vaddq_f32(result, vmulq_f32(vmulq_n_f32(zwxy,              pQ1->m_Y), vld1q_f32(sy)));
+        result = vaddq_f32(result, vmulq_f32(vmulq_n_f32(vrev64q_f32(q2),   pQ1->m_Z), vld1q_f32(sz)));
+
+        vst1q_f32(&pR->m_X, result);
+    #else
+        pR->m_X = pQ1->m_W * pQ2->m_X + pQ1->m_X * pQ2->m_W + pQ1->m_Y * pQ2->m_Z - pQ1->m_Z * pQ2->m_Y;
+        pR->m_Y = pQ1->m_W * pQ2->m_Y - pQ1->m_X * pQ2->m_Z + pQ1->m_Y * pQ2->m_W + pQ1->m_Z * pQ2->m_X;
+        pR->m_Z = pQ1->m_W * pQ2->m_Z + pQ1->m_X * pQ2->m_Y - pQ1->m_Y * pQ2->m_X + pQ1->m_Z * pQ2->m_W;
+        pR->m_W = pQ1->m_W * pQ2->m_W - pQ1->m_X * pQ2->m_X - pQ1->m_Y * pQ2->m_Y - pQ1->m_Z * pQ2->m_Z;
+    #endif
 }
 //---------------------------------------------------------------------------
 void csrQuatInverse(const CSR_Quaternion* pQ, CSR_Quaternion* pR)
@@ -960,10 +1174,18 @@ int csrQuatSlerp(const CSR_Quaternion* pQ1, const CSR_Quaternion* pQ2, float p,
     }
 
     // calculate the resulting quaternion by using a special form of linear interpolation
-    pR->m_X = (scale0 * pQ1->m_X) + (scale1 * interpolateWith.m_X);
-    pR->m_Y = (scale0 * pQ1->m_Y) + (scale1 * interpolateWith.m_Y);
-    pR->m_Z = (scale0 * pQ1->m_Z) + (scale1 * interpolateWith.m_Z);
-    pR->m_W = (scale0 * pQ1->m_W) + (scale1 * interpolateWith.m_W);
+    #if defined(CSR_USE_SSE)
+        _mm_storeu_ps(&pR->m_X, _mm_add_ps(_mm_mul_ps(_mm_set1_ps(scale0), _mm_loadu_ps(&pQ1->m_X)),
+                                           _mm_mul_ps(_mm_set1_ps(scale1), _mm_loadu_ps(&interpolateWith.m_X))));
+    #elif defined(CSR_USE_NEON)
+        vst1q_f32(&pR->m_X, vaddq_f32(vmulq_n_f32(vld1q_f32(&pQ1->m_X),             scale0),
+                                      vmulq_n_f32(vld1q_f32(&interpolateWith.m_X), scale1)));
+    #else
+        pR->m_X = (scale0 * pQ1->m_X) + (scale1 * interpolateWith.m_X);
+        pR->m_Y = (scale0 * pQ1->m_Y) + (scale1 * interpolateWith.m_Y);
+        pR->m_Z = (scale0 * pQ1->m_Z) + (scale1 * interpolateWith.m_Z);
+        pR->m_W = (scale0 * pQ1->m_W) + (scale1 * interpolateWith.m_W);
+    #endif
 
     return 1;
 }
@@ -1485,6 +1707,28 @@ void csrPolygon3ClosestPoint(const CSR_Vector3* pP, const CSR_Polygon3* pPo, CSR
         *pR = rca;
 }
 //---------------------------------------------------------------------------
+void csrPolygon3PacketSet(const CSR_Polygon3*       pPolygon,
+                                size_t              index,
+                                CSR_Polygon3Packet* pPacket)
+{
+    CSR_Vector3 e1;
+    CSR_Vector3 e2;
+
+    // calculate the edges starting from the first vertex
+    csrVec3Sub(&pPolygon->m_Vertex[1], &pPolygon->m_Vertex[0], &e1);
+    csrVec3Sub(&pPolygon->m_Vertex[2], &pPolygon->m_Vertex[0], &e2);
+
+    pPacket->m_X[index]   = pPolygon->m_Vertex[0].m_X;
+    pPacket->m_Y[index]   = pPolygon->m_Vertex[0].m_Y;
+    pPacket->m_Z[index]   = pPolygon->m_Vertex[0].m_Z;
+    pPacket->m_E1X[index] = e1.m_X;
+    pPacket->m_E1Y[index] = e1.m_Y;
+    pPacket->m_E1Z[index] = e1.m_Z;
+    pPacket->m_E2X[index] = e2.m_X;
+    pPacket->m_E2Y[index] = e2.m_Y;
+    pPacket->m_E2Z[index] = e2.m_Z;
+}
+//---------------------------------------------------------------------------
 // Rectangle functions
 //---------------------------------------------------------------------------
 void csrRectEdge(const CSR_Vector2* pPoint, const CSR_Rect* pRect, CSR_ERect2DEdge* pEdge)
@@ -1622,6 +1866,16 @@ void csrBoxCut(const CSR_Box* pBox, CSR_Box* pLeftBox, CSR_Box* pRightBox)
     }
 }
 //---------------------------------------------------------------------------
+void csrBoxPacketSet(const CSR_Box* pBox, size_t index, CSR_BoxPacket* pPacket)
+{
+    pPacket->m_MinX[index] = pBox->m_Min.m_X;
+    pPacket->m_MinY[index] = pBox->m_Min.m_Y;
+    pPacket->m_MinZ[index] = pBox->m_Min.m_Z;
+    pPacket->m_MaxX[index] = pBox->m_Max.m_X;
+    pPacket->m_MaxY[index] = pBox->m_Max.m_Y;
+    pPacket->m_MaxZ[index] = pBox->m_Max.m_Z;
+}
+//---------------------------------------------------------------------------
 // Inside checks
 //---------------------------------------------------------------------------
 int csrInsidePolygon2(const CSR_Vector2* pP, const CSR_Polygon2* pPo)
@@ -2360,152 +2614,11 @@ int csrIntersect3(const CSR_Figure3* pFigure1,
 
         // ray-polygon intersection
         case 10:
-        {
-            #ifdef _MSC_VER
-                CSR_Plane     polygonPlane = {0};
-                CSR_Vector3   pointOnPlane = {0};
-                CSR_Figure3   plane        = {0};
-            #else
-                CSR_Plane     polygonPlane;
-                CSR_Vector3   pointOnPlane;
-                CSR_Figure3   plane;
-            #endif
-
-            // get the polygon to check
-            const CSR_Polygon3* pPolygon = (CSR_Polygon3*)pSecond;
-
-            // create a plane using the 3 vertices of the polygon
-            csrPlaneFromPoints(&pPolygon->m_Vertex[0],
-                               &pPolygon->m_Vertex[1],
-                               &pPolygon->m_Vertex[2],
-                               &polygonPlane);
-
-            // build a figure for the plane
-            plane.m_Type    = CSR_F3_Plane;
-            plane.m_pFigure = &polygonPlane;
-
-            // calculate the intersection point
-            if (pFigure1->m_Type == CSR_F3_Ray)
-            {
-                if (!csrIntersect3(pFigure1, &plane, &pointOnPlane, pR2, pR3))
-                    return 0;
-            }
-            else
-            if (!csrIntersect3(pFigure2, &plane, &pointOnPlane, pR2, pR3))
-                return 0;
-
-            // check if calculated point is inside the polygon
-            if (csrInsidePolygon3(&pointOnPlane, pPolygon))
-            {
-                if (pR1)
-                    *pR1 = pointOnPlane;
-
-                return 1;
-            }
-
-            return 0;
-        }
+            return csrIntersect3RayPolygon((CSR_Ray3*)pFirst, (CSR_Polygon3*)pSecond, pR1, 0);
 
         // ray-box intersection
         case 11:
-        {
-            float tX1;
-            float tX2;
-            float tY1;
-            float tY2;
-            float tZ1;
-            float tZ2;
-            float tXn;
-            float tXf;
-            float tYn;
-            float tYf;
-            float tZn;
-            float tZf;
-            float tNear;
-            float tFar;
-
-            // get the figures to check
-            const CSR_Ray3* pRay = (CSR_Ray3*)pFirst;
-            const CSR_Box*  pBox = (CSR_Box*)pSecond;
-
-            // get infinite value
-            #ifdef _MSC_VER
-                const float inf = INFINITY;
-            #else
-                const float inf = 1.0f / 0.0f;
-            #endif
-
-            // calculate nearest point where ray intersects box on x coordinate
-            if (pRay->m_InvDir.m_X != inf)
-                tX1 = ((pBox->m_Min.m_X - pRay->m_Pos.m_X) * pRay->m_InvDir.m_X);
-            else
-            if ((pBox->m_Min.m_X - pRay->m_Pos.m_X) < 0.0f)
-                tX1 = -inf;
-            else
-                tX1 =  inf;
-
-            // calculate farthest point where ray intersects box on x coordinate
-            if (pRay->m_InvDir.m_X != inf)
-                tX2 = ((pBox->m_Max.m_X - pRay->m_Pos.m_X) * pRay->m_InvDir.m_X);
-            else
-            if ((pBox->m_Max.m_X - pRay->m_Pos.m_X) < 0.0f)
-                tX2 = -inf;
-            else
-                tX2 =  inf;
-
-            // calculate nearest point where ray intersects box on y coordinate
-            if (pRay->m_InvDir.m_Y != inf)
-                tY1 = ((pBox->m_Min.m_Y - pRay->m_Pos.m_Y) * pRay->m_InvDir.m_Y);
-            else
-            if ((pBox->m_Min.m_Y - pRay->m_Pos.m_Y) < 0.0f)
-                tY1 = -inf;
-            else
-                tY1 =  inf;
-
-            // calculate farthest point where ray intersects box on y coordinate
-            if (pRay->m_InvDir.m_Y != inf)
-                tY2 = ((pBox->m_Max.m_Y - pRay->m_Pos.m_Y) * pRay->m_InvDir.m_Y);
-            else
-            if ((pBox->m_Max.m_Y - pRay->m_Pos.m_Y) < 0.0f)
-                tY2 = -inf;
-            else
-                tY2 =  inf;
-
-            // calculate nearest point where ray intersects box on z coordinate
-            if (pRay->m_InvDir.m_Z != inf)
-                tZ1 = ((pBox->m_Min.m_Z - pRay->m_Pos.m_Z) * pRay->m_InvDir.m_Z);
-            else
-            if ((pBox->m_Min.m_Z - pRay->m_Pos.m_Z) < 0.0f)
-                tZ1 = -inf;
-            else
-                tZ1 =  inf;
-
-            // calculate farthest point where ray intersects box on z coordinate
-            if (pRay->m_InvDir.m_Z != inf)
-                tZ2 = ((pBox->m_Max.m_Z - pRay->m_Pos.m_Z) * pRay->m_InvDir.m_Z);
-            else
-            if ((pBox->m_Max.m_Z - pRay->m_Pos.m_Z) < 0.0f)
-                tZ2 = -inf;
-            else
-                tZ2 =  inf;
-
-            // calculate near/far intersection on each axis
-            csrMathMin(tX1, tX2, &tXn);
-            csrMathMax(tX1, tX2, &tXf);
-            csrMathMin(tY1, tY2, &tYn);
-            csrMathMax(tY1, tY2, &tYf);
-            csrMathMin(tZ1, tZ2, &tZn);
-            csrMathMax(tZ1, tZ2, &tZf);
-
-            // calculate final near/far intersection point
-            csrMathMax(tYn, tZn,   &tNear);
-            csrMathMax(tXn, tNear, &tNear);
-            csrMathMin(tYf, tZf,   &tFar);
-            csrMathMin(tXf, tFar,  &tFar);
-
-            // check if ray intersects box
-            return (tFar >= tNear);
-        }
+            return csrIntersect3RayBox((CSR_Ray3*)pFirst, (CSR_Box*)pSecond, 0, 0);
 
         // segment-plane intersection
         case 14:
@@ -2609,129 +2722,7 @@ int csrIntersect3(const CSR_Figure3* pFigure1,
 
         // polygon-sphere intersection
         case 24:
-        {
-            #ifdef _MSC_VER
-                float        testPoint1;
-                float        testPoint2;
-                CSR_Vector3  sphereNormal    = {0};
-                CSR_Vector3  pointOnSphere   = {0};
-                CSR_Vector3  pointOnPlane    = {0};
-                CSR_Vector3  pointOnTriangle = {0};
-                CSR_Plane    polygonPlane    = {0};
-                CSR_Segment3 seg             = {0};
-                CSR_Figure3  segment         = {0};
-                CSR_Figure3  plane           = {0};
-            #else
-                float        testPoint1;
-                float        testPoint2;
-                CSR_Vector3  sphereNormal;
-                CSR_Vector3  pointOnSphere;
-                CSR_Vector3  pointOnPlane;
-                CSR_Vector3  pointOnTriangle;
-                CSR_Plane    polygonPlane;
-                CSR_Segment3 seg;
-                CSR_Figure3  segment;
-                CSR_Figure3  plane;
-            #endif
-
-            // get the figures to check
-            const CSR_Polygon3* pPolygon = (CSR_Polygon3*)pFirst;
-            const CSR_Sphere*   pSphere  = (CSR_Sphere*)pSecond;
-
-            // create a plane using the 3 vertices of the polygon
-            csrPlaneFromPoints(&pPolygon->m_Vertex[0],
-                               &pPolygon->m_Vertex[1],
-                               &pPolygon->m_Vertex[2],
-                               &polygonPlane);
-
-            // calculate the distance between the center of the sphere and the plane
-            csrPlaneDistanceTo(&pSphere->m_Center, &polygonPlane, &testPoint1);
-
-            // calculate the normal of the distance sphere-plane using the positive or negative
-            // value of the calculated distance between plane and position
-            if (testPoint1 < 0.0f)
-            {
-                sphereNormal.m_X = polygonPlane.m_A;
-                sphereNormal.m_Y = polygonPlane.m_B;
-                sphereNormal.m_Z = polygonPlane.m_C;
-            }
-            else
-            {
-                sphereNormal.m_X = -polygonPlane.m_A;
-                sphereNormal.m_Y = -polygonPlane.m_B;
-                sphereNormal.m_Z = -polygonPlane.m_C;
-            }
-
-            // calculate the point who the segment from center of sphere in the direction of the
-            // plane will cross the border of the sphere
-            pointOnSphere.m_X = pSphere->m_Center.m_X + (pSphere->m_Radius * sphereNormal.m_X);
-            pointOnSphere.m_Y = pSphere->m_Center.m_Y + (pSphere->m_Radius * sphereNormal.m_Y);
-            pointOnSphere.m_Z = pSphere->m_Center.m_Z + (pSphere->m_Radius * sphereNormal.m_Z);
-
-            // calculate the distance between the border of the sphere and the plane
-            csrPlaneDistanceTo(&pointOnSphere, &polygonPlane, &testPoint2);
-
-            // if the test points are on each side of the plane, then the sphere cross the plane. We
-            // assume that the segment from the center of the sphere to the direction of the plane
-            // can never be coplanar
-            if ((testPoint1 <= 0.0f && testPoint2 >= 0.0f) || (testPoint2 <= 0.0f && testPoint1 >= 0.0f))
-            {
-                // calculate who the segment cross the plane
-                if (!testPoint1)
-                    // if testPoint1 is equal to 0, the center of the sphere cross the plane
-                    pointOnPlane = pSphere->m_Center;
-                else
-                if (!testPoint2)
-                    // if testPoint2 is equal to 0, the border of the sphere cross the plane
-                    pointOnPlane = pointOnSphere;
-                else
-                {
-                    seg.m_Start = pSphere->m_Center;
-                    seg.m_End   = pointOnSphere;
-
-                    // build a figure for the segment
-                    segment.m_Type    = CSR_F3_Segment;
-                    segment.m_pFigure = &seg;
-
-                    // build a figure for the plane
-                    plane.m_Type    = CSR_F3_Plane;
-                    plane.m_pFigure = &polygonPlane;
-
-                    // calculate the intersection point
-                    csrIntersect3(&segment, &plane, &pointOnPlane, pR2, pR3);
-                }
-
-                // check if calculated point is inside the polygon
-                if (csrInsidePolygon3(&pointOnPlane, pPolygon))
-                {
-                    // yes, the sphere collide the polygon. Copy the plane and return 1
-                    if (pR3)
-                        *pR3 = polygonPlane;
-
-                    return 1;
-                }
-                else
-                {
-                    // otherwise check if the sphere collide a polygon edge. First calculate the
-                    // point to check on the polygon edge
-                    csrPolygon3ClosestPoint(&pointOnPlane, pPolygon, &pointOnTriangle);
-
-                    // check if this point is inside the sphere
-                    if (csrInsideSphere(&pointOnTriangle, pSphere))
-                    {
-                        // yes, the sphere collide the polygon. In this case the sliding plane is
-                        // copied and the return value is 1
-                        if (pR3)
-                            *pR3 = polygonPlane;
-
-                        return 1;
-                    }
-                }
-            }
-
-            // no collision was found
-            return 0;
-        }
+            return csrIntersect3SpherePolygon((CSR_Sphere*)pSecond, (CSR_Polygon3*)pFirst, pR3);
 
         // box-box intersection
         case 25:
@@ -2948,3 +2939,612 @@ int csrIntersect3(const CSR_Figure3* pFigure1,
     }
 }
 //---------------------------------------------------------------------------
+int csrIntersect3RayBox(const CSR_Ray3* pRay,
+                        const CSR_Box*  pBox,
+                              float*    pNear,
+                              float*    pFar)
+{
+    float tX1;
+    float tX2;
+    float tY1;
+    float tY2;
+    float tZ1;
+    float tZ2;
+    float tXn;
+    float tXf;
+    float tYn;
+    float tYf;
+    float tZn;
+    float tZf;
+    float tNear;
+    float tFar;
+
+    // get infinite value
+    #ifdef _MSC_VER
+        const float inf = INFINITY;
+    #else
+        const float inf = 1.0f / 0.0f;
+    #endif
+
+    // calculate nearest point where ray intersects box on x coordinate
+    if (pRay->m_InvDir.m_X != inf)
+        tX1 = ((pBox->m_Min.m_X - pRay->m_Pos.m_X) * pRay->m_InvDir.m_X);
+    else
+    if ((pBox->m_Min.m_X - pRay->m_Pos.m_X) < 0.0f)
+        tX1 = -inf;
+    else
+        tX1 =  inf;
+
+    // calculate farthest point where ray intersects box on x coordinate
+    if (pRay->m_InvDir.m_X != inf)
+        tX2 = ((pBox->m_Max.m_X - pRay->m_Pos.m_X) * pRay->m_InvDir.m_X);
+    else
+    if ((pBox->m_Max.m_X - pRay->m_Pos.m_X) < 0.0f)
+        tX2 = -inf;
+    else
+        tX2 =  inf;
+
+    // calculate nearest point where ray intersects box on y coordinate
+    if (pRay->m_InvDir.m_Y != inf)
+        tY1 = ((pBox->m_Min.m_Y - pRay->m_Pos.m_Y) * pRay->m_InvDir.m_Y);
+    else
+    if ((pBox->m_Min.m_Y - pRay->m_Pos.m_Y) < 0.0f)
+        tY1 = -inf;
+    else
+        tY1 =  inf;
+
+    // calculate farthest point where ray intersects box on y coordinate
+    if (pRay->m_InvDir.m_Y != inf)
+        tY2 = ((pBox->m_Max.m_Y - pRay->m_Pos.m_Y) * pRay->m_InvDir.m_Y);
+    else
+    if ((pBox->m_Max.m_Y - pRay->m_Pos.m_Y) < 0.0f)
+        tY2 = -inf;
+    else
+        tY2 =  inf;
+
+    // calculate nearest point where ray intersects box on z coordinate
+    if (pRay->m_InvDir.m_Z != inf)
+        tZ1 = ((pBox->m_Min.m_Z - pRay->m_Pos.m_Z) * pRay->m_InvDir.m_Z);
+    else
+    if ((pBox->m_Min.m_Z - pRay->m_Pos.m_Z) < 0.0f)
+        tZ1 = -inf;
+    else
+        tZ1 =  inf;
+
+    // calculate farthest point where ray intersects box on z coordinate
+    if (pRay->m_InvDir.m_Z != inf)
+        tZ2 = ((pBox->m_Max.m_Z - pRay->m_Pos.m_Z) * pRay->m_InvDir.m_Z);
+    else
+    if ((pBox->m_Max.m_Z - pRay->m_Pos.m_Z) < 0.0f)
+        tZ2 = -inf;
+    else
+        tZ2 =  inf;
+
+    // calculate near/far intersection on each axis
+    csrMathMin(tX1, tX2, &tXn);
+    csrMathMax(tX1, tX2, &tXf);
+    csrMathMin(tY1, tY2, &tYn);
+    csrMathMax(tY1, tY2, &tYf);
+    csrMathMin(tZ1, tZ2, &tZn);
+    csrMathMax(tZ1, tZ2, &tZf);
+
+    // calculate final near/far intersection point
+    csrMathMax(tYn, tZn,   &tNear);
+    csrMathMax(tXn, tNear, &tNear);
+    csrMathMin(tYf, tZf,   &tFar);
+    csrMathMin(tXf, tFar,  &tFar);
+
+    if (pNear)
+        *pNear = tNear;
+
+    if (pFar)
+        *pFar = tFar;
+
+    // check if ray intersects box
+    return (tFar >= tNear);
+}
+//---------------------------------------------------------------------------
+int csrIntersect3RayPolygon(const CSR_Ray3*     pRay,
+                            const CSR_Polygon3* pPolygon,
+                                  CSR_Vector3*  pR,
+                                  float*        pDist)
+{
+    float       det;
+    float       invDet;
+    float       u;
+    float       v;
+    float       t;
+    CSR_Vector3 e1;
+    CSR_Vector3 e2;
+    CSR_Vector3 p;
+    CSR_Vector3 q;
+    CSR_Vector3 s;
+
+    /*
+    * use the Moller-Trumbore algorithm, which finds the intersection point barycentric coordinates
+    * (u, v) in the polygon and its distance t on the ray by solving:
+    *
+    * pos + t * dir = v1 + u * (v2 - v1) + v * (v3 - v1)
+    *
+    * the point is inside the polygon if u >= 0, v >= 0 and u + v <= 1
+    */
+    csrVec3Sub(&pPolygon->m_Vertex[1], &pPolygon->m_Vertex[0], &e1);
+    csrVec3Sub(&pPolygon->m_Vertex[2], &pPolygon->m_Vertex[0], &e2);
+    csrVec3Cross(&pRay->m_Dir, &e2, &p);
+    csrVec3Dot(&e1, &p, &det);
+
+    // is the ray parallel to the polygon?
+    if (!det)
+        return 0;
+
+    invDet = 1.0f / det;
+
+    // calculate the u coordinate and check if it's inside the polygon limits
+    csrVec3Sub(&pRay->m_Pos, &pPolygon->m_Vertex[0], &s);
+    csrVec3Dot(&s, &p, &u);
+    u *= invDet;
+
+    if (u < -(float)M_CSR_Epsilon || u > 1.0f + (float)M_CSR_Epsilon)
+        return 0;
+
+    // calculate the v coordinate and check if it's inside the polygon limits
+    csrVec3Cross(&s, &e1, &q);
+    csrVec3Dot(&pRay->m_Dir, &q, &v);
+    v *= invDet;
+
+    if (v < -(float)M_CSR_Epsilon || u + v > 1.0f + (float)M_CSR_Epsilon)
+        return 0;
+
+    // calculate the distance on the ray
+    csrVec3Dot(&e2, &q, &t);
+    t *= invDet;
+
+    if (pR)
+    {
+        pR->m_X = pRay->m_Pos.m_X + (t * pRay->m_Dir.m_X);
+        pR->m_Y = pRay->m_Pos.m_Y + (t * pRay->m_Dir.m_Y);
+        pR->m_Z = pRay->m_Pos.m_Z + (t * pRay->m_Dir.m_Z);
+    }
+
+    if (pDist)
+        *pDist = t;
+
+    return 1;
+}
+//---------------------------------------------------------------------------
+int csrIntersect3SpherePolygon(const CSR_Sphere*   pSphere,
+                               const CSR_Polygon3* pPolygon,
+                                     CSR_Plane*    pR)
+{
+    float       dist;
+    float       d11;
+    float       d12;
+    float       d22;
+    float       dw1;
+    float       dw2;
+    float       denom;
+    float       u;
+    float       v;
+    float       lengthSq;
+    CSR_Plane   polygonPlane;
+    CSR_Vector3 e1;
+    CSR_Vector3 e2;
+    CSR_Vector3 w;
+    CSR_Vector3 pointOnPlane;
+    CSR_Vector3 pointOnTriangle;
+    CSR_Vector3 delta;
+
+    // create a plane using the 3 vertices of the polygon
+    csrPlaneFromPoints(&pPolygon->m_Vertex[0],
+                       &pPolygon->m_Vertex[1],
+                       &pPolygon->m_Vertex[2],
+                       &polygonPlane);
+
+    // calculate the distance between the center of the sphere and the plane
+    csrPlaneDistanceTo(&pSphere->m_Center, &polygonPlane, &dist);
+
+    // is the sphere too far from the plane?
+    if (dist > pSphere->m_Radius || dist < -pSphere->m_Radius)
+        return 0;
+
+    // project the sphere center on the plane
+    pointOnPlane.m_X = pSphere->m_Center.m_X - (dist * polygonPlane.m_A);
+    pointOnPlane.m_Y = pSphere->m_Center.m_Y - (dist * polygonPlane.m_B);
+    pointOnPlane.m_Z = pSphere->m_Center.m_Z - (dist * polygonPlane.m_C);
+
+    // calculate the projected point barycentric coordinates in the polygon
+    csrVec3Sub(&pPolygon->m_Vertex[1], &pPolygon->m_Vertex[0], &e1);
+    csrVec3Sub(&pPolygon->m_Vertex[2], &pPolygon->m_Vertex[0], &e2);
+    csrVec3Sub(&pointOnPlane,          &pPolygon->m_Vertex[0], &w);
+    csrVec3Dot(&e1, &e1, &d11);
+    csrVec3Dot(&e1, &e2, &d12);
+    csrVec3Dot(&e2, &e2, &d22);
+    csrVec3Dot(&w,  &e1, &dw1);
+    csrVec3Dot(&w,  &e2, &dw2);
+
+    denom = (d11 * d22) - (d12 * d12);
+
+    // is the polygon degenerated?
+    if (!denom)
+        return 0;
+
+    u = ((d22 * dw1) - (d12 * dw2)) / denom;
+    v = ((d11 * dw2) - (d12 * dw1)) / denom;
+
+    // if the projected point isn't inside the polygon, the sphere may still collide a polygon
+    // edge, check if the closest point on the edges is inside the sphere
+    if (u < -(float)M_CSR_Epsilon || v < -(float)M_CSR_Epsilon || u + v > 1.0f + (float)M_CSR_Epsilon)
+    {
+        csrPolygon3ClosestPoint(&pointOnPlane, pPolygon, &pointOnTriangle);
+        csrVec3Sub(&pointOnTriangle, &pSphere->m_Center, &delta);
+        csrVec3Dot(&delta, &delta, &lengthSq);
+
+        if (lengthSq > pSphere->m_Radius * pSphere->m_Radius)
+            return 0;
+    }
+
+    if (pR)
+        *pR = polygonPlane;
+
+    return 1;
+}
+//---------------------------------------------------------------------------
+int csrIntersect3RayBoxPacket(const CSR_Ray3*      pRay,
+                              const CSR_BoxPacket* pPacket,
+                                    size_t         count)
+{
+    size_t i;
+    int    mask;
+
+    #if defined(CSR_USE_SSE) || defined(CSR_USE_NEON)
+        const float* pMin[3];
+        const float* pMax[3];
+        const float* pPos;
+        const float* pInvDir;
+
+        // get infinite value
+        #ifdef _MSC_VER
+            const float inf = INFINITY;
+        #else
+            const float inf = 1.0f / 0.0f;
+        #endif
+    #else
+        CSR_Box box;
+    #endif
+
+    if (!count)
+        return 0;
+
+    #if defined(CSR_USE_SSE) || defined(CSR_USE_NEON)
+        pMin[0]  = pPacket->m_MinX;
+        pMin[1]  = pPacket->m_MinY;
+        pMin[2]  = pPacket->m_MinZ;
+        pMax[0]  = pPacket->m_MaxX;
+        pMax[1]  = pPacket->m_MaxY;
+        pMax[2]  = pPacket->m_MaxZ;
+        pPos     = &pRay->m_Pos.m_X;
+        pInvDir  = &pRay->m_InvDir.m_X;
+    #endif
+
+    // NOTE the SIMD versions do the same operations as csrIntersect3RayBox(), thus the results
+    // are identical
+    #if defined(CSR_USE_SSE)
+    {
+        const __m128 posInf = _mm_set1_ps( inf);
+        const __m128 negInf = _mm_set1_ps(-inf);
+        const __m128 zero   = _mm_setzero_ps();
+              __m128 tNear  = negInf;
+              __m128 tFar   = posInf;
+              __m128 t1;
+              __m128 t2;
+              __m128 below;
+
+        // calculate the near/far intersection on each axis, and keep the farthest near and the
+        // nearest far
+        for (i = 0; i < 3; ++i)
+        {
+            t1 = _mm_sub_ps(_mm_loadu_ps(pMin[i]), _mm_set1_ps(pPos[i]));
+            t2 = _mm_sub_ps(_mm_loadu_ps(pMax[i]), _mm_set1_ps(pPos[i]));
+
+            // is the ray parallel to this axis?
+            if (pInvDir[i] != inf)
+            {
+                t1 = _mm_mul_ps(t1, _mm_set1_ps(pInvDir[i]));
+                t2 = _mm_mul_ps(t2, _mm_set1_ps(pInvDir[i]));
+            }
+            else
+            {
+                below = _mm_cmplt_ps(t1, zero);
+                t1    = _mm_or_ps(_mm_and_ps(below, negInf), _mm_andnot_ps(below, posInf));
+                below = _mm_cmplt_ps(t2, zero);
+                t2    = _mm_or_ps(_mm_and_ps(below, negInf), _mm_andnot_ps(below, posInf));
+            }
+
+            tNear = _mm_max_ps(tNear, _mm_min_ps(t1, t2));
+            tFar  = _mm_min_ps(tFar,  _mm_max_ps(t1, t2));
+        }
+
+        mask = _mm_movemask_ps(_mm_cmpge_ps(tFar, tNear));
+    }
+    #elif defined(CSR_USE_NEON)
+    {
+        const float32x4_t posInf = vdupq_n_f32( inf);
+        const float32x4_t negInf = vdupq_n_f32(-inf);
+        const float32x4_t zero   = vdupq_n_f32(0.0f);
+              float32x4_t tNear  = negInf;
+              float32x4_t tFar   = posInf;
+              float32x4_t t1;
+              float32x4_t t2;
+              uint32_t    hit[4];
+
+        // calculate the near/far intersection on each axis, and keep the farthest near and the
+        // nearest far
+        for (i = 0; i < 3; ++i)
+        {
+            t1 = vsubq_f32(vld1q_f32(pMin[i]), vdupq_n_f32(pPos[i]));
+            t2 = vsubq_f32(vld1q_f32(pMax[i]), vdupq_n_f32(pPos[i]));
+
+            // is the ray parallel to this axis?
+            if (pInvDir[i] != inf)
+            {
+                t1 = vmulq_n_f32(t1, pInvDir[i]);
+                t2 = vmulq_n_f32(t2, pInvDir[i]);
+            }
+            else
+            {
+                t1 = vbslq_f32(vcltq_f32(t1, zero), negInf, posInf);
+                t2 = vbslq_f32(vcltq_f32(t2, zero), negInf, posInf);
+            }
+
+            tNear = vmaxq_f32(tNear, vminq_f32(t1, t2));
+            tFar  = vminq_f32(tFar,  vmaxq_f32(t1, t2));
+        }
+
+        vst1q_u32(hit, vcgeq_f32(tFar, tNear));
+
+        mask = (hit[0] & 1) | ((hit[1] & 1) << 1) | ((hit[2] & 1) << 2) | ((hit[3] & 1) << 3);
+    }
+    #else
+        mask = 0;
+
+        for (i = 0; i < count; ++i)
+        {
+            box.m_Min.m_X = pPacket->m_MinX[i];
+            box.m_Min.m_Y = pPacket->m_MinY[i];
+            box.m_Min.m_Z = pPacket->m_MinZ[i];
+            box.m_Max.m_X = pPacket->m_MaxX[i];
+            box.m_Max.m_Y = pPacket->m_MaxY[i];
+            box.m_Max.m_Z = pPacket->m_MaxZ[i];
+
+            if (csrIntersect3RayBox(pRay, &box, 0, 0))
+                mask |= (1 << i);
+        }
+    #endif
+
+    // ignore the unused packet slots
+    return mask & ((1 << count) - 1);
+}
+//---------------------------------------------------------------------------
+int csrIntersect3RayPolygonPacket(const CSR_Ray3*           pRay,
+                                  const CSR_Polygon3Packet* pPacket,
+                                        size_t              count,
+                                        float*              pDist)
+{
+    int mask;
+
+    if (!count)
+        return 0;
+
+    // NOTE the SIMD versions do the same operations as csrIntersect3RayPolygon(), thus the results
+    // are identical
+    #if defined(CSR_USE_SSE)
+    {
+        const __m128 dirX   = _mm_set1_ps(pRay->m_Dir.m_X);
+        const __m128 dirY   = _mm_set1_ps(pRay->m_Dir.m_Y);
+        const __m128 dirZ   = _mm_set1_ps(pRay->m_Dir.m_Z);
+        const __m128 e1X    = _mm_loadu_ps(pPacket->m_E1X);
+        const __m128 e1Y    = _mm_loadu_ps(pPacket->m_E1Y);
+        const __m128 e1Z    = _mm_loadu_ps(pPacket->m_E1Z);
+        const __m128 e2X    = _mm_loadu_ps(pPacket->m_E2X);
+        const __m128 e2Y    = _mm_loadu_ps(pPacket->m_E2Y);
+        const __m128 e2Z    = _mm_loadu_ps(pPacket->m_E2Z);
+        const __m128 minVal = _mm_set1_ps(-(float)M_CSR_Epsilon);
+        const __m128 maxVal = _mm_set1_ps(1.0f + (float)M_CSR_Epsilon);
+              __m128 pX;
+              __m128 pY;
+              __m128 pZ;
+              __m128 sX;
+              __m128 sY;
+              __m128 sZ;
+              __m128 qX;
+              __m128 qY;
+              __m128 qZ;
+              __m128 det;
+              __m128 invDet;
+              __m128 u;
+              __m128 v;
+              __m128 valid;
+
+        // p = dir x e2, det = e1 . p
+        pX  = _mm_sub_ps(_mm_mul_ps(dirY, e2Z), _mm_mul_ps(e2Y, dirZ));
+        pY  = _mm_sub_ps(_mm_mul_ps(dirZ, e2X), _mm_mul_ps(e2Z, dirX));
+        pZ  = _mm_sub_ps(_mm_mul_ps(dirX, e2Y), _mm_mul_ps(e2X, dirY));
+        det = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e1X, pX), _mm_mul_ps(e1Y, pY)), _mm_mul_ps(e1Z, pZ));
+
+        // the lanes where the ray is parallel to the polygon are discarded
+        valid  = _mm_cmpneq_ps(det, _mm_setzero_ps());
+        invDet = _mm_div_ps(_mm_set1_ps(1.0f), det);
+
+        // s = pos - v1, u = (s . p) / det
+        sX = _mm_sub_ps(_mm_set1_ps(pRay->m_Pos.m_X), _mm_loadu_ps(pPacket->m_X));
+        sY = _mm_sub_ps(_mm_set1_ps(pRay->m_Pos.m_Y), _mm_loadu_ps(pPacket->m_Y));
+        sZ = _mm_sub_ps(_mm_set1_ps(pRay->m_Pos.m_Z), _mm_loadu_ps(pPacket->m_Z));
+        u  = _mm_add_ps(_mm_add_ps(_mm_mul_ps(sX, pX), _mm_mul_ps(sY, pY)), _mm_mul_ps(sZ, pZ));
+        u  = _mm_mul_ps(u, invDet);
+
+        // q = s x e1, v = (dir . q) / det
+        qX = _mm_sub_ps(_mm_mul_ps(sY, e1Z), _mm_mul_ps(e1Y, sZ));
+        qY = _mm_sub_ps(_mm_mul_ps(sZ, e1X), _mm_mul_ps(e1Z, sX));
+        qZ = _mm_sub_ps(_mm_mul_ps(sX, e1Y), _mm_mul_ps(e1X, sY));
+        v  = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dirX, qX), _mm_mul_ps(dirY, qY)), _mm_mul_ps(dirZ, qZ));
+        v  = _mm_mul_ps(v, invDet);
+
+        // check if the intersection point is inside the polygons limits
+        valid = _mm_and_ps(valid, _mm_cmpge_ps(u, minVal));
+        valid = _mm_and_ps(valid, _mm_cmple_ps(u, maxVal));
+        valid = _mm_and_ps(valid, _mm_cmpge_ps(v, minVal));
+        valid = _mm_and_ps(valid, _mm_cmple_ps(_mm_add_ps(u, v), maxVal));
+        mask  = _mm_movemask_ps(valid);
+
+        // t = (e2 . q) / det
+        if (pDist)
+            _mm_storeu_ps(pDist,
+                          _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(e2X, qX), _mm_mul_ps(e2Y, qY)),
+                                                _mm_mul_ps(e2Z, qZ)),
+                                     invDet));
+    }
+    #elif defined(CSR_USE_NEON)
+    {
+        const float32x4_t dirX   = vdupq_n_f32(pRay->m_Dir.m_X);
+        const float32x4_t dirY   = vdupq_n_f32(pRay->m_Dir.m_Y);
+        const float32x4_t dirZ   = vdupq_n_f32(pRay->m_Dir.m_Z);
+        const float32x4_t e1X    = vld1q_f32(pPacket->m_E1X);
+        const float32x4_t e1Y    = vld1q_f32(pPacket->m_E1Y);
+        const float32x4_t e1Z    = vld1q_f32(pPacket->m_E1Z);
+        const float32x4_t e2X    = vld1q_f32(pPacket->m_E2X);
+        const float32x4_t e2Y    = vld1q_f32(pPacket->m_E2Y);
+        const float32x4_t e2Z    = vld1q_f32(pPacket->m_E2Z);
+        const float32x4_t minVal = vdupq_n_f32(-(float)M_CSR_Epsilon);
+        const float32x4_t maxVal = vdupq_n_f32(1.0f + (float)M_CSR_Epsilon);
+              float32x4_t pX;
+              float32x4_t pY;
+              float32x4_t pZ;
+              float32x4_t sX;
+              float32x4_t sY;
+              float32x4_t sZ;
+              float32x4_t qX;
+              float32x4_t qY;
+              float32x4_t qZ;
+              float32x4_t invDet;
+              float32x4_t u;
+              float32x4_t v;
+              uint32x4_t  valid;
+              float       det[4];
+              uint32_t    hit[4];
+              size_t      i;
+
+        // p = dir x e2, det = e1 . p
+        pX = vsubq_f32(vmulq_f32(dirY, e2Z), vmulq_f32(e2Y, dirZ));
+        pY = vsubq_f32(vmulq_f32(dirZ, e2X), vmulq_f32(e2Z, dirX));
+        pZ = vsubq_f32(vmulq_f32(dirX, e2Y), vmulq_f32(e2X, dirY));
+        vst1q_f32(det, vaddq_f32(vaddq_f32(vmulq_f32(e1X, pX), vmulq_f32(e1Y, pY)), vmulq_f32(e1Z, pZ)));
+
+        // NEON has no division on all the architectures, the determinants are inverted one by one.
+        // The lanes where the ray is parallel to the polygon are discarded
+        for (i = 0; i < 4; ++i)
+            if (det[i])
+            {
+                hit[i] = 0xFFFFFFFF;
+                det[i] = 1.0f / det[i];
+            }
+            else
+                hit[i] = 0;
+
+        valid  = vld1q_u32(hit);
+        invDet = vld1q_f32(det);
+
+        // s = pos - v1, u = (s . p) / det
+        sX = vsubq_f32(vdupq_n_f32(pRay->m_Pos.m_X), vld1q_f32(pPacket->m_X));
+        sY = vsubq_f32(vdupq_n_f32(pRay->m_Pos.m_Y), vld1q_f32(pPacket->m_Y));
+        sZ = vsubq_f32(vdupq_n_f32(pRay->m_Pos.m_Z), vld1q_f32(pPacket->m_Z));
+        u  = vaddq_f32(vaddq_f32(vmulq_f32(sX, pX), vmulq_f32(sY, pY)), vmulq_f32(sZ, pZ));
+        u  = vmulq_f32(u, invDet);
+
+        // q = s x e1, v = (dir . q) / det
+        qX = vsubq_f32(vmulq_f32(sY, e1Z), vmulq_f32(e1Y, sZ));
+        qY = vsubq_f32(vmulq_f32(sZ, e1X), vmulq_f32(e1Z, sX));
+        qZ = vsubq_f32(vmulq_f32(sX, e1Y), vmulq_f32(e1X, sY));
+        v  = vaddq_f32(vaddq_f32(vmulq_f32(dirX, qX), vmulq_f32(dirY, qY)), vmulq_f32(dirZ, qZ));
+        v  = vmulq_f32(v, invDet);
+
+        // check if the intersection point is inside the polygons limits
+        valid = vandq_u32(valid, vcgeq_f32(u, minVal));
+        valid = vandq_u32(valid, vcleq_f32(u, maxVal));
+        valid = vandq_u32(valid, vcgeq_f32(v, minVal));
+        valid = vandq_u32(valid, vcleq_f32(vaddq_f32(u, v), maxVal));
+        vst1q_u32(hit, valid);
+
+        mask = (hit[0] & 1) | ((hit[1] & 1) << 1) | ((hit[2] & 1) << 2) | ((hit[3] & 1) << 3);
+
+        // t = (e2 . q) / det
+        if (pDist)
+            vst1q_f32(pDist,
+                      vmulq_f32(vaddq_f32(vaddq_f32(vmulq_f32(e2X, qX), vmulq_f32(e2Y, qY)),
+                                          vmulq_f32(e2Z, qZ)),
+                                invDet));
+    }
+    #else
+    {
+        size_t i;
+
+        mask = 0;
+
+        for (i = 0; i < count; ++i)
+        {
+            float det;
+            float invDet;
+            float u;
+            float v;
+            float pX;
+            float pY;
+            float pZ;
+            float sX;
+            float sY;
+            float sZ;
+            float qX;
+            float qY;
+            float qZ;
+
+            // p = dir x e2, det = e1 . p
+            pX  = (pRay->m_Dir.m_Y * pPacket->m_E2Z[i]) - (pPacket->m_E2Y[i] * pRay->m_Dir.m_Z);
+            pY  = (pRay->m_Dir.m_Z * pPacket->m_E2X[i]) - (pPacket->m_E2Z[i] * pRay->m_Dir.m_X);
+            pZ  = (pRay->m_Dir.m_X * pPacket->m_E2Y[i]) - (pPacket->m_E2X[i] * pRay->m_Dir.m_Y);
+            det = (pPacket->m_E1X[i] * pX) + (pPacket->m_E1Y[i] * pY) + (pPacket->m_E1Z[i] * pZ);
+
+            // is the ray parallel to the polygon?
+            if (!det)
+                continue;
+
+            invDet = 1.0f / det;
+
+            // s = pos - v1, u = (s . p) / det
+            sX = pRay->m_Pos.m_X - pPacket->m_X[i];
+            sY = pRay->m_Pos.m_Y - pPacket->m_Y[i];
+            sZ = pRay->m_Pos.m_Z - pPacket->m_Z[i];
+            u  = ((sX * pX) + (sY * pY) + (sZ * pZ)) * invDet;
+
+            if (u < -(float)M_CSR_Epsilon || u > 1.0f + (float)M_CSR_Epsilon)
+                continue;
+
+            // q = s x e1, v = (dir . q) / det
+            qX = (sY * pPacket->m_E1Z[i]) - (pPacket->m_E1Y[i] * sZ);
+            qY = (sZ * pPacket->m_E1X[i]) - (pPacket->m_E1Z[i] * sX);
+            qZ = (sX * pPacket->m_E1Y[i]) - (pPacket->m_E1X[i] * sY);
+            v  = ((pRay->m_Dir.m_X * qX) + (pRay->m_Dir.m_Y * qY) + (pRay->m_Dir.m_Z * qZ)) * invDet;
+
+            if (v < -(float)M_CSR_Epsilon || u + v > 1.0f + (float)M_CSR_Epsilon)
+                continue;
+
+            // t = (e2 . q) / det
+            if (pDist)
+                pDist[i] = ((pPacket->m_E2X[i] * qX) + (pPacket->m_E2Y[i] * qY) + (pPacket->m_E2Z[i] * qZ)) * invDet;
+
+            mask |= (1 << i);
+        }
+    }
+    #endif
+
+    // ignore the unused packet slots
+    return mask & ((1 << count) - 1);
+}
+//---------------------------------------------------------------------------
@@ -22,6 +22,21 @@
 // compactStar engine
 #include "CSR_Common.h"
 
+// SIMD instructions. NOTE the Mobile C Compiler doesn't support them, and they may be disabled
+// by defining CSR_NO_SIMD in the global preprocessor macros
+#if !defined(CSR_NO_SIMD) && !defined(_OS_IOS_) && !defined(_OS_ANDROID_) && !defined(_OS_WINDOWS_)
+    #if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+        #define CSR_USE_SSE
+    #elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+        #define CSR_USE_NEON
+    #endif
+#endif
+
+//---------------------------------------------------------------------------
+// Global defines
+//---------------------------------------------------------------------------
+#define M_CSR_Packet_Size 4 // figure count checked at once by the packet intersection functions
+
 //---------------------------------------------------------------------------
 // Enumerators
 //---------------------------------------------------------------------------
@@ -255,6 +270,36 @@ typedef struct
     const void*  m_pFigure;
 } CSR_Figure3;
 
+/**
+* Aligned-axis box packet, i.e. several boxes stored by coordinate, to be checked at once
+*/
+typedef struct
+{
+    float m_MinX[M_CSR_Packet_Size];
+    float m_MinY[M_CSR_Packet_Size];
+    float m_MinZ[M_CSR_Packet_Size];
+    float m_MaxX[M_CSR_Packet_Size];
+    float m_MaxY[M_CSR_Packet_Size];
+    float m_MaxZ[M_CSR_Packet_Size];
+} CSR_BoxPacket;
+
+/**
+* 3D polygon packet, i.e. several polygons stored by coordinate, to be checked at once
+*@note Each polygon is stored as its first vertex, and its 2 edges starting from this vertex
+*/
+typedef struct
+{
+    float m_X[M_CSR_Packet_Size];   // first vertex
+    float m_Y[M_CSR_Packet_Size];
+    float m_Z[M_CSR_Packet_Size];
+    float m_E1X[M_CSR_Packet_Size]; // edge from the first to the second vertex
+    float m_E1Y[M_CSR_Packet_Size];
+    float m_E1Z[M_CSR_Packet_Size];
+    float m_E2X[M_CSR_Packet_Size]; // edge from the first to the third vertex
+    float m_E2Y[M_CSR_Packet_Size];
+    float m_E2Z[M_CSR_Packet_Size];
+} CSR_Polygon3Packet;
+
 #ifdef __cplusplus
     extern "C"
     {
@@ -609,6 +654,19 @@ typedef struct
         */
         void csrMat4Multiply(const CSR_Matrix4* pM1, const CSR_Matrix4* pM2, CSR_Matrix4* pR);
 
+        /**
+        * Multiplies an array of matrices by a matrix
+        *@param pM - matrices to multiply
+        *@param count - matrix count
+        *@param pM2 - matrix by which each matrix is multiplied
+        *@param[out] pR - resulting matrices, may be the same array as pM
+        *@note Each resulting matrix is equal to csrMat4Multiply(&pM[i], pM2, &pR[i])
+        */
+        void csrMat4MultiplyArray(const CSR_Matrix4* pM,
+                                        size_t       count,
+                                  const CSR_Matrix4* pM2,
+                                        CSR_Matrix4* pR);
+
         /**
         * Transposes a matrix
         *@param pM - matrix to transpose
@@ -640,6 +698,32 @@ typedef struct
         */
         void csrMat4ApplyToNormal(const CSR_Matrix4* pM, const CSR_Vector3* pN, CSR_Vector3* pR);
 
+        /**
+        * Applies a matrix to an array of vectors
+        *@param pM - matrix to apply
+        *@param pV - vectors on which matrix should be applied
+        *@param count - vector count
+        *@param[out] pR - resulting vectors, may be the same array as pV
+        *@note Each resulting vector is equal to csrMat4ApplyToVector(pM, &pV[i], &pR[i])
+        */
+        void csrMat4ApplyToVectorArray(const CSR_Matrix4* pM,
+                                       const CSR_Vector3* pV,
+                                             size_t       count,
+                                             CSR_Vector3* pR);
+
+        /**
+        * Applies a matrix to an array of normals
+        *@param pM - matrix to apply
+        *@param pN - normals on which matrix should be applied
+        *@param count - normal count
+        *@param[out] pR - resulting normals, may be the same array as pN
+        *@note Each resulting normal is equal to csrMat4ApplyToNormal(pM, &pN[i], &pR[i])
+        */
+        void csrMat4ApplyToNormalArray(const CSR_Matrix4* pM,
+                                       const CSR_Vector3* pN,
+                                             size_t       count,
+                                             CSR_Vector3* pR);
+
         /**
         * Transforms a vector by a matrix
         *@param pM - transform matrix
@@ -936,6 +1020,16 @@ typedef struct
         */
         void csrPolygon3ClosestPoint(const CSR_Vector3* pP, const CSR_Polygon3* pPo, CSR_Vector3* pR);
 
+        /**
+        * Sets a polygon in a polygon packet
+        *@param pPolygon - polygon to set
+        *@param index - polygon index in the packet, between 0 and M_CSR_Packet_Size - 1
+        *@param[in, out] pPacket - packet in which the polygon should be set
+        */
+        void csrPolygon3PacketSet(const CSR_Polygon3*       pPolygon,
+                                        size_t              index,
+                                        CSR_Polygon3Packet* pPacket);
+
         //-------------------------------------------------------------------
         // Rectangle functions
         //-------------------------------------------------------------------
@@ -970,6 +1064,14 @@ typedef struct
         */
         void csrBoxCut(const CSR_Box* pBox, CSR_Box* pLeftBox, CSR_Box* pRightBox);
 
+        /**
+        * Sets a box in a box packet
+        *@param pBox - box to set
+        *@param index - box index in the packet, between 0 and M_CSR_Packet_Size - 1
+        *@param[in, out] pPacket - packet in which the box should be set
+        */
+        void csrBoxPacketSet(const CSR_Box* pBox, size_t index, CSR_BoxPacket* pPacket);
+
         //-------------------------------------------------------------------
         // Inside checks
         //-------------------------------------------------------------------
@@ -1064,6 +1166,81 @@ typedef struct
                                 CSR_Vector3* pR2,
                                 CSR_Plane*   pR3);
 
+        /**
+        * Checks if a ray intersects a box
+        *@param pRay - ray to check
+        *@param pBox - box to check against
+        *@param[out] pNear - ray distance where the ray enters the box, ignored if 0
+        *@param[out] pFar - ray distance where the ray leaves the box, ignored if 0
+        *@return 1 if the ray intersects the box, otherwise 0
+        *@note The ray is considered as a line, i.e. a box behind the ray origin is also found. In
+        *      this case the near distance is negative
+        *@note This function is faster than csrIntersect3(), which calls it for the ray-box figures
+        */
+        int csrIntersect3RayBox(const CSR_Ray3* pRay,
+                                const CSR_Box*  pBox,
+                                      float*    pNear,
+                                      float*    pFar);
+
+        /**
+        * Checks if a ray intersects a polygon
+        *@param pRay - ray to check
+        *@param pPolygon - polygon to check against
+        *@param[out] pR - point where the ray intersects the polygon, ignored if 0
+        *@param[out] pDist - ray distance where the ray intersects the polygon, ignored if 0
+        *@return 1 if the ray intersects the polygon, otherwise 0
+        *@note The ray is considered as a line, i.e. a polygon behind the ray origin is also found.
+        *      In this case the distance is negative
+        *@note This function is faster than csrIntersect3(), which calls it for the ray-polygon
+        *      figures
+        */
+        int csrIntersect3RayPolygon(const CSR_Ray3*     pRay,
+                                    const CSR_Polygon3* pPolygon,
+                                          CSR_Vector3*  pR,
+                                          float*        pDist);
+
+        /**
+        * Checks if a sphere intersects a polygon
+        *@param pSphere - sphere to check
+        *@param pPolygon - polygon to check against
+        *@param[out] pR - polygon plane, ignored if 0
+        *@return 1 if the sphere intersects the polygon, otherwise 0
+        *@note This function is faster than csrIntersect3(), which calls it for the polygon-sphere
+        *      figures
+        */
+        int csrIntersect3SpherePolygon(const CSR_Sphere*   pSphere,
+                                       const CSR_Polygon3* pPolygon,
+                                             CSR_Plane*    pR);
+
+        /**
+        * Checks if a ray intersects the boxes of a packet
+        *@param pRay - ray to check
+        *@param pPacket - box packet to check against
+        *@param count - box count in the packet, up to M_CSR_Packet_Size
+        *@return intersection mask, in which the bit n is set if the ray intersects the box n
+        *@note The ray is considered as a line, as in csrIntersect3RayBox()
+        */
+        int csrIntersect3RayBoxPacket(const CSR_Ray3*      pRay,
+                                      const CSR_BoxPacket* pPacket,
+                                            size_t         count);
+
+        /**
+        * Checks if a ray intersects the polygons of a packet
+        *@param pRay - ray to check
+        *@param pPacket - polygon packet to check against
+        *@param count - polygon count in the packet, up to M_CSR_Packet_Size
+        *@param[out] pDist - array of M_CSR_Packet_Size distances, in which the ray distance where
+        *                    the ray intersects each polygon is written, ignored if 0. The distance
+        *                    is undefined for the polygons the ray doesn't intersect
+        *@return intersection mask, in which the bit n is set if the ray intersects the polygon n
+        *@note The ray is considered as a line, as in csrIntersect3RayPolygon(), and the result is
+        *      identical to the one this function returns for each polygon
+        */
+        int csrIntersect3RayPolygonPacket(const CSR_Ray3*           pRay,
+                                          const CSR_Polygon3Packet* pPacket,
+                                                size_t              count,
+                                                float*              pDist);
+
 #ifdef __cplusplus
     }
 #endif
@@ -0,0 +1,324 @@
+/****************************************************************************
+ * ==> CSR_HeightField -----------------------------------------------------*
+ ****************************************************************************
+ * Description : This module provides a height field, i.e. the regular grid *
+ *               of a landscape, on which the ground may be found in a      *
+ *               constant time                                              *
+ * Developer   : Jean-Milost Reymond                                        *
+ * Copyright   : 2017 - 2022, this file is part of the CompactStar Engine.  *
+ *               You are free to copy or redistribute this file, modify it, *
+ *               or use it for your own projects, commercial or not. This   *
+ *               file is provided "as is", WITHOUT ANY WARRANTY OF ANY      *
+ *               KIND. THE DEVELOPER IS NOT RESPONSIBLE FOR ANY DAMAGE OF   *
+ *               ANY KIND, ANY LOSS OF DATA, OR ANY LOSS OF PRODUCTIVITY    *
+ *               TIME THAT MAY RESULT FROM THE USAGE OF THIS SOURCE CODE,   *
+ *               DIRECTLY OR NOT.                                           *
+ ****************************************************************************/
+
+#include "CSR_HeightField.h"
+
+// std
+#include <stdlib.h>
+#include <string.h>
+
+//---------------------------------------------------------------------------
+// Height field private functions
+//---------------------------------------------------------------------------
+int csrHeightFieldLocate(const CSR_HeightField* pHF,
+                         const CSR_Vector3*     pPoint,
+                               size_t*          pIndex,
+                               float*           pFX,
+                               float*           pFZ)
+{
+    float  fx;
+    float  fz;
+    size_t column;
+    size_t row;
+
+    // calculate the point position in the grid, in cells
+    fx = (pPoint->m_X - pHF->m_X) / pHF->m_Scale;
+    fz = (pHF->m_Z - pPoint->m_Z) / pHF->m_Scale;
+
+    // is the point outside the grid? NOTE written to also reject the NaN values
+    if (!(fx >= 0.0f && fx <= (float)(pHF->m_Width - 1) && fz >= 0.0f && fz <= (float)(pHF->m_Depth - 1)))
+        return 0;
+
+    column = (size_t)fx;
+    row    = (size_t)fz;
+
+    // a point on the last column or row belongs to the previous cell
+    if (column >= pHF->m_Width - 1)
+        column = pHF->m_Width - 2;
+
+    if (row >= pHF->m_Depth - 1)
+        row = pHF->m_Depth - 2;
+
+    *pIndex = (row * pHF->m_Width) + column;
+    *pFX    = fx - (float)column;
+    *pFZ    = fz - (float)row;
+
+    return 1;
+}
+//---------------------------------------------------------------------------
+float csrHeightFieldInterpolate(const CSR_HeightField* pHF, size_t index, float fx, float fz)
+{
+    const float h1 = pHF->m_pHeight[index];
+    const float h2 = pHF->m_pHeight[index + 1];
+    const float h3 = pHF->m_pHeight[index + pHF->m_Width];
+    const float h4 = pHF->m_pHeight[index + pHF->m_Width + 1];
+
+    // is the point on the first polygon (v1, v2, v3) or on the second one (v2, v3, v4)?
+    if (fx + fz <= 1.0f)
+        return h1 + (fx * (h2 - h1)) + (fz * (h3 - h1));
+
+    return h4 + ((1.0f - fx) * (h3 - h4)) + ((1.0f - fz) * (h2 - h4));
+}
+//---------------------------------------------------------------------------
+void csrHeightFieldGetVertex(const CSR_HeightField* pHF, size_t index, CSR_Vector3* pR)
+{
+    const size_t column = index % pHF->m_Width;
+    const size_t row    = index / pHF->m_Width;
+
+    // calculate the vertex the same way as the landscape mesh does
+    pR->m_X = pHF->m_X + ((float)column * pHF->m_Scale);
+    pR->m_Y = pHF->m_pHeight[index];
+    pR->m_Z = pHF->m_Z - ((float)row    * pHF->m_Scale);
+}
+//---------------------------------------------------------------------------
+void csrHeightFieldBuildPolygon(const CSR_HeightField* pHF,
+                                      size_t           index,
+                                      float            fx,
+                                      float            fz,
+                                      CSR_Polygon3*    pR)
+{
+    // first polygon (v1, v2, v3)
+    if (fx + fz <= 1.0f)
+    {
+        csrHeightFieldGetVertex(pHF, index,                &pR->m_Vertex[0]);
+        csrHeightFieldGetVertex(pHF, index + 1,            &pR->m_Vertex[1]);
+        csrHeightFieldGetVertex(pHF, index + pHF->m_Width, &pR->m_Vertex[2]);
+        return;
+    }
+
+    // second polygon (v2, v3, v4)
+    csrHeightFieldGetVertex(pHF, index + 1,                &pR->m_Vertex[0]);
+    csrHeightFieldGetVertex(pHF, index + pHF->m_Width,     &pR->m_Vertex[1]);
+    csrHeightFieldGetVertex(pHF, index + pHF->m_Width + 1, &pR->m_Vertex[2]);
+}
+//---------------------------------------------------------------------------
+// Height field functions
+//---------------------------------------------------------------------------
+CSR_HeightField* csrHeightFieldCreate(const CSR_PixelBuffer* pPixelBuffer,
+                                            float            height,
+                                            float            scale)
+{
+    CSR_HeightField* pHF;
+    size_t           i;
+    size_t           count;
+
+    // validate the inputs. NOTE a grid requires at least one cell
+    if (!pPixelBuffer || !pPixelBuffer->m_pData || height <= 0.0f || scale == 0.0f)
+        return 0;
+
+    if (pPixelBuffer->m_Width < 2 || pPixelBuffer->m_Height < 2)
+        return 0;
+
+    // create a new height field
+    pHF = (CSR_HeightField*)malloc(sizeof(CSR_HeightField));
+
+    // succeeded?
+    if (!pHF)
+        return 0;
+
+    csrHeightFieldInit(pHF);
+
+    count          = (size_t)pPixelBuffer->m_Width * (size_t)pPixelBuffer->m_Height;
+    pHF->m_pHeight = (float*)malloc(count * sizeof(float));
+
+    // succeeded?
+    if (!pHF->m_pHeight)
+    {
+        csrHeightFieldRelease(pHF);
+        return 0;
+    }
+
+    // calculate the grid origin, the same way as csrLandscapeGenerateVertices() does
+    pHF->m_Width = pPixelBuffer->m_Width;
+    pHF->m_Depth = pPixelBuffer->m_Height;
+    pHF->m_Scale = scale;
+    pHF->m_X     = -(((pPixelBuffer->m_Width  - 1) * scale) / 2.0f);
+    pHF->m_Z     =  (((pPixelBuffer->m_Height - 1) * scale) / 2.0f);
+
+    // calculate the height of each grid point
+    for (i = 0; i < count; ++i)
+        pHF->m_pHeight[i] = ((float)(((unsigned char*)pPixelBuffer->m_pData)[i * 3]) / 255.0f) * height;
+
+    return pHF;
+}
+//---------------------------------------------------------------------------
+void csrHeightFieldRelease(CSR_HeightField* pHF)
+{
+    // no height field to release?
+    if (!pHF)
+        return;
+
+    // free the heights
+    free(pHF->m_pHeight);
+
+    // free the height field
+    free(pHF);
+}
+//---------------------------------------------------------------------------
+void csrHeightFieldInit(CSR_HeightField* pHF)
+{
+    // no height field to initialize?
+    if (!pHF)
+        return;
+
+    // initialize the height field
+    pHF->m_pHeight = 0;
+    pHF->m_Width   = 0;
+    pHF->m_Depth   = 0;
+    pHF->m_Scale   = 0.0f;
+    pHF->m_X       = 0.0f;
+    pHF->m_Z       = 0.0f;
+}
+//---------------------------------------------------------------------------
+int csrHeightFieldGetHeight(const CSR_HeightField* pHF, const CSR_Vector3* pPoint, float* pR)
+{
+    size_t index;
+    float  fx;
+    float  fz;
+
+    // validate the inputs
+    if (!pHF || !pHF->m_pHeight || !pPoint || !pR)
+        return 0;
+
+    // get the grid cell containing the point
+    if (!csrHeightFieldLocate(pHF, pPoint, &index, &fx, &fz))
+        return 0;
+
+    *pR = csrHeightFieldInterpolate(pHF, index, fx, fz);
+
+    return 1;
+}
+//---------------------------------------------------------------------------
+int csrHeightFieldGetPolygon(const CSR_HeightField* pHF, const CSR_Vector3* pPoint, CSR_Polygon3* pR)
+{
+    size_t index;
+    float  fx;
+    float  fz;
+
+    // validate the inputs
+    if (!pHF || !pHF->m_pHeight || !pPoint || !pR)
+        return 0;
+
+    // get the grid cell containing the point
+    if (!csrHeightFieldLocate(pHF, pPoint, &index, &fx, &fz))
+        return 0;
+
+    csrHeightFieldBuildPolygon(pHF, index, fx, fz, pR);
+
+    return 1;
+}
+//---------------------------------------------------------------------------
+int csrHeightFieldGetPlane(const CSR_HeightField* pHF, const CSR_Vector3* pPoint, CSR_Plane* pR)
+{
+    CSR_Polygon3 polygon;
+
+    // validate the output
+    if (!pR)
+        return 0;
+
+    // get the ground polygon
+    if (!csrHeightFieldGetPolygon(pHF, pPoint, &polygon))
+        return 0;
+
+    csrPlaneFromPoints(&polygon.m_Vertex[0], &polygon.m_Vertex[1], &polygon.m_Vertex[2], pR);
+
+    return 1;
+}
+//---------------------------------------------------------------------------
+// Height field ground collision functions
+//---------------------------------------------------------------------------
+int csrHeightFieldGroundPosY(const CSR_Sphere*      pBoundingSphere,
+                             const CSR_HeightField* pHF,
+                                   CSR_Polygon3*    pGroundPolygon,
+                                   float*           pR)
+{
+    size_t index;
+    float  fx;
+    float  fz;
+
+    // validate the inputs
+    if (!pBoundingSphere || !pHF || !pHF->m_pHeight)
+        return 0;
+
+    // get the grid cell below the sphere
+    if (!csrHeightFieldLocate(pHF, &pBoundingSphere->m_Center, &index, &fx, &fz))
+    {
+        // like csrGroundPosY(), keep the sphere position if no ground was found
+        if (pR)
+            *pR = pBoundingSphere->m_Center.m_Y;
+
+        return 0;
+    }
+
+    // copy the ground polygon, if required
+    if (pGroundPolygon)
+        csrHeightFieldBuildPolygon(pHF, index, fx, fz, pGroundPolygon);
+
+    // calculate the ground position, considering the sphere radius
+    if (pR)
+        *pR = csrHeightFieldInterpolate(pHF, index, fx, fz) + pBoundingSphere->m_Radius;
+
+    return 1;
+}
+//---------------------------------------------------------------------------
+size_t csrHeightFieldGroundPosYBatch(const CSR_Sphere*      pBoundingSphere,
+                                           size_t           count,
+                                     const CSR_HeightField* pHF,
+                                           CSR_Plane*       pGroundPlane,
+                                           float*           pR)
+{
+    size_t       i;
+    size_t       index;
+    size_t       foundCount;
+    float        fx;
+    float        fz;
+    CSR_Polygon3 polygon;
+
+    // validate the inputs
+    if (!pBoundingSphere || !pHF || !pHF->m_pHeight || !pR)
+        return 0;
+
+    foundCount = 0;
+
+    for (i = 0; i < count; ++i)
+    {
+        // get the grid cell below the sphere
+        if (!csrHeightFieldLocate(pHF, &pBoundingSphere[i].m_Center, &index, &fx, &fz))
+        {
+            pR[i] = pBoundingSphere[i].m_Center.m_Y;
+
+            if (pGroundPlane)
+                memset(&pGroundPlane[i], 0, sizeof(CSR_Plane));
+
+            continue;
+        }
+
+        pR[i] = csrHeightFieldInterpolate(pHF, index, fx, fz) + pBoundingSphere[i].m_Radius;
+
+        // calculate the ground plane, if required
+        if (pGroundPlane)
+        {
+            csrHeightFieldBuildPolygon(pHF, index, fx, fz, &polygon);
+            csrPlaneFromPoints(&polygon.m_Vertex[0], &polygon.m_Vertex[1], &polygon.m_Vertex[2], &pGroundPlane[i]);
+        }
+
+        ++foundCount;
+    }
+
+    return foundCount;
+}
+//---------------------------------------------------------------------------
@@ -0,0 +1,159 @@
+/****************************************************************************
+ * ==> CSR_HeightField -----------------------------------------------------*
+ ****************************************************************************
+ * Description : This module provides a height field, i.e. the regular grid *
+ *               of a landscape, on which the ground may be found in a      *
+ *               constant time                                              *
+ * Developer   : Jean-Milost Reymond                                        *
+ * Copyright   : 2017 - 2022, this file is part of the CompactStar Engine.  *
+ *               You are free to copy or redistribute this file, modify it, *
+ *               or use it for your own projects, commercial or not. This   *
+ *               file is provided "as is", WITHOUT ANY WARRANTY OF ANY      *
+ *               KIND. THE DEVELOPER IS NOT RESPONSIBLE FOR ANY DAMAGE OF   *
+ *               ANY KIND, ANY LOSS OF DATA, OR ANY LOSS OF PRODUCTIVITY    *
+ *               TIME THAT MAY RESULT FROM THE USAGE OF THIS SOURCE CODE,   *
+ *               DIRECTLY OR NOT.                                           *
+ ****************************************************************************/
+
+#ifndef CSR_HeightFieldH
+#define CSR_HeightFieldH
+
+// compactStar engine
+#include "CSR_Common.h"
+#include "CSR_Geometry.h"
+#include "CSR_Texture.h"
+
+//---------------------------------------------------------------------------
+// Structures
+//---------------------------------------------------------------------------
+
+/**
+* Height field, matching with the landscape mesh generated by csrLandscapeCreate()
+*@note Each grid cell is split in 2 polygons, in the same order as the landscape mesh:
+*      v1 -- v2
+*          /
+*         /
+*      v3 -- v4
+*/
+typedef struct
+{
+    float* m_pHeight; // height of each grid point, row by row
+    size_t m_Width;   // grid point count on the x axis
+    size_t m_Depth;   // grid point count on the z axis, i.e. row count
+    float  m_Scale;   // distance between 2 neighbor grid points
+    float  m_X;       // x coordinate of the first grid column
+    float  m_Z;       // z coordinate of the first grid row, the next rows go toward -z
+} CSR_HeightField;
+
+#ifdef __cplusplus
+    extern "C"
+    {
+#endif
+        //-------------------------------------------------------------------
+        // Height field functions
+        //-------------------------------------------------------------------
+
+        /**
+        * Creates a height field from a grayscale image
+        *@param pPixelBuffer - pixel buffer containing the landscape map image
+        *@param height - landscape height
+        *@param scale - scale factor
+        *@return newly created height field, 0 on error
+        *@note The parameters should be the same as the ones used to create the landscape mesh,
+        *      see csrLandscapeCreate()
+        *@note The height field must be released when no longer used, see csrHeightFieldRelease()
+        */
+        CSR_HeightField* csrHeightFieldCreate(const CSR_PixelBuffer* pPixelBuffer,
+                                                    float            height,
+                                                    float            scale);
+
+        /**
+        * Releases a height field
+        *@param[in, out] pHF - height field to release
+        */
+        void csrHeightFieldRelease(CSR_HeightField* pHF);
+
+        /**
+        * Initializes a height field structure
+        *@param[in, out] pHF - height field to initialize
+        */
+        void csrHeightFieldInit(CSR_HeightField* pHF);
+
+        /**
+        * Gets the ground height below or above a point
+        *@param pHF - height field
+        *@param pPoint - point, only the x and z coordinates are used
+        *@param[out] pR - ground height
+        *@return 1 if the point is above the grid, otherwise 0
+        */
+        int csrHeightFieldGetHeight(const CSR_HeightField* pHF, const CSR_Vector3* pPoint, float* pR);
+
+        /**
+        * Gets the ground polygon below or above a point
+        *@param pHF - height field
+        *@param pPoint - point, only the x and z coordinates are used
+        *@param[out] pR - ground polygon, the same as in the landscape mesh
+        *@return 1 if the point is above the grid, otherwise 0
+        */
+        int csrHeightFieldGetPolygon(const CSR_HeightField* pHF, const CSR_Vector3* pPoint, CSR_Polygon3* pR);
+
+        /**
+        * Gets the ground plane below or above a point
+        *@param pHF - height field
+        *@param pPoint - point, only the x and z coordinates are used
+        *@param[out] pR - ground plane, its normal is the ground normal
+        *@return 1 if the point is above the grid, otherwise 0
+        */
+        int csrHeightFieldGetPlane(const CSR_HeightField* pHF, const CSR_Vector3* pPoint, CSR_Plane* pR);
+
+        //-------------------------------------------------------------------
+        // Height field ground collision functions
+        //-------------------------------------------------------------------
+
+        /**
+        * Calculates the y axis position where to place the point of view to stay above the ground
+        *@param pBoundingSphere - sphere surrounding the point of view or model
+        *@param pHF - ground height field
+        *@param[out] pGroundPolygon - polygon on which the ground was hit, ignored if 0
+        *@param[out] pR - resulting position on the y axis where to place the point of view or model
+        *@return 1 if a ground polygon was found, otherwise 0
+        *@note This function is the same as csrGroundPosY() with a [0, -1, 0] ground direction,
+        *      except that the ground is also found if the sphere center is below it
+        *@note The bounding sphere should be in the same coordinate system as the height field
+        */
+        int csrHeightFieldGroundPosY(const CSR_Sphere*      pBoundingSphere,
+                                     const CSR_HeightField* pHF,
+                                           CSR_Polygon3*    pGroundPolygon,
+                                           float*           pR);
+
+        /**
+        * Calculates the y axis position where to place several points of view or models
+        *@param pBoundingSphere - spheres surrounding the points of view or models
+        *@param count - sphere count
+        *@param pHF - ground height field
+        *@param[out] pGroundPlane - ground plane below each sphere, ignored if 0
+        *@param[out] pR - resulting position on the y axis for each sphere
+        *@return the sphere count for which a ground polygon was found
+        *@note For a sphere which isn't above the grid, the resulting position is its center y
+        *      coordinate, and all the ground plane values are set to 0
+        */
+        size_t csrHeightFieldGroundPosYBatch(const CSR_Sphere*      pBoundingSphere,
+                                                   size_t           count,
+                                             const CSR_HeightField* pHF,
+                                                   CSR_Plane*       pGroundPlane,
+                                                   float*           pR);
+
+#ifdef __cplusplus
+    }
+#endif
+
+//---------------------------------------------------------------------------
+// Compiler
+//---------------------------------------------------------------------------
+
+// needed in mobile c compiler to link the .h file with the .c
+#if defined(_OS_IOS_) || defined(_OS_ANDROID_) || defined(_OS_WINDOWS_)
+    #include "CSR_HeightField.c"
+#endif
+
+#endif
@@ -3011,7 +3011,7 @@ CSR_IQM* csrIQMOpen(const char*                 pFileName,
     CSR_IQM*    pIQM;
 
     // open the model file
-    pBuffer = csrFileOpen(pFileName);
+    pBuffer = csrFileMap(pFileName);
 
     // succeeded?
     if (!pBuffer || !pBuffer->m_Length)
@@ -0,0 +1,615 @@
+/****************************************************************************
+ * ==> CSR_Job -------------------------------------------------------------*
+ ****************************************************************************
+ * Description : This module provides a portable job pool, which executes   *
+ *               jobs on worker threads                                     *
+ * Developer   : Jean-Milost Reymond                                        *
+ * Copyright   : 2017 - 2022, this file is part of the CompactStar Engine.  *
+ *               You are free to copy or redistribute this file, modify it, *
+ *               or use it for your own projects, commercial or not. This   *
+ *               file is provided "as is", WITHOUT ANY WARRANTY OF ANY      *
+ *               KIND. THE DEVELOPER IS NOT RESPONSIBLE FOR ANY DAMAGE OF   *
+ *               ANY KIND, ANY LOSS OF DATA, OR ANY LOSS OF PRODUCTIVITY    *
+ *               TIME THAT MAY RESULT FROM THE USAGE OF THIS SOURCE CODE,   *
+ *               DIRECTLY OR NOT.                                           *
+ ****************************************************************************/
+
+// clock_gettime() requires the POSIX 1993 functions, which should be enabled before any include
+#if !defined(_WIN32) && !defined(__APPLE__) && !defined(_POSIX_C_SOURCE)
+    #define _POSIX_C_SOURCE 199309L
+#endif
+
+#include "CSR_Job.h"
+
+// std
+#include <stdlib.h>
+#ifndef _WIN32
+    #include <unistd.h>
+    #include <time.h>
+#endif
+
+//---------------------------------------------------------------------------
+// Job private structures
+//---------------------------------------------------------------------------
+
+/**
+* Parallel loop
+*/
+typedef struct
+{
+    CSR_JobPool*       m_pPool;
+    CSR_fOnJobRunIndex m_fOnRunIndex;
+    void*              m_pArg;
+    size_t             m_Count;
+    size_t             m_Next;      // next item to execute, protected by the pool lock
+    size_t             m_ChunkSize; // item count executed between 2 locks
+} CSR_JobLoop;
+
+//---------------------------------------------------------------------------
+// Job private functions
+//---------------------------------------------------------------------------
+void csrJobPoolLock(CSR_JobPool* pPool)
+{
+    #ifdef _WIN32
+        EnterCriticalSection(&pPool->m_Lock);
+    #else
+        pthread_mutex_lock(&pPool->m_Lock);
+    #endif
+}
+//---------------------------------------------------------------------------
+void csrJobPoolUnlock(CSR_JobPool* pPool)
+{
+    #ifdef _WIN32
+        LeaveCriticalSection(&pPool->m_Lock);
+    #else
+        pthread_mutex_unlock(&pPool->m_Lock);
+    #endif
+}
+//---------------------------------------------------------------------------
+void csrJobPoolWaitJobAdded(CSR_JobPool* pPool)
+{
+    #ifdef _WIN32
+        SleepConditionVariableCS(&pPool->m_JobAdded, &pPool->m_Lock, INFINITE);
+    #else
+        pthread_cond_wait(&pPool->m_JobAdded, &pPool->m_Lock);
+    #endif
+}
+//---------------------------------------------------------------------------
+void csrJobPoolWaitJobDone(CSR_JobPool* pPool)
+{
+    #ifdef _WIN32
+        SleepConditionVariableCS(&pPool->m_JobDone, &pPool->m_Lock, INFINITE);
+    #else
+        pthread_cond_wait(&pPool->m_JobDone, &pPool->m_Lock);
+    #endif
+}
+//---------------------------------------------------------------------------
+void csrJobPoolNotifyJobAdded(CSR_JobPool* pPool, int all)
+{
+    #ifdef _WIN32
+        if (all)
+            WakeAllConditionVariable(&pPool->m_JobAdded);
+        else
+            WakeConditionVariable(&pPool->m_JobAdded);
+    #else
+        if (all)
+            pthread_cond_broadcast(&pPool->m_JobAdded);
+        else
+            pthread_cond_signal(&pPool->m_JobAdded);
+    #endif
+}
+//---------------------------------------------------------------------------
+void csrJobPoolNotifyJobDone(CSR_JobPool* pPool)
+{
+    #ifdef _WIN32
+        WakeAllConditionVariable(&pPool->m_JobDone);
+    #else
+        pthread_cond_broadcast(&pPool->m_JobDone);
+    #endif
+}
+//---------------------------------------------------------------------------
+void csrJobPoolExecute(CSR_JobPool* pPool, CSR_Job* pJob)
+{
+    // NOTE the pool should be locked when this function is called, and the job should be removed
+    // from the queue
+    pJob->m_State = CSR_JS_Running;
+
+    csrJobPoolUnlock(pPool);
+
+    // execute the job
+    if (pJob->m_fOnRun)
+        pJob->m_fOnRun(pJob->m_pArg);
+
+    csrJobPoolLock(pPool);
+
+    // from now the job may be released by its owner, it should no longer be accessed
+    pJob->m_State = CSR_JS_Done;
+    --pPool->m_PendingCount;
+
+    csrJobPoolNotifyJobDone(pPool);
+}
+//---------------------------------------------------------------------------
+void csrJobPoolWorker(CSR_JobPool* pPool)
+{
+    CSR_Job* pJob;
+
+    csrJobPoolLock(pPool);
+
+    for (;;)
+    {
+        // wait until a job is available
+        while (!pPool->m_pFirst && !pPool->m_Quit)
+            csrJobPoolWaitJobAdded(pPool);
+
+        // the queued jobs are always executed before quitting
+        if (!pPool->m_pFirst)
+            break;
+
+        // pop the next job
+        pJob             = pPool->m_pFirst;
+        pPool->m_pFirst  = pJob->m_pNext;
+        pJob->m_pNext    = 0;
+
+        if (!pPool->m_pFirst)
+            pPool->m_pLast = 0;
+
+        csrJobPoolExecute(pPool, pJob);
+    }
+
+    csrJobPoolUnlock(pPool);
+}
+//---------------------------------------------------------------------------
+#ifdef _WIN32
+    DWORD WINAPI csrJobPoolThread(LPVOID pArg)
+    {
+        csrJobPoolWorker((CSR_JobPool*)pArg);
+        return 0;
+    }
+#else
+    void* csrJobPoolThread(void* pArg)
+    {
+        csrJobPoolWorker((CSR_JobPool*)pArg);
+        return 0;
+    }
+#endif
+//---------------------------------------------------------------------------
+void csrJobLoopRun(void* pArg)
+{
+    CSR_JobLoop* pLoop = (CSR_JobLoop*)pArg;
+    size_t       start;
+    size_t       end;
+    size_t       i;
+
+    for (;;)
+    {
+        // reserve the next items to execute
+        if (pLoop->m_pPool)
+            csrJobPoolLock(pLoop->m_pPool);
+
+        start          = pLoop->m_Next;
+        pLoop->m_Next += pLoop->m_ChunkSize;
+
+        if (pLoop->m_pPool)
+            csrJobPoolUnlock(pLoop->m_pPool);
+
+        // no more item to execute?
+        if (start >= pLoop->m_Count)
+            return;
+
+        end = start + pLoop->m_ChunkSize;
+
+        if (end > pLoop->m_Count)
+            end = pLoop->m_Count;
+
+        // execute the items
+        for (i = start; i < end; ++i)
+            pLoop->m_fOnRunIndex(pLoop->m_pArg, i);
+    }
+}
+//---------------------------------------------------------------------------
+// Mutex functions
+//---------------------------------------------------------------------------
+CSR_Mutex* csrMutexCreate(void)
+{
+    // create the mutex
+    CSR_Mutex* pMutex = (CSR_Mutex*)malloc(sizeof(CSR_Mutex));
+
+    // succeeded?
+    if (!pMutex)
+        return 0;
+
+    // initialize the mutex
+    #ifdef _WIN32
+        InitializeCriticalSection(&pMutex->m_Lock);
+    #else
+        if (pthread_mutex_init(&pMutex->m_Lock, 0))
+        {
+            free(pMutex);
+            return 0;
+        }
+    #endif
+
+    return pMutex;
+}
+//---------------------------------------------------------------------------
+void csrMutexRelease(CSR_Mutex* pMutex)
+{
+    // no mutex to release?
+    if (!pMutex)
+        return;
+
+    #ifdef _WIN32
+        DeleteCriticalSection(&pMutex->m_Lock);
+    #else
+        pthread_mutex_destroy(&pMutex->m_Lock);
+    #endif
+
+    free(pMutex);
+}
+//---------------------------------------------------------------------------
+void csrMutexLock(CSR_Mutex* pMutex)
+{
+    // no mutex to lock?
+    if (!pMutex)
+        return;
+
+    #ifdef _WIN32
+        EnterCriticalSection(&pMutex->m_Lock);
+    #else
+        pthread_mutex_lock(&pMutex->m_Lock);
+    #endif
+}
+//---------------------------------------------------------------------------
+void csrMutexUnlock(CSR_Mutex* pMutex)
+{
+    // no mutex to unlock?
+    if (!pMutex)
+        return;
+
+    #ifdef _WIN32
+        LeaveCriticalSection(&pMutex->m_Lock);
+    #else
+        pthread_mutex_unlock(&pMutex->m_Lock);
+    #endif
+}
+//---------------------------------------------------------------------------
+// Job functions
+//---------------------------------------------------------------------------
+void csrJobInit(CSR_Job* pJob, CSR_fOnJobRun fOnRun, void* pArg)
+{
+    // no job to initialize?
+    if (!pJob)
+        return;
+
+    // initialize the job
+    pJob->m_fOnRun = fOnRun;
+    pJob->m_pArg   = pArg;
+    pJob->m_State  = CSR_JS_Idle;
+    pJob->m_pNext  = 0;
+}
+//---------------------------------------------------------------------------
+size_t csrJobGetProcessorCount(void)
+{
+    #ifdef _WIN32
+        SYSTEM_INFO info;
+
+        GetSystemInfo(&info);
+
+        if (!info.dwNumberOfProcessors)
+            return 1;
+
+        return (size_t)info.dwNumberOfProcessors;
+    #else
+        const long count = sysconf(_SC_NPROCESSORS_ONLN);
+
+        if (count < 1)
+            return 1;
+
+        return (size_t)count;
+    #endif
+}
+//---------------------------------------------------------------------------
+double csrJobGetTime(void)
+{
+    #ifdef _WIN32
+        LARGE_INTEGER frequency;
+        LARGE_INTEGER counter;
+
+        QueryPerformanceFrequency(&frequency);
+        QueryPerformanceCounter(&counter);
+
+        return ((double)counter.QuadPart * 1000.0) / (double)frequency.QuadPart;
+    #else
+        struct timespec now;
+
+        clock_gettime(CLOCK_MONOTONIC, &now);
+
+        return ((double)now.tv_sec * 1000.0) + ((double)now.tv_nsec / 1000000.0);
+    #endif
+}
+//---------------------------------------------------------------------------
+// Job pool functions
+//---------------------------------------------------------------------------
+CSR_JobPool* csrJobPoolCreate(size_t threadCount)
+{
+    CSR_JobPool* pPool;
+    size_t       i;
+
+    // use one thread per processor, except for the calling one
+    if (!threadCount)
+    {
+        threadCount = csrJobGetProcessorCount();
+
+        if (threadCount > 1)
+            --threadCount;
+    }
+
+    if (threadCount > M_CSR_Job_Max_Threads)
+        threadCount = M_CSR_Job_Max_Threads;
+
+    // create the job pool
+    pPool = (CSR_JobPool*)malloc(sizeof(CSR_JobPool));
+
+    // succeeded?
+    if (!pPool)
+        return 0;
+
+    pPool->m_ThreadCount  = 0;
+    pPool->m_pFirst       = 0;
+    pPool->m_pLast        = 0;
+    pPool->m_PendingCount = 0;
+    pPool->m_Quit         = 0;
+
+    // initialize the synchronization objects
+    #ifdef _WIN32
+        InitializeCriticalSection(&pPool->m_Lock);
+        InitializeConditionVariable(&pPool->m_JobAdded);
+        InitializeConditionVariable(&pPool->m_JobDone);
+    #else
+        pthread_mutex_init(&pPool->m_Lock,     0);
+        pthread_cond_init (&pPool->m_JobAdded, 0);
+        pthread_cond_init (&pPool->m_JobDone,  0);
+    #endif
+
+    // start the worker threads
+    for (i = 0; i < threadCount; ++i)
+    {
+        #ifdef _WIN32
+            pPool->m_Thread[i] = CreateThread(0, 0, csrJobPoolThread, pPool, 0, 0);
+
+            if (!pPool->m_Thread[i])
+                break;
+        #else
+            if (pthread_create(&pPool->m_Thread[i], 0, csrJobPoolThread, pPool))
+                break;
+        #endif
+
+        ++pPool->m_ThreadCount;
+    }
+
+    // no thread could be started?
+    if (!pPool->m_ThreadCount)
+    {
+        csrJobPoolRelease(pPool);
+        return 0;
+    }
+
+    return pPool;
+}
+//---------------------------------------------------------------------------
+void csrJobPoolRelease(CSR_JobPool* pPool)
+{
+    size_t i;
+
+    // no job pool to release?
+    if (!pPool)
+        return;
+
+    // notify the workers to quit, once the queued jobs are done
+    csrJobPoolLock(pPool);
+    pPool->m_Quit = 1;
+    csrJobPoolNotifyJobAdded(pPool, 1);
+    csrJobPoolUnlock(pPool);
+
+    // wait until the worker threads end
+    for (i = 0; i < pPool->m_ThreadCount; ++i)
+    {
+        #ifdef _WIN32
+            WaitForSingleObject(pPool->m_Thread[i], INFINITE);
+            CloseHandle(pPool->m_Thread[i]);
+        #else
+            pthread_join(pPool->m_Thread[i], 0);
+        #endif
+    }
+
+    // release the synchronization objects
+    #ifdef _WIN32
+        DeleteCriticalSection(&pPool->m_Lock);
+    #else
+        pthread_cond_destroy (&pPool->m_JobDone);
+        pthread_cond_destroy (&pPool->m_JobAdded);
+        pthread_mutex_destroy(&pPool->m_Lock);
+    #endif
+
+    free(pPool);
+}
+//---------------------------------------------------------------------------
+int csrJobPoolAdd(CSR_JobPool* pPool, CSR_Job* pJob)
+{
+    // validate the input
+    if (!pJob)
+        return 0;
+
+    // no job pool? Execute the job immediately
+    if (!pPool)
+    {
+        pJob->m_State = CSR_JS_Running;
+
+        if (pJob->m_fOnRun)
+            pJob->m_fOnRun(pJob->m_pArg);
+
+        pJob->m_State = CSR_JS_Done;
+        return 1;
+    }
+
+    csrJobPoolLock(pPool);
+
+    // queue the job
+    pJob->m_State = CSR_JS_Queued;
+    pJob->m_pNext = 0;
+
+    if (pPool->m_pLast)
+        pPool->m_pLast->m_pNext = pJob;
+    else
+        pPool->m_pFirst = pJob;
+
+    pPool->m_pLast = pJob;
+    ++pPool->m_PendingCount;
+
+    // wake up a worker
+    csrJobPoolNotifyJobAdded(pPool, 0);
+    csrJobPoolUnlock(pPool);
+
+    return 1;
+}
+//---------------------------------------------------------------------------
+CSR_EJobState csrJobPoolGetState(CSR_JobPool* pPool, const CSR_Job* pJob)
+{
+    CSR_EJobState state;
+
+    // validate the input
+    if (!pJob)
+        return CSR_JS_Idle;
+
+    // no job pool?
+    if (!pPool)
+        return pJob->m_State;
+
+    csrJobPoolLock(pPool);
+    state = pJob->m_State;
+    csrJobPoolUnlock(pPool);
+
+    return state;
+}
+//---------------------------------------------------------------------------
+void csrJobPoolWait(CSR_JobPool* pPool, CSR_Job* pJob)
+{
+    CSR_Job* pPrev;
+    CSR_Job* pCurrent;
+
+    // validate the inputs
+    if (!pPool || !pJob)
+        return;
+
+    csrJobPoolLock(pPool);
+
+    // job still queued? Execute it immediately instead of waiting for a worker
+    if (pJob->m_State == CSR_JS_Queued)
+    {
+        pPrev    = 0;
+        pCurrent = pPool->m_pFirst;
+
+        // search for the job in the queue
+        while (pCurrent && pCurrent != pJob)
+        {
+            pPrev    = pCurrent;
+            pCurrent = pCurrent->m_pNext;
+        }
+
+        // found it?
+        if (pCurrent)
+        {
+            // remove it from the queue
+            if (pPrev)
+                pPrev->m_pNext = pJob->m_pNext;
+            else
+                pPool->m_pFirst = pJob->m_pNext;
+
+            if (pPool->m_pLast == pJob)
+                pPool->m_pLast = pPrev;
+
+            pJob->m_pNext = 0;
+
+            csrJobPoolExecute(pPool, pJob);
+        }
+    }
+
+    // wait until the job is done
+    while (pJob->m_State == CSR_JS_Queued || pJob->m_State == CSR_JS_Running)
+        csrJobPoolWaitJobDone(pPool);
+
+    csrJobPoolUnlock(pPool);
+}
+//---------------------------------------------------------------------------
+void csrJobPoolWaitAll(CSR_JobPool* pPool)
+{
+    // no job pool?
+    if (!pPool)
+        return;
+
+    csrJobPoolLock(pPool);
+
+    // wait until the queue is empty and all the running jobs are done
+    while (pPool->m_PendingCount)
+        csrJobPoolWaitJobDone(pPool);
+
+    csrJobPoolUnlock(pPool);
+}
+//---------------------------------------------------------------------------
+void csrJobPoolParallelFor(CSR_JobPool*             pPool,
+                           size_t                   count,
+                           const CSR_fOnJobRunIndex fOnRunIndex,
+                           void*                    pArg)
+{
+    CSR_JobLoop loop;
+    CSR_Job     job[M_CSR_Job_Max_Threads];
+    size_t      helperCount;
+    size_t      i;
+
+    // validate the inputs
+    if (!count || !fOnRunIndex)
+        return;
+
+    loop.m_pPool       = pPool;
+    loop.m_fOnRunIndex = fOnRunIndex;
+    loop.m_pArg        = pArg;
+    loop.m_Count       = count;
+    loop.m_Next        = 0;
+    loop.m_ChunkSize   = 1;
+
+    // no job pool or nothing to share? Execute the loop in the calling thread
+    if (!pPool || count == 1)
+    {
+        loop.m_pPool     = 0;
+        loop.m_ChunkSize = count;
+        csrJobLoopRun(&loop);
+        return;
+    }
+
+    // one helper job per worker, without exceeding the item count
+    helperCount = pPool->m_ThreadCount;
+
+    if (helperCount > count - 1)
+        helperCount = count - 1;
+
+    // split the items in about 4 chunks per thread, to balance the load without locking too often
+    loop.m_ChunkSize = count / ((helperCount + 1) * 4);
+
+    if (!loop.m_ChunkSize)
+        loop.m_ChunkSize = 1;
+
+    // start the helpers
+    for (i = 0; i < helperCount; ++i)
+    {
+        csrJobInit(&job[i], csrJobLoopRun, &loop);
+        csrJobPoolAdd(pPool, &job[i]);
+    }
+
+    // the calling thread also executes the loop
+    csrJobLoopRun(&loop);
+
+    // wait until the helpers are done
+    for (i = 0; i < helperCount; ++i)
+        csrJobPoolWait(pPool, &job[i]);
+}
+//---------------------------------------------------------------------------
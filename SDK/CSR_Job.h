@@ -0,0 +1,258 @@
+/****************************************************************************
+ * ==> CSR_Job -------------------------------------------------------------*
+ ****************************************************************************
+ * Description : This module provides a portable job pool, which executes   *
+ *               jobs on worker threads                                     *
+ * Developer   : Jean-Milost Reymond                                        *
+ * Copyright   : 2017 - 2022, this file is part of the CompactStar Engine.  *
+ *               You are free to copy or redistribute this file, modify it, *
+ *               or use it for your own projects, commercial or not. This   *
+ *               file is provided "as is", WITHOUT ANY WARRANTY OF ANY      *
+ *               KIND. THE DEVELOPER IS NOT RESPONSIBLE FOR ANY DAMAGE OF   *
+ *               ANY KIND, ANY LOSS OF DATA, OR ANY LOSS OF PRODUCTIVITY    *
+ *               TIME THAT MAY RESULT FROM THE USAGE OF THIS SOURCE CODE,   *
+ *               DIRECTLY OR NOT.                                           *
+ ****************************************************************************/
+
+#ifndef CSR_JobH
+#define CSR_JobH
+
+// std
+#include <stddef.h>
+
+// threads
+#ifdef _WIN32
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #include <Windows.h>
+#else
+    #include <pthread.h>
+#endif
+
+// compactStar engine
+#include "CSR_Common.h"
+
+//---------------------------------------------------------------------------
+// Global defines
+//---------------------------------------------------------------------------
+#define M_CSR_Job_Max_Threads 64
+
+//---------------------------------------------------------------------------
+// Enumerators
+//---------------------------------------------------------------------------
+
+/**
+* Job state
+*/
+typedef enum
+{
+    CSR_JS_Idle = 0,
+    CSR_JS_Queued,
+    CSR_JS_Running,
+    CSR_JS_Done
+} CSR_EJobState;
+
+//---------------------------------------------------------------------------
+// Callbacks
+//---------------------------------------------------------------------------
+
+/**
+* Called when a job should be executed
+*@param pArg - job argument
+*/
+typedef void (*CSR_fOnJobRun)(void* pArg);
+
+/**
+* Called when an item of a parallel loop should be executed
+*@param pArg - loop argument
+*@param index - item index to execute
+*/
+typedef void (*CSR_fOnJobRunIndex)(void* pArg, size_t index);
+
+//---------------------------------------------------------------------------
+// Structures
+//---------------------------------------------------------------------------
+
+/**
+* Mutex
+*/
+typedef struct
+{
+    #ifdef _WIN32
+        CRITICAL_SECTION m_Lock;
+    #else
+        pthread_mutex_t  m_Lock;
+    #endif
+} CSR_Mutex;
+
+/**
+* Job
+*@note The job is owned by the caller, and should remain valid until it is done
+*/
+typedef struct CSR_Job
+{
+    CSR_fOnJobRun   m_fOnRun;
+    void*           m_pArg;
+    CSR_EJobState   m_State;  // should be read with csrJobPoolGetState() while the job is queued
+    struct CSR_Job* m_pNext;
+} CSR_Job;
+
+/**
+* Job pool
+*/
+typedef struct
+{
+    #ifdef _WIN32
+        HANDLE             m_Thread[M_CSR_Job_Max_Threads];
+        CRITICAL_SECTION   m_Lock;
+        CONDITION_VARIABLE m_JobAdded;
+        CONDITION_VARIABLE m_JobDone;
+    #else
+        pthread_t          m_Thread[M_CSR_Job_Max_Threads];
+        pthread_mutex_t    m_Lock;
+        pthread_cond_t     m_JobAdded;
+        pthread_cond_t     m_JobDone;
+    #endif
+    size_t                 m_ThreadCount;
+    CSR_Job*               m_pFirst;       // first queued job
+    CSR_Job*               m_pLast;        // last queued job
+    size_t                 m_PendingCount; // queued or running job count
+    int                    m_Quit;
+} CSR_JobPool;
+
+#ifdef __cplusplus
+    extern "C"
+    {
+#endif
+        //-------------------------------------------------------------------
+        // Mutex functions
+        //-------------------------------------------------------------------
+
+        /**
+        * Creates a mutex
+        *@return newly created mutex, 0 on error
+        *@note The mutex must be released when no longer used, see csrMutexRelease()
+        */
+        CSR_Mutex* csrMutexCreate(void);
+
+        /**
+        * Releases a mutex
+        *@param[in, out] pMutex - mutex to release
+        */
+        void csrMutexRelease(CSR_Mutex* pMutex);
+
+        /**
+        * Locks a mutex, waits until it is available
+        *@param[in, out] pMutex - mutex to lock
+        */
+        void csrMutexLock(CSR_Mutex* pMutex);
+
+        /**
+        * Unlocks a mutex
+        *@param[in, out] pMutex - mutex to unlock
+        */
+        void csrMutexUnlock(CSR_Mutex* pMutex);
+
+        //-------------------------------------------------------------------
+        // Job functions
+        //-------------------------------------------------------------------
+
+        /**
+        * Initializes a job structure
+        *@param[in, out] pJob - job to initialize
+        *@param fOnRun - function to execute
+        *@param pArg - argument to pass to the function
+        */
+        void csrJobInit(CSR_Job* pJob, CSR_fOnJobRun fOnRun, void* pArg);
+
+        /**
+        * Gets the logical processor count
+        *@return the logical processor count, at least 1
+        */
+        size_t csrJobGetProcessorCount(void);
+
+        /**
+        * Gets the time elapsed since an arbitrary moment, which never goes back
+        *@return the time, in milliseconds
+        *@note This function is thread safe, and may be used to measure the job durations
+        */
+        double csrJobGetTime(void);
+
+        //-------------------------------------------------------------------
+        // Job pool functions
+        //-------------------------------------------------------------------
+
+        /**
+        * Creates a job pool
+        *@param threadCount - worker thread count, if 0 one thread per processor except the calling one
+        *@return newly created job pool, 0 on error
+        *@note The job pool must be released when no longer used, see csrJobPoolRelease()
+        */
+        CSR_JobPool* csrJobPoolCreate(size_t threadCount);
+
+        /**
+        * Releases a job pool, waits until all its jobs are done
+        *@param[in, out] pPool - job pool to release
+        */
+        void csrJobPoolRelease(CSR_JobPool* pPool);
+
+        /**
+        * Adds a job to execute
+        *@param[in, out] pPool - job pool
+        *@param[in, out] pJob - job to add, should be initialized with csrJobInit()
+        *@return 1 on success, otherwise 0
+        *@note If no pool is available, the job is executed immediately in the calling thread
+        */
+        int csrJobPoolAdd(CSR_JobPool* pPool, CSR_Job* pJob);
+
+        /**
+        * Gets a job state
+        *@param pPool - job pool executing the job
+        *@param pJob - job for which the state should be get
+        *@return the job state
+        */
+        CSR_EJobState csrJobPoolGetState(CSR_JobPool* pPool, const CSR_Job* pJob);
+
+        /**
+        * Waits until a job is done
+        *@param[in, out] pPool - job pool executing the job
+        *@param[in, out] pJob - job to wait
+        *@note If the job is still queued, it is executed immediately in the calling thread
+        */
+        void csrJobPoolWait(CSR_JobPool* pPool, CSR_Job* pJob);
+
+        /**
+        * Waits until all the jobs are done
+        *@param[in, out] pPool - job pool
+        */
+        void csrJobPoolWaitAll(CSR_JobPool* pPool);
+
+        /**
+        * Executes a parallel loop
+        *@param[in, out] pPool - job pool, if 0 the loop is executed in the calling thread
+        *@param count - item count to execute
+        *@param fOnRunIndex - function to execute for each item
+        *@param pArg - argument to pass to the function
+        *@note The calling thread also executes items, and the function returns when all the items
+        *      are done. The items are executed in an undefined order, thus they should be independent
+        */
+        void csrJobPoolParallelFor(CSR_JobPool*             pPool,
+                                   size_t                   count,
+                                   const CSR_fOnJobRunIndex fOnRunIndex,
+                                   void*                    pArg);
+
+#ifdef __cplusplus
+    }
+#endif
+
+//---------------------------------------------------------------------------
+// Compiler
+//---------------------------------------------------------------------------
+
+// needed in mobile c compiler to link the .h file with the .c
+#if defined(_OS_IOS_) || defined(_OS_ANDROID_) || defined(_OS_WINDOWS_)
+    #include "CSR_Job.c"
+#endif
+
+#endif
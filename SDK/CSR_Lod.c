@@ -0,0 +1,1127 @@
+/****************************************************************************
+ * ==> CSR_Lod -------------------------------------------------------------*
+ ****************************************************************************
+ * Description : This module provides the level of detail functions, i.e.  *
+ *               a mesh simplifier and a screen size based level selection  *
+ * Developer   : Jean-Milost Reymond                                        *
+ * Copyright   : 2017 - 2022, this file is part of the CompactStar Engine.  *
+ *               You are free to copy or redistribute this file, modify it, *
+ *               or use it for your own projects, commercial or not. This   *
+ *               file is provided "as is", WITHOUT ANY WARRANTY OF ANY      *
+ *               KIND. THE DEVELOPER IS NOT RESPONSIBLE FOR ANY DAMAGE OF   *
+ *               ANY KIND, ANY LOSS OF DATA, OR ANY LOSS OF PRODUCTIVITY    *
+ *               TIME THAT MAY RESULT FROM THE USAGE OF THIS SOURCE CODE,   *
+ *               DIRECTLY OR NOT.                                           *
+ ****************************************************************************/
+
+#include "CSR_Lod.h"
+
+// std
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+//---------------------------------------------------------------------------
+// Global defines
+//---------------------------------------------------------------------------
+#define M_CSR_LOD_Border_Weight 1000.0
+#ifdef CSR_USE_METAL
+    #define M_CSR_LOD_Normal_Offset 4
+#else
+    #define M_CSR_LOD_Normal_Offset 3
+#endif
+
+//---------------------------------------------------------------------------
+// Private structures
+//---------------------------------------------------------------------------
+
+/**
+* Symmetric 4x4 error quadric, stored as a2, ab, ac, ad, b2, bc, bd, c2, cd, d2
+*/
+typedef struct
+{
+    double m_Value[10];
+} CSR_LODQuadric;
+
+/**
+* Edge collapse candidate
+*/
+typedef struct
+{
+    size_t m_Keep;   // vertex kept by the collapse
+    size_t m_Remove; // vertex removed by the collapse
+    int    m_Mid;    // if 1, the kept vertex moves to the edge middle
+    double m_Cost;
+} CSR_LODEdge;
+
+/**
+* Adjacency edge, used to find the borders
+*/
+typedef struct
+{
+    size_t m_V1;
+    size_t m_V2;
+    size_t m_Triangle;
+} CSR_LODAdjEdge;
+
+/**
+* Simplification working memory
+*/
+typedef struct
+{
+    size_t*         m_pTri;      // welded triangle indices
+    size_t*         m_pTable;    // vertex hash table
+    size_t*         m_pPosTable; // position hash table
+    size_t*         m_pAdjStart; // first adjacent triangle of each vertex
+    size_t*         m_pAdj;      // vertex adjacent triangles
+    float*          m_pVertex;   // welded vertices
+    char*           m_pAlive;    // whether or not each triangle still exists
+    char*           m_pLocked;   // whether or not each vertex is locked
+    char*           m_pTouched;  // whether or not each vertex was modified in the current pass
+    CSR_LODQuadric* m_pQuadric;
+    CSR_LODAdjEdge* m_pAdjEdge;
+    CSR_LODEdge*    m_pEdge;
+} CSR_LODWorkspace;
+
+//---------------------------------------------------------------------------
+// Mesh simplification private functions
+//---------------------------------------------------------------------------
+void csrLODQuadricAddPlane(CSR_LODQuadric* pQ, double a, double b, double c, double d, double weight)
+{
+    pQ->m_Value[0] += weight * a * a;
+    pQ->m_Value[1] += weight * a * b;
+    pQ->m_Value[2] += weight * a * c;
+    pQ->m_Value[3] += weight * a * d;
+    pQ->m_Value[4] += weight * b * b;
+    pQ->m_Value[5] += weight * b * c;
+    pQ->m_Value[6] += weight * b * d;
+    pQ->m_Value[7] += weight * c * c;
+    pQ->m_Value[8] += weight * c * d;
+    pQ->m_Value[9] += weight * d * d;
+}
+//---------------------------------------------------------------------------
+double csrLODQuadricError(const CSR_LODQuadric* pQ1, const CSR_LODQuadric* pQ2, const float* pP)
+{
+    const double x = pP[0];
+    const double y = pP[1];
+    const double z = pP[2];
+          double q[10];
+          size_t i;
+
+    for (i = 0; i < 10; ++i)
+        q[i] = pQ1->m_Value[i] + pQ2->m_Value[i];
+
+    return        q[0] * x * x + 2.0 * q[1] * x * y + 2.0 * q[2] * x * z + 2.0 * q[3] * x
+           +      q[4] * y * y + 2.0 * q[5] * y * z + 2.0 * q[6] * y
+           +      q[7] * z * z + 2.0 * q[8] * z
+           +      q[9];
+}
+//---------------------------------------------------------------------------
+void csrLODTriangleNormal(const float* pP1, const float* pP2, const float* pP3, CSR_Vector3* pN)
+{
+    CSR_Vector3 e1;
+    CSR_Vector3 e2;
+
+    e1.m_X = pP2[0] - pP1[0];
+    e1.m_Y = pP2[1] - pP1[1];
+    e1.m_Z = pP2[2] - pP1[2];
+    e2.m_X = pP3[0] - pP1[0];
+    e2.m_Y = pP3[1] - pP1[1];
+    e2.m_Z = pP3[2] - pP1[2];
+
+    csrVec3Cross(&e1, &e2, pN);
+}
+//---------------------------------------------------------------------------
+size_t csrLODHashVertex(const float* pVertex, size_t size)
+{
+    const unsigned char* pByte = (const unsigned char*)pVertex;
+          size_t         hash  = 2166136261u;
+          size_t         i;
+
+    // FNV-1a hash
+    for (i = 0; i < size; ++i)
+    {
+        hash ^= pByte[i];
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+//---------------------------------------------------------------------------
+int csrLODCompareAdjEdge(const void* pA, const void* pB)
+{
+    const CSR_LODAdjEdge* pE1 = (const CSR_LODAdjEdge*)pA;
+    const CSR_LODAdjEdge* pE2 = (const CSR_LODAdjEdge*)pB;
+
+    if (pE1->m_V1 != pE2->m_V1)
+        return pE1->m_V1 < pE2->m_V1 ? -1 : 1;
+
+    if (pE1->m_V2 != pE2->m_V2)
+        return pE1->m_V2 < pE2->m_V2 ? -1 : 1;
+
+    return 0;
+}
+//---------------------------------------------------------------------------
+int csrLODCompareEdgeCost(const void* pA, const void* pB)
+{
+    const CSR_LODEdge* pE1 = (const CSR_LODEdge*)pA;
+    const CSR_LODEdge* pE2 = (const CSR_LODEdge*)pB;
+
+    if (pE1->m_Cost < pE2->m_Cost)
+        return -1;
+
+    if (pE1->m_Cost > pE2->m_Cost)
+        return 1;
+
+    return 0;
+}
+//---------------------------------------------------------------------------
+void csrLODWorkspaceInit(CSR_LODWorkspace* pWS)
+{
+    pWS->m_pTri      = 0;
+    pWS->m_pTable    = 0;
+    pWS->m_pPosTable = 0;
+    pWS->m_pAdjStart = 0;
+    pWS->m_pAdj      = 0;
+    pWS->m_pVertex   = 0;
+    pWS->m_pAlive    = 0;
+    pWS->m_pLocked   = 0;
+    pWS->m_pTouched  = 0;
+    pWS->m_pQuadric  = 0;
+    pWS->m_pAdjEdge  = 0;
+    pWS->m_pEdge     = 0;
+}
+//---------------------------------------------------------------------------
+void csrLODWorkspaceRelease(CSR_LODWorkspace* pWS)
+{
+    // free() accepts null pointers
+    free(pWS->m_pTri);
+    free(pWS->m_pTable);
+    free(pWS->m_pPosTable);
+    free(pWS->m_pAdjStart);
+    free(pWS->m_pAdj);
+    free(pWS->m_pVertex);
+    free(pWS->m_pAlive);
+    free(pWS->m_pLocked);
+    free(pWS->m_pTouched);
+    free(pWS->m_pQuadric);
+    free(pWS->m_pAdjEdge);
+    free(pWS->m_pEdge);
+}
+//---------------------------------------------------------------------------
+char* csrLODCopyFileName(const char* pFileName)
+{
+    char*  pCopy;
+    size_t length;
+
+    if (!pFileName)
+        return 0;
+
+    length = strlen(pFileName);
+    pCopy  = (char*)malloc(length + 1);
+
+    if (pCopy)
+        memcpy(pCopy, pFileName, length + 1);
+
+    return pCopy;
+}
+//---------------------------------------------------------------------------
+int csrLODCopyVertexBuffer(const CSR_VertexBuffer* pSrc, CSR_VertexBuffer* pDst)
+{
+    *pDst         = *pSrc;
+    pDst->m_pData = 0;
+
+    if (!pSrc->m_Count)
+        return 1;
+
+    pDst->m_pData = (float*)malloc(pSrc->m_Count * sizeof(float));
+
+    if (!pDst->m_pData)
+        return 0;
+
+    memcpy(pDst->m_pData, pSrc->m_pData, pSrc->m_Count * sizeof(float));
+
+    return 1;
+}
+//---------------------------------------------------------------------------
+int csrLODSimplifyVertexBuffer(const CSR_VertexBuffer* pSrc, float ratio, CSR_VertexBuffer* pDst)
+{
+    const size_t           stride      = pSrc->m_Format.m_Stride;
+    const size_t           vertexCount = stride ? pSrc->m_Count / stride : 0;
+          size_t           triCount    = 0;
+          size_t           vertCount   = 0;
+          size_t           aliveCount;
+          size_t           target;
+          size_t           tableSize;
+          size_t           edgeCount;
+          size_t           i;
+          size_t           j;
+          size_t           k;
+          CSR_LODWorkspace ws;
+
+    // get the triangle count to simplify
+    if (vertexCount >= 3)
+        switch (pSrc->m_Format.m_Type)
+        {
+            case CSR_VT_Triangles:     triCount = vertexCount / 3; break;
+            case CSR_VT_TriangleStrip:
+            case CSR_VT_TriangleFan:   triCount = vertexCount - 2; break;
+            default:                                               break;
+        }
+
+    // nothing to simplify? (e.g. quads, or not enough triangles)
+    if (triCount < 2 || ratio >= 1.0f)
+        return csrLODCopyVertexBuffer(pSrc, pDst);
+
+    // allocate the working memory
+    csrLODWorkspaceInit(&ws);
+
+    for (tableSize = 16; tableSize < vertexCount * 2; tableSize <<= 1);
+
+    ws.m_pTri      = (size_t*)malloc(triCount * 3 * sizeof(size_t));
+    ws.m_pTable    = (size_t*)malloc(tableSize * sizeof(size_t));
+    ws.m_pPosTable = (size_t*)malloc(tableSize * sizeof(size_t));
+    ws.m_pVertex   = (float*) malloc(vertexCount * stride * sizeof(float));
+    ws.m_pAlive    = (char*)  malloc(triCount);
+    ws.m_pAdjEdge  = (CSR_LODAdjEdge*)malloc(triCount * 3 * sizeof(CSR_LODAdjEdge));
+    ws.m_pEdge     = (CSR_LODEdge*)   malloc(triCount * 3 * sizeof(CSR_LODEdge));
+    ws.m_pAdjStart = (size_t*)malloc((vertexCount + 1) * sizeof(size_t));
+    ws.m_pAdj      = (size_t*)malloc(triCount * 3 * sizeof(size_t));
+
+    if (!ws.m_pTri || !ws.m_pTable || !ws.m_pPosTable || !ws.m_pVertex || !ws.m_pAlive || !ws.m_pAdjEdge || !ws.m_pEdge || !ws.m_pAdjStart || !ws.m_pAdj)
+        {
+            csrLODWorkspaceRelease(&ws);
+            return 0;
+        }
+
+    for (i = 0; i < tableSize; ++i)
+    {
+        ws.m_pTable[i]    = M_CSR_Unknown_Index;
+        ws.m_pPosTable[i] = M_CSR_Unknown_Index;
+    }
+
+    // weld the identical vertices and build the indexed triangles
+    for (i = 0; i < triCount; ++i)
+    {
+        size_t src[3];
+
+        switch (pSrc->m_Format.m_Type)
+        {
+            case CSR_VT_Triangles:
+                src[0] = i * 3;
+                src[1] = i * 3 + 1;
+                src[2] = i * 3 + 2;
+                break;
+
+            case CSR_VT_TriangleStrip:
+                // odd triangles have an inverted winding
+                src[0] = (i & 1) ? i + 1 : i;
+                src[1] = (i & 1) ? i     : i + 1;
+                src[2] = i + 2;
+                break;
+
+            default:
+                src[0] = 0;
+                src[1] = i + 1;
+                src[2] = i + 2;
+                break;
+        }
+
+        for (j = 0; j < 3; ++j)
+        {
+            const float* pSrcVertex = &pSrc->m_pData[src[j] * stride];
+                  size_t slot       = csrLODHashVertex(pSrcVertex, stride * sizeof(float)) & (tableSize - 1);
+
+            // search for an identical vertex
+            while (ws.m_pTable[slot] != (size_t)M_CSR_Unknown_Index &&
+                   memcmp(&ws.m_pVertex[ws.m_pTable[slot] * stride], pSrcVertex, stride * sizeof(float)))
+                slot = (slot + 1) & (tableSize - 1);
+
+            // not found? Add it
+            if (ws.m_pTable[slot] == (size_t)M_CSR_Unknown_Index)
+            {
+                memcpy(&ws.m_pVertex[vertCount * stride], pSrcVertex, stride * sizeof(float));
+                ws.m_pTable[slot] = vertCount;
+                ++vertCount;
+            }
+
+            ws.m_pTri[i * 3 + j] = ws.m_pTable[slot];
+        }
+    }
+
+    ws.m_pQuadric = (CSR_LODQuadric*)calloc(vertCount, sizeof(CSR_LODQuadric));
+    ws.m_pLocked  = (char*)calloc(vertCount, 1);
+    ws.m_pTouched = (char*)malloc(vertCount);
+
+    if (!ws.m_pQuadric || !ws.m_pLocked || !ws.m_pTouched)
+        {
+            csrLODWorkspaceRelease(&ws);
+            return 0;
+        }
+
+    // lock the vertices sharing their position with another vertex (UV seams, hard edges, ...),
+    // otherwise the simplification would open cracks between both sides
+    for (i = 0; i < vertCount; ++i)
+    {
+        size_t slot = csrLODHashVertex(&ws.m_pVertex[i * stride], 3 * sizeof(float)) & (tableSize - 1);
+
+        while (ws.m_pPosTable[slot] != (size_t)M_CSR_Unknown_Index &&
+               memcmp(&ws.m_pVertex[ws.m_pPosTable[slot] * stride], &ws.m_pVertex[i * stride], 3 * sizeof(float)))
+            slot = (slot + 1) & (tableSize - 1);
+
+        if (ws.m_pPosTable[slot] == (size_t)M_CSR_Unknown_Index)
+            ws.m_pPosTable[slot] = i;
+        else
+        {
+            ws.m_pLocked[i]                    = 1;
+            ws.m_pLocked[ws.m_pPosTable[slot]] = 1;
+        }
+    }
+
+    aliveCount = 0;
+
+    // calculate the vertex quadrics from their surrounding triangle planes
+    for (i = 0; i < triCount; ++i)
+    {
+        const size_t*     pT = &ws.m_pTri[i * 3];
+              CSR_Vector3 n;
+              float       length;
+
+        // remove the already degenerated triangles
+        if (pT[0] == pT[1] || pT[1] == pT[2] || pT[0] == pT[2])
+        {
+            ws.m_pAlive[i] = 0;
+            continue;
+        }
+
+        ws.m_pAlive[i] = 1;
+        ++aliveCount;
+
+        csrLODTriangleNormal(&ws.m_pVertex[pT[0] * stride], &ws.m_pVertex[pT[1] * stride], &ws.m_pVertex[pT[2] * stride], &n);
+        csrVec3Length(&n, &length);
+
+        if (length <= 0.0f)
+            continue;
+
+        // the quadric is weighted by the triangle area
+        for (j = 0; j < 3; ++j)
+        {
+            const float* pP = &ws.m_pVertex[pT[0] * stride];
+
+            csrLODQuadricAddPlane(&ws.m_pQuadric[pT[j]],
+                                   n.m_X / length,
+                                   n.m_Y / length,
+                                   n.m_Z / length,
+                                 -(n.m_X * pP[0] + n.m_Y * pP[1] + n.m_Z * pP[2]) / length,
+                                   length * 0.5);
+        }
+    }
+
+    // find the border edges, i.e. the edges belonging to only one triangle
+    edgeCount = 0;
+
+    for (i = 0; i < triCount; ++i)
+        if (ws.m_pAlive[i])
+            for (j = 0; j < 3; ++j)
+            {
+                const size_t v1 = ws.m_pTri[i * 3 + j];
+                const size_t v2 = ws.m_pTri[i * 3 + ((j + 1) % 3)];
+
+                ws.m_pAdjEdge[edgeCount].m_V1       = v1 < v2 ? v1 : v2;
+                ws.m_pAdjEdge[edgeCount].m_V2       = v1 < v2 ? v2 : v1;
+                ws.m_pAdjEdge[edgeCount].m_Triangle = i;
+                ++edgeCount;
+            }
+
+    qsort(ws.m_pAdjEdge, edgeCount, sizeof(CSR_LODAdjEdge), csrLODCompareAdjEdge);
+
+    for (i = 0; i < edgeCount; i = j)
+    {
+        for (j = i + 1; j < edgeCount && !csrLODCompareAdjEdge(&ws.m_pAdjEdge[i], &ws.m_pAdjEdge[j]); ++j);
+
+        // border edge? Add a perpendicular plane to keep the vertices on the border
+        if (j - i == 1)
+        {
+            const size_t*     pT = &ws.m_pTri[ws.m_pAdjEdge[i].m_Triangle * 3];
+            const float*      pA = &ws.m_pVertex[ws.m_pAdjEdge[i].m_V1 * stride];
+            const float*      pB = &ws.m_pVertex[ws.m_pAdjEdge[i].m_V2 * stride];
+                  CSR_Vector3 n;
+                  CSR_Vector3 dir;
+                  CSR_Vector3 borderN;
+                  float       lengthSq;
+
+            csrLODTriangleNormal(&ws.m_pVertex[pT[0] * stride], &ws.m_pVertex[pT[1] * stride], &ws.m_pVertex[pT[2] * stride], &n);
+
+            dir.m_X  = pB[0] - pA[0];
+            dir.m_Y  = pB[1] - pA[1];
+            dir.m_Z  = pB[2] - pA[2];
+            csrVec3Dot(&dir, &dir, &lengthSq);
+
+            csrVec3Cross(&dir, &n, &borderN);
+            csrVec3Normalize(&borderN, &borderN);
+
+            for (k = 0; k < 2; ++k)
+                csrLODQuadricAddPlane(&ws.m_pQuadric[k ? ws.m_pAdjEdge[i].m_V2 : ws.m_pAdjEdge[i].m_V1],
+                                       borderN.m_X,
+                                       borderN.m_Y,
+                                       borderN.m_Z,
+                                     -(borderN.m_X * pA[0] + borderN.m_Y * pA[1] + borderN.m_Z * pA[2]),
+                                       lengthSq * M_CSR_LOD_Border_Weight);
+        }
+    }
+
+    // calculate the triangle count to reach
+    target = (size_t)(triCount * ratio);
+
+    if (target < 1)
+        target = 1;
+
+    // collapse the cheapest edges, pass after pass, until the target is reached. Each pass
+    // collapses a set of independent edges, thus the costs are recalculated between passes
+    while (aliveCount > target)
+    {
+        size_t collapsed = 0;
+
+        // build the unique edges of the remaining triangles
+        edgeCount = 0;
+
+        for (i = 0; i < triCount; ++i)
+            if (ws.m_pAlive[i])
+                for (j = 0; j < 3; ++j)
+                {
+                    const size_t v1 = ws.m_pTri[i * 3 + j];
+                    const size_t v2 = ws.m_pTri[i * 3 + ((j + 1) % 3)];
+
+                    ws.m_pAdjEdge[edgeCount].m_V1       = v1 < v2 ? v1 : v2;
+                    ws.m_pAdjEdge[edgeCount].m_V2       = v1 < v2 ? v2 : v1;
+                    ws.m_pAdjEdge[edgeCount].m_Triangle = i;
+                    ++edgeCount;
+                }
+
+        qsort(ws.m_pAdjEdge, edgeCount, sizeof(CSR_LODAdjEdge), csrLODCompareAdjEdge);
+
+        // calculate the collapse cost of each edge
+        for (i = 0, k = 0; i < edgeCount; i = j)
+        {
+            const size_t v1 = ws.m_pAdjEdge[i].m_V1;
+            const size_t v2 = ws.m_pAdjEdge[i].m_V2;
+
+            for (j = i + 1; j < edgeCount && !csrLODCompareAdjEdge(&ws.m_pAdjEdge[i], &ws.m_pAdjEdge[j]); ++j);
+
+            // a locked vertex can neither be removed nor moved
+            if (ws.m_pLocked[v1] && ws.m_pLocked[v2])
+                continue;
+
+            if (ws.m_pLocked[v1] || ws.m_pLocked[v2])
+            {
+                ws.m_pEdge[k].m_Keep   = ws.m_pLocked[v1] ? v1 : v2;
+                ws.m_pEdge[k].m_Remove = ws.m_pLocked[v1] ? v2 : v1;
+                ws.m_pEdge[k].m_Mid    = 0;
+                ws.m_pEdge[k].m_Cost   = csrLODQuadricError(&ws.m_pQuadric[v1], &ws.m_pQuadric[v2], &ws.m_pVertex[ws.m_pEdge[k].m_Keep * stride]);
+            }
+            else
+            {
+                const float* pA = &ws.m_pVertex[v1 * stride];
+                const float* pB = &ws.m_pVertex[v2 * stride];
+                      float  mid[3];
+                      double costA;
+                      double costB;
+                      double costMid;
+
+                mid[0] = (pA[0] + pB[0]) * 0.5f;
+                mid[1] = (pA[1] + pB[1]) * 0.5f;
+                mid[2] = (pA[2] + pB[2]) * 0.5f;
+
+                costA   = csrLODQuadricError(&ws.m_pQuadric[v1], &ws.m_pQuadric[v2], pA);
+                costB   = csrLODQuadricError(&ws.m_pQuadric[v1], &ws.m_pQuadric[v2], pB);
+                costMid = csrLODQuadricError(&ws.m_pQuadric[v1], &ws.m_pQuadric[v2], mid);
+
+                // select the position minimizing the error
+                if (costMid < costA && costMid < costB)
+                {
+                    ws.m_pEdge[k].m_Keep   = v1;
+                    ws.m_pEdge[k].m_Remove = v2;
+                    ws.m_pEdge[k].m_Mid    = 1;
+                    ws.m_pEdge[k].m_Cost   = costMid;
+                }
+                else
+                {
+                    ws.m_pEdge[k].m_Keep   = costA <= costB ? v1 : v2;
+                    ws.m_pEdge[k].m_Remove = costA <= costB ? v2 : v1;
+                    ws.m_pEdge[k].m_Mid    = 0;
+                    ws.m_pEdge[k].m_Cost   = costA <= costB ? costA : costB;
+                }
+            }
+
+            ++k;
+        }
+
+        edgeCount = k;
+
+        qsort(ws.m_pEdge, edgeCount, sizeof(CSR_LODEdge), csrLODCompareEdgeCost);
+
+        // build the vertex to triangle adjacency
+        memset(ws.m_pAdjStart, 0, (vertCount + 1) * sizeof(size_t));
+
+        for (i = 0; i < triCount; ++i)
+            if (ws.m_pAlive[i])
+                for (j = 0; j < 3; ++j)
+                    ++ws.m_pAdjStart[ws.m_pTri[i * 3 + j] + 1];
+
+        for (i = 0; i < vertCount; ++i)
+            ws.m_pAdjStart[i + 1] += ws.m_pAdjStart[i];
+
+        for (i = 0; i < triCount; ++i)
+            if (ws.m_pAlive[i])
+                for (j = 0; j < 3; ++j)
+                    ws.m_pAdj[ws.m_pAdjStart[ws.m_pTri[i * 3 + j]]++] = i;
+
+        // restore the start offsets, shifted by the fill
+        for (i = vertCount; i > 0; --i)
+            ws.m_pAdjStart[i] = ws.m_pAdjStart[i - 1];
+
+        ws.m_pAdjStart[0] = 0;
+
+        memset(ws.m_pTouched, 0, vertCount);
+
+        // collapse the edges, cheapest first
+        for (i = 0; i < edgeCount && aliveCount > target; ++i)
+        {
+            const size_t keep   = ws.m_pEdge[i].m_Keep;
+            const size_t remove = ws.m_pEdge[i].m_Remove;
+                  float  newPos[3];
+                  int    flipped = 0;
+
+            // an edge touching a vertex already modified in this pass will be processed in the next one
+            if (ws.m_pTouched[keep] || ws.m_pTouched[remove])
+                continue;
+
+            if (ws.m_pEdge[i].m_Mid)
+            {
+                newPos[0] = (ws.m_pVertex[keep * stride]     + ws.m_pVertex[remove * stride])     * 0.5f;
+                newPos[1] = (ws.m_pVertex[keep * stride + 1] + ws.m_pVertex[remove * stride + 1]) * 0.5f;
+                newPos[2] = (ws.m_pVertex[keep * stride + 2] + ws.m_pVertex[remove * stride + 2]) * 0.5f;
+            }
+            else
+                memcpy(newPos, &ws.m_pVertex[keep * stride], sizeof(newPos));
+
+            // check that no surrounding triangle would flip
+            for (k = 0; k < 2 && !flipped; ++k)
+            {
+                const size_t v = k ? remove : keep;
+
+                for (j = ws.m_pAdjStart[v]; j < ws.m_pAdjStart[v + 1] && !flipped; ++j)
+                {
+                    const size_t*     pT = &ws.m_pTri[ws.m_pAdj[j] * 3];
+                    const float*      pP[3];
+                          CSR_Vector3 oldN;
+                          CSR_Vector3 newN;
+                          float       dot;
+                          size_t      l;
+
+                    // skip the dead triangles and the triangles which will disappear
+                    if (!ws.m_pAlive[ws.m_pAdj[j]])
+                        continue;
+
+                    if ((pT[0] == keep   || pT[1] == keep   || pT[2] == keep) &&
+                        (pT[0] == remove || pT[1] == remove || pT[2] == remove))
+                        continue;
+
+                    for (l = 0; l < 3; ++l)
+                        pP[l] = (pT[l] == v) ? newPos : &ws.m_pVertex[pT[l] * stride];
+
+                    csrLODTriangleNormal(&ws.m_pVertex[pT[0] * stride], &ws.m_pVertex[pT[1] * stride], &ws.m_pVertex[pT[2] * stride], &oldN);
+                    csrLODTriangleNormal(pP[0], pP[1], pP[2], &newN);
+                    csrVec3Dot(&oldN, &newN, &dot);
+
+                    if (dot <= 0.0f)
+                        flipped = 1;
+                }
+            }
+
+            if (flipped)
+                continue;
+
+            // move the kept vertex, interpolating its attributes if it moves to the middle
+            if (ws.m_pEdge[i].m_Mid)
+            {
+                for (j = 0; j < stride; ++j)
+                    ws.m_pVertex[keep * stride + j] = (ws.m_pVertex[keep * stride + j] + ws.m_pVertex[remove * stride + j]) * 0.5f;
+
+                if (pSrc->m_Format.m_HasNormal)
+                {
+                    CSR_Vector3 normal;
+
+                    normal.m_X = ws.m_pVertex[keep * stride + M_CSR_LOD_Normal_Offset];
+                    normal.m_Y = ws.m_pVertex[keep * stride + M_CSR_LOD_Normal_Offset + 1];
+                    normal.m_Z = ws.m_pVertex[keep * stride + M_CSR_LOD_Normal_Offset + 2];
+
+                    csrVec3Normalize(&normal, &normal);
+
+                    ws.m_pVertex[keep * stride + M_CSR_LOD_Normal_Offset]     = normal.m_X;
+                    ws.m_pVertex[keep * stride + M_CSR_LOD_Normal_Offset + 1] = normal.m_Y;
+                    ws.m_pVertex[keep * stride + M_CSR_LOD_Normal_Offset + 2] = normal.m_Z;
+                }
+            }
+
+            for (j = 0; j < 10; ++j)
+                ws.m_pQuadric[keep].m_Value[j] += ws.m_pQuadric[remove].m_Value[j];
+
+            // replace the removed vertex in its triangles, and remove the degenerated ones
+            for (j = ws.m_pAdjStart[remove]; j < ws.m_pAdjStart[remove + 1]; ++j)
+            {
+                size_t* pT = &ws.m_pTri[ws.m_pAdj[j] * 3];
+
+                if (!ws.m_pAlive[ws.m_pAdj[j]])
+                    continue;
+
+                if (pT[0] == keep || pT[1] == keep || pT[2] == keep)
+                {
+                    ws.m_pAlive[ws.m_pAdj[j]] = 0;
+                    --aliveCount;
+                    continue;
+                }
+
+                for (k = 0; k < 3; ++k)
+                    if (pT[k] == remove)
+                        pT[k] = keep;
+            }
+
+            ws.m_pTouched[keep]   = 1;
+            ws.m_pTouched[remove] = 1;
+            ++collapsed;
+        }
+
+        // no more edge can be collapsed?
+        if (!collapsed)
+            break;
+    }
+
+    // build the simplified vertex buffer
+    *pDst                  = *pSrc;
+    pDst->m_Format.m_Type  = CSR_VT_Triangles;
+    pDst->m_Count          = aliveCount * 3 * stride;
+    pDst->m_pData          = (float*)malloc(pDst->m_Count * sizeof(float));
+
+    if (!pDst->m_pData)
+    {
+        pDst->m_Count = 0;
+        csrLODWorkspaceRelease(&ws);
+        return 0;
+    }
+
+    for (i = 0, k = 0; i < triCount; ++i)
+        if (ws.m_pAlive[i])
+            for (j = 0; j < 3; ++j, ++k)
+                memcpy(&pDst->m_pData[k * stride], &ws.m_pVertex[ws.m_pTri[i * 3 + j] * stride], stride * sizeof(float));
+
+    csrLODWorkspaceRelease(&ws);
+
+    return 1;
+}
+//---------------------------------------------------------------------------
+// Mesh simplification functions
+//---------------------------------------------------------------------------
+int csrLODSimplify(const CSR_Mesh* pMesh, float ratio, CSR_Mesh* pResult)
+{
+    size_t i;
+
+    // validate the inputs
+    if (!pMesh || !pResult || ratio <= 0.0f)
+        return 0;
+
+    pResult->m_Time = pMesh->m_Time;
+
+    // copy the skin texture file names, the textures remain linked to the source skin
+    pResult->m_Skin.m_Time                = pMesh->m_Skin.m_Time;
+    pResult->m_Skin.m_Texture.m_pFileName = csrLODCopyFileName(pMesh->m_Skin.m_Texture.m_pFileName);
+    pResult->m_Skin.m_BumpMap.m_pFileName = csrLODCopyFileName(pMesh->m_Skin.m_BumpMap.m_pFileName);
+    pResult->m_Skin.m_CubeMap.m_pFileName = csrLODCopyFileName(pMesh->m_Skin.m_CubeMap.m_pFileName);
+
+    if (!pMesh->m_Count)
+        return 1;
+
+    // create the simplified vertex buffers
+    pResult->m_pVB = (CSR_VertexBuffer*)malloc(pMesh->m_Count * sizeof(CSR_VertexBuffer));
+
+    if (!pResult->m_pVB)
+        return 0;
+
+    for (i = 0; i < pMesh->m_Count; ++i)
+    {
+        csrVertexBufferInit(&pResult->m_pVB[i]);
+
+        if (!csrLODSimplifyVertexBuffer(&pMesh->m_pVB[i], ratio, &pResult->m_pVB[i]))
+        {
+            pResult->m_Count = i;
+            return 0;
+        }
+    }
+
+    pResult->m_Count = pMesh->m_Count;
+
+    return 1;
+}
+//---------------------------------------------------------------------------
+void csrLODMeshContentRelease(CSR_Mesh* pMesh, const CSR_fOnDeleteTexture fOnDeleteTexture)
+{
+    size_t i;
+
+    // no mesh to release?
+    if (!pMesh)
+        return;
+
+    // release the skin
+    csrSkinContentRelease(&pMesh->m_Skin, fOnDeleteTexture);
+
+    // free the mesh vertex buffers
+    if (pMesh->m_pVB)
+    {
+        for (i = 0; i < pMesh->m_Count; ++i)
+            if (pMesh->m_pVB[i].m_pData)
+                free(pMesh->m_pVB[i].m_pData);
+
+        free(pMesh->m_pVB);
+    }
+
+    csrMeshInit(pMesh);
+}
+//---------------------------------------------------------------------------
+// Level of detail functions
+//---------------------------------------------------------------------------
+CSR_LOD* csrLODCreate(const CSR_Mesh* pMesh, size_t levelCount, float reduction)
+{
+    CSR_LOD*    pLOD;
+    CSR_Vector3 min;
+    CSR_Vector3 max;
+    float       ratio;
+    float       screenSize;
+    float       radiusSq;
+    int         hasVertex;
+    size_t      i;
+    size_t      j;
+
+    // validate the inputs
+    if (!pMesh || reduction <= 0.0f || reduction >= 1.0f)
+        return 0;
+
+    // create the level of detail mesh
+    pLOD = (CSR_LOD*)malloc(sizeof(CSR_LOD));
+
+    // succeeded?
+    if (!pLOD)
+        return 0;
+
+    csrLODInit(pLOD);
+
+    // calculate the source mesh bounding sphere
+    hasVertex = 0;
+    radiusSq  = 0.0f;
+
+    for (i = 0; i < pMesh->m_Count; ++i)
+    {
+        const CSR_VertexBuffer* pVB = &pMesh->m_pVB[i];
+
+        if (!pVB->m_Format.m_Stride)
+            continue;
+
+        for (j = 0; j + 2 < pVB->m_Count; j += pVB->m_Format.m_Stride)
+        {
+            const float* pP = &pVB->m_pData[j];
+
+            if (!hasVertex)
+            {
+                min.m_X   = max.m_X = pP[0];
+                min.m_Y   = max.m_Y = pP[1];
+                min.m_Z   = max.m_Z = pP[2];
+                hasVertex = 1;
+                continue;
+            }
+
+            if (pP[0] < min.m_X) min.m_X = pP[0];
+            if (pP[1] < min.m_Y) min.m_Y = pP[1];
+            if (pP[2] < min.m_Z) min.m_Z = pP[2];
+            if (pP[0] > max.m_X) max.m_X = pP[0];
+            if (pP[1] > max.m_Y) max.m_Y = pP[1];
+            if (pP[2] > max.m_Z) max.m_Z = pP[2];
+        }
+    }
+
+    if (hasVertex)
+    {
+        pLOD->m_Bounds.m_Center.m_X = (min.m_X + max.m_X) * 0.5f;
+        pLOD->m_Bounds.m_Center.m_Y = (min.m_Y + max.m_Y) * 0.5f;
+        pLOD->m_Bounds.m_Center.m_Z = (min.m_Z + max.m_Z) * 0.5f;
+
+        for (i = 0; i < pMesh->m_Count; ++i)
+        {
+            const CSR_VertexBuffer* pVB = &pMesh->m_pVB[i];
+
+            if (!pVB->m_Format.m_Stride)
+                continue;
+
+            for (j = 0; j + 2 < pVB->m_Count; j += pVB->m_Format.m_Stride)
+            {
+                const float x = pVB->m_pData[j]     - pLOD->m_Bounds.m_Center.m_X;
+                const float y = pVB->m_pData[j + 1] - pLOD->m_Bounds.m_Center.m_Y;
+                const float z = pVB->m_pData[j + 2] - pLOD->m_Bounds.m_Center.m_Z;
+
+                if (x * x + y * y + z * z > radiusSq)
+                    radiusSq = x * x + y * y + z * z;
+            }
+        }
+
+        pLOD->m_Bounds.m_Radius = sqrtf(radiusSq);
+    }
+
+    // no level to generate?
+    if (!levelCount)
+        return pLOD;
+
+    pLOD->m_pMesh       = (CSR_Mesh*)malloc(levelCount * sizeof(CSR_Mesh));
+    pLOD->m_pScreenSize = (float*)   malloc(levelCount * sizeof(float));
+
+    if (!pLOD->m_pMesh || !pLOD->m_pScreenSize)
+    {
+        csrLODRelease(pLOD, 0);
+        return 0;
+    }
+
+    ratio      = 1.0f;
+    screenSize = 0.25f;
+
+    // generate the levels, each one is simplified from the source mesh to limit the error
+    for (i = 0; i < levelCount; ++i)
+    {
+        ratio *= reduction;
+
+        csrMeshInit(&pLOD->m_pMesh[i]);
+        pLOD->m_pScreenSize[i] = screenSize;
+        pLOD->m_Count          = i + 1;
+
+        if (!csrLODSimplify(pMesh, ratio, &pLOD->m_pMesh[i]))
+        {
+            csrLODRelease(pLOD, 0);
+            return 0;
+        }
+
+        screenSize *= 0.5f;
+    }
+
+    return pLOD;
+}
+//---------------------------------------------------------------------------
+void csrLODRelease(CSR_LOD* pLOD, const CSR_fOnDeleteTexture fOnDeleteTexture)
+{
+    size_t i;
+
+    // no level of detail mesh to release?
+    if (!pLOD)
+        return;
+
+    // release the simplified meshes
+    if (pLOD->m_pMesh)
+    {
+        for (i = 0; i < pLOD->m_Count; ++i)
+            csrLODMeshContentRelease(&pLOD->m_pMesh[i], fOnDeleteTexture);
+
+        free(pLOD->m_pMesh);
+    }
+
+    // free the screen sizes
+    if (pLOD->m_pScreenSize)
+        free(pLOD->m_pScreenSize);
+
+    free(pLOD);
+}
+//---------------------------------------------------------------------------
+void csrLODInit(CSR_LOD* pLOD)
+{
+    // no level of detail mesh to initialize?
+    if (!pLOD)
+        return;
+
+    // initialize the level of detail mesh
+    pLOD->m_pMesh                = 0;
+    pLOD->m_pScreenSize          = 0;
+    pLOD->m_Count                = 0;
+    pLOD->m_Hysteresis           = M_CSR_LOD_Default_Hysteresis;
+    pLOD->m_Bounds.m_Center.m_X  = 0.0f;
+    pLOD->m_Bounds.m_Center.m_Y  = 0.0f;
+    pLOD->m_Bounds.m_Center.m_Z  = 0.0f;
+    pLOD->m_Bounds.m_Radius      = 0.0f;
+}
+//---------------------------------------------------------------------------
+const CSR_Mesh* csrLODGetMesh(const CSR_LOD* pLOD, const CSR_Mesh* pSource, size_t level)
+{
+    // no level of detail, or source level?
+    if (!pLOD || !pLOD->m_Count || !level)
+        return pSource;
+
+    // level out of bounds?
+    if (level > pLOD->m_Count)
+        level = pLOD->m_Count;
+
+    return &pLOD->m_pMesh[level - 1];
+}
+//---------------------------------------------------------------------------
+float csrLODScreenSize(const CSR_LOD*     pLOD,
+                       const CSR_Matrix4* pModelMatrix,
+                       const CSR_Matrix4* pViewMatrix,
+                       const CSR_Matrix4* pProjectionMatrix)
+{
+    CSR_Vector3 worldCenter;
+    CSR_Vector3 viewCenter;
+    float       scale;
+    float       distance;
+    float       radius;
+    size_t      i;
+
+    // validate the inputs
+    if (!pLOD || !pViewMatrix || !pProjectionMatrix)
+        return 1.0f;
+
+    worldCenter = pLOD->m_Bounds.m_Center;
+    scale       = 1.0f;
+
+    // apply the model matrix, and get its greatest scale factor
+    if (pModelMatrix)
+    {
+        csrMat4ApplyToVector(pModelMatrix, &pLOD->m_Bounds.m_Center, &worldCenter);
+
+        scale = 0.0f;
+
+        for (i = 0; i < 3; ++i)
+        {
+            const float axisSq = pModelMatrix->m_Table[i][0] * pModelMatrix->m_Table[i][0] +
+                                 pModelMatrix->m_Table[i][1] * pModelMatrix->m_Table[i][1] +
+                                 pModelMatrix->m_Table[i][2] * pModelMatrix->m_Table[i][2];
+
+            if (axisSq > scale)
+                scale = axisSq;
+        }
+
+        scale = sqrtf(scale);
+    }
+
+    csrMat4ApplyToVector(pViewMatrix, &worldCenter, &viewCenter);
+    csrVec3Length(&viewCenter, &distance);
+
+    radius = pLOD->m_Bounds.m_Radius * scale;
+
+    // the camera is inside the bounding sphere
+    if (distance <= radius)
+        return 1.0f;
+
+    // project the bounding sphere diameter, as a viewport height ratio
+    return (radius * pProjectionMatrix->m_Table[1][1]) / distance;
+}
+//---------------------------------------------------------------------------
+size_t csrLODSelect(const CSR_LOD* pLOD, float screenSize, size_t currentLevel)
+{
+    size_t level;
+
+    // no level of detail?
+    if (!pLOD || !pLOD->m_Count || !pLOD->m_pScreenSize)
+        return 0;
+
+    level = currentLevel > pLOD->m_Count ? pLOD->m_Count : currentLevel;
+
+    // switch to a less detailed level only if the screen size is clearly under the threshold
+    while (level < pLOD->m_Count && screenSize < pLOD->m_pScreenSize[level] * (1.0f - pLOD->m_Hysteresis))
+        ++level;
+
+    // switch to a more detailed level only if the screen size is clearly above the threshold
+    while (level > 0 && screenSize > pLOD->m_pScreenSize[level - 1] * (1.0f + pLOD->m_Hysteresis))
+        --level;
+
+    return level;
+}
+//---------------------------------------------------------------------------
+// Level of detail state functions
+//---------------------------------------------------------------------------
+CSR_LODState* csrLODStateCreate(void)
+{
+    // create a new level of detail state
+    CSR_LODState* pState = (CSR_LODState*)malloc(sizeof(CSR_LODState));
+
+    // succeeded?
+    if (!pState)
+        return 0;
+
+    // initialize the level of detail state content
+    csrLODStateInit(pState);
+
+    return pState;
+}
+//---------------------------------------------------------------------------
+void csrLODStateRelease(CSR_LODState* pState)
+{
+    // no level of detail state to release?
+    if (!pState)
+        return;
+
+    // free the levels
+    if (pState->m_pLevel)
+        free(pState->m_pLevel);
+
+    free(pState);
+}
+//---------------------------------------------------------------------------
+void csrLODStateInit(CSR_LODState* pState)
+{
+    // no level of detail state to initialize?
+    if (!pState)
+        return;
+
+    // initialize the level of detail state
+    pState->m_pLevel = 0;
+    pState->m_Count  = 0;
+}
+//---------------------------------------------------------------------------
+int csrLODStateUpdate(const CSR_LOD*      pLOD,
+                      const CSR_Array*    pMatrixArray,
+                      const CSR_Matrix4*  pViewMatrix,
+                      const CSR_Matrix4*  pProjectionMatrix,
+                            CSR_LODState* pState)
+{
+    size_t i;
+    size_t count;
+
+    // validate the inputs
+    if (!pLOD || !pViewMatrix || !pProjectionMatrix || !pState)
+        return 0;
+
+    // get the instance count
+    count = (pMatrixArray && pMatrixArray->m_Count) ? pMatrixArray->m_Count : 1;
+
+    // resize the levels, the new instances start at the most detailed level
+    if (count != pState->m_Count)
+    {
+        size_t* pLevel = (size_t*)csrMemoryAlloc(pState->m_pLevel, sizeof(size_t), count);
+
+        // succeeded?
+        if (!pLevel)
+            return 0;
+
+        for (i = pState->m_Count; i < count; ++i)
+            pLevel[i] = 0;
+
+        pState->m_pLevel = pLevel;
+        pState->m_Count  = count;
+    }
+
+    // select the level of each instance
+    for (i = 0; i < count; ++i)
+    {
+        const CSR_Matrix4* pModelMatrix =
+                (pMatrixArray && pMatrixArray->m_Count) ? (const CSR_Matrix4*)pMatrixArray->m_pItem[i].m_pData : 0;
+
+        pState->m_pLevel[i] = csrLODSelect(pLOD,
+                                           csrLODScreenSize(pLOD, pModelMatrix, pViewMatrix, pProjectionMatrix),
+                                           pState->m_pLevel[i]);
+    }
+
+    return 1;
+}
+//---------------------------------------------------------------------------
@@ -0,0 +1,205 @@
+/****************************************************************************
+ * ==> CSR_Lod -------------------------------------------------------------*
+ ****************************************************************************
+ * Description : This module provides the level of detail functions, i.e.  *
+ *               a mesh simplifier and a screen size based level selection  *
+ * Developer   : Jean-Milost Reymond                                        *
+ * Copyright   : 2017 - 2022, this file is part of the CompactStar Engine.  *
+ *               You are free to copy or redistribute this file, modify it, *
+ *               or use it for your own projects, commercial or not. This   *
+ *               file is provided "as is", WITHOUT ANY WARRANTY OF ANY      *
+ *               KIND. THE DEVELOPER IS NOT RESPONSIBLE FOR ANY DAMAGE OF   *
+ *               ANY KIND, ANY LOSS OF DATA, OR ANY LOSS OF PRODUCTIVITY    *
+ *               TIME THAT MAY RESULT FROM THE USAGE OF THIS SOURCE CODE,   *
+ *               DIRECTLY OR NOT.                                           *
+ ****************************************************************************/
+
+#ifndef CSR_LodH
+#define CSR_LodH
+
+// compactStar engine
+#include "CSR_Common.h"
+#include "CSR_Geometry.h"
+#include "CSR_Texture.h"
+#include "CSR_Vertex.h"
+
+//---------------------------------------------------------------------------
+// Global defines
+//---------------------------------------------------------------------------
+#define M_CSR_LOD_Default_Hysteresis 0.1f
+
+//---------------------------------------------------------------------------
+// Structures
+//---------------------------------------------------------------------------
+
+/**
+* Level of detail mesh
+*@note The level 0 is the source mesh, which isn't owned by this structure. The level i (i > 0)
+*      is m_pMesh[i - 1], and is used when the mesh screen size is lower than m_pScreenSize[i - 1]
+*/
+typedef struct
+{
+    CSR_Mesh*  m_pMesh;       // simplified meshes, from the most to the least detailed
+    float*     m_pScreenSize; // screen size (as a viewport height ratio) under which each level is used
+    size_t     m_Count;       // simplified mesh count
+    float      m_Hysteresis;  // ratio around each screen size in which the current level is kept
+    CSR_Sphere m_Bounds;      // source mesh bounding sphere, in model coordinates
+} CSR_LOD;
+
+/**
+* Level of detail state, i.e. the level currently used by each instance of a mesh
+*/
+typedef struct
+{
+    size_t* m_pLevel;
+    size_t  m_Count;
+} CSR_LODState;
+
+#ifdef __cplusplus
+    extern "C"
+    {
+#endif
+        //-------------------------------------------------------------------
+        // Mesh simplification functions
+        //-------------------------------------------------------------------
+
+        /**
+        * Simplifies a mesh using the quadric error metrics
+        *@param pMesh - mesh to simplify
+        *@param ratio - triangle count to keep, as a ratio between 0.0 and 1.0
+        *@param[in, out] pResult - simplified mesh, should be initialized with csrMeshInit()
+        *@return 1 on success, otherwise 0
+        *@note Only the triangles, triangle strips and triangle fans are simplified, the other
+        *      vertex buffers are copied as is. The simplified vertex buffers are triangle lists
+        *@note The vertices sharing the same position but not the same normal, texture coordinates
+        *      or color (i.e. the UV seams and hard edges) are handled as borders, and are preserved
+        *@note The skin texture file names are copied in the result, but not the pixel buffers
+        *@note The result content should be released when no longer used, see csrLODMeshContentRelease()
+        */
+        int csrLODSimplify(const CSR_Mesh* pMesh, float ratio, CSR_Mesh* pResult);
+
+        /**
+        * Releases a mesh content, without releasing the mesh itself
+        *@param[in, out] pMesh - mesh for which the content should be released
+        *@param fOnDeleteTexture - callback function to notify the GPU that a texture should be deleted
+        */
+        void csrLODMeshContentRelease(CSR_Mesh* pMesh, const CSR_fOnDeleteTexture fOnDeleteTexture);
+
+        //-------------------------------------------------------------------
+        // Level of detail functions
+        //-------------------------------------------------------------------
+
+        /**
+        * Creates a level of detail mesh
+        *@param pMesh - source mesh, used as level 0
+        *@param levelCount - simplified level count to generate
+        *@param reduction - triangle ratio to keep between a level and the next one, e.g. 0.5
+        *@return newly created level of detail mesh, 0 on error
+        *@note Each level is used when the screen size falls below the half of the previous one,
+        *      starting at 0.25, these values may be changed in m_pScreenSize
+        *@note The level of detail mesh must be released when no longer used, see csrLODRelease()
+        */
+        CSR_LOD* csrLODCreate(const CSR_Mesh* pMesh, size_t levelCount, float reduction);
+
+        /**
+        * Releases a level of detail mesh
+        *@param[in, out] pLOD - level of detail mesh to release
+        *@param fOnDeleteTexture - callback function to notify the GPU that a texture should be deleted
+        */
+        void csrLODRelease(CSR_LOD* pLOD, const CSR_fOnDeleteTexture fOnDeleteTexture);
+
+        /**
+        * Initializes a level of detail mesh structure
+        *@param[in, out] pLOD - level of detail mesh to initialize
+        */
+        void csrLODInit(CSR_LOD* pLOD);
+
+        /**
+        * Gets the mesh matching with a level
+        *@param pLOD - level of detail mesh
+        *@param pSource - source mesh, returned for the level 0
+        *@param level - level for which the mesh should be get
+        *@return the level mesh, the least detailed one if the level is out of bounds
+        *@note The simplified meshes own a copy of the source skin file names, but the textures are
+        *      linked to the source skin. A level should be drawn with the source skin, see
+        *      csrDrawMeshWithSkin()
+        */
+        const CSR_Mesh* csrLODGetMesh(const CSR_LOD* pLOD, const CSR_Mesh* pSource, size_t level);
+
+        /**
+        * Calculates the size a mesh takes on the screen
+        *@param pLOD - level of detail mesh
+        *@param pModelMatrix - model matrix, if 0 an identity matrix will be used
+        *@param pViewMatrix - view matrix
+        *@param pProjectionMatrix - projection matrix
+        *@return the projected bounding sphere diameter, as a viewport height ratio
+        */
+        float csrLODScreenSize(const CSR_LOD*     pLOD,
+                               const CSR_Matrix4* pModelMatrix,
+                               const CSR_Matrix4* pViewMatrix,
+                               const CSR_Matrix4* pProjectionMatrix);
+
+        /**
+        * Selects the level to use for a screen size
+        *@param pLOD - level of detail mesh
+        *@param screenSize - mesh screen size, see csrLODScreenSize()
+        *@param currentLevel - level currently used, needed to apply the hysteresis
+        *@return the level to use
+        *@note A level change is only accepted when the screen size moves farther than the
+        *      hysteresis ratio from the threshold, thus the level doesn't pop on the threshold
+        */
+        size_t csrLODSelect(const CSR_LOD* pLOD, float screenSize, size_t currentLevel);
+
+        //-------------------------------------------------------------------
+        // Level of detail state functions
+        //-------------------------------------------------------------------
+
+        /**
+        * Creates a level of detail state
+        *@return newly created level of detail state, 0 on error
+        *@note The level of detail state must be released when no longer used, see csrLODStateRelease()
+        */
+        CSR_LODState* csrLODStateCreate(void);
+
+        /**
+        * Releases a level of detail state
+        *@param[in, out] pState - level of detail state to release
+        */
+        void csrLODStateRelease(CSR_LODState* pState);
+
+        /**
+        * Initializes a level of detail state structure
+        *@param[in, out] pState - level of detail state to initialize
+        */
+        void csrLODStateInit(CSR_LODState* pState);
+
+        /**
+        * Updates the level used by each instance of a mesh
+        *@param pLOD - level of detail mesh
+        *@param pMatrixArray - instance model matrices, if 0 one instance using an identity matrix
+        *                      is considered
+        *@param pViewMatrix - view matrix
+        *@param pProjectionMatrix - projection matrix
+        *@param[in, out] pState - level of detail state to update, resized to the instance count
+        *@return 1 on success, otherwise 0
+        */
+        int csrLODStateUpdate(const CSR_LOD*      pLOD,
+                              const CSR_Array*    pMatrixArray,
+                              const CSR_Matrix4*  pViewMatrix,
+                              const CSR_Matrix4*  pProjectionMatrix,
+                                    CSR_LODState* pState);
+
+#ifdef __cplusplus
+    }
+#endif
+
+//---------------------------------------------------------------------------
+// Compiler
+//---------------------------------------------------------------------------
+
+// needed in mobile c compiler to link the .h file with the .c
+#if defined(_OS_IOS_) || defined(_OS_ANDROID_) || defined(_OS_WINDOWS_)
+    #include "CSR_Lod.c"
+#endif
+
+#endif
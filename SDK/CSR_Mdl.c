@@ -1376,7 +1376,7 @@ CSR_MDL* csrMDLOpen(const char*                 pFileName,
     CSR_MDL*    pMDL;
 
     // open the model file
-    pBuffer = csrFileOpen(pFileName);
+    pBuffer = csrFileMap(pFileName);
 
     // succeeded?
     if (!pBuffer || !pBuffer->m_Length)
@@ -1460,6 +1460,43 @@ void csrMDLRelease(CSR_MDL* pMDL, const CSR_fOnDeleteTexture fOnDeleteTexture)
     free(pMDL);
 }
 //---------------------------------------------------------------------------
+void csrMDLApplySkins(CSR_MDL* pMDL, const CSR_fOnApplySkin fOnApplySkin)
+{
+    size_t i;
+    double time;
+
+    // validate the inputs
+    if (!pMDL || !fOnApplySkin)
+        return;
+
+    // iterate through skins to apply
+    for (i = 0; i < pMDL->m_SkinCount; ++i)
+    {
+        int canRelease = 0;
+
+        // notify that the model skin should be applied
+        fOnApplySkin(i, &pMDL->m_pSkin[i], &canRelease);
+
+        // can release the skin content? (NOTE the skin texture, bump map and cubemap members can
+        // still be used as keys even after their content is released)
+        if (canRelease)
+        {
+            // keep the animation time
+            time = pMDL->m_pSkin[i].m_Time;
+
+            // release the skin content
+            csrTextureContentRelease(&pMDL->m_pSkin[i].m_Texture);
+            csrTextureContentRelease(&pMDL->m_pSkin[i].m_BumpMap);
+            csrTextureContentRelease(&pMDL->m_pSkin[i].m_CubeMap);
+
+            // clear their values
+            csrSkinInit(&pMDL->m_pSkin[i]);
+
+            pMDL->m_pSkin[i].m_Time = time;
+        }
+    }
+}
+//---------------------------------------------------------------------------
 void csrMDLUpdateIndex(const CSR_MDL* pMDL,
                              size_t   fps,
                              size_t   animationIndex,
@@ -105,6 +105,14 @@ typedef struct
         */
         void csrMDLRelease(CSR_MDL* pMDL, const CSR_fOnDeleteTexture fOnDeleteTexture);
 
+        /**
+        * Applies the skins of a MDL model created without skin callback
+        *@param[in, out] pMDL - MDL model for which the skins should be applied
+        *@param fOnApplySkin - called when a skin should be applied to the model, ignored if 0
+        *@note The skin content is released if the callback allows it, as csrMDLCreate() does
+        */
+        void csrMDLApplySkins(CSR_MDL* pMDL, const CSR_fOnApplySkin fOnApplySkin);
+
         /**
         * Updates the MDL model indexes (e.g. before getting the next mesh to show)
         *@param pMDL - MDL model
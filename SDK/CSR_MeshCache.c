@@ -0,0 +1,946 @@
+/****************************************************************************
+ * ==> CSR_MeshCache -------------------------------------------------------*
+ ****************************************************************************
+ * Description : This module provides a cache of cooked models, i.e. models *
+ *               already parsed and stored in a binary file, which may be   *
+ *               loaded without parsing the source file again               *
+ * Developer   : Jean-Milost Reymond                                        *
+ * Copyright   : 2017 - 2022, this file is part of the CompactStar Engine.  *
+ *               You are free to copy or redistribute this file, modify it, *
+ *               or use it for your own projects, commercial or not. This   *
+ *               file is provided "as is", WITHOUT ANY WARRANTY OF ANY      *
+ *               KIND. THE DEVELOPER IS NOT RESPONSIBLE FOR ANY DAMAGE OF   *
+ *               ANY KIND, ANY LOSS OF DATA, OR ANY LOSS OF PRODUCTIVITY    *
+ *               TIME THAT MAY RESULT FROM THE USAGE OF THIS SOURCE CODE,   *
+ *               DIRECTLY OR NOT.                                           *
+ ****************************************************************************/
+
+#include "CSR_MeshCache.h"
+
+// std
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+// compactStar engine
+#include "CSR_Wavefront.h"
+
+//---------------------------------------------------------------------------
+// Global defines
+//---------------------------------------------------------------------------
+#define M_CSR_MeshCache_Endianness 0x01020304
+#define M_CSR_MeshCache_Type_Model 0
+#define M_CSR_MeshCache_Type_MDL   1
+#define M_CSR_MeshCache_Has_Buffer 0x1
+#define M_CSR_MeshCache_Has_Name   0x2
+
+//---------------------------------------------------------------------------
+// Mesh cache private functions
+//---------------------------------------------------------------------------
+void csrMeshCacheHash(const void* pData, size_t length, unsigned* pFnv, unsigned* pDjb)
+{
+    const unsigned char* pBytes = (const unsigned char*)pData;
+          size_t         i;
+
+    // hash the content with FNV-1a and djb2, as the pixel buffer keys do
+    for (i = 0; i < length; ++i)
+    {
+        *pFnv = (*pFnv ^ pBytes[i]) * 16777619u;
+        *pDjb = ((*pDjb << 5) + *pDjb) + pBytes[i];
+    }
+}
+//---------------------------------------------------------------------------
+int csrMeshCacheCanRead(const CSR_Buffer* pBuffer, size_t offset, size_t length, size_t count)
+{
+    // offset is out of bounds?
+    if (offset > pBuffer->m_Length)
+        return 0;
+
+    // not enough data remaining? (NOTE written this way to avoid an overflow on corrupted counts)
+    if (length && count > (pBuffer->m_Length - offset) / length)
+        return 0;
+
+    return 1;
+}
+//---------------------------------------------------------------------------
+int csrMeshCacheWriteHeader(CSR_Buffer* pBuffer, const CSR_MeshCacheKey* pKey, unsigned type)
+{
+    unsigned header[5];
+
+    header[0] = M_CSR_MeshCache_ID;
+    header[1] = M_CSR_MeshCache_Version;
+    header[2] = type;
+    header[3] = M_CSR_MeshCache_Endianness;
+    header[4] = (unsigned)sizeof(size_t);
+
+    return (csrBufferWrite(pBuffer, header,         sizeof(unsigned), 5) &&
+            csrBufferWrite(pBuffer, pKey->m_Hash,   sizeof(unsigned), 2) &&
+            csrBufferWrite(pBuffer, &pKey->m_Length, sizeof(size_t),  1));
+}
+//---------------------------------------------------------------------------
+int csrMeshCacheReadHeader(const CSR_Buffer*       pBuffer,
+                                 size_t*           pOffset,
+                           const CSR_MeshCacheKey* pKey,
+                                 unsigned          type)
+{
+    unsigned header[5];
+    unsigned hash[2];
+    size_t   length;
+
+    // read the header and the key
+    if (!csrBufferRead(pBuffer, pOffset, sizeof(unsigned), 5, header))
+        return 0;
+
+    // the file was cooked with another version, or on another platform?
+    if (header[0] != M_CSR_MeshCache_ID         ||
+        header[1] != M_CSR_MeshCache_Version    ||
+        header[2] != type                       ||
+        header[3] != M_CSR_MeshCache_Endianness ||
+        header[4] != (unsigned)sizeof(size_t))
+        return 0;
+
+    if (!csrBufferRead(pBuffer, pOffset, sizeof(unsigned), 2, hash) ||
+        !csrBufferRead(pBuffer, pOffset, sizeof(size_t),   1, &length))
+        return 0;
+
+    // the file should match with the whole key, not only with its name
+    return (hash[0] == pKey->m_Hash[0] && hash[1] == pKey->m_Hash[1] && length == pKey->m_Length);
+}
+//---------------------------------------------------------------------------
+int csrMeshCacheWriteTexture(CSR_Buffer* pBuffer, const CSR_Texture* pTexture)
+{
+    unsigned flags = 0;
+    unsigned info[6];
+    size_t   length;
+
+    if (pTexture->m_pBuffer)
+        flags |= M_CSR_MeshCache_Has_Buffer;
+
+    if (pTexture->m_pFileName)
+        flags |= M_CSR_MeshCache_Has_Name;
+
+    if (!csrBufferWrite(pBuffer, &flags, sizeof(unsigned), 1))
+        return 0;
+
+    // write the pixel buffer
+    if (pTexture->m_pBuffer)
+    {
+        info[0] = (unsigned)pTexture->m_pBuffer->m_ImageType;
+        info[1] = (unsigned)pTexture->m_pBuffer->m_PixelType;
+        info[2] =           pTexture->m_pBuffer->m_Width;
+        info[3] =           pTexture->m_pBuffer->m_Height;
+        info[4] =           pTexture->m_pBuffer->m_Stride;
+        info[5] =           pTexture->m_pBuffer->m_BytePerPixel;
+
+        length = pTexture->m_pBuffer->m_pData ? pTexture->m_pBuffer->m_DataLength : 0;
+
+        if (!csrBufferWrite(pBuffer, info,    sizeof(unsigned), 6) ||
+            !csrBufferWrite(pBuffer, &length, sizeof(size_t),   1))
+            return 0;
+
+        if (length && !csrBufferWrite(pBuffer, pTexture->m_pBuffer->m_pData, length, 1))
+            return 0;
+    }
+
+    // write the file name
+    if (pTexture->m_pFileName)
+    {
+        length = strlen(pTexture->m_pFileName);
+
+        if (!csrBufferWrite(pBuffer, &length, sizeof(size_t), 1))
+            return 0;
+
+        if (length && !csrBufferWrite(pBuffer, pTexture->m_pFileName, length, 1))
+            return 0;
+    }
+
+    return 1;
+}
+//---------------------------------------------------------------------------
+int csrMeshCacheReadTexture(const CSR_Buffer* pBuffer, size_t* pOffset, CSR_Texture* pTexture)
+{
+    unsigned flags;
+    unsigned info[6];
+    size_t   length;
+
+    if (!csrBufferRead(pBuffer, pOffset, sizeof(unsigned), 1, &flags))
+        return 0;
+
+    // read the pixel buffer
+    if (flags & M_CSR_MeshCache_Has_Buffer)
+    {
+        // create the pixel buffer, owned by the texture from now, thus released with it on error
+        pTexture->m_pBuffer = csrPixelBufferCreate();
+
+        // succeeded?
+        if (!pTexture->m_pBuffer)
+            return 0;
+
+        if (!csrBufferRead(pBuffer, pOffset, sizeof(unsigned), 6, info) ||
+            !csrBufferRead(pBuffer, pOffset, sizeof(size_t),   1, &length))
+            return 0;
+
+        pTexture->m_pBuffer->m_ImageType    = (CSR_EImageType)info[0];
+        pTexture->m_pBuffer->m_PixelType    = (CSR_EPixelType)info[1];
+        pTexture->m_pBuffer->m_Width        = info[2];
+        pTexture->m_pBuffer->m_Height       = info[3];
+        pTexture->m_pBuffer->m_Stride       = info[4];
+        pTexture->m_pBuffer->m_BytePerPixel = info[5];
+
+        if (length)
+        {
+            if (!csrMeshCacheCanRead(pBuffer, *pOffset, length, 1))
+                return 0;
+
+            pTexture->m_pBuffer->m_pData = malloc(length);
+
+            // succeeded?
+            if (!pTexture->m_pBuffer->m_pData)
+                return 0;
+
+            pTexture->m_pBuffer->m_DataLength = length;
+
+            if (!csrBufferRead(pBuffer, pOffset, length, 1, pTexture->m_pBuffer->m_pData))
+                return 0;
+        }
+    }
+
+    // read the file name
+    if (flags & M_CSR_MeshCache_Has_Name)
+    {
+        if (!csrBufferRead(pBuffer, pOffset, sizeof(size_t), 1, &length))
+            return 0;
+
+        if (!csrMeshCacheCanRead(pBuffer, *pOffset, length, 1))
+            return 0;
+
+        pTexture->m_pFileName = (char*)malloc(length + 1);
+
+        // succeeded?
+        if (!pTexture->m_pFileName)
+            return 0;
+
+        if (length && !csrBufferRead(pBuffer, pOffset, length, 1, pTexture->m_pFileName))
+            return 0;
+
+        pTexture->m_pFileName[length] = '\0';
+    }
+
+    return 1;
+}
+//---------------------------------------------------------------------------
+int csrMeshCacheWriteSkin(CSR_Buffer* pBuffer, const CSR_Skin* pSkin)
+{
+    return (csrMeshCacheWriteTexture(pBuffer, &pSkin->m_Texture) &&
+            csrMeshCacheWriteTexture(pBuffer, &pSkin->m_BumpMap) &&
+            csrMeshCacheWriteTexture(pBuffer, &pSkin->m_CubeMap) &&
+            csrBufferWrite(pBuffer, &pSkin->m_Time, sizeof(double), 1));
+}
+//---------------------------------------------------------------------------
+int csrMeshCacheReadSkin(const CSR_Buffer* pBuffer, size_t* pOffset, CSR_Skin* pSkin)
+{
+    return (csrMeshCacheReadTexture(pBuffer, pOffset, &pSkin->m_Texture) &&
+            csrMeshCacheReadTexture(pBuffer, pOffset, &pSkin->m_BumpMap) &&
+            csrMeshCacheReadTexture(pBuffer, pOffset, &pSkin->m_CubeMap) &&
+            csrBufferRead(pBuffer, pOffset, sizeof(double), 1, &pSkin->m_Time));
+}
+//---------------------------------------------------------------------------
+int csrMeshCacheWriteVB(CSR_Buffer* pBuffer, const CSR_VertexBuffer* pVB)
+{
+    int   values[9];
+    float scale[2];
+
+    // write the vertex format, culling and material member by member, to not depend on the padding
+    values[0] = (int)pVB->m_Format.m_Type;
+    values[1] =      pVB->m_Format.m_HasNormal;
+    values[2] =      pVB->m_Format.m_HasTexCoords;
+    values[3] =      pVB->m_Format.m_HasPerVertexColor;
+    values[4] = (int)pVB->m_Format.m_Stride;
+    values[5] = (int)pVB->m_Culling.m_Type;
+    values[6] = (int)pVB->m_Culling.m_Face;
+    values[7] =      pVB->m_Material.m_Transparent;
+    values[8] =      pVB->m_Material.m_Wireframe;
+    scale[0]  =      pVB->m_Material.m_uScale;
+    scale[1]  =      pVB->m_Material.m_vScale;
+
+    if (!csrBufferWrite(pBuffer, values,                     sizeof(int),      9) ||
+        !csrBufferWrite(pBuffer, &pVB->m_Material.m_Color,   sizeof(unsigned), 1) ||
+        !csrBufferWrite(pBuffer, scale,                      sizeof(float),    2) ||
+        !csrBufferWrite(pBuffer, &pVB->m_Time,               sizeof(double),   1) ||
+        !csrBufferWrite(pBuffer, &pVB->m_Count,              sizeof(size_t),   1))
+        return 0;
+
+    // write the vertices
+    if (pVB->m_Count && !csrBufferWrite(pBuffer, pVB->m_pData, sizeof(float), pVB->m_Count))
+        return 0;
+
+    return 1;
+}
+//---------------------------------------------------------------------------
+int csrMeshCacheReadVB(const CSR_Buffer* pBuffer, size_t* pOffset, CSR_VertexBuffer* pVB)
+{
+    int    values[9];
+    float  scale[2];
+    size_t count;
+
+    if (!csrBufferRead(pBuffer, pOffset, sizeof(int),      9, values)                   ||
+        !csrBufferRead(pBuffer, pOffset, sizeof(unsigned), 1, &pVB->m_Material.m_Color) ||
+        !csrBufferRead(pBuffer, pOffset, sizeof(float),    2, scale)                    ||
+        !csrBufferRead(pBuffer, pOffset, sizeof(double),   1, &pVB->m_Time)             ||
+        !csrBufferRead(pBuffer, pOffset, sizeof(size_t),   1, &count))
+        return 0;
+
+    pVB->m_Format.m_Type              = (CSR_EVertexType)values[0];
+    pVB->m_Format.m_HasNormal         =                  values[1];
+    pVB->m_Format.m_HasTexCoords      =                  values[2];
+    pVB->m_Format.m_HasPerVertexColor =                  values[3];
+    pVB->m_Format.m_Stride            = (unsigned)       values[4];
+    pVB->m_Culling.m_Type             = (CSR_ECullingType)values[5];
+    pVB->m_Culling.m_Face             = (CSR_ECullingFace)values[6];
+    pVB->m_Material.m_Transparent     =                  values[7];
+    pVB->m_Material.m_Wireframe       =                  values[8];
+    pVB->m_Material.m_uScale          =                  scale[0];
+    pVB->m_Material.m_vScale          =                  scale[1];
+
+    // no vertices?
+    if (!count)
+        return 1;
+
+    if (!csrMeshCacheCanRead(pBuffer, *pOffset, sizeof(float), count))
+        return 0;
+
+    pVB->m_pData = (float*)malloc(count * sizeof(float));
+
+    // succeeded?
+    if (!pVB->m_pData)
+        return 0;
+
+    pVB->m_Count = count;
+
+    return csrBufferRead(pBuffer, pOffset, sizeof(float), count, pVB->m_pData);
+}
+//---------------------------------------------------------------------------
+int csrMeshCacheWriteModelContent(CSR_Buffer* pBuffer, const CSR_Model* pModel)
+{
+    size_t i;
+    size_t j;
+
+    if (!csrBufferWrite(pBuffer, &pModel->m_MeshCount, sizeof(size_t), 1) ||
+        !csrBufferWrite(pBuffer, &pModel->m_Time,      sizeof(double), 1))
+        return 0;
+
+    // iterate through the meshes to write
+    for (i = 0; i < pModel->m_MeshCount; ++i)
+    {
+        if (!csrMeshCacheWriteSkin(pBuffer, &pModel->m_pMesh[i].m_Skin))
+            return 0;
+
+        if (!csrBufferWrite(pBuffer, &pModel->m_pMesh[i].m_Count, sizeof(size_t), 1) ||
+            !csrBufferWrite(pBuffer, &pModel->m_pMesh[i].m_Time,  sizeof(double), 1))
+            return 0;
+
+        // iterate through the mesh vertex buffers to write
+        for (j = 0; j < pModel->m_pMesh[i].m_Count; ++j)
+            if (!csrMeshCacheWriteVB(pBuffer, &pModel->m_pMesh[i].m_pVB[j]))
+                return 0;
+    }
+
+    return 1;
+}
+//---------------------------------------------------------------------------
+int csrMeshCacheReadModelContent(const CSR_Buffer* pBuffer, size_t* pOffset, CSR_Model* pModel)
+{
+    size_t    i;
+    size_t    j;
+    size_t    meshCount;
+    size_t    vbCount;
+    CSR_Mesh* pMesh;
+
+    if (!csrBufferRead(pBuffer, pOffset, sizeof(size_t), 1, &meshCount) ||
+        !csrBufferRead(pBuffer, pOffset, sizeof(double), 1, &pModel->m_Time))
+        return 0;
+
+    // no meshes?
+    if (!meshCount)
+        return 1;
+
+    // each mesh takes at least its vertex buffer count in the file
+    if (!csrMeshCacheCanRead(pBuffer, *pOffset, sizeof(size_t), meshCount))
+        return 0;
+
+    pModel->m_pMesh = (CSR_Mesh*)malloc(meshCount * sizeof(CSR_Mesh));
+
+    // succeeded?
+    if (!pModel->m_pMesh)
+        return 0;
+
+    // initialize all the meshes first, thus the model may be released at any time on error
+    for (i = 0; i < meshCount; ++i)
+        csrMeshInit(&pModel->m_pMesh[i]);
+
+    pModel->m_MeshCount = meshCount;
+
+    // iterate through the meshes to read
+    for (i = 0; i < meshCount; ++i)
+    {
+        pMesh = &pModel->m_pMesh[i];
+
+        if (!csrMeshCacheReadSkin(pBuffer, pOffset, &pMesh->m_Skin))
+            return 0;
+
+        if (!csrBufferRead(pBuffer, pOffset, sizeof(size_t), 1, &vbCount) ||
+            !csrBufferRead(pBuffer, pOffset, sizeof(double), 1, &pMesh->m_Time))
+            return 0;
+
+        // no vertex buffers?
+        if (!vbCount)
+            continue;
+
+        if (!csrMeshCacheCanRead(pBuffer, *pOffset, sizeof(size_t), vbCount))
+            return 0;
+
+        pMesh->m_pVB = (CSR_VertexBuffer*)malloc(vbCount * sizeof(CSR_VertexBuffer));
+
+        // succeeded?
+        if (!pMesh->m_pVB)
+            return 0;
+
+        for (j = 0; j < vbCount; ++j)
+            csrVertexBufferInit(&pMesh->m_pVB[j]);
+
+        pMesh->m_Count = vbCount;
+
+        // iterate through the mesh vertex buffers to read
+        for (j = 0; j < vbCount; ++j)
+            if (!csrMeshCacheReadVB(pBuffer, pOffset, &pMesh->m_pVB[j]))
+                return 0;
+    }
+
+    return 1;
+}
+//---------------------------------------------------------------------------
+int csrMeshCacheSave(const CSR_MeshCache* pCache, const CSR_MeshCacheKey* pKey, const CSR_Buffer* pBuffer)
+{
+    char*  pFileName;
+    char*  pTempName;
+    size_t length;
+    int    success;
+
+    pFileName = csrMeshCacheGetFileName(pCache, pKey);
+
+    // succeeded?
+    if (!pFileName)
+        return 0;
+
+    length    = strlen(pFileName);
+    pTempName = (char*)malloc(length + 32);
+
+    // succeeded?
+    if (!pTempName)
+    {
+        free(pFileName);
+        return 0;
+    }
+
+    // the temporary name should be unique, as the same model may be cooked by several threads
+    #ifdef _MSC_VER
+        sprintf_s(pTempName, length + 32, "%s.%p.tmp", pFileName, (const void*)pBuffer);
+    #else
+        sprintf(pTempName, "%s.%p.tmp", pFileName, (const void*)pBuffer);
+    #endif
+
+    // write the temporary file, then rename it, thus the cooked file is never read incomplete
+    success = csrFileSave(pTempName, pBuffer) && !rename(pTempName, pFileName);
+
+    // failed? (e.g. the file was already renamed by another writer on Windows)
+    if (!success)
+        remove(pTempName);
+
+    free(pTempName);
+    free(pFileName);
+
+    return success;
+}
+//---------------------------------------------------------------------------
+// Mesh cache functions
+//---------------------------------------------------------------------------
+CSR_MeshCache* csrMeshCacheCreate(const char* pDir)
+{
+    CSR_MeshCache* pCache;
+    size_t         length;
+
+    // validate the input
+    if (!pDir)
+        return 0;
+
+    // create a new mesh cache
+    pCache = (CSR_MeshCache*)malloc(sizeof(CSR_MeshCache));
+
+    // succeeded?
+    if (!pCache)
+        return 0;
+
+    // initialize the mesh cache content
+    csrMeshCacheInit(pCache);
+
+    // copy the dir
+    length          = strlen(pDir);
+    pCache->m_pDir  = (char*)malloc(length + 1);
+
+    // succeeded?
+    if (!pCache->m_pDir)
+    {
+        csrMeshCacheRelease(pCache);
+        return 0;
+    }
+
+    memcpy(pCache->m_pDir, pDir, length + 1);
+
+    return pCache;
+}
+//---------------------------------------------------------------------------
+void csrMeshCacheRelease(CSR_MeshCache* pCache)
+{
+    // no mesh cache to release?
+    if (!pCache)
+        return;
+
+    // free the dir
+    if (pCache->m_pDir)
+        free(pCache->m_pDir);
+
+    // free the mesh cache
+    free(pCache);
+}
+//---------------------------------------------------------------------------
+void csrMeshCacheInit(CSR_MeshCache* pCache)
+{
+    // no mesh cache to initialize?
+    if (!pCache)
+        return;
+
+    // initialize the mesh cache content
+    pCache->m_pDir = 0;
+}
+//---------------------------------------------------------------------------
+int csrMeshCacheGetKey(const CSR_Buffer*        pSource,
+                       const CSR_Buffer*        pExtra,
+                       const CSR_VertexFormat*  pVertFormat,
+                       const CSR_VertexCulling* pVertCulling,
+                       const CSR_Material*      pMaterial,
+                             CSR_MeshCacheKey*  pKey)
+{
+    int           values[7];
+    unsigned char marker;
+    unsigned      fnv;
+    unsigned      djb;
+
+    // validate the inputs
+    if (!pSource || !pSource->m_pData || !pKey)
+        return 0;
+
+    fnv = 2166136261u;
+    djb = 5381u;
+
+    // hash the source content
+    csrMeshCacheHash(pSource->m_pData, pSource->m_Length, &fnv, &djb);
+
+    // hash the additional content, and a marker to distinguish a missing content from an empty one
+    marker = (pExtra && pExtra->m_pData) ? 1 : 0;
+    csrMeshCacheHash(&marker, 1, &fnv, &djb);
+
+    if (marker)
+        csrMeshCacheHash(pExtra->m_pData, pExtra->m_Length, &fnv, &djb);
+
+    // hash the loading options. Only the members set by the caller are used, because the other
+    // members (e.g. the vertex format type and stride) are calculated by the loaders
+    memset(values, 0, sizeof(values));
+    values[0] = pVertFormat  ? 1                                : 0;
+    values[1] = pVertFormat  ? pVertFormat->m_HasNormal         : 0;
+    values[2] = pVertFormat  ? pVertFormat->m_HasTexCoords      : 0;
+    values[3] = pVertFormat  ? pVertFormat->m_HasPerVertexColor : 0;
+    values[4] = pVertCulling ? 1                                : 0;
+    values[5] = pVertCulling ? (int)pVertCulling->m_Type        : 0;
+    values[6] = pVertCulling ? (int)pVertCulling->m_Face        : 0;
+    csrMeshCacheHash(values, sizeof(values), &fnv, &djb);
+
+    marker = pMaterial ? 1 : 0;
+    csrMeshCacheHash(&marker, 1, &fnv, &djb);
+
+    if (pMaterial)
+    {
+        csrMeshCacheHash(&pMaterial->m_Color,       sizeof(unsigned), &fnv, &djb);
+        csrMeshCacheHash(&pMaterial->m_Transparent, sizeof(int),      &fnv, &djb);
+        csrMeshCacheHash(&pMaterial->m_Wireframe,   sizeof(int),      &fnv, &djb);
+        csrMeshCacheHash(&pMaterial->m_uScale,      sizeof(float),    &fnv, &djb);
+        csrMeshCacheHash(&pMaterial->m_vScale,      sizeof(float),    &fnv, &djb);
+    }
+
+    pKey->m_Hash[0] = fnv;
+    pKey->m_Hash[1] = djb;
+    pKey->m_Length  = pSource->m_Length;
+
+    return 1;
+}
+//---------------------------------------------------------------------------
+char* csrMeshCacheGetFileName(const CSR_MeshCache* pCache, const CSR_MeshCacheKey* pKey)
+{
+    char*  pFileName;
+    size_t length;
+
+    // validate the inputs
+    if (!pCache || !pCache->m_pDir || !pKey)
+        return 0;
+
+    // the dir, a separator, 3 hexadecimal values, the extension and the terminating zero
+    length    = strlen(pCache->m_pDir) + 1 + 3 * 16 + sizeof(M_CSR_MeshCache_Extension);
+    pFileName = (char*)malloc(length);
+
+    // succeeded?
+    if (!pFileName)
+        return 0;
+
+    #ifdef _MSC_VER
+        sprintf_s(pFileName,
+                  length,
+                  "%s/%08x%08x%08lx%s",
+                  pCache->m_pDir,
+                  pKey->m_Hash[0],
+                  pKey->m_Hash[1],
+                  (unsigned long)pKey->m_Length,
+                  M_CSR_MeshCache_Extension);
+    #else
+        sprintf(pFileName,
+                "%s/%08x%08x%08lx%s",
+                pCache->m_pDir,
+                pKey->m_Hash[0],
+                pKey->m_Hash[1],
+                (unsigned long)pKey->m_Length,
+                M_CSR_MeshCache_Extension);
+    #endif
+
+    return pFileName;
+}
+//---------------------------------------------------------------------------
+int csrMeshCacheWriteModel(const CSR_MeshCache*    pCache,
+                           const CSR_MeshCacheKey* pKey,
+                           const CSR_Model*        pModel)
+{
+    CSR_Buffer* pBuffer;
+    int         success;
+
+    // validate the inputs
+    if (!pCache || !pKey || !pModel)
+        return 0;
+
+    pBuffer = csrBufferCreate();
+
+    // succeeded?
+    if (!pBuffer)
+        return 0;
+
+    // cook the model, and save it
+    success = csrMeshCacheWriteHeader(pBuffer, pKey, M_CSR_MeshCache_Type_Model) &&
+              csrMeshCacheWriteModelContent(pBuffer, pModel)                      &&
+              csrMeshCacheSave(pCache, pKey, pBuffer);
+
+    csrBufferRelease(pBuffer);
+
+    return success;
+}
+//---------------------------------------------------------------------------
+CSR_Model* csrMeshCacheReadModel(const CSR_MeshCache* pCache, const CSR_MeshCacheKey* pKey)
+{
+    char*       pFileName;
+    CSR_Buffer* pBuffer;
+    CSR_Model*  pModel;
+    size_t      offset = 0;
+
+    // validate the inputs
+    if (!pCache || !pKey)
+        return 0;
+
+    pFileName = csrMeshCacheGetFileName(pCache, pKey);
+
+    // succeeded?
+    if (!pFileName)
+        return 0;
+
+    // map the cooked file, if it exists
+    pBuffer = csrFileMap(pFileName);
+    free(pFileName);
+
+    // not cooked yet?
+    if (!pBuffer)
+        return 0;
+
+    pModel = csrModelCreate();
+
+    // read the model
+    if (!pModel                                                                    ||
+        !csrMeshCacheReadHeader(pBuffer, &offset, pKey, M_CSR_MeshCache_Type_Model) ||
+        !csrMeshCacheReadModelContent(pBuffer, &offset, pModel))
+    {
+        csrModelRelease(pModel, 0);
+        csrBufferRelease(pBuffer);
+        return 0;
+    }
+
+    csrBufferRelease(pBuffer);
+
+    return pModel;
+}
+//---------------------------------------------------------------------------
+int csrMeshCacheWriteMDL(const CSR_MeshCache*    pCache,
+                         const CSR_MeshCacheKey* pKey,
+                         const CSR_MDL*          pMDL)
+{
+    CSR_Buffer* pBuffer;
+    size_t      i;
+    int         success;
+
+    // validate the inputs
+    if (!pCache || !pKey || !pMDL)
+        return 0;
+
+    pBuffer = csrBufferCreate();
+
+    // succeeded?
+    if (!pBuffer)
+        return 0;
+
+    success = csrMeshCacheWriteHeader(pBuffer, pKey, M_CSR_MeshCache_Type_MDL) &&
+              csrBufferWrite(pBuffer, &pMDL->m_ModelCount, sizeof(size_t), 1);
+
+    // write the models
+    for (i = 0; success && i < pMDL->m_ModelCount; ++i)
+        success = csrMeshCacheWriteModelContent(pBuffer, &pMDL->m_pModel[i]);
+
+    // write the animations
+    success = success && csrBufferWrite(pBuffer, &pMDL->m_AnimationCount, sizeof(size_t), 1);
+
+    for (i = 0; success && i < pMDL->m_AnimationCount; ++i)
+        success = csrBufferWrite(pBuffer, pMDL->m_pAnimation[i].m_Name,   sizeof(pMDL->m_pAnimation[i].m_Name), 1) &&
+                  csrBufferWrite(pBuffer, &pMDL->m_pAnimation[i].m_Start, sizeof(size_t),                       1) &&
+                  csrBufferWrite(pBuffer, &pMDL->m_pAnimation[i].m_End,   sizeof(size_t),                       1);
+
+    // write the skins
+    success = success && csrBufferWrite(pBuffer, &pMDL->m_SkinCount, sizeof(size_t), 1);
+
+    for (i = 0; success && i < pMDL->m_SkinCount; ++i)
+        success = csrMeshCacheWriteSkin(pBuffer, &pMDL->m_pSkin[i]);
+
+    // save the cooked model
+    success = success && csrMeshCacheSave(pCache, pKey, pBuffer);
+
+    csrBufferRelease(pBuffer);
+
+    return success;
+}
+//---------------------------------------------------------------------------
+CSR_MDL* csrMeshCacheReadMDL(const CSR_MeshCache* pCache, const CSR_MeshCacheKey* pKey)
+{
+    char*       pFileName;
+    CSR_Buffer* pBuffer;
+    CSR_MDL*    pMDL;
+    size_t      count;
+    size_t      i;
+    size_t      offset  = 0;
+    int         success;
+
+    // validate the inputs
+    if (!pCache || !pKey)
+        return 0;
+
+    pFileName = csrMeshCacheGetFileName(pCache, pKey);
+
+    // succeeded?
+    if (!pFileName)
+        return 0;
+
+    // map the cooked file, if it exists
+    pBuffer = csrFileMap(pFileName);
+    free(pFileName);
+
+    // not cooked yet?
+    if (!pBuffer)
+        return 0;
+
+    // create the MDL model
+    pMDL = (CSR_MDL*)malloc(sizeof(CSR_MDL));
+
+    // succeeded?
+    if (!pMDL)
+    {
+        csrBufferRelease(pBuffer);
+        return 0;
+    }
+
+    csrMDLInit(pMDL);
+
+    success = csrMeshCacheReadHeader(pBuffer, &offset, pKey, M_CSR_MeshCache_Type_MDL) &&
+              csrBufferRead(pBuffer, &offset, sizeof(size_t), 1, &count)               &&
+              csrMeshCacheCanRead(pBuffer, offset, sizeof(size_t), count);
+
+    // read the models
+    if (success && count)
+    {
+        pMDL->m_pModel = (CSR_Model*)malloc(count * sizeof(CSR_Model));
+        success        = pMDL->m_pModel != 0;
+
+        if (success)
+        {
+            for (i = 0; i < count; ++i)
+                csrModelInit(&pMDL->m_pModel[i]);
+
+            pMDL->m_ModelCount = count;
+        }
+
+        for (i = 0; success && i < count; ++i)
+            success = csrMeshCacheReadModelContent(pBuffer, &offset, &pMDL->m_pModel[i]);
+    }
+
+    // read the animations
+    success = success                                                                &&
+              csrBufferRead(pBuffer, &offset, sizeof(size_t), 1, &count)             &&
+              csrMeshCacheCanRead(pBuffer, offset, sizeof(CSR_Animation_Frame), count);
+
+    if (success && count)
+    {
+        pMDL->m_pAnimation = (CSR_Animation_Frame*)malloc(count * sizeof(CSR_Animation_Frame));
+        success            = pMDL->m_pAnimation != 0;
+
+        if (success)
+            pMDL->m_AnimationCount = count;
+
+        for (i = 0; success && i < count; ++i)
+            success = csrBufferRead(pBuffer, &offset, sizeof(pMDL->m_pAnimation[i].m_Name), 1, pMDL->m_pAnimation[i].m_Name) &&
+                      csrBufferRead(pBuffer, &offset, sizeof(size_t),                       1, &pMDL->m_pAnimation[i].m_Start) &&
+                      csrBufferRead(pBuffer, &offset, sizeof(size_t),                       1, &pMDL->m_pAnimation[i].m_End);
+    }
+
+    // read the skins
+    success = success                                                    &&
+              csrBufferRead(pBuffer, &offset, sizeof(size_t), 1, &count) &&
+              csrMeshCacheCanRead(pBuffer, offset, sizeof(unsigned) * 3, count);
+
+    if (success && count)
+    {
+        pMDL->m_pSkin = (CSR_Skin*)malloc(count * sizeof(CSR_Skin));
+        success       = pMDL->m_pSkin != 0;
+
+        if (success)
+        {
+            for (i = 0; i < count; ++i)
+                csrSkinInit(&pMDL->m_pSkin[i]);
+
+            pMDL->m_SkinCount = count;
+        }
+
+        for (i = 0; success && i < count; ++i)
+            success = csrMeshCacheReadSkin(pBuffer, &offset, &pMDL->m_pSkin[i]);
+    }
+
+    csrBufferRelease(pBuffer);
+
+    // failed?
+    if (!success)
+    {
+        csrMDLRelease(pMDL, 0);
+        return 0;
+    }
+
+    return pMDL;
+}
+//---------------------------------------------------------------------------
+// Cached loader functions
+//---------------------------------------------------------------------------
+CSR_Model* csrMeshCacheGetWaveFront(const CSR_MeshCache*        pCache,
+                                    const CSR_Buffer*           pBuffer,
+                                    const CSR_VertexFormat*     pVertFormat,
+                                    const CSR_VertexCulling*    pVertCulling,
+                                    const CSR_Material*         pMaterial,
+                                    const CSR_fOnGetVertexColor fOnGetVertexColor,
+                                    const CSR_fOnApplySkin      fOnApplySkin,
+                                    const CSR_fOnDeleteTexture  fOnDeleteTexture)
+{
+    CSR_MeshCacheKey key;
+    CSR_Model*       pModel;
+    int              useCache;
+
+    // the vertex colors returned by the callback cannot be part of the key
+    useCache = pCache && !fOnGetVertexColor &&
+               csrMeshCacheGetKey(pBuffer, 0, pVertFormat, pVertCulling, pMaterial, &key);
+
+    // already cooked?
+    if (useCache)
+    {
+        pModel = csrMeshCacheReadModel(pCache, &key);
+
+        if (pModel)
+            return pModel;
+    }
+
+    // parse the source file
+    pModel = csrWaveFrontCreate(pBuffer,
+                                pVertFormat,
+                                pVertCulling,
+                                pMaterial,
+                                fOnGetVertexColor,
+                                fOnApplySkin,
+                                fOnDeleteTexture);
+
+    // cook it for the next time. A failure isn't an error, the model will just be parsed again
+    if (pModel && useCache)
+        csrMeshCacheWriteModel(pCache, &key, pModel);
+
+    return pModel;
+}
+//---------------------------------------------------------------------------
+CSR_MDL* csrMeshCacheGetMDL(const CSR_MeshCache*        pCache,
+                            const CSR_Buffer*           pBuffer,
+                            const CSR_Buffer*           pPalette,
+                            const CSR_VertexFormat*     pVertFormat,
+                            const CSR_VertexCulling*    pVertCulling,
+                            const CSR_Material*         pMaterial,
+                            const CSR_fOnGetVertexColor fOnGetVertexColor,
+                            const CSR_fOnApplySkin      fOnApplySkin,
+                            const CSR_fOnDeleteTexture  fOnDeleteTexture)
+{
+    CSR_MeshCacheKey key;
+    CSR_MDL*         pMDL;
+
+    // the vertex colors returned by the callback cannot be part of the key
+    if (!pCache || fOnGetVertexColor ||
+        !csrMeshCacheGetKey(pBuffer, pPalette, pVertFormat, pVertCulling, pMaterial, &key))
+        return csrMDLCreate(pBuffer,
+                            pPalette,
+                            pVertFormat,
+                            pVertCulling,
+                            pMaterial,
+                            fOnGetVertexColor,
+                            fOnApplySkin,
+                            fOnDeleteTexture);
+
+    // not cooked yet?
+    pMDL = csrMeshCacheReadMDL(pCache, &key);
+
+    if (!pMDL)
+    {
+        // parse the source file, the skins are applied later because their content should be cooked
+        pMDL = csrMDLCreate(pBuffer, pPalette, pVertFormat, pVertCulling, pMaterial, 0, 0, fOnDeleteTexture);
+
+        // failed?
+        if (!pMDL)
+            return 0;
+
+        // cook it for the next time. A failure isn't an error, the model will just be parsed again
+        csrMeshCacheWriteMDL(pCache, &key, pMDL);
+    }
+
+    // apply the skins
+    csrMDLApplySkins(pMDL, fOnApplySkin);
+
+    return pMDL;
+}
+//---------------------------------------------------------------------------
@@ -0,0 +1,223 @@
+/****************************************************************************
+ * ==> CSR_MeshCache -------------------------------------------------------*
+ ****************************************************************************
+ * Description : This module provides a cache of cooked models, i.e. models *
+ *               already parsed and stored in a binary file, which may be   *
+ *               loaded without parsing the source file again               *
+ * Developer   : Jean-Milost Reymond                                        *
+ * Copyright   : 2017 - 2022, this file is part of the CompactStar Engine.  *
+ *               You are free to copy or redistribute this file, modify it, *
+ *               or use it for your own projects, commercial or not. This   *
+ *               file is provided "as is", WITHOUT ANY WARRANTY OF ANY      *
+ *               KIND. THE DEVELOPER IS NOT RESPONSIBLE FOR ANY DAMAGE OF   *
+ *               ANY KIND, ANY LOSS OF DATA, OR ANY LOSS OF PRODUCTIVITY    *
+ *               TIME THAT MAY RESULT FROM THE USAGE OF THIS SOURCE CODE,   *
+ *               DIRECTLY OR NOT.                                           *
+ ****************************************************************************/
+
+#ifndef CSR_MeshCacheH
+#define CSR_MeshCacheH
+
+// compactStar engine
+#include "CSR_Common.h"
+#include "CSR_Texture.h"
+#include "CSR_Vertex.h"
+#include "CSR_Model.h"
+#include "CSR_Mdl.h"
+
+//---------------------------------------------------------------------------
+// Global defines
+//---------------------------------------------------------------------------
+#define M_CSR_MeshCache_ID        0x43525343 // CSRC
+#define M_CSR_MeshCache_Version   1          // should be incremented each time a cached loader changes
+#define M_CSR_MeshCache_Extension ".csrc"
+
+//---------------------------------------------------------------------------
+// Structures
+//---------------------------------------------------------------------------
+
+/**
+* Mesh cache key, identifies a cooked model by its source content and its loading options
+*/
+typedef struct
+{
+    unsigned m_Hash[2]; // two independent content hashes, to make the collisions negligible
+    size_t   m_Length;  // source content length
+} CSR_MeshCacheKey;
+
+/**
+* Mesh cache
+*/
+typedef struct
+{
+    char* m_pDir; // dir in which the cooked models are stored
+} CSR_MeshCache;
+
+#ifdef __cplusplus
+    extern "C"
+    {
+#endif
+        //-------------------------------------------------------------------
+        // Mesh cache functions
+        //-------------------------------------------------------------------
+
+        /**
+        * Creates a mesh cache
+        *@param pDir - dir in which the cooked models are stored, should already exist
+        *@return newly created mesh cache, 0 on error
+        *@note The mesh cache must be released when no longer used, see csrMeshCacheRelease()
+        */
+        CSR_MeshCache* csrMeshCacheCreate(const char* pDir);
+
+        /**
+        * Releases a mesh cache
+        *@param[in, out] pCache - mesh cache to release
+        *@note The cooked model files are kept on the disk
+        */
+        void csrMeshCacheRelease(CSR_MeshCache* pCache);
+
+        /**
+        * Initializes a mesh cache structure
+        *@param[in, out] pCache - mesh cache to initialize
+        */
+        void csrMeshCacheInit(CSR_MeshCache* pCache);
+
+        /**
+        * Gets a mesh cache key
+        *@param pSource - source model file content
+        *@param pExtra - additional content used to build the model, e.g. a palette, ignored if 0
+        *@param pVertFormat - model vertex format, if 0 the default format will be used
+        *@param pVertCulling - model vertex culling, if 0 the default culling will be used
+        *@param pMaterial - mesh material, if 0 the default material will be used
+        *@param[out] pKey - key
+        *@return 1 on success, otherwise 0
+        *@note Only the normal, texture coordinates and per-vertex color flags of the vertex format
+        *      are part of the key, the other members are calculated by the loaders
+        */
+        int csrMeshCacheGetKey(const CSR_Buffer*        pSource,
+                               const CSR_Buffer*        pExtra,
+                               const CSR_VertexFormat*  pVertFormat,
+                               const CSR_VertexCulling* pVertCulling,
+                               const CSR_Material*      pMaterial,
+                                     CSR_MeshCacheKey*  pKey);
+
+        /**
+        * Gets the cooked model file name matching with a key
+        *@param pCache - mesh cache
+        *@param pKey - key
+        *@return the file name, 0 on error
+        *@note The file name must be released with free() when no longer used
+        */
+        char* csrMeshCacheGetFileName(const CSR_MeshCache* pCache, const CSR_MeshCacheKey* pKey);
+
+        /**
+        * Writes a cooked model
+        *@param pCache - mesh cache
+        *@param pKey - key identifying the model
+        *@param pModel - model to write
+        *@return 1 on success, otherwise 0
+        *@note The file is written under a temporary name and renamed when complete, thus several
+        *      threads or processes may write the same model without reading an incomplete file
+        */
+        int csrMeshCacheWriteModel(const CSR_MeshCache*    pCache,
+                                   const CSR_MeshCacheKey* pKey,
+                                   const CSR_Model*        pModel);
+
+        /**
+        * Reads a cooked model
+        *@param pCache - mesh cache
+        *@param pKey - key identifying the model
+        *@return the model, 0 if not found or on error
+        *@note The model must be released when no longer used, see csrModelRelease()
+        */
+        CSR_Model* csrMeshCacheReadModel(const CSR_MeshCache* pCache, const CSR_MeshCacheKey* pKey);
+
+        /**
+        * Writes a cooked MDL model
+        *@param pCache - mesh cache
+        *@param pKey - key identifying the model
+        *@param pMDL - MDL model to write, its skins should still contain their pixel buffers
+        *@return 1 on success, otherwise 0
+        */
+        int csrMeshCacheWriteMDL(const CSR_MeshCache*    pCache,
+                                 const CSR_MeshCacheKey* pKey,
+                                 const CSR_MDL*          pMDL);
+
+        /**
+        * Reads a cooked MDL model
+        *@param pCache - mesh cache
+        *@param pKey - key identifying the model
+        *@return the MDL model, 0 if not found or on error
+        *@note The skins are not applied, see csrMDLApplySkins()
+        *@note The MDL model must be released when no longer used, see csrMDLRelease()
+        */
+        CSR_MDL* csrMeshCacheReadMDL(const CSR_MeshCache* pCache, const CSR_MeshCacheKey* pKey);
+
+        //-------------------------------------------------------------------
+        // Cached loader functions
+        //-------------------------------------------------------------------
+
+        /**
+        * Gets a WaveFront model from the cache, or creates and caches it if not found
+        *@param pCache - mesh cache, if 0 the model is always created from the buffer
+        *@param pBuffer - buffer containing the WaveFront file to read
+        *@param pVertFormat - model vertex format, if 0 the default format will be used
+        *@param pVertCulling - model vertex culling, if 0 the default culling will be used
+        *@param pMaterial - mesh material, if 0 the default material will be used
+        *@param fOnGetVertexColor - get vertex color callback function to use, 0 if not used
+        *@param fOnApplySkin - called when a skin should be applied to the model
+        *@param fOnDeleteTexture - callback function to notify the GPU that a texture should be deleted
+        *@return the model, 0 on error
+        *@note The cache is bypassed if a get vertex color callback is defined, because its result
+        *      cannot be part of the key
+        *@note The model must be released when no longer used, see csrModelRelease()
+        */
+        CSR_Model* csrMeshCacheGetWaveFront(const CSR_MeshCache*        pCache,
+                                            const CSR_Buffer*           pBuffer,
+                                            const CSR_VertexFormat*     pVertFormat,
+                                            const CSR_VertexCulling*    pVertCulling,
+                                            const CSR_Material*         pMaterial,
+                                            const CSR_fOnGetVertexColor fOnGetVertexColor,
+                                            const CSR_fOnApplySkin      fOnApplySkin,
+                                            const CSR_fOnDeleteTexture  fOnDeleteTexture);
+
+        /**
+        * Gets a MDL model from the cache, or creates and caches it if not found
+        *@param pCache - mesh cache, if 0 the model is always created from the buffer
+        *@param pBuffer - buffer containing the MDL file to read
+        *@param pPalette - palette to use to generate the model texture, if 0 a default palette will be used
+        *@param pVertFormat - model vertex format, if 0 the default format will be used
+        *@param pVertCulling - model vertex culling, if 0 the default culling will be used
+        *@param pMaterial - mesh material, if 0 the default material will be used
+        *@param fOnGetVertexColor - get vertex color callback function to use, 0 if not used
+        *@param fOnApplySkin - called when a skin should be applied to the model
+        *@param fOnDeleteTexture - callback function to notify the GPU that a texture should be deleted
+        *@return the MDL model, 0 on error
+        *@note The cache is bypassed if a get vertex color callback is defined, because its result
+        *      cannot be part of the key
+        *@note The MDL model must be released when no longer used, see csrMDLRelease()
+        */
+        CSR_MDL* csrMeshCacheGetMDL(const CSR_MeshCache*        pCache,
+                                    const CSR_Buffer*           pBuffer,
+                                    const CSR_Buffer*           pPalette,
+                                    const CSR_VertexFormat*     pVertFormat,
+                                    const CSR_VertexCulling*    pVertCulling,
+                                    const CSR_Material*         pMaterial,
+                                    const CSR_fOnGetVertexColor fOnGetVertexColor,
+                                    const CSR_fOnApplySkin      fOnApplySkin,
+                                    const CSR_fOnDeleteTexture  fOnDeleteTexture);
+
+#ifdef __cplusplus
+    }
+#endif
+
+//---------------------------------------------------------------------------
+// Compiler
+//---------------------------------------------------------------------------
+
+// needed in mobile c compiler to link the .h file with the .c
+#if defined(_OS_IOS_) || defined(_OS_ANDROID_) || defined(_OS_WINDOWS_)
+    #include "CSR_MeshCache.c"
+#endif
+
+#endif
@@ -2111,6 +2111,252 @@ void csrSkinWeightsInit(CSR_Skin_Weights* pSkinWeights)
     csrMat4Identity(&pSkinWeights->m_Matrix);
 }
 //---------------------------------------------------------------------------
+// Skin binding functions
+//---------------------------------------------------------------------------
+CSR_SkinBinding* csrSkinBindingCreate(const CSR_Skin_Weights_Group* pGroup,
+                                      const CSR_VertexBuffer*       pVB)
+{
+    CSR_SkinBinding* pBinding;
+    size_t           stride;
+    size_t           i;
+    size_t           j;
+    size_t           k;
+    size_t           l;
+
+    // validate the inputs
+    if (!pGroup || !pVB || !pVB->m_Format.m_Stride)
+        return 0;
+
+    stride = pVB->m_Format.m_Stride;
+
+    // create a new skin binding
+    pBinding = (CSR_SkinBinding*)malloc(sizeof(CSR_SkinBinding));
+
+    // succeeded?
+    if (!pBinding)
+        return 0;
+
+    csrSkinBindingInit(pBinding);
+
+    pBinding->m_VertexCount = pVB->m_Count / stride;
+    pBinding->m_BoneCount   = pGroup->m_Count;
+
+    // no vertex to bind?
+    if (!pBinding->m_VertexCount)
+        return pBinding;
+
+    // allocate the bone indices and weights, an empty slot has a 0 weight
+    pBinding->m_pBones   = (float*)calloc(pBinding->m_VertexCount * M_CSR_Skin_Max_Influences, sizeof(float));
+    pBinding->m_pWeights = (float*)calloc(pBinding->m_VertexCount * M_CSR_Skin_Max_Influences, sizeof(float));
+
+    // succeeded?
+    if (!pBinding->m_pBones || !pBinding->m_pWeights)
+    {
+        csrSkinBindingRelease(pBinding);
+        return 0;
+    }
+
+    // iterate through the skin weights, each of them is a bone
+    for (i = 0; i < pGroup->m_Count; ++i)
+    {
+        const CSR_Skin_Weights* pWeights = &pGroup->m_pSkinWeights[i];
+
+        // iterate through the bone weights, each of them may be shared by several vertices
+        for (j = 0; j < pWeights->m_IndexTableCount && j < pWeights->m_WeightCount; ++j)
+        {
+            const float weight = pWeights->m_pWeights[j];
+
+            // ignore the bones without influence
+            if (weight <= 0.0f)
+                continue;
+
+            for (k = 0; k < pWeights->m_pIndexTable[j].m_Count; ++k)
+            {
+                size_t weakest;
+                float* pVertexBones;
+                float* pVertexWeights;
+
+                // the indices point on the vertex position in the buffer
+                const size_t vertex = pWeights->m_pIndexTable[j].m_pData[k] / stride;
+
+                if (vertex >= pBinding->m_VertexCount)
+                    continue;
+
+                pVertexBones   = &pBinding->m_pBones  [vertex * M_CSR_Skin_Max_Influences];
+                pVertexWeights = &pBinding->m_pWeights[vertex * M_CSR_Skin_Max_Influences];
+
+                // find the weakest influence, an empty slot being the weakest of all
+                weakest = 0;
+
+                for (l = 1; l < M_CSR_Skin_Max_Influences; ++l)
+                    if (pVertexWeights[l] < pVertexWeights[weakest])
+                        weakest = l;
+
+                // replace it if the new influence is stronger
+                if (weight > pVertexWeights[weakest])
+                {
+                    pVertexBones  [weakest] = (float)i;
+                    pVertexWeights[weakest] = weight;
+                }
+            }
+        }
+    }
+
+    // normalize the kept influences
+    for (i = 0; i < pBinding->m_VertexCount; ++i)
+    {
+        float* pVertexWeights = &pBinding->m_pWeights[i * M_CSR_Skin_Max_Influences];
+        float  sum            = 0.0f;
+
+        for (j = 0; j < M_CSR_Skin_Max_Influences; ++j)
+            sum += pVertexWeights[j];
+
+        if (sum > 0.0f)
+            for (j = 0; j < M_CSR_Skin_Max_Influences; ++j)
+                pVertexWeights[j] /= sum;
+    }
+
+    return pBinding;
+}
+//---------------------------------------------------------------------------
+void csrSkinBindingRelease(CSR_SkinBinding* pBinding)
+{
+    // no skin binding to release?
+    if (!pBinding)
+        return;
+
+    // free the bone indices
+    if (pBinding->m_pBones)
+        free(pBinding->m_pBones);
+
+    // free the bone weights
+    if (pBinding->m_pWeights)
+        free(pBinding->m_pWeights);
+
+    // free the skin binding
+    free(pBinding);
+}
+//---------------------------------------------------------------------------
+void csrSkinBindingInit(CSR_SkinBinding* pBinding)
+{
+    // no skin binding to initialize?
+    if (!pBinding)
+        return;
+
+    // initialize the skin binding content
+    pBinding->m_pBones      = 0;
+    pBinding->m_pWeights    = 0;
+    pBinding->m_VertexCount = 0;
+    pBinding->m_BoneCount   = 0;
+}
+//---------------------------------------------------------------------------
+void csrSkinPaletteBuild(const CSR_Skin_Weights_Group* pGroup,
+                         const CSR_AnimationSet_Bone*  pAnimSet,
+                               size_t                  frameIndex,
+                               CSR_Matrix4*            pInitialMatrix,
+                               CSR_Matrix4*            pPalette)
+{
+    size_t i;
+
+    // validate the inputs
+    if (!pGroup || !pPalette)
+        return;
+
+    // iterate through the skin weights, each of them is a bone
+    for (i = 0; i < pGroup->m_Count; ++i)
+    {
+        CSR_Matrix4 boneMatrix;
+
+        // get the bone matrix
+        if (pAnimSet)
+            csrBoneGetAnimMatrix(pGroup->m_pSkinWeights[i].m_pBone,
+                                 pAnimSet,
+                                 frameIndex,
+                                 pInitialMatrix,
+                                &boneMatrix);
+        else
+            csrBoneGetMatrix(pGroup->m_pSkinWeights[i].m_pBone, pInitialMatrix, &boneMatrix);
+
+        // get the final matrix after bones transform
+        csrMat4Multiply(&pGroup->m_pSkinWeights[i].m_Matrix, &boneMatrix, &pPalette[i]);
+    }
+}
+//---------------------------------------------------------------------------
+int csrSkinBindingApply(const CSR_SkinBinding*  pBinding,
+                        const CSR_Matrix4*      pPalette,
+                        const CSR_VertexBuffer* pSrc,
+                              CSR_VertexBuffer* pDst)
+{
+    size_t stride;
+    size_t i;
+    size_t j;
+
+    // validate the inputs
+    if (!pBinding || !pPalette || !pSrc || !pDst || !pSrc->m_Format.m_Stride)
+        return 0;
+
+    stride = pSrc->m_Format.m_Stride;
+
+    // the binding and the buffers should match
+    if (pBinding->m_VertexCount != pSrc->m_Count / stride || pDst->m_Count < pSrc->m_Count)
+        return 0;
+
+    // copy the vertex data, then transform the skinned positions
+    memcpy(pDst->m_pData, pSrc->m_pData, pSrc->m_Count * sizeof(float));
+
+    for (i = 0; i < pBinding->m_VertexCount; ++i)
+    {
+        #ifdef _MSC_VER
+            const float* pVertexBones   = &pBinding->m_pBones  [i * M_CSR_Skin_Max_Influences];
+            const float* pVertexWeights = &pBinding->m_pWeights[i * M_CSR_Skin_Max_Influences];
+            float*       pPos           = &pDst->m_pData[i * stride];
+            int          skinned        = 0;
+            CSR_Vector3  inputVertex    = {0};
+            CSR_Vector3  outputVertex   = {0};
+            CSR_Vector3  blendedVertex  = {0};
+        #else
+            const float* pVertexBones   = &pBinding->m_pBones  [i * M_CSR_Skin_Max_Influences];
+            const float* pVertexWeights = &pBinding->m_pWeights[i * M_CSR_Skin_Max_Influences];
+            float*       pPos           = &pDst->m_pData[i * stride];
+            int          skinned        = 0;
+            CSR_Vector3  inputVertex;
+            CSR_Vector3  outputVertex;
+            CSR_Vector3  blendedVertex;
+        #endif
+
+        inputVertex.m_X   = pPos[0];
+        inputVertex.m_Y   = pPos[1];
+        inputVertex.m_Z   = pPos[2];
+        blendedVertex.m_X = 0.0f;
+        blendedVertex.m_Y = 0.0f;
+        blendedVertex.m_Z = 0.0f;
+
+        // blend the vertex transformed by each of its bones
+        for (j = 0; j < M_CSR_Skin_Max_Influences; ++j)
+        {
+            if (pVertexWeights[j] <= 0.0f)
+                continue;
+
+            csrMat4Transform(&pPalette[(size_t)pVertexBones[j]], &inputVertex, &outputVertex);
+
+            blendedVertex.m_X += outputVertex.m_X * pVertexWeights[j];
+            blendedVertex.m_Y += outputVertex.m_Y * pVertexWeights[j];
+            blendedVertex.m_Z += outputVertex.m_Z * pVertexWeights[j];
+            skinned            = 1;
+        }
+
+        // the vertices influenced by no bone keep their position
+        if (!skinned)
+            continue;
+
+        pPos[0] = blendedVertex.m_X;
+        pPos[1] = blendedVertex.m_Y;
+        pPos[2] = blendedVertex.m_Z;
+    }
+
+    return 1;
+}
+//---------------------------------------------------------------------------
 // Animation key functions
 //---------------------------------------------------------------------------
 CSR_AnimationKey* csrAnimKeyCreate(void)
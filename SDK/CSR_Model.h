@@ -22,6 +22,11 @@
 #include "CSR_Vertex.h"
 #include "CSR_Texture.h"
 
+//---------------------------------------------------------------------------
+// Global defines
+//---------------------------------------------------------------------------
+#define M_CSR_Skin_Max_Influences 4 // max bone count influencing a skinned vertex
+
 //---------------------------------------------------------------------------
 // Enumerators
 //---------------------------------------------------------------------------
@@ -109,6 +114,20 @@ typedef struct
     size_t            m_Count;        // skin weights count
 } CSR_Skin_Weights_Group;
 
+/**
+* Skin binding, it's the bones influencing each vertex of a vertex buffer
+*@note The bones are the skin weights indices in their group, thus their matrix index in a bone
+*      matrix palette, see csrSkinPaletteBuild()
+*@note The bone indices are stored as float, to be usable as vertex attributes
+*/
+typedef struct
+{
+    float* m_pBones;      // bone indices, M_CSR_Skin_Max_Influences per vertex
+    float* m_pWeights;    // bone weights, M_CSR_Skin_Max_Influences per vertex, summing to 1 if the vertex is skinned
+    size_t m_VertexCount;
+    size_t m_BoneCount;   // bone count, i.e. palette size
+} CSR_SkinBinding;
+
 /**
 * Animation key, may be a rotation, a translation, a scale, a matrix, ...
 */
@@ -517,6 +536,65 @@ typedef void (*CSR_fOnApplySkin)(size_t index, const CSR_Skin* pSkin, int* pCanR
         */
         void csrSkinWeightsInit(CSR_Skin_Weights* pSkinWeights);
 
+        //-------------------------------------------------------------------
+        // Skin binding functions
+        //-------------------------------------------------------------------
+
+        /**
+        * Creates a skin binding from the skin weights of a mesh
+        *@param pGroup - skin weights of the mesh
+        *@param pVB - mesh vertex buffer, on which the skin weights indices point
+        *@return newly created skin binding, 0 on error
+        *@note Only the M_CSR_Skin_Max_Influences strongest bones are kept for each vertex, and
+        *      their weights are normalized
+        *@note The skin binding must be released when no longer used, see csrSkinBindingRelease()
+        */
+        CSR_SkinBinding* csrSkinBindingCreate(const CSR_Skin_Weights_Group* pGroup,
+                                              const CSR_VertexBuffer*       pVB);
+
+        /**
+        * Releases a skin binding
+        *@param[in, out] pBinding - skin binding to release
+        */
+        void csrSkinBindingRelease(CSR_SkinBinding* pBinding);
+
+        /**
+        * Initializes a skin binding structure
+        *@param[in, out] pBinding - skin binding to initialize
+        */
+        void csrSkinBindingInit(CSR_SkinBinding* pBinding);
+
+        /**
+        * Builds the bone matrix palette of a mesh, i.e. the final matrix of each of its skin weights
+        *@param pGroup - skin weights of the mesh
+        *@param pAnimSet - animation set to use, if 0 the bone pose is used
+        *@param frameIndex - animation frame index, ignored if pAnimSet is 0
+        *@param pInitialMatrix - initial matrix from which the bone matrices should be get, may be 0
+        *@param[out] pPalette - palette, should contain pGroup->m_Count matrices
+        *@note The palette should be built once per frame, then it may be applied by the CPU, see
+        *      csrSkinBindingApply(), or uploaded to a skinning shader
+        */
+        void csrSkinPaletteBuild(const CSR_Skin_Weights_Group* pGroup,
+                                 const CSR_AnimationSet_Bone*  pAnimSet,
+                                       size_t                  frameIndex,
+                                       CSR_Matrix4*            pInitialMatrix,
+                                       CSR_Matrix4*            pPalette);
+
+        /**
+        * Applies a bone matrix palette on a vertex buffer
+        *@param pBinding - skin binding of the vertex buffer
+        *@param pPalette - bone matrix palette, should contain pBinding->m_BoneCount matrices
+        *@param pSrc - source vertex buffer
+        *@param[out] pDst - skinned vertex buffer, should contain as much data as the source
+        *@return 1 on success, otherwise 0
+        *@note Only the vertex positions are transformed, the remaining data is copied, and the
+        *      vertices influenced by no bone are copied unchanged
+        */
+        int csrSkinBindingApply(const CSR_SkinBinding*  pBinding,
+                                const CSR_Matrix4*      pPalette,
+                                const CSR_VertexBuffer* pSrc,
+                                      CSR_VertexBuffer* pDst);
+
         //-------------------------------------------------------------------
         // Animation key functions
         //-------------------------------------------------------------------
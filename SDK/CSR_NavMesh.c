@@ -0,0 +1,1454 @@
+/****************************************************************************
+ * ==> CSR_NavMesh ---------------------------------------------------------*
+ ****************************************************************************
+ * Description : This module provides a navigation mesh, baked from the     *
+ *               walkable polygons of a scene, and a path finding service   *
+ * Developer   : Jean-Milost Reymond                                        *
+ * Copyright   : 2017 - 2022, this file is part of the CompactStar Engine.  *
+ *               You are free to copy or redistribute this file, modify it, *
+ *               or use it for your own projects, commercial or not. This   *
+ *               file is provided "as is", WITHOUT ANY WARRANTY OF ANY      *
+ *               KIND. THE DEVELOPER IS NOT RESPONSIBLE FOR ANY DAMAGE OF   *
+ *               ANY KIND, ANY LOSS OF DATA, OR ANY LOSS OF PRODUCTIVITY    *
+ *               TIME THAT MAY RESULT FROM THE USAGE OF THIS SOURCE CODE,   *
+ *               DIRECTLY OR NOT.                                           *
+ ****************************************************************************/
+
+#include "CSR_NavMesh.h"
+
+// std
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+//---------------------------------------------------------------------------
+// Private structures
+//---------------------------------------------------------------------------
+
+/**
+* Navigation mesh sort key, used to merge the vertices, remove the duplicated polygons and
+* connect the polygons
+*/
+typedef struct
+{
+    long   m_Key[3];
+    size_t m_Index;
+    size_t m_Edge;
+} CSR_NavSortKey;
+
+/**
+* Navigation mesh search node, used by the A* algorithm
+*/
+typedef struct
+{
+    CSR_Vector3 m_Pos;       // point from which the polygon is entered, i.e. the crossed edge middle
+    float       m_Cost;      // cost from the start point
+    float       m_Score;     // cost plus estimated remaining cost
+    int         m_Parent;    // previous polygon on the path
+    size_t      m_HeapIndex; // position in the open list
+    int         m_State;     // 0 if not visited, 1 if in the open list, 2 if closed
+} CSR_NavNode;
+
+/**
+* Navigation mesh batch, used to find several paths at once
+*/
+typedef struct
+{
+    CSR_NavMesh*        m_pNavMesh;
+    CSR_NavPathRequest* m_pRequest;
+} CSR_NavBatch;
+
+//---------------------------------------------------------------------------
+// Navigation mesh private functions
+//---------------------------------------------------------------------------
+int csrNavMeshCompareKey(const void* pA, const void* pB)
+{
+    const CSR_NavSortKey* pKeyA = (const CSR_NavSortKey*)pA;
+    const CSR_NavSortKey* pKeyB = (const CSR_NavSortKey*)pB;
+    size_t                i;
+
+    for (i = 0; i < 3; ++i)
+    {
+        if (pKeyA->m_Key[i] < pKeyB->m_Key[i])
+            return -1;
+
+        if (pKeyA->m_Key[i] > pKeyB->m_Key[i])
+            return 1;
+    }
+
+    // keep the sort deterministic, qsort isn't stable
+    if (pKeyA->m_Index < pKeyB->m_Index)
+        return -1;
+
+    if (pKeyA->m_Index > pKeyB->m_Index)
+        return 1;
+
+    return 0;
+}
+//---------------------------------------------------------------------------
+int csrNavMeshSameKey(const CSR_NavSortKey* pA, const CSR_NavSortKey* pB)
+{
+    return (pA->m_Key[0] == pB->m_Key[0] && pA->m_Key[1] == pB->m_Key[1] && pA->m_Key[2] == pB->m_Key[2]);
+}
+//---------------------------------------------------------------------------
+void csrNavMeshSortIndices(const size_t* pIndex, long* pR)
+{
+    long   value;
+    size_t i;
+    size_t j;
+
+    for (i = 0; i < 3; ++i)
+        pR[i] = (long)pIndex[i];
+
+    // insertion sort, enough for 3 values
+    for (i = 1; i < 3; ++i)
+        for (j = i; j > 0 && pR[j - 1] > pR[j]; --j)
+        {
+            value     = pR[j];
+            pR[j]     = pR[j - 1];
+            pR[j - 1] = value;
+        }
+}
+//---------------------------------------------------------------------------
+int csrNavMeshWeld(CSR_NavMesh* pNavMesh)
+{
+    CSR_NavSortKey* pKey;
+    size_t*         pRemap;
+    CSR_Vector3*    pVertex;
+    size_t          count;
+    size_t          i;
+    size_t          j;
+
+    if (!pNavMesh->m_VertexCount)
+        return 1;
+
+    pKey    = (CSR_NavSortKey*)malloc(pNavMesh->m_VertexCount * sizeof(CSR_NavSortKey));
+    pRemap  = (size_t*)malloc(pNavMesh->m_VertexCount * sizeof(size_t));
+    pVertex = (CSR_Vector3*)malloc(pNavMesh->m_VertexCount * sizeof(CSR_Vector3));
+
+    if (!pKey || !pRemap || !pVertex)
+    {
+        free(pKey);
+        free(pRemap);
+        free(pVertex);
+        return 0;
+    }
+
+    // quantize the vertices on the weld tolerance
+    for (i = 0; i < pNavMesh->m_VertexCount; ++i)
+    {
+        pKey[i].m_Key[0] = (long)floor((pNavMesh->m_pVertex[i].m_X / M_CSR_NavMesh_Weld_Tolerance) + 0.5f);
+        pKey[i].m_Key[1] = (long)floor((pNavMesh->m_pVertex[i].m_Y / M_CSR_NavMesh_Weld_Tolerance) + 0.5f);
+        pKey[i].m_Key[2] = (long)floor((pNavMesh->m_pVertex[i].m_Z / M_CSR_NavMesh_Weld_Tolerance) + 0.5f);
+        pKey[i].m_Index  = i;
+        pKey[i].m_Edge   = 0;
+    }
+
+    qsort(pKey, pNavMesh->m_VertexCount, sizeof(CSR_NavSortKey), csrNavMeshCompareKey);
+
+    count = 0;
+
+    // keep one vertex per key, the first added one
+    for (i = 0; i < pNavMesh->m_VertexCount; ++i)
+    {
+        if (!i || !csrNavMeshSameKey(&pKey[i - 1], &pKey[i]))
+        {
+            pVertex[count] = pNavMesh->m_pVertex[pKey[i].m_Index];
+            ++count;
+        }
+
+        pRemap[pKey[i].m_Index] = count - 1;
+    }
+
+    // remap the polygon vertices
+    for (i = 0; i < pNavMesh->m_PolygonCount; ++i)
+        for (j = 0; j < 3; ++j)
+            pNavMesh->m_pPolygon[i].m_Vertex[j] = pRemap[pNavMesh->m_pPolygon[i].m_Vertex[j]];
+
+    free(pNavMesh->m_pVertex);
+    pNavMesh->m_pVertex        = pVertex;
+    pNavMesh->m_VertexCount    = count;
+    pNavMesh->m_VertexCapacity = pNavMesh->m_VertexCount;
+
+    free(pKey);
+    free(pRemap);
+
+    return 1;
+}
+//---------------------------------------------------------------------------
+int csrNavMeshRemoveDuplicates(CSR_NavMesh* pNavMesh)
+{
+    CSR_NavSortKey* pKey;
+    char*           pKeep;
+    size_t          count;
+    size_t          i;
+
+    if (!pNavMesh->m_PolygonCount)
+        return 1;
+
+    pKey  = (CSR_NavSortKey*)malloc(pNavMesh->m_PolygonCount * sizeof(CSR_NavSortKey));
+    pKeep = (char*)malloc(pNavMesh->m_PolygonCount);
+
+    if (!pKey || !pKeep)
+    {
+        free(pKey);
+        free(pKeep);
+        return 0;
+    }
+
+    for (i = 0; i < pNavMesh->m_PolygonCount; ++i)
+    {
+        csrNavMeshSortIndices(pNavMesh->m_pPolygon[i].m_Vertex, pKey[i].m_Key);
+        pKey[i].m_Index = i;
+        pKey[i].m_Edge  = 0;
+    }
+
+    qsort(pKey, pNavMesh->m_PolygonCount, sizeof(CSR_NavSortKey), csrNavMeshCompareKey);
+
+    // keep the first of the duplicated polygons, and drop the ones collapsed by the weld. NOTE an
+    // aligned-axis bounding box tree may store a same polygon in several leaves
+    for (i = 0; i < pNavMesh->m_PolygonCount; ++i)
+        pKeep[pKey[i].m_Index] = (pKey[i].m_Key[0] != pKey[i].m_Key[1] &&
+                                  pKey[i].m_Key[1] != pKey[i].m_Key[2] &&
+                                  (!i || !csrNavMeshSameKey(&pKey[i - 1], &pKey[i])));
+
+    count = 0;
+
+    for (i = 0; i < pNavMesh->m_PolygonCount; ++i)
+        if (pKeep[i])
+        {
+            pNavMesh->m_pPolygon[count] = pNavMesh->m_pPolygon[i];
+            ++count;
+        }
+
+    pNavMesh->m_PolygonCount = count;
+
+    free(pKey);
+    free(pKeep);
+
+    return 1;
+}
+//---------------------------------------------------------------------------
+int csrNavMeshConnect(CSR_NavMesh* pNavMesh)
+{
+    CSR_NavSortKey* pKey;
+    size_t          count;
+    size_t          i;
+    size_t          j;
+
+    for (i = 0; i < pNavMesh->m_PolygonCount; ++i)
+        for (j = 0; j < 3; ++j)
+            pNavMesh->m_pPolygon[i].m_Neighbor[j] = M_CSR_Unknown_Index;
+
+    if (!pNavMesh->m_PolygonCount)
+        return 1;
+
+    count = pNavMesh->m_PolygonCount * 3;
+    pKey  = (CSR_NavSortKey*)malloc(count * sizeof(CSR_NavSortKey));
+
+    if (!pKey)
+        return 0;
+
+    // get the edges, identified by their sorted vertex indices
+    for (i = 0; i < pNavMesh->m_PolygonCount; ++i)
+        for (j = 0; j < 3; ++j)
+        {
+            const size_t          v1    = pNavMesh->m_pPolygon[i].m_Vertex[j];
+            const size_t          v2    = pNavMesh->m_pPolygon[i].m_Vertex[(j + 1) % 3];
+                  CSR_NavSortKey* pEdge = &pKey[(i * 3) + j];
+
+            pEdge->m_Key[0] = (long)(v1 < v2 ? v1 : v2);
+            pEdge->m_Key[1] = (long)(v1 < v2 ? v2 : v1);
+            pEdge->m_Key[2] = 0;
+            pEdge->m_Index  = i;
+            pEdge->m_Edge   = j;
+        }
+
+    qsort(pKey, count, sizeof(CSR_NavSortKey), csrNavMeshCompareKey);
+
+    // connect the polygons sharing an edge. NOTE an edge shared by more than 2 polygons isn't a
+    // manifold edge, it's safer to leave it unconnected
+    for (i = 0; i < count; i = j)
+    {
+        j = i + 1;
+
+        while (j < count && csrNavMeshSameKey(&pKey[i], &pKey[j]))
+            ++j;
+
+        if (j - i != 2)
+            continue;
+
+        pNavMesh->m_pPolygon[pKey[i].m_Index].m_Neighbor[pKey[i].m_Edge]         = (int)pKey[i + 1].m_Index;
+        pNavMesh->m_pPolygon[pKey[i + 1].m_Index].m_Neighbor[pKey[i + 1].m_Edge] = (int)pKey[i].m_Index;
+    }
+
+    free(pKey);
+
+    return 1;
+}
+//---------------------------------------------------------------------------
+void csrNavMeshPolygonBounds(const CSR_NavMesh* pNavMesh, size_t index, CSR_Vector3* pMin, CSR_Vector3* pMax)
+{
+    size_t i;
+
+    *pMin = pNavMesh->m_pVertex[pNavMesh->m_pPolygon[index].m_Vertex[0]];
+    *pMax = *pMin;
+
+    for (i = 1; i < 3; ++i)
+    {
+        const CSR_Vector3* pV = &pNavMesh->m_pVertex[pNavMesh->m_pPolygon[index].m_Vertex[i]];
+
+        if (pV->m_X < pMin->m_X) pMin->m_X = pV->m_X;
+        if (pV->m_Z < pMin->m_Z) pMin->m_Z = pV->m_Z;
+        if (pV->m_X > pMax->m_X) pMax->m_X = pV->m_X;
+        if (pV->m_Z > pMax->m_Z) pMax->m_Z = pV->m_Z;
+    }
+}
+//---------------------------------------------------------------------------
+void csrNavMeshCellRange(const CSR_NavMesh* pNavMesh,
+                               float        x,
+                               float        z,
+                               size_t*      pX,
+                               size_t*      pZ)
+{
+    float fx = (x - pNavMesh->m_GridX) / pNavMesh->m_CellSize;
+    float fz = (z - pNavMesh->m_GridZ) / pNavMesh->m_CellSize;
+
+    // clamp the cell in the grid
+    if (!(fx > 0.0f))
+        fx = 0.0f;
+
+    if (!(fz > 0.0f))
+        fz = 0.0f;
+
+    *pX = (size_t)fx;
+    *pZ = (size_t)fz;
+
+    if (*pX >= pNavMesh->m_GridWidth)
+        *pX = pNavMesh->m_GridWidth - 1;
+
+    if (*pZ >= pNavMesh->m_GridDepth)
+        *pZ = pNavMesh->m_GridDepth - 1;
+}
+//---------------------------------------------------------------------------
+int csrNavMeshBuildGrid(CSR_NavMesh* pNavMesh)
+{
+    #ifdef _MSC_VER
+        CSR_Vector3 min     = {0};
+        CSR_Vector3 max     = {0};
+        CSR_Vector3 polyMin = {0};
+        CSR_Vector3 polyMax = {0};
+        float       extent;
+        size_t      cellCount;
+        size_t      total;
+        size_t      minX;
+        size_t      minZ;
+        size_t      maxX;
+        size_t      maxZ;
+        size_t      pass;
+        size_t      x;
+        size_t      z;
+        size_t      i;
+    #else
+        CSR_Vector3 min;
+        CSR_Vector3 max;
+        CSR_Vector3 polyMin;
+        CSR_Vector3 polyMax;
+        float       extent;
+        size_t      cellCount;
+        size_t      total;
+        size_t      minX;
+        size_t      minZ;
+        size_t      maxX;
+        size_t      maxZ;
+        size_t      pass;
+        size_t      x;
+        size_t      z;
+        size_t      i;
+    #endif
+
+    free(pNavMesh->m_pCellStart);
+    free(pNavMesh->m_pCellPolygon);
+    pNavMesh->m_pCellStart   = 0;
+    pNavMesh->m_pCellPolygon = 0;
+    pNavMesh->m_GridWidth    = 0;
+    pNavMesh->m_GridDepth    = 0;
+
+    if (!pNavMesh->m_PolygonCount)
+        return 1;
+
+    // calculate the mesh bounds on the ground plane
+    min = pNavMesh->m_pVertex[0];
+    max = min;
+
+    for (i = 1; i < pNavMesh->m_VertexCount; ++i)
+    {
+        const CSR_Vector3* pV = &pNavMesh->m_pVertex[i];
+
+        if (pV->m_X < min.m_X) min.m_X = pV->m_X;
+        if (pV->m_Z < min.m_Z) min.m_Z = pV->m_Z;
+        if (pV->m_X > max.m_X) max.m_X = pV->m_X;
+        if (pV->m_Z > max.m_Z) max.m_Z = pV->m_Z;
+    }
+
+    // about one polygon per cell on the longest side, on a square number of cells
+    extent = max.m_X - min.m_X;
+
+    if (max.m_Z - min.m_Z > extent)
+        extent = max.m_Z - min.m_Z;
+
+    pNavMesh->m_GridX    = min.m_X;
+    pNavMesh->m_GridZ    = min.m_Z;
+    pNavMesh->m_CellSize = extent / (float)ceil(sqrt((double)pNavMesh->m_PolygonCount));
+
+    if (pNavMesh->m_CellSize < M_CSR_NavMesh_Weld_Tolerance)
+        pNavMesh->m_CellSize = M_CSR_NavMesh_Weld_Tolerance;
+
+    pNavMesh->m_GridWidth = (size_t)((max.m_X - min.m_X) / pNavMesh->m_CellSize) + 1;
+    pNavMesh->m_GridDepth = (size_t)((max.m_Z - min.m_Z) / pNavMesh->m_CellSize) + 1;
+    cellCount             = pNavMesh->m_GridWidth * pNavMesh->m_GridDepth;
+
+    pNavMesh->m_pCellStart = (size_t*)calloc(cellCount + 1, sizeof(size_t));
+
+    if (!pNavMesh->m_pCellStart)
+        return 0;
+
+    // count the polygons in each cell on the first pass, then store them on the second one
+    for (pass = 0; pass < 2; ++pass)
+    {
+        for (i = 0; i < pNavMesh->m_PolygonCount; ++i)
+        {
+            csrNavMeshPolygonBounds(pNavMesh, i, &polyMin, &polyMax);
+            csrNavMeshCellRange(pNavMesh, polyMin.m_X, polyMin.m_Z, &minX, &minZ);
+            csrNavMeshCellRange(pNavMesh, polyMax.m_X, polyMax.m_Z, &maxX, &maxZ);
+
+            for (z = minZ; z <= maxZ; ++z)
+                for (x = minX; x <= maxX; ++x)
+                {
+                    const size_t cell = (z * pNavMesh->m_GridWidth) + x;
+
+                    if (!pass)
+                        ++pNavMesh->m_pCellStart[cell + 1];
+                    else
+                    {
+                        pNavMesh->m_pCellPolygon[pNavMesh->m_pCellStart[cell]] = i;
+                        ++pNavMesh->m_pCellStart[cell];
+                    }
+                }
+        }
+
+        if (!pass)
+        {
+            // convert the counts to start positions
+            for (i = 0; i < cellCount; ++i)
+                pNavMesh->m_pCellStart[i + 1] += pNavMesh->m_pCellStart[i];
+
+            total                    = pNavMesh->m_pCellStart[cellCount];
+            pNavMesh->m_pCellPolygon = (size_t*)malloc(total * sizeof(size_t));
+
+            if (!pNavMesh->m_pCellPolygon)
+                return 0;
+        }
+    }
+
+    // the second pass moved each start to the next cell start, restore them
+    for (i = cellCount; i > 0; --i)
+        pNavMesh->m_pCellStart[i] = pNavMesh->m_pCellStart[i - 1];
+
+    pNavMesh->m_pCellStart[0] = 0;
+
+    return 1;
+}
+//---------------------------------------------------------------------------
+int csrNavMeshProject(const CSR_NavMesh* pNavMesh, size_t index, const CSR_Vector3* pPoint, float* pY)
+{
+    const CSR_NavPolygon* pPolygon  = &pNavMesh->m_pPolygon[index];
+    const CSR_Vector3*    pA        = &pNavMesh->m_pVertex[pPolygon->m_Vertex[0]];
+    const CSR_Vector3*    pB        = &pNavMesh->m_pVertex[pPolygon->m_Vertex[1]];
+    const CSR_Vector3*    pC        = &pNavMesh->m_pVertex[pPolygon->m_Vertex[2]];
+    const float           tolerance = -0.0001f;
+          float           det;
+          float           u;
+          float           v;
+
+    // calculate the point barycentric coordinates on the ground plane
+    det = ((pB->m_X - pA->m_X) * (pC->m_Z - pA->m_Z)) - ((pC->m_X - pA->m_X) * (pB->m_Z - pA->m_Z));
+
+    if (fabs(det) < M_CSR_Epsilon)
+        return 0;
+
+    u = (((pPoint->m_X - pA->m_X) * (pC->m_Z - pA->m_Z)) - ((pC->m_X - pA->m_X) * (pPoint->m_Z - pA->m_Z))) / det;
+    v = (((pB->m_X - pA->m_X) * (pPoint->m_Z - pA->m_Z)) - ((pPoint->m_X - pA->m_X) * (pB->m_Z - pA->m_Z))) / det;
+
+    // is the point outside the polygon?
+    if (u < tolerance || v < tolerance || u + v > 1.0f - tolerance)
+        return 0;
+
+    *pY = pA->m_Y + (u * (pB->m_Y - pA->m_Y)) + (v * (pC->m_Y - pA->m_Y));
+
+    return 1;
+}
+//---------------------------------------------------------------------------
+float csrNavMeshDistance(const CSR_Vector3* pA, const CSR_Vector3* pB)
+{
+    const float x = pB->m_X - pA->m_X;
+    const float y = pB->m_Y - pA->m_Y;
+    const float z = pB->m_Z - pA->m_Z;
+
+    return sqrtf((x * x) + (y * y) + (z * z));
+}
+//---------------------------------------------------------------------------
+void csrNavMeshHeapUp(CSR_NavNode* pNode, size_t* pHeap, size_t index)
+{
+    const size_t polygon = pHeap[index];
+
+    while (index)
+    {
+        const size_t parent = (index - 1) / 2;
+
+        if (pNode[pHeap[parent]].m_Score <= pNode[polygon].m_Score)
+            break;
+
+        pHeap[index]                    = pHeap[parent];
+        pNode[pHeap[index]].m_HeapIndex = index;
+        index                           = parent;
+    }
+
+    pHeap[index]               = polygon;
+    pNode[polygon].m_HeapIndex = index;
+}
+//---------------------------------------------------------------------------
+size_t csrNavMeshHeapPop(CSR_NavNode* pNode, size_t* pHeap, size_t* pCount)
+{
+    const size_t result = pHeap[0];
+          size_t polygon;
+          size_t index;
+
+    --(*pCount);
+
+    if (!*pCount)
+        return result;
+
+    // move the last item on the top, then down to its place
+    polygon = pHeap[*pCount];
+    index   = 0;
+
+    for (;;)
+    {
+        size_t child = (index * 2) + 1;
+
+        if (child >= *pCount)
+            break;
+
+        if (child + 1 < *pCount && pNode[pHeap[child + 1]].m_Score < pNode[pHeap[child]].m_Score)
+            ++child;
+
+        if (pNode[polygon].m_Score <= pNode[pHeap[child]].m_Score)
+            break;
+
+        pHeap[index]                    = pHeap[child];
+        pNode[pHeap[index]].m_HeapIndex = index;
+        index                           = child;
+    }
+
+    pHeap[index]               = polygon;
+    pNode[polygon].m_HeapIndex = index;
+
+    return result;
+}
+//---------------------------------------------------------------------------
+int csrNavMeshSearch(const CSR_NavMesh*  pNavMesh,
+                           size_t        start,
+                           size_t        end,
+                     const CSR_Vector3*  pStart,
+                     const CSR_Vector3*  pEnd,
+                           size_t**      ppCorridor,
+                           size_t*       pCount)
+{
+    CSR_NavNode* pNode;
+    size_t*      pHeap;
+    size_t       heapCount;
+    size_t       count;
+    size_t       i;
+    int          polygon;
+    int          found;
+
+    pNode = (CSR_NavNode*)calloc(pNavMesh->m_PolygonCount, sizeof(CSR_NavNode));
+    pHeap = (size_t*)malloc(pNavMesh->m_PolygonCount * sizeof(size_t));
+
+    if (!pNode || !pHeap)
+    {
+        free(pNode);
+        free(pHeap);
+        return 0;
+    }
+
+    // open the start polygon
+    pNode[start].m_Pos    = *pStart;
+    pNode[start].m_Cost   = 0.0f;
+    pNode[start].m_Score  = csrNavMeshDistance(pStart, pEnd);
+    pNode[start].m_Parent = M_CSR_Unknown_Index;
+    pNode[start].m_State  = 1;
+    pHeap[0]              = start;
+    heapCount             = 1;
+    found                 = 0;
+
+    while (heapCount)
+    {
+        const size_t current = csrNavMeshHeapPop(pNode, pHeap, &heapCount);
+
+        if (current == end)
+        {
+            found = 1;
+            break;
+        }
+
+        pNode[current].m_State = 2;
+
+        // visit the neighbors. The cost is the distance between the crossed edge middles, which
+        // follows the shortest path more closely than the distance between the polygon centers
+        for (i = 0; i < 3; ++i)
+        {
+            const int          neighbor = pNavMesh->m_pPolygon[current].m_Neighbor[i];
+            const CSR_Vector3* pV1;
+            const CSR_Vector3* pV2;
+                  CSR_Vector3  pos;
+                  float        cost;
+
+            if (neighbor == M_CSR_Unknown_Index || pNode[neighbor].m_State == 2)
+                continue;
+
+            pV1      = &pNavMesh->m_pVertex[pNavMesh->m_pPolygon[current].m_Vertex[i]];
+            pV2      = &pNavMesh->m_pVertex[pNavMesh->m_pPolygon[current].m_Vertex[(i + 1) % 3]];
+            pos.m_X  = (pV1->m_X + pV2->m_X) * 0.5f;
+            pos.m_Y  = (pV1->m_Y + pV2->m_Y) * 0.5f;
+            pos.m_Z  = (pV1->m_Z + pV2->m_Z) * 0.5f;
+            cost     = pNode[current].m_Cost + csrNavMeshDistance(&pNode[current].m_Pos, &pos);
+
+            // the end polygon is reached by its end point
+            if ((size_t)neighbor == end)
+                cost += csrNavMeshDistance(&pos, pEnd);
+
+            if (pNode[neighbor].m_State == 1 && cost >= pNode[neighbor].m_Cost)
+                continue;
+
+            pNode[neighbor].m_Pos    = pos;
+            pNode[neighbor].m_Cost   = cost;
+            pNode[neighbor].m_Score  = cost + csrNavMeshDistance(&pos, pEnd);
+            pNode[neighbor].m_Parent = (int)current;
+
+            if (pNode[neighbor].m_State != 1)
+            {
+                pNode[neighbor].m_State     = 1;
+                pNode[neighbor].m_HeapIndex = heapCount;
+                pHeap[heapCount]            = (size_t)neighbor;
+                ++heapCount;
+            }
+
+            csrNavMeshHeapUp(pNode, pHeap, pNode[neighbor].m_HeapIndex);
+        }
+    }
+
+    free(pHeap);
+
+    if (!found)
+    {
+        free(pNode);
+        return 0;
+    }
+
+    // count the crossed polygons, then copy them from the start to the end
+    count = 0;
+
+    for (polygon = (int)end; polygon != M_CSR_Unknown_Index; polygon = pNode[polygon].m_Parent)
+        ++count;
+
+    *ppCorridor = (size_t*)malloc(count * sizeof(size_t));
+
+    if (!*ppCorridor)
+    {
+        free(pNode);
+        return 0;
+    }
+
+    *pCount = count;
+
+    for (polygon = (int)end; polygon != M_CSR_Unknown_Index; polygon = pNode[polygon].m_Parent)
+        (*ppCorridor)[--count] = (size_t)polygon;
+
+    free(pNode);
+
+    return 1;
+}
+//---------------------------------------------------------------------------
+float csrNavMeshTriArea2(const CSR_Vector3* pA, const CSR_Vector3* pB, const CSR_Vector3* pC)
+{
+    return ((pC->m_X - pA->m_X) * (pB->m_Z - pA->m_Z)) - ((pB->m_X - pA->m_X) * (pC->m_Z - pA->m_Z));
+}
+//---------------------------------------------------------------------------
+int csrNavMeshSamePoint(const CSR_Vector3* pA, const CSR_Vector3* pB)
+{
+    const float x = pB->m_X - pA->m_X;
+    const float z = pB->m_Z - pA->m_Z;
+
+    return ((x * x) + (z * z)) < (M_CSR_NavMesh_Weld_Tolerance * M_CSR_NavMesh_Weld_Tolerance);
+}
+//---------------------------------------------------------------------------
+int csrNavMeshPullPath(const CSR_NavMesh*  pNavMesh,
+                       const size_t*       pCorridor,
+                             size_t        count,
+                       const CSR_Vector3*  pStart,
+                       const CSR_Vector3*  pEnd,
+                             CSR_NavPath*  pPath)
+{
+    #ifdef _MSC_VER
+        CSR_Vector3* pLeft;
+        CSR_Vector3* pRight;
+        CSR_Vector3  apex        = {0};
+        CSR_Vector3  portalLeft  = {0};
+        CSR_Vector3  portalRight = {0};
+        size_t       portalCount;
+        size_t       apexIndex;
+        size_t       leftIndex;
+        size_t       rightIndex;
+        size_t       i;
+        size_t       j;
+    #else
+        CSR_Vector3* pLeft;
+        CSR_Vector3* pRight;
+        CSR_Vector3  apex;
+        CSR_Vector3  portalLeft;
+        CSR_Vector3  portalRight;
+        size_t       portalCount;
+        size_t       apexIndex;
+        size_t       leftIndex;
+        size_t       rightIndex;
+        size_t       i;
+        size_t       j;
+    #endif
+
+    portalCount = count + 1;
+
+    pLeft           = (CSR_Vector3*)malloc(portalCount * sizeof(CSR_Vector3));
+    pRight          = (CSR_Vector3*)malloc(portalCount * sizeof(CSR_Vector3));
+    pPath->m_pPoint = (CSR_Vector3*)malloc((count + 2) * sizeof(CSR_Vector3));
+
+    if (!pLeft || !pRight || !pPath->m_pPoint)
+    {
+        free(pLeft);
+        free(pRight);
+        csrNavPathContentRelease(pPath);
+        return 0;
+    }
+
+    // get the portals, i.e. the edges shared by the crossed polygons, sorted from the travel
+    // direction point of view. The first and last portals are the start and end points
+    pLeft[0]  = *pStart;
+    pRight[0] = *pStart;
+
+    for (i = 1; i < count; ++i)
+    {
+        const CSR_NavPolygon* pFrom = &pNavMesh->m_pPolygon[pCorridor[i - 1]];
+
+        for (j = 0; j < 3; ++j)
+            if (pFrom->m_Neighbor[j] == (int)pCorridor[i])
+                break;
+
+        pRight[i] = pNavMesh->m_pVertex[pFrom->m_Vertex[j]];
+        pLeft[i]  = pNavMesh->m_pVertex[pFrom->m_Vertex[(j + 1) % 3]];
+
+        if (csrNavMeshTriArea2(&pFrom->m_Center, &pRight[i], &pLeft[i]) > 0.0f)
+        {
+            apex      = pLeft[i];
+            pLeft[i]  = pRight[i];
+            pRight[i] = apex;
+        }
+    }
+
+    pLeft[count]  = *pEnd;
+    pRight[count] = *pEnd;
+
+    // pull the path through the portals, using the simple stupid funnel algorithm
+    pPath->m_pPoint[0] = *pStart;
+    pPath->m_Count     = 1;
+    pPath->m_Current   = 0;
+
+    apex        = *pStart;
+    portalLeft  = pLeft[0];
+    portalRight = pRight[0];
+    apexIndex   = 0;
+    leftIndex   = 0;
+    rightIndex  = 0;
+
+    for (i = 1; i < portalCount; ++i)
+    {
+        // update the right side of the funnel
+        if (csrNavMeshTriArea2(&apex, &portalRight, &pRight[i]) <= 0.0f)
+        {
+            if (csrNavMeshSamePoint(&apex, &portalRight) ||
+                csrNavMeshTriArea2(&apex, &portalLeft, &pRight[i]) > 0.0f)
+            {
+                // tighten the funnel
+                portalRight = pRight[i];
+                rightIndex  = i;
+            }
+            else
+            {
+                // the right side crosses the left one, the left point becomes a path corner
+                pPath->m_pPoint[pPath->m_Count] = portalLeft;
+                ++pPath->m_Count;
+
+                apex        = portalLeft;
+                apexIndex   = leftIndex;
+                portalLeft  = apex;
+                portalRight = apex;
+                leftIndex   = apexIndex;
+                rightIndex  = apexIndex;
+                i           = apexIndex;
+                continue;
+            }
+        }
+
+        // update the left side of the funnel
+        if (csrNavMeshTriArea2(&apex, &portalLeft, &pLeft[i]) >= 0.0f)
+        {
+            if (csrNavMeshSamePoint(&apex, &portalLeft) ||
+                csrNavMeshTriArea2(&apex, &portalRight, &pLeft[i]) < 0.0f)
+            {
+                // tighten the funnel
+                portalLeft = pLeft[i];
+                leftIndex  = i;
+            }
+            else
+            {
+                // the left side crosses the right one, the right point becomes a path corner
+                pPath->m_pPoint[pPath->m_Count] = portalRight;
+                ++pPath->m_Count;
+
+                apex        = portalRight;
+                apexIndex   = rightIndex;
+                portalLeft  = apex;
+                portalRight = apex;
+                leftIndex   = apexIndex;
+                rightIndex  = apexIndex;
+                i           = apexIndex;
+                continue;
+            }
+        }
+    }
+
+    // add the end point, unless it was already added as a corner
+    if (!csrNavMeshSamePoint(&pPath->m_pPoint[pPath->m_Count - 1], pEnd) || pPath->m_Count == 1)
+    {
+        pPath->m_pPoint[pPath->m_Count] = *pEnd;
+        ++pPath->m_Count;
+    }
+    else
+        pPath->m_pPoint[pPath->m_Count - 1] = *pEnd;
+
+    free(pLeft);
+    free(pRight);
+
+    return 1;
+}
+//---------------------------------------------------------------------------
+size_t csrNavMeshCacheIndex(int start, int end)
+{
+    return ((((size_t)start) * 2654435761u) ^ (size_t)end) % M_CSR_NavMesh_Cache_Size;
+}
+//---------------------------------------------------------------------------
+void csrNavMeshFindPathIndex(void* pArg, size_t index)
+{
+    CSR_NavBatch*       pBatch   = (CSR_NavBatch*)pArg;
+    CSR_NavPathRequest* pRequest = &pBatch->m_pRequest[index];
+
+    pRequest->m_Found = csrNavMeshFindPath(pBatch->m_pNavMesh,
+                                          &pRequest->m_Start,
+                                          &pRequest->m_End,
+                                           pRequest->m_MaxDist,
+                                          &pRequest->m_Path);
+}
+//---------------------------------------------------------------------------
+// Navigation mesh functions
+//---------------------------------------------------------------------------
+CSR_NavMesh* csrNavMeshCreate(void)
+{
+    // create a new navigation mesh
+    CSR_NavMesh* pNavMesh = (CSR_NavMesh*)malloc(sizeof(CSR_NavMesh));
+
+    // succeeded?
+    if (!pNavMesh)
+        return 0;
+
+    // initialize the navigation mesh content
+    csrNavMeshInit(pNavMesh);
+
+    return pNavMesh;
+}
+//---------------------------------------------------------------------------
+void csrNavMeshRelease(CSR_NavMesh* pNavMesh)
+{
+    // no navigation mesh to release?
+    if (!pNavMesh)
+        return;
+
+    csrNavMeshClearCache(pNavMesh);
+
+    // free the navigation mesh content
+    free(pNavMesh->m_pVertex);
+    free(pNavMesh->m_pPolygon);
+    free(pNavMesh->m_pCellStart);
+    free(pNavMesh->m_pCellPolygon);
+    csrMutexRelease(pNavMesh->m_pCacheLock);
+
+    // free the navigation mesh
+    free(pNavMesh);
+}
+//---------------------------------------------------------------------------
+void csrNavMeshInit(CSR_NavMesh* pNavMesh)
+{
+    size_t i;
+
+    // no navigation mesh to initialize?
+    if (!pNavMesh)
+        return;
+
+    // initialize the navigation mesh
+    pNavMesh->m_pVertex         = 0;
+    pNavMesh->m_VertexCount     = 0;
+    pNavMesh->m_VertexCapacity  = 0;
+    pNavMesh->m_pPolygon        = 0;
+    pNavMesh->m_PolygonCount    = 0;
+    pNavMesh->m_PolygonCapacity = 0;
+    pNavMesh->m_MaxSlope        = M_CSR_NavMesh_Default_Max_Slope;
+    pNavMesh->m_GridX           = 0.0f;
+    pNavMesh->m_GridZ           = 0.0f;
+    pNavMesh->m_CellSize        = 0.0f;
+    pNavMesh->m_GridWidth       = 0;
+    pNavMesh->m_GridDepth       = 0;
+    pNavMesh->m_pCellStart      = 0;
+    pNavMesh->m_pCellPolygon    = 0;
+    pNavMesh->m_CacheHits       = 0;
+    pNavMesh->m_CacheMisses     = 0;
+    pNavMesh->m_pCacheLock      = 0;
+
+    for (i = 0; i < M_CSR_NavMesh_Cache_Size; ++i)
+    {
+        pNavMesh->m_Cache[i].m_Start     = M_CSR_Unknown_Index;
+        pNavMesh->m_Cache[i].m_End       = M_CSR_Unknown_Index;
+        pNavMesh->m_Cache[i].m_pCorridor = 0;
+        pNavMesh->m_Cache[i].m_Count     = 0;
+    }
+}
+//---------------------------------------------------------------------------
+int csrNavMeshAddPolygon(      CSR_NavMesh*  pNavMesh,
+                         const CSR_Polygon3* pPolygon,
+                         const CSR_Matrix4*  pMatrix)
+{
+    #ifdef _MSC_VER
+        CSR_Vector3     vertex[3] = {0};
+        CSR_Vector3     ab        = {0};
+        CSR_Vector3     ac        = {0};
+        CSR_Vector3     normal    = {0};
+        CSR_NavPolygon* pNavPolygon;
+        float           length;
+        size_t          i;
+    #else
+        CSR_Vector3     vertex[3];
+        CSR_Vector3     ab;
+        CSR_Vector3     ac;
+        CSR_Vector3     normal;
+        CSR_NavPolygon* pNavPolygon;
+        float           length;
+        size_t          i;
+    #endif
+
+    // validate the inputs
+    if (!pNavMesh || !pPolygon)
+        return 0;
+
+    for (i = 0; i < 3; ++i)
+        if (pMatrix)
+            csrMat4Transform(pMatrix, &pPolygon->m_Vertex[i], &vertex[i]);
+        else
+            vertex[i] = pPolygon->m_Vertex[i];
+
+    // is the polygon walkable? NOTE the polygon winding is unknown, so both faces are accepted
+    csrVec3Sub(&vertex[1], &vertex[0], &ab);
+    csrVec3Sub(&vertex[2], &vertex[0], &ac);
+    csrVec3Cross(&ab, &ac, &normal);
+    csrVec3Length(&normal, &length);
+
+    if (length < M_CSR_Epsilon || fabs(normal.m_Y) < pNavMesh->m_MaxSlope * length)
+        return 1;
+
+    // reserve the place for the new polygon
+    if (pNavMesh->m_VertexCount + 3 > pNavMesh->m_VertexCapacity)
+    {
+        const size_t capacity = pNavMesh->m_VertexCapacity ? pNavMesh->m_VertexCapacity * 2 : 96;
+        CSR_Vector3* pVertex  = (CSR_Vector3*)csrMemoryAlloc(pNavMesh->m_pVertex, sizeof(CSR_Vector3), capacity);
+
+        if (!pVertex)
+            return 0;
+
+        pNavMesh->m_pVertex        = pVertex;
+        pNavMesh->m_VertexCapacity = capacity;
+    }
+
+    if (pNavMesh->m_PolygonCount + 1 > pNavMesh->m_PolygonCapacity)
+    {
+        const size_t    capacity    = pNavMesh->m_PolygonCapacity ? pNavMesh->m_PolygonCapacity * 2 : 32;
+        CSR_NavPolygon* pNewPolygon = (CSR_NavPolygon*)csrMemoryAlloc(pNavMesh->m_pPolygon,
+                                                                      sizeof(CSR_NavPolygon),
+                                                                      capacity);
+
+        if (!pNewPolygon)
+            return 0;
+
+        pNavMesh->m_pPolygon        = pNewPolygon;
+        pNavMesh->m_PolygonCapacity = capacity;
+    }
+
+    // add the polygon, its vertices are merged with the other ones while the mesh is built
+    pNavPolygon = &pNavMesh->m_pPolygon[pNavMesh->m_PolygonCount];
+
+    for (i = 0; i < 3; ++i)
+    {
+        pNavMesh->m_pVertex[pNavMesh->m_VertexCount + i] = vertex[i];
+        pNavPolygon->m_Vertex[i]                         = pNavMesh->m_VertexCount + i;
+        pNavPolygon->m_Neighbor[i]                       = M_CSR_Unknown_Index;
+    }
+
+    pNavMesh->m_VertexCount += 3;
+    ++pNavMesh->m_PolygonCount;
+
+    return 1;
+}
+//---------------------------------------------------------------------------
+int csrNavMeshAddTree(      CSR_NavMesh*  pNavMesh,
+                      const CSR_AABBNode* pTree,
+                      const CSR_Matrix4*  pMatrix)
+{
+    CSR_Polygon3 polygon;
+    size_t       i;
+
+    // validate the inputs
+    if (!pNavMesh || !pTree)
+        return 0;
+
+    // leaf reached?
+    if (!pTree->m_pLeft && !pTree->m_pRight)
+    {
+        if (!pTree->m_pPolygonBuffer)
+            return 1;
+
+        // add the leaf polygons
+        for (i = 0; i < pTree->m_pPolygonBuffer->m_Count; ++i)
+            if (csrIndexedPolygonToPolygon(&pTree->m_pPolygonBuffer->m_pIndexedPolygon[i], &polygon))
+                if (!csrNavMeshAddPolygon(pNavMesh, &polygon, pMatrix))
+                    return 0;
+
+        return 1;
+    }
+
+    if (pTree->m_pLeft && !csrNavMeshAddTree(pNavMesh, pTree->m_pLeft, pMatrix))
+        return 0;
+
+    if (pTree->m_pRight && !csrNavMeshAddTree(pNavMesh, pTree->m_pRight, pMatrix))
+        return 0;
+
+    return 1;
+}
+//---------------------------------------------------------------------------
+int csrNavMeshAddHeightField(      CSR_NavMesh*     pNavMesh,
+                             const CSR_HeightField* pHF,
+                             const CSR_Matrix4*     pMatrix)
+{
+    CSR_Polygon3 polygon;
+    size_t       x;
+    size_t       z;
+    size_t       i;
+
+    // validate the inputs
+    if (!pNavMesh || !pHF || !pHF->m_pHeight || pHF->m_Width < 2 || pHF->m_Depth < 2)
+        return 0;
+
+    // add the 2 polygons of each cell, the same way as the height field builds them
+    for (z = 0; z < pHF->m_Depth - 1; ++z)
+        for (x = 0; x < pHF->m_Width - 1; ++x)
+        {
+            const size_t index = (z * pHF->m_Width) + x;
+            const size_t corner[4] = {index, index + 1, index + pHF->m_Width, index + pHF->m_Width + 1};
+                  size_t polygonIndex;
+
+            for (polygonIndex = 0; polygonIndex < 2; ++polygonIndex)
+            {
+                for (i = 0; i < 3; ++i)
+                {
+                    const size_t vertex = corner[polygonIndex + i];
+
+                    polygon.m_Vertex[i].m_X = pHF->m_X + ((float)(vertex % pHF->m_Width) * pHF->m_Scale);
+                    polygon.m_Vertex[i].m_Y = pHF->m_pHeight[vertex];
+                    polygon.m_Vertex[i].m_Z = pHF->m_Z - ((float)(vertex / pHF->m_Width) * pHF->m_Scale);
+                }
+
+                if (!csrNavMeshAddPolygon(pNavMesh, &polygon, pMatrix))
+                    return 0;
+            }
+        }
+
+    return 1;
+}
+//---------------------------------------------------------------------------
+int csrNavMeshAddScene(CSR_NavMesh* pNavMesh, const CSR_Scene* pScene)
+{
+    size_t i;
+    size_t j;
+
+    // validate the inputs
+    if (!pNavMesh || !pScene)
+        return 0;
+
+    for (i = 0; i < pScene->m_ItemCount; ++i)
+    {
+        const CSR_SceneItem* pItem = &pScene->m_pItem[i];
+
+        // only the ground items are walkable
+        if (!(pItem->m_CollisionType & CSR_CO_Ground) || !pItem->m_pMatrixArray)
+            continue;
+
+        if (!pItem->m_pHeightField &&
+            (!pItem->m_pAABBTree || pItem->m_AABBTreeIndex >= pItem->m_AABBTreeCount))
+            continue;
+
+        // add the item once per matrix
+        for (j = 0; j < pItem->m_pMatrixArray->m_Count; ++j)
+        {
+            const CSR_Matrix4* pMatrix = (const CSR_Matrix4*)pItem->m_pMatrixArray->m_pItem[j].m_pData;
+                  int          success;
+
+            if (pItem->m_pHeightField)
+                success = csrNavMeshAddHeightField(pNavMesh, pItem->m_pHeightField, pMatrix);
+            else
+                success = csrNavMeshAddTree(pNavMesh, &pItem->m_pAABBTree[pItem->m_AABBTreeIndex], pMatrix);
+
+            if (!success)
+                return 0;
+        }
+    }
+
+    return 1;
+}
+//---------------------------------------------------------------------------
+int csrNavMeshBuild(CSR_NavMesh* pNavMesh)
+{
+    size_t i;
+    size_t j;
+
+    // validate the input
+    if (!pNavMesh)
+        return 0;
+
+    // the cached paths may no longer be valid
+    csrNavMeshClearCache(pNavMesh);
+
+    // the cache lock is required to find the paths from several threads
+    if (!pNavMesh->m_pCacheLock)
+    {
+        pNavMesh->m_pCacheLock = csrMutexCreate();
+
+        if (!pNavMesh->m_pCacheLock)
+            return 0;
+    }
+
+    if (!csrNavMeshWeld(pNavMesh)             ||
+        !csrNavMeshRemoveDuplicates(pNavMesh) ||
+        !csrNavMeshConnect(pNavMesh))
+        return 0;
+
+    // calculate the polygon centers
+    for (i = 0; i < pNavMesh->m_PolygonCount; ++i)
+    {
+        CSR_NavPolygon* pPolygon = &pNavMesh->m_pPolygon[i];
+
+        pPolygon->m_Center.m_X = 0.0f;
+        pPolygon->m_Center.m_Y = 0.0f;
+        pPolygon->m_Center.m_Z = 0.0f;
+
+        for (j = 0; j < 3; ++j)
+        {
+            pPolygon->m_Center.m_X += pNavMesh->m_pVertex[pPolygon->m_Vertex[j]].m_X;
+            pPolygon->m_Center.m_Y += pNavMesh->m_pVertex[pPolygon->m_Vertex[j]].m_Y;
+            pPolygon->m_Center.m_Z += pNavMesh->m_pVertex[pPolygon->m_Vertex[j]].m_Z;
+        }
+
+        pPolygon->m_Center.m_X /= 3.0f;
+        pPolygon->m_Center.m_Y /= 3.0f;
+        pPolygon->m_Center.m_Z /= 3.0f;
+    }
+
+    return csrNavMeshBuildGrid(pNavMesh);
+}
+//---------------------------------------------------------------------------
+int csrNavMeshFindPolygon(const CSR_NavMesh*  pNavMesh,
+                          const CSR_Vector3*  pPoint,
+                                float         maxDist,
+                                CSR_Vector3*  pR)
+{
+    size_t x;
+    size_t z;
+    size_t cell;
+    size_t i;
+    float  bestDist;
+    float  bestY;
+    float  y;
+    int    result;
+
+    // validate the inputs
+    if (!pNavMesh || !pPoint || !pNavMesh->m_pCellStart)
+        return M_CSR_Unknown_Index;
+
+    // is the point outside the grid? NOTE written to also reject the NaN values
+    if (!(pPoint->m_X >= pNavMesh->m_GridX &&
+          pPoint->m_X <= pNavMesh->m_GridX + ((float)pNavMesh->m_GridWidth * pNavMesh->m_CellSize) &&
+          pPoint->m_Z >= pNavMesh->m_GridZ &&
+          pPoint->m_Z <= pNavMesh->m_GridZ + ((float)pNavMesh->m_GridDepth * pNavMesh->m_CellSize)))
+        return M_CSR_Unknown_Index;
+
+    csrNavMeshCellRange(pNavMesh, pPoint->m_X, pPoint->m_Z, &x, &z);
+
+    cell     = (z * pNavMesh->m_GridWidth) + x;
+    result   = M_CSR_Unknown_Index;
+    bestDist = maxDist;
+    bestY    = 0.0f;
+
+    // find the nearest polygon vertically among the ones overlapping the cell
+    for (i = pNavMesh->m_pCellStart[cell]; i < pNavMesh->m_pCellStart[cell + 1]; ++i)
+    {
+        const size_t polygon = pNavMesh->m_pCellPolygon[i];
+
+        if (!csrNavMeshProject(pNavMesh, polygon, pPoint, &y))
+            continue;
+
+        if (fabs(y - pPoint->m_Y) > bestDist)
+            continue;
+
+        bestDist = (float)fabs(y - pPoint->m_Y);
+        bestY    = y;
+        result   = (int)polygon;
+    }
+
+    if (result != M_CSR_Unknown_Index && pR)
+    {
+        pR->m_X = pPoint->m_X;
+        pR->m_Y = bestY;
+        pR->m_Z = pPoint->m_Z;
+    }
+
+    return result;
+}
+//---------------------------------------------------------------------------
+int csrNavMeshFindPath(      CSR_NavMesh* pNavMesh,
+                       const CSR_Vector3* pStart,
+                       const CSR_Vector3* pEnd,
+                             float        maxDist,
+                             CSR_NavPath* pPath)
+{
+    #ifdef _MSC_VER
+        CSR_NavPathCacheEntry* pEntry;
+        CSR_Vector3            start = {0};
+        CSR_Vector3            end   = {0};
+        size_t*                pCorridor;
+        size_t                 count;
+        int                    startPolygon;
+        int                    endPolygon;
+        int                    result;
+    #else
+        CSR_NavPathCacheEntry* pEntry;
+        CSR_Vector3            start;
+        CSR_Vector3            end;
+        size_t*                pCorridor;
+        size_t                 count;
+        int                    startPolygon;
+        int                    endPolygon;
+        int                    result;
+    #endif
+
+    // validate the inputs
+    if (!pNavMesh || !pStart || !pEnd || !pPath)
+        return 0;
+
+    csrNavPathContentRelease(pPath);
+
+    // get the start and end polygons, and the start and end points on the mesh
+    startPolygon = csrNavMeshFindPolygon(pNavMesh, pStart, maxDist, &start);
+
+    if (startPolygon == M_CSR_Unknown_Index)
+        return 0;
+
+    endPolygon = csrNavMeshFindPolygon(pNavMesh, pEnd, maxDist, &end);
+
+    if (endPolygon == M_CSR_Unknown_Index)
+        return 0;
+
+    pCorridor = 0;
+    count     = 0;
+    pEntry    = &pNavMesh->m_Cache[csrNavMeshCacheIndex(startPolygon, endPolygon)];
+
+    // search for the crossed polygons in the cache
+    csrMutexLock(pNavMesh->m_pCacheLock);
+
+    if (pNavMesh->m_pCacheLock && pEntry->m_Start == startPolygon && pEntry->m_End == endPolygon)
+    {
+        pCorridor = (size_t*)malloc(pEntry->m_Count * sizeof(size_t));
+
+        if (pCorridor)
+        {
+            memcpy(pCorridor, pEntry->m_pCorridor, pEntry->m_Count * sizeof(size_t));
+            count = pEntry->m_Count;
+            ++pNavMesh->m_CacheHits;
+        }
+    }
+
+    csrMutexUnlock(pNavMesh->m_pCacheLock);
+
+    // not found, search them with the A* algorithm
+    if (!pCorridor)
+    {
+        if (!csrNavMeshSearch(pNavMesh,
+                              (size_t)startPolygon,
+                              (size_t)endPolygon,
+                             &start,
+                             &end,
+                             &pCorridor,
+                             &count))
+            return 0;
+
+        // keep them in the cache
+        if (pNavMesh->m_pCacheLock)
+        {
+            size_t* pCached = (size_t*)malloc(count * sizeof(size_t));
+
+            if (pCached)
+            {
+                memcpy(pCached, pCorridor, count * sizeof(size_t));
+
+                csrMutexLock(pNavMesh->m_pCacheLock);
+
+                free(pEntry->m_pCorridor);
+                pEntry->m_Start     = startPolygon;
+                pEntry->m_End       = endPolygon;
+                pEntry->m_pCorridor = pCached;
+                pEntry->m_Count     = count;
+                ++pNavMesh->m_CacheMisses;
+
+                csrMutexUnlock(pNavMesh->m_pCacheLock);
+            }
+        }
+    }
+
+    // smooth the path
+    result = csrNavMeshPullPath(pNavMesh, pCorridor, count, &start, &end, pPath);
+
+    free(pCorridor);
+
+    return result;
+}
+//---------------------------------------------------------------------------
+void csrNavMeshFindPaths(CSR_NavMesh*        pNavMesh,
+                         CSR_NavPathRequest* pRequest,
+                         size_t              count,
+                         CSR_JobPool*        pPool)
+{
+    CSR_NavBatch batch;
+
+    // validate the inputs
+    if (!pNavMesh || !pRequest || !count)
+        return;
+
+    batch.m_pNavMesh = pNavMesh;
+    batch.m_pRequest = pRequest;
+
+    csrJobPoolParallelFor(pPool, count, csrNavMeshFindPathIndex, &batch);
+}
+//---------------------------------------------------------------------------
+void csrNavMeshClearCache(CSR_NavMesh* pNavMesh)
+{
+    size_t i;
+
+    // validate the input
+    if (!pNavMesh)
+        return;
+
+    csrMutexLock(pNavMesh->m_pCacheLock);
+
+    for (i = 0; i < M_CSR_NavMesh_Cache_Size; ++i)
+    {
+        free(pNavMesh->m_Cache[i].m_pCorridor);
+
+        pNavMesh->m_Cache[i].m_Start     = M_CSR_Unknown_Index;
+        pNavMesh->m_Cache[i].m_End       = M_CSR_Unknown_Index;
+        pNavMesh->m_Cache[i].m_pCorridor = 0;
+        pNavMesh->m_Cache[i].m_Count     = 0;
+    }
+
+    csrMutexUnlock(pNavMesh->m_pCacheLock);
+}
+//---------------------------------------------------------------------------
+// Navigation path functions
+//---------------------------------------------------------------------------
+void csrNavPathContentRelease(CSR_NavPath* pPath)
+{
+    // no navigation path to release?
+    if (!pPath)
+        return;
+
+    free(pPath->m_pPoint);
+
+    csrNavPathInit(pPath);
+}
+//---------------------------------------------------------------------------
+void csrNavPathInit(CSR_NavPath* pPath)
+{
+    // no navigation path to initialize?
+    if (!pPath)
+        return;
+
+    pPath->m_pPoint  = 0;
+    pPath->m_Count   = 0;
+    pPath->m_Current = 0;
+}
+//---------------------------------------------------------------------------
+int csrNavPathFollow(      CSR_NavPath* pPath,
+                     const CSR_Vector3* pPos,
+                           float        reachDist,
+                           CSR_Vector3* pR)
+{
+    // validate the inputs
+    if (!pPath || !pPos || !pR || !pPath->m_Count)
+        return 0;
+
+    // skip the reached points
+    while (pPath->m_Current < pPath->m_Count)
+    {
+        const float x = pPath->m_pPoint[pPath->m_Current].m_X - pPos->m_X;
+        const float z = pPath->m_pPoint[pPath->m_Current].m_Z - pPos->m_Z;
+
+        if ((x * x) + (z * z) > reachDist * reachDist)
+            break;
+
+        ++pPath->m_Current;
+    }
+
+    // end reached?
+    if (pPath->m_Current >= pPath->m_Count)
+    {
+        *pR = pPath->m_pPoint[pPath->m_Count - 1];
+        return 0;
+    }
+
+    *pR = pPath->m_pPoint[pPath->m_Current];
+
+    return 1;
+}
+//---------------------------------------------------------------------------
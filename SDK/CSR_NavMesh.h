@@ -0,0 +1,284 @@
+/****************************************************************************
+ * ==> CSR_NavMesh ---------------------------------------------------------*
+ ****************************************************************************
+ * Description : This module provides a navigation mesh, baked from the     *
+ *               walkable polygons of a scene, and a path finding service   *
+ * Developer   : Jean-Milost Reymond                                        *
+ * Copyright   : 2017 - 2022, this file is part of the CompactStar Engine.  *
+ *               You are free to copy or redistribute this file, modify it, *
+ *               or use it for your own projects, commercial or not. This   *
+ *               file is provided "as is", WITHOUT ANY WARRANTY OF ANY      *
+ *               KIND. THE DEVELOPER IS NOT RESPONSIBLE FOR ANY DAMAGE OF   *
+ *               ANY KIND, ANY LOSS OF DATA, OR ANY LOSS OF PRODUCTIVITY    *
+ *               TIME THAT MAY RESULT FROM THE USAGE OF THIS SOURCE CODE,   *
+ *               DIRECTLY OR NOT.                                           *
+ ****************************************************************************/
+
+#ifndef CSR_NavMeshH
+#define CSR_NavMeshH
+
+// compactStar engine
+#include "CSR_Common.h"
+#include "CSR_Geometry.h"
+#include "CSR_Collision.h"
+#include "CSR_HeightField.h"
+#include "CSR_Scene.h"
+#include "CSR_Job.h"
+
+//---------------------------------------------------------------------------
+// Global defines
+//---------------------------------------------------------------------------
+#define M_CSR_NavMesh_Default_Max_Slope 0.7071f // cosine of the steepest walkable slope, i.e. 45 degrees
+#define M_CSR_NavMesh_Weld_Tolerance    0.001f  // distance below which 2 vertices are merged
+#define M_CSR_NavMesh_Cache_Size        64      // path cache entry count
+
+//---------------------------------------------------------------------------
+// Structures
+//---------------------------------------------------------------------------
+
+/**
+* Navigation mesh polygon
+*/
+typedef struct
+{
+    size_t      m_Vertex[3];   // vertex indices
+    int         m_Neighbor[3]; // polygon sharing the edge from m_Vertex[i] to m_Vertex[(i + 1) % 3], M_CSR_Unknown_Index if none
+    CSR_Vector3 m_Center;
+} CSR_NavPolygon;
+
+/**
+* Navigation mesh path cache entry, i.e. the polygons crossed between 2 polygons
+*/
+typedef struct
+{
+    int     m_Start;    // start polygon index, M_CSR_Unknown_Index if the entry is empty
+    int     m_End;      // end polygon index
+    size_t* m_pCorridor;
+    size_t  m_Count;
+} CSR_NavPathCacheEntry;
+
+/**
+* Navigation mesh
+*@note The polygons are added in the world coordinates, then the mesh is built. Once built, the
+*      mesh is read only, and the path finding functions may be called from several threads
+*/
+typedef struct
+{
+    CSR_Vector3*          m_pVertex;
+    size_t                m_VertexCount;
+    size_t                m_VertexCapacity;
+    CSR_NavPolygon*       m_pPolygon;
+    size_t                m_PolygonCount;
+    size_t                m_PolygonCapacity;
+    float                 m_MaxSlope;                      // cosine of the steepest walkable slope
+    float                 m_GridX;                         // grid origin on the x axis
+    float                 m_GridZ;                         // grid origin on the z axis
+    float                 m_CellSize;
+    size_t                m_GridWidth;                     // cell count on the x axis
+    size_t                m_GridDepth;                     // cell count on the z axis
+    size_t*               m_pCellStart;                    // first polygon of each cell in m_pCellPolygon, plus the end
+    size_t*               m_pCellPolygon;                  // polygons overlapping each cell
+    CSR_NavPathCacheEntry m_Cache[M_CSR_NavMesh_Cache_Size];
+    size_t                m_CacheHits;
+    size_t                m_CacheMisses;
+    CSR_Mutex*            m_pCacheLock;
+} CSR_NavMesh;
+
+/**
+* Navigation path
+*/
+typedef struct
+{
+    CSR_Vector3* m_pPoint;
+    size_t       m_Count;
+    size_t       m_Current; // point the agent is currently walking to
+} CSR_NavPath;
+
+/**
+* Navigation path request, used to find several paths at once
+*/
+typedef struct
+{
+    CSR_Vector3 m_Start;
+    CSR_Vector3 m_End;
+    float       m_MaxDist; // max vertical distance between the points and the navigation mesh
+    CSR_NavPath m_Path;    // found path
+    int         m_Found;   // 1 if the path was found, otherwise 0
+} CSR_NavPathRequest;
+
+#ifdef __cplusplus
+    extern "C"
+    {
+#endif
+        //-------------------------------------------------------------------
+        // Navigation mesh functions
+        //-------------------------------------------------------------------
+
+        /**
+        * Creates a navigation mesh
+        *@return newly created navigation mesh, 0 on error
+        *@note The navigation mesh must be released when no longer used, see csrNavMeshRelease()
+        */
+        CSR_NavMesh* csrNavMeshCreate(void);
+
+        /**
+        * Releases a navigation mesh
+        *@param[in, out] pNavMesh - navigation mesh to release
+        */
+        void csrNavMeshRelease(CSR_NavMesh* pNavMesh);
+
+        /**
+        * Initializes a navigation mesh structure
+        *@param[in, out] pNavMesh - navigation mesh to initialize
+        */
+        void csrNavMeshInit(CSR_NavMesh* pNavMesh);
+
+        /**
+        * Adds a polygon to a navigation mesh
+        *@param[in, out] pNavMesh - navigation mesh
+        *@param pPolygon - polygon to add
+        *@param pMatrix - matrix to apply to the polygon, ignored if 0
+        *@return 1 on success, otherwise 0
+        *@note The polygon is ignored, but the function succeeds, if it isn't walkable, i.e. if it's
+        *      degenerated or steeper than the navigation mesh max slope
+        *@note The navigation mesh should be built after the polygons are added, see csrNavMeshBuild()
+        */
+        int csrNavMeshAddPolygon(      CSR_NavMesh*  pNavMesh,
+                                 const CSR_Polygon3* pPolygon,
+                                 const CSR_Matrix4*  pMatrix);
+
+        /**
+        * Adds the walkable polygons of an aligned-axis bounding box tree to a navigation mesh
+        *@param[in, out] pNavMesh - navigation mesh
+        *@param pTree - tree containing the polygons to add
+        *@param pMatrix - matrix to apply to the polygons, ignored if 0
+        *@return 1 on success, otherwise 0
+        */
+        int csrNavMeshAddTree(      CSR_NavMesh*  pNavMesh,
+                              const CSR_AABBNode* pTree,
+                              const CSR_Matrix4*  pMatrix);
+
+        /**
+        * Adds the walkable polygons of a height field to a navigation mesh
+        *@param[in, out] pNavMesh - navigation mesh
+        *@param pHF - height field containing the polygons to add
+        *@param pMatrix - matrix to apply to the polygons, ignored if 0
+        *@return 1 on success, otherwise 0
+        */
+        int csrNavMeshAddHeightField(      CSR_NavMesh*     pNavMesh,
+                                     const CSR_HeightField* pHF,
+                                     const CSR_Matrix4*     pMatrix);
+
+        /**
+        * Adds the walkable polygons of a scene to a navigation mesh
+        *@param[in, out] pNavMesh - navigation mesh
+        *@param pScene - scene containing the polygons to add
+        *@return 1 on success, otherwise 0
+        *@note Only the items detecting the ground collisions are added, using their height field
+        *      if they have one, otherwise their collision aligned-axis bounding box tree
+        */
+        int csrNavMeshAddScene(CSR_NavMesh* pNavMesh, const CSR_Scene* pScene);
+
+        /**
+        * Builds a navigation mesh, i.e. merges its vertices and connects its polygons
+        *@param[in, out] pNavMesh - navigation mesh to build
+        *@return 1 on success, otherwise 0
+        *@note The path cache is cleared
+        */
+        int csrNavMeshBuild(CSR_NavMesh* pNavMesh);
+
+        /**
+        * Finds the navigation mesh polygon below or above a point
+        *@param pNavMesh - navigation mesh
+        *@param pPoint - point
+        *@param maxDist - max vertical distance between the point and the polygon
+        *@param[out] pR - point projected on the polygon, ignored if 0
+        *@return polygon index, M_CSR_Unknown_Index if not found
+        */
+        int csrNavMeshFindPolygon(const CSR_NavMesh*  pNavMesh,
+                                  const CSR_Vector3*  pPoint,
+                                        float         maxDist,
+                                        CSR_Vector3*  pR);
+
+        /**
+        * Finds a path between 2 points
+        *@param[in, out] pNavMesh - navigation mesh
+        *@param pStart - path start point
+        *@param pEnd - path end point
+        *@param maxDist - max vertical distance between the points and the navigation mesh
+        *@param[out] pPath - found path, its previous content is released
+        *@return 1 if a path was found, otherwise 0
+        *@note The polygons to cross are found with the A* algorithm, and cached, then the path is
+        *      smoothed by pulling it through the crossed polygon edges
+        *@note This function is thread safe, once the navigation mesh is built
+        */
+        int csrNavMeshFindPath(      CSR_NavMesh* pNavMesh,
+                               const CSR_Vector3* pStart,
+                               const CSR_Vector3* pEnd,
+                                     float        maxDist,
+                                     CSR_NavPath* pPath);
+
+        /**
+        * Finds several paths at once
+        *@param[in, out] pNavMesh - navigation mesh
+        *@param[in, out] pRequest - path requests, the found paths are written in them
+        *@param count - request count
+        *@param[in, out] pPool - job pool on which the paths are found, if 0 they are found in the
+        *                        calling thread
+        */
+        void csrNavMeshFindPaths(CSR_NavMesh*        pNavMesh,
+                                 CSR_NavPathRequest* pRequest,
+                                 size_t              count,
+                                 CSR_JobPool*        pPool);
+
+        /**
+        * Clears the navigation mesh path cache
+        *@param[in, out] pNavMesh - navigation mesh
+        */
+        void csrNavMeshClearCache(CSR_NavMesh* pNavMesh);
+
+        //-------------------------------------------------------------------
+        // Navigation path functions
+        //-------------------------------------------------------------------
+
+        /**
+        * Releases a navigation path content
+        *@param[in, out] pPath - navigation path for which the content should be released
+        */
+        void csrNavPathContentRelease(CSR_NavPath* pPath);
+
+        /**
+        * Initializes a navigation path structure
+        *@param[in, out] pPath - navigation path to initialize
+        */
+        void csrNavPathInit(CSR_NavPath* pPath);
+
+        /**
+        * Follows a navigation path
+        *@param[in, out] pPath - navigation path to follow
+        *@param pPos - agent position
+        *@param reachDist - horizontal distance below which a path point is considered as reached
+        *@param[out] pR - point the agent should walk to
+        *@return 1 while the path end isn't reached, otherwise 0
+        *@note This function is cheap, and may be called on each frame instead of probing the
+        *      scene collisions
+        */
+        int csrNavPathFollow(      CSR_NavPath* pPath,
+                             const CSR_Vector3* pPos,
+                                   float        reachDist,
+                                   CSR_Vector3* pR);
+
+#ifdef __cplusplus
+    }
+#endif
+
+//---------------------------------------------------------------------------
+// Compiler
+//---------------------------------------------------------------------------
+
+// needed in mobile c compiler to link the .h file with the .c
+#if defined(_OS_IOS_) || defined(_OS_ANDROID_) || defined(_OS_WINDOWS_)
+    #include "CSR_NavMesh.c"
+#endif
+
+#endif
@@ -18,6 +18,8 @@
 // std
 #include <stdlib.h>
 #include <string.h>
+#include <float.h>
+#include <math.h>
 
 //---------------------------------------------------------------------------
 // Particle private functions
@@ -59,6 +61,301 @@ CSR_Particle* csrParticleDeleteFrom(CSR_Particle* pParticle, size_t index, size_
     return pNewParticle;
 }
 //---------------------------------------------------------------------------
+// Particle engine private structures
+//---------------------------------------------------------------------------
+
+/**
+* Particle engine animation step, shared by the jobs
+*/
+typedef struct
+{
+    CSR_ParticleEngine* m_pEngine;
+    size_t*             m_pChunkSlot;    // killed particle count per chunk, then first free slot per chunk
+    size_t              m_Count;         // slot count to animate
+    size_t              m_ChunkSize;
+    CSR_Vector3         m_Acceleration;  // velocity to add, already multiplied by the elapsed time
+    CSR_Vector3         m_Turbulence;    // max random velocity to add, already multiplied by the elapsed time
+    unsigned            m_TurbulenceKey; // random key of the current animation
+    int                 m_HasTurbulence;
+    float               m_Damping;
+    float               m_Time;          // elapsed time, in seconds
+} CSR_ParticleEngineStep;
+
+/**
+* Particle engine vertex buffer writer, shared by the jobs
+*/
+typedef struct
+{
+    const CSR_ParticleEngine* m_pEngine;
+    const CSR_VertexBuffer*   m_pShape;
+          CSR_VertexBuffer*   m_pVB;
+          size_t*             m_pChunkSlot; // alive particle count per chunk, then first written particle per chunk
+          size_t              m_ChunkSize;
+} CSR_ParticleEngineWriter;
+
+//---------------------------------------------------------------------------
+// Particle engine private functions
+//---------------------------------------------------------------------------
+unsigned csrParticleEngineHash(unsigned value)
+{
+    // integer hash, each input bit changes about the half of the output bits
+    value &= 0xFFFFFFFF;
+    value ^= value >> 16;
+    value  = (value * 0x7FEB352D) & 0xFFFFFFFF;
+    value ^= value >> 15;
+    value  = (value * 0x846CA68B) & 0xFFFFFFFF;
+    value ^= value >> 16;
+
+    return value;
+}
+//---------------------------------------------------------------------------
+float csrParticleEngineRandom(unsigned key, unsigned counter, float min, float max)
+{
+    // counter based generator, the value only depends on the key and on the position in the
+    // stream, thus several threads may generate the values of the same stream in any order
+    const unsigned value = csrParticleEngineHash(key ^ csrParticleEngineHash(counter));
+
+    // keep the 24 highest bits, which fit exactly in the float mantissa
+    return min + ((max - min) * ((float)(value >> 8) * (1.0f / 16777216.0f)));
+}
+//---------------------------------------------------------------------------
+int csrParticleEngineResize(void** ppStream, size_t itemSize, size_t capacity)
+{
+    // resize the stream
+    void* pStream = csrMemoryAlloc(*ppStream, itemSize, capacity);
+
+    // succeeded?
+    if (!pStream)
+        return 0;
+
+    *ppStream = pStream;
+
+    return 1;
+}
+//---------------------------------------------------------------------------
+void csrParticleEngineWrap(float* pStream, size_t count, float min, float max)
+{
+    const float size = max - min;
+    size_t      i;
+
+    // empty bounds?
+    if (size <= 0.0f)
+        return;
+
+    // move the particles which left the bounds on the opposite side
+    for (i = 0; i < count; ++i)
+        if (pStream[i] < min)
+            pStream[i] += size;
+        else
+        if (pStream[i] > max)
+            pStream[i] -= size;
+}
+//---------------------------------------------------------------------------
+size_t* csrParticleEngineCreateChunkSlots(size_t count, size_t* pChunkSize, size_t* pChunkCount, size_t* pLocal)
+{
+    size_t* pChunkSlot;
+
+    *pChunkSize  = M_CSR_Particle_Chunk_Size;
+    *pChunkCount = (count + M_CSR_Particle_Chunk_Size - 1) / M_CSR_Particle_Chunk_Size;
+
+    // a single chunk may use the local slots
+    if (*pChunkCount <= 1)
+        return pLocal;
+
+    // one more slot is used to store the total
+    pChunkSlot = (size_t*)malloc((*pChunkCount + 1) * sizeof(size_t));
+
+    // succeeded?
+    if (pChunkSlot)
+        return pChunkSlot;
+
+    // not enough memory, process all the particles in a single chunk. NOTE the result is the same,
+    // as it doesn't depend on the chunk size
+    *pChunkSize  = count;
+    *pChunkCount = 1;
+
+    return pLocal;
+}
+//---------------------------------------------------------------------------
+void csrParticleEngineAnimateChunk(void* pArg, size_t index)
+{
+    CSR_ParticleEngineStep* pStep     = (CSR_ParticleEngineStep*)pArg;
+    CSR_ParticleEngine*     pEngine   = pStep->m_pEngine;
+    size_t                  start     = index * pStep->m_ChunkSize;
+    size_t                  end       = start + pStep->m_ChunkSize;
+    size_t                  killCount = 0;
+    size_t                  i;
+    unsigned                counter;
+
+    if (end > pStep->m_Count)
+        end = pStep->m_Count;
+
+    // integrate the velocities and the positions. NOTE each loop reads and writes contiguous
+    // streams without branching, thus the compiler may vectorize it. The killed particles are
+    // also integrated, which is cheaper than testing their alive flag
+    if (pStep->m_Acceleration.m_X != 0.0f ||
+        pStep->m_Acceleration.m_Y != 0.0f ||
+        pStep->m_Acceleration.m_Z != 0.0f ||
+        pStep->m_Damping          != 1.0f)
+        for (i = start; i < end; ++i)
+        {
+            pEngine->m_pVelX[i] = (pEngine->m_pVelX[i] + pStep->m_Acceleration.m_X) * pStep->m_Damping;
+            pEngine->m_pVelY[i] = (pEngine->m_pVelY[i] + pStep->m_Acceleration.m_Y) * pStep->m_Damping;
+            pEngine->m_pVelZ[i] = (pEngine->m_pVelZ[i] + pStep->m_Acceleration.m_Z) * pStep->m_Damping;
+        }
+
+    // apply the turbulence, the random stream position only depends on the particle index
+    if (pStep->m_HasTurbulence)
+        for (i = start; i < end; ++i)
+        {
+            counter = (unsigned)i * 4;
+
+            pEngine->m_pVelX[i] += csrParticleEngineRandom(pStep->m_TurbulenceKey,
+                                                           counter,
+                                                          -pStep->m_Turbulence.m_X,
+                                                           pStep->m_Turbulence.m_X);
+            pEngine->m_pVelY[i] += csrParticleEngineRandom(pStep->m_TurbulenceKey,
+                                                           counter + 1,
+                                                          -pStep->m_Turbulence.m_Y,
+                                                           pStep->m_Turbulence.m_Y);
+            pEngine->m_pVelZ[i] += csrParticleEngineRandom(pStep->m_TurbulenceKey,
+                                                           counter + 2,
+                                                          -pStep->m_Turbulence.m_Z,
+                                                           pStep->m_Turbulence.m_Z);
+        }
+
+    for (i = start; i < end; ++i)
+    {
+        pEngine->m_pX[i] += pEngine->m_pVelX[i] * pStep->m_Time;
+        pEngine->m_pY[i] += pEngine->m_pVelY[i] * pStep->m_Time;
+        pEngine->m_pZ[i] += pEngine->m_pVelZ[i] * pStep->m_Time;
+    }
+
+    for (i = start; i < end; ++i)
+        pEngine->m_pLifetime[i] -= pStep->m_Time;
+
+    // move the particles which left the bounds on the opposite side
+    if (pEngine->m_BoundsMode == CSR_PB_Wrap)
+    {
+        csrParticleEngineWrap(&pEngine->m_pX[start],
+                               end - start,
+                               pEngine->m_Bounds.m_Min.m_X,
+                               pEngine->m_Bounds.m_Max.m_X);
+        csrParticleEngineWrap(&pEngine->m_pY[start],
+                               end - start,
+                               pEngine->m_Bounds.m_Min.m_Y,
+                               pEngine->m_Bounds.m_Max.m_Y);
+        csrParticleEngineWrap(&pEngine->m_pZ[start],
+                               end - start,
+                               pEngine->m_Bounds.m_Min.m_Z,
+                               pEngine->m_Bounds.m_Max.m_Z);
+    }
+
+    // mark the expired particles, and the ones which left the bounds. NOTE they are added to the
+    // free list later, once the first free slot of each chunk is known
+    for (i = start; i < end; ++i)
+    {
+        // already killed?
+        if (!pEngine->m_pAlive[i])
+            continue;
+
+        // still alive and inside the bounds?
+        if (pEngine->m_pLifetime[i] > 0.0f &&
+           (pEngine->m_BoundsMode != CSR_PB_Kill ||
+           (pEngine->m_pX[i] >= pEngine->m_Bounds.m_Min.m_X && pEngine->m_pX[i] <= pEngine->m_Bounds.m_Max.m_X &&
+            pEngine->m_pY[i] >= pEngine->m_Bounds.m_Min.m_Y && pEngine->m_pY[i] <= pEngine->m_Bounds.m_Max.m_Y &&
+            pEngine->m_pZ[i] >= pEngine->m_Bounds.m_Min.m_Z && pEngine->m_pZ[i] <= pEngine->m_Bounds.m_Max.m_Z)))
+            continue;
+
+        pEngine->m_pAlive[i] = 2;
+        ++killCount;
+    }
+
+    pStep->m_pChunkSlot[index] = killCount;
+}
+//---------------------------------------------------------------------------
+void csrParticleEngineFreeChunk(void* pArg, size_t index)
+{
+    CSR_ParticleEngineStep* pStep   = (CSR_ParticleEngineStep*)pArg;
+    CSR_ParticleEngine*     pEngine = pStep->m_pEngine;
+    size_t                  start   = index * pStep->m_ChunkSize;
+    size_t                  end     = start + pStep->m_ChunkSize;
+    size_t                  slot    = pStep->m_pChunkSlot[index];
+    size_t                  i;
+
+    // nothing was killed in this chunk?
+    if (slot == pStep->m_pChunkSlot[index + 1])
+        return;
+
+    if (end > pStep->m_Count)
+        end = pStep->m_Count;
+
+    // add the marked particles to the free list
+    for (i = start; i < end; ++i)
+        if (pEngine->m_pAlive[i] == 2)
+        {
+            pEngine->m_pAlive[i]   = 0;
+            pEngine->m_pFree[slot] = i;
+            ++slot;
+        }
+}
+//---------------------------------------------------------------------------
+void csrParticleEngineCountChunk(void* pArg, size_t index)
+{
+    CSR_ParticleEngineWriter* pWriter    = (CSR_ParticleEngineWriter*)pArg;
+    size_t                    start      = index * pWriter->m_ChunkSize;
+    size_t                    end        = start + pWriter->m_ChunkSize;
+    size_t                    aliveCount = 0;
+    size_t                    i;
+
+    if (end > pWriter->m_pEngine->m_Count)
+        end = pWriter->m_pEngine->m_Count;
+
+    for (i = start; i < end; ++i)
+        if (pWriter->m_pEngine->m_pAlive[i])
+            ++aliveCount;
+
+    pWriter->m_pChunkSlot[index] = aliveCount;
+}
+//---------------------------------------------------------------------------
+void csrParticleEngineWriteChunk(void* pArg, size_t index)
+{
+    CSR_ParticleEngineWriter* pWriter = (CSR_ParticleEngineWriter*)pArg;
+    const CSR_ParticleEngine* pEngine = pWriter->m_pEngine;
+    const CSR_VertexBuffer*   pShape  = pWriter->m_pShape;
+    size_t                    start   = index * pWriter->m_ChunkSize;
+    size_t                    end     = start + pWriter->m_ChunkSize;
+    size_t                    stride  = pShape->m_Format.m_Stride;
+    size_t                    i;
+    size_t                    j;
+    float*                    pData;
+
+    if (end > pEngine->m_Count)
+        end = pEngine->m_Count;
+
+    // get the location of the first particle of this chunk
+    pData = pWriter->m_pVB->m_pData + (pWriter->m_pChunkSlot[index] * pShape->m_Count);
+
+    // iterate through the alive particles
+    for (i = start; i < end; ++i)
+    {
+        if (!pEngine->m_pAlive[i])
+            continue;
+
+        // copy the shape and move it to the particle position
+        memcpy(pData, pShape->m_pData, pShape->m_Count * sizeof(float));
+
+        for (j = 0; j < pShape->m_Count; j += stride)
+        {
+            pData[j]     += pEngine->m_pX[i];
+            pData[j + 1] += pEngine->m_pY[i];
+            pData[j + 2] += pEngine->m_pZ[i];
+        }
+
+        pData += pShape->m_Count;
+    }
+}
+//---------------------------------------------------------------------------
 // Particle functions
 //---------------------------------------------------------------------------
 CSR_Particle* csrParticleCreate(void)
@@ -263,3 +560,513 @@ void csrParticlesAnimate(CSR_Particles* pParticles, float elapsedTime)
         pParticles->m_fOnCalculateMotion(pParticles, &pParticles->m_pParticle[i], elapsedTime);
 }
 //---------------------------------------------------------------------------
+// Particle emitter functions
+//---------------------------------------------------------------------------
+void csrParticleEmitterInit(CSR_ParticleEmitter* pEmitter)
+{
+    // no particle emitter to initialize?
+    if (!pEmitter)
+        return;
+
+    // initialize the particle emitter
+    pEmitter->m_Box.m_Min.m_X   = 0.0f;
+    pEmitter->m_Box.m_Min.m_Y   = 0.0f;
+    pEmitter->m_Box.m_Min.m_Z   = 0.0f;
+    pEmitter->m_Box.m_Max.m_X   = 0.0f;
+    pEmitter->m_Box.m_Max.m_Y   = 0.0f;
+    pEmitter->m_Box.m_Max.m_Z   = 0.0f;
+    pEmitter->m_MinVelocity.m_X = 0.0f;
+    pEmitter->m_MinVelocity.m_Y = 0.0f;
+    pEmitter->m_MinVelocity.m_Z = 0.0f;
+    pEmitter->m_MaxVelocity.m_X = 0.0f;
+    pEmitter->m_MaxVelocity.m_Y = 0.0f;
+    pEmitter->m_MaxVelocity.m_Z = 0.0f;
+    pEmitter->m_MinLifetime     = 0.0f;
+    pEmitter->m_MaxLifetime     = 0.0f;
+    pEmitter->m_Rate            = 0.0f;
+    pEmitter->m_Elapsed         = 0.0f;
+    pEmitter->m_Seed            = 1;
+    pEmitter->m_Counter         = 0;
+}
+//---------------------------------------------------------------------------
+// Particle engine functions
+//---------------------------------------------------------------------------
+CSR_ParticleEngine* csrParticleEngineCreate(void)
+{
+    // create a new particle engine
+    CSR_ParticleEngine* pEngine = (CSR_ParticleEngine*)malloc(sizeof(CSR_ParticleEngine));
+
+    // succeeded?
+    if (!pEngine)
+        return 0;
+
+    // initialize the particle engine content
+    csrParticleEngineInit(pEngine);
+
+    return pEngine;
+}
+//---------------------------------------------------------------------------
+void csrParticleEngineRelease(CSR_ParticleEngine* pEngine)
+{
+    // no particle engine to release?
+    if (!pEngine)
+        return;
+
+    // free the particle streams
+    free(pEngine->m_pX);
+    free(pEngine->m_pY);
+    free(pEngine->m_pZ);
+    free(pEngine->m_pVelX);
+    free(pEngine->m_pVelY);
+    free(pEngine->m_pVelZ);
+    free(pEngine->m_pLifetime);
+    free(pEngine->m_pAlive);
+    free(pEngine->m_pFree);
+
+    // free the emitters and forces
+    free(pEngine->m_pEmitter);
+    free(pEngine->m_pForce);
+
+    // free the particle engine
+    free(pEngine);
+}
+//---------------------------------------------------------------------------
+void csrParticleEngineInit(CSR_ParticleEngine* pEngine)
+{
+    // no particle engine to initialize?
+    if (!pEngine)
+        return;
+
+    // initialize the particle engine
+    pEngine->m_pX               = 0;
+    pEngine->m_pY               = 0;
+    pEngine->m_pZ               = 0;
+    pEngine->m_pVelX            = 0;
+    pEngine->m_pVelY            = 0;
+    pEngine->m_pVelZ            = 0;
+    pEngine->m_pLifetime        = 0;
+    pEngine->m_pAlive           = 0;
+    pEngine->m_pFree            = 0;
+    pEngine->m_Count            = 0;
+    pEngine->m_Capacity         = 0;
+    pEngine->m_FreeCount        = 0;
+    pEngine->m_pEmitter         = 0;
+    pEngine->m_EmitterCount     = 0;
+    pEngine->m_pForce           = 0;
+    pEngine->m_ForceCount       = 0;
+    pEngine->m_Bounds.m_Min.m_X = 0.0f;
+    pEngine->m_Bounds.m_Min.m_Y = 0.0f;
+    pEngine->m_Bounds.m_Min.m_Z = 0.0f;
+    pEngine->m_Bounds.m_Max.m_X = 0.0f;
+    pEngine->m_Bounds.m_Max.m_Y = 0.0f;
+    pEngine->m_Bounds.m_Max.m_Z = 0.0f;
+    pEngine->m_BoundsMode       = CSR_PB_None;
+    pEngine->m_Seed             = 1;
+    pEngine->m_Frame            = 0;
+}
+//---------------------------------------------------------------------------
+int csrParticleEngineReserve(CSR_ParticleEngine* pEngine, size_t capacity)
+{
+    // validate the input
+    if (!pEngine)
+        return 0;
+
+    // already enough memory?
+    if (capacity <= pEngine->m_Capacity)
+        return 1;
+
+    // resize all the streams. NOTE the engine remains valid if one of them fails, because the
+    // capacity is only updated once all the streams are resized
+    if (!csrParticleEngineResize((void**)&pEngine->m_pX,        sizeof(float),         capacity) ||
+        !csrParticleEngineResize((void**)&pEngine->m_pY,        sizeof(float),         capacity) ||
+        !csrParticleEngineResize((void**)&pEngine->m_pZ,        sizeof(float),         capacity) ||
+        !csrParticleEngineResize((void**)&pEngine->m_pVelX,     sizeof(float),         capacity) ||
+        !csrParticleEngineResize((void**)&pEngine->m_pVelY,     sizeof(float),         capacity) ||
+        !csrParticleEngineResize((void**)&pEngine->m_pVelZ,     sizeof(float),         capacity) ||
+        !csrParticleEngineResize((void**)&pEngine->m_pLifetime, sizeof(float),         capacity) ||
+        !csrParticleEngineResize((void**)&pEngine->m_pAlive,    sizeof(unsigned char), capacity) ||
+        !csrParticleEngineResize((void**)&pEngine->m_pFree,     sizeof(size_t),        capacity))
+        return 0;
+
+    pEngine->m_Capacity = capacity;
+
+    return 1;
+}
+//---------------------------------------------------------------------------
+CSR_ParticleEmitter* csrParticleEngineAddEmitter(      CSR_ParticleEngine*  pEngine,
+                                                 const CSR_ParticleEmitter* pEmitter)
+{
+    CSR_ParticleEmitter* pNewEmitter;
+
+    // validate the inputs
+    if (!pEngine || !pEmitter)
+        return 0;
+
+    // add a new emitter to the engine
+    pNewEmitter = (CSR_ParticleEmitter*)csrMemoryAlloc(pEngine->m_pEmitter,
+                                                       sizeof(CSR_ParticleEmitter),
+                                                       pEngine->m_EmitterCount + 1);
+
+    // succeeded?
+    if (!pNewEmitter)
+        return 0;
+
+    // copy the emitter
+    pNewEmitter[pEngine->m_EmitterCount] = *pEmitter;
+
+    pEngine->m_pEmitter = pNewEmitter;
+    ++pEngine->m_EmitterCount;
+
+    return &pNewEmitter[pEngine->m_EmitterCount - 1];
+}
+//---------------------------------------------------------------------------
+CSR_ParticleForce* csrParticleEngineAddForce(      CSR_ParticleEngine* pEngine,
+                                             const CSR_ParticleForce*  pForce)
+{
+    CSR_ParticleForce* pNewForce;
+
+    // validate the inputs
+    if (!pEngine || !pForce)
+        return 0;
+
+    // add a new force to the engine
+    pNewForce = (CSR_ParticleForce*)csrMemoryAlloc(pEngine->m_pForce,
+                                                   sizeof(CSR_ParticleForce),
+                                                   pEngine->m_ForceCount + 1);
+
+    // succeeded?
+    if (!pNewForce)
+        return 0;
+
+    // copy the force
+    pNewForce[pEngine->m_ForceCount] = *pForce;
+
+    pEngine->m_pForce = pNewForce;
+    ++pEngine->m_ForceCount;
+
+    return &pNewForce[pEngine->m_ForceCount - 1];
+}
+//---------------------------------------------------------------------------
+size_t csrParticleEngineSpawn(CSR_ParticleEngine*  pEngine,
+                              CSR_ParticleEmitter* pEmitter,
+                              size_t               count)
+{
+    size_t   i;
+    size_t   index;
+    size_t   required;
+    size_t   capacity;
+    unsigned counter;
+
+    // validate the inputs
+    if (!pEngine || !pEmitter)
+        return 0;
+
+    // calculate the slot count required in addition to the free ones
+    required = (count > pEngine->m_FreeCount) ? pEngine->m_Count + (count - pEngine->m_FreeCount) : 0;
+
+    // reserve the memory for all the particles at once
+    if (required > pEngine->m_Capacity)
+    {
+        capacity = pEngine->m_Capacity ? pEngine->m_Capacity * 2 : M_CSR_Particle_Min_Capacity;
+
+        if (capacity < required)
+            capacity = required;
+
+        if (!csrParticleEngineReserve(pEngine, capacity) && !csrParticleEngineReserve(pEngine, required))
+            // fill at least the free slots and the remaining capacity
+            count = pEngine->m_FreeCount + (pEngine->m_Capacity - pEngine->m_Count);
+    }
+
+    for (i = 0; i < count; ++i)
+    {
+        // get the next free slot, reuse the killed particles first
+        if (pEngine->m_FreeCount)
+            index = pEngine->m_pFree[--pEngine->m_FreeCount];
+        else
+            index = pEngine->m_Count++;
+
+        // get the particle position in the emitter random stream. NOTE each particle uses 8 values,
+        // thus the spawned particles only depend on the emitter seed and on its spawned count
+        counter = pEmitter->m_Counter * 8;
+        ++pEmitter->m_Counter;
+
+        // calculate the particle start position
+        pEngine->m_pX[index] = csrParticleEngineRandom(pEmitter->m_Seed,
+                                                       counter,
+                                                       pEmitter->m_Box.m_Min.m_X,
+                                                       pEmitter->m_Box.m_Max.m_X);
+        pEngine->m_pY[index] = csrParticleEngineRandom(pEmitter->m_Seed,
+                                                       counter + 1,
+                                                       pEmitter->m_Box.m_Min.m_Y,
+                                                       pEmitter->m_Box.m_Max.m_Y);
+        pEngine->m_pZ[index] = csrParticleEngineRandom(pEmitter->m_Seed,
+                                                       counter + 2,
+                                                       pEmitter->m_Box.m_Min.m_Z,
+                                                       pEmitter->m_Box.m_Max.m_Z);
+
+        // calculate the particle initial velocity
+        pEngine->m_pVelX[index] = csrParticleEngineRandom(pEmitter->m_Seed,
+                                                          counter + 3,
+                                                          pEmitter->m_MinVelocity.m_X,
+                                                          pEmitter->m_MaxVelocity.m_X);
+        pEngine->m_pVelY[index] = csrParticleEngineRandom(pEmitter->m_Seed,
+                                                          counter + 4,
+                                                          pEmitter->m_MinVelocity.m_Y,
+                                                          pEmitter->m_MaxVelocity.m_Y);
+        pEngine->m_pVelZ[index] = csrParticleEngineRandom(pEmitter->m_Seed,
+                                                          counter + 5,
+                                                          pEmitter->m_MinVelocity.m_Z,
+                                                          pEmitter->m_MaxVelocity.m_Z);
+
+        // calculate the particle lifetime. NOTE FLT_MAX remains unchanged while the elapsed time
+        // is subtracted, thus the particle never expires
+        if (pEmitter->m_MinLifetime == 0.0f && pEmitter->m_MaxLifetime == 0.0f)
+            pEngine->m_pLifetime[index] = FLT_MAX;
+        else
+            pEngine->m_pLifetime[index] = csrParticleEngineRandom(pEmitter->m_Seed,
+                                                                  counter + 6,
+                                                                  pEmitter->m_MinLifetime,
+                                                                  pEmitter->m_MaxLifetime);
+
+        pEngine->m_pAlive[index] = 1;
+    }
+
+    return count;
+}
+//---------------------------------------------------------------------------
+void csrParticleEngineKill(CSR_ParticleEngine* pEngine, const size_t* pIndex, size_t count)
+{
+    size_t i;
+
+    // validate the inputs
+    if (!pEngine || !pIndex)
+        return;
+
+    for (i = 0; i < count; ++i)
+    {
+        // out of range or already killed?
+        if (pIndex[i] >= pEngine->m_Count || !pEngine->m_pAlive[pIndex[i]])
+            continue;
+
+        // kill the particle and keep its slot for the next spawned one
+        pEngine->m_pAlive[pIndex[i]]             = 0;
+        pEngine->m_pFree[pEngine->m_FreeCount++] = pIndex[i];
+    }
+}
+//---------------------------------------------------------------------------
+void csrParticleEngineClear(CSR_ParticleEngine* pEngine)
+{
+    // validate the input
+    if (!pEngine)
+        return;
+
+    pEngine->m_Count     = 0;
+    pEngine->m_FreeCount = 0;
+}
+//---------------------------------------------------------------------------
+size_t csrParticleEngineGetAliveCount(const CSR_ParticleEngine* pEngine)
+{
+    // validate the input
+    if (!pEngine)
+        return 0;
+
+    return pEngine->m_Count - pEngine->m_FreeCount;
+}
+//---------------------------------------------------------------------------
+void csrParticleEngineAnimate(CSR_ParticleEngine* pEngine, float elapsedTime)
+{
+    csrParticleEngineAnimateParallel(pEngine, elapsedTime, 0);
+}
+//---------------------------------------------------------------------------
+void csrParticleEngineAnimateParallel(CSR_ParticleEngine* pEngine, float elapsedTime, CSR_JobPool* pPool)
+{
+    size_t                 i;
+    size_t                 spawnCount;
+    size_t                 chunkCount;
+    size_t                 freeCount;
+    size_t                 killCount;
+    size_t                 localSlot[2];
+    float                  drag;
+    CSR_ParticleEngineStep step;
+
+    // validate the inputs
+    if (!pEngine || elapsedTime <= 0.0f)
+        return;
+
+    // convert the elapsed time in seconds
+    step.m_Time = elapsedTime * 0.001f;
+
+    // spawn the emitters particles. NOTE this is done on the calling thread, because the spawned
+    // particles may reuse any free slot
+    for (i = 0; i < pEngine->m_EmitterCount; ++i)
+    {
+        if (pEngine->m_pEmitter[i].m_Rate <= 0.0f)
+            continue;
+
+        pEngine->m_pEmitter[i].m_Elapsed += step.m_Time;
+
+        // calculate the particle count to spawn since the last animation
+        spawnCount = (size_t)(pEngine->m_pEmitter[i].m_Elapsed * pEngine->m_pEmitter[i].m_Rate);
+
+        if (!spawnCount)
+            continue;
+
+        pEngine->m_pEmitter[i].m_Elapsed -= (float)spawnCount / pEngine->m_pEmitter[i].m_Rate;
+
+        csrParticleEngineSpawn(pEngine, &pEngine->m_pEmitter[i], spawnCount);
+    }
+
+    // sum the forces, they are the same for all the particles
+    step.m_pEngine          = pEngine;
+    step.m_Count            = pEngine->m_Count;
+    step.m_Acceleration.m_X = 0.0f;
+    step.m_Acceleration.m_Y = 0.0f;
+    step.m_Acceleration.m_Z = 0.0f;
+    step.m_Turbulence.m_X   = 0.0f;
+    step.m_Turbulence.m_Y   = 0.0f;
+    step.m_Turbulence.m_Z   = 0.0f;
+    step.m_TurbulenceKey    = csrParticleEngineHash(pEngine->m_Seed ^ csrParticleEngineHash(pEngine->m_Frame));
+    step.m_HasTurbulence    = 0;
+    step.m_Damping          = 1.0f;
+
+    for (i = 0; i < pEngine->m_ForceCount; ++i)
+        switch (pEngine->m_pForce[i].m_Type)
+        {
+            case CSR_PF_Constant:
+                step.m_Acceleration.m_X += pEngine->m_pForce[i].m_Vector.m_X * step.m_Time;
+                step.m_Acceleration.m_Y += pEngine->m_pForce[i].m_Vector.m_Y * step.m_Time;
+                step.m_Acceleration.m_Z += pEngine->m_pForce[i].m_Vector.m_Z * step.m_Time;
+                break;
+
+            case CSR_PF_Drag:
+                drag = 1.0f - (pEngine->m_pForce[i].m_Factor * step.m_Time);
+
+                // the drag may stop the particle, but never reverse it
+                if (drag < 0.0f)
+                    drag = 0.0f;
+
+                step.m_Damping *= drag;
+                break;
+
+            case CSR_PF_Turbulence:
+                step.m_Turbulence.m_X += fabs(pEngine->m_pForce[i].m_Vector.m_X) * step.m_Time;
+                step.m_Turbulence.m_Y += fabs(pEngine->m_pForce[i].m_Vector.m_Y) * step.m_Time;
+                step.m_Turbulence.m_Z += fabs(pEngine->m_pForce[i].m_Vector.m_Z) * step.m_Time;
+                step.m_HasTurbulence   = 1;
+                break;
+        }
+
+    // each animation uses a new turbulence random stream
+    ++pEngine->m_Frame;
+
+    if (!step.m_Count)
+        return;
+
+    step.m_pChunkSlot = csrParticleEngineCreateChunkSlots(step.m_Count, &step.m_ChunkSize, &chunkCount, localSlot);
+
+    // animate the particles and count the killed ones in each chunk
+    csrJobPoolParallelFor(pPool, chunkCount, csrParticleEngineAnimateChunk, &step);
+
+    // calculate the first free slot of each chunk. NOTE the killed particles are thus always added
+    // to the free list in the index order, whatever the thread count
+    freeCount = pEngine->m_FreeCount;
+
+    for (i = 0; i < chunkCount; ++i)
+    {
+        killCount            = step.m_pChunkSlot[i];
+        step.m_pChunkSlot[i] = freeCount;
+        freeCount           += killCount;
+    }
+
+    step.m_pChunkSlot[chunkCount] = freeCount;
+
+    // add the killed particles to the free list
+    if (freeCount != pEngine->m_FreeCount)
+        csrJobPoolParallelFor(pPool, chunkCount, csrParticleEngineFreeChunk, &step);
+
+    pEngine->m_FreeCount = freeCount;
+
+    if (step.m_pChunkSlot != localSlot)
+        free(step.m_pChunkSlot);
+}
+//---------------------------------------------------------------------------
+int csrParticleEngineToVB(const CSR_ParticleEngine* pEngine,
+                          const CSR_VertexBuffer*   pShape,
+                                CSR_VertexBuffer*   pVB)
+{
+    return csrParticleEngineToVBParallel(pEngine, pShape, pVB, 0);
+}
+//---------------------------------------------------------------------------
+int csrParticleEngineToVBParallel(const CSR_ParticleEngine* pEngine,
+                                  const CSR_VertexBuffer*   pShape,
+                                        CSR_VertexBuffer*   pVB,
+                                        CSR_JobPool*        pPool)
+{
+    size_t                   i;
+    size_t                   count;
+    size_t                   chunkCount;
+    size_t                   aliveCount;
+    size_t                   localSlot[2];
+    float*                   pData;
+    CSR_ParticleEngineWriter writer;
+
+    // validate the inputs
+    if (!pEngine || !pShape || !pVB || !pShape->m_Format.m_Stride)
+        return 0;
+
+    // only the list types may be copied several times in the same buffer
+    if (pShape->m_Format.m_Type != CSR_VT_Triangles && pShape->m_Format.m_Type != CSR_VT_Lines)
+        return 0;
+
+    // calculate the required buffer size
+    count = csrParticleEngineGetAliveCount(pEngine) * pShape->m_Count;
+
+    // does the buffer grow?
+    if (count > pVB->m_Count)
+    {
+        pData = (float*)csrMemoryAlloc(pVB->m_pData, sizeof(float), count);
+
+        // succeeded?
+        if (!pData)
+            return 0;
+
+        pVB->m_pData = pData;
+    }
+
+    pVB->m_Format = pShape->m_Format;
+    pVB->m_Count  = count;
+
+    if (!count)
+        return 1;
+
+    writer.m_pEngine    = pEngine;
+    writer.m_pShape     = pShape;
+    writer.m_pVB        = pVB;
+    writer.m_pChunkSlot = csrParticleEngineCreateChunkSlots(pEngine->m_Count,
+                                                            &writer.m_ChunkSize,
+                                                            &chunkCount,
+                                                             localSlot);
+
+    // count the alive particles in each chunk
+    csrJobPoolParallelFor(pPool, chunkCount, csrParticleEngineCountChunk, &writer);
+
+    // calculate the first particle written by each chunk, thus the particles are always written
+    // in the index order, whatever the thread count
+    count = 0;
+
+    for (i = 0; i < chunkCount; ++i)
+    {
+        aliveCount             = writer.m_pChunkSlot[i];
+        writer.m_pChunkSlot[i] = count;
+        count                 += aliveCount;
+    }
+
+    // write the particles
+    csrJobPoolParallelFor(pPool, chunkCount, csrParticleEngineWriteChunk, &writer);
+
+    if (writer.m_pChunkSlot != localSlot)
+        free(writer.m_pChunkSlot);
+
+    return 1;
+}
+//---------------------------------------------------------------------------
@@ -21,7 +21,39 @@
 
 // compactStar engine
 #include "CSR_Geometry.h"
+#include "CSR_Vertex.h"
 #include "CSR_Physics.h"
+#include "CSR_Job.h"
+
+//---------------------------------------------------------------------------
+// Global defines
+//---------------------------------------------------------------------------
+#define M_CSR_Particle_Min_Capacity 64
+#define M_CSR_Particle_Chunk_Size   4096 // particles per job, fixed to not depend on the thread count
+
+//---------------------------------------------------------------------------
+// Enumerators
+//---------------------------------------------------------------------------
+
+/**
+* Particle force type
+*/
+typedef enum
+{
+    CSR_PF_Constant = 0, // constant acceleration applied to all the particles, e.g. gravity or wind
+    CSR_PF_Drag,         // velocity damping, proportional to the particle velocity
+    CSR_PF_Turbulence    // random acceleration, different for each particle and each animation
+} CSR_EParticleForceType;
+
+/**
+* Particle bounds mode, i.e. what happens to a particle leaving the engine bounds
+*/
+typedef enum
+{
+    CSR_PB_None = 0, // bounds are ignored
+    CSR_PB_Kill,     // particle is killed
+    CSR_PB_Wrap      // particle is moved to the opposite side of the bounds
+} CSR_EParticleBoundsMode;
 
 //---------------------------------------------------------------------------
 // Prototypes
@@ -72,6 +104,62 @@ struct CSR_Particles
     CSR_fOnCalculateMotion m_fOnCalculateMotion;
 };
 
+/**
+* Particle force
+*/
+typedef struct
+{
+    CSR_EParticleForceType m_Type;
+    CSR_Vector3            m_Vector; // acceleration in units per second squared, for constant forces,
+                                     // or max acceleration on each axis, for turbulence forces
+    float                  m_Factor; // damping factor per second, for drag forces
+} CSR_ParticleForce;
+
+/**
+* Particle emitter
+*/
+typedef struct
+{
+    CSR_Box     m_Box;         // box in which the particles are spawned
+    CSR_Vector3 m_MinVelocity; // initial velocity, in units per second
+    CSR_Vector3 m_MaxVelocity;
+    float       m_MinLifetime; // lifetime in seconds, infinite if both min and max are 0
+    float       m_MaxLifetime;
+    float       m_Rate;        // particles spawned per second while animating, 0 to disable
+    float       m_Elapsed;     // time elapsed since the last spawn, in seconds
+    unsigned    m_Seed;        // random seed
+    unsigned    m_Counter;     // spawned particle count, i.e. position in the random stream
+} CSR_ParticleEmitter;
+
+/**
+* Particle engine, stores the particles in contiguous streams (i.e. one array per component)
+*@note Killed particles are kept in their slot until a new particle is spawned in it, thus a
+*      particle index remains valid until the particle is killed
+*/
+typedef struct
+{
+    float*                  m_pX;         // position streams
+    float*                  m_pY;
+    float*                  m_pZ;
+    float*                  m_pVelX;      // velocity streams, in units per second
+    float*                  m_pVelY;
+    float*                  m_pVelZ;
+    float*                  m_pLifetime;  // remaining lifetime stream, in seconds
+    unsigned char*          m_pAlive;     // alive flag stream
+    size_t*                 m_pFree;      // free slot list
+    size_t                  m_Count;      // slot count, including the killed particles
+    size_t                  m_Capacity;   // allocated slot count
+    size_t                  m_FreeCount;
+    CSR_ParticleEmitter*    m_pEmitter;
+    size_t                  m_EmitterCount;
+    CSR_ParticleForce*      m_pForce;
+    size_t                  m_ForceCount;
+    CSR_Box                 m_Bounds;
+    CSR_EParticleBoundsMode m_BoundsMode;
+    unsigned                m_Seed;       // random seed, for the turbulence forces
+    unsigned                m_Frame;      // animation count, i.e. position in the random stream
+} CSR_ParticleEngine;
+
 #ifdef __cplusplus
     extern "C"
     {
@@ -152,6 +240,153 @@ struct CSR_Particles
         */
         void csrParticlesAnimate(CSR_Particles* pParticles, float elapsedTime);
 
+        //-------------------------------------------------------------------
+        // Particle emitter functions
+        //-------------------------------------------------------------------
+
+        /**
+        * Initializes a particle emitter
+        *@param[in, out] pEmitter - particle emitter to initialize
+        */
+        void csrParticleEmitterInit(CSR_ParticleEmitter* pEmitter);
+
+        //-------------------------------------------------------------------
+        // Particle engine functions
+        //-------------------------------------------------------------------
+
+        /**
+        * Creates a particle engine
+        *@return newly created particle engine, 0 on error
+        *@note The particle engine must be released when no longer used, see csrParticleEngineRelease()
+        */
+        CSR_ParticleEngine* csrParticleEngineCreate(void);
+
+        /**
+        * Releases a particle engine
+        *@param[in, out] pEngine - particle engine to release
+        */
+        void csrParticleEngineRelease(CSR_ParticleEngine* pEngine);
+
+        /**
+        * Initializes a particle engine
+        *@param[in, out] pEngine - particle engine to initialize
+        */
+        void csrParticleEngineInit(CSR_ParticleEngine* pEngine);
+
+        /**
+        * Reserves the memory for a particle count
+        *@param[in, out] pEngine - particle engine
+        *@param capacity - particle count to reserve
+        *@return 1 on success, otherwise 0
+        */
+        int csrParticleEngineReserve(CSR_ParticleEngine* pEngine, size_t capacity);
+
+        /**
+        * Adds an emitter to a particle engine
+        *@param[in, out] pEngine - particle engine
+        *@param pEmitter - emitter to add, copied in the engine
+        *@return the newly added emitter on success, otherwise 0
+        *@note The returned pointer remains valid until the next emitter is added
+        */
+        CSR_ParticleEmitter* csrParticleEngineAddEmitter(      CSR_ParticleEngine*  pEngine,
+                                                         const CSR_ParticleEmitter* pEmitter);
+
+        /**
+        * Adds a force to a particle engine
+        *@param[in, out] pEngine - particle engine
+        *@param pForce - force to add, copied in the engine
+        *@return the newly added force on success, otherwise 0
+        *@note The returned pointer remains valid until the next force is added
+        */
+        CSR_ParticleForce* csrParticleEngineAddForce(      CSR_ParticleEngine* pEngine,
+                                                     const CSR_ParticleForce*  pForce);
+
+        /**
+        * Spawns particles from an emitter
+        *@param[in, out] pEngine - particle engine
+        *@param[in, out] pEmitter - emitter from which the particles are spawned, its counter is updated
+        *@param count - particle count to spawn
+        *@return spawned particle count, may be lower than count on error
+        *@note The free slots are reused first, the spawned particles are appended after
+        */
+        size_t csrParticleEngineSpawn(CSR_ParticleEngine*  pEngine,
+                                      CSR_ParticleEmitter* pEmitter,
+                                      size_t               count);
+
+        /**
+        * Kills particles
+        *@param[in, out] pEngine - particle engine
+        *@param pIndex - indices of the particles to kill
+        *@param count - index count
+        *@note Already killed or out of range particles are ignored
+        */
+        void csrParticleEngineKill(CSR_ParticleEngine* pEngine, const size_t* pIndex, size_t count);
+
+        /**
+        * Kills all the particles
+        *@param[in, out] pEngine - particle engine
+        *@note The memory is kept for the next spawned particles
+        */
+        void csrParticleEngineClear(CSR_ParticleEngine* pEngine);
+
+        /**
+        * Gets the alive particle count
+        *@param pEngine - particle engine
+        *@return the alive particle count
+        */
+        size_t csrParticleEngineGetAliveCount(const CSR_ParticleEngine* pEngine);
+
+        /**
+        * Animates the particles, i.e. spawns the emitters particles, applies the forces, moves the
+        * particles and kills the expired ones
+        *@param[in, out] pEngine - particle engine
+        *@param elapsedTime - elapsed time since last animation, in milliseconds
+        */
+        void csrParticleEngineAnimate(CSR_ParticleEngine* pEngine, float elapsedTime);
+
+        /**
+        * Animates the particles on several threads
+        *@param[in, out] pEngine - particle engine
+        *@param elapsedTime - elapsed time since last animation, in milliseconds
+        *@param pPool - job pool to use, if 0 the particles are animated in the calling thread
+        *@note The particles are split in chunks of a fixed size, and each random value only depends
+        *      on the seeds, the animation count and the particle index. Thus the result is the same,
+        *      bit by bit, whatever the thread count
+        */
+        void csrParticleEngineAnimateParallel(CSR_ParticleEngine* pEngine,
+                                              float               elapsedTime,
+                                              CSR_JobPool*        pPool);
+
+        /**
+        * Writes a copy of a shape at each alive particle position in a vertex buffer, thus all the
+        * particles may be drawn at once
+        *@param pEngine - particle engine
+        *@param pShape - shape to copy, its vertices are relative to the particle position. Only
+        *                the CSR_VT_Triangles and CSR_VT_Lines types are supported
+        *@param[in, out] pVB - vertex buffer to write to, its format is set to the shape one
+        *@return 1 on success, otherwise 0
+        *@note The vertex buffer memory is only reallocated when it grows, thus it may be updated
+        *      on each frame without allocation as long as the alive particle count doesn't increase
+        */
+        int csrParticleEngineToVB(const CSR_ParticleEngine* pEngine,
+                                  const CSR_VertexBuffer*   pShape,
+                                        CSR_VertexBuffer*   pVB);
+
+        /**
+        * Writes a copy of a shape at each alive particle position in a vertex buffer, on several threads
+        *@param pEngine - particle engine
+        *@param pShape - shape to copy, its vertices are relative to the particle position. Only
+        *                the CSR_VT_Triangles and CSR_VT_Lines types are supported
+        *@param[in, out] pVB - vertex buffer to write to, its format is set to the shape one
+        *@param pPool - job pool to use, if 0 the vertex buffer is written in the calling thread
+        *@return 1 on success, otherwise 0
+        *@note The particles are written in the same order as csrParticleEngineToVB() does
+        */
+        int csrParticleEngineToVBParallel(const CSR_ParticleEngine* pEngine,
+                                          const CSR_VertexBuffer*   pShape,
+                                                CSR_VertexBuffer*   pVB,
+                                                CSR_JobPool*        pPool);
+
 #ifdef __cplusplus
     }
 #endif
@@ -0,0 +1,893 @@
+/****************************************************************************
+ * ==> CSR_PhysicsWorld ----------------------------------------------------*
+ ****************************************************************************
+ * Description : This module provides a physics world, which moves rigid    *
+ *               bodies at a fixed time step and solves their contacts      *
+ * Developer   : Jean-Milost Reymond                                        *
+ * Copyright   : 2017 - 2022, this file is part of the CompactStar Engine.  *
+ *               You are free to copy or redistribute this file, modify it, *
+ *               or use it for your own projects, commercial or not. This   *
+ *               file is provided "as is", WITHOUT ANY WARRANTY OF ANY      *
+ *               KIND. THE DEVELOPER IS NOT RESPONSIBLE FOR ANY DAMAGE OF   *
+ *               ANY KIND, ANY LOSS OF DATA, OR ANY LOSS OF PRODUCTIVITY    *
+ *               TIME THAT MAY RESULT FROM THE USAGE OF THIS SOURCE CODE,   *
+ *               DIRECTLY OR NOT.                                           *
+ ****************************************************************************/
+
+#include "CSR_PhysicsWorld.h"
+
+// std
+#include <stdlib.h>
+#include <math.h>
+
+//---------------------------------------------------------------------------
+// Physics world private functions
+//---------------------------------------------------------------------------
+int csrPhysicsWorldReserve(void** ppData, size_t itemSize, size_t count, size_t* pCapacity)
+{
+    void*  pData;
+    size_t capacity;
+
+    // enough place?
+    if (count <= *pCapacity)
+        return 1;
+
+    // grow the array geometrically, to keep the additions in an amortized constant time
+    capacity = *pCapacity ? *pCapacity * 2 : 16;
+
+    if (capacity < count)
+        capacity = count;
+
+    pData = csrMemoryAlloc(*ppData, itemSize, capacity);
+
+    // succeeded?
+    if (!pData)
+        return 0;
+
+    *ppData    = pData;
+    *pCapacity = capacity;
+
+    return 1;
+}
+//---------------------------------------------------------------------------
+int csrPhysicsWorldGrow(void** ppData, size_t itemSize, size_t capacity)
+{
+    void* pData = csrMemoryAlloc(*ppData, itemSize, capacity);
+
+    // succeeded?
+    if (!pData)
+        return 0;
+
+    *ppData = pData;
+
+    return 1;
+}
+//---------------------------------------------------------------------------
+int csrPhysicsWorldReserveBodies(CSR_PhysicsWorld* pWorld, size_t count)
+{
+    size_t capacity;
+
+    // enough place?
+    if (count <= pWorld->m_BodyCapacity)
+        return 1;
+
+    capacity = pWorld->m_BodyCapacity ? pWorld->m_BodyCapacity * 2 : 16;
+
+    if (capacity < count)
+        capacity = count;
+
+    // grow each body array. NOTE if an allocation fails, the already grown arrays are just
+    // larger than required, which is harmless
+    if (!csrPhysicsWorldGrow((void**)&pWorld->m_pPos,         sizeof(CSR_Vector3),           capacity) ||
+        !csrPhysicsWorldGrow((void**)&pWorld->m_pVelocity,    sizeof(CSR_Vector3),           capacity) ||
+        !csrPhysicsWorldGrow((void**)&pWorld->m_pForce,       sizeof(CSR_Vector3),           capacity) ||
+        !csrPhysicsWorldGrow((void**)&pWorld->m_pInvMass,     sizeof(float),                 capacity) ||
+        !csrPhysicsWorldGrow((void**)&pWorld->m_pRestitution, sizeof(float),                 capacity) ||
+        !csrPhysicsWorldGrow((void**)&pWorld->m_pFriction,    sizeof(float),                 capacity) ||
+        !csrPhysicsWorldGrow((void**)&pWorld->m_pSleepTime,   sizeof(float),                 capacity) ||
+        !csrPhysicsWorldGrow((void**)&pWorld->m_pIslandRest,  sizeof(float),                 capacity) ||
+        !csrPhysicsWorldGrow((void**)&pWorld->m_pIsland,      sizeof(size_t),                capacity) ||
+        !csrPhysicsWorldGrow((void**)&pWorld->m_pState,       sizeof(CSR_EPhysicsBodyState), capacity) ||
+        !csrPhysicsWorldGrow((void**)&pWorld->m_pCollider,    sizeof(CSR_Collider*),         capacity) ||
+        !csrPhysicsWorldGrow((void**)&pWorld->m_pBox,         sizeof(CSR_Box),               capacity) ||
+        !csrPhysicsWorldGrow((void**)&pWorld->m_pOrder,       sizeof(size_t),                capacity))
+        return 0;
+
+    pWorld->m_BodyCapacity = capacity;
+
+    return 1;
+}
+//---------------------------------------------------------------------------
+void csrPhysicsWorldUpdateBox(CSR_PhysicsWorld* pWorld, size_t index)
+{
+    #ifdef _MSC_VER
+        CSR_Vector3 dir     = {0};
+        CSR_Vector3 support = {0};
+    #else
+        CSR_Vector3 dir;
+        CSR_Vector3 support;
+    #endif
+    const CSR_Collider* pCollider = pWorld->m_pCollider[index];
+          CSR_Box*      pBox      = &pWorld->m_pBox[index];
+
+    // no support function? Consider the body as a point
+    if (!pCollider->m_fOnSupport)
+    {
+        pBox->m_Min = pWorld->m_pPos[index];
+        pBox->m_Max = pWorld->m_pPos[index];
+        return;
+    }
+
+    dir.m_Y = 0.0f;
+    dir.m_Z = 0.0f;
+
+    // get the collider extent on each axis, using its support function
+    dir.m_X = -1.0f; pCollider->m_fOnSupport(pCollider, &dir, &support); pBox->m_Min.m_X = support.m_X;
+    dir.m_X =  1.0f; pCollider->m_fOnSupport(pCollider, &dir, &support); pBox->m_Max.m_X = support.m_X;
+    dir.m_X =  0.0f;
+
+    dir.m_Y = -1.0f; pCollider->m_fOnSupport(pCollider, &dir, &support); pBox->m_Min.m_Y = support.m_Y;
+    dir.m_Y =  1.0f; pCollider->m_fOnSupport(pCollider, &dir, &support); pBox->m_Max.m_Y = support.m_Y;
+    dir.m_Y =  0.0f;
+
+    dir.m_Z = -1.0f; pCollider->m_fOnSupport(pCollider, &dir, &support); pBox->m_Min.m_Z = support.m_Z;
+    dir.m_Z =  1.0f; pCollider->m_fOnSupport(pCollider, &dir, &support); pBox->m_Max.m_Z = support.m_Z;
+}
+//---------------------------------------------------------------------------
+int csrPhysicsWorldBoxesOverlap(const CSR_Box* pBox1, const CSR_Box* pBox2)
+{
+    return !(pBox1->m_Max.m_X < pBox2->m_Min.m_X || pBox1->m_Min.m_X > pBox2->m_Max.m_X ||
+             pBox1->m_Max.m_Y < pBox2->m_Min.m_Y || pBox1->m_Min.m_Y > pBox2->m_Max.m_Y ||
+             pBox1->m_Max.m_Z < pBox2->m_Min.m_Z || pBox1->m_Min.m_Z > pBox2->m_Max.m_Z);
+}
+//---------------------------------------------------------------------------
+void csrPhysicsWorldWakeOverlapping(CSR_PhysicsWorld* pWorld, const CSR_Box* pBox)
+{
+    size_t i;
+
+    // wake the resting bodies which may lie on the box, e.g. when a static body moves
+    for (i = 0; i < pWorld->m_BodyCount; ++i)
+        if (pWorld->m_pState[i] == CSR_PS_Sleeping && csrPhysicsWorldBoxesOverlap(pBox, &pWorld->m_pBox[i]))
+            csrPhysicsWorldWake(pWorld, i);
+}
+//---------------------------------------------------------------------------
+size_t csrPhysicsWorldFindIsland(size_t* pIsland, size_t index)
+{
+    // find the island root, and shorten the path on the way
+    while (pIsland[index] != index)
+    {
+        pIsland[index] = pIsland[pIsland[index]];
+        index          = pIsland[index];
+    }
+
+    return index;
+}
+//---------------------------------------------------------------------------
+int csrPhysicsWorldCompareContacts(const void* pValue1, const void* pValue2)
+{
+    const CSR_PhysicsContact* pContact1 = (const CSR_PhysicsContact*)pValue1;
+    const CSR_PhysicsContact* pContact2 = (const CSR_PhysicsContact*)pValue2;
+
+    // sort by body pair. NOTE a pair appears only once, thus the order is always the same
+    if (pContact1->m_A != pContact2->m_A)
+        return pContact1->m_A < pContact2->m_A ? -1 : 1;
+
+    if (pContact1->m_B != pContact2->m_B)
+        return pContact1->m_B < pContact2->m_B ? -1 : 1;
+
+    return 0;
+}
+//---------------------------------------------------------------------------
+const CSR_PhysicsContact* csrPhysicsWorldFindPrevContact(const CSR_PhysicsWorld* pWorld,
+                                                         const CSR_PhysicsContact* pContact)
+{
+    size_t first = 0;
+    size_t last  = pWorld->m_PrevContactCount;
+    size_t middle;
+    int    result;
+
+    // search the same body pair in the previous contacts, which are sorted
+    while (first < last)
+    {
+        middle = first + ((last - first) / 2);
+        result = csrPhysicsWorldCompareContacts(pContact, &pWorld->m_pPrevContact[middle]);
+
+        if (!result)
+            return &pWorld->m_pPrevContact[middle];
+
+        if (result < 0)
+            last = middle;
+        else
+            first = middle + 1;
+    }
+
+    return 0;
+}
+//---------------------------------------------------------------------------
+void csrPhysicsWorldApplyContactImpulse(      CSR_PhysicsWorld* pWorld,
+                                        const CSR_PhysicsContact* pContact,
+                                        const CSR_Vector3*      pDir,
+                                              float             impulse)
+{
+    const float invMassA = pWorld->m_pInvMass[pContact->m_A];
+    const float invMassB = pWorld->m_pInvMass[pContact->m_B];
+
+    pWorld->m_pVelocity[pContact->m_A].m_X += pDir->m_X * impulse * invMassA;
+    pWorld->m_pVelocity[pContact->m_A].m_Y += pDir->m_Y * impulse * invMassA;
+    pWorld->m_pVelocity[pContact->m_A].m_Z += pDir->m_Z * impulse * invMassA;
+    pWorld->m_pVelocity[pContact->m_B].m_X -= pDir->m_X * impulse * invMassB;
+    pWorld->m_pVelocity[pContact->m_B].m_Y -= pDir->m_Y * impulse * invMassB;
+    pWorld->m_pVelocity[pContact->m_B].m_Z -= pDir->m_Z * impulse * invMassB;
+}
+//---------------------------------------------------------------------------
+void csrPhysicsWorldIntegrateVelocities(CSR_PhysicsWorld* pWorld, float dt)
+{
+    size_t i;
+    float  damping;
+
+    damping = 1.0f / (1.0f + (dt * pWorld->m_LinearDamping));
+
+    for (i = 0; i < pWorld->m_BodyCount; ++i)
+    {
+        if (pWorld->m_pState[i] == CSR_PS_Awake)
+        {
+            pWorld->m_pVelocity[i].m_X += (pWorld->m_Gravity.m_X + (pWorld->m_pForce[i].m_X * pWorld->m_pInvMass[i])) * dt;
+            pWorld->m_pVelocity[i].m_Y += (pWorld->m_Gravity.m_Y + (pWorld->m_pForce[i].m_Y * pWorld->m_pInvMass[i])) * dt;
+            pWorld->m_pVelocity[i].m_Z += (pWorld->m_Gravity.m_Z + (pWorld->m_pForce[i].m_Z * pWorld->m_pInvMass[i])) * dt;
+
+            csrVec3MulVal(&pWorld->m_pVelocity[i], damping, &pWorld->m_pVelocity[i]);
+        }
+
+        // the forces only apply for one step
+        pWorld->m_pForce[i].m_X = 0.0f;
+        pWorld->m_pForce[i].m_Y = 0.0f;
+        pWorld->m_pForce[i].m_Z = 0.0f;
+    }
+}
+//---------------------------------------------------------------------------
+void csrPhysicsWorldSortBodies(CSR_PhysicsWorld* pWorld)
+{
+    size_t i;
+    size_t j;
+    size_t index;
+    float  x;
+
+    // insertion sort on the box min x, which is very fast on the almost sorted order kept from
+    // the previous step. The body index breaks the ties, to keep the order deterministic
+    for (i = 1; i < pWorld->m_BodyCount; ++i)
+    {
+        index = pWorld->m_pOrder[i];
+        x     = pWorld->m_pBox[index].m_Min.m_X;
+        j     = i;
+
+        while (j > 0 && (pWorld->m_pBox[pWorld->m_pOrder[j - 1]].m_Min.m_X > x ||
+                        (pWorld->m_pBox[pWorld->m_pOrder[j - 1]].m_Min.m_X == x && pWorld->m_pOrder[j - 1] > index)))
+        {
+            pWorld->m_pOrder[j] = pWorld->m_pOrder[j - 1];
+            --j;
+        }
+
+        pWorld->m_pOrder[j] = index;
+    }
+}
+//---------------------------------------------------------------------------
+int csrPhysicsWorldFindContacts(CSR_PhysicsWorld* pWorld)
+{
+    #ifdef _MSC_VER
+        CSR_Vector3 mtv = {0};
+    #else
+        CSR_Vector3 mtv;
+    #endif
+    CSR_PhysicsContact* pContact;
+    size_t              i;
+    size_t              j;
+    size_t              a;
+    size_t              b;
+    float               depth;
+
+    // sweep along the x axis, each box only overlaps the next boxes starting before it ends
+    for (i = 0; i < pWorld->m_BodyCount; ++i)
+    {
+        a = pWorld->m_pOrder[i];
+
+        if (pWorld->m_pState[a] == CSR_PS_Free)
+            continue;
+
+        for (j = i + 1; j < pWorld->m_BodyCount; ++j)
+        {
+            b = pWorld->m_pOrder[j];
+
+            if (pWorld->m_pBox[b].m_Min.m_X > pWorld->m_pBox[a].m_Max.m_X)
+                break;
+
+            if (pWorld->m_pState[b] == CSR_PS_Free)
+                continue;
+
+            // the pairs without any awake body cannot change
+            if (pWorld->m_pState[a] != CSR_PS_Awake && pWorld->m_pState[b] != CSR_PS_Awake)
+                continue;
+
+            if (!csrPhysicsWorldBoxesOverlap(&pWorld->m_pBox[a], &pWorld->m_pBox[b]))
+                continue;
+
+            // do the colliders overlap? NOTE the translation vector moves the first collider out
+            // of the second one
+            if (a < b)
+            {
+                if (!csrGJKResolve(pWorld->m_pCollider[a], pWorld->m_pCollider[b], &mtv))
+                    continue;
+            }
+            else
+            if (!csrGJKResolve(pWorld->m_pCollider[b], pWorld->m_pCollider[a], &mtv))
+                continue;
+
+            csrVec3Length(&mtv, &depth);
+
+            // just touching?
+            if (depth <= 0.0f)
+                continue;
+
+            if (!csrPhysicsWorldReserve((void**)&pWorld->m_pContact,
+                                         sizeof(CSR_PhysicsContact),
+                                         pWorld->m_ContactCount + 1,
+                                        &pWorld->m_ContactCapacity))
+                return 0;
+
+            pContact = &pWorld->m_pContact[pWorld->m_ContactCount];
+            ++pWorld->m_ContactCount;
+
+            pContact->m_A              = a < b ? a : b;
+            pContact->m_B              = a < b ? b : a;
+            pContact->m_Depth          = depth;
+            pContact->m_NormalImpulse  = 0.0f;
+            pContact->m_TangentImpulse = 0.0f;
+            pContact->m_NormalMass     = 0.0f;
+            pContact->m_Bias           = 0.0f;
+            pContact->m_Friction       = (float)sqrt(pWorld->m_pFriction[a] * pWorld->m_pFriction[b]);
+            csrVec3DivVal(&mtv, depth, &pContact->m_Normal);
+
+            // a resting body touched by a moving one should move again
+            if (pWorld->m_pState[a] == CSR_PS_Sleeping)
+                csrPhysicsWorldWake(pWorld, a);
+            else
+            if (pWorld->m_pState[b] == CSR_PS_Sleeping)
+                csrPhysicsWorldWake(pWorld, b);
+        }
+    }
+
+    // sort the contacts by body pair, to solve them in a stable order and find their previous state
+    if (pWorld->m_ContactCount > 1)
+        qsort(pWorld->m_pContact,
+              pWorld->m_ContactCount,
+              sizeof(CSR_PhysicsContact),
+              csrPhysicsWorldCompareContacts);
+
+    return 1;
+}
+//---------------------------------------------------------------------------
+void csrPhysicsWorldPrepareContacts(CSR_PhysicsWorld* pWorld, float dt)
+{
+    #ifdef _MSC_VER
+        CSR_Vector3 relVel  = {0};
+        CSR_Vector3 tangent = {0};
+    #else
+        CSR_Vector3 relVel;
+        CSR_Vector3 tangent;
+    #endif
+    const CSR_PhysicsContact* pPrev;
+          CSR_PhysicsContact* pContact;
+          size_t              i;
+          float               invMassSum;
+          float               normalVel;
+          float               length;
+          float               restitution;
+
+    for (i = 0; i < pWorld->m_ContactCount; ++i)
+    {
+        pContact   = &pWorld->m_pContact[i];
+        invMassSum =  pWorld->m_pInvMass[pContact->m_A] + pWorld->m_pInvMass[pContact->m_B];
+
+        if (invMassSum <= 0.0f)
+            continue;
+
+        pContact->m_NormalMass = 1.0f / invMassSum;
+
+        // calculate the approach speed
+        csrVec3Sub(&pWorld->m_pVelocity[pContact->m_A], &pWorld->m_pVelocity[pContact->m_B], &relVel);
+        csrVec3Dot(&relVel, &pContact->m_Normal, &normalVel);
+
+        // the bodies bounce if they hit fast enough
+        restitution = pWorld->m_pRestitution[pContact->m_A] > pWorld->m_pRestitution[pContact->m_B] ?
+                      pWorld->m_pRestitution[pContact->m_A] : pWorld->m_pRestitution[pContact->m_B];
+
+        if (-normalVel > pWorld->m_RestitutionThreshold)
+            pContact->m_Bias = -restitution * normalVel;
+
+        // push the bodies apart if they penetrate too deeply
+        if (pContact->m_Depth > pWorld->m_Slop)
+            pContact->m_Bias += (pWorld->m_Baumgarte / dt) * (pContact->m_Depth - pWorld->m_Slop);
+
+        // the friction opposes to the sliding velocity
+        tangent.m_X = relVel.m_X - (pContact->m_Normal.m_X * normalVel);
+        tangent.m_Y = relVel.m_Y - (pContact->m_Normal.m_Y * normalVel);
+        tangent.m_Z = relVel.m_Z - (pContact->m_Normal.m_Z * normalVel);
+        csrVec3Length(&tangent, &length);
+
+        if (length > M_CSR_Epsilon)
+            csrVec3DivVal(&tangent, length, &pContact->m_Tangent);
+        else
+        {
+            pContact->m_Tangent.m_X = 0.0f;
+            pContact->m_Tangent.m_Y = 0.0f;
+            pContact->m_Tangent.m_Z = 0.0f;
+        }
+
+        // start from the impulse found for the same pair on the previous step
+        pPrev = csrPhysicsWorldFindPrevContact(pWorld, pContact);
+
+        if (pPrev)
+        {
+            pContact->m_NormalImpulse = pPrev->m_NormalImpulse;
+            csrPhysicsWorldApplyContactImpulse(pWorld, pContact, &pContact->m_Normal, pContact->m_NormalImpulse);
+        }
+    }
+}
+//---------------------------------------------------------------------------
+void csrPhysicsWorldSolveContacts(CSR_PhysicsWorld* pWorld)
+{
+    #ifdef _MSC_VER
+        CSR_Vector3 relVel = {0};
+    #else
+        CSR_Vector3 relVel;
+    #endif
+    CSR_PhysicsContact* pContact;
+    size_t              i;
+    size_t              j;
+    float               vel;
+    float               impulse;
+    float               oldImpulse;
+    float               maxFriction;
+
+    // sequential impulses, each contact is solved with the velocities updated by the previous ones
+    for (i = 0; i < pWorld->m_Iterations; ++i)
+        for (j = 0; j < pWorld->m_ContactCount; ++j)
+        {
+            pContact = &pWorld->m_pContact[j];
+
+            if (pContact->m_NormalMass <= 0.0f)
+                continue;
+
+            // friction, limited by the normal impulse
+            csrVec3Sub(&pWorld->m_pVelocity[pContact->m_A], &pWorld->m_pVelocity[pContact->m_B], &relVel);
+            csrVec3Dot(&relVel, &pContact->m_Tangent, &vel);
+
+            maxFriction                = pContact->m_Friction * pContact->m_NormalImpulse;
+            oldImpulse                 = pContact->m_TangentImpulse;
+            pContact->m_TangentImpulse = oldImpulse - (vel * pContact->m_NormalMass);
+
+            if (pContact->m_TangentImpulse > maxFriction)
+                pContact->m_TangentImpulse = maxFriction;
+            else
+            if (pContact->m_TangentImpulse < -maxFriction)
+                pContact->m_TangentImpulse = -maxFriction;
+
+            csrPhysicsWorldApplyContactImpulse(pWorld,
+                                               pContact,
+                                              &pContact->m_Tangent,
+                                               pContact->m_TangentImpulse - oldImpulse);
+
+            // normal, the accumulated impulse may only push the bodies apart
+            csrVec3Sub(&pWorld->m_pVelocity[pContact->m_A], &pWorld->m_pVelocity[pContact->m_B], &relVel);
+            csrVec3Dot(&relVel, &pContact->m_Normal, &vel);
+
+            impulse                   = pContact->m_NormalMass * (pContact->m_Bias - vel);
+            oldImpulse                = pContact->m_NormalImpulse;
+            pContact->m_NormalImpulse = oldImpulse + impulse;
+
+            if (pContact->m_NormalImpulse < 0.0f)
+                pContact->m_NormalImpulse = 0.0f;
+
+            csrPhysicsWorldApplyContactImpulse(pWorld,
+                                               pContact,
+                                              &pContact->m_Normal,
+                                               pContact->m_NormalImpulse - oldImpulse);
+        }
+}
+//---------------------------------------------------------------------------
+void csrPhysicsWorldIntegratePositions(CSR_PhysicsWorld* pWorld, float dt)
+{
+    size_t i;
+
+    for (i = 0; i < pWorld->m_BodyCount; ++i)
+    {
+        if (pWorld->m_pState[i] != CSR_PS_Awake)
+            continue;
+
+        pWorld->m_pPos[i].m_X += pWorld->m_pVelocity[i].m_X * dt;
+        pWorld->m_pPos[i].m_Y += pWorld->m_pVelocity[i].m_Y * dt;
+        pWorld->m_pPos[i].m_Z += pWorld->m_pVelocity[i].m_Z * dt;
+
+        csrColliderSetPos(&pWorld->m_pPos[i], pWorld->m_pCollider[i]);
+    }
+}
+//---------------------------------------------------------------------------
+void csrPhysicsWorldUpdateIslands(CSR_PhysicsWorld* pWorld, float dt)
+{
+    size_t i;
+    size_t root;
+    size_t rootA;
+    size_t rootB;
+    float  speed;
+    float  sleepSpeed;
+
+    sleepSpeed = pWorld->m_SleepVelocity * pWorld->m_SleepVelocity;
+
+    // measure since when each awake body rests
+    for (i = 0; i < pWorld->m_BodyCount; ++i)
+    {
+        if (pWorld->m_pState[i] != CSR_PS_Awake)
+            continue;
+
+        csrVec3Dot(&pWorld->m_pVelocity[i], &pWorld->m_pVelocity[i], &speed);
+
+        if (speed < sleepSpeed)
+            pWorld->m_pSleepTime[i] += dt;
+        else
+            pWorld->m_pSleepTime[i]  = 0.0f;
+
+        pWorld->m_pIsland[i]     = i;
+        pWorld->m_pIslandRest[i] = pWorld->m_pSleepTime[i];
+    }
+
+    // the bodies touching each others belong to the same island. NOTE the static bodies don't
+    // link the islands, otherwise the whole scene would be a single island
+    for (i = 0; i < pWorld->m_ContactCount; ++i)
+    {
+        if (pWorld->m_pState[pWorld->m_pContact[i].m_A] != CSR_PS_Awake ||
+            pWorld->m_pState[pWorld->m_pContact[i].m_B] != CSR_PS_Awake)
+            continue;
+
+        rootA = csrPhysicsWorldFindIsland(pWorld->m_pIsland, pWorld->m_pContact[i].m_A);
+        rootB = csrPhysicsWorldFindIsland(pWorld->m_pIsland, pWorld->m_pContact[i].m_B);
+
+        if (rootA == rootB)
+            continue;
+
+        // the lowest index is always the root, to keep the islands deterministic
+        if (rootA < rootB)
+        {
+            pWorld->m_pIsland[rootB] = rootA;
+
+            if (pWorld->m_pIslandRest[rootB] < pWorld->m_pIslandRest[rootA])
+                pWorld->m_pIslandRest[rootA] = pWorld->m_pIslandRest[rootB];
+        }
+        else
+        {
+            pWorld->m_pIsland[rootA] = rootB;
+
+            if (pWorld->m_pIslandRest[rootA] < pWorld->m_pIslandRest[rootB])
+                pWorld->m_pIslandRest[rootB] = pWorld->m_pIslandRest[rootA];
+        }
+    }
+
+    // an island falls asleep when all its bodies rest for long enough
+    for (i = 0; i < pWorld->m_BodyCount; ++i)
+    {
+        if (pWorld->m_pState[i] != CSR_PS_Awake)
+            continue;
+
+        root                 = csrPhysicsWorldFindIsland(pWorld->m_pIsland, i);
+        pWorld->m_pIsland[i] = root;
+
+        if (pWorld->m_pIslandRest[root] < pWorld->m_SleepDelay)
+            continue;
+
+        pWorld->m_pState[i]        = CSR_PS_Sleeping;
+        pWorld->m_pVelocity[i].m_X = 0.0f;
+        pWorld->m_pVelocity[i].m_Y = 0.0f;
+        pWorld->m_pVelocity[i].m_Z = 0.0f;
+    }
+}
+//---------------------------------------------------------------------------
+// Physics world functions
+//---------------------------------------------------------------------------
+CSR_PhysicsWorld* csrPhysicsWorldCreate(void)
+{
+    // create a new physics world
+    CSR_PhysicsWorld* pWorld = (CSR_PhysicsWorld*)malloc(sizeof(CSR_PhysicsWorld));
+
+    // succeeded?
+    if (!pWorld)
+        return 0;
+
+    csrPhysicsWorldInit(pWorld);
+
+    return pWorld;
+}
+//---------------------------------------------------------------------------
+void csrPhysicsWorldRelease(CSR_PhysicsWorld* pWorld)
+{
+    // no physics world to release?
+    if (!pWorld)
+        return;
+
+    // free the bodies
+    free(pWorld->m_pPos);
+    free(pWorld->m_pVelocity);
+    free(pWorld->m_pForce);
+    free(pWorld->m_pInvMass);
+    free(pWorld->m_pRestitution);
+    free(pWorld->m_pFriction);
+    free(pWorld->m_pSleepTime);
+    free(pWorld->m_pIslandRest);
+    free(pWorld->m_pIsland);
+    free(pWorld->m_pState);
+    free(pWorld->m_pCollider);
+    free(pWorld->m_pBox);
+    free(pWorld->m_pOrder);
+
+    // free the contacts
+    free(pWorld->m_pContact);
+    free(pWorld->m_pPrevContact);
+
+    // free the physics world
+    free(pWorld);
+}
+//---------------------------------------------------------------------------
+void csrPhysicsWorldInit(CSR_PhysicsWorld* pWorld)
+{
+    // no physics world to initialize?
+    if (!pWorld)
+        return;
+
+    // initialize the physics world
+    pWorld->m_Gravity.m_X          =  0.0f;
+    pWorld->m_Gravity.m_Y          = -M_CSR_Gravitation;
+    pWorld->m_Gravity.m_Z          =  0.0f;
+    pWorld->m_TimeStep             =  M_CSR_PhysicsWorld_Default_Time_Step;
+    pWorld->m_MaxSteps             =  M_CSR_PhysicsWorld_Default_Max_Steps;
+    pWorld->m_Iterations           =  M_CSR_PhysicsWorld_Default_Iterations;
+    pWorld->m_LinearDamping        =  0.05f;
+    pWorld->m_Baumgarte            =  0.2f;
+    pWorld->m_Slop                 =  0.005f;
+    pWorld->m_RestitutionThreshold =  1.0f;
+    pWorld->m_SleepVelocity        =  0.05f;
+    pWorld->m_SleepDelay           =  0.5f;
+    pWorld->m_Accumulator          =  0.0f;
+    pWorld->m_pPos                 =  0;
+    pWorld->m_pVelocity            =  0;
+    pWorld->m_pForce               =  0;
+    pWorld->m_pInvMass             =  0;
+    pWorld->m_pRestitution         =  0;
+    pWorld->m_pFriction            =  0;
+    pWorld->m_pSleepTime           =  0;
+    pWorld->m_pIslandRest          =  0;
+    pWorld->m_pIsland              =  0;
+    pWorld->m_pState               =  0;
+    pWorld->m_pCollider            =  0;
+    pWorld->m_pBox                 =  0;
+    pWorld->m_pOrder               =  0;
+    pWorld->m_BodyCount            =  0;
+    pWorld->m_BodyCapacity         =  0;
+    pWorld->m_pContact             =  0;
+    pWorld->m_ContactCount         =  0;
+    pWorld->m_ContactCapacity      =  0;
+    pWorld->m_pPrevContact         =  0;
+    pWorld->m_PrevContactCount     =  0;
+    pWorld->m_PrevContactCapacity  =  0;
+}
+//---------------------------------------------------------------------------
+int csrPhysicsWorldAddBody(CSR_PhysicsWorld* pWorld, CSR_Collider* pCollider, float mass)
+{
+    size_t index;
+
+    // validate the inputs
+    if (!pWorld || !pCollider || mass < 0.0f)
+        return M_CSR_Unknown_Index;
+
+    // reuse the first free slot, if any
+    for (index = 0; index < pWorld->m_BodyCount; ++index)
+        if (pWorld->m_pState[index] == CSR_PS_Free)
+            break;
+
+    if (index == pWorld->m_BodyCount)
+    {
+        if (!csrPhysicsWorldReserveBodies(pWorld, pWorld->m_BodyCount + 1))
+            return M_CSR_Unknown_Index;
+
+        // the new slot is sorted on the next step
+        pWorld->m_pOrder[pWorld->m_BodyCount] = index;
+        ++pWorld->m_BodyCount;
+    }
+
+    // initialize the body
+    pWorld->m_pPos[index]          = pCollider->m_Pos;
+    pWorld->m_pVelocity[index].m_X = 0.0f;
+    pWorld->m_pVelocity[index].m_Y = 0.0f;
+    pWorld->m_pVelocity[index].m_Z = 0.0f;
+    pWorld->m_pForce[index]        = pWorld->m_pVelocity[index];
+    pWorld->m_pInvMass[index]      = mass > 0.0f ? 1.0f / mass : 0.0f;
+    pWorld->m_pRestitution[index]  = 0.0f;
+    pWorld->m_pFriction[index]     = 0.5f;
+    pWorld->m_pSleepTime[index]    = 0.0f;
+    pWorld->m_pIslandRest[index]   = 0.0f;
+    pWorld->m_pIsland[index]       = index;
+    pWorld->m_pState[index]        = mass > 0.0f ? CSR_PS_Awake : CSR_PS_Static;
+    pWorld->m_pCollider[index]     = pCollider;
+
+    csrPhysicsWorldUpdateBox(pWorld, index);
+
+    return (int)index;
+}
+//---------------------------------------------------------------------------
+void csrPhysicsWorldRemoveBody(CSR_PhysicsWorld* pWorld, size_t index)
+{
+    size_t i;
+
+    // validate the inputs
+    if (!pWorld || index >= pWorld->m_BodyCount || pWorld->m_pState[index] == CSR_PS_Free)
+        return;
+
+    // wake the island, and the resting bodies which may lie on the removed body
+    csrPhysicsWorldWake(pWorld, index);
+    csrPhysicsWorldWakeOverlapping(pWorld, &pWorld->m_pBox[index]);
+
+    pWorld->m_pState[index]    = CSR_PS_Free;
+    pWorld->m_pCollider[index] = 0;
+
+    // the previous contacts of the removed body are no longer valid, because its slot may be reused
+    for (i = 0; i < pWorld->m_PrevContactCount; ++i)
+        if (pWorld->m_pPrevContact[i].m_A == index || pWorld->m_pPrevContact[i].m_B == index)
+            pWorld->m_pPrevContact[i].m_NormalImpulse = 0.0f;
+}
+//---------------------------------------------------------------------------
+void csrPhysicsWorldApplyForce(CSR_PhysicsWorld* pWorld, size_t index, const CSR_Vector3* pForce)
+{
+    // validate the inputs
+    if (!pWorld || !pForce || index >= pWorld->m_BodyCount || pWorld->m_pState[index] == CSR_PS_Free)
+        return;
+
+    // the static bodies cannot move
+    if (pWorld->m_pState[index] == CSR_PS_Static)
+        return;
+
+    csrPhysicsWorldWake(pWorld, index);
+    csrVec3Add(&pWorld->m_pForce[index], pForce, &pWorld->m_pForce[index]);
+}
+//---------------------------------------------------------------------------
+void csrPhysicsWorldApplyImpulse(CSR_PhysicsWorld* pWorld, size_t index, const CSR_Vector3* pImpulse)
+{
+    // validate the inputs
+    if (!pWorld || !pImpulse || index >= pWorld->m_BodyCount || pWorld->m_pState[index] == CSR_PS_Free)
+        return;
+
+    // the static bodies cannot move
+    if (pWorld->m_pState[index] == CSR_PS_Static)
+        return;
+
+    csrPhysicsWorldWake(pWorld, index);
+
+    pWorld->m_pVelocity[index].m_X += pImpulse->m_X * pWorld->m_pInvMass[index];
+    pWorld->m_pVelocity[index].m_Y += pImpulse->m_Y * pWorld->m_pInvMass[index];
+    pWorld->m_pVelocity[index].m_Z += pImpulse->m_Z * pWorld->m_pInvMass[index];
+}
+//---------------------------------------------------------------------------
+void csrPhysicsWorldSetPos(CSR_PhysicsWorld* pWorld, size_t index, const CSR_Vector3* pPos)
+{
+    // validate the inputs
+    if (!pWorld || !pPos || index >= pWorld->m_BodyCount || pWorld->m_pState[index] == CSR_PS_Free)
+        return;
+
+    csrPhysicsWorldWake(pWorld, index);
+
+    // the bodies resting on a static body should fall if it moves
+    if (pWorld->m_pState[index] == CSR_PS_Static)
+        csrPhysicsWorldWakeOverlapping(pWorld, &pWorld->m_pBox[index]);
+
+    pWorld->m_pPos[index] = *pPos;
+    csrColliderSetPos(pPos, pWorld->m_pCollider[index]);
+    csrPhysicsWorldUpdateBox(pWorld, index);
+
+    if (pWorld->m_pState[index] == CSR_PS_Static)
+        csrPhysicsWorldWakeOverlapping(pWorld, &pWorld->m_pBox[index]);
+}
+//---------------------------------------------------------------------------
+void csrPhysicsWorldWake(CSR_PhysicsWorld* pWorld, size_t index)
+{
+    size_t i;
+    size_t island;
+
+    // validate the inputs
+    if (!pWorld || index >= pWorld->m_BodyCount)
+        return;
+
+    // the awake body should not fall asleep immediately
+    if (pWorld->m_pState[index] == CSR_PS_Awake)
+    {
+        pWorld->m_pSleepTime[index] = 0.0f;
+        return;
+    }
+
+    if (pWorld->m_pState[index] != CSR_PS_Sleeping)
+        return;
+
+    island = pWorld->m_pIsland[index];
+
+    // wake the whole island
+    for (i = 0; i < pWorld->m_BodyCount; ++i)
+        if (pWorld->m_pState[i] == CSR_PS_Sleeping && pWorld->m_pIsland[i] == island)
+        {
+            pWorld->m_pState[i]     = CSR_PS_Awake;
+            pWorld->m_pSleepTime[i] = 0.0f;
+        }
+}
+//---------------------------------------------------------------------------
+size_t csrPhysicsWorldUpdate(CSR_PhysicsWorld* pWorld, float elapsedTime)
+{
+    size_t steps;
+
+    // validate the inputs
+    if (!pWorld || pWorld->m_TimeStep <= 0.0f)
+        return 0;
+
+    pWorld->m_Accumulator += elapsedTime * 0.001f;
+    steps                  = 0;
+
+    // integrate the elapsed time by fixed steps
+    while (pWorld->m_Accumulator >= pWorld->m_TimeStep && steps < pWorld->m_MaxSteps)
+    {
+        csrPhysicsWorldStep(pWorld);
+
+        pWorld->m_Accumulator -= pWorld->m_TimeStep;
+        ++steps;
+    }
+
+    // too much time elapsed? Drop it, otherwise the next updates would be even slower
+    if (pWorld->m_Accumulator >= pWorld->m_TimeStep)
+        pWorld->m_Accumulator = 0.0f;
+
+    return steps;
+}
+//---------------------------------------------------------------------------
+void csrPhysicsWorldStep(CSR_PhysicsWorld* pWorld)
+{
+    CSR_PhysicsContact* pContact;
+    size_t              i;
+    size_t              capacity;
+    float               dt;
+
+    // validate the input
+    if (!pWorld || pWorld->m_TimeStep <= 0.0f)
+        return;
+
+    dt = pWorld->m_TimeStep;
+
+    // keep the last contacts to warm start the solver
+    pContact                      = pWorld->m_pPrevContact;
+    capacity                      = pWorld->m_PrevContactCapacity;
+    pWorld->m_pPrevContact        = pWorld->m_pContact;
+    pWorld->m_PrevContactCount    = pWorld->m_ContactCount;
+    pWorld->m_PrevContactCapacity = pWorld->m_ContactCapacity;
+    pWorld->m_pContact            = pContact;
+    pWorld->m_ContactCapacity     = capacity;
+    pWorld->m_ContactCount        = 0;
+
+    csrPhysicsWorldIntegrateVelocities(pWorld, dt);
+
+    // update the moving body boxes, and sort them for the broad phase
+    for (i = 0; i < pWorld->m_BodyCount; ++i)
+        if (pWorld->m_pState[i] == CSR_PS_Awake)
+            csrPhysicsWorldUpdateBox(pWorld, i);
+
+    csrPhysicsWorldSortBodies(pWorld);
+
+    // find and solve the contacts. NOTE on an allocation failure, the contacts found so far are
+    // still solved
+    csrPhysicsWorldFindContacts(pWorld);
+    csrPhysicsWorldPrepareContacts(pWorld, dt);
+    csrPhysicsWorldSolveContacts(pWorld);
+
+    csrPhysicsWorldIntegratePositions(pWorld, dt);
+    csrPhysicsWorldUpdateIslands(pWorld, dt);
+}
+//---------------------------------------------------------------------------
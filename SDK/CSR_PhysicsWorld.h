@@ -0,0 +1,224 @@
+/****************************************************************************
+ * ==> CSR_PhysicsWorld ----------------------------------------------------*
+ ****************************************************************************
+ * Description : This module provides a physics world, which moves rigid    *
+ *               bodies at a fixed time step and solves their contacts      *
+ * Developer   : Jean-Milost Reymond                                        *
+ * Copyright   : 2017 - 2022, this file is part of the CompactStar Engine.  *
+ *               You are free to copy or redistribute this file, modify it, *
+ *               or use it for your own projects, commercial or not. This   *
+ *               file is provided "as is", WITHOUT ANY WARRANTY OF ANY      *
+ *               KIND. THE DEVELOPER IS NOT RESPONSIBLE FOR ANY DAMAGE OF   *
+ *               ANY KIND, ANY LOSS OF DATA, OR ANY LOSS OF PRODUCTIVITY    *
+ *               TIME THAT MAY RESULT FROM THE USAGE OF THIS SOURCE CODE,   *
+ *               DIRECTLY OR NOT.                                           *
+ ****************************************************************************/
+
+#ifndef CSR_PhysicsWorldH
+#define CSR_PhysicsWorldH
+
+// compactStar engine
+#include "CSR_Common.h"
+#include "CSR_Geometry.h"
+#include "CSR_Physics.h"
+#include "CSR_GJK.h"
+
+//---------------------------------------------------------------------------
+// Global defines
+//---------------------------------------------------------------------------
+#define M_CSR_PhysicsWorld_Default_Time_Step  (1.0f / 60.0f) // in seconds
+#define M_CSR_PhysicsWorld_Default_Max_Steps  5
+#define M_CSR_PhysicsWorld_Default_Iterations 10
+
+//---------------------------------------------------------------------------
+// Enumerations
+//---------------------------------------------------------------------------
+
+/**
+* Physics body state
+*/
+typedef enum
+{
+    CSR_PS_Free = 0, // the body slot is free
+    CSR_PS_Static,   // the body never moves
+    CSR_PS_Awake,
+    CSR_PS_Sleeping  // the body rests, it's neither moved nor tested against the other resting bodies
+} CSR_EPhysicsBodyState;
+
+//---------------------------------------------------------------------------
+// Structures
+//---------------------------------------------------------------------------
+
+/**
+* Physics contact, between 2 bodies whose colliders overlap
+*/
+typedef struct
+{
+    size_t      m_A;              // first body index, always lower than the second one
+    size_t      m_B;              // second body index
+    CSR_Vector3 m_Normal;         // contact normal, from the second body toward the first one
+    CSR_Vector3 m_Tangent;        // friction direction
+    float       m_Depth;          // penetration depth
+    float       m_NormalImpulse;  // accumulated normal impulse
+    float       m_TangentImpulse; // accumulated friction impulse
+    float       m_NormalMass;     // inverse of the summed inverse masses
+    float       m_Bias;           // target separating velocity, for restitution and position correction
+    float       m_Friction;
+} CSR_PhysicsContact;
+
+/**
+* Physics world
+*@note The bodies are stored by property (structure of arrays), and a body is identified by its
+*      index in these arrays. An index remains valid until the body is removed
+*@note The bodies are linear, i.e. they don't rotate. A contact only provides the minimum
+*      translation vector found by the GJK/EPA algorithm, and no contact point
+*@note The world is deterministic: the same world, stepped with the same elapsed times and the
+*      same inputs, always produces the same results on a same build
+*/
+typedef struct
+{
+    CSR_Vector3            m_Gravity;              // in m/s^2
+    float                  m_TimeStep;             // fixed integration step, in seconds
+    size_t                 m_MaxSteps;             // max steps done by an update, the remaining time is dropped
+    size_t                 m_Iterations;           // solver iterations on each step
+    float                  m_LinearDamping;        // velocity ratio lost each second
+    float                  m_Baumgarte;            // penetration ratio corrected on each step
+    float                  m_Slop;                 // allowed penetration, keeps the resting contacts stable
+    float                  m_RestitutionThreshold; // impact speed below which the bodies don't bounce, in m/s
+    float                  m_SleepVelocity;        // speed below which a body starts to rest, in m/s
+    float                  m_SleepDelay;           // rest time after which an island falls asleep, in seconds
+    float                  m_Accumulator;          // time not yet integrated, in seconds
+    CSR_Vector3*           m_pPos;
+    CSR_Vector3*           m_pVelocity;
+    CSR_Vector3*           m_pForce;               // forces applied until the next step
+    float*                 m_pInvMass;             // 0 for the static bodies
+    float*                 m_pRestitution;
+    float*                 m_pFriction;
+    float*                 m_pSleepTime;           // time since which the body rests
+    float*                 m_pIslandRest;          // lowest rest time of each island, indexed by island root
+    size_t*                m_pIsland;              // island the body belongs to
+    CSR_EPhysicsBodyState* m_pState;
+    CSR_Collider**         m_pCollider;            // body collider, not owned by the world
+    CSR_Box*               m_pBox;                 // body bounding box, in world coordinates
+    size_t*                m_pOrder;               // body indices sorted on the bounding box x axis
+    size_t                 m_BodyCount;            // used slots, including the free ones
+    size_t                 m_BodyCapacity;
+    CSR_PhysicsContact*    m_pContact;             // contacts found on the last step
+    size_t                 m_ContactCount;
+    size_t                 m_ContactCapacity;
+    CSR_PhysicsContact*    m_pPrevContact;         // contacts of the previous step, used to warm start the solver
+    size_t                 m_PrevContactCount;
+    size_t                 m_PrevContactCapacity;
+} CSR_PhysicsWorld;
+
+#ifdef __cplusplus
+    extern "C"
+    {
+#endif
+        //-------------------------------------------------------------------
+        // Physics world functions
+        //-------------------------------------------------------------------
+
+        /**
+        * Creates a physics world
+        *@return newly created physics world, 0 on error
+        *@note The physics world must be released when no longer used, see csrPhysicsWorldRelease()
+        */
+        CSR_PhysicsWorld* csrPhysicsWorldCreate(void);
+
+        /**
+        * Releases a physics world
+        *@param[in, out] pWorld - physics world to release
+        *@note The body colliders are not released
+        */
+        void csrPhysicsWorldRelease(CSR_PhysicsWorld* pWorld);
+
+        /**
+        * Initializes a physics world structure
+        *@param[in, out] pWorld - physics world to initialize
+        */
+        void csrPhysicsWorldInit(CSR_PhysicsWorld* pWorld);
+
+        /**
+        * Adds a body in the world
+        *@param[in, out] pWorld - physics world
+        *@param pCollider - body collider, its position becomes the body position
+        *@param mass - body mass in kilograms, if 0 the body is static
+        *@return body index, M_CSR_Unknown_Index on error
+        *@note The collider should remain valid while the body is in the world. The world moves it
+        *@note A removed body slot is reused by the next added body
+        */
+        int csrPhysicsWorldAddBody(CSR_PhysicsWorld* pWorld, CSR_Collider* pCollider, float mass);
+
+        /**
+        * Removes a body from the world
+        *@param[in, out] pWorld - physics world
+        *@param index - body index to remove
+        *@note The bodies resting against the removed one are woken up
+        */
+        void csrPhysicsWorldRemoveBody(CSR_PhysicsWorld* pWorld, size_t index);
+
+        /**
+        * Applies a force on a body until the next step
+        *@param[in, out] pWorld - physics world
+        *@param index - body index
+        *@param pForce - force to apply, in Newtons
+        *@note The body is woken up
+        */
+        void csrPhysicsWorldApplyForce(CSR_PhysicsWorld* pWorld, size_t index, const CSR_Vector3* pForce);
+
+        /**
+        * Applies an impulse on a body, i.e. changes its velocity immediately
+        *@param[in, out] pWorld - physics world
+        *@param index - body index
+        *@param pImpulse - impulse to apply, in Newton-seconds
+        *@note The body is woken up
+        */
+        void csrPhysicsWorldApplyImpulse(CSR_PhysicsWorld* pWorld, size_t index, const CSR_Vector3* pImpulse);
+
+        /**
+        * Sets a body position
+        *@param[in, out] pWorld - physics world
+        *@param index - body index
+        *@param pPos - new body position
+        *@note The body is woken up
+        */
+        void csrPhysicsWorldSetPos(CSR_PhysicsWorld* pWorld, size_t index, const CSR_Vector3* pPos);
+
+        /**
+        * Wakes a body up, with all the bodies resting in the same island
+        *@param[in, out] pWorld - physics world
+        *@param index - body index
+        */
+        void csrPhysicsWorldWake(CSR_PhysicsWorld* pWorld, size_t index);
+
+        /**
+        * Updates the world
+        *@param[in, out] pWorld - physics world to update
+        *@param elapsedTime - elapsed time since last update, in milliseconds
+        *@return step count done by the update
+        *@note The elapsed time is integrated by fixed steps, the remaining time is kept for the
+        *      next update
+        */
+        size_t csrPhysicsWorldUpdate(CSR_PhysicsWorld* pWorld, float elapsedTime);
+
+        /**
+        * Does a single world step, whatever the elapsed time
+        *@param[in, out] pWorld - physics world to step
+        */
+        void csrPhysicsWorldStep(CSR_PhysicsWorld* pWorld);
+
+#ifdef __cplusplus
+    }
+#endif
+
+//---------------------------------------------------------------------------
+// Compiler
+//---------------------------------------------------------------------------
+
+// needed in mobile c compiler to link the .h file with the .c
+#if defined(_OS_IOS_) || defined(_OS_ANDROID_) || defined(_OS_WINDOWS_)
+    #include "CSR_PhysicsWorld.c"
+#endif
+
+#endif
@@ -17,6 +17,7 @@
 
 // std
 #include <stdlib.h>
+#include <string.h>
 
 #ifdef CSR_USE_OPENGL
     #include "CSR_Renderer_OpenGL.h"
@@ -24,6 +25,213 @@
     #include "CSR_Renderer_Metal.h"
 #endif
 
+//---------------------------------------------------------------------------
+// Render command functions
+//---------------------------------------------------------------------------
+void csrRenderCommandInit(CSR_RenderCommand* pCommand)
+{
+    // no render command to initialize?
+    if (!pCommand)
+        return;
+
+    // initialize the render command
+    pCommand->m_Type        = CSR_RC_Mesh;
+    pCommand->m_Pass        = CSR_RP_Opaque;
+    pCommand->m_pModel      = 0;
+    pCommand->m_pMesh       = 0;
+    pCommand->m_pSkin       = 0;
+    pCommand->m_pShader     = 0;
+    pCommand->m_MatrixStart = 0;
+    pCommand->m_MatrixCount = 0;
+    pCommand->m_Index[0]    = 0;
+    pCommand->m_Index[1]    = 0;
+    pCommand->m_Index[2]    = 0;
+}
+//---------------------------------------------------------------------------
+// Render command list private functions
+//---------------------------------------------------------------------------
+int csrRenderCommandListReserve(CSR_RenderCommandList* pList, size_t commandCount, size_t matrixCount)
+{
+    // do grow the command array? (NOTE the capacity is doubled to amortize the allocations
+    // while the same list is recorded frame after frame)
+    if (commandCount > pList->m_Capacity)
+    {
+        CSR_RenderCommand* pCommand;
+        size_t             capacity = pList->m_Capacity ? pList->m_Capacity : 64;
+
+        while (capacity < commandCount)
+            capacity <<= 1;
+
+        pCommand = (CSR_RenderCommand*)csrMemoryAlloc(pList->m_pCommand,
+                                                      sizeof(CSR_RenderCommand),
+                                                      capacity);
+
+        // succeeded?
+        if (!pCommand)
+            return 0;
+
+        pList->m_pCommand = pCommand;
+        pList->m_Capacity = capacity;
+    }
+
+    // do grow the matrix pool?
+    if (matrixCount > pList->m_MatrixCapacity)
+    {
+        CSR_Matrix4* pMatrix;
+        size_t       capacity = pList->m_MatrixCapacity ? pList->m_MatrixCapacity : 64;
+
+        while (capacity < matrixCount)
+            capacity <<= 1;
+
+        pMatrix = (CSR_Matrix4*)csrMemoryAlloc(pList->m_pMatrix, sizeof(CSR_Matrix4), capacity);
+
+        // succeeded?
+        if (!pMatrix)
+            return 0;
+
+        pList->m_pMatrix        = pMatrix;
+        pList->m_MatrixCapacity = capacity;
+    }
+
+    return 1;
+}
+//---------------------------------------------------------------------------
+// Render command list functions
+//---------------------------------------------------------------------------
+CSR_RenderCommandList* csrRenderCommandListCreate(void)
+{
+    // create a new render command list
+    CSR_RenderCommandList* pList = (CSR_RenderCommandList*)malloc(sizeof(CSR_RenderCommandList));
+
+    // succeeded?
+    if (!pList)
+        return 0;
+
+    // initialize the render command list content
+    csrRenderCommandListInit(pList);
+
+    return pList;
+}
+//---------------------------------------------------------------------------
+void csrRenderCommandListRelease(CSR_RenderCommandList* pList)
+{
+    // no render command list to release?
+    if (!pList)
+        return;
+
+    // free the commands
+    if (pList->m_pCommand)
+        free(pList->m_pCommand);
+
+    // free the matrix pool
+    if (pList->m_pMatrix)
+        free(pList->m_pMatrix);
+
+    // free the render command list
+    free(pList);
+}
+//---------------------------------------------------------------------------
+void csrRenderCommandListInit(CSR_RenderCommandList* pList)
+{
+    // no render command list to initialize?
+    if (!pList)
+        return;
+
+    // initialize the render command list
+    pList->m_Color.m_R      = 0.0f;
+    pList->m_Color.m_G      = 0.0f;
+    pList->m_Color.m_B      = 0.0f;
+    pList->m_Color.m_A      = 1.0f;
+    pList->m_pCommand       = 0;
+    pList->m_Count          = 0;
+    pList->m_Capacity       = 0;
+    pList->m_pMatrix        = 0;
+    pList->m_MatrixCount    = 0;
+    pList->m_MatrixCapacity = 0;
+
+    csrMat4Identity(&pList->m_ProjectionMatrix);
+    csrMat4Identity(&pList->m_ViewMatrix);
+}
+//---------------------------------------------------------------------------
+void csrRenderCommandListClear(CSR_RenderCommandList* pList)
+{
+    // no render command list to clear?
+    if (!pList)
+        return;
+
+    // reset the counters, the memory will be reused by the next recording
+    pList->m_Count       = 0;
+    pList->m_MatrixCount = 0;
+}
+//---------------------------------------------------------------------------
+int csrRenderCommandListAdd(const CSR_RenderCommand*     pCommand,
+                            const CSR_Array*             pMatrixArray,
+                                  CSR_RenderCommandList* pList)
+{
+    size_t             i;
+    size_t             matrixCount;
+    CSR_RenderCommand* pNewCommand;
+
+    // validate the inputs
+    if (!pCommand || !pList)
+        return 0;
+
+    // get the model matrix count to copy
+    matrixCount = pMatrixArray ? pMatrixArray->m_Count : 0;
+
+    // reserve the memory for the new command and its matrices
+    if (!csrRenderCommandListReserve(pList, pList->m_Count + 1, pList->m_MatrixCount + matrixCount))
+        return 0;
+
+    // add the new command
+    pNewCommand                = &pList->m_pCommand[pList->m_Count];
+    *pNewCommand               = *pCommand;
+    pNewCommand->m_MatrixStart = pList->m_MatrixCount;
+    pNewCommand->m_MatrixCount = matrixCount;
+
+    // copy the model matrices
+    for (i = 0; i < matrixCount; ++i)
+        pList->m_pMatrix[pList->m_MatrixCount + i] = *((CSR_Matrix4*)pMatrixArray->m_pItem[i].m_pData);
+
+    pList->m_MatrixCount += matrixCount;
+    ++pList->m_Count;
+
+    return 1;
+}
+//---------------------------------------------------------------------------
+int csrRenderCommandListAppend(const CSR_RenderCommandList* pSrc, CSR_RenderCommandList* pDst)
+{
+    size_t i;
+
+    // validate the inputs
+    if (!pSrc || !pDst)
+        return 0;
+
+    // nothing to append?
+    if (!pSrc->m_Count)
+        return 1;
+
+    // reserve the memory for the appended commands and matrices
+    if (!csrRenderCommandListReserve(pDst,
+                                     pDst->m_Count       + pSrc->m_Count,
+                                     pDst->m_MatrixCount + pSrc->m_MatrixCount))
+        return 0;
+
+    // copy the commands, and rebase their matrices in the destination pool
+    memcpy(&pDst->m_pCommand[pDst->m_Count], pSrc->m_pCommand, pSrc->m_Count * sizeof(CSR_RenderCommand));
+
+    for (i = 0; i < pSrc->m_Count; ++i)
+        pDst->m_pCommand[pDst->m_Count + i].m_MatrixStart += pDst->m_MatrixCount;
+
+    // copy the matrices
+    if (pSrc->m_MatrixCount)
+        memcpy(&pDst->m_pMatrix[pDst->m_MatrixCount], pSrc->m_pMatrix, pSrc->m_MatrixCount * sizeof(CSR_Matrix4));
+
+    pDst->m_Count       += pSrc->m_Count;
+    pDst->m_MatrixCount += pSrc->m_MatrixCount;
+
+    return 1;
+}
 //---------------------------------------------------------------------------
 // Shader functions
 //---------------------------------------------------------------------------
@@ -122,6 +330,21 @@ void csrDrawMesh(const CSR_Mesh*    pMesh,
     #endif
 }
 //---------------------------------------------------------------------------
+void csrDrawMeshWithSkin(const CSR_Mesh*    pMesh,
+                         const CSR_Skin*    pSkin,
+                         const void*        pShader,
+                         const CSR_Array*   pMatrixArray,
+                         const CSR_fOnGetID fOnGetID)
+{
+    #ifdef CSR_USE_OPENGL
+        csrOpenGLDrawMeshWithSkin(pMesh, pSkin, (CSR_OpenGLShader*)pShader, pMatrixArray, fOnGetID);
+    #elif defined(CSR_USE_METAL)
+        csrMetalDrawMeshWithSkin(pMesh, pSkin, pShader, pMatrixArray, fOnGetID);
+    #else
+        #warning "csrDrawMeshWithSkin() isn't implemented and will not work on this platform"
+    #endif
+}
+//---------------------------------------------------------------------------
 void csrDrawModel(const CSR_Model*   pModel,
                         size_t       index,
                   const void*        pShader,
@@ -252,6 +475,155 @@ void csrDrawModel(const CSR_Model*   pModel,
     }
 #endif
 //---------------------------------------------------------------------------
+void csrDrawRenderCommands(const CSR_RenderCommandList* pList,
+                                 size_t                 first,
+                                 size_t                 count,
+                           const CSR_fOnGetID           fOnGetID)
+{
+    #ifdef CSR_USE_OPENGL
+        csrOpenGLDrawRenderCommands(pList, first, count, fOnGetID);
+    #elif defined(CSR_USE_METAL)
+        size_t         i;
+        size_t         j;
+        size_t         last;
+        CSR_ArrayItem* pItems;
+
+        // validate the inputs
+        if (!pList || first >= pList->m_Count)
+            return;
+
+        last = first + count;
+
+        if (last > pList->m_Count)
+            last = pList->m_Count;
+
+        pItems = 0;
+
+        // build the array items pointing to the model matrices (the existing draw functions
+        // expect a matrix array)
+        if (pList->m_MatrixCount)
+        {
+            pItems = (CSR_ArrayItem*)malloc(pList->m_MatrixCount * sizeof(CSR_ArrayItem));
+
+            // succeeded?
+            if (!pItems)
+                return;
+
+            for (j = 0; j < pList->m_MatrixCount; ++j)
+            {
+                pItems[j].m_pData    = &pList->m_pMatrix[j];
+                pItems[j].m_AutoFree = 0;
+            }
+        }
+
+        // iterate through the commands to draw
+        for (i = first; i < last; ++i)
+        {
+            const CSR_RenderCommand* pCommand = &pList->m_pCommand[i];
+                  CSR_Array          matrixArray;
+                  CSR_Array*         pMatrixArray;
+
+            // get the command model matrices
+            if (pCommand->m_MatrixCount)
+            {
+                matrixArray.m_pItem = &pItems[pCommand->m_MatrixStart];
+                matrixArray.m_Count = pCommand->m_MatrixCount;
+                pMatrixArray        = &matrixArray;
+            }
+            else
+                pMatrixArray = 0;
+
+            csrShaderEnable(pCommand->m_pShader);
+            csrShaderConnectProjectionMatrix(pCommand->m_pShader, &pList->m_ProjectionMatrix);
+
+            // the skybox should ignore the view translation and should not write the depth buffer
+            if (pCommand->m_Pass == CSR_RP_Skybox)
+            {
+                CSR_Matrix4 skyboxViewMatrix = pList->m_ViewMatrix;
+
+                skyboxViewMatrix.m_Table[3][0] = 0.0f;
+                skyboxViewMatrix.m_Table[3][1] = 0.0f;
+                skyboxViewMatrix.m_Table[3][2] = 0.0f;
+
+                csrStateEnableDepthMask(0);
+                csrShaderConnectViewMatrix(pCommand->m_pShader, &skyboxViewMatrix);
+            }
+            else
+                csrShaderConnectViewMatrix(pCommand->m_pShader, &pList->m_ViewMatrix);
+
+            switch (pCommand->m_Type)
+            {
+                case CSR_RC_Line:
+                    csrDrawLine((const CSR_Line*)pCommand->m_pModel, pCommand->m_pShader);
+                    break;
+
+                case CSR_RC_Mesh:
+                    csrDrawMeshWithSkin(pCommand->m_pMesh,
+                                        pCommand->m_pSkin,
+                                        pCommand->m_pShader,
+                                        pMatrixArray,
+                                        fOnGetID);
+                    break;
+
+                #ifdef USE_MDL
+                    case CSR_RC_MDL:
+                        csrDrawMDL((const CSR_MDL*)pCommand->m_pModel,
+                                   pCommand->m_pShader,
+                                   pMatrixArray,
+                                   pCommand->m_Index[0],
+                                   pCommand->m_Index[1],
+                                   pCommand->m_Index[2],
+                                   fOnGetID);
+                        break;
+                #endif
+
+                #ifdef USE_X
+                    case CSR_RC_X:
+                        csrDrawX((const CSR_X*)pCommand->m_pModel,
+                                 pCommand->m_pShader,
+                                 pMatrixArray,
+                                 pCommand->m_Index[0],
+                                 pCommand->m_Index[1],
+                                 fOnGetID);
+                        break;
+                #endif
+
+                #ifdef USE_COLLADA
+                    case CSR_RC_Collada:
+                        csrDrawCollada((const CSR_Collada*)pCommand->m_pModel,
+                                       pCommand->m_pShader,
+                                       pMatrixArray,
+                                       pCommand->m_Index[0],
+                                       pCommand->m_Index[1],
+                                       fOnGetID);
+                        break;
+                #endif
+
+                #ifdef USE_IQM
+                    case CSR_RC_IQM:
+                        csrDrawIQM((const CSR_IQM*)pCommand->m_pModel,
+                                   pCommand->m_pShader,
+                                   pMatrixArray,
+                                   pCommand->m_Index[0],
+                                   pCommand->m_Index[1],
+                                   fOnGetID);
+                        break;
+                #endif
+            }
+
+            if (pCommand->m_Pass == CSR_RP_Skybox)
+                csrStateEnableDepthMask(1);
+
+            csrShaderEnable(0);
+        }
+
+        if (pItems)
+            free(pItems);
+    #else
+        #warning "csrDrawRenderCommands() isn't implemented and will not work on this platform"
+    #endif
+}
+//---------------------------------------------------------------------------
 // State functions
 //---------------------------------------------------------------------------
 void csrStateEnableDepthMask(int value)
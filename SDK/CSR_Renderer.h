@@ -52,6 +52,84 @@
     #error "The graphics library to use in unknown for this system."
 #endif
 
+//---------------------------------------------------------------------------
+// Enumerators
+//---------------------------------------------------------------------------
+
+/**
+* Render command type
+*/
+typedef enum
+{
+    CSR_RC_Line,
+    CSR_RC_Mesh
+    #ifdef USE_MDL
+        ,
+        CSR_RC_MDL
+    #endif
+    #ifdef USE_X
+        ,
+        CSR_RC_X
+    #endif
+    #ifdef USE_COLLADA
+        ,
+        CSR_RC_Collada
+    #endif
+    #ifdef USE_IQM
+        ,
+        CSR_RC_IQM
+    #endif
+} CSR_ERenderCommandType;
+
+/**
+* Render pass, i.e. the scene step in which a render command should be executed
+*/
+typedef enum
+{
+    CSR_RP_Skybox,
+    CSR_RP_Opaque,
+    CSR_RP_Transparent
+} CSR_ERenderPass;
+
+//---------------------------------------------------------------------------
+// Structures
+//---------------------------------------------------------------------------
+
+/**
+* Render command, contains everything required to draw an item without traversing the scene again
+*@note The command only links the model, mesh and shader, it never owns them
+*/
+typedef struct
+{
+    CSR_ERenderCommandType m_Type;        // command type
+    CSR_ERenderPass        m_Pass;        // render pass in which the command should be executed
+    const void*            m_pModel;      // source model to draw (line, mesh, MDL, X, ...)
+    const CSR_Mesh*        m_pMesh;       // resolved mesh (skin, materials and vertex buffers), 0 if not resolved
+    const CSR_Skin*        m_pSkin;       // skin to bind while drawing the mesh, if 0 the mesh skin is used
+    const void*            m_pShader;     // shader to use to draw the model
+    size_t                 m_MatrixStart; // first model matrix index in the command list matrix pool
+    size_t                 m_MatrixCount; // model matrix count, if 0 the current model matrix is used
+    size_t                 m_Index[3];    // resolved indexes (MDL: skin, model and mesh, others: anim set and frame)
+} CSR_RenderCommand;
+
+/**
+* Render command list
+*@note The model matrices are copied in the list while the commands are recorded, thus the scene
+*      may be modified while the list is drawn, as long as the models themselves remain alive
+*/
+typedef struct
+{
+    CSR_Color          m_Color;            // scene background color
+    CSR_Matrix4        m_ProjectionMatrix; // scene projection matrix
+    CSR_Matrix4        m_ViewMatrix;       // scene view matrix
+    CSR_RenderCommand* m_pCommand;         // recorded commands
+    size_t             m_Count;            // command count
+    size_t             m_Capacity;         // allocated command count
+    CSR_Matrix4*       m_pMatrix;          // model matrix pool
+    size_t             m_MatrixCount;      // model matrix count
+    size_t             m_MatrixCapacity;   // allocated model matrix count
+} CSR_RenderCommandList;
+
 //---------------------------------------------------------------------------
 // Callbacks
 //---------------------------------------------------------------------------
@@ -72,6 +150,67 @@ typedef void* (*CSR_fOnGetID)(const void* pKey);
     extern "C"
     {
 #endif
+        //-------------------------------------------------------------------
+        // Render command functions
+        //-------------------------------------------------------------------
+
+        /**
+        * Initializes a render command structure
+        *@param[in, out] pCommand - render command to initialize
+        */
+        void csrRenderCommandInit(CSR_RenderCommand* pCommand);
+
+        //-------------------------------------------------------------------
+        // Render command list functions
+        //-------------------------------------------------------------------
+
+        /**
+        * Creates a render command list
+        *@return newly created render command list, 0 on error
+        *@note The render command list must be released when no longer used, see
+        *      csrRenderCommandListRelease()
+        */
+        CSR_RenderCommandList* csrRenderCommandListCreate(void);
+
+        /**
+        * Releases a render command list
+        *@param[in, out] pList - render command list to release
+        */
+        void csrRenderCommandListRelease(CSR_RenderCommandList* pList);
+
+        /**
+        * Initializes a render command list structure
+        *@param[in, out] pList - render command list to initialize
+        */
+        void csrRenderCommandListInit(CSR_RenderCommandList* pList);
+
+        /**
+        * Clears a render command list, but keeps its allocated memory for the next recording
+        *@param[in, out] pList - render command list to clear
+        */
+        void csrRenderCommandListClear(CSR_RenderCommandList* pList);
+
+        /**
+        * Adds a render command to a list
+        *@param pCommand - render command to add, its matrix start and count will be overwritten
+        *@param pMatrixArray - model matrices to copy in the list, 0 to use the current model matrix
+        *@param[in, out] pList - render command list to add to
+        *@return 1 on success, otherwise 0
+        */
+        int csrRenderCommandListAdd(const CSR_RenderCommand*     pCommand,
+                                    const CSR_Array*             pMatrixArray,
+                                          CSR_RenderCommandList* pList);
+
+        /**
+        * Appends the content of a render command list at the end of another
+        *@param pSrc - render command list to append
+        *@param[in, out] pDst - render command list to append to
+        *@return 1 on success, otherwise 0
+        *@note This function allows several threads to record their own list, which are then merged
+        *      in the expected draw order
+        */
+        int csrRenderCommandListAppend(const CSR_RenderCommandList* pSrc, CSR_RenderCommandList* pDst);
+
         //-------------------------------------------------------------------
         // Shader functions
         //-------------------------------------------------------------------
@@ -143,6 +282,23 @@ typedef void* (*CSR_fOnGetID)(const void* pKey);
                          const CSR_Array*   pMatrixArray,
                          const CSR_fOnGetID fOnGetID);
 
+        /**
+        * Draws a mesh in a scene, using the textures linked to another skin
+        *@param pMesh - mesh to draw
+        *@param pSkin - skin to bind, if 0 the mesh skin will be used
+        *@param pShader - shader to use to draw the mesh
+        *@param pMatrixArray - matrices to use, one for each vertex buffer drawing. If 0, the model
+        *                      matrix currently connected in the shader will be used
+        *@param fOnGetID - callback function to get the OpenGL identifier matching with a key
+        *@note This is useful to draw a mesh derived from another one, e.g. a level of detail, with
+        *      the textures already linked to the source mesh
+        */
+        void csrDrawMeshWithSkin(const CSR_Mesh*    pMesh,
+                                 const CSR_Skin*    pSkin,
+                                 const void*        pShader,
+                                 const CSR_Array*   pMatrixArray,
+                                 const CSR_fOnGetID fOnGetID);
+
         /**
         * Draws a model in a scene
         *@param pModel - model to draw
@@ -236,6 +392,19 @@ typedef void* (*CSR_fOnGetID)(const void* pKey);
                             const CSR_fOnGetID fOnGetID);
         #endif
 
+        /**
+        * Draws a range of recorded render commands
+        *@param pList - render command list containing the commands to draw
+        *@param first - first command to draw
+        *@param count - command count to draw
+        *@param fOnGetID - callback function to get the renderer identifier matching with a key
+        *@note This function should be called from the thread owning the graphics context
+        */
+        void csrDrawRenderCommands(const CSR_RenderCommandList* pList,
+                                         size_t                 first,
+                                         size_t                 count,
+                                   const CSR_fOnGetID           fOnGetID);
+
         //-------------------------------------------------------------------
         // State functions
         //-------------------------------------------------------------------
@@ -122,6 +122,21 @@
                               const CSR_Array*   _Nullable pMatrixArray,
                               const CSR_fOnGetID _Nullable fOnGetID);
 
+        /**
+        * Draws a mesh in a scene, using the textures linked to another skin
+        *@param pMesh - mesh to draw
+        *@param pSkin - skin to bind, if 0 the mesh skin will be used
+        *@param pShader - shader to use to draw the mesh
+        *@param pMatrixArray - matrices to use, one for each vertex buffer drawing. If 0, the model
+        *                      matrix currently connected in the shader will be used
+        *@param fOnGetID - callback function to get the OpenGL identifier matching with a key
+        */
+        void csrMetalDrawMeshWithSkin(const CSR_Mesh*    _Nullable pMesh,
+                                      const CSR_Skin*    _Nullable pSkin,
+                                      const void*        _Nullable pShader,
+                                      const CSR_Array*   _Nullable pMatrixArray,
+                                      const CSR_fOnGetID _Nullable fOnGetID);
+
         /**
         * Draws a model in a scene
         *@param pModel - model to draw
@@ -363,6 +378,21 @@
                               :(const CSR_Array* _Nullable)pMatrixArray
                               :(const CSR_fOnGetID _Nullable)fOnGetID;
 
+    /**
+    * Draws a mesh in a scene, using the textures linked to another skin
+    *@param pMesh - mesh to draw
+    *@param pSkin - skin to bind, if nil the mesh skin will be used
+    *@param pShader - shader to use to draw the mesh
+    *@param pMatrixArray - matrices to use, one for each vertex buffer drawing. If 0, the model
+    *                      matrix currently connected in the shader will be used
+    *@param fOnGetID - callback function to get the OpenGL identifier matching with a key
+    */
+    - (void) csrMetalDrawMeshWithSkin :(const CSR_Mesh* _Nullable)pMesh
+                                      :(const CSR_Skin* _Nullable)pSkin
+                                      :(const void* _Nullable)pShader
+                                      :(const CSR_Array* _Nullable)pMatrixArray
+                                      :(const CSR_fOnGetID _Nullable)fOnGetID;
+
     /**
     * Draws a model in a scene
     *@param pModel - model to draw
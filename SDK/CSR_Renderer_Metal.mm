@@ -81,6 +81,15 @@ void csrMetalDrawMesh(const CSR_Mesh*    _Nullable pMesh,
     [(__bridge id)g_pOwner csrMetalDrawMesh :pMesh :pShader :pMatrixArray :fOnGetID];
 }
 //---------------------------------------------------------------------------
+void csrMetalDrawMeshWithSkin(const CSR_Mesh*    _Nullable pMesh,
+                              const CSR_Skin*    _Nullable pSkin,
+                              const void*        _Nullable pShader,
+                              const CSR_Array*   _Nullable pMatrixArray,
+                              const CSR_fOnGetID _Nullable fOnGetID)
+{
+    [(__bridge id)g_pOwner csrMetalDrawMeshWithSkin :pMesh :pSkin :pShader :pMatrixArray :fOnGetID];
+}
+//---------------------------------------------------------------------------
 void csrMetalDrawModel(const CSR_Model*   _Nullable pModel,
                              size_t                 index,
                        const void*        _Nullable pShader,
@@ -369,6 +378,15 @@ typedef std::map<std::string,                       id<MTLRenderPipelineState>>
                           :(const void* _Nullable)pShader
                           :(const CSR_Array* _Nullable)pMatrixArray
                           :(const CSR_fOnGetID _Nullable)fOnGetID
+{
+    [self csrMetalDrawMeshWithSkin :pMesh :nil :pShader :pMatrixArray :fOnGetID];
+}
+//---------------------------------------------------------------------------
+- (void) csrMetalDrawMeshWithSkin :(const CSR_Mesh* _Nullable)pMesh
+                                  :(const CSR_Skin* _Nullable)pSkin
+                                  :(const void* _Nullable)pShader
+                                  :(const CSR_Array* _Nullable)pMatrixArray
+                                  :(const CSR_fOnGetID _Nullable)fOnGetID
 {
     size_t i;
 
@@ -376,6 +394,10 @@ typedef std::map<std::string,                       id<MTLRenderPipelineState>>
     if (!pMesh)
         return;
 
+    // no skin? Use the mesh one
+    if (!pSkin)
+        pSkin = &pMesh->m_Skin;
+
     // no shader?
     if (!pShader)
         return;
@@ -397,8 +419,8 @@ typedef std::map<std::string,                       id<MTLRenderPipelineState>>
             if (pMesh->m_pVB[i].m_Format.m_HasTexCoords)
             {
                 // get the OpenGL texture and bump map resource identifiers for this mesh
-                pTexture = (__bridge id<MTLTexture>)fOnGetID(&pMesh->m_Skin.m_Texture);
-                pBumpmap = (__bridge id<MTLTexture>)fOnGetID(&pMesh->m_Skin.m_BumpMap);
+                pTexture = (__bridge id<MTLTexture>)fOnGetID(&pSkin->m_Texture);
+                pBumpmap = (__bridge id<MTLTexture>)fOnGetID(&pSkin->m_BumpMap);
 
                 // a texture is defined for this mesh?
                 if (pTexture && m_pRenderEncoder)
@@ -411,7 +433,7 @@ typedef std::map<std::string,                       id<MTLRenderPipelineState>>
             }
 
             // get the OpenGL cubemap resource identifier for this mesh
-            pCubemap = (__bridge id<MTLTexture>)fOnGetID(&pMesh->m_Skin.m_CubeMap);
+            pCubemap = (__bridge id<MTLTexture>)fOnGetID(&pSkin->m_CubeMap);
 
             // a cube map is defined for this mesh?
             if (pCubemap && m_pRenderEncoder)
@@ -1686,6 +1708,12 @@ typedef std::map<std::string,                       id<MTLRenderPipelineState>>
         case CSR_VT_TriangleFan:
             @throw @"Unsupported format type - CSR_VT_TriangleFan";
 
+        case CSR_VT_Lines:
+            [pRenderEncoder drawPrimitives:MTLPrimitiveTypeLine
+                               vertexStart:0
+                               vertexCount:vertexCount];
+            return;
+
         default:
             return;
     }
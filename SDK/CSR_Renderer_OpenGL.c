@@ -30,6 +30,7 @@ GLuint csrOpenGLTextureFromPixelBuffer(const CSR_PixelBuffer* pPixelBuffer)
     size_t         c;
     GLint          pixelType;
     GLuint         index;
+    int            useMipmaps;
 
     // validate the input
     if (!pPixelBuffer || !pPixelBuffer->m_Width || !pPixelBuffer->m_Height || !pPixelBuffer->m_pData)
@@ -85,12 +86,20 @@ GLuint csrOpenGLTextureFromPixelBuffer(const CSR_PixelBuffer* pPixelBuffer)
     else
         pPixels = (unsigned char*)pPixelBuffer->m_pData;
 
+    // with OpenGL 2 only, the mipmaps are only supported by the power of 2 textures
+    #ifdef CSR_OPENGL_2_ONLY
+        useMipmaps = !(pPixelBuffer->m_Width  & (pPixelBuffer->m_Width  - 1)) &&
+                     !(pPixelBuffer->m_Height & (pPixelBuffer->m_Height - 1));
+    #else
+        useMipmaps = 1;
+    #endif
+
     // create new OpenGL texture
     glGenTextures(1, &index);
     glBindTexture(GL_TEXTURE_2D, index);
 
-    // set texture filtering
-    glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    // set texture filtering, trilinear if the mipmaps are available, to avoid the distant aliasing
+    glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, useMipmaps ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
     glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
     // set texture wrapping mode
@@ -108,6 +117,10 @@ GLuint csrOpenGLTextureFromPixelBuffer(const CSR_PixelBuffer* pPixelBuffer)
                  GL_UNSIGNED_BYTE,
                  pPixels);
 
+    // generate the mipmaps
+    if (useMipmaps)
+        glGenerateMipmap(GL_TEXTURE_2D);
+
     // delete local pixel buffer
     if (pPixelBuffer->m_ImageType == CSR_IT_Bitmap)
         free(pPixels);
@@ -115,9 +128,231 @@ GLuint csrOpenGLTextureFromPixelBuffer(const CSR_PixelBuffer* pPixelBuffer)
     return index;
 }
 //---------------------------------------------------------------------------
+// Texture cache functions
+//---------------------------------------------------------------------------
+CSR_OpenGLTextureCache* csrOpenGLTextureCacheCreate(size_t budget)
+{
+    // create a new texture cache
+    CSR_OpenGLTextureCache* pCache = (CSR_OpenGLTextureCache*)malloc(sizeof(CSR_OpenGLTextureCache));
+
+    // succeeded?
+    if (!pCache)
+        return 0;
+
+    // initialize the texture cache content
+    csrOpenGLTextureCacheInit(pCache);
+    pCache->m_Budget = budget;
+
+    return pCache;
+}
+//---------------------------------------------------------------------------
+void csrOpenGLTextureCacheRelease(CSR_OpenGLTextureCache* pCache)
+{
+    size_t i;
+
+    // no texture cache to release?
+    if (!pCache)
+        return;
+
+    // delete the textures on the GPU side
+    for (i = 0; i < pCache->m_Count; ++i)
+        glDeleteTextures(1, &pCache->m_pItem[i].m_ID);
+
+    // free the items
+    if (pCache->m_pItem)
+        free(pCache->m_pItem);
+
+    // free the texture cache
+    free(pCache);
+}
+//---------------------------------------------------------------------------
+void csrOpenGLTextureCacheInit(CSR_OpenGLTextureCache* pCache)
+{
+    // no texture cache to initialize?
+    if (!pCache)
+        return;
+
+    // initialize the texture cache
+    pCache->m_pItem         = 0;
+    pCache->m_Count         = 0;
+    pCache->m_Budget        = 0;
+    pCache->m_ResidentSize  = 0;
+    pCache->m_Time          = 0;
+    pCache->m_HitCount      = 0;
+    pCache->m_MissCount     = 0;
+    pCache->m_EvictionCount = 0;
+}
+//---------------------------------------------------------------------------
+GLuint csrOpenGLTextureCacheGet(const CSR_PixelBuffer* pPixelBuffer, CSR_OpenGLTextureCache* pCache)
+{
+    CSR_PixelBufferKey          key;
+    CSR_OpenGLTextureCacheItem* pItem;
+    GLuint                      id;
+    size_t                      i;
+
+    // validate the inputs
+    if (!pPixelBuffer || !pCache)
+        return M_CSR_Error_Code;
+
+    // identify the texture by its content
+    if (!csrPixelBufferGetKey(pPixelBuffer, &key))
+        return M_CSR_Error_Code;
+
+    ++pCache->m_Time;
+
+    // search for an already loaded texture
+    for (i = 0; i < pCache->m_Count; ++i)
+        if (csrPixelBufferKeyEqual(&pCache->m_pItem[i].m_Key, &key))
+        {
+            ++pCache->m_pItem[i].m_UseCount;
+            pCache->m_pItem[i].m_LastUse = pCache->m_Time;
+            ++pCache->m_HitCount;
+
+            return pCache->m_pItem[i].m_ID;
+        }
+
+    ++pCache->m_MissCount;
+
+    // load the texture
+    id = csrOpenGLTextureFromPixelBuffer(pPixelBuffer);
+
+    // succeeded?
+    if (id == M_CSR_Error_Code)
+        return M_CSR_Error_Code;
+
+    // add the texture in the cache
+    pItem = (CSR_OpenGLTextureCacheItem*)csrMemoryAlloc(pCache->m_pItem,
+                                                        sizeof(CSR_OpenGLTextureCacheItem),
+                                                        pCache->m_Count + 1);
+
+    // succeeded?
+    if (!pItem)
+    {
+        glDeleteTextures(1, &id);
+        return M_CSR_Error_Code;
+    }
+
+    pCache->m_pItem = pItem;
+    pItem           = &pCache->m_pItem[pCache->m_Count];
+    ++pCache->m_Count;
+
+    pItem->m_Key      = key;
+    pItem->m_ID       = id;
+    pItem->m_UseCount = 1;
+    pItem->m_LastUse  = pCache->m_Time;
+
+    // the GPU generally stores the pixels on 4 bytes, and the mipmaps add a third of the size
+    pItem->m_Size = (size_t)pPixelBuffer->m_Width * (size_t)pPixelBuffer->m_Height * 4;
+    pItem->m_Size = pItem->m_Size + pItem->m_Size / 3;
+
+    pCache->m_ResidentSize += pItem->m_Size;
+
+    // free the room for the new texture, if possible
+    csrOpenGLTextureCacheTrim(pCache);
+
+    return id;
+}
+//---------------------------------------------------------------------------
+int csrOpenGLTextureCacheDrop(GLuint id, CSR_OpenGLTextureCache* pCache)
+{
+    size_t i;
+
+    // no texture cache?
+    if (!pCache)
+        return 0;
+
+    // search for the texture
+    for (i = 0; i < pCache->m_Count; ++i)
+        if (pCache->m_pItem[i].m_ID == id)
+        {
+            if (pCache->m_pItem[i].m_UseCount)
+                --pCache->m_pItem[i].m_UseCount;
+
+            pCache->m_pItem[i].m_LastUse = ++pCache->m_Time;
+
+            // evict the unused textures if the budget is exceeded
+            csrOpenGLTextureCacheTrim(pCache);
+
+            return 1;
+        }
+
+    return 0;
+}
+//---------------------------------------------------------------------------
+void csrOpenGLTextureCacheTrim(CSR_OpenGLTextureCache* pCache)
+{
+    size_t i;
+    size_t oldest;
+
+    // no texture cache?
+    if (!pCache)
+        return;
+
+    // evict the least recently used unused texture until the budget is reached
+    while (pCache->m_ResidentSize > pCache->m_Budget)
+    {
+        oldest = M_CSR_Unknown_Index;
+
+        for (i = 0; i < pCache->m_Count; ++i)
+            if (!pCache->m_pItem[i].m_UseCount &&
+                (oldest == (size_t)M_CSR_Unknown_Index || pCache->m_pItem[i].m_LastUse < pCache->m_pItem[oldest].m_LastUse))
+                oldest = i;
+
+        // all the remaining textures are used
+        if (oldest == (size_t)M_CSR_Unknown_Index)
+            return;
+
+        glDeleteTextures(1, &pCache->m_pItem[oldest].m_ID);
+
+        pCache->m_ResidentSize -= pCache->m_pItem[oldest].m_Size;
+        ++pCache->m_EvictionCount;
+
+        // remove the item, the order doesn't matter
+        pCache->m_pItem[oldest] = pCache->m_pItem[pCache->m_Count - 1];
+        --pCache->m_Count;
+    }
+}
+//---------------------------------------------------------------------------
+float csrOpenGLTextureCacheHitRate(const CSR_OpenGLTextureCache* pCache)
+{
+    size_t total;
+
+    // no texture cache?
+    if (!pCache)
+        return 0.0f;
+
+    total = pCache->m_HitCount + pCache->m_MissCount;
+
+    // no access yet?
+    if (!total)
+        return 0.0f;
+
+    return (float)pCache->m_HitCount / (float)total;
+}
+//---------------------------------------------------------------------------
 // Cubemap functions
 //------------------------------------------------------------------------------
 GLuint csrOpenGLCubemapLoad(const char** pFileNames)
+{
+    CSR_PixelBuffer* pPixelBuffers[6];
+    GLuint           textureID;
+    size_t           i;
+
+    // load the faces content from files. NOTE a face which cannot be loaded is skipped
+    for (i = 0; i < 6; ++i)
+        pPixelBuffers[i] = csrPixelBufferFromBitmapFile(pFileNames[i]);
+
+    // load the cubemap texture on the GPU
+    textureID = csrOpenGLCubemapFromPixelBuffers((const CSR_PixelBuffer* const*)pPixelBuffers);
+
+    // release the previously loaded bitmaps
+    for (i = 0; i < 6; ++i)
+        csrPixelBufferRelease(pPixelBuffers[i]);
+
+    return textureID;
+}
+//---------------------------------------------------------------------------
+GLuint csrOpenGLCubemapFromPixelBuffers(const CSR_PixelBuffer* const* pPixelBuffers)
 {
     size_t i;
 
@@ -130,13 +365,23 @@ GLuint csrOpenGLCubemapLoad(const char** pFileNames)
     for (i = 0; i < 6; ++i)
     {
         unsigned char* pPixels;
+        GLint          pixelType;
         int            doReleasePixels = 0;
 
-        // load the texture content from file
-        CSR_PixelBuffer* pPixelBuffer = csrPixelBufferFromBitmapFile(pFileNames[i]);
+        // get the face content
+        const CSR_PixelBuffer* pPixelBuffer = pPixelBuffers[i];
 
-        // failed?
-        if (!pPixelBuffer)
+        // no content?
+        if (!pPixelBuffer || !pPixelBuffer->m_pData)
+            continue;
+
+        // select the correct pixel type to use (the bitmaps are limited to 24 bit RGB)
+        if (pPixelBuffer->m_BytePerPixel == 3)
+            pixelType = GL_RGB;
+        else
+        if (pPixelBuffer->m_BytePerPixel == 4 && pPixelBuffer->m_ImageType != CSR_IT_Bitmap)
+            pixelType = GL_RGBA;
+        else
             continue;
 
         // reorder the pixels if image is a bitmap
@@ -178,19 +423,16 @@ GLuint csrOpenGLCubemapLoad(const char** pFileNames)
         // load the texture on the GPU
         glTexImage2D((GLenum)(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i),
                      0,
-                     GL_RGB,
+                     pixelType,
                      pPixelBuffer->m_Width,
                      pPixelBuffer->m_Height,
                      0,
-                     GL_RGB,
+                     pixelType,
                      GL_UNSIGNED_BYTE,
                      pPixels);
 
         if (doReleasePixels)
             free(pPixels);
-
-        // release the previously loaded bitmap
-        csrPixelBufferRelease(pPixelBuffer);
     }
 
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
@@ -302,6 +544,9 @@ void csrOpenGLShaderInit(CSR_OpenGLShader* pShader)
     pShader->m_CubemapSlot  = -1;
     pShader->m_ColorSlot    = -1;
     pShader->m_ModelSlot    = -1;
+    pShader->m_BoneSlot     = -1;
+    pShader->m_WeightSlot   = -1;
+    pShader->m_PaletteSlot  = -1;
 }
 //---------------------------------------------------------------------------
 CSR_OpenGLShader* csrOpenGLShaderLoadFromFile(const char*               pVertex,
@@ -641,6 +886,97 @@ void csrOpenGLStaticBufferInit(CSR_OpenGLStaticBuffer* pSB)
     pSB->m_Stride   = 0;
 }
 //---------------------------------------------------------------------------
+// Skin buffer functions
+//---------------------------------------------------------------------------
+CSR_OpenGLSkinBuffer* csrOpenGLSkinBufferCreate(const CSR_VertexBuffer* pVB,
+                                                const CSR_SkinBinding*  pBinding)
+{
+    CSR_OpenGLSkinBuffer* pSB;
+    size_t                attribCount;
+
+    // validate the inputs
+    if (!pVB || !pVB->m_Count || !pVB->m_Format.m_Stride || !pBinding)
+        return 0;
+
+    // the binding should match with the vertex buffer
+    if (pBinding->m_VertexCount != pVB->m_Count / pVB->m_Format.m_Stride)
+        return 0;
+
+    // too many bones to be uploaded to the shader?
+    if (pBinding->m_BoneCount > M_CSR_OpenGL_Max_Palette_Size)
+        return 0;
+
+    // create a skin buffer
+    pSB = (CSR_OpenGLSkinBuffer*)malloc(sizeof(CSR_OpenGLSkinBuffer));
+
+    // succeeded?
+    if (!pSB)
+        return 0;
+
+    // initialize the skin buffer
+    csrOpenGLSkinBufferInit(pSB);
+
+    pSB->m_Count       = pVB->m_Count;
+    pSB->m_VertexCount = pBinding->m_VertexCount;
+    pSB->m_BoneCount   = pBinding->m_BoneCount;
+
+    attribCount = pBinding->m_VertexCount * M_CSR_Skin_Max_Influences;
+
+    // create a Vertex Buffer Object (VBO) on the GPU size, and bind it
+    glGenBuffers(1, &pSB->m_BufferID);
+    glBindBuffer(GL_ARRAY_BUFFER, pSB->m_BufferID);
+
+    // allocate the VBO, then copy the vertices, the bone indices and the bone weights one after the other
+    glBufferData(GL_ARRAY_BUFFER,
+                 (pVB->m_Count + 2 * attribCount) * sizeof(float),
+                 0,
+                 GL_STATIC_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER,
+                    0,
+                    pVB->m_Count * sizeof(float),
+                    pVB->m_pData);
+    glBufferSubData(GL_ARRAY_BUFFER,
+                    pVB->m_Count * sizeof(float),
+                    attribCount * sizeof(float),
+                    pBinding->m_pBones);
+    glBufferSubData(GL_ARRAY_BUFFER,
+                    (pVB->m_Count + attribCount) * sizeof(float),
+                    attribCount * sizeof(float),
+                    pBinding->m_pWeights);
+
+    // unbind the VBO
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    return pSB;
+}
+//---------------------------------------------------------------------------
+void csrOpenGLSkinBufferRelease(CSR_OpenGLSkinBuffer* pSB)
+{
+    // no skin buffer to release?
+    if (!pSB)
+        return;
+
+    // free the skin buffer content
+    if (pSB->m_BufferID != M_CSR_Error_Code)
+        glDeleteBuffers(1, &pSB->m_BufferID);
+
+    // free the skin buffer
+    free(pSB);
+}
+//---------------------------------------------------------------------------
+void csrOpenGLSkinBufferInit(CSR_OpenGLSkinBuffer* pSB)
+{
+    // no skin buffer to initialize?
+    if (!pSB)
+        return;
+
+    // initialize the skin buffer content
+    pSB->m_BufferID    = M_CSR_Error_Code;
+    pSB->m_Count       = 0;
+    pSB->m_VertexCount = 0;
+    pSB->m_BoneCount   = 0;
+}
+//---------------------------------------------------------------------------
 // Multisample antialiasing shader
 //---------------------------------------------------------------------------
 #ifndef CSR_OPENGL_2_ONLY
@@ -1068,6 +1404,7 @@ void csrOpenGLDrawArray(const CSR_VertexBuffer* pVB, size_t vertexCount)
         case CSR_VT_Triangles:     glDrawArrays(GL_TRIANGLES,      0, (GLsizei)vertexCount); return;
         case CSR_VT_TriangleStrip: glDrawArrays(GL_TRIANGLE_STRIP, 0, (GLsizei)vertexCount); return;
         case CSR_VT_TriangleFan:   glDrawArrays(GL_TRIANGLE_FAN,   0, (GLsizei)vertexCount); return;
+        case CSR_VT_Lines:         glDrawArrays(GL_LINES,          0, (GLsizei)vertexCount); return;
         default:                                                                             return;
     }
 }
@@ -1199,9 +1536,10 @@ void csrOpenGLDrawLine(const CSR_Line* pLine, const CSR_OpenGLShader* pShader)
     csrOpenGLShaderEnable(0);
 }
 //---------------------------------------------------------------------------
-void csrOpenGLDrawVertexBuffer(const CSR_VertexBuffer* pVB,
-                               const CSR_OpenGLShader* pShader,
-                               const CSR_Array*        pMatrixArray)
+void csrOpenGLDrawVertices(const CSR_VertexBuffer* pVB,
+                           const float*            pData,
+                           const CSR_OpenGLShader* pShader,
+                           const CSR_Array*        pMatrixArray)
 {
     GLvoid* pCoords;
     GLvoid* pNormals;
@@ -1273,10 +1611,12 @@ void csrOpenGLDrawVertexBuffer(const CSR_VertexBuffer* pVB,
     if (pVB->m_Format.m_HasPerVertexColor)
         glEnableVertexAttribArray(pShader->m_ColorSlot);
 
+    // the data is either in the client memory, or in the bound VBO, in which case it's 0 and
+    // the attribute pointers are byte offsets in the VBO
     offset = 0;
 
     // send vertices to shader
-    pCoords = &pVB->m_pData[offset];
+    pCoords = pData ? (GLvoid*)(pData + offset) : (GLvoid*)(offset * sizeof(float));
     glVertexAttribPointer(pShader->m_VertexSlot,
                           3,
                           GL_FLOAT,
@@ -1290,7 +1630,7 @@ void csrOpenGLDrawVertexBuffer(const CSR_VertexBuffer* pVB,
     if (pVB->m_Format.m_HasNormal)
     {
         // send normals to shader
-        pNormals = &pVB->m_pData[offset];
+        pNormals = pData ? (GLvoid*)(pData + offset) : (GLvoid*)(offset * sizeof(float));
         glVertexAttribPointer(pShader->m_NormalSlot,
                               3,
                               GL_FLOAT,
@@ -1305,7 +1645,7 @@ void csrOpenGLDrawVertexBuffer(const CSR_VertexBuffer* pVB,
     if (pVB->m_Format.m_HasTexCoords)
     {
         // send textures to shader
-        pTexCoords = &pVB->m_pData[offset];
+        pTexCoords = pData ? (GLvoid*)(pData + offset) : (GLvoid*)(offset * sizeof(float));
         glVertexAttribPointer(pShader->m_TexCoordSlot,
                               2,
                               GL_FLOAT,
@@ -1320,7 +1660,7 @@ void csrOpenGLDrawVertexBuffer(const CSR_VertexBuffer* pVB,
     if (pVB->m_Format.m_HasPerVertexColor)
     {
         // send colors to shader
-        pColors = &pVB->m_pData[offset];
+        pColors = pData ? (GLvoid*)(pData + offset) : (GLvoid*)(offset * sizeof(float));
         glVertexAttribPointer(pShader->m_ColorSlot,
                               4,
                               GL_FLOAT,
@@ -1385,10 +1725,89 @@ void csrOpenGLDrawVertexBuffer(const CSR_VertexBuffer* pVB,
         glDisableVertexAttribArray(pShader->m_ColorSlot);
 }
 //---------------------------------------------------------------------------
+void csrOpenGLBindSkinTextures(const CSR_Skin*         pSkin,
+                               const CSR_VertexBuffer* pVB,
+                               const CSR_OpenGLShader* pShader,
+                               const CSR_fOnGetID      fOnGetID)
+{
+    // in order to link textures, the OnGetID callback should be defined
+    if (fOnGetID)
+    {
+        CSR_OpenGLID* pTextureID;
+        CSR_OpenGLID* pBumpmapID;
+        CSR_OpenGLID* pCubemapID;
+
+        // vertices have UV texture coordinates?
+        if (pVB->m_Format.m_HasTexCoords)
+        {
+            // get the OpenGL texture and bump map resource identifiers for this mesh
+            pTextureID = (CSR_OpenGLID*)fOnGetID(&pSkin->m_Texture);
+            pBumpmapID = (CSR_OpenGLID*)fOnGetID(&pSkin->m_BumpMap);
+
+            // a texture is defined for this mesh?
+            if (pTextureID && (GLuint)pTextureID->m_ID != M_CSR_Error_Code)
+            {
+                // select the texture sampler to use (GL_TEXTURE0 for normal textures)
+                glActiveTexture(GL_TEXTURE0);
+                glUniform1i(pShader->m_TextureSlot, GL_TEXTURE0);
+
+                // bind the texture to use
+                glBindTexture(GL_TEXTURE_2D, pTextureID->m_ID);
+            }
+
+            // a bump map is defined for this mesh?
+            if (pBumpmapID && (GLuint)pBumpmapID->m_ID != M_CSR_Error_Code)
+            {
+                // select the texture sampler to use (GL_TEXTURE1 for bump map textures)
+                glActiveTexture(GL_TEXTURE1);
+                glUniform1i(pShader->m_BumpMapSlot, GL_TEXTURE1);
+
+                // bind the texture to use
+                glBindTexture(GL_TEXTURE_2D, pBumpmapID->m_ID);
+            }
+        }
+
+        // get the OpenGL cubemap resource identifier for this mesh
+        pCubemapID = (CSR_OpenGLID*)fOnGetID(&pSkin->m_CubeMap);
+
+        // a cube map is defined for this mesh?
+        if (pCubemapID && (GLuint)pCubemapID->m_ID != M_CSR_Error_Code)
+        {
+            // select the texture sampler to use (GL_TEXTURE0 for cubemap textures)
+            //glActiveTexture(GL_TEXTURE0);
+            //glUniform1i(pShader->m_CubemapSlot, GL_TEXTURE0);
+
+            // bind the cubemap texture to use
+            glBindTexture(GL_TEXTURE_CUBE_MAP, pCubemapID->m_ID);
+        }
+    }
+}
+//---------------------------------------------------------------------------
+void csrOpenGLDrawVertexBuffer(const CSR_VertexBuffer* pVB,
+                               const CSR_OpenGLShader* pShader,
+                               const CSR_Array*        pMatrixArray)
+{
+    // no vertex buffer to draw?
+    if (!pVB)
+        return;
+
+    // draw the vertices from the vertex buffer memory
+    csrOpenGLDrawVertices(pVB, pVB->m_pData, pShader, pMatrixArray);
+}
+//---------------------------------------------------------------------------
 void csrOpenGLDrawMesh(const CSR_Mesh*         pMesh,
                        const CSR_OpenGLShader* pShader,
                        const CSR_Array*        pMatrixArray,
                        const CSR_fOnGetID      fOnGetID)
+{
+    csrOpenGLDrawMeshWithSkin(pMesh, 0, pShader, pMatrixArray, fOnGetID);
+}
+//---------------------------------------------------------------------------
+void csrOpenGLDrawMeshWithSkin(const CSR_Mesh*         pMesh,
+                               const CSR_Skin*         pSkin,
+                               const CSR_OpenGLShader* pShader,
+                               const CSR_Array*        pMatrixArray,
+                               const CSR_fOnGetID      fOnGetID)
 {
     size_t i;
 
@@ -1396,6 +1815,10 @@ void csrOpenGLDrawMesh(const CSR_Mesh*         pMesh,
     if (!pMesh)
         return;
 
+    // no skin? Use the mesh one
+    if (!pSkin)
+        pSkin = &pMesh->m_Skin;
+
     // no shader?
     if (!pShader)
         return;
@@ -1406,61 +1829,86 @@ void csrOpenGLDrawMesh(const CSR_Mesh*         pMesh,
     // iterate through the vertex buffers composing the mesh to draw
     for (i = 0; i < pMesh->m_Count; ++i)
     {
-        // in order to link textures, the OnGetID callback should be defined
-        if (fOnGetID)
-        {
-            CSR_OpenGLID* pTextureID;
-            CSR_OpenGLID* pBumpmapID;
-            CSR_OpenGLID* pCubemapID;
+        // bind the mesh textures
+        csrOpenGLBindSkinTextures(pSkin, &pMesh->m_pVB[i], pShader, fOnGetID);
 
-            // vertices have UV texture coordinates?
-            if (pMesh->m_pVB[i].m_Format.m_HasTexCoords)
-            {
-                // get the OpenGL texture and bump map resource identifiers for this mesh
-                pTextureID = (CSR_OpenGLID*)fOnGetID(&pMesh->m_Skin.m_Texture);
-                pBumpmapID = (CSR_OpenGLID*)fOnGetID(&pMesh->m_Skin.m_BumpMap);
+        // draw the next mesh vertex buffer
+        csrOpenGLDrawVertexBuffer(&pMesh->m_pVB[i], pShader, pMatrixArray);
+    }
+}
+//---------------------------------------------------------------------------
+void csrOpenGLDrawSkinnedMesh(const CSR_Mesh*             pMesh,
+                              const CSR_OpenGLSkinBuffer* pSB,
+                              const CSR_OpenGLShader*     pShader,
+                              const CSR_Matrix4*          pPalette,
+                              const CSR_Array*            pMatrixArray,
+                              const CSR_fOnGetID          fOnGetID)
+{
+    const CSR_VertexBuffer* pVB;
+    size_t                  bonesOffset;
+    size_t                  weightsOffset;
 
-                // a texture is defined for this mesh?
-                if (pTextureID && (GLuint)pTextureID->m_ID != M_CSR_Error_Code)
-                {
-                    // select the texture sampler to use (GL_TEXTURE0 for normal textures)
-                    glActiveTexture(GL_TEXTURE0);
-                    glUniform1i(pShader->m_TextureSlot, GL_TEXTURE0);
+    // validate the inputs
+    if (!pMesh || !pMesh->m_Count || !pSB || !pShader || !pPalette)
+        return;
 
-                    // bind the texture to use
-                    glBindTexture(GL_TEXTURE_2D, pTextureID->m_ID);
-                }
+    // the skinned mesh contains only one vertex buffer
+    pVB = &pMesh->m_pVB[0];
 
-                // a bump map is defined for this mesh?
-                if (pBumpmapID && (GLuint)pBumpmapID->m_ID != M_CSR_Error_Code)
-                {
-                    // select the texture sampler to use (GL_TEXTURE1 for bump map textures)
-                    glActiveTexture(GL_TEXTURE1);
-                    glUniform1i(pShader->m_BumpMapSlot, GL_TEXTURE1);
+    // the skin buffer should match with the vertex buffer
+    if (pVB->m_Count != pSB->m_Count)
+        return;
 
-                    // bind the texture to use
-                    glBindTexture(GL_TEXTURE_2D, pBumpmapID->m_ID);
-                }
-            }
+    // the skinning attributes should be connected
+    if (pShader->m_BoneSlot == -1 || pShader->m_WeightSlot == -1 || pShader->m_PaletteSlot == -1)
+        return;
+
+    // enable the shader to use for drawing
+    csrOpenGLShaderEnable(pShader);
 
-            // get the OpenGL cubemap resource identifier for this mesh
-            pCubemapID = (CSR_OpenGLID*)fOnGetID(&pMesh->m_Skin.m_CubeMap);
+    // bind the mesh textures
+    csrOpenGLBindSkinTextures(&pMesh->m_Skin, pVB, pShader, fOnGetID);
 
-            // a cube map is defined for this mesh?
-            if (pCubemapID && (GLuint)pCubemapID->m_ID != M_CSR_Error_Code)
-            {
-                // select the texture sampler to use (GL_TEXTURE0 for cubemap textures)
-                //glActiveTexture(GL_TEXTURE0);
-                //glUniform1i(pShader->m_CubemapSlot, GL_TEXTURE0);
+    // connect the bone matrix palette to the shader
+    if (pSB->m_BoneCount)
+        glUniformMatrix4fv(pShader->m_PaletteSlot,
+                           (GLsizei)pSB->m_BoneCount,
+                           0,
+                           &pPalette[0].m_Table[0][0]);
 
-                // bind the cubemap texture to use
-                glBindTexture(GL_TEXTURE_CUBE_MAP, pCubemapID->m_ID);
-            }
-        }
+    // bind the VBO containing the mesh
+    glBindBuffer(GL_ARRAY_BUFFER, pSB->m_BufferID);
 
-        // draw the next mesh vertex buffer
-        csrOpenGLDrawVertexBuffer(&pMesh->m_pVB[i], pShader, pMatrixArray);
-    }
+    // the bone indices and weights follow the vertices in the VBO
+    bonesOffset   = pSB->m_Count * sizeof(float);
+    weightsOffset = bonesOffset + pSB->m_VertexCount * M_CSR_Skin_Max_Influences * sizeof(float);
+
+    // send the bone indices and weights to shader
+    glEnableVertexAttribArray(pShader->m_BoneSlot);
+    glVertexAttribPointer(pShader->m_BoneSlot,
+                          M_CSR_Skin_Max_Influences,
+                          GL_FLOAT,
+                          GL_FALSE,
+                          M_CSR_Skin_Max_Influences * sizeof(float),
+                          (const GLvoid*)bonesOffset);
+
+    glEnableVertexAttribArray(pShader->m_WeightSlot);
+    glVertexAttribPointer(pShader->m_WeightSlot,
+                          M_CSR_Skin_Max_Influences,
+                          GL_FLOAT,
+                          GL_FALSE,
+                          M_CSR_Skin_Max_Influences * sizeof(float),
+                          (const GLvoid*)weightsOffset);
+
+    // draw the vertices from the VBO
+    csrOpenGLDrawVertices(pVB, 0, pShader, pMatrixArray);
+
+    // disable the skinning slots
+    glDisableVertexAttribArray(pShader->m_WeightSlot);
+    glDisableVertexAttribArray(pShader->m_BoneSlot);
+
+    // unbind the VBO
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
 //---------------------------------------------------------------------------
 void csrOpenGLDrawModel(const CSR_Model*        pModel,
@@ -2298,6 +2746,163 @@ void csrOpenGLDrawModel(const CSR_Model*        pModel,
     }
 #endif
 //---------------------------------------------------------------------------
+void csrOpenGLDrawRenderCommands(const CSR_RenderCommandList* pList,
+                                       size_t                 first,
+                                       size_t                 count,
+                                 const CSR_fOnGetID           fOnGetID)
+{
+    size_t                  i;
+    size_t                  j;
+    size_t                  last;
+    int                     skyboxView;
+    CSR_ArrayItem*          pItems;
+    const CSR_OpenGLShader* pCurrentShader;
+    CSR_Matrix4             skyboxViewMatrix;
+
+    // validate the inputs
+    if (!pList || first >= pList->m_Count)
+        return;
+
+    last = first + count;
+
+    if (last > pList->m_Count)
+        last = pList->m_Count;
+
+    pItems = 0;
+
+    // build the array items pointing to the recorded model matrices
+    if (pList->m_MatrixCount)
+    {
+        pItems = (CSR_ArrayItem*)malloc(pList->m_MatrixCount * sizeof(CSR_ArrayItem));
+
+        // succeeded?
+        if (!pItems)
+            return;
+
+        for (j = 0; j < pList->m_MatrixCount; ++j)
+        {
+            pItems[j].m_pData    = &pList->m_pMatrix[j];
+            pItems[j].m_AutoFree = 0;
+        }
+    }
+
+    // the skybox should ignore the view translation
+    skyboxViewMatrix               = pList->m_ViewMatrix;
+    skyboxViewMatrix.m_Table[3][0] = 0.0f;
+    skyboxViewMatrix.m_Table[3][1] = 0.0f;
+    skyboxViewMatrix.m_Table[3][2] = 0.0f;
+
+    pCurrentShader = 0;
+    skyboxView     = 0;
+
+    // iterate through the commands to draw
+    for (i = first; i < last; ++i)
+    {
+        const CSR_RenderCommand* pCommand = &pList->m_pCommand[i];
+        const CSR_OpenGLShader*  pShader  = (const CSR_OpenGLShader*)pCommand->m_pShader;
+              CSR_Array          matrixArray;
+              CSR_Array*         pMatrixArray;
+
+        if (!pShader)
+            continue;
+
+        // get the command model matrices
+        if (pCommand->m_MatrixCount)
+        {
+            matrixArray.m_pItem = &pItems[pCommand->m_MatrixStart];
+            matrixArray.m_Count = pCommand->m_MatrixCount;
+            pMatrixArray        = &matrixArray;
+        }
+        else
+            pMatrixArray = 0;
+
+        // shader changed since the previous command? (NOTE the view matrix should also be
+        // reconnected when the pass enters or leaves the skybox)
+        if (pShader != pCurrentShader || skyboxView != (pCommand->m_Pass == CSR_RP_Skybox))
+        {
+            pCurrentShader = pShader;
+            skyboxView     = (pCommand->m_Pass == CSR_RP_Skybox);
+
+            csrOpenGLShaderEnable(pShader);
+            csrOpenGLShaderConnectProjectionMatrix(pShader, &pList->m_ProjectionMatrix);
+            csrOpenGLShaderConnectViewMatrix(pShader,
+                                             skyboxView ? &skyboxViewMatrix : &pList->m_ViewMatrix);
+        }
+
+        // the skybox should not write the depth buffer
+        if (skyboxView)
+            csrOpenGLStateEnableDepthMask(0);
+
+        switch (pCommand->m_Type)
+        {
+            case CSR_RC_Line:
+                csrOpenGLDrawLine((const CSR_Line*)pCommand->m_pModel, pShader);
+                break;
+
+            case CSR_RC_Mesh:
+                csrOpenGLDrawMeshWithSkin(pCommand->m_pMesh,
+                                          pCommand->m_pSkin,
+                                          pShader,
+                                          pMatrixArray,
+                                          fOnGetID);
+                break;
+
+            #ifdef USE_MDL
+                case CSR_RC_MDL:
+                    csrOpenGLDrawMDL((const CSR_MDL*)pCommand->m_pModel,
+                                     pShader,
+                                     pMatrixArray,
+                                     pCommand->m_Index[0],
+                                     pCommand->m_Index[1],
+                                     pCommand->m_Index[2],
+                                     fOnGetID);
+                    break;
+            #endif
+
+            #ifdef USE_X
+                case CSR_RC_X:
+                    csrOpenGLDrawX((const CSR_X*)pCommand->m_pModel,
+                                   pShader,
+                                   pMatrixArray,
+                                   pCommand->m_Index[0],
+                                   pCommand->m_Index[1],
+                                   fOnGetID);
+                    break;
+            #endif
+
+            #ifdef USE_COLLADA
+                case CSR_RC_Collada:
+                    csrOpenGLDrawCollada((const CSR_Collada*)pCommand->m_pModel,
+                                         pShader,
+                                         pMatrixArray,
+                                         pCommand->m_Index[0],
+                                         pCommand->m_Index[1],
+                                         fOnGetID);
+                    break;
+            #endif
+
+            #ifdef USE_IQM
+                case CSR_RC_IQM:
+                    csrOpenGLDrawIQM((const CSR_IQM*)pCommand->m_pModel,
+                                     pShader,
+                                     pMatrixArray,
+                                     pCommand->m_Index[0],
+                                     pCommand->m_Index[1],
+                                     fOnGetID);
+                    break;
+            #endif
+        }
+
+        if (skyboxView)
+            csrOpenGLStateEnableDepthMask(1);
+    }
+
+    csrOpenGLShaderEnable(0);
+
+    if (pItems)
+        free(pItems);
+}
+//---------------------------------------------------------------------------
 // State functions
 //---------------------------------------------------------------------------
 void csrOpenGLStateEnableDepthMask(int value)
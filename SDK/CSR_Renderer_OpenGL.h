@@ -56,6 +56,12 @@
     #error "The OpenGL renderer isn't implemented for this platform"
 #endif
 
+//---------------------------------------------------------------------------
+// Global defines
+//---------------------------------------------------------------------------
+#define M_CSR_Default_Texture_Budget (256 * 1024 * 1024)
+#define M_CSR_OpenGL_Max_Palette_Size 28 // max bone matrices uploaded to a skinning shader, fits in the 128 vertex uniform vectors of GLES2
+
 //---------------------------------------------------------------------------
 // Structures
 //---------------------------------------------------------------------------
@@ -71,6 +77,33 @@ typedef struct
     GLint  m_ID;
 } CSR_OpenGLID;
 
+/**
+* OpenGL texture cache item
+*/
+typedef struct
+{
+    CSR_PixelBufferKey m_Key;
+    GLuint             m_ID;
+    size_t             m_Size;     // resident size on the GPU, in bytes
+    size_t             m_UseCount;
+    size_t             m_LastUse;  // cache time of the last use, for the least recently used eviction
+} CSR_OpenGLTextureCacheItem;
+
+/**
+* OpenGL texture cache, shares the textures with identical content between models, skins and levels
+*/
+typedef struct
+{
+    CSR_OpenGLTextureCacheItem* m_pItem;
+    size_t                      m_Count;
+    size_t                      m_Budget;        // resident size above which the unused textures are evicted, in bytes
+    size_t                      m_ResidentSize;  // size of all the cached textures, in bytes
+    size_t                      m_Time;          // incremented on each cache access
+    size_t                      m_HitCount;
+    size_t                      m_MissCount;
+    size_t                      m_EvictionCount;
+} CSR_OpenGLTextureCache;
+
 /**
 * Shader
 */
@@ -87,6 +120,9 @@ typedef struct
     GLint  m_CubemapSlot;
     GLint  m_ColorSlot;
     GLint  m_ModelSlot;
+    GLint  m_BoneSlot;     // skinning bone indices attribute
+    GLint  m_WeightSlot;   // skinning bone weights attribute
+    GLint  m_PaletteSlot;  // skinning bone matrix palette uniform
 } CSR_OpenGLShader;
 
 /**
@@ -98,6 +134,18 @@ typedef struct
     size_t m_Stride;
 } CSR_OpenGLStaticBuffer;
 
+/**
+* Skin buffer, it's a static buffer containing a skinned vertex buffer and its skin binding, which
+* are deformed on the GPU side by a bone matrix palette
+*/
+typedef struct
+{
+    GLuint m_BufferID;    // source vertices, followed by the bone indices, then by the bone weights
+    size_t m_Count;       // source vertex buffer data count
+    size_t m_VertexCount;
+    size_t m_BoneCount;   // bone matrix palette size
+} CSR_OpenGLSkinBuffer;
+
 /**
 * Multisampling antialiasing
 */
@@ -139,9 +187,67 @@ typedef void (*CSR_fOnLinkStaticVB)(const CSR_OpenGLShader* pShader, const void*
         * Loads a texture contained in a pixel buffer on the GPU
         *@param pPixelBuffer - pixel buffer containing the texture to load
         *@return loaded texture index, M_CSR_Error_Code on error
+        *@note The mipmaps are generated and a trilinear filtering is used. With OpenGL 2 only, the
+        *      mipmaps are only generated for the power of 2 textures
         */
         GLuint csrOpenGLTextureFromPixelBuffer(const CSR_PixelBuffer* pPixelBuffer);
 
+        //-------------------------------------------------------------------
+        // Texture cache functions
+        //-------------------------------------------------------------------
+
+        /**
+        * Creates a texture cache
+        *@param budget - resident size above which the unused textures are evicted, in bytes
+        *@return newly created texture cache, 0 on error
+        *@note The texture cache must be released when no longer used, see csrOpenGLTextureCacheRelease()
+        */
+        CSR_OpenGLTextureCache* csrOpenGLTextureCacheCreate(size_t budget);
+
+        /**
+        * Releases a texture cache, and deletes all its textures on the GPU
+        *@param[in, out] pCache - texture cache to release
+        */
+        void csrOpenGLTextureCacheRelease(CSR_OpenGLTextureCache* pCache);
+
+        /**
+        * Initializes a texture cache structure
+        *@param[in, out] pCache - texture cache to initialize
+        */
+        void csrOpenGLTextureCacheInit(CSR_OpenGLTextureCache* pCache);
+
+        /**
+        * Gets the texture matching with a pixel buffer content, loads it if not cached yet
+        *@param pPixelBuffer - pixel buffer containing the texture
+        *@param[in, out] pCache - texture cache
+        *@return texture index, M_CSR_Error_Code on error
+        *@note Each successful call adds a use to the texture, which should be removed when the
+        *      texture is no longer used, see csrOpenGLTextureCacheDrop()
+        */
+        GLuint csrOpenGLTextureCacheGet(const CSR_PixelBuffer* pPixelBuffer, CSR_OpenGLTextureCache* pCache);
+
+        /**
+        * Removes a use from a cached texture
+        *@param id - texture index to drop
+        *@param[in, out] pCache - texture cache
+        *@return 1 if the texture belongs to the cache, otherwise 0
+        *@note An unused texture remains cached, until the budget is exceeded
+        */
+        int csrOpenGLTextureCacheDrop(GLuint id, CSR_OpenGLTextureCache* pCache);
+
+        /**
+        * Evicts the least recently used unused textures until the cache fits its budget
+        *@param[in, out] pCache - texture cache to trim
+        */
+        void csrOpenGLTextureCacheTrim(CSR_OpenGLTextureCache* pCache);
+
+        /**
+        * Gets the texture cache hit rate
+        *@param pCache - texture cache
+        *@return the hit rate, between 0.0 and 1.0
+        */
+        float csrOpenGLTextureCacheHitRate(const CSR_OpenGLTextureCache* pCache);
+
         //-------------------------------------------------------------------
         // Cubemap functions
         //-------------------------------------------------------------------
@@ -153,6 +259,14 @@ typedef void (*CSR_fOnLinkStaticVB)(const CSR_OpenGLShader* pShader, const void*
         */
         GLuint csrOpenGLCubemapLoad(const char** pFileNames);
 
+        /**
+        * Creates a cubemap texture on the GPU from 6 images containing each faces
+        *@param pPixelBuffers - face pixel buffers, a NULL face is skipped
+        *@return loaded texture index, M_CSR_Error_Code on error
+        *@note The faces should be sorted as follow: right, left, top, bottom, front, back
+        */
+        GLuint csrOpenGLCubemapFromPixelBuffers(const CSR_PixelBuffer* const* pPixelBuffers);
+
         //-------------------------------------------------------------------
         // Identifier functions
         //-------------------------------------------------------------------
@@ -315,6 +429,35 @@ typedef void (*CSR_fOnLinkStaticVB)(const CSR_OpenGLShader* pShader, const void*
         */
         void csrOpenGLStaticBufferInit(CSR_OpenGLStaticBuffer* pSB);
 
+        //-------------------------------------------------------------------
+        // Skin buffer functions
+        //-------------------------------------------------------------------
+
+        /**
+        * Creates a skin buffer
+        *@param pVB - skinned vertex buffer, in its bind pose
+        *@param pBinding - vertex buffer skin binding, see csrSkinBindingCreate()
+        *@return newly created skin buffer, 0 on error or if the binding contains more than
+        *        M_CSR_OpenGL_Max_Palette_Size bones, in which case the skinning should remain on
+        *        the CPU side, see csrSkinBindingApply()
+        *@note The vertices are uploaded once, then only the palette is uploaded on each draw
+        *@note The skin buffer must be released when no longer used, see csrOpenGLSkinBufferRelease()
+        */
+        CSR_OpenGLSkinBuffer* csrOpenGLSkinBufferCreate(const CSR_VertexBuffer* pVB,
+                                                        const CSR_SkinBinding*  pBinding);
+
+        /**
+        * Releases a skin buffer
+        *@param[in, out] pSB - skin buffer to release
+        */
+        void csrOpenGLSkinBufferRelease(CSR_OpenGLSkinBuffer* pSB);
+
+        /**
+        * Initializes a skin buffer structure
+        *@param[in, out] pSB - skin buffer to initialize
+        */
+        void csrOpenGLSkinBufferInit(CSR_OpenGLSkinBuffer* pSB);
+
         //-------------------------------------------------------------------
         // Multisampling antialiasing functions
         //-------------------------------------------------------------------
@@ -426,6 +569,40 @@ typedef void (*CSR_fOnLinkStaticVB)(const CSR_OpenGLShader* pShader, const void*
                                const CSR_Array*        pMatrixArray,
                                const CSR_fOnGetID      fOnGetID);
 
+        /**
+        * Draws a mesh in a scene, using the textures linked to another skin
+        *@param pMesh - mesh to draw
+        *@param pSkin - skin to bind, if 0 the mesh skin will be used
+        *@param pShader - shader to use to draw the mesh
+        *@param pMatrixArray - matrices to use, one for each vertex buffer drawing. If 0, the model
+        *                      matrix currently connected in the shader will be used
+        *@param fOnGetID - callback function to get the OpenGL identifier matching with a key
+        */
+        void csrOpenGLDrawMeshWithSkin(const CSR_Mesh*         pMesh,
+                                       const CSR_Skin*         pSkin,
+                                       const CSR_OpenGLShader* pShader,
+                                       const CSR_Array*        pMatrixArray,
+                                       const CSR_fOnGetID      fOnGetID);
+
+        /**
+        * Draws a skinned mesh in a scene, the skinning being applied by the shader
+        *@param pMesh - mesh to draw, should contain the vertex buffer from which the skin buffer was created
+        *@param pSB - mesh skin buffer
+        *@param pShader - skinning shader to use to draw the mesh
+        *@param pPalette - bone matrix palette, see csrSkinPaletteBuild()
+        *@param pMatrixArray - matrices to use, one for each vertex buffer drawing. If 0, the model
+        *                      matrix currently connected in the shader will be used
+        *@param fOnGetID - callback function to get the OpenGL identifier matching with a key
+        *@note The shader m_BoneSlot, m_WeightSlot and m_PaletteSlot should be set, see the
+        *      CSR_ShaderHelper skinning shaders
+        */
+        void csrOpenGLDrawSkinnedMesh(const CSR_Mesh*             pMesh,
+                                      const CSR_OpenGLSkinBuffer* pSB,
+                                      const CSR_OpenGLShader*     pShader,
+                                      const CSR_Matrix4*          pPalette,
+                                      const CSR_Array*            pMatrixArray,
+                                      const CSR_fOnGetID          fOnGetID);
+
         /**
         * Draws a model in a scene
         *@param pModel - model to draw
@@ -519,6 +696,21 @@ typedef void (*CSR_fOnLinkStaticVB)(const CSR_OpenGLShader* pShader, const void*
                                   const CSR_fOnGetID      fOnGetID);
         #endif
 
+        /**
+        * Draws a range of previously recorded render commands
+        *@param pList - render command list containing the commands to draw
+        *@param first - first command to draw
+        *@param count - command count to draw
+        *@param fOnGetID - callback function to get the OpenGL identifier matching with a key
+        *@note This function should be called from the thread owning the OpenGL context
+        *@note The shader and its projection and view matrices are only changed when the shader
+        *      differs from the one used by the previous command
+        */
+        void csrOpenGLDrawRenderCommands(const CSR_RenderCommandList* pList,
+                                               size_t                 first,
+                                               size_t                 count,
+                                         const CSR_fOnGetID           fOnGetID);
+
         //-------------------------------------------------------------------
         // State functions
         //-------------------------------------------------------------------
@@ -185,6 +185,10 @@ void csrCollisionOutputInit(CSR_CollisionOutput* pCO)
     pCO->m_CollisionPlane.m_B = 0.0f;
     pCO->m_CollisionPlane.m_C = 0.0f;
     pCO->m_CollisionPlane.m_D = 0.0f;
+    pCO->m_HitTime            = 1.0f;
+    pCO->m_HitPos.m_X         = 0.0f;
+    pCO->m_HitPos.m_Y         = 0.0f;
+    pCO->m_HitPos.m_Z         = 0.0f;
     pCO->m_GroundPlane.m_A    = 0.0f;
     pCO->m_GroundPlane.m_B    = 0.0f;
     pCO->m_GroundPlane.m_C    = 0.0f;
@@ -271,6 +275,129 @@ CSR_SceneItem* csrSceneItemDeleteModelFrom(CSR_SceneItem*       pItem,
     return pNewItem;
 }
 //---------------------------------------------------------------------------
+size_t csrSceneItemGetLODGroup(const CSR_SceneItem* pItem,
+                                     size_t         level,
+                                     CSR_ArrayItem* pBuffer,
+                                     CSR_Array*     pGroup)
+{
+    size_t i;
+
+    pGroup->m_pItem = pBuffer;
+    pGroup->m_Count = 0;
+
+    // get the model matrices using the level
+    for (i = 0; i < pItem->m_pLODState->m_Count && i < pItem->m_pMatrixArray->m_Count; ++i)
+        if (pItem->m_pLODState->m_pLevel[i] == level)
+        {
+            pBuffer[pGroup->m_Count] = pItem->m_pMatrixArray->m_pItem[i];
+            ++pGroup->m_Count;
+        }
+
+    return pGroup->m_Count;
+}
+//---------------------------------------------------------------------------
+void csrSceneItemDrawLOD(const CSR_Scene*        pScene,
+                         const CSR_SceneContext* pContext,
+                         const CSR_SceneItem*    pItem,
+                         const CSR_Mesh*         pMesh,
+                         const void*             pShader)
+{
+    CSR_ArrayItem* pBuffer;
+    CSR_Array      group;
+    size_t         level;
+
+    // select the level of each model matrix
+    if (!csrLODStateUpdate(pItem->m_pLOD,
+                           pItem->m_pMatrixArray,
+                          &pScene->m_ViewMatrix,
+                          &pScene->m_ProjectionMatrix,
+                           pItem->m_pLODState))
+    {
+        csrDrawMesh(pMesh, pShader, pItem->m_pMatrixArray, pContext->m_fOnGetID);
+        return;
+    }
+
+    // no model matrix? Draw the selected level with the currently connected matrix. The levels are
+    // drawn with the source skin, on which the textures are linked
+    if (!pItem->m_pMatrixArray || !pItem->m_pMatrixArray->m_Count)
+    {
+        csrDrawMeshWithSkin(csrLODGetMesh(pItem->m_pLOD, pMesh, pItem->m_pLODState->m_pLevel[0]),
+                           &pMesh->m_Skin,
+                            pShader,
+                            pItem->m_pMatrixArray,
+                            pContext->m_fOnGetID);
+        return;
+    }
+
+    pBuffer = (CSR_ArrayItem*)malloc(pItem->m_pMatrixArray->m_Count * sizeof(CSR_ArrayItem));
+
+    // succeeded?
+    if (!pBuffer)
+        return;
+
+    // draw each level with the model matrices using it
+    for (level = 0; level <= pItem->m_pLOD->m_Count; ++level)
+        if (csrSceneItemGetLODGroup(pItem, level, pBuffer, &group))
+            csrDrawMeshWithSkin(csrLODGetMesh(pItem->m_pLOD, pMesh, level),
+                               &pMesh->m_Skin,
+                                pShader,
+                               &group,
+                                pContext->m_fOnGetID);
+
+    free(pBuffer);
+}
+//---------------------------------------------------------------------------
+int csrSceneItemRecordLOD(const CSR_Scene*             pScene,
+                          const CSR_SceneItem*         pItem,
+                          const CSR_RenderCommand*     pCommand,
+                                CSR_RenderCommandList* pList)
+{
+    CSR_RenderCommand command;
+    CSR_ArrayItem*    pBuffer;
+    CSR_Array         group;
+    size_t            level;
+    int               success;
+
+    // select the level of each model matrix
+    if (!csrLODStateUpdate(pItem->m_pLOD,
+                           pItem->m_pMatrixArray,
+                          &pScene->m_ViewMatrix,
+                          &pScene->m_ProjectionMatrix,
+                           pItem->m_pLODState))
+        return csrRenderCommandListAdd(pCommand, pItem->m_pMatrixArray, pList);
+
+    // the levels are drawn with the source skin, on which the textures are linked
+    command         = *pCommand;
+    command.m_pSkin = &pCommand->m_pMesh->m_Skin;
+
+    // no model matrix?
+    if (!pItem->m_pMatrixArray || !pItem->m_pMatrixArray->m_Count)
+    {
+        command.m_pMesh = csrLODGetMesh(pItem->m_pLOD, pCommand->m_pMesh, pItem->m_pLODState->m_pLevel[0]);
+        return csrRenderCommandListAdd(&command, pItem->m_pMatrixArray, pList);
+    }
+
+    pBuffer = (CSR_ArrayItem*)malloc(pItem->m_pMatrixArray->m_Count * sizeof(CSR_ArrayItem));
+
+    // succeeded?
+    if (!pBuffer)
+        return 0;
+
+    success = 1;
+
+    // record a command for each level, with the model matrices using it
+    for (level = 0; level <= pItem->m_pLOD->m_Count && success; ++level)
+        if (csrSceneItemGetLODGroup(pItem, level, pBuffer, &group))
+        {
+            command.m_pMesh = csrLODGetMesh(pItem->m_pLOD, pCommand->m_pMesh, level);
+            success         = csrRenderCommandListAdd(&command, &group, pList);
+        }
+
+    free(pBuffer);
+
+    return success;
+}
+//---------------------------------------------------------------------------
 // Scene item functions
 //---------------------------------------------------------------------------
 CSR_SceneItem* csrSceneItemCreate(void)
@@ -350,6 +477,13 @@ void csrSceneItemContentRelease(CSR_SceneItem*       pSceneItem,
     // release the matrix array
     csrArrayRelease(pSceneItem->m_pMatrixArray);
 
+    // release the level of detail
+    csrLODRelease(pSceneItem->m_pLOD, fOnDeleteTexture);
+    csrLODStateRelease(pSceneItem->m_pLODState);
+
+    // release the height field
+    csrHeightFieldRelease(pSceneItem->m_pHeightField);
+
     // NOTE don't release the shader, as it's just linked with the item, not owned
 }
 //---------------------------------------------------------------------------
@@ -368,6 +502,48 @@ void csrSceneItemInit(CSR_SceneItem* pSceneItem)
     pSceneItem->m_pAABBTree     = 0;
     pSceneItem->m_AABBTreeCount = 0;
     pSceneItem->m_AABBTreeIndex = 0;
+    pSceneItem->m_pLOD          = 0;
+    pSceneItem->m_pLODState     = 0;
+    pSceneItem->m_pHeightField  = 0;
+}
+//---------------------------------------------------------------------------
+int csrSceneItemSetLOD(CSR_SceneItem* pSceneItem, CSR_LOD* pLOD)
+{
+    CSR_LODState* pState = 0;
+
+    // no scene item?
+    if (!pSceneItem)
+        return 0;
+
+    // create the level of detail state
+    if (pLOD)
+    {
+        pState = csrLODStateCreate();
+
+        // succeeded?
+        if (!pState)
+            return 0;
+    }
+
+    // release the previous level of detail
+    csrLODRelease(pSceneItem->m_pLOD, 0);
+    csrLODStateRelease(pSceneItem->m_pLODState);
+
+    pSceneItem->m_pLOD      = pLOD;
+    pSceneItem->m_pLODState = pState;
+
+    return 1;
+}
+//---------------------------------------------------------------------------
+void csrSceneItemSetHeightField(CSR_SceneItem* pSceneItem, CSR_HeightField* pHF)
+{
+    // no scene item?
+    if (!pSceneItem)
+        return;
+
+    // replace the previous height field
+    csrHeightFieldRelease(pSceneItem->m_pHeightField);
+    pSceneItem->m_pHeightField = pHF;
 }
 //---------------------------------------------------------------------------
 void csrSceneItemDraw(const CSR_Scene*        pScene,
@@ -408,28 +584,39 @@ void csrSceneItemDraw(const CSR_Scene*        pScene,
             break;
 
         case CSR_MT_Mesh:
-            // draw the mesh
-            csrDrawMesh((const CSR_Mesh*)pItem->m_pModel,
-                                         pShader,
-                                         pItem->m_pMatrixArray,
-                                         pContext->m_fOnGetID);
+            // draw the mesh, at the level of detail matching with its screen size if available
+            if (pItem->m_pLOD)
+                csrSceneItemDrawLOD(pScene, pContext, pItem, (const CSR_Mesh*)pItem->m_pModel, pShader);
+            else
+                csrDrawMesh((const CSR_Mesh*)pItem->m_pModel,
+                                             pShader,
+                                             pItem->m_pMatrixArray,
+                                             pContext->m_fOnGetID);
 
             break;
 
         case CSR_MT_Model:
         {
-            size_t index = 0;
+            const CSR_Model* pModel = (const CSR_Model*)pItem->m_pModel;
+                  size_t     index  = 0;
 
             // notify the caller that the model is about to be drawn
             if (pContext->m_fOnGetModelIndex)
                 pContext->m_fOnGetModelIndex((const CSR_Model*)pItem->m_pModel, &index);
 
-            // draw the model
-            csrDrawModel((const CSR_Model*)pItem->m_pModel,
-                                           index,
-                                           pShader,
-                                           pItem->m_pMatrixArray,
-                                           pContext->m_fOnGetID);
+            // draw the model, at the level of detail matching with its screen size if available
+            if (pItem->m_pLOD && pModel && pModel->m_MeshCount)
+                csrSceneItemDrawLOD(pScene,
+                                    pContext,
+                                    pItem,
+                                   &pModel->m_pMesh[index % pModel->m_MeshCount],
+                                    pShader);
+            else
+                csrDrawModel((const CSR_Model*)pItem->m_pModel,
+                                               index,
+                                               pShader,
+                                               pItem->m_pMatrixArray,
+                                               pContext->m_fOnGetID);
 
             break;
         }
@@ -532,6 +719,125 @@ void csrSceneItemDraw(const CSR_Scene*        pScene,
     csrShaderEnable(0);
 }
 //---------------------------------------------------------------------------
+int csrSceneItemRecord(const CSR_Scene*             pScene,
+                       const CSR_SceneContext*      pContext,
+                       const CSR_SceneItem*         pItem,
+                             CSR_ERenderPass        pass,
+                             CSR_RenderCommandList* pList)
+{
+    CSR_RenderCommand command;
+
+    // validate the inputs
+    if (!pScene || !pContext || !pItem || !pList)
+        return 0;
+
+    csrRenderCommandInit(&command);
+
+    command.m_Pass   = pass;
+    command.m_pModel = pItem->m_pModel;
+
+    // get the shader to use with the model
+    if (pContext->m_fOnGetShader)
+        command.m_pShader = pContext->m_fOnGetShader(pItem->m_pModel, pItem->m_Type);
+
+    // found one? (NOTE an item without shader is skipped, as csrSceneItemDraw() does)
+    if (!command.m_pShader)
+        return 1;
+
+    // resolve the model to draw, the index callbacks are called here and not on replay
+    switch (pItem->m_Type)
+    {
+        case CSR_MT_Line:
+            command.m_Type = CSR_RC_Line;
+            break;
+
+        case CSR_MT_Mesh:
+            command.m_Type  = CSR_RC_Mesh;
+            command.m_pMesh = (const CSR_Mesh*)pItem->m_pModel;
+            break;
+
+        case CSR_MT_Model:
+        {
+            const CSR_Model* pModel = (const CSR_Model*)pItem->m_pModel;
+                  size_t     index  = 0;
+
+            if (!pModel || !pModel->m_MeshCount)
+                return 1;
+
+            // notify the caller that the model is about to be drawn
+            if (pContext->m_fOnGetModelIndex)
+                pContext->m_fOnGetModelIndex(pModel, &index);
+
+            command.m_Type  = CSR_RC_Mesh;
+            command.m_pMesh = &pModel->m_pMesh[index % pModel->m_MeshCount];
+            break;
+        }
+
+        #ifdef USE_MDL
+            case CSR_MT_MDL:
+                command.m_Type = CSR_RC_MDL;
+
+                // notify the caller that the MDL model is about to be drawn
+                if (pContext->m_fOnGetMDLIndex)
+                    pContext->m_fOnGetMDLIndex((const CSR_MDL*)pItem->m_pModel,
+                                                              &command.m_Index[0],
+                                                              &command.m_Index[1],
+                                                              &command.m_Index[2]);
+
+                break;
+        #endif
+
+        #ifdef USE_X
+            case CSR_MT_X:
+                command.m_Type = CSR_RC_X;
+
+                // notify the caller that the X model is about to be drawn
+                if (pContext->m_fOnGetXIndex)
+                    pContext->m_fOnGetXIndex((const CSR_X*)pItem->m_pModel,
+                                                          &command.m_Index[0],
+                                                          &command.m_Index[1]);
+
+                break;
+        #endif
+
+        #ifdef USE_COLLADA
+            case CSR_MT_Collada:
+                command.m_Type = CSR_RC_Collada;
+
+                // notify the caller that the Collada model is about to be drawn
+                if (pContext->m_fOnGetColladaIndex)
+                    pContext->m_fOnGetColladaIndex((const CSR_Collada*)pItem->m_pModel,
+                                                                      &command.m_Index[0],
+                                                                      &command.m_Index[1]);
+
+                break;
+        #endif
+
+        #ifdef USE_IQM
+            case CSR_MT_IQM:
+                command.m_Type = CSR_RC_IQM;
+
+                // notify the caller that the IQM model is about to be drawn
+                if (pContext->m_fOnGetIQMIndex)
+                    pContext->m_fOnGetIQMIndex((const CSR_IQM*)pItem->m_pModel,
+                                                              &command.m_Index[0],
+                                                              &command.m_Index[1]);
+
+                break;
+        #endif
+
+        default:
+            return 1;
+    }
+
+    // split the mesh commands by level of detail
+    if (command.m_Type == CSR_RC_Mesh && pItem->m_pLOD)
+        return csrSceneItemRecordLOD(pScene, pItem, &command, pList);
+
+    // add the command, the model matrices are copied in the list
+    return csrRenderCommandListAdd(&command, pItem->m_pMatrixArray, pList);
+}
+//---------------------------------------------------------------------------
 void csrSceneItemDetectCollision(const CSR_Scene*                   pScene,
                                  const CSR_SceneItem*               pSceneItem,
                                  const CSR_CollisionInput*          pCollisionInput,
@@ -677,13 +983,26 @@ void csrSceneItemDetectCollision(const CSR_Scene*                   pScene,
         {
             CSR_Polygon3 groundPolygon;
             float        posY;
+            int          foundGround;
+
+            // calculate the y position where to place the point of view. NOTE the height field
+            // finds the ground in a constant time, but only in the default ground direction
+            if (pSceneItem->m_pHeightField       &&
+                pScene->m_GroundDir.m_X ==  0.0f &&
+                pScene->m_GroundDir.m_Y == -1.0f &&
+                pScene->m_GroundDir.m_Z ==  0.0f)
+                foundGround = csrHeightFieldGroundPosY(&sphere,
+                                                        pSceneItem->m_pHeightField,
+                                                       &groundPolygon,
+                                                       &posY);
+            else
+                foundGround = csrGroundPosY(&sphere,
+                                            &pSceneItem->m_pAABBTree[pSceneItem->m_AABBTreeIndex],
+                                            &pScene->m_GroundDir,
+                                            &groundPolygon,
+                                            &posY);
 
-            // calculate the y position where to place the point of view
-            if (csrGroundPosY(&sphere,
-                              &pSceneItem->m_pAABBTree[pSceneItem->m_AABBTreeIndex],
-                              &pScene->m_GroundDir,
-                              &groundPolygon,
-                              &posY))
+            if (foundGround)
             {
                 CSR_Plane   polygonPlane;
                 CSR_Matrix4 transposedMatrix;
@@ -707,40 +1026,36 @@ void csrSceneItemDetectCollision(const CSR_Scene*                   pScene,
         // do detect the edge collision on this model?
         if (pSceneItem->m_CollisionType & CSR_CO_Edge)
         {
-            CSR_Vector3 motionDir;
-            CSR_Vector3 motionDirN;
-            CSR_Ray3    motionRay;
-
-            // calculate the motion ray and put it into the model coordinate system
-            csrVec3Sub(&pCollisionInput->m_CheckPos, &pCollisionInput->m_BoundingSphere.m_Center, &motionDir);
-            csrVec3Normalize(&motionDir, &motionDirN);
-            csrMat4ApplyToVector(&invertMatrix, &pCollisionInput->m_BoundingSphere.m_Center, &rayPos);
-            csrMat4ApplyToNormal(&invertMatrix, &motionDir, &rayDir);
-            csrVec3Normalize(&rayDir, &rayDirN);
-            csrRay3FromPointDir(&rayPos, &rayDirN, &motionRay);
-
-            // 1. detect if the motion ray intersects one of the polygon. If yes the detection is terminated
-            // 2. detect if the sphere intersects one of the polygon
-
-            /*
-            CSR_Polygon3Buffer polygonBuffer;
-
-            // check for collision
-            if (csrAABBTreeResolve(&transformedRay,
-                                   &pSceneItem->m_pAABBTree[pSceneItem->m_AABBTreeIndex],
-                                    0,
-                                   &polygonBuffer))
+            CSR_Sphere         startSphere;
+            CSR_Vector3        motion;
+            CSR_SweptSphereHit hit;
+
+            // put the motion start into the model coordinate system, the motion end is the check
+            // position, already converted above
+            csrMat4Transform(&invertMatrix, &pCollisionInput->m_BoundingSphere.m_Center, &startSphere.m_Center);
+            startSphere.m_Radius = sphere.m_Radius;
+            csrVec3Sub(&sphere.m_Center, &startSphere.m_Center, &motion);
+
+            // sweep the sphere along the whole motion, and keep the nearest hit of all the models
+            if (csrSweptSphereAABBTree(&startSphere,
+                                       &motion,
+                                       &pSceneItem->m_pAABBTree[pSceneItem->m_AABBTreeIndex],
+                                       &hit) &&
+              (!(pCollisionOutput->m_Collision & CSR_CO_Edge) || hit.m_Time < pCollisionOutput->m_HitTime))
             {
-                // found at least 1 collision
-                pCollisionInfo->m_Collision = 1;
+                CSR_Matrix4 transposedMatrix;
 
-                // FIXME calculate the resulting sliding plane
-            }
+                // notify that an edge collision happened
+                pCollisionOutput->m_Collision |= CSR_CO_Edge;
+                pCollisionOutput->m_HitTime    = hit.m_Time;
 
-            // delete found polygons (no longer needed from now)
-            if (polygonBuffer.m_Count)
-                free(polygonBuffer.m_pPolygon);
-            */
+                // put the hit position and the sliding plane back into the scene coordinate system
+                csrMat4Transform(&((CSR_Matrix4*)pSceneItem->m_pMatrixArray->m_pItem->m_pData)[i],
+                                 &hit.m_Pos,
+                                 &pCollisionOutput->m_HitPos);
+                csrMat4Transpose(&invertMatrix, &transposedMatrix);
+                csrPlaneTransform(&hit.m_SlidingPlane, &transposedMatrix, &pCollisionOutput->m_CollisionPlane);
+            }
         }
 
         // do detect the mouse collision on this model?
@@ -1961,6 +2276,150 @@ void csrSceneDraw(const CSR_Scene* pScene, const CSR_SceneContext* pContext)
         csrDrawEnd();
 }
 //---------------------------------------------------------------------------
+int csrSceneRecordItems(const CSR_Scene*             pScene,
+                        const CSR_SceneContext*      pContext,
+                              int                    transparent,
+                              size_t                 start,
+                              size_t                 count,
+                              CSR_RenderCommandList* pList)
+{
+    size_t               i;
+    size_t               end;
+    size_t               itemCount;
+    const CSR_SceneItem* pItems;
+    CSR_ERenderPass      pass;
+
+    // validate the inputs
+    if (!pScene || !pContext || !pList)
+        return 0;
+
+    // get the item array to record
+    if (transparent)
+    {
+        pItems    = pScene->m_pTransparentItem;
+        itemCount = pScene->m_TransparentItemCount;
+        pass      = CSR_RP_Transparent;
+    }
+    else
+    {
+        pItems    = pScene->m_pItem;
+        itemCount = pScene->m_ItemCount;
+        pass      = CSR_RP_Opaque;
+    }
+
+    // nothing to record?
+    if (start >= itemCount)
+        return 1;
+
+    end = start + count;
+
+    if (end > itemCount)
+        end = itemCount;
+
+    // record the items
+    for (i = start; i < end; ++i)
+        if (!csrSceneItemRecord(pScene, pContext, &pItems[i], pass, pList))
+            return 0;
+
+    return 1;
+}
+//---------------------------------------------------------------------------
+int csrSceneRecord(const CSR_Scene*             pScene,
+                   const CSR_SceneContext*      pContext,
+                         CSR_RenderCommandList* pList)
+{
+    // validate the inputs
+    if (!pScene || !pContext || !pList)
+        return 0;
+
+    // copy the scene state, the scene may change while the commands are drawn
+    pList->m_Color            = pScene->m_Color;
+    pList->m_ProjectionMatrix = pScene->m_ProjectionMatrix;
+    pList->m_ViewMatrix       = pScene->m_ViewMatrix;
+
+    // record the skybox
+    if (pScene->m_pSkybox && pContext->m_fOnGetShader)
+    {
+        CSR_RenderCommand command;
+
+        csrRenderCommandInit(&command);
+
+        command.m_Type    = CSR_RC_Mesh;
+        command.m_Pass    = CSR_RP_Skybox;
+        command.m_pModel  = pScene->m_pSkybox;
+        command.m_pMesh   = pScene->m_pSkybox;
+        command.m_pShader = pContext->m_fOnGetShader(pScene->m_pSkybox, CSR_MT_Mesh);
+
+        if (command.m_pShader && !csrRenderCommandListAdd(&command, 0, pList))
+            return 0;
+    }
+
+    // record the standard models
+    if (!csrSceneRecordItems(pScene, pContext, 0, 0, pScene->m_ItemCount, pList))
+        return 0;
+
+    // record the transparent models
+    return csrSceneRecordItems(pScene, pContext, 1, 0, pScene->m_TransparentItemCount, pList);
+}
+//---------------------------------------------------------------------------
+void csrSceneDrawCommands(const CSR_Scene*             pScene,
+                          const CSR_SceneContext*      pContext,
+                          const CSR_RenderCommandList* pList)
+{
+    size_t i;
+    size_t first;
+    size_t opaqueStart;
+    size_t transparentStart;
+
+    // validate the inputs
+    if (!pScene || !pContext || !pList)
+        return;
+
+    // begin the scene drawing
+    if (pContext->m_fOnSceneBegin)
+        pContext->m_fOnSceneBegin(pScene, pContext);
+    else
+        csrDrawBegin(&pList->m_Color);
+
+    // find where each pass begins, the commands are recorded in pass order
+    for (first = 0; first < pList->m_Count && pList->m_pCommand[first].m_Pass == CSR_RP_Skybox; ++first);
+
+    opaqueStart = first;
+
+    for (i = first; i < pList->m_Count && pList->m_pCommand[i].m_Pass == CSR_RP_Opaque; ++i);
+
+    transparentStart = i;
+
+    // draw the skybox
+    csrDrawRenderCommands(pList, 0, opaqueStart, pContext->m_fOnGetID);
+
+    // prepare the scene to draw common models
+    if (pContext->m_fOnPrepareDraw)
+        pContext->m_fOnPrepareDraw(pScene, pContext);
+
+    // first draw the standard models
+    csrDrawRenderCommands(pList,
+                          opaqueStart,
+                          transparentStart - opaqueStart,
+                          pContext->m_fOnGetID);
+
+    // prepare the scene to draw transparent models
+    if (pContext->m_fOnPrepareTransparentDraw)
+        pContext->m_fOnPrepareTransparentDraw(pScene, pContext);
+
+    // then draw the transparent models
+    csrDrawRenderCommands(pList,
+                          transparentStart,
+                          pList->m_Count - transparentStart,
+                          pContext->m_fOnGetID);
+
+    // end the scene drawing
+    if (pContext->m_fOnSceneEnd)
+        pContext->m_fOnSceneEnd(pScene, pContext);
+    else
+        csrDrawEnd();
+}
+//---------------------------------------------------------------------------
 void csrSceneArcBallToMatrix(const CSR_ArcBall* pArcball, CSR_Matrix4* pR)
 {
     #ifdef _MSC_VER
@@ -22,6 +22,8 @@
 #include "CSR_Collision.h"
 #include "CSR_GJK.h"
 #include "CSR_Model.h"
+#include "CSR_Lod.h"
+#include "CSR_HeightField.h"
 #include "CSR_Renderer.h"
 #ifdef USE_MDL
     #include "CSR_Mdl.h"
@@ -131,6 +133,9 @@ typedef struct
     CSR_AABBNode*      m_pAABBTree;     // aligned-axis bounding box trees owned by the model
     size_t             m_AABBTreeCount; // aligned-axis bounding box tree count
     size_t             m_AABBTreeIndex; // aligned-axis bounding box tree index to use for the collision detection
+    CSR_LOD*           m_pLOD;          // level of detail meshes, if 0 the model is always drawn at full resolution
+    CSR_LODState*      m_pLODState;     // level currently used by each model matrix
+    CSR_HeightField*   m_pHeightField;  // landscape height field, if set the ground is found in it instead of in the tree
 } CSR_SceneItem;
 
 /**
@@ -195,7 +200,8 @@ typedef struct
 {
     CSR_Ray3    m_MouseRay;       // ray starting from the mouse position, transformed in the viewport coordinates system
     CSR_Sphere  m_BoundingSphere; // bounding sphere representing the model or point of view at its current position
-    CSR_Vector3 m_CheckPos;       // the model or point of view position to check
+    CSR_Vector3 m_CheckPos;       // the model or point of view position to check, the edge collision is
+                                  // checked on the whole motion from the bounding sphere center to it
 } CSR_CollisionInput;
 
 /**
@@ -206,6 +212,8 @@ typedef struct
     CSR_ECollisionType m_Collision;      // found collision type in the scene
     float              m_GroundPos;      // the ground position on the y axis, M_CSR_NoGround if no ground was found
     CSR_Plane          m_CollisionPlane; // the collision plane, in case a collision was found
+    float              m_HitTime;        // edge collision, motion part done before the impact, between 0 and 1
+    CSR_Vector3        m_HitPos;         // edge collision, bounding sphere center at the impact
     CSR_Plane          m_GroundPlane;    // the ground plane, in case a ground was found
     CSR_Vector3        m_MinTransVec;    // minimum translation vector, if GJK is used
     CSR_Array*         m_pHitModels;     // models hit by the mouse ray
@@ -470,6 +478,27 @@ struct CSR_SceneContext
         */
         void csrSceneItemInit(CSR_SceneItem* pSI);
 
+        /**
+        * Sets the level of detail meshes to use with a scene item
+        *@param[in, out] pSI - scene item for which the level of detail should be set
+        *@param pLOD - level of detail meshes, created from the item mesh, if 0 the level of detail is removed
+        *@return 1 on success, otherwise 0
+        *@note The scene item takes the ownership of the level of detail meshes
+        *@note The level of detail is only applied to the mesh and model items. For a model, the
+        *      level of detail replaces the drawn mesh, thus it should only be used on static models
+        */
+        int csrSceneItemSetLOD(CSR_SceneItem* pSI, CSR_LOD* pLOD);
+
+        /**
+        * Sets the height field to use to find the ground on a scene item
+        *@param[in, out] pSI - scene item for which the height field should be set
+        *@param pHF - height field, matching with the item landscape, if 0 the height field is removed
+        *@note The scene item takes the ownership of the height field
+        *@note The height field is only used if the scene ground direction is [0, -1, 0], otherwise
+        *      the ground is still found in the aligned-axis bounding box tree
+        */
+        void csrSceneItemSetHeightField(CSR_SceneItem* pSI, CSR_HeightField* pHF);
+
         /**
         * Draws a scene item
         *@param pScene - scene at which the item belongs
@@ -480,6 +509,23 @@ struct CSR_SceneContext
                               const CSR_SceneContext* pContext,
                               const CSR_SceneItem*    pItem);
 
+        /**
+        * Records a scene item in a render command list
+        *@param pScene - scene at which the item belongs
+        *@param pContext - scene context
+        *@param pItem - scene item to record
+        *@param pass - render pass in which the item will be drawn
+        *@param[in, out] pList - render command list in which the item should be recorded
+        *@return 1 on success, otherwise 0
+        *@note The shader and index callbacks are called while recording and not while drawing,
+        *      thus the recording may be executed outside the thread owning the graphics context
+        */
+        int csrSceneItemRecord(const CSR_Scene*             pScene,
+                               const CSR_SceneContext*      pContext,
+                               const CSR_SceneItem*         pItem,
+                                     CSR_ERenderPass        pass,
+                                     CSR_RenderCommandList* pList);
+
         /**
         * Detects the collisions happening against a scene item
         *@param pScene - scene containing the item to check
@@ -661,6 +707,49 @@ struct CSR_SceneContext
         */
         void csrSceneDraw(const CSR_Scene* pScene, const CSR_SceneContext* pContext);
 
+        /**
+        * Records a range of scene items in a render command list
+        *@param pScene - scene containing the items to record
+        *@param pContext - scene context
+        *@param transparent - if 1, the range is read from the transparent items
+        *@param start - first item to record
+        *@param count - item count to record
+        *@param[in, out] pList - render command list in which the items should be recorded
+        *@return 1 on success, otherwise 0
+        *@note Several threads may record distinct ranges in their own lists, which may then be
+        *      merged in order with csrRenderCommandListAppend()
+        */
+        int csrSceneRecordItems(const CSR_Scene*             pScene,
+                                const CSR_SceneContext*      pContext,
+                                      int                    transparent,
+                                      size_t                 start,
+                                      size_t                 count,
+                                      CSR_RenderCommandList* pList);
+
+        /**
+        * Records a whole scene in a render command list
+        *@param pScene - scene to record
+        *@param pContext - scene context
+        *@param[in, out] pList - render command list in which the scene should be recorded
+        *@return 1 on success, otherwise 0
+        *@note The list should be cleared with csrRenderCommandListClear() before recording a new frame
+        */
+        int csrSceneRecord(const CSR_Scene*             pScene,
+                           const CSR_SceneContext*      pContext,
+                                 CSR_RenderCommandList* pList);
+
+        /**
+        * Draws a previously recorded scene
+        *@param pScene - recorded scene
+        *@param pContext - scene context
+        *@param pList - render command list containing the recorded scene
+        *@note The begin, prepare and end callbacks are called as in csrSceneDraw(), but the shader
+        *      and index callbacks are not, their results were saved while recording
+        */
+        void csrSceneDrawCommands(const CSR_Scene*             pScene,
+                                  const CSR_SceneContext*      pContext,
+                                  const CSR_RenderCommandList* pList);
+
         /**
         * Gets a camera (or view) matrix from arcball values
         *@param pArcball - arcball values
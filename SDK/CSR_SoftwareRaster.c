@@ -21,6 +21,188 @@
 #include <math.h>
 #include <string.h>
 
+//---------------------------------------------------------------------------
+// Raster private functions
+//---------------------------------------------------------------------------
+size_t csrRasterTextureTexelIndex(const CSR_RasterTextureLevel* pLevel, size_t x, size_t y)
+{
+    // the tiles are stored row by row, and the texels row by row inside each tile
+    return ((((y >> M_CSR_Raster_Tile_Shift) * pLevel->m_TileCountX) + (x >> M_CSR_Raster_Tile_Shift))
+                    << (2 * M_CSR_Raster_Tile_Shift))                                             +
+           ((y & (M_CSR_Raster_Tile_Size - 1)) << M_CSR_Raster_Tile_Shift)                         +
+            (x & (M_CSR_Raster_Tile_Size - 1));
+}
+//---------------------------------------------------------------------------
+int csrRasterTextureLevelFromPixelBuffer(const CSR_PixelBuffer* pPB, CSR_RasterTextureLevel* pLevel)
+{
+    const unsigned char* pData;
+    const unsigned char* pSrc;
+          size_t         rowLength;
+          size_t         tileCountY;
+          size_t         x;
+          size_t         y;
+          unsigned       r;
+          unsigned       g;
+          unsigned       b;
+          unsigned       a;
+
+    pLevel->m_Width      = pPB->m_Width;
+    pLevel->m_Height     = pPB->m_Height;
+    pLevel->m_TileCountX = (pLevel->m_Width  + M_CSR_Raster_Tile_Size - 1) >> M_CSR_Raster_Tile_Shift;
+    tileCountY           = (pLevel->m_Height + M_CSR_Raster_Tile_Size - 1) >> M_CSR_Raster_Tile_Shift;
+
+    // the partial tiles on the right and bottom borders are allocated entirely
+    pLevel->m_pTexel = (unsigned*)malloc(pLevel->m_TileCountX                               *
+                                         tileCountY                                         *
+                                         (M_CSR_Raster_Tile_Size * M_CSR_Raster_Tile_Size) *
+                                         sizeof(unsigned));
+
+    // succeeded?
+    if (!pLevel->m_pTexel)
+        return 0;
+
+    pData     = (const unsigned char*)pPB->m_pData;
+    rowLength = csrPixelBufferRowLength(pPB);
+
+    // pack the pixels in the tiles
+    for (y = 0; y < pLevel->m_Height; ++y)
+        for (x = 0; x < pLevel->m_Width; ++x)
+        {
+            // the bitmap pixels are stored in BGR, and mirrored (see csrOpenGLTextureFromPixelBuffer())
+            if (pPB->m_ImageType == CSR_IT_Bitmap)
+            {
+                pSrc = pData + (rowLength * y) + (3 * (pLevel->m_Width - x - 1));
+                r    = pSrc[2];
+                g    = pSrc[1];
+                b    = pSrc[0];
+                a    = 255;
+            }
+            else
+            {
+                pSrc = pData + (rowLength * y) + (pPB->m_BytePerPixel * x);
+                r    = pSrc[0];
+                g    = pSrc[1];
+                b    = pSrc[2];
+                a    = pPB->m_BytePerPixel == 4 ? pSrc[3] : 255;
+            }
+
+            pLevel->m_pTexel[csrRasterTextureTexelIndex(pLevel, x, y)] = r | (g << 8) | (b << 16) | (a << 24);
+        }
+
+    return 1;
+}
+//---------------------------------------------------------------------------
+unsigned csrRasterTextureLerp(unsigned texel1, unsigned texel2, unsigned factor)
+{
+    // interpolate the red and blue channels together, then the green and alpha channels together.
+    // The factor is a 8 bit fixed point value, so each interpolated channel fits in 16 bit
+    const unsigned rb = ((((texel1       & 0x00FF00FF) * (256 - factor)) +
+                          ((texel2       & 0x00FF00FF) *        factor))  >> 8) & 0x00FF00FF;
+    const unsigned ga =  ((((texel1 >> 8) & 0x00FF00FF) * (256 - factor)) +
+                          (((texel2 >> 8) & 0x00FF00FF) *        factor))        & 0xFF00FF00;
+
+    return rb | ga;
+}
+//---------------------------------------------------------------------------
+void csrRasterGetST(const CSR_Polygon3* pRasterPoly,
+                    const CSR_Vector2*  pST,
+                          float         area,
+                          float         x,
+                          float         y,
+                          CSR_Vector2*  pResult)
+{
+    #ifdef _MSC_VER
+        CSR_Vector3 pixelSample = {0};
+    #else
+        CSR_Vector3 pixelSample;
+    #endif
+    float w0;
+    float w1;
+    float w2;
+    float invZ;
+
+    pResult->m_X = 0.0f;
+    pResult->m_Y = 0.0f;
+
+    // degenerated polygon?
+    if (!area)
+        return;
+
+    pixelSample.m_X = x;
+    pixelSample.m_Y = y;
+    pixelSample.m_Z = 0.0f;
+
+    // calculate the barycentric coordinates, the pixel may be outside the polygon
+    csrRasterFindEdge(&pRasterPoly->m_Vertex[1], &pRasterPoly->m_Vertex[2], &pixelSample, &w0);
+    csrRasterFindEdge(&pRasterPoly->m_Vertex[2], &pRasterPoly->m_Vertex[0], &pixelSample, &w1);
+    csrRasterFindEdge(&pRasterPoly->m_Vertex[0], &pRasterPoly->m_Vertex[1], &pixelSample, &w2);
+
+    w0 /= area;
+    w1 /= area;
+    w2 /= area;
+
+    // calculate the perspective correct texture coordinate
+    invZ = (pRasterPoly->m_Vertex[0].m_Z * w0) +
+           (pRasterPoly->m_Vertex[1].m_Z * w1) +
+           (pRasterPoly->m_Vertex[2].m_Z * w2);
+
+    if (!invZ)
+        return;
+
+    pResult->m_X = ((pST[0].m_X * w0) + (pST[1].m_X * w1) + (pST[2].m_X * w2)) / invZ;
+    pResult->m_Y = ((pST[0].m_Y * w0) + (pST[1].m_Y * w1) + (pST[2].m_Y * w2)) / invZ;
+}
+//---------------------------------------------------------------------------
+void csrFrameBufferTableRow(const CSR_Pixel* pPixel,
+                                  size_t     width,
+                            const double*    pPrevRow,
+                                  double*    pRow)
+{
+    size_t x;
+    double r  = 0.0;
+    double g  = 0.0;
+    double b  = 0.0;
+    double sq = 0.0;
+
+    // the first column is empty
+    pRow[0] = 0.0;
+    pRow[1] = 0.0;
+    pRow[2] = 0.0;
+    pRow[3] = 0.0;
+
+    // each entry contains the sum of the pixels above and on the left, i.e. the previous row entry
+    // plus the sum of the pixel row on the left. The sums are integers, thus exact in a double
+    for (x = 0; x < width; ++x)
+    {
+        r  += pPixel[x].m_R;
+        g  += pPixel[x].m_G;
+        b  += pPixel[x].m_B;
+        sq += (pPixel[x].m_R * pPixel[x].m_R) +
+              (pPixel[x].m_G * pPixel[x].m_G) +
+              (pPixel[x].m_B * pPixel[x].m_B);
+
+        pRow[((x + 1) * 4)]     = pPrevRow[((x + 1) * 4)]     + r;
+        pRow[((x + 1) * 4) + 1] = pPrevRow[((x + 1) * 4) + 1] + g;
+        pRow[((x + 1) * 4) + 2] = pPrevRow[((x + 1) * 4) + 2] + b;
+        pRow[((x + 1) * 4) + 3] = pPrevRow[((x + 1) * 4) + 3] + sq;
+    }
+}
+//---------------------------------------------------------------------------
+void csrFrameBufferTableSum(const double* pTop,
+                            const double* pBottom,
+                                  size_t  left,
+                                  size_t  right,
+                                  double* pSum)
+{
+    size_t i;
+
+    // the sum of a rectangle is read in its 4 corners, the bottom and right ones are exclusive
+    for (i = 0; i < 4; ++i)
+        pSum[i] = (pBottom[((right + 1) * 4) + i] - pBottom[(left * 4) + i]) -
+                  (pTop   [((right + 1) * 4) + i] - pTop   [(left * 4) + i]);
+}
+//---------------------------------------------------------------------------
+// Frame buffer functions
 //---------------------------------------------------------------------------
 CSR_FrameBuffer* csrFrameBufferCreate(size_t width, size_t height)
 {
@@ -98,6 +280,142 @@ void csrFrameBufferClear(CSR_FrameBuffer* pFB, const CSR_Pixel* pPixel)
         memcpy(&pFB->m_pPixel[i], pPixel, sizeof(CSR_Pixel));
 }
 //---------------------------------------------------------------------------
+int csrFrameBufferOilPainting(const CSR_FrameBuffer* pSrc,
+                                    size_t           radius,
+                                    CSR_FrameBuffer* pDst)
+{
+    double*    pTable;
+    double*    pRow[4];
+    double     sum[4];
+    double     n;
+    double     mean[3];
+    double     variance;
+    double     minVariance;
+    size_t     rowCount;
+    size_t     rowLength;
+    size_t     tableRow;
+    size_t     x;
+    size_t     y;
+    size_t     i;
+    size_t     left;
+    size_t     right;
+    size_t     top;
+    size_t     bottom;
+    size_t     height;
+    size_t     quadrantLeft[4];
+    size_t     quadrantRight[4];
+    CSR_Pixel* pPixel;
+
+    // validate the inputs
+    if (!pSrc || !pSrc->m_pPixel || !pDst || !pDst->m_pPixel)
+        return 0;
+
+    // the frame buffers should have the same size
+    if (pSrc->m_Width != pDst->m_Width || pSrc->m_Height != pDst->m_Height)
+        return 0;
+
+    /*
+    * the summed-area table row k contains, for each column, the sums of the pixel colors and of
+    * their squares above the row k and on the left of the column. A pixel row needs the table rows
+    * between y - radius and y + radius + 1, so only these rows are kept, in a ring. As the pixel
+    * row y is written after the source rows until y + radius are read, the source frame buffer may
+    * also be the destination one
+    */
+    rowCount = (2 * radius) + 2;
+
+    if (rowCount > pSrc->m_Height + 1)
+        rowCount = pSrc->m_Height + 1;
+
+    rowLength = (pSrc->m_Width + 1) * 4;
+    pTable    = (double*)malloc(rowCount * rowLength * sizeof(double));
+
+    // succeeded?
+    if (!pTable)
+        return 0;
+
+    // the first table row is empty
+    memset(pTable, 0, rowLength * sizeof(double));
+    tableRow = 1;
+
+    for (y = 0; y < pSrc->m_Height; ++y)
+    {
+        // calculate the quadrants vertical limits
+        top    = y >= radius ? y - radius : 0;
+        bottom = y + radius < pSrc->m_Height ? y + radius : pSrc->m_Height - 1;
+
+        // build the table rows until the one below the quadrants
+        for (; tableRow <= bottom + 1; ++tableRow)
+            csrFrameBufferTableRow(&pSrc->m_pPixel[(tableRow - 1) * pSrc->m_Width],
+                                    pSrc->m_Width,
+                                   &pTable[((tableRow - 1) % rowCount) * rowLength],
+                                   &pTable[( tableRow      % rowCount) * rowLength]);
+
+        // get the table rows above and below the top and bottom quadrants
+        pRow[0] = &pTable[( top         % rowCount) * rowLength];
+        pRow[1] = &pTable[((y + 1)      % rowCount) * rowLength];
+        pRow[2] = &pTable[( y           % rowCount) * rowLength];
+        pRow[3] = &pTable[((bottom + 1) % rowCount) * rowLength];
+
+        for (x = 0; x < pSrc->m_Width; ++x)
+        {
+            // calculate the quadrants horizontal limits
+            left  = x >= radius ? x - radius : 0;
+            right = x + radius < pSrc->m_Width ? x + radius : pSrc->m_Width - 1;
+
+            // the quadrants are, in order, the top left, top right, bottom right and bottom left ones
+            quadrantLeft[0] = left; quadrantRight[0] = x;
+            quadrantLeft[1] = x;    quadrantRight[1] = right;
+            quadrantLeft[2] = x;    quadrantRight[2] = right;
+            quadrantLeft[3] = left; quadrantRight[3] = x;
+
+            pPixel      = &pDst->m_pPixel[(y * pSrc->m_Width) + x];
+            minVariance = 0.0;
+
+            for (i = 0; i < 4; ++i)
+            {
+                // get the quadrant sums
+                if (i < 2)
+                {
+                    csrFrameBufferTableSum(pRow[0], pRow[1], quadrantLeft[i], quadrantRight[i], sum);
+                    height = y - top + 1;
+                }
+                else
+                {
+                    csrFrameBufferTableSum(pRow[2], pRow[3], quadrantLeft[i], quadrantRight[i], sum);
+                    height = bottom - y + 1;
+                }
+
+                n = (double)((quadrantRight[i] - quadrantLeft[i] + 1) * height);
+
+                // calculate the quadrant mean color, and its variance summed on all the channels. The
+                // variance numerator is an exact integer, thus equal variances are always kept equal
+                mean[0]  = sum[0] / n;
+                mean[1]  = sum[1] / n;
+                mean[2]  = sum[2] / n;
+                variance = ((n * sum[3]) - ((sum[0] * sum[0]) + (sum[1] * sum[1]) + (sum[2] * sum[2]))) / (n * n);
+
+                // keep the mean color of the less varying quadrant
+                if (!i || variance < minVariance)
+                {
+                    minVariance = variance;
+                    pPixel->m_R = (unsigned char)(mean[0] + 0.5);
+                    pPixel->m_G = (unsigned char)(mean[1] + 0.5);
+                    pPixel->m_B = (unsigned char)(mean[2] + 0.5);
+                }
+            }
+
+            // the alpha channel is kept
+            pPixel->m_A = pSrc->m_pPixel[(y * pSrc->m_Width) + x].m_A;
+        }
+    }
+
+    free(pTable);
+
+    return 1;
+}
+//---------------------------------------------------------------------------
+// Depth buffer functions
+//---------------------------------------------------------------------------
 CSR_DepthBuffer* csrDepthBufferCreate(size_t width, size_t height)
 {
     // create a depth buffer
@@ -174,6 +492,220 @@ void csrDepthBufferClear(CSR_DepthBuffer* pDB, float zFar)
         memcpy(&pDB->m_pData[i], &zFar, sizeof(float));
 }
 //---------------------------------------------------------------------------
+// Raster texture functions
+//---------------------------------------------------------------------------
+CSR_RasterTexture* csrRasterTextureCreate(const CSR_PixelBuffer* pPB)
+{
+    CSR_MipChain*      pMC;
+    CSR_RasterTexture* pTexture;
+    size_t             i;
+
+    // validate the input
+    if (!pPB || !pPB->m_pData)
+        return 0;
+
+    // only the 24 bit bitmaps and the 24 or 32 bit raw images are supported
+    if (pPB->m_BytePerPixel != 3 && (pPB->m_BytePerPixel != 4 || pPB->m_ImageType == CSR_IT_Bitmap))
+        return 0;
+
+    // generate the mipmaps
+    pMC = csrMipChainCreate(pPB);
+
+    // succeeded?
+    if (!pMC)
+        return 0;
+
+    // create the raster texture
+    pTexture = (CSR_RasterTexture*)malloc(sizeof(CSR_RasterTexture));
+
+    // succeeded?
+    if (!pTexture)
+    {
+        csrMipChainRelease(pMC);
+        return 0;
+    }
+
+    csrRasterTextureInit(pTexture);
+
+    // create the texture levels
+    pTexture->m_pLevel = (CSR_RasterTextureLevel*)malloc(pMC->m_Count * sizeof(CSR_RasterTextureLevel));
+
+    // succeeded?
+    if (!pTexture->m_pLevel)
+    {
+        csrMipChainRelease(pMC);
+        csrRasterTextureRelease(pTexture);
+        return 0;
+    }
+
+    pTexture->m_Count = pMC->m_Count;
+
+    for (i = 0; i < pTexture->m_Count; ++i)
+        pTexture->m_pLevel[i].m_pTexel = 0;
+
+    // convert each mipmap to a tiled texture level
+    for (i = 0; i < pTexture->m_Count; ++i)
+        if (!csrRasterTextureLevelFromPixelBuffer(&pMC->m_pLevel[i], &pTexture->m_pLevel[i]))
+        {
+            csrMipChainRelease(pMC);
+            csrRasterTextureRelease(pTexture);
+            return 0;
+        }
+
+    // the mipmap chain is no longer needed
+    csrMipChainRelease(pMC);
+
+    return pTexture;
+}
+//---------------------------------------------------------------------------
+void csrRasterTextureRelease(CSR_RasterTexture* pTexture)
+{
+    size_t i;
+
+    // no raster texture to release?
+    if (!pTexture)
+        return;
+
+    // free the texture levels
+    if (pTexture->m_pLevel)
+    {
+        for (i = 0; i < pTexture->m_Count; ++i)
+            if (pTexture->m_pLevel[i].m_pTexel)
+                free(pTexture->m_pLevel[i].m_pTexel);
+
+        free(pTexture->m_pLevel);
+    }
+
+    // free the raster texture
+    free(pTexture);
+}
+//---------------------------------------------------------------------------
+void csrRasterTextureInit(CSR_RasterTexture* pTexture)
+{
+    // no raster texture to initialize?
+    if (!pTexture)
+        return;
+
+    // initialize the raster texture
+    pTexture->m_pLevel = 0;
+    pTexture->m_Count  = 0;
+}
+//---------------------------------------------------------------------------
+float csrRasterTextureGetLevel(const CSR_RasterTexture* pTexture,
+                               const CSR_Vector2*       pDSTdx,
+                               const CSR_Vector2*       pDSTdy)
+{
+    float dUdx;
+    float dVdx;
+    float dUdy;
+    float dVdy;
+    float rhoX;
+    float rhoY;
+    float level;
+
+    // validate the inputs
+    if (!pTexture || !pTexture->m_Count || !pDSTdx || !pDSTdy)
+        return 0.0f;
+
+    // convert the derivatives to texels in the full size image
+    dUdx = pDSTdx->m_X * (float)pTexture->m_pLevel[0].m_Width;
+    dVdx = pDSTdx->m_Y * (float)pTexture->m_pLevel[0].m_Height;
+    dUdy = pDSTdy->m_X * (float)pTexture->m_pLevel[0].m_Width;
+    dVdy = pDSTdy->m_Y * (float)pTexture->m_pLevel[0].m_Height;
+
+    // get the largest squared pixel footprint
+    rhoX = (dUdx * dUdx) + (dVdx * dVdx);
+    rhoY = (dUdy * dUdy) + (dVdy * dVdy);
+
+    if (rhoY > rhoX)
+        rhoX = rhoY;
+
+    // magnified texture?
+    if (rhoX <= 1.0f)
+        return 0.0f;
+
+    // the level is the log2 of the footprint, i.e. the half of the squared footprint log2
+    level = (float)(0.5 * log(rhoX) / log(2.0));
+
+    if (level > (float)(pTexture->m_Count - 1))
+        return (float)(pTexture->m_Count - 1);
+
+    return level;
+}
+//---------------------------------------------------------------------------
+void csrRasterTextureSample(const CSR_RasterTexture* pTexture,
+                            const CSR_Vector2*       pST,
+                                  float              level,
+                                  CSR_Color*         pColor)
+{
+    const CSR_RasterTextureLevel* pLevel;
+          float                   s;
+          float                   t;
+          float                   u;
+          float                   v;
+          size_t                  index;
+          size_t                  x0;
+          size_t                  y0;
+          size_t                  x1;
+          size_t                  y1;
+          unsigned                fx;
+          unsigned                fy;
+          unsigned                texel;
+
+    // validate the inputs
+    if (!pTexture || !pTexture->m_Count || !pST || !pColor)
+        return;
+
+    // get the nearest mipmap level
+    if (level <= 0.0f)
+        index = 0;
+    else
+        index = (size_t)(level + 0.5f);
+
+    if (index >= pTexture->m_Count)
+        index = pTexture->m_Count - 1;
+
+    pLevel = &pTexture->m_pLevel[index];
+
+    // limit the texture coordinate between 0 and 1 (equivalent to OpenGL clamp mode)
+    csrMathClamp(pST->m_X, 0.0f, 1.0f, &s);
+    csrMathClamp(pST->m_Y, 0.0f, 1.0f, &t);
+
+    // calculate the texel position, relative to the texel centers
+    u = (s * (float)pLevel->m_Width)  - 0.5f;
+    v = (t * (float)pLevel->m_Height) - 0.5f;
+
+    if (u < 0.0f)
+        u = 0.0f;
+
+    if (v < 0.0f)
+        v = 0.0f;
+
+    // get the 4 texels to blend, and the blend weights, as 8 bit fixed point values
+    x0 = (size_t)u;
+    y0 = (size_t)v;
+    x1 = (x0 + 1 < pLevel->m_Width)  ? x0 + 1 : x0;
+    y1 = (y0 + 1 < pLevel->m_Height) ? y0 + 1 : y0;
+    fx = (unsigned)((u - (float)x0) * 256.0f);
+    fy = (unsigned)((v - (float)y0) * 256.0f);
+
+    // blend the texels, all the channels are interpolated at once
+    texel = csrRasterTextureLerp(csrRasterTextureLerp(pLevel->m_pTexel[csrRasterTextureTexelIndex(pLevel, x0, y0)],
+                                                      pLevel->m_pTexel[csrRasterTextureTexelIndex(pLevel, x1, y0)],
+                                                      fx),
+                                 csrRasterTextureLerp(pLevel->m_pTexel[csrRasterTextureTexelIndex(pLevel, x0, y1)],
+                                                      pLevel->m_pTexel[csrRasterTextureTexelIndex(pLevel, x1, y1)],
+                                                      fx),
+                                 fy);
+
+    pColor->m_R = (float)( texel        & 0xFF) / 255.0f;
+    pColor->m_G = (float)((texel >> 8)  & 0xFF) / 255.0f;
+    pColor->m_B = (float)((texel >> 16) & 0xFF) / 255.0f;
+    pColor->m_A = (float)((texel >> 24) & 0xFF) / 255.0f;
+}
+//---------------------------------------------------------------------------
+// Raster functions
+//---------------------------------------------------------------------------
 void csrRasterInit(CSR_Raster* pRaster)
 {
     // no raster to initialize?
@@ -184,6 +716,7 @@ void csrRasterInit(CSR_Raster* pRaster)
     pRaster->m_ApertureHeight = 0.735f; // 35mm full aperture in inches
     pRaster->m_FocalLength    = 20.0f;  // focal length in mm
     pRaster->m_Type           = CSR_RT_Overscan;
+    pRaster->m_pTexture       = 0;
 }
 //---------------------------------------------------------------------------
 void csrRasterFindMin(float a, float b, float c, float* pR)
@@ -466,6 +999,7 @@ int csrRasterDrawPolygon(const CSR_Polygon3*              pPolygon,
                                CSR_ECullingType           cullingType,
                                CSR_ECullingFace           cullingFace,
                          const CSR_Rect*                  pScreenRect,
+                         const CSR_RasterTexture*         pTexture,
                                CSR_FrameBuffer*           pFB,
                                CSR_DepthBuffer*           pDB,
                          const CSR_fOnApplyFragmentShader fOnApplyFragmentShader)
@@ -485,8 +1019,11 @@ int csrRasterDrawPolygon(const CSR_Polygon3*              pPolygon,
         float        w2;
         float        invZ;
         float        z;
+        float        level;
         size_t       x;
         size_t       y;
+        size_t       quadX;
+        size_t       quadY;
         size_t       x0;
         size_t       x1;
         size_t       y0;
@@ -496,6 +1033,9 @@ int csrRasterDrawPolygon(const CSR_Polygon3*              pPolygon,
         CSR_Polygon3 rasterPoly  = {0};
         CSR_Vector2  st[3]       = {0};
         CSR_Vector2  stCoord     = {0};
+        CSR_Vector2  quadST[3]   = {0};
+        CSR_Vector2  dSTdx       = {0};
+        CSR_Vector2  dSTdy       = {0};
         CSR_Vector3  pixelSample = {0};
         CSR_Vector3  sampler     = {0};
         CSR_Color    color       = {0};
@@ -514,8 +1054,11 @@ int csrRasterDrawPolygon(const CSR_Polygon3*              pPolygon,
         float        w2;
         float        invZ;
         float        z;
+        float        level;
         size_t       x;
         size_t       y;
+        size_t       quadX;
+        size_t       quadY;
         size_t       x0;
         size_t       x1;
         size_t       y0;
@@ -525,6 +1068,9 @@ int csrRasterDrawPolygon(const CSR_Polygon3*              pPolygon,
         CSR_Polygon3 rasterPoly;
         CSR_Vector2  st[3];
         CSR_Vector2  stCoord;
+        CSR_Vector2  quadST[3];
+        CSR_Vector2  dSTdx;
+        CSR_Vector2  dSTdy;
         CSR_Vector3  pixelSample;
         CSR_Vector3  sampler;
         CSR_Color    color;
@@ -661,125 +1207,153 @@ int csrRasterDrawPolygon(const CSR_Polygon3*              pPolygon,
     // calculate the triangle area (multiplied by 2)
     csrRasterFindEdge(&rasterPoly.m_Vertex[0], &rasterPoly.m_Vertex[1], &rasterPoly.m_Vertex[2], &area);
 
-    // iterate through pixels to draw
-    for (y = y0; y <= y1; ++y)
-        for (x = x0; x <= x1; ++x)
-        {
-            pixelSample.m_X = x + 0.5f;
-            pixelSample.m_Y = y + 0.5f;
-            pixelSample.m_Z =     0.0f;
-
-            // calculate the sub-triangle areas (multiplied by 2)
-            csrRasterFindEdge(&rasterPoly.m_Vertex[1], &rasterPoly.m_Vertex[2], &pixelSample, &w0);
-            csrRasterFindEdge(&rasterPoly.m_Vertex[2], &rasterPoly.m_Vertex[0], &pixelSample, &w1);
-            csrRasterFindEdge(&rasterPoly.m_Vertex[0], &rasterPoly.m_Vertex[1], &pixelSample, &w2);
-
-            pixelVisible = 0;
+    level = 0.0f;
 
-            // check if the pixel is visible. The culling mode is important to determine the sign
-            switch (cullingMode)
+    // iterate through the 2x2 pixel quads to draw, the first and last ones may be cut by the area
+    for (quadY = y0 & ~(size_t)1; quadY <= y1; quadY += 2)
+        for (quadX = x0 & ~(size_t)1; quadX <= x1; quadX += 2)
+        {
+            // select the texture mipmap level, once for each quad
+            if (pTexture)
             {
-                // clockwise
-                case 0:
-                    if (w0 >= 0 && w1 >= 0 && w2 >= 0)
-                        pixelVisible = 1;
-
-                    break;
-
-                // counter-clockwise
-                case 1:
-                    if (w0 <= 0 && w1 <= 0 && w2 <= 0)
-                    {
-                        pixelVisible = 1;
-
-                        // invert the sampler values
-                        w0 = -w0;
-                        w1 = -w1;
-                        w2 = -w2;
-                    }
-
-                    break;
-
-                // both
-                case 2:
-                    if (w0 >= 0 && w1 >= 0 && w2 >= 0)
-                        pixelVisible = 1;
-                    else
-                    if (w0 <= 0 && w1 <= 0 && w2 <= 0)
-                    {
-                        pixelVisible = 1;
-
-                        // invert the sampler values
-                        w0 = -w0;
-                        w1 = -w1;
-                        w2 = -w2;
-                    }
-
-                    break;
-
-                // error
-                default:
-                    return 0;
+                // get the texture coordinates on the quad top left, top right and bottom left pixels
+                csrRasterGetST(&rasterPoly, st, area, (float)quadX + 0.5f, (float)quadY + 0.5f, &quadST[0]);
+                csrRasterGetST(&rasterPoly, st, area, (float)quadX + 1.5f, (float)quadY + 0.5f, &quadST[1]);
+                csrRasterGetST(&rasterPoly, st, area, (float)quadX + 0.5f, (float)quadY + 1.5f, &quadST[2]);
+
+                // calculate the texture coordinate screen derivatives
+                dSTdx.m_X = quadST[1].m_X - quadST[0].m_X;
+                dSTdx.m_Y = quadST[1].m_Y - quadST[0].m_Y;
+                dSTdy.m_X = quadST[2].m_X - quadST[0].m_X;
+                dSTdy.m_Y = quadST[2].m_Y - quadST[0].m_Y;
+
+                level = csrRasterTextureGetLevel(pTexture, &dSTdx, &dSTdy);
             }
 
-            // is pixel visible?
-            if (pixelVisible)
-            {
-                // calculate the barycentric coordinates, which are the areas of the sub-triangles
-                // divided by the area of the main triangle
-                w0 /= area;
-                w1 /= area;
-                w2 /= area;
-
-                // calculate the pixel depth
-                invZ = (rasterPoly.m_Vertex[0].m_Z * w0) +
-                       (rasterPoly.m_Vertex[1].m_Z * w1) +
-                       (rasterPoly.m_Vertex[2].m_Z * w2);
-                z    = 1.0f / invZ;
-
-                // test the pixel against the depth buffer
-                if (z < pDB->m_pData[y * pFB->m_Width + x])
+            // iterate through the quad pixels to draw
+            for (y = quadY < y0 ? y0 : quadY; y <= quadY + 1 && y <= y1; ++y)
+                for (x = quadX < x0 ? x0 : quadX; x <= quadX + 1 && x <= x1; ++x)
                 {
-                    // test passed, update the depth buffer
-                    pDB->m_pData[y * pFB->m_Width + x] = z;
+                    pixelSample.m_X = x + 0.5f;
+                    pixelSample.m_Y = y + 0.5f;
+                    pixelSample.m_Z =     0.0f;
 
-                    // calculate the default pixel color, based on the per-vertex color
-                    color.m_R = w0 * pColor[0].m_R + w1 * pColor[1].m_R + w2 * pColor[2].m_R;
-                    color.m_G = w0 * pColor[0].m_G + w1 * pColor[1].m_G + w2 * pColor[2].m_G;
-                    color.m_B = w0 * pColor[0].m_B + w1 * pColor[1].m_B + w2 * pColor[2].m_B;
+                    // calculate the sub-triangle areas (multiplied by 2)
+                    csrRasterFindEdge(&rasterPoly.m_Vertex[1], &rasterPoly.m_Vertex[2], &pixelSample, &w0);
+                    csrRasterFindEdge(&rasterPoly.m_Vertex[2], &rasterPoly.m_Vertex[0], &pixelSample, &w1);
+                    csrRasterFindEdge(&rasterPoly.m_Vertex[0], &rasterPoly.m_Vertex[1], &pixelSample, &w2);
 
-                    // calculate the texture coordinate
-                    stCoord.m_X = ((st[0].m_X * w0) + (st[1].m_X * w1) + (st[2].m_X * w2)) * z;
-                    stCoord.m_Y = ((st[0].m_Y * w0) + (st[1].m_Y * w1) + (st[2].m_Y * w2)) * z;
+                    pixelVisible = 0;
 
-                    // for each pixel, apply the fragment shader
-                    if (fOnApplyFragmentShader)
+                    // check if the pixel is visible. The culling mode is important to determine the sign
+                    switch (cullingMode)
                     {
-                        // set the sampler items
-                        sampler.m_X = w0;
-                        sampler.m_Y = w1;
-                        sampler.m_Z = w2;
-
-                        fOnApplyFragmentShader(pMatrix,
-                                               pPolygon,
-                                               &stCoord,
-                                               &sampler,
-                                               z,
-                                               &color);
+                        // clockwise
+                        case 0:
+                            if (w0 >= 0 && w1 >= 0 && w2 >= 0)
+                                pixelVisible = 1;
+
+                            break;
+
+                        // counter-clockwise
+                        case 1:
+                            if (w0 <= 0 && w1 <= 0 && w2 <= 0)
+                            {
+                                pixelVisible = 1;
+
+                                // invert the sampler values
+                                w0 = -w0;
+                                w1 = -w1;
+                                w2 = -w2;
+                            }
+
+                            break;
+
+                        // both
+                        case 2:
+                            if (w0 >= 0 && w1 >= 0 && w2 >= 0)
+                                pixelVisible = 1;
+                            else
+                            if (w0 <= 0 && w1 <= 0 && w2 <= 0)
+                            {
+                                pixelVisible = 1;
+
+                                // invert the sampler values
+                                w0 = -w0;
+                                w1 = -w1;
+                                w2 = -w2;
+                            }
+
+                            break;
+
+                        // error
+                        default:
+                            return 0;
                     }
 
-                    // limit the color components between 0.0 and 1.0
-                    csrMathClamp(color.m_R, 0.0, 1.0, &color.m_R);
-                    csrMathClamp(color.m_G, 0.0, 1.0, &color.m_G);
-                    csrMathClamp(color.m_B, 0.0, 1.0, &color.m_B);
-
-                    // write the final pixel inside the frame buffer
-                    pFB->m_pPixel[y * pFB->m_Width + x].m_R = (unsigned char)(color.m_R * 255.0f);
-                    pFB->m_pPixel[y * pFB->m_Width + x].m_G = (unsigned char)(color.m_G * 255.0f);
-                    pFB->m_pPixel[y * pFB->m_Width + x].m_B = (unsigned char)(color.m_B * 255.0f);
-                    pFB->m_pPixel[y * pFB->m_Width + x].m_A = (unsigned char)(color.m_A * 255.0f);
+                    // is pixel visible?
+                    if (pixelVisible)
+                    {
+                        // calculate the barycentric coordinates, which are the areas of the sub-triangles
+                        // divided by the area of the main triangle
+                        w0 /= area;
+                        w1 /= area;
+                        w2 /= area;
+
+                        // calculate the pixel depth
+                        invZ = (rasterPoly.m_Vertex[0].m_Z * w0) +
+                               (rasterPoly.m_Vertex[1].m_Z * w1) +
+                               (rasterPoly.m_Vertex[2].m_Z * w2);
+                        z    = 1.0f / invZ;
+
+                        // test the pixel against the depth buffer
+                        if (z < pDB->m_pData[y * pFB->m_Width + x])
+                        {
+                            // test passed, update the depth buffer
+                            pDB->m_pData[y * pFB->m_Width + x] = z;
+
+                            // calculate the default pixel color, based on the per-vertex color
+                            color.m_R = w0 * pColor[0].m_R + w1 * pColor[1].m_R + w2 * pColor[2].m_R;
+                            color.m_G = w0 * pColor[0].m_G + w1 * pColor[1].m_G + w2 * pColor[2].m_G;
+                            color.m_B = w0 * pColor[0].m_B + w1 * pColor[1].m_B + w2 * pColor[2].m_B;
+
+                            // calculate the texture coordinate
+                            stCoord.m_X = ((st[0].m_X * w0) + (st[1].m_X * w1) + (st[2].m_X * w2)) * z;
+                            stCoord.m_Y = ((st[0].m_Y * w0) + (st[1].m_Y * w1) + (st[2].m_Y * w2)) * z;
+
+                            // sample the texture, if any
+                            if (pTexture)
+                                csrRasterTextureSample(pTexture, &stCoord, level, &color);
+
+                            // for each pixel, apply the fragment shader
+                            if (fOnApplyFragmentShader)
+                            {
+                                // set the sampler items
+                                sampler.m_X = w0;
+                                sampler.m_Y = w1;
+                                sampler.m_Z = w2;
+
+                                fOnApplyFragmentShader(pMatrix,
+                                                       pPolygon,
+                                                       &stCoord,
+                                                       &sampler,
+                                                       z,
+                                                       &color);
+                            }
+
+                            // limit the color components between 0.0 and 1.0
+                            csrMathClamp(color.m_R, 0.0, 1.0, &color.m_R);
+                            csrMathClamp(color.m_G, 0.0, 1.0, &color.m_G);
+                            csrMathClamp(color.m_B, 0.0, 1.0, &color.m_B);
+
+                            // write the final pixel inside the frame buffer
+                            pFB->m_pPixel[y * pFB->m_Width + x].m_R = (unsigned char)(color.m_R * 255.0f);
+                            pFB->m_pPixel[y * pFB->m_Width + x].m_G = (unsigned char)(color.m_G * 255.0f);
+                            pFB->m_pPixel[y * pFB->m_Width + x].m_B = (unsigned char)(color.m_B * 255.0f);
+                            pFB->m_pPixel[y * pFB->m_Width + x].m_A = (unsigned char)(color.m_A * 255.0f);
+                        }
+                    }
                 }
-            }
         }
 
     return 1;
@@ -848,6 +1422,7 @@ int csrRasterDraw(const CSR_Matrix4*               pMatrix,
                                            pVB->m_Culling.m_Type,
                                            pVB->m_Culling.m_Face,
                                           &screenRect,
+                                           pRaster->m_pTexture,
                                            pFB,
                                            pDB,
                                            fOnApplyFragmentShader))
@@ -909,6 +1484,7 @@ int csrRasterDraw(const CSR_Matrix4*               pMatrix,
                                            pVB->m_Culling.m_Type,
                                            pVB->m_Culling.m_Face,
                                           &screenRect,
+                                           pRaster->m_pTexture,
                                            pFB,
                                            pDB,
                                            fOnApplyFragmentShader))
@@ -951,6 +1527,7 @@ int csrRasterDraw(const CSR_Matrix4*               pMatrix,
                                            pVB->m_Culling.m_Type,
                                            pVB->m_Culling.m_Face,
                                           &screenRect,
+                                           pRaster->m_pTexture,
                                            pFB,
                                            pDB,
                                            fOnApplyFragmentShader))
@@ -997,6 +1574,7 @@ int csrRasterDraw(const CSR_Matrix4*               pMatrix,
                                            pVB->m_Culling.m_Type,
                                            pVB->m_Culling.m_Face,
                                           &screenRect,
+                                           pRaster->m_pTexture,
                                            pFB,
                                            pDB,
                                            fOnApplyFragmentShader))
@@ -1025,6 +1603,7 @@ int csrRasterDraw(const CSR_Matrix4*               pMatrix,
                                            pVB->m_Culling.m_Type,
                                            pVB->m_Culling.m_Face,
                                           &screenRect,
+                                           pRaster->m_pTexture,
                                            pFB,
                                            pDB,
                                            fOnApplyFragmentShader))
@@ -1074,6 +1653,7 @@ int csrRasterDraw(const CSR_Matrix4*               pMatrix,
                                            pVB->m_Culling.m_Type,
                                            pVB->m_Culling.m_Face,
                                           &screenRect,
+                                           pRaster->m_pTexture,
                                            pFB,
                                            pDB,
                                            fOnApplyFragmentShader))
@@ -1102,6 +1682,7 @@ int csrRasterDraw(const CSR_Matrix4*               pMatrix,
                                            pVB->m_Culling.m_Type,
                                            pVB->m_Culling.m_Face,
                                           &screenRect,
+                                           pRaster->m_pTexture,
                                            pFB,
                                            pDB,
                                            fOnApplyFragmentShader))
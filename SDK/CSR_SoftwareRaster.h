@@ -23,8 +23,15 @@
 // compactStart engine
 #include "CSR_Common.h"
 #include "CSR_Geometry.h"
+#include "CSR_Texture.h"
 #include "CSR_Vertex.h"
 
+//---------------------------------------------------------------------------
+// Global defines
+//---------------------------------------------------------------------------
+#define M_CSR_Raster_Tile_Shift 2                            // texture tile side, as a power of 2
+#define M_CSR_Raster_Tile_Size  (1 << M_CSR_Raster_Tile_Shift) // texture tile side, in texels
+
 //---------------------------------------------------------------------------
 // Enumerators
 //---------------------------------------------------------------------------
@@ -75,15 +82,38 @@ typedef struct
     size_t m_Size;
 } CSR_DepthBuffer;
 
+/**
+* Raster texture level
+*@note The texels are stored in square tiles of M_CSR_Raster_Tile_Size side, so the texels read by
+*      a bilinear fetch or by the neighbor pixels are generally close in memory
+*/
+typedef struct
+{
+    unsigned* m_pTexel;     // RGBA texels, packed in 32 bit with the red in the lowest byte
+    size_t    m_Width;
+    size_t    m_Height;
+    size_t    m_TileCountX;
+} CSR_RasterTextureLevel;
+
+/**
+* Raster texture, i.e. a texture with its mipmaps, prepared for the rasterizer sampling
+*/
+typedef struct
+{
+    CSR_RasterTextureLevel* m_pLevel; // from the full size image (level 0) to the 1x1 image
+    size_t                  m_Count;
+} CSR_RasterTexture;
+
 /**
 * Rasterizer options
 */
 typedef struct
 {
-    float           m_ApertureWidth;  // in inches
-    float           m_ApertureHeight; // in inches
-    float           m_FocalLength;    // in mm
-    CSR_ERasterType m_Type;
+    float                    m_ApertureWidth;  // in inches
+    float                    m_ApertureHeight; // in inches
+    float                    m_FocalLength;    // in mm
+    CSR_ERasterType          m_Type;
+    const CSR_RasterTexture* m_pTexture;       // texture sampled before the fragment shader, if 0 the sampling is left to the fragment shader
 } CSR_Raster;
 
 //---------------------------------------------------------------------------
@@ -159,6 +189,22 @@ typedef void (*CSR_fOnApplyFragmentShader)(const CSR_Matrix4*  pMatrix,
         */
         void csrFrameBufferClear(CSR_FrameBuffer* pFB, const CSR_Pixel* pPixel);
 
+        /**
+        * Applies an oil painting effect on a frame buffer
+        *@param pSrc - frame buffer on which the effect should be applied
+        *@param radius - effect radius, in pixels
+        *@param[out] pDst - frame buffer in which the result is written, may be the source one
+        *@return 1 on success, otherwise 0
+        *@note The effect is a Kuwahara filter, i.e. each pixel takes the mean color of the less
+        *      varying of its 4 neighbor quadrants of (radius + 1) x (radius + 1) pixels. The
+        *      quadrant statistics are read in summed-area tables, thus the cost doesn't depend on
+        *      the radius. The quadrants are cut on the frame buffer borders
+        *@note The destination frame buffer should have the same size as the source one
+        */
+        int csrFrameBufferOilPainting(const CSR_FrameBuffer* pSrc,
+                                            size_t           radius,
+                                            CSR_FrameBuffer* pDst);
+
         //-------------------------------------------------------------------
         // Depth buffer functions
         //-------------------------------------------------------------------
@@ -194,6 +240,54 @@ typedef void (*CSR_fOnApplyFragmentShader)(const CSR_Matrix4*  pMatrix,
         */
         void csrDepthBufferClear(CSR_DepthBuffer* pDB, float zFar);
 
+        //-------------------------------------------------------------------
+        // Raster texture functions
+        //-------------------------------------------------------------------
+
+        /**
+        * Creates a raster texture from a pixel buffer
+        *@param pPB - pixel buffer containing the texture
+        *@return newly created raster texture, 0 on error
+        *@note The mipmaps are generated, and the texels are reordered in tiles
+        *@note The raster texture must be released when no longer used, see csrRasterTextureRelease()
+        */
+        CSR_RasterTexture* csrRasterTextureCreate(const CSR_PixelBuffer* pPB);
+
+        /**
+        * Releases a raster texture
+        *@param[in, out] pTexture - raster texture to release
+        */
+        void csrRasterTextureRelease(CSR_RasterTexture* pTexture);
+
+        /**
+        * Initializes a raster texture structure
+        *@param[in, out] pTexture - raster texture to initialize
+        */
+        void csrRasterTextureInit(CSR_RasterTexture* pTexture);
+
+        /**
+        * Selects the mipmap level to sample, from the texture coordinate screen derivatives
+        *@param pTexture - raster texture
+        *@param pDSTdx - texture coordinate difference between a pixel and its right neighbor
+        *@param pDSTdy - texture coordinate difference between a pixel and its bottom neighbor
+        *@return the mipmap level, between 0.0 and the last level
+        */
+        float csrRasterTextureGetLevel(const CSR_RasterTexture* pTexture,
+                                       const CSR_Vector2*       pDSTdx,
+                                       const CSR_Vector2*       pDSTdy);
+
+        /**
+        * Samples a raster texture, using a bilinear filtering in the nearest mipmap level
+        *@param pTexture - raster texture to sample
+        *@param pST - texture coordinate, clamped between 0.0 and 1.0
+        *@param level - mipmap level to sample, see csrRasterTextureGetLevel()
+        *@param[out] pColor - sampled color
+        */
+        void csrRasterTextureSample(const CSR_RasterTexture* pTexture,
+                                    const CSR_Vector2*       pST,
+                                          float              level,
+                                          CSR_Color*         pColor);
+
         //-------------------------------------------------------------------
         // Raster functions
         //-------------------------------------------------------------------
@@ -302,10 +396,13 @@ typedef void (*CSR_fOnApplyFragmentShader)(const CSR_Matrix4*  pMatrix,
         *@param cullingType - culling type to apply
         *@param cullingFace - culling face to apply
         *@param pScreenRect - rect containing the screen coordinates
+        *@param pTexture - texture to sample, ignored if 0
         *@param[in, out] pFB - frame buffer in which the scene will be drawn
         *@param[in, out] pDB - depth buffer to use for depth checking
         *@param fOnApplyFragmentShader - fragment shader callback
         *@return 1 on success, otherwise 0
+        *@note If a texture is defined, the pixel color is replaced by the sampled texel before the
+        *      fragment shader is applied. The mipmap level is selected once per 2x2 pixel quad
         */
         int csrRasterDrawPolygon(const CSR_Polygon3*              pPolygon,
                                  const CSR_Vector3*               pNormal,
@@ -316,6 +413,7 @@ typedef void (*CSR_fOnApplyFragmentShader)(const CSR_Matrix4*  pMatrix,
                                        CSR_ECullingType           cullingType,
                                        CSR_ECullingFace           cullingFace,
                                  const CSR_Rect*                  pScreenRect,
+                                 const CSR_RasterTexture*         pTexture,
                                        CSR_FrameBuffer*           pFB,
                                        CSR_DepthBuffer*           pDB,
                                  const CSR_fOnApplyFragmentShader fOnApplyFragmentShader);
@@ -161,7 +161,7 @@ CSR_Sound* csrSoundOpenWavFile(const ALCdevice*  pOpenALDevice,
     CSR_Sound*  pSound;
 
     // open the sound file
-    pBuffer = csrFileOpen(pFileName);
+    pBuffer = csrFileMap(pFileName);
 
     // create the sound from the Wav file content
     pSound = csrSoundOpenWavBuffer(pOpenALDevice, pOpenALContext, pBuffer);
@@ -0,0 +1,1135 @@
+/****************************************************************************
+ * ==> CSR_SoundManager ----------------------------------------------------*
+ ****************************************************************************
+ * Description : This module provides a sound manager, which plays shared   *
+ *               sound buffers and streamed sounds on a bounded voice pool  *
+ * Developer   : Jean-Milost Reymond                                        *
+ * Copyright   : 2017 - 2022, this file is part of the CompactStar Engine.  *
+ *               You are free to copy or redistribute this file, modify it, *
+ *               or use it for your own projects, commercial or not. This   *
+ *               file is provided "as is", WITHOUT ANY WARRANTY OF ANY      *
+ *               KIND. THE DEVELOPER IS NOT RESPONSIBLE FOR ANY DAMAGE OF   *
+ *               ANY KIND, ANY LOSS OF DATA, OR ANY LOSS OF PRODUCTIVITY    *
+ *               TIME THAT MAY RESULT FROM THE USAGE OF THIS SOURCE CODE,   *
+ *               DIRECTLY OR NOT.                                           *
+ ****************************************************************************/
+
+#include "CSR_SoundManager.h"
+
+// std
+#include <stdlib.h>
+#include <string.h>
+
+//---------------------------------------------------------------------------
+// Private structures
+//---------------------------------------------------------------------------
+
+/**
+* Wav file info
+*/
+typedef struct
+{
+    ALenum   m_Format;
+    unsigned m_Sampling;
+    size_t   m_DataOffset;
+    size_t   m_DataLength;
+} CSR_SoundWavInfo;
+
+//---------------------------------------------------------------------------
+// Wav private functions
+//---------------------------------------------------------------------------
+unsigned csrSoundWavReadValue(const unsigned char* pData, size_t count)
+{
+    unsigned value = 0;
+
+    // the wav values are little endian
+    while (count)
+    {
+        --count;
+        value = (value << 8) | pData[count];
+    }
+
+    return value;
+}
+//---------------------------------------------------------------------------
+int csrSoundWavReadFormat(const unsigned char* pData, CSR_SoundWavInfo* pInfo)
+{
+    const unsigned audioFormat = csrSoundWavReadValue(pData,      2);
+    const unsigned channels    = csrSoundWavReadValue(pData + 2,  2);
+    const unsigned bits        = csrSoundWavReadValue(pData + 14, 2);
+
+    // only the PCM data may be played by OpenAL
+    if (audioFormat != 1)
+        return 0;
+
+    pInfo->m_Sampling = csrSoundWavReadValue(pData + 4, 4);
+
+    if (channels == 1 && bits == 8)
+        pInfo->m_Format = AL_FORMAT_MONO8;
+    else
+    if (channels == 1 && bits == 16)
+        pInfo->m_Format = AL_FORMAT_MONO16;
+    else
+    if (channels == 2 && bits == 8)
+        pInfo->m_Format = AL_FORMAT_STEREO8;
+    else
+    if (channels == 2 && bits == 16)
+        pInfo->m_Format = AL_FORMAT_STEREO16;
+    else
+        return 0;
+
+    return 1;
+}
+//---------------------------------------------------------------------------
+int csrSoundWavParseBuffer(const CSR_Buffer* pBuffer, CSR_SoundWavInfo* pInfo)
+{
+    const unsigned char* pData = (const unsigned char*)pBuffer->m_pData;
+    size_t               offset;
+    size_t               chunkLength;
+    int                  formatFound = 0;
+
+    // check the RIFF and WAVE signatures
+    if (pBuffer->m_Length < 12 || memcmp(pData, "RIFF", 4) || memcmp(pData + 8, "WAVE", 4))
+        return 0;
+
+    offset = 12;
+
+    // iterate through the chunks until the data one
+    while (offset + 8 <= pBuffer->m_Length)
+    {
+        chunkLength  = csrSoundWavReadValue(pData + offset + 4, 4);
+        offset      += 8;
+
+        if (!memcmp(pData + offset - 8, "fmt ", 4))
+        {
+            if (chunkLength < 16 || offset + 16 > pBuffer->m_Length)
+                return 0;
+
+            if (!csrSoundWavReadFormat(pData + offset, pInfo))
+                return 0;
+
+            formatFound = 1;
+        }
+        else
+        if (!memcmp(pData + offset - 8, "data", 4))
+        {
+            if (!formatFound)
+                return 0;
+
+            // a truncated file is played until its end
+            if (chunkLength > pBuffer->m_Length - offset)
+                chunkLength = pBuffer->m_Length - offset;
+
+            pInfo->m_DataOffset = offset;
+            pInfo->m_DataLength = chunkLength;
+            return 1;
+        }
+
+        // the chunk exceeds the buffer?
+        if (chunkLength > pBuffer->m_Length - offset)
+            return 0;
+
+        // skip the chunk, NOTE the chunks are aligned on 2 bytes
+        offset += chunkLength + (chunkLength & 1);
+    }
+
+    return 0;
+}
+//---------------------------------------------------------------------------
+int csrSoundWavParseFile(FILE* pFile, CSR_SoundWavInfo* pInfo)
+{
+    unsigned char header[16];
+    size_t        chunkLength;
+    long          position;
+    long          fileLength;
+    int           formatFound = 0;
+
+    // get the file length, the chunks shouldn't exceed it
+    position = ftell(pFile);
+
+    if (position < 0 || fseek(pFile, 0, SEEK_END))
+        return 0;
+
+    fileLength = ftell(pFile);
+
+    if (fileLength < 0 || fseek(pFile, position, SEEK_SET))
+        return 0;
+
+    // check the RIFF and WAVE signatures
+    if (fread(header, 1, 12, pFile) != 12 || memcmp(header, "RIFF", 4) || memcmp(header + 8, "WAVE", 4))
+        return 0;
+
+    // iterate through the chunks until the data one
+    while (fread(header, 1, 8, pFile) == 8)
+    {
+        chunkLength = csrSoundWavReadValue(header + 4, 4);
+
+        if (!memcmp(header, "fmt ", 4))
+        {
+            if (chunkLength < 16 || fread(header, 1, 16, pFile) != 16)
+                return 0;
+
+            if (!csrSoundWavReadFormat(header, pInfo))
+                return 0;
+
+            formatFound  = 1;
+            chunkLength -= 16;
+        }
+        else
+        if (!memcmp(header, "data", 4))
+        {
+            if (!formatFound)
+                return 0;
+
+            pInfo->m_DataOffset = (size_t)ftell(pFile);
+            pInfo->m_DataLength = chunkLength;
+            return 1;
+        }
+
+        position = ftell(pFile);
+
+        // the chunk exceeds the file?
+        if (position < 0 || chunkLength > (size_t)(fileLength - position))
+            return 0;
+
+        // skip the chunk, NOTE the chunks are aligned on 2 bytes
+        if (fseek(pFile, (long)(chunkLength + (chunkLength & 1)), SEEK_CUR))
+            return 0;
+    }
+
+    return 0;
+}
+//---------------------------------------------------------------------------
+// Sound stream private functions
+//---------------------------------------------------------------------------
+size_t csrSoundStreamRead(CSR_SoundStream* pStream, void* pData, size_t length)
+{
+    size_t read;
+
+    // custom decoder?
+    if (pStream->m_fOnDecode)
+        return pStream->m_fOnDecode(pStream->m_pDecodeArg, pData, length);
+
+    // no wav file?
+    if (!pStream->m_pFile)
+        return 0;
+
+    // read the next wav data
+    if (length > pStream->m_DataLength - pStream->m_DataPos)
+        length = pStream->m_DataLength - pStream->m_DataPos;
+
+    if (!length)
+        return 0;
+
+    if (fseek(pStream->m_pFile, (long)(pStream->m_DataOffset + pStream->m_DataPos), SEEK_SET))
+        return 0;
+
+    read                = fread(pData, 1, length, pStream->m_pFile);
+    pStream->m_DataPos += read;
+
+    return read;
+}
+//---------------------------------------------------------------------------
+int csrSoundStreamRewind(CSR_SoundStream* pStream)
+{
+    // custom decoder?
+    if (pStream->m_fOnDecode)
+        return pStream->m_fOnRewind ? pStream->m_fOnRewind(pStream->m_pDecodeArg) : 0;
+
+    pStream->m_DataPos = 0;
+    return 1;
+}
+//---------------------------------------------------------------------------
+void csrSoundStreamOnDecode(void* pArg)
+{
+    CSR_SoundStream* pStream = (CSR_SoundStream*)pArg;
+    size_t           length  = 0;
+    size_t           read;
+    int              rewound = 0;
+
+    // fill the block
+    while (length < M_CSR_Sound_Stream_Buffer_Length)
+    {
+        read = csrSoundStreamRead(pStream, pStream->m_pBlock + length, M_CSR_Sound_Stream_Buffer_Length - length);
+
+        if (read)
+        {
+            length  += read;
+            rewound  = 0;
+            continue;
+        }
+
+        // restart the looped stream. NOTE an empty stream should not be restarted endlessly
+        if (pStream->m_Loop && !rewound && csrSoundStreamRewind(pStream))
+        {
+            rewound = 1;
+            continue;
+        }
+
+        pStream->m_End = 1;
+        break;
+    }
+
+    pStream->m_BlockLength = length;
+}
+//---------------------------------------------------------------------------
+void csrSoundStreamDecodeNext(CSR_SoundStream* pStream, CSR_JobPool* pPool)
+{
+    // nothing left to decode?
+    if (pStream->m_End)
+    {
+        pStream->m_BlockLength = 0;
+        return;
+    }
+
+    pStream->m_pPool = pPool;
+    pStream->m_Busy  = 1;
+
+    csrJobInit(&pStream->m_Job, csrSoundStreamOnDecode, pStream);
+
+    // decode the next block while the previous ones are played
+    if (!csrJobPoolAdd(pPool, &pStream->m_Job))
+    {
+        csrSoundStreamOnDecode(pStream);
+        pStream->m_Busy = 0;
+    }
+}
+//---------------------------------------------------------------------------
+int csrSoundStreamIsReady(CSR_SoundStream* pStream)
+{
+    if (pStream->m_Busy && csrJobPoolGetState(pStream->m_pPool, &pStream->m_Job) == CSR_JS_Done)
+        pStream->m_Busy = 0;
+
+    return !pStream->m_Busy;
+}
+//---------------------------------------------------------------------------
+void csrSoundStreamWait(CSR_SoundStream* pStream)
+{
+    if (!pStream->m_Busy)
+        return;
+
+    csrJobPoolWait(pStream->m_pPool, &pStream->m_Job);
+    pStream->m_Busy = 0;
+}
+//---------------------------------------------------------------------------
+// Sound manager private functions
+//---------------------------------------------------------------------------
+float csrSoundManagerGetAudibility(const CSR_SoundManager* pManager,
+                                   const CSR_Vector3*      pPos,
+                                         int               relative,
+                                         float             gain)
+{
+    CSR_Vector3 delta;
+    float       distance;
+
+    // calculate the distance between the sound and the listener
+    if (relative)
+        delta = *pPos;
+    else
+        csrVec3Sub(pPos, &pManager->m_ListenerPos, &delta);
+
+    csrVec3Length(&delta, &distance);
+
+    // the gain decreases with the distance, as with the default OpenAL distance model
+    return distance > 1.0f ? gain / distance : gain;
+}
+//---------------------------------------------------------------------------
+void csrSoundManagerApplyVoice(const CSR_SoundVoice* pVoice)
+{
+    #ifdef _MSC_VER
+        ALfloat position[3] = {0};
+    #else
+        ALfloat position[3];
+    #endif
+
+    position[0] = pVoice->m_Position.m_X;
+    position[1] = pVoice->m_Position.m_Y;
+    position[2] = pVoice->m_Position.m_Z;
+
+    alSourcef (pVoice->m_ID, AL_GAIN,            pVoice->m_Gain);
+    alSourcei (pVoice->m_ID, AL_SOURCE_RELATIVE, pVoice->m_Relative ? AL_TRUE : AL_FALSE);
+    alSourcefv(pVoice->m_ID, AL_POSITION,        position);
+}
+//---------------------------------------------------------------------------
+void csrSoundManagerStopVoice(CSR_SoundVoice* pVoice)
+{
+    // stop the voice and detach its buffers
+    alSourceStop(pVoice->m_ID);
+    alSourcei(pVoice->m_ID, AL_BUFFER, 0);
+
+    // release the stream, once its current block is decoded
+    if (pVoice->m_pStream)
+    {
+        csrSoundStreamWait(pVoice->m_pStream);
+        pVoice->m_pStream->m_Attached = 0;
+    }
+
+    pVoice->m_pBuffer = 0;
+    pVoice->m_pStream = 0;
+    pVoice->m_Handle  = 0;
+}
+//---------------------------------------------------------------------------
+int csrSoundManagerIsVoiceEnded(const CSR_SoundVoice* pVoice)
+{
+    ALint state;
+
+    // a stream may be stopped while waiting for its next block
+    if (!pVoice->m_pBuffer)
+        return 0;
+
+    alGetSourcei(pVoice->m_ID, AL_SOURCE_STATE, &state);
+
+    return state == AL_STOPPED;
+}
+//---------------------------------------------------------------------------
+CSR_SoundVoice* csrSoundManagerGetVoice(CSR_SoundManager* pManager, int priority, float audibility)
+{
+    CSR_SoundVoice* pCandidate          = 0;
+    float           candidateAudibility = 0.0f;
+    float           voiceAudibility;
+    size_t          i;
+
+    for (i = 0; i < pManager->m_VoiceCount; ++i)
+    {
+        CSR_SoundVoice* pVoice = &pManager->m_pVoice[i];
+
+        // free voice, or voice whose sound ended?
+        if (!pVoice->m_Handle || csrSoundManagerIsVoiceEnded(pVoice))
+        {
+            if (pVoice->m_Handle)
+                csrSoundManagerStopVoice(pVoice);
+
+            return pVoice;
+        }
+
+        voiceAudibility = csrSoundManagerGetAudibility(pManager,
+                                                      &pVoice->m_Position,
+                                                       pVoice->m_Relative,
+                                                       pVoice->m_Gain);
+
+        // search for the least important voice
+        if (!pCandidate                                    ||
+             pVoice->m_Priority < pCandidate->m_Priority   ||
+            (pVoice->m_Priority == pCandidate->m_Priority && voiceAudibility < candidateAudibility))
+        {
+            pCandidate          = pVoice;
+            candidateAudibility = voiceAudibility;
+        }
+    }
+
+    // no voice, or all the voices are more important than the new sound?
+    if (!pCandidate                                                                 ||
+         priority < pCandidate->m_Priority                                          ||
+        (priority == pCandidate->m_Priority && audibility <= candidateAudibility))
+        return 0;
+
+    // steal the voice
+    csrSoundManagerStopVoice(pCandidate);
+
+    return pCandidate;
+}
+//---------------------------------------------------------------------------
+void csrSoundManagerStartVoice(CSR_SoundManager* pManager,
+                               CSR_SoundVoice*   pVoice,
+                         const CSR_Vector3*      pPos,
+                               float             gain,
+                               int               priority)
+{
+    if (pPos)
+    {
+        pVoice->m_Position = *pPos;
+        pVoice->m_Relative = 0;
+    }
+    else
+    {
+        pVoice->m_Position.m_X = 0.0f;
+        pVoice->m_Position.m_Y = 0.0f;
+        pVoice->m_Position.m_Z = 0.0f;
+        pVoice->m_Relative     = 1;
+    }
+
+    pVoice->m_Gain     = gain;
+    pVoice->m_Priority = priority;
+
+    // get a new handle, NOTE 0 is reserved for the free voices
+    ++pManager->m_LastHandle;
+
+    if (!pManager->m_LastHandle)
+        ++pManager->m_LastHandle;
+
+    pVoice->m_Handle = pManager->m_LastHandle;
+
+    csrSoundManagerApplyVoice(pVoice);
+}
+//---------------------------------------------------------------------------
+CSR_SoundVoice* csrSoundManagerFindVoice(const CSR_SoundManager* pManager, unsigned handle)
+{
+    size_t i;
+
+    if (!pManager || !handle)
+        return 0;
+
+    for (i = 0; i < pManager->m_VoiceCount; ++i)
+        if (pManager->m_pVoice[i].m_Handle == handle)
+            return &pManager->m_pVoice[i];
+
+    return 0;
+}
+//---------------------------------------------------------------------------
+void csrSoundManagerFeedStream(CSR_SoundManager* pManager, CSR_SoundVoice* pVoice)
+{
+    CSR_SoundStream* pStream = pVoice->m_pStream;
+    ALint            processed;
+    ALint            queued;
+    ALint            state;
+    ALuint           bufferID;
+
+    alGetSourcei(pVoice->m_ID, AL_BUFFERS_PROCESSED, &processed);
+
+    // replace the played buffers by the decoded blocks
+    while (processed > 0 && csrSoundStreamIsReady(pStream) && pStream->m_BlockLength)
+    {
+        alSourceUnqueueBuffers(pVoice->m_ID, 1, &bufferID);
+        alBufferData(bufferID,
+                     pStream->m_Format,
+                     pStream->m_pBlock,
+                     (ALsizei)pStream->m_BlockLength,
+                     (ALsizei)pStream->m_Sampling);
+        alSourceQueueBuffers(pVoice->m_ID, 1, &bufferID);
+
+        --processed;
+
+        csrSoundStreamDecodeNext(pStream, pManager->m_pPool);
+    }
+
+    alGetSourcei(pVoice->m_ID, AL_SOURCE_STATE, &state);
+
+    if (state != AL_STOPPED)
+        return;
+
+    alGetSourcei(pVoice->m_ID, AL_BUFFERS_QUEUED,    &queued);
+    alGetSourcei(pVoice->m_ID, AL_BUFFERS_PROCESSED, &processed);
+
+    // the source played all its buffers before the next block was decoded, restart it
+    if (queued > processed)
+    {
+        alSourcePlay(pVoice->m_ID);
+        return;
+    }
+
+    // whole stream played?
+    if (csrSoundStreamIsReady(pStream) && !pStream->m_BlockLength)
+        csrSoundManagerStopVoice(pVoice);
+}
+//---------------------------------------------------------------------------
+// Sound buffer functions
+//---------------------------------------------------------------------------
+CSR_SoundBuffer* csrSoundBufferCreate(const CSR_Buffer* pBuffer, ALenum format, unsigned sampling)
+{
+    CSR_SoundBuffer* pSoundBuffer;
+
+    // no sound data?
+    if (!pBuffer || !pBuffer->m_pData || !pBuffer->m_Length)
+        return 0;
+
+    // create a new sound buffer
+    pSoundBuffer = (CSR_SoundBuffer*)malloc(sizeof(CSR_SoundBuffer));
+
+    // succeeded?
+    if (!pSoundBuffer)
+        return 0;
+
+    csrSoundBufferInit(pSoundBuffer);
+
+    // clear the previous errors
+    alGetError();
+
+    // grab a buffer ID from openAL
+    alGenBuffers(1, &pSoundBuffer->m_ID);
+
+    // succeeded?
+    if (alGetError() != AL_NO_ERROR)
+    {
+        pSoundBuffer->m_ID = M_OPENAL_ERROR_ID;
+        csrSoundBufferRelease(pSoundBuffer);
+        return 0;
+    }
+
+    // upload the sound data, which may then be shared by several voices
+    alBufferData(pSoundBuffer->m_ID, format, pBuffer->m_pData, (ALsizei)pBuffer->m_Length, (ALsizei)sampling);
+
+    // succeeded?
+    if (alGetError() != AL_NO_ERROR)
+    {
+        csrSoundBufferRelease(pSoundBuffer);
+        return 0;
+    }
+
+    pSoundBuffer->m_Format   = format;
+    pSoundBuffer->m_Sampling = sampling;
+
+    return pSoundBuffer;
+}
+//---------------------------------------------------------------------------
+void csrSoundBufferRelease(CSR_SoundBuffer* pSoundBuffer)
+{
+    // no sound buffer to release?
+    if (!pSoundBuffer)
+        return;
+
+    // delete the buffer
+    if (pSoundBuffer->m_ID != M_OPENAL_ERROR_ID)
+        alDeleteBuffers(1, &pSoundBuffer->m_ID);
+
+    // free the sound buffer
+    free(pSoundBuffer);
+}
+//---------------------------------------------------------------------------
+void csrSoundBufferInit(CSR_SoundBuffer* pSoundBuffer)
+{
+    // no sound buffer to initialize?
+    if (!pSoundBuffer)
+        return;
+
+    // initialize the sound buffer content
+    pSoundBuffer->m_ID       = M_OPENAL_ERROR_ID;
+    pSoundBuffer->m_Format   = AL_FORMAT_STEREO16;
+    pSoundBuffer->m_Sampling = 0;
+}
+//---------------------------------------------------------------------------
+CSR_SoundBuffer* csrSoundBufferOpenWavFile(const char* pFileName)
+{
+    CSR_Buffer*      pBuffer;
+    CSR_SoundBuffer* pSoundBuffer;
+
+    // open the sound file
+    pBuffer = csrFileMap(pFileName);
+
+    // create the sound buffer from the wav file content
+    pSoundBuffer = csrSoundBufferOpenWavBuffer(pBuffer);
+
+    // release the file buffer (no longer required)
+    csrBufferRelease(pBuffer);
+
+    return pSoundBuffer;
+}
+//---------------------------------------------------------------------------
+CSR_SoundBuffer* csrSoundBufferOpenWavBuffer(const CSR_Buffer* pBuffer)
+{
+    CSR_Buffer       dataBuffer;
+    CSR_SoundWavInfo info;
+
+    // no buffer?
+    if (!pBuffer || !pBuffer->m_pData)
+        return 0;
+
+    // read the wav header
+    if (!csrSoundWavParseBuffer(pBuffer, &info))
+        return 0;
+
+    // populate a pseudo-buffer to read the sound data
+    dataBuffer.m_pData  = ((unsigned char*)pBuffer->m_pData) + info.m_DataOffset;
+    dataBuffer.m_Length = info.m_DataLength;
+
+    return csrSoundBufferCreate(&dataBuffer, info.m_Format, info.m_Sampling);
+}
+//---------------------------------------------------------------------------
+// Sound stream functions
+//---------------------------------------------------------------------------
+CSR_SoundStream* csrSoundStreamCreate(CSR_fOnDecodeSoundStream fOnDecode,
+                                      CSR_fOnRewindSoundStream fOnRewind,
+                                      void*                    pDecodeArg,
+                                      ALenum                   format,
+                                      unsigned                 sampling)
+{
+    CSR_SoundStream* pStream;
+
+    // create a new sound stream
+    pStream = (CSR_SoundStream*)malloc(sizeof(CSR_SoundStream));
+
+    // succeeded?
+    if (!pStream)
+        return 0;
+
+    csrSoundStreamInit(pStream);
+
+    pStream->m_fOnDecode  = fOnDecode;
+    pStream->m_fOnRewind  = fOnRewind;
+    pStream->m_pDecodeArg = pDecodeArg;
+    pStream->m_Format     = format;
+    pStream->m_Sampling   = sampling;
+
+    // create the block to decode
+    pStream->m_pBlock = (unsigned char*)malloc(M_CSR_Sound_Stream_Buffer_Length);
+
+    // succeeded?
+    if (!pStream->m_pBlock)
+    {
+        csrSoundStreamRelease(pStream);
+        return 0;
+    }
+
+    // clear the previous errors
+    alGetError();
+
+    // grab the buffer IDs to queue from openAL
+    alGenBuffers(M_CSR_Sound_Stream_Buffer_Count, pStream->m_BufferID);
+
+    // succeeded?
+    if (alGetError() != AL_NO_ERROR)
+    {
+        pStream->m_BufferID[0] = M_OPENAL_ERROR_ID;
+        csrSoundStreamRelease(pStream);
+        return 0;
+    }
+
+    return pStream;
+}
+//---------------------------------------------------------------------------
+void csrSoundStreamRelease(CSR_SoundStream* pStream)
+{
+    // no sound stream to release?
+    if (!pStream)
+        return;
+
+    // wait until the current block is decoded
+    csrSoundStreamWait(pStream);
+
+    // delete the buffers
+    if (pStream->m_BufferID[0] != M_OPENAL_ERROR_ID)
+        alDeleteBuffers(M_CSR_Sound_Stream_Buffer_Count, pStream->m_BufferID);
+
+    // close the wav file
+    if (pStream->m_pFile)
+        fclose(pStream->m_pFile);
+
+    // free the block
+    free(pStream->m_pBlock);
+
+    // free the sound stream
+    free(pStream);
+}
+//---------------------------------------------------------------------------
+void csrSoundStreamInit(CSR_SoundStream* pStream)
+{
+    size_t i;
+
+    // no sound stream to initialize?
+    if (!pStream)
+        return;
+
+    // initialize the sound stream content
+    pStream->m_fOnDecode   = 0;
+    pStream->m_fOnRewind   = 0;
+    pStream->m_pDecodeArg  = 0;
+    pStream->m_pFile       = 0;
+    pStream->m_DataOffset  = 0;
+    pStream->m_DataLength  = 0;
+    pStream->m_DataPos     = 0;
+    pStream->m_Format      = AL_FORMAT_STEREO16;
+    pStream->m_Sampling    = 0;
+    pStream->m_pBlock      = 0;
+    pStream->m_BlockLength = 0;
+    pStream->m_pPool       = 0;
+    pStream->m_Busy        = 0;
+    pStream->m_Loop        = 0;
+    pStream->m_End         = 0;
+    pStream->m_Attached    = 0;
+
+    for (i = 0; i < M_CSR_Sound_Stream_Buffer_Count; ++i)
+        pStream->m_BufferID[i] = M_OPENAL_ERROR_ID;
+
+    csrJobInit(&pStream->m_Job, 0, 0);
+}
+//---------------------------------------------------------------------------
+CSR_SoundStream* csrSoundStreamOpenWavFile(const char* pFileName)
+{
+    FILE*            pFile;
+    CSR_SoundStream* pStream;
+    CSR_SoundWavInfo info;
+
+    // open the wav file
+    #ifdef _MSC_VER
+        fopen_s(&pFile, pFileName, "rb");
+    #else
+        pFile = fopen(pFileName, "rb");
+    #endif
+
+    // succeeded?
+    if (!pFile)
+        return 0;
+
+    // read the wav header, the data will be read while the stream is played
+    if (!csrSoundWavParseFile(pFile, &info))
+    {
+        fclose(pFile);
+        return 0;
+    }
+
+    pStream = csrSoundStreamCreate(0, 0, 0, info.m_Format, info.m_Sampling);
+
+    // succeeded?
+    if (!pStream)
+    {
+        fclose(pFile);
+        return 0;
+    }
+
+    pStream->m_pFile      = pFile;
+    pStream->m_DataOffset = info.m_DataOffset;
+    pStream->m_DataLength = info.m_DataLength;
+
+    return pStream;
+}
+//---------------------------------------------------------------------------
+// Sound manager functions
+//---------------------------------------------------------------------------
+CSR_SoundManager* csrSoundManagerCreate(size_t voiceCount, CSR_JobPool* pPool)
+{
+    CSR_SoundManager* pManager;
+
+    if (!voiceCount)
+        voiceCount = M_CSR_Sound_Default_Voice_Count;
+
+    // create a new sound manager
+    pManager = (CSR_SoundManager*)malloc(sizeof(CSR_SoundManager));
+
+    // succeeded?
+    if (!pManager)
+        return 0;
+
+    csrSoundManagerInit(pManager);
+
+    pManager->m_pPool  = pPool;
+    pManager->m_pVoice = (CSR_SoundVoice*)malloc(voiceCount * sizeof(CSR_SoundVoice));
+
+    // succeeded?
+    if (!pManager->m_pVoice)
+    {
+        csrSoundManagerRelease(pManager);
+        return 0;
+    }
+
+    // clear the previous errors
+    alGetError();
+
+    // create the voices, until the device has no more sources
+    while (pManager->m_VoiceCount < voiceCount)
+    {
+        CSR_SoundVoice* pVoice = &pManager->m_pVoice[pManager->m_VoiceCount];
+
+        alGenSources(1, &pVoice->m_ID);
+
+        // succeeded?
+        if (alGetError() != AL_NO_ERROR)
+            break;
+
+        pVoice->m_pBuffer      = 0;
+        pVoice->m_pStream      = 0;
+        pVoice->m_Position.m_X = 0.0f;
+        pVoice->m_Position.m_Y = 0.0f;
+        pVoice->m_Position.m_Z = 0.0f;
+        pVoice->m_Gain         = 1.0f;
+        pVoice->m_Priority     = 0;
+        pVoice->m_Relative     = 0;
+        pVoice->m_Handle       = 0;
+
+        alSourcef(pVoice->m_ID, AL_PITCH, 1.0f);
+
+        ++pManager->m_VoiceCount;
+    }
+
+    // no voice could be created?
+    if (!pManager->m_VoiceCount)
+    {
+        csrSoundManagerRelease(pManager);
+        return 0;
+    }
+
+    return pManager;
+}
+//---------------------------------------------------------------------------
+void csrSoundManagerRelease(CSR_SoundManager* pManager)
+{
+    size_t i;
+
+    // no sound manager to release?
+    if (!pManager)
+        return;
+
+    // stop the sounds, and release the streams
+    csrSoundManagerStopAll(pManager);
+
+    // delete the sources
+    for (i = 0; i < pManager->m_VoiceCount; ++i)
+        alDeleteSources(1, &pManager->m_pVoice[i].m_ID);
+
+    // free the voices
+    free(pManager->m_pVoice);
+
+    // free the sound manager
+    free(pManager);
+}
+//---------------------------------------------------------------------------
+void csrSoundManagerInit(CSR_SoundManager* pManager)
+{
+    // no sound manager to initialize?
+    if (!pManager)
+        return;
+
+    // initialize the sound manager content
+    pManager->m_pVoice          = 0;
+    pManager->m_VoiceCount      = 0;
+    pManager->m_ListenerPos.m_X = 0.0f;
+    pManager->m_ListenerPos.m_Y = 0.0f;
+    pManager->m_ListenerPos.m_Z = 0.0f;
+    pManager->m_pPool           = 0;
+    pManager->m_LastHandle      = 0;
+}
+//---------------------------------------------------------------------------
+void csrSoundManagerSetListener(CSR_SoundManager* pManager, const CSR_Vector3* pPos)
+{
+    #ifdef _MSC_VER
+        ALfloat position[3] = {0};
+    #else
+        ALfloat position[3];
+    #endif
+
+    if (!pManager || !pPos)
+        return;
+
+    pManager->m_ListenerPos = *pPos;
+
+    position[0] = pPos->m_X;
+    position[1] = pPos->m_Y;
+    position[2] = pPos->m_Z;
+
+    alListenerfv(AL_POSITION, position);
+}
+//---------------------------------------------------------------------------
+unsigned csrSoundManagerPlay(      CSR_SoundManager* pManager,
+                             const CSR_SoundBuffer*  pSoundBuffer,
+                             const CSR_Vector3*      pPos,
+                                   float             gain,
+                                   int               priority,
+                                   int               loop)
+{
+    #ifdef _MSC_VER
+        const CSR_Vector3 origin = {0};
+    #else
+        const CSR_Vector3 origin = {0.0f, 0.0f, 0.0f};
+    #endif
+    CSR_SoundVoice* pVoice;
+
+    if (!pManager || !pSoundBuffer || pSoundBuffer->m_ID == M_OPENAL_ERROR_ID)
+        return 0;
+
+    // get a voice to play the sound
+    pVoice = csrSoundManagerGetVoice(pManager,
+                                     priority,
+                                     csrSoundManagerGetAudibility(pManager,
+                                                                  pPos ? pPos : &origin,
+                                                                  !pPos,
+                                                                  gain));
+
+    // no voice available?
+    if (!pVoice)
+        return 0;
+
+    // clear the previous errors
+    alGetError();
+
+    // attach the shared buffer to the voice
+    alSourcei(pVoice->m_ID, AL_BUFFER,  (ALint)pSoundBuffer->m_ID);
+    alSourcei(pVoice->m_ID, AL_LOOPING, loop ? AL_TRUE : AL_FALSE);
+
+    csrSoundManagerStartVoice(pManager, pVoice, pPos, gain, priority);
+    pVoice->m_pBuffer = pSoundBuffer;
+
+    alSourcePlay(pVoice->m_ID);
+
+    // succeeded?
+    if (alGetError() != AL_NO_ERROR)
+    {
+        csrSoundManagerStopVoice(pVoice);
+        return 0;
+    }
+
+    return pVoice->m_Handle;
+}
+//---------------------------------------------------------------------------
+unsigned csrSoundManagerPlayStream(      CSR_SoundManager* pManager,
+                                         CSR_SoundStream*  pStream,
+                                   const CSR_Vector3*      pPos,
+                                         float             gain,
+                                         int               priority,
+                                         int               loop)
+{
+    #ifdef _MSC_VER
+        const CSR_Vector3 origin = {0};
+    #else
+        const CSR_Vector3 origin = {0.0f, 0.0f, 0.0f};
+    #endif
+    CSR_SoundVoice* pVoice;
+    size_t          i;
+    size_t          queued;
+
+    if (!pManager || !pStream || !pStream->m_pBlock || pStream->m_Attached)
+        return 0;
+
+    if (pStream->m_BufferID[0] == M_OPENAL_ERROR_ID)
+        return 0;
+
+    // get a voice to play the stream
+    pVoice = csrSoundManagerGetVoice(pManager,
+                                     priority,
+                                     csrSoundManagerGetAudibility(pManager,
+                                                                  pPos ? pPos : &origin,
+                                                                  !pPos,
+                                                                  gain));
+
+    // no voice available?
+    if (!pVoice)
+        return 0;
+
+    // restart the stream. NOTE a custom stream without rewind function continues where it stopped
+    csrSoundStreamWait(pStream);
+    csrSoundStreamRewind(pStream);
+
+    pStream->m_Loop        = loop;
+    pStream->m_End         = 0;
+    pStream->m_BlockLength = 0;
+
+    // clear the previous errors
+    alGetError();
+
+    // the stream loops itself, thus the source should not
+    alSourcei(pVoice->m_ID, AL_BUFFER,  0);
+    alSourcei(pVoice->m_ID, AL_LOOPING, AL_FALSE);
+
+    queued = 0;
+
+    // decode and queue the first blocks in the calling thread, so the sound starts immediately
+    for (i = 0; i < M_CSR_Sound_Stream_Buffer_Count; ++i)
+    {
+        csrSoundStreamOnDecode(pStream);
+
+        // stream end reached?
+        if (!pStream->m_BlockLength)
+            break;
+
+        alBufferData(pStream->m_BufferID[i],
+                     pStream->m_Format,
+                     pStream->m_pBlock,
+                     (ALsizei)pStream->m_BlockLength,
+                     (ALsizei)pStream->m_Sampling);
+        alSourceQueueBuffers(pVoice->m_ID, 1, &pStream->m_BufferID[i]);
+        ++queued;
+
+        if (pStream->m_End)
+        {
+            pStream->m_BlockLength = 0;
+            break;
+        }
+    }
+
+    // nothing to play?
+    if (!queued)
+    {
+        alSourcei(pVoice->m_ID, AL_BUFFER, 0);
+        return 0;
+    }
+
+    csrSoundManagerStartVoice(pManager, pVoice, pPos, gain, priority);
+    pVoice->m_pStream   = pStream;
+    pStream->m_Attached = 1;
+
+    // decode the next block while the first ones are played
+    csrSoundStreamDecodeNext(pStream, pManager->m_pPool);
+
+    alSourcePlay(pVoice->m_ID);
+
+    // succeeded?
+    if (alGetError() != AL_NO_ERROR)
+    {
+        csrSoundManagerStopVoice(pVoice);
+        return 0;
+    }
+
+    return pVoice->m_Handle;
+}
+//---------------------------------------------------------------------------
+void csrSoundManagerStop(CSR_SoundManager* pManager, unsigned handle)
+{
+    CSR_SoundVoice* pVoice = csrSoundManagerFindVoice(pManager, handle);
+
+    if (pVoice)
+        csrSoundManagerStopVoice(pVoice);
+}
+//---------------------------------------------------------------------------
+void csrSoundManagerStopAll(CSR_SoundManager* pManager)
+{
+    size_t i;
+
+    if (!pManager)
+        return;
+
+    for (i = 0; i < pManager->m_VoiceCount; ++i)
+        if (pManager->m_pVoice[i].m_Handle)
+            csrSoundManagerStopVoice(&pManager->m_pVoice[i]);
+}
+//---------------------------------------------------------------------------
+int csrSoundManagerIsPlaying(const CSR_SoundManager* pManager, unsigned handle)
+{
+    const CSR_SoundVoice* pVoice = csrSoundManagerFindVoice(pManager, handle);
+
+    if (!pVoice)
+        return 0;
+
+    return !csrSoundManagerIsVoiceEnded(pVoice);
+}
+//---------------------------------------------------------------------------
+int csrSoundManagerSetPosition(CSR_SoundManager* pManager, unsigned handle, const CSR_Vector3* pPos)
+{
+    CSR_SoundVoice* pVoice;
+
+    if (!pPos)
+        return 0;
+
+    pVoice = csrSoundManagerFindVoice(pManager, handle);
+
+    if (!pVoice)
+        return 0;
+
+    pVoice->m_Position = *pPos;
+    pVoice->m_Relative = 0;
+
+    csrSoundManagerApplyVoice(pVoice);
+
+    return 1;
+}
+//---------------------------------------------------------------------------
+void csrSoundManagerUpdate(CSR_SoundManager* pManager)
+{
+    size_t i;
+
+    if (!pManager)
+        return;
+
+    for (i = 0; i < pManager->m_VoiceCount; ++i)
+    {
+        CSR_SoundVoice* pVoice = &pManager->m_pVoice[i];
+
+        // free voice?
+        if (!pVoice->m_Handle)
+            continue;
+
+        // feed the stream, or release the voice whose sound ended
+        if (pVoice->m_pStream)
+            csrSoundManagerFeedStream(pManager, pVoice);
+        else
+        if (csrSoundManagerIsVoiceEnded(pVoice))
+            csrSoundManagerStopVoice(pVoice);
+    }
+}
+//---------------------------------------------------------------------------
@@ -0,0 +1,339 @@
+/****************************************************************************
+ * ==> CSR_SoundManager ----------------------------------------------------*
+ ****************************************************************************
+ * Description : This module provides a sound manager, which plays shared   *
+ *               sound buffers and streamed sounds on a bounded voice pool  *
+ * Developer   : Jean-Milost Reymond                                        *
+ * Copyright   : 2017 - 2022, this file is part of the CompactStar Engine.  *
+ *               You are free to copy or redistribute this file, modify it, *
+ *               or use it for your own projects, commercial or not. This   *
+ *               file is provided "as is", WITHOUT ANY WARRANTY OF ANY      *
+ *               KIND. THE DEVELOPER IS NOT RESPONSIBLE FOR ANY DAMAGE OF   *
+ *               ANY KIND, ANY LOSS OF DATA, OR ANY LOSS OF PRODUCTIVITY    *
+ *               TIME THAT MAY RESULT FROM THE USAGE OF THIS SOURCE CODE,   *
+ *               DIRECTLY OR NOT.                                           *
+ ****************************************************************************/
+
+#ifndef CSR_SoundManagerH
+#define CSR_SoundManagerH
+
+// std
+#include <stdio.h>
+
+// compactStar engine
+#include "CSR_Common.h"
+#include "CSR_Geometry.h"
+#include "CSR_Sound.h"
+#include "CSR_Job.h"
+
+//---------------------------------------------------------------------------
+// Global defines
+//---------------------------------------------------------------------------
+#define M_CSR_Sound_Default_Voice_Count  16
+#define M_CSR_Sound_Stream_Buffer_Count  4
+#define M_CSR_Sound_Stream_Buffer_Length 32768 // bytes in each streamed buffer
+
+//---------------------------------------------------------------------------
+// Callbacks
+//---------------------------------------------------------------------------
+
+/**
+* Called when the next sound stream data should be decoded
+*@param pArg - decoder argument
+*@param[out] pData - buffer to fill with the decoded PCM data
+*@param length - buffer length, in bytes
+*@return decoded length in bytes, 0 if the stream end is reached
+*@note This function is called from the job pool threads
+*/
+typedef size_t (*CSR_fOnDecodeSoundStream)(void* pArg, void* pData, size_t length);
+
+/**
+* Called when a sound stream should restart from its beginning
+*@param pArg - decoder argument
+*@return 1 on success, otherwise 0
+*/
+typedef int (*CSR_fOnRewindSoundStream)(void* pArg);
+
+//---------------------------------------------------------------------------
+// Structures
+//---------------------------------------------------------------------------
+
+/**
+* Sound buffer, contains a whole sound which may be played by several voices at once
+*/
+typedef struct
+{
+    ALuint   m_ID;
+    ALenum   m_Format;
+    unsigned m_Sampling;
+} CSR_SoundBuffer;
+
+/**
+* Sound stream, decoded on the fly while it is played
+*@note A stream may only be played by one voice at once
+*/
+typedef struct
+{
+    CSR_fOnDecodeSoundStream m_fOnDecode;
+    CSR_fOnRewindSoundStream m_fOnRewind;
+    void*                    m_pDecodeArg;
+    FILE*                    m_pFile;                                      // wav file, if opened by csrSoundStreamOpenWavFile()
+    size_t                   m_DataOffset;                                 // wav data offset in the file
+    size_t                   m_DataLength;                                 // wav data length
+    size_t                   m_DataPos;                                    // next wav data to read
+    ALenum                   m_Format;
+    unsigned                 m_Sampling;
+    ALuint                   m_BufferID[M_CSR_Sound_Stream_Buffer_Count];
+    unsigned char*           m_pBlock;                                     // block decoded by the job
+    size_t                   m_BlockLength;                                // decoded block length, 0 if nothing left
+    CSR_Job                  m_Job;
+    CSR_JobPool*             m_pPool;                                      // job pool decoding the block
+    int                      m_Busy;                                       // 1 while the block is decoded
+    int                      m_Loop;
+    int                      m_End;                                        // 1 once the whole stream was decoded
+    int                      m_Attached;                                   // 1 while a voice plays the stream
+} CSR_SoundStream;
+
+/**
+* Sound voice, i.e. an OpenAL source which plays a sound buffer or stream
+*/
+typedef struct
+{
+    ALuint                 m_ID;
+    const CSR_SoundBuffer* m_pBuffer;  // played sound buffer, if any
+    CSR_SoundStream*       m_pStream;  // played sound stream, if any
+    CSR_Vector3            m_Position;
+    float                  m_Gain;
+    int                    m_Priority;
+    int                    m_Relative; // if 1, the position is relative to the listener
+    unsigned               m_Handle;   // handle of the played sound, 0 if the voice is free
+} CSR_SoundVoice;
+
+/**
+* Sound manager
+*/
+typedef struct
+{
+    CSR_SoundVoice* m_pVoice;
+    size_t          m_VoiceCount;
+    CSR_Vector3     m_ListenerPos;
+    CSR_JobPool*    m_pPool;      // job pool decoding the streams, if 0 they are decoded in the calling thread
+    unsigned        m_LastHandle;
+} CSR_SoundManager;
+
+#ifdef __cplusplus
+    extern "C"
+    {
+#endif
+        //-------------------------------------------------------------------
+        // Sound buffer functions
+        //-------------------------------------------------------------------
+
+        /**
+        * Creates a sound buffer from PCM data
+        *@param pBuffer - buffer containing the PCM data
+        *@param format - PCM data format, e.g. AL_FORMAT_STEREO16
+        *@param sampling - sound sampling (standard values are e.g. 48000, 44100, ...)
+        *@return newly created sound buffer on success, 0 on error
+        *@note An OpenAL context should be current
+        *@note The sound buffer must be released when no longer used, see csrSoundBufferRelease()
+        */
+        CSR_SoundBuffer* csrSoundBufferCreate(const CSR_Buffer* pBuffer, ALenum format, unsigned sampling);
+
+        /**
+        * Releases a sound buffer
+        *@param[in, out] pSoundBuffer - sound buffer to release
+        *@note The voices playing the buffer should be stopped before, see csrSoundManagerStopAll()
+        */
+        void csrSoundBufferRelease(CSR_SoundBuffer* pSoundBuffer);
+
+        /**
+        * Initializes a sound buffer structure
+        *@param[in, out] pSoundBuffer - sound buffer to initialize
+        */
+        void csrSoundBufferInit(CSR_SoundBuffer* pSoundBuffer);
+
+        /**
+        * Opens a sound buffer from a wav file
+        *@param pFileName - wav file name
+        *@return opened sound buffer on success, 0 on error
+        *@note The sound buffer must be released when no longer used, see csrSoundBufferRelease()
+        */
+        CSR_SoundBuffer* csrSoundBufferOpenWavFile(const char* pFileName);
+
+        /**
+        * Opens a sound buffer from a wav buffer
+        *@param pBuffer - buffer containing the wav file
+        *@return opened sound buffer on success, 0 on error
+        *@note The sound buffer must be released when no longer used, see csrSoundBufferRelease()
+        */
+        CSR_SoundBuffer* csrSoundBufferOpenWavBuffer(const CSR_Buffer* pBuffer);
+
+        //-------------------------------------------------------------------
+        // Sound stream functions
+        //-------------------------------------------------------------------
+
+        /**
+        * Creates a sound stream decoded by a custom decoder
+        *@param fOnDecode - function to call to decode the next stream data
+        *@param fOnRewind - function to call to restart the stream
+        *@param pDecodeArg - argument to pass to the decoder functions
+        *@param format - decoded PCM data format, e.g. AL_FORMAT_STEREO16
+        *@param sampling - sound sampling (standard values are e.g. 48000, 44100, ...)
+        *@return newly created sound stream on success, 0 on error
+        *@note An OpenAL context should be current
+        *@note The sound stream must be released when no longer used, see csrSoundStreamRelease()
+        */
+        CSR_SoundStream* csrSoundStreamCreate(CSR_fOnDecodeSoundStream fOnDecode,
+                                              CSR_fOnRewindSoundStream fOnRewind,
+                                              void*                    pDecodeArg,
+                                              ALenum                   format,
+                                              unsigned                 sampling);
+
+        /**
+        * Releases a sound stream, waits until its current block is decoded
+        *@param[in, out] pStream - sound stream to release
+        *@note The voice playing the stream should be stopped before
+        */
+        void csrSoundStreamRelease(CSR_SoundStream* pStream);
+
+        /**
+        * Initializes a sound stream structure
+        *@param[in, out] pStream - sound stream to initialize
+        */
+        void csrSoundStreamInit(CSR_SoundStream* pStream);
+
+        /**
+        * Opens a sound stream from a wav file
+        *@param pFileName - wav file name
+        *@return opened sound stream on success, 0 on error
+        *@note Only the wav header is read, the sound data is read while the stream is played
+        *@note The sound stream must be released when no longer used, see csrSoundStreamRelease()
+        */
+        CSR_SoundStream* csrSoundStreamOpenWavFile(const char* pFileName);
+
+        //-------------------------------------------------------------------
+        // Sound manager functions
+        //-------------------------------------------------------------------
+
+        /**
+        * Creates a sound manager
+        *@param voiceCount - max sound count played at once, if 0 a default count is used
+        *@param pPool - job pool on which the streams are decoded, if 0 they are decoded in the calling thread
+        *@return newly created sound manager on success, 0 on error
+        *@note An OpenAL context should be current. Less voices may be created if the device doesn't
+        *      support enough sources
+        *@note The sound manager must be released when no longer used, see csrSoundManagerRelease()
+        */
+        CSR_SoundManager* csrSoundManagerCreate(size_t voiceCount, CSR_JobPool* pPool);
+
+        /**
+        * Releases a sound manager, stops all its voices
+        *@param[in, out] pManager - sound manager to release
+        */
+        void csrSoundManagerRelease(CSR_SoundManager* pManager);
+
+        /**
+        * Initializes a sound manager structure
+        *@param[in, out] pManager - sound manager to initialize
+        */
+        void csrSoundManagerInit(CSR_SoundManager* pManager);
+
+        /**
+        * Sets the listener position
+        *@param[in, out] pManager - sound manager
+        *@param pPos - listener position
+        */
+        void csrSoundManagerSetListener(CSR_SoundManager* pManager, const CSR_Vector3* pPos);
+
+        /**
+        * Plays a sound buffer
+        *@param[in, out] pManager - sound manager
+        *@param pSoundBuffer - sound buffer to play
+        *@param pPos - sound position, if 0 the sound is played on the listener
+        *@param gain - sound gain, between 0 and 1
+        *@param priority - sound priority
+        *@param loop - if 1, the sound is looped
+        *@return played sound handle, 0 if no voice is available
+        *@note If all the voices are used, the sound replaces the voice with the lowest priority, and
+        *      for a same priority the least audible one, i.e. the quietest one for its distance. The
+        *      sound isn't played if all the voices are more important
+        *@note Only the mono sounds are positioned by OpenAL
+        */
+        unsigned csrSoundManagerPlay(      CSR_SoundManager* pManager,
+                                     const CSR_SoundBuffer*  pSoundBuffer,
+                                     const CSR_Vector3*      pPos,
+                                           float             gain,
+                                           int               priority,
+                                           int               loop);
+
+        /**
+        * Plays a sound stream from its beginning
+        *@param[in, out] pManager - sound manager
+        *@param[in, out] pStream - sound stream to play, should not be already played
+        *@param pPos - sound position, if 0 the sound is played on the listener
+        *@param gain - sound gain, between 0 and 1
+        *@param priority - sound priority
+        *@param loop - if 1, the sound is looped
+        *@return played sound handle, 0 if no voice is available or on error
+        *@note The first blocks are decoded in the calling thread, the next ones on the job pool
+        */
+        unsigned csrSoundManagerPlayStream(      CSR_SoundManager* pManager,
+                                                 CSR_SoundStream*  pStream,
+                                           const CSR_Vector3*      pPos,
+                                                 float             gain,
+                                                 int               priority,
+                                                 int               loop);
+
+        /**
+        * Stops a sound
+        *@param[in, out] pManager - sound manager
+        *@param handle - sound handle to stop
+        */
+        void csrSoundManagerStop(CSR_SoundManager* pManager, unsigned handle);
+
+        /**
+        * Stops all the sounds
+        *@param[in, out] pManager - sound manager
+        */
+        void csrSoundManagerStopAll(CSR_SoundManager* pManager);
+
+        /**
+        * Checks if a sound is still played
+        *@param pManager - sound manager
+        *@param handle - sound handle to check
+        *@return 1 if the sound is still played, otherwise 0
+        *@note A sound is no longer played if it was stopped, or replaced by a more important one
+        */
+        int csrSoundManagerIsPlaying(const CSR_SoundManager* pManager, unsigned handle);
+
+        /**
+        * Changes a sound position
+        *@param[in, out] pManager - sound manager
+        *@param handle - sound handle
+        *@param pPos - new sound position
+        *@return 1 on success, 0 if the sound is no longer played
+        */
+        int csrSoundManagerSetPosition(CSR_SoundManager* pManager, unsigned handle, const CSR_Vector3* pPos);
+
+        /**
+        * Updates the sound manager, should be called regularly, e.g. on each frame
+        *@param[in, out] pManager - sound manager to update
+        *@note The ended voices are released, and the played streams are fed with their decoded blocks
+        */
+        void csrSoundManagerUpdate(CSR_SoundManager* pManager);
+
+#ifdef __cplusplus
+    }
+#endif
+
+//---------------------------------------------------------------------------
+// Compiler
+//---------------------------------------------------------------------------
+
+// needed in mobile c compiler to link the .h file with the .c
+#if defined(_OS_IOS_) || defined(_OS_ANDROID_) || defined(_OS_WINDOWS_)
+    #include "CSR_SoundManager.c"
+#endif
+
+#endif
@@ -111,7 +111,7 @@ CSR_PixelBuffer* csrPixelBufferFromBitmapFile(const char* pFileName)
     CSR_PixelBuffer* pPixelBuffer;
 
     // open bitmap file
-    pBuffer = csrFileOpen(pFileName);
+    pBuffer = csrFileMap(pFileName);
 
     // convert to pixel buffer
     pPixelBuffer = csrPixelBufferFromBitmapBuffer(pBuffer);
@@ -306,7 +306,7 @@ CSR_PixelBuffer* csrPixelBufferFromTgaFile(const char* pFileName)
     CSR_PixelBuffer* pPixelBuffer;
 
     // open bitmap file
-    pBuffer = csrFileOpen(pFileName);
+    pBuffer = csrFileMap(pFileName);
 
     // convert to pixel buffer
     pPixelBuffer = csrPixelBufferFromTgaBuffer(pBuffer);
@@ -775,6 +775,260 @@ CSR_PixelBuffer* csrPixelBufferFromTgaBuffer(const CSR_Buffer* pBuffer)
     }
 }
 //---------------------------------------------------------------------------
+size_t csrPixelBufferRowLength(const CSR_PixelBuffer* pPB)
+{
+    // no pixel buffer?
+    if (!pPB)
+        return 0;
+
+    // the bitmap rows are padded, see csrPixelBufferFromBitmapBuffer()
+    if (pPB->m_ImageType == CSR_IT_Bitmap && pPB->m_Stride)
+        return pPB->m_Stride;
+
+    return (size_t)pPB->m_Width * (size_t)pPB->m_BytePerPixel;
+}
+//---------------------------------------------------------------------------
+int csrPixelBufferGetKey(const CSR_PixelBuffer* pPB, CSR_PixelBufferKey* pKey)
+{
+    const unsigned char* pData;
+          size_t         length;
+          size_t         i;
+          unsigned       fnv;
+          unsigned       djb;
+
+    // validate the inputs
+    if (!pPB || !pPB->m_pData || !pKey)
+        return 0;
+
+    pData  = (const unsigned char*)pPB->m_pData;
+    length = csrPixelBufferRowLength(pPB) * pPB->m_Height;
+
+    if (pPB->m_DataLength && length > pPB->m_DataLength)
+        length = pPB->m_DataLength;
+
+    fnv = 2166136261u;
+    djb = 5381u;
+
+    // hash the content with FNV-1a and djb2, which are independent enough to be combined
+    for (i = 0; i < length; ++i)
+    {
+        fnv = (fnv ^ pData[i]) * 16777619u;
+        djb = ((djb << 5) + djb) + pData[i];
+    }
+
+    // the image format is also part of the content
+    fnv = (fnv ^ (unsigned)pPB->m_ImageType) * 16777619u;
+    fnv = (fnv ^ (unsigned)pPB->m_PixelType) * 16777619u;
+
+    pKey->m_Hash[0]      = fnv;
+    pKey->m_Hash[1]      = djb;
+    pKey->m_Width        = pPB->m_Width;
+    pKey->m_Height       = pPB->m_Height;
+    pKey->m_BytePerPixel = pPB->m_BytePerPixel;
+
+    return 1;
+}
+//---------------------------------------------------------------------------
+int csrPixelBufferKeyEqual(const CSR_PixelBufferKey* pKey1, const CSR_PixelBufferKey* pKey2)
+{
+    // validate the inputs
+    if (!pKey1 || !pKey2)
+        return 0;
+
+    return (pKey1->m_Hash[0]      == pKey2->m_Hash[0]      &&
+            pKey1->m_Hash[1]      == pKey2->m_Hash[1]      &&
+            pKey1->m_Width        == pKey2->m_Width        &&
+            pKey1->m_Height       == pKey2->m_Height       &&
+            pKey1->m_BytePerPixel == pKey2->m_BytePerPixel);
+}
+//---------------------------------------------------------------------------
+CSR_PixelBuffer* csrPixelBufferDownsample(const CSR_PixelBuffer* pPB)
+{
+    CSR_PixelBuffer*     pResult;
+    const unsigned char* pSrc;
+    unsigned char*       pDst;
+    size_t               srcRowLength;
+    size_t               dstRowLength;
+    unsigned             x;
+    unsigned             y;
+    unsigned             c;
+
+    // validate the input
+    if (!pPB || !pPB->m_pData || !pPB->m_Width || !pPB->m_Height || !pPB->m_BytePerPixel)
+        return 0;
+
+    // create the result pixel buffer
+    pResult = csrPixelBufferCreate();
+
+    // succeeded?
+    if (!pResult)
+        return 0;
+
+    pResult->m_ImageType    = pPB->m_ImageType;
+    pResult->m_PixelType    = pPB->m_PixelType;
+    pResult->m_Width        = pPB->m_Width  > 1 ? pPB->m_Width  >> 1 : 1;
+    pResult->m_Height       = pPB->m_Height > 1 ? pPB->m_Height >> 1 : 1;
+    pResult->m_BytePerPixel = pPB->m_BytePerPixel;
+
+    // the bitmap rows keep their padding
+    if (pPB->m_ImageType == CSR_IT_Bitmap)
+        pResult->m_Stride = ((pResult->m_Width * pResult->m_BytePerPixel + 3) / 4) * 4;
+    else
+        pResult->m_Stride = pResult->m_Width * pResult->m_BytePerPixel;
+
+    dstRowLength          = csrPixelBufferRowLength(pResult);
+    srcRowLength          = csrPixelBufferRowLength(pPB);
+    pResult->m_DataLength = dstRowLength * pResult->m_Height;
+    pResult->m_pData      = calloc(pResult->m_DataLength, 1);
+
+    // succeeded?
+    if (!pResult->m_pData)
+    {
+        csrPixelBufferRelease(pResult);
+        return 0;
+    }
+
+    pSrc = (const unsigned char*)pPB->m_pData;
+    pDst = (unsigned char*)pResult->m_pData;
+
+    // average each 2x2 block, the last row or column is repeated on the odd sides
+    for (y = 0; y < pResult->m_Height; ++y)
+    {
+        const unsigned y0 = (y << 1)     < pPB->m_Height ? (y << 1)     : pPB->m_Height - 1;
+        const unsigned y1 = (y << 1) + 1 < pPB->m_Height ? (y << 1) + 1 : pPB->m_Height - 1;
+
+        for (x = 0; x < pResult->m_Width; ++x)
+        {
+            const unsigned x0 = (x << 1)     < pPB->m_Width ? (x << 1)     : pPB->m_Width - 1;
+            const unsigned x1 = (x << 1) + 1 < pPB->m_Width ? (x << 1) + 1 : pPB->m_Width - 1;
+
+            for (c = 0; c < pPB->m_BytePerPixel; ++c)
+            {
+                const unsigned sum = pSrc[y0 * srcRowLength + x0 * pPB->m_BytePerPixel + c] +
+                                     pSrc[y0 * srcRowLength + x1 * pPB->m_BytePerPixel + c] +
+                                     pSrc[y1 * srcRowLength + x0 * pPB->m_BytePerPixel + c] +
+                                     pSrc[y1 * srcRowLength + x1 * pPB->m_BytePerPixel + c];
+
+                pDst[y * dstRowLength + x * pResult->m_BytePerPixel + c] = (unsigned char)((sum + 2) >> 2);
+            }
+        }
+    }
+
+    return pResult;
+}
+//---------------------------------------------------------------------------
+// Mipmap chain functions
+//---------------------------------------------------------------------------
+CSR_MipChain* csrMipChainCreate(const CSR_PixelBuffer* pPB)
+{
+    CSR_MipChain* pMC;
+    size_t        count;
+    size_t        i;
+    unsigned      size;
+
+    // validate the input
+    if (!pPB || !pPB->m_pData || !pPB->m_Width || !pPB->m_Height)
+        return 0;
+
+    // create the mipmap chain
+    pMC = (CSR_MipChain*)malloc(sizeof(CSR_MipChain));
+
+    // succeeded?
+    if (!pMC)
+        return 0;
+
+    csrMipChainInit(pMC);
+
+    // calculate the level count
+    size  = pPB->m_Width > pPB->m_Height ? pPB->m_Width : pPB->m_Height;
+    count = 1;
+
+    while (size > 1)
+    {
+        size >>= 1;
+        ++count;
+    }
+
+    pMC->m_pLevel = (CSR_PixelBuffer*)malloc(count * sizeof(CSR_PixelBuffer));
+
+    // succeeded?
+    if (!pMC->m_pLevel)
+    {
+        csrMipChainRelease(pMC);
+        return 0;
+    }
+
+    // copy the source as level 0
+    pMC->m_pLevel[0]              = *pPB;
+    pMC->m_pLevel[0].m_Stride     = (unsigned)csrPixelBufferRowLength(pPB);
+    pMC->m_pLevel[0].m_DataLength = csrPixelBufferRowLength(pPB) * pPB->m_Height;
+    pMC->m_pLevel[0].m_pData      = malloc(pMC->m_pLevel[0].m_DataLength);
+    pMC->m_Count                  = 1;
+
+    // succeeded?
+    if (!pMC->m_pLevel[0].m_pData || (pPB->m_DataLength && pPB->m_DataLength < pMC->m_pLevel[0].m_DataLength))
+    {
+        csrMipChainRelease(pMC);
+        return 0;
+    }
+
+    memcpy(pMC->m_pLevel[0].m_pData, pPB->m_pData, pMC->m_pLevel[0].m_DataLength);
+
+    // generate the next levels, each one from the previous
+    for (i = 1; i < count; ++i)
+    {
+        CSR_PixelBuffer* pLevel = csrPixelBufferDownsample(&pMC->m_pLevel[i - 1]);
+
+        // succeeded?
+        if (!pLevel)
+        {
+            csrMipChainRelease(pMC);
+            return 0;
+        }
+
+        // take the level content, and release the container only
+        pMC->m_pLevel[i] = *pLevel;
+        free(pLevel);
+
+        ++pMC->m_Count;
+    }
+
+    return pMC;
+}
+//---------------------------------------------------------------------------
+void csrMipChainRelease(CSR_MipChain* pMC)
+{
+    size_t i;
+
+    // no mipmap chain to release?
+    if (!pMC)
+        return;
+
+    // free the levels
+    if (pMC->m_pLevel)
+    {
+        for (i = 0; i < pMC->m_Count; ++i)
+            if (pMC->m_pLevel[i].m_pData)
+                free(pMC->m_pLevel[i].m_pData);
+
+        free(pMC->m_pLevel);
+    }
+
+    // free the mipmap chain
+    free(pMC);
+}
+//---------------------------------------------------------------------------
+void csrMipChainInit(CSR_MipChain* pMC)
+{
+    // no mipmap chain to initialize?
+    if (!pMC)
+        return;
+
+    // initialize the mipmap chain content
+    pMC->m_pLevel = 0;
+    pMC->m_Count  = 0;
+}
+//---------------------------------------------------------------------------
 // Texture functions
 //---------------------------------------------------------------------------
 CSR_Texture* csrTextureCreate(void)
@@ -64,6 +64,26 @@ typedef struct
     void*          m_pData;
 } CSR_PixelBuffer;
 
+/**
+* Pixel buffer key, identifies a pixel buffer by its content
+*/
+typedef struct
+{
+    unsigned m_Hash[2]; // two independent content hashes, to make the collisions negligible
+    unsigned m_Width;
+    unsigned m_Height;
+    unsigned m_BytePerPixel;
+} CSR_PixelBufferKey;
+
+/**
+* Mipmap chain, from the full size image (level 0) to the 1x1 image
+*/
+typedef struct
+{
+    CSR_PixelBuffer* m_pLevel;
+    size_t           m_Count;
+} CSR_MipChain;
+
 /**
 * Texture item
 */
@@ -164,6 +184,63 @@ typedef void (*CSR_fOnDeleteTexture)(const CSR_Texture* pTexture);
         */
         CSR_PixelBuffer* csrPixelBufferFromTgaBuffer(const CSR_Buffer* pBuffer);
 
+        /**
+        * Gets the pixel buffer row length in bytes
+        *@param pPB - pixel buffer
+        *@return the row length, including the padding if any
+        *@note The bitmap rows are padded to 4 bytes, the other image rows are tightly packed
+        */
+        size_t csrPixelBufferRowLength(const CSR_PixelBuffer* pPB);
+
+        /**
+        * Calculates the key identifying a pixel buffer content
+        *@param pPB - pixel buffer for which the key should be calculated
+        *@param[out] pKey - pixel buffer key
+        *@return 1 on success, otherwise 0
+        */
+        int csrPixelBufferGetKey(const CSR_PixelBuffer* pPB, CSR_PixelBufferKey* pKey);
+
+        /**
+        * Compares 2 pixel buffer keys
+        *@param pKey1 - first key to compare
+        *@param pKey2 - second key to compare
+        *@return 1 if both keys are identical, otherwise 0
+        */
+        int csrPixelBufferKeyEqual(const CSR_PixelBufferKey* pKey1, const CSR_PixelBufferKey* pKey2);
+
+        /**
+        * Creates a pixel buffer with the half size of another, using a 2x2 box filter
+        *@param pPB - source pixel buffer
+        *@return newly created pixel buffer, 0 on error
+        *@note Each side is at least 1 pixel, a 1x1 source is copied as is
+        *@note The pixel buffer must be released when no longer used, see csrPixelBufferRelease()
+        */
+        CSR_PixelBuffer* csrPixelBufferDownsample(const CSR_PixelBuffer* pPB);
+
+        //-------------------------------------------------------------------
+        // Mipmap chain functions
+        //-------------------------------------------------------------------
+
+        /**
+        * Creates a mipmap chain from a pixel buffer
+        *@param pPB - source pixel buffer, copied as level 0
+        *@return newly created mipmap chain, 0 on error
+        *@note The mipmap chain must be released when no longer used, see csrMipChainRelease()
+        */
+        CSR_MipChain* csrMipChainCreate(const CSR_PixelBuffer* pPB);
+
+        /**
+        * Releases a mipmap chain
+        *@param[in, out] pMC - mipmap chain to release
+        */
+        void csrMipChainRelease(CSR_MipChain* pMC);
+
+        /**
+        * Initializes a mipmap chain structure
+        *@param[in, out] pMC - mipmap chain to initialize
+        */
+        void csrMipChainInit(CSR_MipChain* pMC);
+
         //-------------------------------------------------------------------
         // Texture functions
         //-------------------------------------------------------------------
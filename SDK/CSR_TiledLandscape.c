@@ -0,0 +1,994 @@
+/****************************************************************************
+ * ==> CSR_TiledLandscape --------------------------------------------------*
+ ****************************************************************************
+ * Description : This module provides a tiled landscape, whose tiles are    *
+ *               built around the point of view on worker threads, and      *
+ *               released when they become too far                          *
+ * Developer   : Jean-Milost Reymond                                        *
+ * Copyright   : 2017 - 2022, this file is part of the CompactStar Engine.  *
+ *               You are free to copy or redistribute this file, modify it, *
+ *               or use it for your own projects, commercial or not. This   *
+ *               file is provided "as is", WITHOUT ANY WARRANTY OF ANY      *
+ *               KIND. THE DEVELOPER IS NOT RESPONSIBLE FOR ANY DAMAGE OF   *
+ *               ANY KIND, ANY LOSS OF DATA, OR ANY LOSS OF PRODUCTIVITY    *
+ *               TIME THAT MAY RESULT FROM THE USAGE OF THIS SOURCE CODE,   *
+ *               DIRECTLY OR NOT.                                           *
+ ****************************************************************************/
+
+#include "CSR_TiledLandscape.h"
+
+// std
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+//---------------------------------------------------------------------------
+// Private structures
+//---------------------------------------------------------------------------
+
+/**
+* Tile to load, found around the point of view
+*/
+typedef struct
+{
+    size_t m_X;
+    size_t m_Z;
+    float  m_Distance;
+} CSR_TiledLandscapeCandidate;
+
+//---------------------------------------------------------------------------
+// Tiled landscape private functions
+//---------------------------------------------------------------------------
+void csrTiledLandscapeGetTileCells(const CSR_TiledLandscape* pLandscape,
+                                         size_t              x,
+                                         size_t              z,
+                                         size_t*             pCellsX,
+                                         size_t*             pCellsZ)
+{
+    const size_t firstX = x * pLandscape->m_TileSize;
+    const size_t firstZ = z * pLandscape->m_TileSize;
+
+    // the last tiles may be smaller than the others
+    *pCellsX = (pLandscape->m_Width - 1) - firstX;
+    *pCellsZ = (pLandscape->m_Depth - 1) - firstZ;
+
+    if (*pCellsX > pLandscape->m_TileSize)
+        *pCellsX = pLandscape->m_TileSize;
+
+    if (*pCellsZ > pLandscape->m_TileSize)
+        *pCellsZ = pLandscape->m_TileSize;
+}
+//---------------------------------------------------------------------------
+float csrTiledLandscapeGetDistance(const CSR_TiledLandscape* pLandscape,
+                                         size_t              x,
+                                         size_t              z,
+                                   const CSR_Vector3*        pViewPos)
+{
+    size_t cellsX;
+    size_t cellsZ;
+    float  minX;
+    float  maxX;
+    float  minZ;
+    float  maxZ;
+    float  dx;
+    float  dz;
+
+    csrTiledLandscapeGetTileCells(pLandscape, x, z, &cellsX, &cellsZ);
+
+    // calculate the tile rect
+    minX = pLandscape->m_X + ((float) (x * pLandscape->m_TileSize)           * pLandscape->m_Scale);
+    maxX = pLandscape->m_X + ((float)((x * pLandscape->m_TileSize) + cellsX) * pLandscape->m_Scale);
+    maxZ = pLandscape->m_Z - ((float) (z * pLandscape->m_TileSize)           * pLandscape->m_Scale);
+    minZ = pLandscape->m_Z - ((float)((z * pLandscape->m_TileSize) + cellsZ) * pLandscape->m_Scale);
+
+    // calculate the distance between the point of view and the nearest tile point, on the xz plane
+    dx = 0.0f;
+    dz = 0.0f;
+
+    if (pViewPos->m_X < minX)
+        dx = minX - pViewPos->m_X;
+    else
+    if (pViewPos->m_X > maxX)
+        dx = pViewPos->m_X - maxX;
+
+    if (pViewPos->m_Z < minZ)
+        dz = minZ - pViewPos->m_Z;
+    else
+    if (pViewPos->m_Z > maxZ)
+        dz = pViewPos->m_Z - maxZ;
+
+    return sqrtf((dx * dx) + (dz * dz));
+}
+//---------------------------------------------------------------------------
+size_t csrTiledLandscapeGetLevel(const CSR_TiledLandscape* pLandscape, float distance)
+{
+    size_t level         = 0;
+    float  levelDistance = pLandscape->m_LODDistance;
+
+    // no level of detail?
+    if (levelDistance <= 0.0f)
+        return 0;
+
+    // each level is used from twice the previous level distance
+    while (level < pLandscape->m_MaxLevel && distance >= levelDistance)
+    {
+        ++level;
+        levelDistance *= 2.0f;
+    }
+
+    return level;
+}
+//---------------------------------------------------------------------------
+CSR_HeightField* csrTiledLandscapeLoadHeightField(const CSR_TiledLandscapeTile* pTile)
+{
+    const CSR_TiledLandscape* pLandscape = pTile->m_pLandscape;
+    CSR_HeightField*          pHF;
+    size_t                    cellsX;
+    size_t                    cellsZ;
+    size_t                    count;
+    size_t                    i;
+
+    csrTiledLandscapeGetTileCells(pLandscape, pTile->m_X, pTile->m_Z, &cellsX, &cellsZ);
+
+    // create the tile height field
+    pHF = (CSR_HeightField*)malloc(sizeof(CSR_HeightField));
+
+    // succeeded?
+    if (!pHF)
+        return 0;
+
+    csrHeightFieldInit(pHF);
+
+    count          = (cellsX + 1) * (cellsZ + 1);
+    pHF->m_pHeight = (float*)malloc(count * sizeof(float));
+
+    // succeeded?
+    if (!pHF->m_pHeight)
+    {
+        csrHeightFieldRelease(pHF);
+        return 0;
+    }
+
+    // read the tile samples, including the ones shared with the next tiles
+    if (!pLandscape->m_fOnRead(pLandscape->m_pReadArg,
+                               pTile->m_X * pLandscape->m_TileSize,
+                               pTile->m_Z * pLandscape->m_TileSize,
+                               cellsX + 1,
+                               cellsZ + 1,
+                               pHF->m_pHeight))
+    {
+        csrHeightFieldRelease(pHF);
+        return 0;
+    }
+
+    for (i = 0; i < count; ++i)
+        pHF->m_pHeight[i] *= pLandscape->m_Height;
+
+    pHF->m_Width = cellsX + 1;
+    pHF->m_Depth = cellsZ + 1;
+    pHF->m_Scale = pLandscape->m_Scale;
+    pHF->m_X     = pLandscape->m_X + ((float)(pTile->m_X * pLandscape->m_TileSize) * pLandscape->m_Scale);
+    pHF->m_Z     = pLandscape->m_Z - ((float)(pTile->m_Z * pLandscape->m_TileSize) * pLandscape->m_Scale);
+
+    return pHF;
+}
+//---------------------------------------------------------------------------
+float* csrTiledLandscapeAddVertex(const CSR_Vector3*      pVertex,
+                                  const CSR_Vector3*      pNormal,
+                                  const CSR_Vector2*      pUV,
+                                  const CSR_VertexBuffer* pVB,
+                                        float*            pData)
+{
+    // write the vertex the same way as csrVertexBufferAdd() does, in an already allocated buffer
+    pData[0] = pVertex->m_X;
+    pData[1] = pVertex->m_Y;
+    pData[2] = pVertex->m_Z;
+
+    #ifdef CSR_USE_METAL
+        pData[3] = 1.0f;
+        pData   += 4;
+    #else
+        pData   += 3;
+    #endif
+
+    if (pVB->m_Format.m_HasNormal)
+    {
+        pData[0] = pNormal->m_X;
+        pData[1] = pNormal->m_Y;
+        pData[2] = pNormal->m_Z;
+
+        #ifdef CSR_USE_METAL
+            pData[3] = 1.0f;
+            pData   += 4;
+        #else
+            pData   += 3;
+        #endif
+    }
+
+    if (pVB->m_Format.m_HasTexCoords)
+    {
+        pData[0] = pUV->m_X;
+        pData[1] = pUV->m_Y;
+
+        #ifdef CSR_USE_METAL
+            pData[2] = 0.0f;
+            pData[3] = 0.0f;
+            pData   += 4;
+        #else
+            pData   += 2;
+        #endif
+    }
+
+    if (pVB->m_Format.m_HasPerVertexColor)
+    {
+        pData[0] = (float)((pVB->m_Material.m_Color >> 24) & 0xFF) / 255.0f;
+        pData[1] = (float)((pVB->m_Material.m_Color >> 16) & 0xFF) / 255.0f;
+        pData[2] = (float)((pVB->m_Material.m_Color >> 8)  & 0xFF) / 255.0f;
+        pData[3] = (float) (pVB->m_Material.m_Color        & 0xFF) / 255.0f;
+        pData   += 4;
+    }
+
+    return pData;
+}
+//---------------------------------------------------------------------------
+float* csrTiledLandscapeAddPolygon(const CSR_Vector3*      pV1,
+                                   const CSR_Vector3*      pV2,
+                                   const CSR_Vector3*      pV3,
+                                   const CSR_Vector2*      pUV1,
+                                   const CSR_Vector2*      pUV2,
+                                   const CSR_Vector2*      pUV3,
+                                   const CSR_VertexBuffer* pVB,
+                                         float*            pData)
+{
+    CSR_Plane   plane;
+    CSR_Vector3 normal;
+
+    // calculate the polygon normal, the same way as the landscape does
+    if (pVB->m_Format.m_HasNormal)
+    {
+        csrPlaneFromPoints(pV1, pV2, pV3, &plane);
+
+        normal.m_X = plane.m_A;
+        normal.m_Y = plane.m_B;
+        normal.m_Z = plane.m_C;
+    }
+
+    pData = csrTiledLandscapeAddVertex(pV1, &normal, pUV1, pVB, pData);
+    pData = csrTiledLandscapeAddVertex(pV2, &normal, pUV2, pVB, pData);
+    pData = csrTiledLandscapeAddVertex(pV3, &normal, pUV3, pVB, pData);
+
+    return pData;
+}
+//---------------------------------------------------------------------------
+void csrTiledLandscapeGetSample(const CSR_TiledLandscapeTile* pTile,
+                                const CSR_HeightField*        pHF,
+                                      size_t                  x,
+                                      size_t                  z,
+                                      float                   depth,
+                                      CSR_Vector3*            pVertex,
+                                      CSR_Vector2*            pUV)
+{
+    const CSR_TiledLandscape* pLandscape = pTile->m_pLandscape;
+    const size_t              sampleX    = (pTile->m_X * pLandscape->m_TileSize) + x;
+    const size_t              sampleZ    = (pTile->m_Z * pLandscape->m_TileSize) + z;
+
+    // calculate the vertex the same way as the landscape does
+    pVertex->m_X = pLandscape->m_X + ((float)sampleX * pLandscape->m_Scale);
+    pVertex->m_Y = pHF->m_pHeight[(z * pHF->m_Width) + x] - depth;
+    pVertex->m_Z = pLandscape->m_Z - ((float)sampleZ * pLandscape->m_Scale);
+
+    // the texture coordinates are calculated on the whole landscape
+    pUV->m_X = (float)sampleX / (float)pLandscape->m_Width;
+    pUV->m_Y = (float)sampleZ / (float)pLandscape->m_Depth;
+}
+//---------------------------------------------------------------------------
+float* csrTiledLandscapeAddSkirt(const CSR_TiledLandscapeTile* pTile,
+                                 const CSR_HeightField*        pHF,
+                                       size_t                  x1,
+                                       size_t                  z1,
+                                       size_t                  x2,
+                                       size_t                  z2,
+                                 const CSR_VertexBuffer*       pVB,
+                                       float*                  pData)
+{
+    const float depth = pTile->m_pLandscape->m_SkirtDepth;
+    CSR_Vector3 v1;
+    CSR_Vector3 v2;
+    CSR_Vector3 v3;
+    CSR_Vector3 v4;
+    CSR_Vector2 uv1;
+    CSR_Vector2 uv2;
+    CSR_Vector2 uv3;
+    CSR_Vector2 uv4;
+
+    // get the border points, and the points below them
+    csrTiledLandscapeGetSample(pTile, pHF, x1, z1, 0.0f,  &v1, &uv1);
+    csrTiledLandscapeGetSample(pTile, pHF, x2, z2, 0.0f,  &v2, &uv2);
+    csrTiledLandscapeGetSample(pTile, pHF, x1, z1, depth, &v3, &uv3);
+    csrTiledLandscapeGetSample(pTile, pHF, x2, z2, depth, &v4, &uv4);
+
+    // add the vertical skirt polygons, facing outside when the border is traversed counterclockwise
+    pData = csrTiledLandscapeAddPolygon(&v1, &v2, &v3, &uv1, &uv2, &uv3, pVB, pData);
+    pData = csrTiledLandscapeAddPolygon(&v2, &v4, &v3, &uv2, &uv4, &uv3, pVB, pData);
+
+    return pData;
+}
+//---------------------------------------------------------------------------
+size_t csrTiledLandscapeGetSampleIndex(size_t index, size_t step, size_t cells)
+{
+    // the last sample is always the tile border, even if the cell count isn't a multiple of the step
+    index *= step;
+
+    return index < cells ? index : cells;
+}
+//---------------------------------------------------------------------------
+CSR_Mesh* csrTiledLandscapeBuildMesh(const CSR_TiledLandscapeTile* pTile,
+                                     const CSR_HeightField*        pHF,
+                                           size_t                  level)
+{
+    const CSR_TiledLandscape* pLandscape = pTile->m_pLandscape;
+    const size_t              step       = (size_t)1 << level;
+    const size_t              cellsX     = pHF->m_Width - 1;
+    const size_t              cellsZ     = pHF->m_Depth - 1;
+    const size_t              countX     = (cellsX + step - 1) / step;
+    const size_t              countZ     = (cellsZ + step - 1) / step;
+    CSR_Mesh*                 pMesh;
+    CSR_VertexBuffer*         pVB;
+    float*                    pData;
+    size_t                    x;
+    size_t                    z;
+    size_t                    x1;
+    size_t                    x2;
+    size_t                    z1;
+    size_t                    z2;
+    CSR_Vector3               v1;
+    CSR_Vector3               v2;
+    CSR_Vector3               v3;
+    CSR_Vector3               v4;
+    CSR_Vector2               uv1;
+    CSR_Vector2               uv2;
+    CSR_Vector2               uv3;
+    CSR_Vector2               uv4;
+
+    // create a mesh to contain the tile
+    pMesh = csrMeshCreate();
+
+    // succeeded?
+    if (!pMesh)
+        return 0;
+
+    pMesh->m_pVB = (CSR_VertexBuffer*)malloc(sizeof(CSR_VertexBuffer));
+
+    // succeeded?
+    if (!pMesh->m_pVB)
+    {
+        csrMeshRelease(pMesh, 0);
+        return 0;
+    }
+
+    pMesh->m_Count = 1;
+    pVB            = pMesh->m_pVB;
+
+    // configure the vertex buffer
+    csrVertexBufferInit(pVB);
+    pVB->m_Format        = pLandscape->m_Format;
+    pVB->m_Culling       = pLandscape->m_Culling;
+    pVB->m_Material      = pLandscape->m_Material;
+    pVB->m_Format.m_Type = CSR_VT_Triangles;
+    csrVertexFormatCalculateStride(&pVB->m_Format);
+
+    // allocate the vertices at once, 2 polygons for each cell and for each border segment
+    pVB->m_Count = (((countX * countZ) + ((countX + countZ) * 2)) * 6) * pVB->m_Format.m_Stride;
+    pVB->m_pData = (float*)malloc(pVB->m_Count * sizeof(float));
+
+    // succeeded?
+    if (!pVB->m_pData)
+    {
+        pVB->m_Count = 0;
+        csrMeshRelease(pMesh, 0);
+        return 0;
+    }
+
+    pData = pVB->m_pData;
+
+    // generate the tile polygons, in the same order as the landscape:
+    // v1 -- v2
+    //     /
+    //    /
+    // v3 -- v4
+    for (z = 0; z < countZ; ++z)
+    {
+        z1 = csrTiledLandscapeGetSampleIndex(z,     step, cellsZ);
+        z2 = csrTiledLandscapeGetSampleIndex(z + 1, step, cellsZ);
+
+        for (x = 0; x < countX; ++x)
+        {
+            x1 = csrTiledLandscapeGetSampleIndex(x,     step, cellsX);
+            x2 = csrTiledLandscapeGetSampleIndex(x + 1, step, cellsX);
+
+            csrTiledLandscapeGetSample(pTile, pHF, x1, z1, 0.0f, &v1, &uv1);
+            csrTiledLandscapeGetSample(pTile, pHF, x2, z1, 0.0f, &v2, &uv2);
+            csrTiledLandscapeGetSample(pTile, pHF, x1, z2, 0.0f, &v3, &uv3);
+            csrTiledLandscapeGetSample(pTile, pHF, x2, z2, 0.0f, &v4, &uv4);
+
+            pData = csrTiledLandscapeAddPolygon(&v1, &v2, &v3, &uv1, &uv2, &uv3, pVB, pData);
+            pData = csrTiledLandscapeAddPolygon(&v2, &v3, &v4, &uv2, &uv3, &uv4, pVB, pData);
+        }
+    }
+
+    // add the skirts, which hide the cracks between tiles of different levels. NOTE the first row
+    // is on the +z side, and the rows go toward -z
+    for (x = 0; x < countX; ++x)
+    {
+        x1 = csrTiledLandscapeGetSampleIndex(x,     step, cellsX);
+        x2 = csrTiledLandscapeGetSampleIndex(x + 1, step, cellsX);
+
+        pData = csrTiledLandscapeAddSkirt(pTile, pHF, x2, 0,      x1, 0,      pVB, pData);
+        pData = csrTiledLandscapeAddSkirt(pTile, pHF, x1, cellsZ, x2, cellsZ, pVB, pData);
+    }
+
+    for (z = 0; z < countZ; ++z)
+    {
+        z1 = csrTiledLandscapeGetSampleIndex(z,     step, cellsZ);
+        z2 = csrTiledLandscapeGetSampleIndex(z + 1, step, cellsZ);
+
+        pData = csrTiledLandscapeAddSkirt(pTile, pHF, cellsX, z2, cellsX, z1, pVB, pData);
+        pData = csrTiledLandscapeAddSkirt(pTile, pHF, 0,      z1, 0,      z2, pVB, pData);
+    }
+
+    return pMesh;
+}
+//---------------------------------------------------------------------------
+void csrTiledLandscapeOnBuildTile(void* pArg)
+{
+    CSR_TiledLandscapeTile* pTile = (CSR_TiledLandscapeTile*)pArg;
+    const CSR_HeightField*  pHF   = pTile->m_pHeightField;
+
+    // load the tile heights, if still not done
+    if (!pHF)
+    {
+        pTile->m_pNewHeightField = csrTiledLandscapeLoadHeightField(pTile);
+        pHF                      = pTile->m_pNewHeightField;
+
+        // succeeded?
+        if (!pHF)
+            return;
+    }
+
+    // build the tile mesh
+    pTile->m_pNewMesh = csrTiledLandscapeBuildMesh(pTile, pHF, pTile->m_NewLevel);
+}
+//---------------------------------------------------------------------------
+void csrTiledLandscapeCommitTile(CSR_TiledLandscapeTile* pTile)
+{
+    // show the heights loaded by the job
+    if (pTile->m_pNewHeightField)
+    {
+        csrHeightFieldRelease(pTile->m_pHeightField);
+        pTile->m_pHeightField = pTile->m_pNewHeightField;
+    }
+
+    // replace the mesh by the one built by the job
+    if (pTile->m_pNewMesh)
+    {
+        csrMeshRelease(pTile->m_pMesh, 0);
+        pTile->m_pMesh  = pTile->m_pNewMesh;
+        pTile->m_Level  = pTile->m_NewLevel;
+    }
+
+    pTile->m_pNewHeightField = 0;
+    pTile->m_pNewMesh        = 0;
+    pTile->m_Busy            = 0;
+}
+//---------------------------------------------------------------------------
+int csrTiledLandscapeBuildTile(CSR_TiledLandscapeTile* pTile, size_t level, CSR_JobPool* pPool)
+{
+    pTile->m_NewLevel        = level;
+    pTile->m_pNewHeightField = 0;
+    pTile->m_pNewMesh        = 0;
+    pTile->m_pPool           = pPool;
+    pTile->m_Busy            = 1;
+
+    csrJobInit(&pTile->m_Job, csrTiledLandscapeOnBuildTile, pTile);
+
+    // add the job
+    if (!csrJobPoolAdd(pPool, &pTile->m_Job))
+    {
+        pTile->m_Busy = 0;
+        return 0;
+    }
+
+    // already done, e.g. if no pool is used?
+    if (csrJobPoolGetState(pPool, &pTile->m_Job) == CSR_JS_Done)
+        csrTiledLandscapeCommitTile(pTile);
+
+    return 1;
+}
+//---------------------------------------------------------------------------
+void csrTiledLandscapeTileRelease(CSR_TiledLandscapeTile* pTile)
+{
+    // wait until the tile job is done
+    if (pTile->m_Busy)
+        csrJobPoolWait(pTile->m_pPool, &pTile->m_Job);
+
+    csrHeightFieldRelease(pTile->m_pNewHeightField);
+    csrHeightFieldRelease(pTile->m_pHeightField);
+    csrMeshRelease(pTile->m_pNewMesh, 0);
+    csrMeshRelease(pTile->m_pMesh, 0);
+
+    free(pTile);
+}
+//---------------------------------------------------------------------------
+CSR_TiledLandscapeTile* csrTiledLandscapeAddTile(CSR_TiledLandscape* pLandscape, size_t x, size_t z)
+{
+    CSR_TiledLandscapeTile*  pTile;
+    CSR_TiledLandscapeTile** pTiles;
+
+    // create the tile
+    pTile = (CSR_TiledLandscapeTile*)malloc(sizeof(CSR_TiledLandscapeTile));
+
+    // succeeded?
+    if (!pTile)
+        return 0;
+
+    // add it to the resident tiles
+    pTiles = (CSR_TiledLandscapeTile**)csrMemoryAlloc(pLandscape->m_pTile,
+                                                      sizeof(CSR_TiledLandscapeTile*),
+                                                      pLandscape->m_TileCount + 1);
+
+    // succeeded?
+    if (!pTiles)
+    {
+        free(pTile);
+        return 0;
+    }
+
+    pTile->m_pLandscape      = pLandscape;
+    pTile->m_X               = x;
+    pTile->m_Z               = z;
+    pTile->m_pHeightField    = 0;
+    pTile->m_pMesh           = 0;
+    pTile->m_Level           = 0;
+    pTile->m_pNewHeightField = 0;
+    pTile->m_pNewMesh        = 0;
+    pTile->m_NewLevel        = 0;
+    pTile->m_pPool           = 0;
+    pTile->m_Busy            = 0;
+
+    pTiles[pLandscape->m_TileCount] = pTile;
+    pLandscape->m_pTile             = pTiles;
+    ++pLandscape->m_TileCount;
+
+    pLandscape->m_pGrid[(z * pLandscape->m_TileCountX) + x] = pTile;
+
+    return pTile;
+}
+//---------------------------------------------------------------------------
+int csrTiledLandscapeCompareCandidates(const void* pA, const void* pB)
+{
+    const float distA = ((const CSR_TiledLandscapeCandidate*)pA)->m_Distance;
+    const float distB = ((const CSR_TiledLandscapeCandidate*)pB)->m_Distance;
+
+    if (distA < distB)
+        return -1;
+
+    return distA > distB ? 1 : 0;
+}
+//---------------------------------------------------------------------------
+const CSR_TiledLandscapeTile* csrTiledLandscapeGetTile(const CSR_TiledLandscape* pLandscape,
+                                                       const CSR_Vector3*        pPoint)
+{
+    const float tileLength = (float)pLandscape->m_TileSize * pLandscape->m_Scale;
+    float       fx;
+    float       fz;
+    size_t      x;
+    size_t      z;
+
+    // calculate the point position in the tile grid
+    fx = (pPoint->m_X - pLandscape->m_X) / tileLength;
+    fz = (pLandscape->m_Z - pPoint->m_Z) / tileLength;
+
+    // is the point outside the landscape? NOTE written to also reject the NaN values
+    if (!(fx >= 0.0f && fx <= (float)pLandscape->m_TileCountX &&
+          fz >= 0.0f && fz <= (float)pLandscape->m_TileCountZ))
+        return 0;
+
+    x = (size_t)fx;
+    z = (size_t)fz;
+
+    // a point on the last border belongs to the last tile
+    if (x >= pLandscape->m_TileCountX)
+        x = pLandscape->m_TileCountX - 1;
+
+    if (z >= pLandscape->m_TileCountZ)
+        z = pLandscape->m_TileCountZ - 1;
+
+    return pLandscape->m_pGrid[(z * pLandscape->m_TileCountX) + x];
+}
+//---------------------------------------------------------------------------
+// Tiled landscape functions
+//---------------------------------------------------------------------------
+CSR_TiledLandscape* csrTiledLandscapeCreate(      size_t                      width,
+                                                  size_t                      depth,
+                                                  float                       height,
+                                                  float                       scale,
+                                                  size_t                      tileSize,
+                                            const CSR_fOnReadLandscapeHeights fOnRead,
+                                                  void*                       pReadArg,
+                                            const CSR_VertexFormat*           pVertFormat,
+                                            const CSR_VertexCulling*          pVertCulling,
+                                            const CSR_Material*               pMaterial)
+{
+    CSR_TiledLandscape* pLandscape;
+    float               tileLength;
+
+    // validate the inputs
+    if (width < 2 || depth < 2 || height <= 0.0f || scale <= 0.0f || !fOnRead)
+        return 0;
+
+    if (!tileSize)
+        tileSize = M_CSR_TiledLandscape_Default_Tile_Size;
+
+    // create the tiled landscape
+    pLandscape = (CSR_TiledLandscape*)malloc(sizeof(CSR_TiledLandscape));
+
+    // succeeded?
+    if (!pLandscape)
+        return 0;
+
+    csrTiledLandscapeInit(pLandscape);
+
+    pLandscape->m_fOnRead    = fOnRead;
+    pLandscape->m_pReadArg   = pReadArg;
+    pLandscape->m_Width      = width;
+    pLandscape->m_Depth      = depth;
+    pLandscape->m_TileSize   = tileSize;
+    pLandscape->m_TileCountX = ((width - 1) + tileSize - 1) / tileSize;
+    pLandscape->m_TileCountZ = ((depth - 1) + tileSize - 1) / tileSize;
+    pLandscape->m_Height     = height;
+    pLandscape->m_Scale      = scale;
+
+    // calculate the landscape origin, the same way as csrLandscapeGenerateVertices() does
+    pLandscape->m_X = -(((width - 1) * scale) / 2.0f);
+    pLandscape->m_Z =  (((depth - 1) * scale) / 2.0f);
+
+    // calculate the default distances, from the tile length
+    tileLength                   = (float)tileSize * scale;
+    pLandscape->m_LoadDistance   = tileLength * 4.0f;
+    pLandscape->m_UnloadDistance = tileLength * 5.0f;
+    pLandscape->m_LODDistance    = tileLength;
+    pLandscape->m_SkirtDepth     = height;
+
+    // the last level draws each tile with a single cell
+    while (((size_t)1 << (pLandscape->m_MaxLevel + 1)) <= tileSize)
+        ++pLandscape->m_MaxLevel;
+
+    // apply the user wished vertex format
+    if (pVertFormat)
+        pLandscape->m_Format = *pVertFormat;
+
+    // apply the user wished vertex culling
+    if (pVertCulling)
+        pLandscape->m_Culling = *pVertCulling;
+
+    // apply the user wished material
+    if (pMaterial)
+        pLandscape->m_Material = *pMaterial;
+
+    // create the tile grid, which only contains the resident tiles
+    pLandscape->m_pGrid = (CSR_TiledLandscapeTile**)calloc(pLandscape->m_TileCountX * pLandscape->m_TileCountZ,
+                                                           sizeof(CSR_TiledLandscapeTile*));
+
+    // succeeded?
+    if (!pLandscape->m_pGrid)
+    {
+        csrTiledLandscapeRelease(pLandscape);
+        return 0;
+    }
+
+    return pLandscape;
+}
+//---------------------------------------------------------------------------
+void csrTiledLandscapeRelease(CSR_TiledLandscape* pLandscape)
+{
+    size_t i;
+
+    // no tiled landscape to release?
+    if (!pLandscape)
+        return;
+
+    // release the resident tiles
+    for (i = 0; i < pLandscape->m_TileCount; ++i)
+        csrTiledLandscapeTileRelease(pLandscape->m_pTile[i]);
+
+    free(pLandscape->m_pTile);
+    free(pLandscape->m_pGrid);
+
+    // free the tiled landscape
+    free(pLandscape);
+}
+//---------------------------------------------------------------------------
+void csrTiledLandscapeInit(CSR_TiledLandscape* pLandscape)
+{
+    // no tiled landscape to initialize?
+    if (!pLandscape)
+        return;
+
+    // initialize the tiled landscape
+    pLandscape->m_fOnRead        = 0;
+    pLandscape->m_pReadArg       = 0;
+    pLandscape->m_Width          = 0;
+    pLandscape->m_Depth          = 0;
+    pLandscape->m_TileSize       = 0;
+    pLandscape->m_TileCountX     = 0;
+    pLandscape->m_TileCountZ     = 0;
+    pLandscape->m_Height         = 0.0f;
+    pLandscape->m_Scale          = 0.0f;
+    pLandscape->m_X              = 0.0f;
+    pLandscape->m_Z              = 0.0f;
+    pLandscape->m_LoadDistance   = 0.0f;
+    pLandscape->m_UnloadDistance = 0.0f;
+    pLandscape->m_LODDistance    = 0.0f;
+    pLandscape->m_MaxLevel       = 0;
+    pLandscape->m_SkirtDepth     = 0.0f;
+    pLandscape->m_MaxJobs        = M_CSR_TiledLandscape_Default_Max_Jobs;
+    pLandscape->m_pGrid          = 0;
+    pLandscape->m_pTile          = 0;
+    pLandscape->m_TileCount      = 0;
+
+    // initialize the vertex format and material
+    csrVertexFormatInit(&pLandscape->m_Format);
+    csrMaterialInit(&pLandscape->m_Material);
+
+    // initialize the vertex culling, the same way as the landscape does
+    csrVertexCullingInit(&pLandscape->m_Culling);
+    pLandscape->m_Culling.m_Type = CSR_CT_None;
+    pLandscape->m_Culling.m_Face = CSR_CF_CW;
+}
+//---------------------------------------------------------------------------
+int csrTiledLandscapeReadPixelBuffer(void*  pArg,
+                                     size_t x,
+                                     size_t z,
+                                     size_t width,
+                                     size_t depth,
+                                     float* pHeights)
+{
+    const CSR_PixelBuffer* pPixelBuffer = (const CSR_PixelBuffer*)pArg;
+    const unsigned char*   pRow;
+    size_t                 i;
+    size_t                 j;
+
+    // validate the inputs
+    if (!pPixelBuffer || !pPixelBuffer->m_pData || !pHeights)
+        return 0;
+
+    // is the area outside the image?
+    if (x + width > pPixelBuffer->m_Width || z + depth > pPixelBuffer->m_Height)
+        return 0;
+
+    // read the area, the same way as csrLandscapeGenerateVertices() does
+    for (j = 0; j < depth; ++j)
+    {
+        pRow = (const unsigned char*)pPixelBuffer->m_pData + ((((z + j) * pPixelBuffer->m_Width) + x) * 3);
+
+        for (i = 0; i < width; ++i)
+            pHeights[(j * width) + i] = (float)pRow[i * 3] / 255.0f;
+    }
+
+    return 1;
+}
+//---------------------------------------------------------------------------
+void csrTiledLandscapeUpdate(      CSR_TiledLandscape* pLandscape,
+                             const CSR_Vector3*        pViewPos,
+                                   CSR_JobPool*        pPool)
+{
+    CSR_TiledLandscapeTile*      pTile;
+    CSR_TiledLandscapeCandidate* pCandidate;
+    size_t                       i;
+    size_t                       x;
+    size_t                       z;
+    size_t                       level;
+    size_t                       jobCount;
+    size_t                       candidateCount;
+    float                        tileLength;
+    float                        distance;
+    float                        fx1;
+    float                        fx2;
+    float                        fz1;
+    float                        fz2;
+    size_t                       x1;
+    size_t                       x2;
+    size_t                       z1;
+    size_t                       z2;
+
+    // validate the inputs
+    if (!pLandscape || !pLandscape->m_pGrid || !pViewPos)
+        return;
+
+    // show the tiles whose job is done
+    for (i = 0; i < pLandscape->m_TileCount; ++i)
+    {
+        pTile = pLandscape->m_pTile[i];
+
+        if (pTile->m_Busy && csrJobPoolGetState(pTile->m_pPool, &pTile->m_Job) == CSR_JS_Done)
+            csrTiledLandscapeCommitTile(pTile);
+    }
+
+    // release the far tiles. NOTE the busy tiles are kept until their job is done
+    i = pLandscape->m_TileCount;
+
+    while (i)
+    {
+        --i;
+
+        pTile = pLandscape->m_pTile[i];
+
+        if (pTile->m_Busy)
+            continue;
+
+        if (csrTiledLandscapeGetDistance(pLandscape, pTile->m_X, pTile->m_Z, pViewPos) <= pLandscape->m_UnloadDistance)
+            continue;
+
+        pLandscape->m_pGrid[(pTile->m_Z * pLandscape->m_TileCountX) + pTile->m_X] = 0;
+
+        // remove the tile from the resident tiles, the order doesn't matter
+        --pLandscape->m_TileCount;
+        pLandscape->m_pTile[i] = pLandscape->m_pTile[pLandscape->m_TileCount];
+
+        csrTiledLandscapeTileRelease(pTile);
+    }
+
+    jobCount = 0;
+
+    // count the tiles still being built
+    for (i = 0; i < pLandscape->m_TileCount; ++i)
+        if (pLandscape->m_pTile[i]->m_Busy)
+            ++jobCount;
+
+    // rebuild the tiles whose level of detail changed, or whose previous job failed
+    for (i = 0; i < pLandscape->m_TileCount && jobCount < pLandscape->m_MaxJobs; ++i)
+    {
+        pTile = pLandscape->m_pTile[i];
+
+        if (pTile->m_Busy)
+            continue;
+
+        distance = csrTiledLandscapeGetDistance(pLandscape, pTile->m_X, pTile->m_Z, pViewPos);
+        level    = csrTiledLandscapeGetLevel(pLandscape, distance);
+
+        if (pTile->m_pMesh && pTile->m_Level == level)
+            continue;
+
+        if (csrTiledLandscapeBuildTile(pTile, level, pPool))
+            ++jobCount;
+    }
+
+    // enough tiles are being built?
+    if (jobCount >= pLandscape->m_MaxJobs)
+        return;
+
+    // calculate the tile range around the point of view
+    tileLength = (float)pLandscape->m_TileSize * pLandscape->m_Scale;
+    fx1        = floorf((pViewPos->m_X - pLandscape->m_LoadDistance - pLandscape->m_X) / tileLength);
+    fx2        = floorf((pViewPos->m_X + pLandscape->m_LoadDistance - pLandscape->m_X) / tileLength);
+    fz1        = floorf((pLandscape->m_Z - pViewPos->m_Z - pLandscape->m_LoadDistance) / tileLength);
+    fz2        = floorf((pLandscape->m_Z - pViewPos->m_Z + pLandscape->m_LoadDistance) / tileLength);
+
+    // is the range outside the landscape? NOTE written to also reject the NaN values
+    if (!(fx2 >= 0.0f && fz2 >= 0.0f && fx1 < (float)pLandscape->m_TileCountX && fz1 < (float)pLandscape->m_TileCountZ))
+        return;
+
+    x1 = fx1 > 0.0f ? (size_t)fx1 : 0;
+    z1 = fz1 > 0.0f ? (size_t)fz1 : 0;
+    x2 = fx2 < (float)(pLandscape->m_TileCountX - 1) ? (size_t)fx2 : pLandscape->m_TileCountX - 1;
+    z2 = fz2 < (float)(pLandscape->m_TileCountZ - 1) ? (size_t)fz2 : pLandscape->m_TileCountZ - 1;
+
+    pCandidate = (CSR_TiledLandscapeCandidate*)malloc((x2 - x1 + 1) * (z2 - z1 + 1) * sizeof(CSR_TiledLandscapeCandidate));
+
+    // succeeded?
+    if (!pCandidate)
+        return;
+
+    candidateCount = 0;
+
+    // search for the missing tiles
+    for (z = z1; z <= z2; ++z)
+        for (x = x1; x <= x2; ++x)
+        {
+            if (pLandscape->m_pGrid[(z * pLandscape->m_TileCountX) + x])
+                continue;
+
+            distance = csrTiledLandscapeGetDistance(pLandscape, x, z, pViewPos);
+
+            if (distance > pLandscape->m_LoadDistance)
+                continue;
+
+            pCandidate[candidateCount].m_X        = x;
+            pCandidate[candidateCount].m_Z        = z;
+            pCandidate[candidateCount].m_Distance = distance;
+            ++candidateCount;
+        }
+
+    // load the nearest tiles first
+    qsort(pCandidate, candidateCount, sizeof(CSR_TiledLandscapeCandidate), csrTiledLandscapeCompareCandidates);
+
+    for (i = 0; i < candidateCount && jobCount < pLandscape->m_MaxJobs; ++i)
+    {
+        pTile = csrTiledLandscapeAddTile(pLandscape, pCandidate[i].m_X, pCandidate[i].m_Z);
+
+        // succeeded?
+        if (!pTile)
+            break;
+
+        if (csrTiledLandscapeBuildTile(pTile,
+                                       csrTiledLandscapeGetLevel(pLandscape, pCandidate[i].m_Distance),
+                                       pPool))
+            ++jobCount;
+    }
+
+    free(pCandidate);
+}
+//---------------------------------------------------------------------------
+void csrTiledLandscapeDraw(const CSR_TiledLandscape* pLandscape,
+                           const void*               pShader,
+                           const CSR_Array*          pMatrixArray,
+                           const CSR_fOnGetID        fOnGetID)
+{
+    size_t i;
+
+    // validate the input
+    if (!pLandscape)
+        return;
+
+    // draw the built tiles
+    for (i = 0; i < pLandscape->m_TileCount; ++i)
+        if (pLandscape->m_pTile[i]->m_pMesh)
+            csrDrawMesh(pLandscape->m_pTile[i]->m_pMesh, pShader, pMatrixArray, fOnGetID);
+}
+//---------------------------------------------------------------------------
+int csrTiledLandscapeGetHeight(const CSR_TiledLandscape* pLandscape,
+                               const CSR_Vector3*        pPoint,
+                                     float*              pR)
+{
+    const CSR_TiledLandscapeTile* pTile;
+
+    // validate the inputs
+    if (!pLandscape || !pLandscape->m_pGrid || !pPoint)
+        return 0;
+
+    // get the resident tile below the point
+    pTile = csrTiledLandscapeGetTile(pLandscape, pPoint);
+
+    if (!pTile)
+        return 0;
+
+    return csrHeightFieldGetHeight(pTile->m_pHeightField, pPoint, pR);
+}
+//---------------------------------------------------------------------------
+int csrTiledLandscapeGroundPosY(const CSR_Sphere*         pBoundingSphere,
+                                const CSR_TiledLandscape* pLandscape,
+                                      CSR_Polygon3*       pGroundPolygon,
+                                      float*              pR)
+{
+    const CSR_TiledLandscapeTile* pTile = 0;
+
+    // validate the inputs
+    if (!pBoundingSphere)
+        return 0;
+
+    // get the resident tile below the sphere
+    if (pLandscape && pLandscape->m_pGrid)
+        pTile = csrTiledLandscapeGetTile(pLandscape, &pBoundingSphere->m_Center);
+
+    if (!pTile || !pTile->m_pHeightField)
+    {
+        // like csrGroundPosY(), keep the sphere position if no ground was found
+        if (pR)
+            *pR = pBoundingSphere->m_Center.m_Y;
+
+        return 0;
+    }
+
+    return csrHeightFieldGroundPosY(pBoundingSphere, pTile->m_pHeightField, pGroundPolygon, pR);
+}
+//---------------------------------------------------------------------------
@@ -0,0 +1,249 @@
+/****************************************************************************
+ * ==> CSR_TiledLandscape --------------------------------------------------*
+ ****************************************************************************
+ * Description : This module provides a tiled landscape, whose tiles are    *
+ *               built around the point of view on worker threads, and      *
+ *               released when they become too far                          *
+ * Developer   : Jean-Milost Reymond                                        *
+ * Copyright   : 2017 - 2022, this file is part of the CompactStar Engine.  *
+ *               You are free to copy or redistribute this file, modify it, *
+ *               or use it for your own projects, commercial or not. This   *
+ *               file is provided "as is", WITHOUT ANY WARRANTY OF ANY      *
+ *               KIND. THE DEVELOPER IS NOT RESPONSIBLE FOR ANY DAMAGE OF   *
+ *               ANY KIND, ANY LOSS OF DATA, OR ANY LOSS OF PRODUCTIVITY    *
+ *               TIME THAT MAY RESULT FROM THE USAGE OF THIS SOURCE CODE,   *
+ *               DIRECTLY OR NOT.                                           *
+ ****************************************************************************/
+
+#ifndef CSR_TiledLandscapeH
+#define CSR_TiledLandscapeH
+
+// compactStar engine
+#include "CSR_Common.h"
+#include "CSR_Geometry.h"
+#include "CSR_Texture.h"
+#include "CSR_Vertex.h"
+#include "CSR_HeightField.h"
+#include "CSR_Job.h"
+#include "CSR_Renderer.h"
+
+//---------------------------------------------------------------------------
+// Global defines
+//---------------------------------------------------------------------------
+#define M_CSR_TiledLandscape_Default_Tile_Size 64 // cells on each tile side
+#define M_CSR_TiledLandscape_Default_Max_Jobs  4  // tiles built at the same time
+
+//---------------------------------------------------------------------------
+// Callbacks
+//---------------------------------------------------------------------------
+
+/**
+* Called when a landscape area should be read
+*@param pArg - reader argument
+*@param x - first sample column to read
+*@param z - first sample row to read
+*@param width - sample count to read on each row
+*@param depth - row count to read
+*@param[out] pHeights - heights to fill, row by row, between 0 and 1
+*@return 1 on success, otherwise 0
+*@note This function is called from the worker threads, thus it should be thread safe
+*/
+typedef int (*CSR_fOnReadLandscapeHeights)(void*  pArg,
+                                           size_t x,
+                                           size_t z,
+                                           size_t width,
+                                           size_t depth,
+                                           float* pHeights);
+
+//---------------------------------------------------------------------------
+// Structures
+//---------------------------------------------------------------------------
+
+typedef struct CSR_TiledLandscape CSR_TiledLandscape;
+
+/**
+* Tiled landscape tile
+*@note The members prefixed by m_pNew are written by the tile job, and become visible once the
+*      job is done, on the next landscape update
+*/
+typedef struct
+{
+    CSR_TiledLandscape* m_pLandscape;      // landscape owning the tile
+    size_t              m_X;               // tile column
+    size_t              m_Z;               // tile row
+    CSR_HeightField*    m_pHeightField;    // tile heights at full resolution, used for the collisions
+    CSR_Mesh*           m_pMesh;           // tile mesh to draw
+    size_t              m_Level;           // tile mesh level of detail, each level halves the resolution
+    CSR_HeightField*    m_pNewHeightField; // heights loaded by the job
+    CSR_Mesh*           m_pNewMesh;        // mesh built by the job
+    size_t              m_NewLevel;        // level of detail of the mesh to build
+    CSR_Job             m_Job;
+    CSR_JobPool*        m_pPool;           // job pool executing the job
+    int                 m_Busy;            // 1 while the job isn't done
+} CSR_TiledLandscapeTile;
+
+/**
+* Tiled landscape
+*@note The landscape has the same coordinate system as the one created by csrLandscapeCreate()
+*      from an image of the same size
+*@note The landscape properties shouldn't be changed while a tile is busy
+*/
+struct CSR_TiledLandscape
+{
+    CSR_fOnReadLandscapeHeights m_fOnRead;
+    void*                       m_pReadArg;
+    size_t                      m_Width;          // sample count on the x axis
+    size_t                      m_Depth;          // sample count on the z axis
+    size_t                      m_TileSize;       // cell count on each tile side
+    size_t                      m_TileCountX;
+    size_t                      m_TileCountZ;
+    float                       m_Height;         // landscape height
+    float                       m_Scale;          // distance between 2 neighbor samples
+    float                       m_X;              // x coordinate of the first sample column
+    float                       m_Z;              // z coordinate of the first sample row, the next rows go toward -z
+    float                       m_LoadDistance;   // the tiles closer than this distance are built
+    float                       m_UnloadDistance; // the tiles farther than this distance are released
+    float                       m_LODDistance;    // distance from which the level 1 is used, doubled for each next level
+    size_t                      m_MaxLevel;       // max level of detail
+    float                       m_SkirtDepth;     // depth of the skirts hiding the cracks between the tiles
+    size_t                      m_MaxJobs;        // max tile count built at the same time
+    CSR_VertexFormat            m_Format;
+    CSR_VertexCulling           m_Culling;
+    CSR_Material                m_Material;
+    CSR_TiledLandscapeTile**    m_pGrid;          // tile at each grid position, 0 if not resident
+    CSR_TiledLandscapeTile**    m_pTile;          // resident tiles
+    size_t                      m_TileCount;
+};
+
+#ifdef __cplusplus
+    extern "C"
+    {
+#endif
+        //-------------------------------------------------------------------
+        // Tiled landscape functions
+        //-------------------------------------------------------------------
+
+        /**
+        * Creates a tiled landscape
+        *@param width - sample count on the x axis
+        *@param depth - sample count on the z axis
+        *@param height - landscape height
+        *@param scale - scale factor
+        *@param tileSize - cell count on each tile side, should be a power of 2. If 0, a default size is used
+        *@param fOnRead - function to call to read the landscape samples
+        *@param pReadArg - argument to pass to the read function
+        *@param pVertFormat - model vertex format, if 0 the default format will be used
+        *@param pVertCulling - model vertex culling, if 0 the default culling will be used
+        *@param pMaterial - mesh material, if 0 the default material will be used
+        *@return newly created tiled landscape, 0 on error
+        *@note No tile is built before the first update, see csrTiledLandscapeUpdate()
+        *@note The tiled landscape must be released when no longer used, see csrTiledLandscapeRelease()
+        */
+        CSR_TiledLandscape* csrTiledLandscapeCreate(      size_t                      width,
+                                                          size_t                      depth,
+                                                          float                       height,
+                                                          float                       scale,
+                                                          size_t                      tileSize,
+                                                    const CSR_fOnReadLandscapeHeights fOnRead,
+                                                          void*                       pReadArg,
+                                                    const CSR_VertexFormat*           pVertFormat,
+                                                    const CSR_VertexCulling*          pVertCulling,
+                                                    const CSR_Material*               pMaterial);
+
+        /**
+        * Releases a tiled landscape, waits until all its tiles are built
+        *@param[in, out] pLandscape - tiled landscape to release
+        */
+        void csrTiledLandscapeRelease(CSR_TiledLandscape* pLandscape);
+
+        /**
+        * Initializes a tiled landscape structure
+        *@param[in, out] pLandscape - tiled landscape to initialize
+        */
+        void csrTiledLandscapeInit(CSR_TiledLandscape* pLandscape);
+
+        /**
+        * Reads the landscape samples from a grayscale image
+        *@param pArg - pixel buffer containing the landscape map image
+        *@param x - first sample column to read
+        *@param z - first sample row to read
+        *@param width - sample count to read on each row
+        *@param depth - row count to read
+        *@param[out] pHeights - heights to fill, row by row, between 0 and 1
+        *@return 1 on success, otherwise 0
+        *@note This function may be used as landscape read function, the image should remain valid
+        *      while the landscape is used
+        */
+        int csrTiledLandscapeReadPixelBuffer(void*  pArg,
+                                             size_t x,
+                                             size_t z,
+                                             size_t width,
+                                             size_t depth,
+                                             float* pHeights);
+
+        /**
+        * Updates the tiles around the point of view
+        *@param[in, out] pLandscape - tiled landscape to update
+        *@param pViewPos - point of view position, in the landscape coordinate system
+        *@param pPool - job pool on which the tiles are built, if 0 they are built in the calling thread
+        *@note The built tiles are added, the far tiles are released and the tiles whose level of
+        *      detail changed are rebuilt. A tile remains drawn with its previous mesh until the new
+        *      one is built
+        */
+        void csrTiledLandscapeUpdate(      CSR_TiledLandscape* pLandscape,
+                                     const CSR_Vector3*        pViewPos,
+                                           CSR_JobPool*        pPool);
+
+        /**
+        * Draws the resident tiles
+        *@param pLandscape - tiled landscape to draw
+        *@param pShader - shader to use to draw the tiles
+        *@param pMatrixArray - matrices to use, see csrDrawMesh()
+        *@param fOnGetID - function to call to get an OpenGL identifier matching with a key
+        *@note Each tile mesh has its own skin, thus fOnGetID should resolve the tile skin keys to
+        *      the landscape textures
+        */
+        void csrTiledLandscapeDraw(const CSR_TiledLandscape* pLandscape,
+                                   const void*               pShader,
+                                   const CSR_Array*          pMatrixArray,
+                                   const CSR_fOnGetID        fOnGetID);
+
+        /**
+        * Gets the ground height below or above a point
+        *@param pLandscape - tiled landscape
+        *@param pPoint - point, only the x and z coordinates are used
+        *@param[out] pR - ground height
+        *@return 1 if the point is above a resident tile, otherwise 0
+        */
+        int csrTiledLandscapeGetHeight(const CSR_TiledLandscape* pLandscape,
+                                       const CSR_Vector3*        pPoint,
+                                             float*              pR);
+
+        /**
+        * Calculates the y axis position where to place the point of view to stay above the ground
+        *@param pBoundingSphere - sphere surrounding the point of view or model
+        *@param pLandscape - tiled landscape
+        *@param[out] pGroundPolygon - polygon on which the ground was hit, ignored if 0
+        *@param[out] pR - resulting position on the y axis where to place the point of view or model
+        *@return 1 if the sphere is above a resident tile, otherwise 0
+        *@note See csrHeightFieldGroundPosY()
+        */
+        int csrTiledLandscapeGroundPosY(const CSR_Sphere*         pBoundingSphere,
+                                        const CSR_TiledLandscape* pLandscape,
+                                              CSR_Polygon3*       pGroundPolygon,
+                                              float*              pR);
+
+#ifdef __cplusplus
+    }
+#endif
+
+//---------------------------------------------------------------------------
+// Compiler
+//---------------------------------------------------------------------------
+
+// needed in mobile c compiler to link the .h file with the .c
+#if defined(_OS_IOS_) || defined(_OS_ANDROID_) || defined(_OS_WINDOWS_)
+    #include "CSR_TiledLandscape.c"
+#endif
+
+#endif
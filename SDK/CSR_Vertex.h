@@ -55,7 +55,8 @@ typedef enum
     CSR_VT_TriangleStrip,
     CSR_VT_TriangleFan,
     CSR_VT_Quads,
-    CSR_VT_QuadStrip
+    CSR_VT_QuadStrip,
+    CSR_VT_Lines
 } CSR_EVertexType;
 
 //---------------------------------------------------------------------------
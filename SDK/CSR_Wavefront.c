@@ -26,6 +26,550 @@
     #include <math.h>
 #endif
 
+//------------------------------------------------------------------------------
+// Global defines
+//------------------------------------------------------------------------------
+#define M_CSR_WaveFront_Min_Chunk_Size (256 * 1024) // smallest chunk parsed by a job, in bytes
+#define M_CSR_WaveFront_Min_Capacity   64           // initial capacity of the growable arrays
+#define M_CSR_WaveFront_Max_Digits     15           // max significant digits converted exactly by the fast parser
+#define M_CSR_WaveFront_Max_Decimals   22           // max decimals for which the power of 10 is exact
+#define M_CSR_WaveFront_Max_Token      256          // max chars converted by the slow path, as the original reader
+
+//------------------------------------------------------------------------------
+// Private structures
+//------------------------------------------------------------------------------
+
+/**
+* Growable array, its capacity grows geometrically
+*/
+typedef struct
+{
+    void*  m_pData;
+    size_t m_Count;
+    size_t m_Capacity;
+} CSR_WavefrontArray;
+
+/**
+* Face read in a chunk
+*/
+typedef struct
+{
+    size_t m_Start;          // first face index in the chunk index array
+    size_t m_Count;          // face index count
+    size_t m_VertexCount;    // vertex values read in the chunk before the face
+    size_t m_NormalCount;    // normal values read in the chunk before the face
+    size_t m_UVCount;        // texture coordinate values read in the chunk before the face
+    int    m_ObjectChanging; // 1 if an object begins, 0 if not, -1 if it depends on the previous chunks
+} CSR_WavefrontChunkFace;
+
+/**
+* Chunk, i.e. a set of whole lines which may be parsed independently
+*/
+typedef struct
+{
+    const char*        m_pStart;
+    const char*        m_pEnd;
+    CSR_WavefrontArray m_Vertex;         // float array
+    CSR_WavefrontArray m_Normal;         // float array
+    CSR_WavefrontArray m_UV;             // float array
+    CSR_WavefrontArray m_Index;          // int array
+    CSR_WavefrontArray m_Face;           // CSR_WavefrontChunkFace array
+    size_t             m_VertexOffset;   // vertex values read in the previous chunks
+    size_t             m_NormalOffset;   // normal values read in the previous chunks
+    size_t             m_UVOffset;       // texture coordinate values read in the previous chunks
+    int                m_ObjectChanging; // state at the chunk end, -1 if the chunk doesn't change it
+    int                m_Success;
+} CSR_WavefrontChunk;
+
+/**
+* Number being read, the chars are fed one by one, as atof() and atoi() would read them
+*/
+typedef struct
+{
+    const char* m_pStart;   // first char of the token in the source
+    size_t      m_Length;   // kept chars count
+    double      m_Mantissa; // significant digits, exact while m_Digits <= M_CSR_WaveFront_Max_Digits
+    unsigned    m_Integer;  // digits, as an integer
+    size_t      m_Digits;   // significant digit count
+    size_t      m_Decimals; // digit count after the dot
+    int         m_HasDigit;
+    int         m_HasDot;
+    int         m_Negative;
+    int         m_Stopped;  // if 1, the next chars are ignored, as the conversion would stop here
+} CSR_WavefrontNumber;
+
+//------------------------------------------------------------------------------
+// WaveFront private functions
+//------------------------------------------------------------------------------
+void* csrWaveFrontArrayPush(CSR_WavefrontArray* pArray, size_t itemSize)
+{
+    size_t capacity;
+    void*  pData;
+
+    // no more room? Double the capacity, thus the copies are amortized
+    if (pArray->m_Count >= pArray->m_Capacity)
+    {
+        capacity = pArray->m_Capacity ? pArray->m_Capacity * 2 : M_CSR_WaveFront_Min_Capacity;
+        pData    = csrMemoryAlloc(pArray->m_pData, itemSize, capacity);
+
+        // succeeded?
+        if (!pData)
+            return 0;
+
+        pArray->m_pData    = pData;
+        pArray->m_Capacity = capacity;
+    }
+
+    return (char*)pArray->m_pData + (pArray->m_Count++ * itemSize);
+}
+//---------------------------------------------------------------------------
+void csrWaveFrontArrayRelease(CSR_WavefrontArray* pArray)
+{
+    if (pArray->m_pData)
+        free(pArray->m_pData);
+
+    pArray->m_pData    = 0;
+    pArray->m_Count    = 0;
+    pArray->m_Capacity = 0;
+}
+//---------------------------------------------------------------------------
+static inline void csrWaveFrontNumberBegin(CSR_WavefrontNumber* pNumber)
+{
+    pNumber->m_pStart   = 0;
+    pNumber->m_Length   = 0;
+    pNumber->m_Mantissa = 0.0;
+    pNumber->m_Integer  = 0;
+    pNumber->m_Digits   = 0;
+    pNumber->m_Decimals = 0;
+    pNumber->m_HasDigit = 0;
+    pNumber->m_HasDot   = 0;
+    pNumber->m_Negative = 0;
+    pNumber->m_Stopped  = 0;
+}
+//---------------------------------------------------------------------------
+static inline void csrWaveFrontNumberFeed(CSR_WavefrontNumber* pNumber, const char* pChar)
+{
+    if (!pNumber->m_Length)
+        pNumber->m_pStart = pChar;
+
+    ++pNumber->m_Length;
+
+    // the conversion already stopped on a previous char?
+    if (pNumber->m_Stopped)
+        return;
+
+    // digit? (tested first, as it's the most frequent char)
+    if (*pChar >= '0' && *pChar <= '9')
+    {
+        pNumber->m_HasDigit = 1;
+        pNumber->m_Integer  = (pNumber->m_Integer * 10) + (unsigned)(*pChar - '0');
+
+        // the leading zeros aren't significant
+        if (pNumber->m_Digits || *pChar != '0')
+        {
+            if (pNumber->m_Digits < M_CSR_WaveFront_Max_Digits)
+                pNumber->m_Mantissa = (pNumber->m_Mantissa * 10.0) + (double)(*pChar - '0');
+
+            ++pNumber->m_Digits;
+        }
+
+        if (pNumber->m_HasDot)
+            ++pNumber->m_Decimals;
+
+        return;
+    }
+
+    // a sign is only allowed before the number
+    if (*pChar == '-')
+    {
+        if (pNumber->m_HasDigit || pNumber->m_HasDot || pNumber->m_Negative)
+            pNumber->m_Stopped = 1;
+        else
+            pNumber->m_Negative = 1;
+
+        return;
+    }
+
+    // only one dot is allowed
+    if (pNumber->m_HasDot)
+        pNumber->m_Stopped = 1;
+    else
+        pNumber->m_HasDot = 1;
+}
+//---------------------------------------------------------------------------
+float csrWaveFrontNumberToFloat(const CSR_WavefrontNumber* pNumber)
+{
+    static const double pow10[M_CSR_WaveFront_Max_Decimals + 1] =
+    {
+        1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+
+    #ifdef _MSC_VER
+        char        token[M_CSR_WaveFront_Max_Token] = {0};
+        const char* pChar;
+        size_t      length;
+        size_t      i;
+        double      value;
+    #else
+        char        token[M_CSR_WaveFront_Max_Token];
+        const char* pChar;
+        size_t      length;
+        size_t      i;
+        double      value;
+    #endif
+
+    // nothing was converted? (NOTE in this case atof() returns a positive zero, even after a sign)
+    if (!pNumber->m_HasDigit)
+        return 0.0f;
+
+    // the mantissa and the power of 10 are both exact, thus their quotient is correctly rounded, as
+    // the atof() result would be
+    if (pNumber->m_Digits <= M_CSR_WaveFront_Max_Digits && pNumber->m_Decimals <= M_CSR_WaveFront_Max_Decimals)
+    {
+        value = pNumber->m_Mantissa / pow10[pNumber->m_Decimals];
+        return (float)(pNumber->m_Negative ? -value : value);
+    }
+
+    // too many digits, copy the kept chars and let the library convert them
+    length = 0;
+
+    for (pChar = pNumber->m_pStart, i = 0; i < pNumber->m_Length && length < sizeof(token) - 1; ++pChar)
+        if ((*pChar >= '0' && *pChar <= '9') || *pChar == '-' || *pChar == '.')
+        {
+            token[length++] = *pChar;
+            ++i;
+        }
+
+    token[length] = '\0';
+
+    return (float)atof(token);
+}
+//---------------------------------------------------------------------------
+int csrWaveFrontNumberToInt(const CSR_WavefrontNumber* pNumber)
+{
+    return pNumber->m_Negative ? -(int)pNumber->m_Integer : (int)pNumber->m_Integer;
+}
+//---------------------------------------------------------------------------
+const char* csrWaveFrontParseFloats(const char*         pChar,
+                                    const char*         pEnd,
+                                    CSR_WavefrontArray* pArray,
+                                    int*                pSuccess)
+{
+    CSR_WavefrontNumber number;
+    float*              pValue;
+
+    csrWaveFrontNumberBegin(&number);
+
+    // read the line. NOTE the last value is dropped if the file doesn't end with a line break,
+    // as the original reader did
+    for (; pChar < pEnd; ++pChar)
+        switch (*pChar)
+        {
+            case '\r':
+            case '\n':
+            case ' ':
+                // something to convert?
+                if (number.m_Length)
+                {
+                    pValue = (float*)csrWaveFrontArrayPush(pArray, sizeof(float));
+
+                    // succeeded?
+                    if (!pValue)
+                    {
+                        *pSuccess = 0;
+                        return pEnd;
+                    }
+
+                    *pValue = csrWaveFrontNumberToFloat(&number);
+                    csrWaveFrontNumberBegin(&number);
+                }
+
+                // end of line?
+                if (*pChar != ' ')
+                    return pChar;
+
+                break;
+
+            default:
+                // keep only numeric values
+                if ((*pChar >= '0' && *pChar <= '9') || *pChar == '-' || *pChar == '.')
+                    csrWaveFrontNumberFeed(&number, pChar);
+
+                break;
+        }
+
+    return pChar;
+}
+//---------------------------------------------------------------------------
+const char* csrWaveFrontParseInts(const char*         pChar,
+                                  const char*         pEnd,
+                                  CSR_WavefrontArray* pArray,
+                                  int*                pSuccess)
+{
+    CSR_WavefrontNumber number;
+    int*                pValue;
+
+    csrWaveFrontNumberBegin(&number);
+
+    // read the line
+    for (; pChar < pEnd; ++pChar)
+        switch (*pChar)
+        {
+            case '\r':
+            case '\n':
+            case ' ':
+            case '/':
+                // something to convert?
+                if (number.m_Length)
+                {
+                    pValue = (int*)csrWaveFrontArrayPush(pArray, sizeof(int));
+
+                    // succeeded?
+                    if (!pValue)
+                    {
+                        *pSuccess = 0;
+                        return pEnd;
+                    }
+
+                    *pValue = csrWaveFrontNumberToInt(&number);
+                    csrWaveFrontNumberBegin(&number);
+                }
+
+                // end of line?
+                if (*pChar == '\r' || *pChar == '\n')
+                    return pChar;
+
+                break;
+
+            default:
+                // keep only numeric values
+                if ((*pChar >= '0' && *pChar <= '9') || *pChar == '-')
+                    csrWaveFrontNumberFeed(&number, pChar);
+
+                break;
+        }
+
+    return pChar;
+}
+//---------------------------------------------------------------------------
+void csrWaveFrontParseChunk(CSR_WavefrontChunk* pChunk)
+{
+    const char*             pChar;
+    const char*             pEnd;
+    CSR_WavefrontChunkFace* pFace;
+    size_t                  start;
+
+    pChar                    = pChunk->m_pStart;
+    pEnd                     = pChunk->m_pEnd;
+    pChunk->m_ObjectChanging = -1;
+    pChunk->m_Success        = 1;
+
+    // iterate through the lines
+    while (pChar < pEnd && pChunk->m_Success)
+    {
+        switch (*pChar)
+        {
+            case 'v':
+                // a new vertex is read, thus the next face no longer begins an object
+                pChunk->m_ObjectChanging = 0;
+
+                // line contains a normal
+                if (pChar + 1 < pEnd && pChar[1] == 'n')
+                {
+                    pChar = csrWaveFrontParseFloats(pChar + 1, pEnd, &pChunk->m_Normal, &pChunk->m_Success);
+                    break;
+                }
+
+                // line contains a texture coordinate
+                if (pChar + 1 < pEnd && pChar[1] == 't')
+                {
+                    pChar = csrWaveFrontParseFloats(pChar + 1, pEnd, &pChunk->m_UV, &pChunk->m_Success);
+                    break;
+                }
+
+                // line contains a vertex
+                pChar = csrWaveFrontParseFloats(pChar, pEnd, &pChunk->m_Vertex, &pChunk->m_Success);
+                break;
+
+            case 'f':
+                start = pChunk->m_Index.m_Count;
+
+                // line contains a face
+                pChar = csrWaveFrontParseInts(pChar, pEnd, &pChunk->m_Index, &pChunk->m_Success);
+
+                pFace = (CSR_WavefrontChunkFace*)csrWaveFrontArrayPush(&pChunk->m_Face,
+                                                                       sizeof(CSR_WavefrontChunkFace));
+
+                // succeeded?
+                if (!pFace)
+                {
+                    pChunk->m_Success = 0;
+                    return;
+                }
+
+                // keep the state required to build the face once all the chunks are read
+                pFace->m_Start          = start;
+                pFace->m_Count          = pChunk->m_Index.m_Count - start;
+                pFace->m_VertexCount    = pChunk->m_Vertex.m_Count;
+                pFace->m_NormalCount    = pChunk->m_Normal.m_Count;
+                pFace->m_UVCount        = pChunk->m_UV.m_Count;
+                pFace->m_ObjectChanging = pChunk->m_ObjectChanging;
+                break;
+
+            case 'o':
+                // line contains an object
+                pChunk->m_ObjectChanging = 1;
+
+                // skip the line (NOTE the comments, groups and unknown lines are skipped the same way)
+            default:
+                while (pChar < pEnd && *pChar != '\r' && *pChar != '\n')
+                    ++pChar;
+
+                break;
+        }
+
+        // go to next line
+        ++pChar;
+    }
+}
+//---------------------------------------------------------------------------
+void csrWaveFrontParseChunkIndex(void* pArg, size_t index)
+{
+    csrWaveFrontParseChunk(&((CSR_WavefrontChunk*)pArg)[index]);
+}
+//---------------------------------------------------------------------------
+int csrWaveFrontMergeChunks(CSR_WavefrontChunk*    pChunks,
+                            size_t                 chunkCount,
+                            CSR_WavefrontVertex*   pVertex,
+                            CSR_WavefrontNormal*   pNormal,
+                            CSR_WavefrontTexCoord* pUV)
+{
+    size_t i;
+
+    // calculate the offset of each chunk in the merged arrays
+    for (i = 0; i < chunkCount; ++i)
+    {
+        pChunks[i].m_VertexOffset = pVertex->m_Count;
+        pChunks[i].m_NormalOffset = pNormal->m_Count;
+        pChunks[i].m_UVOffset     = pUV->m_Count;
+
+        pVertex->m_Count += pChunks[i].m_Vertex.m_Count;
+        pNormal->m_Count += pChunks[i].m_Normal.m_Count;
+        pUV->m_Count     += pChunks[i].m_UV.m_Count;
+    }
+
+    // only one chunk? Just take its arrays
+    if (chunkCount == 1)
+    {
+        pVertex->m_pData = (float*)pChunks[0].m_Vertex.m_pData;
+        pNormal->m_pData = (float*)pChunks[0].m_Normal.m_pData;
+        pUV->m_pData     = (float*)pChunks[0].m_UV.m_pData;
+
+        pChunks[0].m_Vertex.m_pData = 0;
+        pChunks[0].m_Normal.m_pData = 0;
+        pChunks[0].m_UV.m_pData     = 0;
+
+        return 1;
+    }
+
+    pVertex->m_pData = (float*)malloc((pVertex->m_Count + 1) * sizeof(float));
+    pNormal->m_pData = (float*)malloc((pNormal->m_Count + 1) * sizeof(float));
+    pUV->m_pData     = (float*)malloc((pUV->m_Count     + 1) * sizeof(float));
+
+    // succeeded?
+    if (!pVertex->m_pData || !pNormal->m_pData || !pUV->m_pData)
+        return 0;
+
+    // copy the chunk values
+    for (i = 0; i < chunkCount; ++i)
+    {
+        if (pChunks[i].m_Vertex.m_Count)
+            memcpy(pVertex->m_pData + pChunks[i].m_VertexOffset,
+                   pChunks[i].m_Vertex.m_pData,
+                   pChunks[i].m_Vertex.m_Count * sizeof(float));
+
+        if (pChunks[i].m_Normal.m_Count)
+            memcpy(pNormal->m_pData + pChunks[i].m_NormalOffset,
+                   pChunks[i].m_Normal.m_pData,
+                   pChunks[i].m_Normal.m_Count * sizeof(float));
+
+        if (pChunks[i].m_UV.m_Count)
+            memcpy(pUV->m_pData + pChunks[i].m_UVOffset,
+                   pChunks[i].m_UV.m_pData,
+                   pChunks[i].m_UV.m_Count * sizeof(float));
+    }
+
+    return 1;
+}
+//---------------------------------------------------------------------------
+int csrWaveFrontBuildChunks(const CSR_WavefrontChunk*    pChunks,
+                                  size_t                 chunkCount,
+                            const CSR_WavefrontVertex*   pVertex,
+                            const CSR_WavefrontNormal*   pNormal,
+                            const CSR_WavefrontTexCoord* pUV,
+                            const CSR_VertexFormat*      pVertFormat,
+                            const CSR_VertexCulling*     pVertCulling,
+                            const CSR_Material*          pMaterial,
+                                  CSR_Model*             pModel,
+                            const CSR_fOnGetVertexColor  fOnGetVertexColor,
+                            const CSR_fOnApplySkin       fOnApplySkin)
+{
+    size_t                        i;
+    size_t                        j;
+    int                           objectChanging;
+    const CSR_WavefrontChunkFace* pChunkFace;
+    CSR_WavefrontVertex           vertex;
+    CSR_WavefrontNormal           normal;
+    CSR_WavefrontTexCoord         uv;
+    CSR_WavefrontFace             face;
+
+    objectChanging = 0;
+
+    // build the faces in the file order, the values read until each face are visible to it, as
+    // they were while the file was read line by line
+    for (i = 0; i < chunkCount; ++i)
+    {
+        for (j = 0; j < pChunks[i].m_Face.m_Count; ++j)
+        {
+            pChunkFace = &((const CSR_WavefrontChunkFace*)pChunks[i].m_Face.m_pData)[j];
+
+            // the object state may depend on the previous chunks
+            if (pChunkFace->m_ObjectChanging >= 0)
+                objectChanging = pChunkFace->m_ObjectChanging;
+
+            vertex.m_pData = pVertex->m_pData;
+            vertex.m_Count = pChunks[i].m_VertexOffset + pChunkFace->m_VertexCount;
+            normal.m_pData = pNormal->m_pData;
+            normal.m_Count = pChunks[i].m_NormalOffset + pChunkFace->m_NormalCount;
+            uv.m_pData     = pUV->m_pData;
+            uv.m_Count     = pChunks[i].m_UVOffset     + pChunkFace->m_UVCount;
+            face.m_pData   = (int*)pChunks[i].m_Index.m_pData + pChunkFace->m_Start;
+            face.m_Count   = pChunkFace->m_Count;
+
+            // build the face
+            if (!csrWaveFrontBuildFace(&vertex,
+                                       &normal,
+                                       &uv,
+                                       &face,
+                                       pVertFormat,
+                                       pVertCulling,
+                                       pMaterial,
+                                       objectChanging,
+                                       0,
+                                       pModel,
+                                       fOnGetVertexColor,
+                                       fOnApplySkin))
+                return 0;
+        }
+
+        // keep the object state for the next chunks
+        if (pChunks[i].m_ObjectChanging >= 0)
+            objectChanging = pChunks[i].m_ObjectChanging;
+    }
+
+    return 1;
+}
 //------------------------------------------------------------------------------
 // WaveFront functions
 //------------------------------------------------------------------------------
@@ -37,15 +581,37 @@ CSR_Model* csrWaveFrontCreate(const CSR_Buffer*           pBuffer,
                               const CSR_fOnApplySkin      fOnApplySkin,
                               const CSR_fOnDeleteTexture  fOnDeleteTexture)
 {
-    size_t                 i;
-    int                    objectChanging;
-    int                    groupChanging;
-    char                   ch;
-    CSR_WavefrontVertex*   pVertex;
-    CSR_WavefrontNormal*   pNormal;
-    CSR_WavefrontTexCoord* pUV;
-    CSR_WavefrontFace*     pFace;
-    CSR_Model*             pModel;
+    return csrWaveFrontCreateParallel(pBuffer,
+                                      pVertFormat,
+                                      pVertCulling,
+                                      pMaterial,
+                                      fOnGetVertexColor,
+                                      fOnApplySkin,
+                                      fOnDeleteTexture,
+                                      0);
+}
+//------------------------------------------------------------------------------
+CSR_Model* csrWaveFrontCreateParallel(const CSR_Buffer*           pBuffer,
+                                      const CSR_VertexFormat*     pVertFormat,
+                                      const CSR_VertexCulling*    pVertCulling,
+                                      const CSR_Material*         pMaterial,
+                                      const CSR_fOnGetVertexColor fOnGetVertexColor,
+                                      const CSR_fOnApplySkin      fOnApplySkin,
+                                      const CSR_fOnDeleteTexture  fOnDeleteTexture,
+                                            CSR_JobPool*          pPool)
+{
+    size_t                i;
+    size_t                chunkCount;
+    size_t                maxChunkCount;
+    int                   success;
+    const char*           pStart;
+    const char*           pEnd;
+    const char*           pSplit;
+    CSR_WavefrontChunk*   pChunks;
+    CSR_WavefrontVertex   vertex;
+    CSR_WavefrontNormal   normal;
+    CSR_WavefrontTexCoord uv;
+    CSR_Model*            pModel;
 
     // validate the input
     if (!pBuffer)
@@ -58,144 +624,113 @@ CSR_Model* csrWaveFrontCreate(const CSR_Buffer*           pBuffer,
     if (!pModel)
         return 0;
 
-    pVertex = (CSR_WavefrontVertex*)  malloc(sizeof(CSR_WavefrontVertex));
-    pNormal = (CSR_WavefrontNormal*)  malloc(sizeof(CSR_WavefrontNormal));
-    pUV     = (CSR_WavefrontTexCoord*)malloc(sizeof(CSR_WavefrontTexCoord));
-    pFace   = (CSR_WavefrontFace*)    malloc(sizeof(CSR_WavefrontFace));
+    // nothing to read?
+    if (!pBuffer->m_pData || !pBuffer->m_Length)
+        return pModel;
 
-    // validate the pointers
-    if (!pVertex || !pNormal || !pUV || !pFace)
-        return 0;
+    chunkCount = 1;
 
-    pVertex->m_pData = 0;
-    pVertex->m_Count = 0;
-    pNormal->m_pData = 0;
-    pNormal->m_Count = 0;
-    pUV->m_pData     = 0;
-    pUV->m_Count     = 0;
-    pFace->m_pData   = 0;
-    pFace->m_Count   = 0;
-    objectChanging   = 0;
-    groupChanging    = 0;
-
-    // iterate through wavefront chars
-    for (i = 0; i < pBuffer->m_Length; ++i)
+    // split the file in several chunks, if they may be read in parallel
+    if (pPool)
     {
-        // get the next char
-        ch = ((char*)pBuffer->m_pData)[i];
+        chunkCount    = pBuffer->m_Length / M_CSR_WaveFront_Min_Chunk_Size;
+        maxChunkCount = (pPool->m_ThreadCount + 1) * 4;
 
-        // dispatch char
-        switch (ch)
-        {
-            // found commented line
-            case '#':
-                csrWaveFrontReadComment(pBuffer, &ch, &i);
-                continue;
+        if (chunkCount > maxChunkCount)
+            chunkCount = maxChunkCount;
 
-            case 'v':
-                // do begin to read a new wavefront object or group?
-                if (objectChanging || groupChanging)
-                {
-                    objectChanging = 0;
-                    groupChanging  = 0;
-                }
+        if (!chunkCount)
+            chunkCount = 1;
+    }
 
-                // check if line contains a normal or a texture coordinate
-                if (i + 1 < pBuffer->m_Length)
-                {
-                    // line contains a normal
-                    if (((char*)pBuffer->m_pData)[i + 1] == 'n')
-                    {
-                        ++i;
-                        csrWaveFrontReadNormal(pBuffer, &ch, &i, pNormal);
-                        continue;
-                    }
+    pChunks = (CSR_WavefrontChunk*)malloc(chunkCount * sizeof(CSR_WavefrontChunk));
 
-                    // line contains a texture coordinate
-                    if (((char*)pBuffer->m_pData)[i + 1] == 't')
-                    {
-                        ++i;
-                        csrWaveFrontReadTextureCoordinate(pBuffer, &ch, &i, pUV);
-                        continue;
-                    }
-                }
+    // succeeded?
+    if (!pChunks)
+    {
+        csrModelRelease(pModel, fOnDeleteTexture);
+        return 0;
+    }
 
-                // line contains a vertex
-                csrWaveFrontReadVertex(pBuffer, &ch, &i, pVertex);
-                continue;
+    memset(pChunks, 0x0, chunkCount * sizeof(CSR_WavefrontChunk));
 
-            case 'f':
-                // line contains a face
-                csrWaveFrontReadFace(pBuffer, &ch, &i, pFace);
-
-                // build the face
-                if (!csrWaveFrontBuildFace(pVertex,
-                                           pNormal,
-                                           pUV,
-                                           pFace,
-                                           pVertFormat,
-                                           pVertCulling,
-                                           pMaterial,
-                                           objectChanging,
-                                           0,
-                                           pModel,
-                                           fOnGetVertexColor,
-                                           fOnApplySkin))
-                {
-                    // free the model
-                    csrModelRelease(pModel, fOnDeleteTexture);
-
-                    // free the local buffers
-                    free(pVertex->m_pData);
-                    free(pNormal->m_pData);
-                    free(pUV->m_pData);
-                    free(pFace->m_pData);
-                    free(pVertex);
-                    free(pNormal);
-                    free(pUV);
-                    free(pFace);
-
-                    return 0;
-                }
+    pStart = (const char*)pBuffer->m_pData;
+    pEnd   = pStart + pBuffer->m_Length;
 
-                // free the local face buffer
-                free(pFace->m_pData);
+    // each chunk should begin on a line start
+    for (i = 0; i < chunkCount; ++i)
+    {
+        pChunks[i].m_pStart = i ? pChunks[i - 1].m_pEnd : pStart;
 
-                // reset the values
-                pFace->m_pData = 0;
-                pFace->m_Count = 0;
+        // last chunk?
+        if (i == chunkCount - 1)
+        {
+            pChunks[i].m_pEnd = pEnd;
+            break;
+        }
 
-                groupChanging = 1;
-                continue;
+        pSplit = pStart + ((pBuffer->m_Length / chunkCount) * (i + 1));
 
-            case 'o':
-                // line contains an object
-                csrWaveFrontReadUnknown(pBuffer, &ch, &i);
-                objectChanging = 1;
-                continue;
+        if (pSplit < pChunks[i].m_pStart)
+            pSplit = pChunks[i].m_pStart;
 
-            case 'g':
-                // line contains a polygon group
-                csrWaveFrontReadUnknown(pBuffer, &ch, &i);
-                groupChanging = 1;
-                continue;
+        // search for the next line break
+        while (pSplit < pEnd && *pSplit != '\r' && *pSplit != '\n')
+            ++pSplit;
 
-            default:
-                // unknown line, skip it
-                csrWaveFrontReadUnknown(pBuffer, &ch, &i);
-                continue;
-        }
+        pChunks[i].m_pEnd = (pSplit < pEnd) ? pSplit + 1 : pEnd;
     }
 
+    // read the chunks
+    csrJobPoolParallelFor(pPool, chunkCount, csrWaveFrontParseChunkIndex, pChunks);
+
+    success = 1;
+
+    for (i = 0; i < chunkCount; ++i)
+        success = success && pChunks[i].m_Success;
+
+    vertex.m_pData = 0;
+    vertex.m_Count = 0;
+    normal.m_pData = 0;
+    normal.m_Count = 0;
+    uv.m_pData     = 0;
+    uv.m_Count     = 0;
+
+    // merge the chunk values, and build the model
+    success = success && csrWaveFrontMergeChunks(pChunks, chunkCount, &vertex, &normal, &uv);
+    success = success && csrWaveFrontBuildChunks(pChunks,
+                                                 chunkCount,
+                                                 &vertex,
+                                                 &normal,
+                                                 &uv,
+                                                 pVertFormat,
+                                                 pVertCulling,
+                                                 pMaterial,
+                                                 pModel,
+                                                 fOnGetVertexColor,
+                                                 fOnApplySkin);
+
     // free the local buffers
-    free(pVertex->m_pData);
-    free(pNormal->m_pData);
-    free(pUV->m_pData);
-    free(pFace->m_pData);
-    free(pVertex);
-    free(pNormal);
-    free(pUV);
-    free(pFace);
+    for (i = 0; i < chunkCount; ++i)
+    {
+        csrWaveFrontArrayRelease(&pChunks[i].m_Vertex);
+        csrWaveFrontArrayRelease(&pChunks[i].m_Normal);
+        csrWaveFrontArrayRelease(&pChunks[i].m_UV);
+        csrWaveFrontArrayRelease(&pChunks[i].m_Index);
+        csrWaveFrontArrayRelease(&pChunks[i].m_Face);
+    }
+
+    free(pChunks);
+    free(vertex.m_pData);
+    free(normal.m_pData);
+    free(uv.m_pData);
+
+    // failed?
+    if (!success)
+    {
+        csrModelRelease(pModel, fOnDeleteTexture);
+        return 0;
+    }
 
     return pModel;
 }
@@ -212,7 +747,7 @@ CSR_Model* csrWaveFrontOpen(const char*                 pFileName,
     CSR_Model*  pModel;
 
     // open the model file
-    pBuffer = csrFileOpen(pFileName);
+    pBuffer = csrFileMap(pFileName);
 
     // succeeded?
     if (!pBuffer || !pBuffer->m_Length)
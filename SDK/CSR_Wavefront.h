@@ -22,6 +22,7 @@
 #include "CSR_Texture.h"
 #include "CSR_Vertex.h"
 #include "CSR_Model.h"
+#include "CSR_Job.h"
 
 //---------------------------------------------------------------------------
 // Structures
@@ -111,6 +112,31 @@ typedef struct
                                       const CSR_fOnApplySkin      fOnApplySkin,
                                       const CSR_fOnDeleteTexture  fOnDeleteTexture);
 
+        /**
+        * Create a mesh from a buffer containing a WaveFront file, reading it on several threads
+        *@param pBuffer - buffer containing the WaveFront file
+        *@param pVertFormat - model vertex format, if 0 the default format will be used
+        *@param pVertCulling - model vertex culling, if 0 the default culling will be used
+        *@param pMaterial - mesh material, if 0 the default material will be used
+        *@param fOnGetVertexColor - get vertex color callback function to use, 0 if not used
+        *@param fOnApplySkin - called when a skin should be applied to the model
+        *@param fOnDeleteTexture - callback function to notify the GPU that a texture should be deleted
+        *@param pPool - job pool to read with, if 0 the file is read in the calling thread
+        *@return model containing the WaveFront file on success, otherwise 0
+        *@note The file is split in line aligned chunks, which are read in parallel, then merged.
+        *      The model is built in the calling thread, thus the callbacks are always called from
+        *      it, in the file order. The resulting model is the same as with csrWaveFrontCreate()
+        *@note The model content should be released using the csrModelRelease function when useless
+        */
+        CSR_Model* csrWaveFrontCreateParallel(const CSR_Buffer*           pBuffer,
+                                              const CSR_VertexFormat*     pVertFormat,
+                                              const CSR_VertexCulling*    pVertCulling,
+                                              const CSR_Material*         pMaterial,
+                                              const CSR_fOnGetVertexColor fOnGetVertexColor,
+                                              const CSR_fOnApplySkin      fOnApplySkin,
+                                              const CSR_fOnDeleteTexture  fOnDeleteTexture,
+                                                    CSR_JobPool*          pPool);
+
         /**
         * Opens a WaveFront file
         *@param pFileName - WaveFront file name to open
@@ -3782,7 +3782,7 @@ CSR_X* csrXOpen(const char*                 pFileName,
     CSR_X*      pX;
 
     // open the model file
-    pBuffer = csrFileOpen(pFileName);
+    pBuffer = csrFileMap(pFileName);
 
     // succeeded?
     if (!pBuffer || !pBuffer->m_Length)
@@ -249,8 +249,9 @@ void TMainForm::DeleteScene()
     m_Initialized = false;
 
     // release the model texture
-    if (m_pModelTexture)
-        csrPixelBufferRelease(m_pModelTexture);
+    m_Raster.m_pTexture = 0;
+    csrRasterTextureRelease(m_pModelTexture);
+    m_pModelTexture = NULL;
 
     // release the model
     if (m_pModel)
@@ -487,16 +488,12 @@ void TMainForm::OnApplySkin(size_t index, const CSR_Skin* pSkin, int* pCanReleas
         return;
 
     // release the previously existing texture, if any
-    if (m_pModelTexture)
-        csrPixelBufferRelease(m_pModelTexture);
+    m_Raster.m_pTexture = 0;
+    csrRasterTextureRelease(m_pModelTexture);
 
-    // copy the pixel buffer content (the source buffer will be released sooner)
-    m_pModelTexture = (CSR_PixelBuffer*)malloc(sizeof(CSR_PixelBuffer));
-    memcpy(m_pModelTexture, pSkin->m_Texture.m_pBuffer, sizeof(CSR_PixelBuffer));
-
-    // copy the texture pixel data
-    m_pModelTexture->m_pData = (unsigned char*)malloc(pSkin->m_Texture.m_pBuffer->m_DataLength);
-    memcpy(m_pModelTexture->m_pData, pSkin->m_Texture.m_pBuffer->m_pData, pSkin->m_Texture.m_pBuffer->m_DataLength);
+    // convert the pixel buffer to a mipmapped raster texture, sampled by the rasterizer itself
+    m_pModelTexture     = csrRasterTextureCreate(pSkin->m_Texture.m_pBuffer);
+    m_Raster.m_pTexture = m_pModelTexture;
 }
 //---------------------------------------------------------------------------
 void TMainForm::OnApplyFragmentShader(const CSR_Matrix4*  pMatrix,
@@ -506,28 +503,7 @@ void TMainForm::OnApplyFragmentShader(const CSR_Matrix4*  pMatrix,
                                             float         z,
                                             CSR_Color*    pColor)
 {
-    float  stX;
-    float  stY;
-    size_t x;
-    size_t y;
-    size_t line;
-
-    // limit the texture coordinate between 0 and 1 (equivalent to OpenGL clamp mode)
-    csrMathClamp(pST->m_X, 0.0f, 1.0f, &stX);
-    csrMathClamp(pST->m_Y, 0.0f, 1.0f, &stY);
-
-    // calculate the x and y coordinate to pick in the texture, and the line length in pixels
-    x    = stX * m_pModelTexture->m_Width;
-    y    = stY * m_pModelTexture->m_Height;
-    line = m_pModelTexture->m_Width * m_pModelTexture->m_BytePerPixel;
-
-    // calculate the pixel index to get
-    const size_t index = (y * line) + (x * m_pModelTexture->m_BytePerPixel);
-
-    // get the pixel color from texture
-    pColor->m_R = (float)(((unsigned char*)(m_pModelTexture->m_pData))[index])     / 255.0f;
-    pColor->m_G = (float)(((unsigned char*)(m_pModelTexture->m_pData))[index + 1]) / 255.0f;
-    pColor->m_B = (float)(((unsigned char*)(m_pModelTexture->m_pData))[index + 2]) / 255.0f;
+    // the pixel color was already sampled from the texture by the rasterizer, just make it opaque
     pColor->m_A = 1.0f;
 }
 //---------------------------------------------------------------------------
@@ -97,29 +97,29 @@ class TMainForm : public TForm
             void Clear();
         };
 
-        IStats           m_Stats;
-        CSR_Raster       m_Raster;
-        CSR_Matrix4      m_ProjectionMatrix;
-        CSR_Matrix4      m_Matrix;
-        CSR_MDL*         m_pModel;
-        CSR_PixelBuffer* m_pModelTexture;
-        CSR_FrameBuffer* m_pFrameBuffer;
-        CSR_DepthBuffer* m_pDepthBuffer;
-        float            m_zNear;
-        float            m_zFar;
-        float            m_PosY;
-        float            m_AngleX;
-        float            m_AngleY;
-        double           m_pTextureLastTime;
-        double           m_pModelLastTime;
-        double           m_pMeshLastTime;
-        std::size_t      m_TextureIndex;
-        std::size_t      m_ModelIndex;
-        std::size_t      m_MeshIndex;
-        std::size_t      m_FrameCount;
-        unsigned __int64 m_StartTime;
-        unsigned __int64 m_PreviousTime;
-        bool             m_Initialized;
+        IStats             m_Stats;
+        CSR_Raster         m_Raster;
+        CSR_Matrix4        m_ProjectionMatrix;
+        CSR_Matrix4        m_Matrix;
+        CSR_MDL*           m_pModel;
+        CSR_RasterTexture* m_pModelTexture;
+        CSR_FrameBuffer*   m_pFrameBuffer;
+        CSR_DepthBuffer*   m_pDepthBuffer;
+        float              m_zNear;
+        float              m_zFar;
+        float              m_PosY;
+        float              m_AngleX;
+        float              m_AngleY;
+        double             m_pTextureLastTime;
+        double             m_pModelLastTime;
+        double             m_pMeshLastTime;
+        std::size_t        m_TextureIndex;
+        std::size_t        m_ModelIndex;
+        std::size_t        m_MeshIndex;
+        std::size_t        m_FrameCount;
+        unsigned __int64   m_StartTime;
+        unsigned __int64   m_PreviousTime;
+        bool               m_Initialized;
 
         /**
         * Gets the models directory